@@ -314,6 +314,7 @@ namespace std {
 %include "iDynTree/AttitudeEstimator.h"
 %include "iDynTree/AttitudeMahonyFilter.h"
 %include "iDynTree/ExtendedKalmanFilter.h"
+%template(AttitudeQuaternionEKFHelper) iDynTree::DiscreteExtendedKalmanFilterFixedSizeHelper<10, 3, 4>;
 %include "iDynTree/AttitudeQuaternionEKF.h"
 
 // SolidShapes related classes
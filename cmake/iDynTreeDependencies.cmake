@@ -66,6 +66,10 @@ if(NOT TARGET LibXml2::LibXml2)
   find_package(LibXml2 REQUIRED)
 endif()
 
+if(NOT TARGET Threads::Threads)
+  find_package(Threads REQUIRED)
+endif()
+
 idyntree_handle_dependency(YARP COMPONENTS os dev math MAIN_TARGET YARP::YARP_os)
 set(YARP_REQUIRED_VERSION 3.3)
 if(IDYNTREE_USES_YARP AND YARP_FOUND)
@@ -92,6 +96,8 @@ if(IDYNTREE_USES_ALGLIB AND ALGLIB_FOUND)
   endif()
 endif()
 idyntree_handle_dependency(WORHP DO_NOT_SILENTLY_SEARCH)
+# Google Benchmark is only used by the benchmarks, that are compiled if BUILD_TESTING is enabled
+idyntree_handle_dependency(benchmark NO_MODULE MAIN_TARGET benchmark::benchmark)
 # Workaround for https://github.com/robotology/idyntree/issues/599
 # NO_MODULE passed to avoid that the Findassimp of YCM is used instead, https://github.com/robotology/idyntree/pull/832
 idyntree_handle_dependency(assimp DO_NOT_SILENTLY_SEARCH NO_MODULE MAIN_TARGET assimp::assimp)
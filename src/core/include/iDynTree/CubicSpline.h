@@ -8,6 +8,7 @@
 #include <vector>
 #include <iDynTree/VectorFixSize.h>
 #include <iDynTree/VectorDynSize.h>
+#include <iDynTree/MatrixDynSize.h>
 
 namespace iDynTree
 {
@@ -17,12 +18,15 @@ namespace iDynTree
         iDynTree::VectorDynSize m_time;
         iDynTree::VectorDynSize m_y;
         iDynTree::VectorDynSize m_T;
+        iDynTree::VectorDynSize m_tridiagonalBuffer;
 
         double m_v0;
         double m_vf;
         double m_a0;
         double m_af;
 
+        size_t m_lastInterval;
+
         bool computePhasesDuration();
         bool computeIntermediateVelocities();
         bool computeCoefficients();
@@ -40,6 +44,69 @@ namespace iDynTree
         double evaluatePoint(double t);
         double evaluatePoint(double t, double& velocity, double& acceleration);
     };
+
+    /**
+     * Cubic splines of multiple channels (for example the joints of a robot) sharing the same time knots.
+     *
+     * Each channel is interpolated as in CubicSpline, but the interval containing the evaluation time is
+     * searched only once for all the channels, and the coefficients of the channels are stored contiguously
+     * so that all of them are evaluated together.
+     */
+    class MultiChannelCubicSpline {
+        iDynTree::VectorDynSize m_time;
+        iDynTree::VectorDynSize m_T;
+        iDynTree::MatrixDynSize m_y; // knots x channels
+        iDynTree::MatrixDynSize m_velocities; // knots x channels
+        iDynTree::MatrixDynSize m_coefficients; // intervals x (4 * channels)
+        iDynTree::VectorDynSize m_tridiagonalBuffer;
+
+        iDynTree::VectorDynSize m_v0;
+        iDynTree::VectorDynSize m_vf;
+        iDynTree::VectorDynSize m_a0;
+        iDynTree::VectorDynSize m_af;
+
+        size_t m_lastInterval;
+
+        bool computeCoefficients();
+
+        bool m_areCoefficientsUpdated;
+
+    public:
+        MultiChannelCubicSpline();
+
+        MultiChannelCubicSpline(unsigned int numberOfChannels, unsigned int buffersDimension);
+
+        /**
+         * Set the knots of the splines.
+         *
+         * @param[in] time the time of the knots, strictly increasing.
+         * @param[in] yData the values of the knots, with a row for each channel and a column for each element of time.
+         * @return true if all went well, false otherwise.
+         */
+        bool setData(const iDynTree::VectorDynSize& time, const iDynTree::MatrixDynSize& yData);
+
+        /**
+         * Set the velocity and the acceleration of each channel at the first knot (zero by default).
+         */
+        bool setInitialConditions(const iDynTree::VectorDynSize& initialVelocities, const iDynTree::VectorDynSize& initialAccelerations);
+
+        /**
+         * Set the velocity and the acceleration of each channel at the last knot (zero by default).
+         */
+        bool setFinalConditions(const iDynTree::VectorDynSize& finalVelocities, const iDynTree::VectorDynSize& finalAccelerations);
+
+        size_t getNrOfChannels() const;
+
+        /**
+         * Evaluate all the channels at time t.
+         *
+         * Queries with increasing (or constant) time do not need to search the interval of the knots.
+         * @return true if all went well, false otherwise (for example if no data was set).
+         */
+        bool evaluatePoint(double t, iDynTree::VectorDynSize& positions);
+
+        bool evaluatePoint(double t, iDynTree::VectorDynSize& positions, iDynTree::VectorDynSize& velocities, iDynTree::VectorDynSize& accelerations);
+    };
 }
 
 #endif
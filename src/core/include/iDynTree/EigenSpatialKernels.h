@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef IDYNTREE_EIGEN_SPATIAL_KERNELS_H
+#define IDYNTREE_EIGEN_SPATIAL_KERNELS_H
+
+#include <iDynTree/Transform.h>
+#include <iDynTree/Position.h>
+#include <iDynTree/Rotation.h>
+#include <iDynTree/SpatialInertia.h>
+#include <iDynTree/VectorFixSize.h>
+#include <iDynTree/EigenHelpers.h>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+/**
+ * \file EigenSpatialKernels.h
+ *
+ * Inline fixed-size kernels for the spatial algebra operations used in the inner loops
+ * of the model algorithms (ForwardPositionKinematics, RNEADynamicPhase, CompositeRigidBodyAlgorithm, ...).
+ *
+ * Differently from the operators of iDynTree::Transform, iDynTree::SpatialInertia, etc., that are
+ * implemented in the iDynTree libraries and return their result by value, these functions are defined
+ * in the header and operate on Eigen fixed-size objects (or on Eigen maps of the iDynTree storage),
+ * so that the compiler can inline them and avoid the creation of temporaries.
+ * As for iDynTree::SpatialMotionVector and iDynTree::SpatialForceVector, the 6D vectors
+ * are stored with the linear part first and the angular part last.
+ *
+ * This header includes Eigen, so (as iDynTree/EigenHelpers.h) it is meant to be used
+ * in code that already depends on Eigen.
+ */
+
+namespace iDynTree
+{
+
+/**
+ * 6D spatial vector (motion or force), with the linear part first.
+ */
+typedef Eigen::Matrix<double,6,1> SpatialVector6d;
+
+/**
+ * Compute a_H_c = a_H_b*b_H_c.
+ *
+ * a_H_c can be the same object of a_H_b or b_H_c.
+ */
+inline void composeTransforms(const Transform& a_H_b, const Transform& b_H_c, Transform& a_H_c)
+{
+    Rotation a_R_c;
+    Position a_p_c;
+    toEigen(a_R_c).noalias() = toEigen(a_H_b.getRotation())*toEigen(b_H_c.getRotation());
+    toEigen(a_p_c).noalias() = toEigen(a_H_b.getRotation())*toEigen(b_H_c.getPosition());
+    toEigen(a_p_c) += toEigen(a_H_b.getPosition());
+    a_H_c.setRotation(a_R_c);
+    a_H_c.setPosition(a_p_c);
+}
+
+/**
+ * Compute b_H_a = a_H_b^{-1}.
+ *
+ * b_H_a can be the same object of a_H_b.
+ */
+inline void inverseTransform(const Transform& a_H_b, Transform& b_H_a)
+{
+    Rotation b_R_a;
+    Position b_p_a;
+    toEigen(b_R_a) = toEigen(a_H_b.getRotation()).transpose();
+    toEigen(b_p_a).noalias() = -(toEigen(a_H_b.getRotation()).transpose()*toEigen(a_H_b.getPosition()));
+    b_H_a.setRotation(b_R_a);
+    b_H_a.setPosition(b_p_a);
+}
+
+/**
+ * Transform the motion vector v_b (expressed in b) in a, i.e. compute a_X_b*v_b.
+ */
+template<typename Derived>
+inline SpatialVector6d transformMotionVector(const Transform& a_H_b, const Eigen::MatrixBase<Derived>& v_b)
+{
+    Eigen::Map<const Eigen::Matrix<double,3,3,Eigen::RowMajor> > R = toEigen(a_H_b.getRotation());
+    SpatialVector6d v_a;
+    v_a.tail<3>().noalias() = R*v_b.template tail<3>();
+    v_a.head<3>().noalias() = R*v_b.template head<3>();
+    v_a.head<3>() += toEigen(a_H_b.getPosition()).cross(v_a.tail<3>());
+    return v_a;
+}
+
+/**
+ * Transform the motion vector v_a (expressed in a) in b, i.e. compute a_X_b^{-1}*v_a without inverting a_H_b.
+ */
+template<typename Derived>
+inline SpatialVector6d inverseTransformMotionVector(const Transform& a_H_b, const Eigen::MatrixBase<Derived>& v_a)
+{
+    Eigen::Map<const Eigen::Matrix<double,3,3,Eigen::RowMajor> > R = toEigen(a_H_b.getRotation());
+    Eigen::Vector3d linear = v_a.template head<3>() - toEigen(a_H_b.getPosition()).cross(v_a.template tail<3>());
+    SpatialVector6d v_b;
+    v_b.head<3>().noalias() = R.transpose()*linear;
+    v_b.tail<3>().noalias() = R.transpose()*v_a.template tail<3>();
+    return v_b;
+}
+
+/**
+ * Transform the force vector f_b (expressed in b) in a, i.e. compute a_X_b^**f_b.
+ */
+template<typename Derived>
+inline SpatialVector6d transformForceVector(const Transform& a_H_b, const Eigen::MatrixBase<Derived>& f_b)
+{
+    Eigen::Map<const Eigen::Matrix<double,3,3,Eigen::RowMajor> > R = toEigen(a_H_b.getRotation());
+    SpatialVector6d f_a;
+    f_a.head<3>().noalias() = R*f_b.template head<3>();
+    f_a.tail<3>().noalias() = R*f_b.template tail<3>();
+    f_a.tail<3>() += toEigen(a_H_b.getPosition()).cross(f_a.head<3>());
+    return f_a;
+}
+
+/**
+ * Transform the force vector f_a (expressed in a) in b, i.e. compute a_X_b^{-*}*f_a without inverting a_H_b.
+ */
+template<typename Derived>
+inline SpatialVector6d inverseTransformForceVector(const Transform& a_H_b, const Eigen::MatrixBase<Derived>& f_a)
+{
+    Eigen::Map<const Eigen::Matrix<double,3,3,Eigen::RowMajor> > R = toEigen(a_H_b.getRotation());
+    Eigen::Vector3d angular = f_a.template tail<3>() - toEigen(a_H_b.getPosition()).cross(f_a.template head<3>());
+    SpatialVector6d f_b;
+    f_b.head<3>().noalias() = R.transpose()*f_a.template head<3>();
+    f_b.tail<3>().noalias() = R.transpose()*angular;
+    return f_b;
+}
+
+/**
+ * Cross product of motion vectors, v \times m.
+ */
+template<typename DerivedV, typename DerivedM>
+inline SpatialVector6d crossMotion(const Eigen::MatrixBase<DerivedV>& v, const Eigen::MatrixBase<DerivedM>& m)
+{
+    SpatialVector6d res;
+    res.head<3>() = v.template tail<3>().cross(m.template head<3>()) + v.template head<3>().cross(m.template tail<3>());
+    res.tail<3>() = v.template tail<3>().cross(m.template tail<3>());
+    return res;
+}
+
+/**
+ * Cross product of a motion vector and of a force vector, v \bar\times^* f.
+ */
+template<typename DerivedV, typename DerivedF>
+inline SpatialVector6d crossForce(const Eigen::MatrixBase<DerivedV>& v, const Eigen::MatrixBase<DerivedF>& f)
+{
+    SpatialVector6d res;
+    res.head<3>() = v.template tail<3>().cross(f.template head<3>());
+    res.tail<3>() = v.template tail<3>().cross(f.template tail<3>()) + v.template head<3>().cross(f.template head<3>());
+    return res;
+}
+
+/**
+ * Add to the inertial parameters of a body expressed in a the inertial parameters of a body expressed in b,
+ * given the rotation a_R_b and the position a_p_b of a_H_b.
+ *
+ * The inertial parameters are ordered as in SpatialInertia::asVector, i.e. mass, first moment of mass
+ * and the six elements of the rotational inertia with respect to the frame origin. Computing the transform
+ * on the inertial parameters avoids the 6x6 matrix products of a_X_b^* I_b b_X_a, and supports the inertias with zero mass.
+ */
+template<typename DerivedR, typename DerivedP, typename DerivedB>
+inline void addTransformedInertialParameters(const Eigen::MatrixBase<DerivedR>& R, const Eigen::MatrixBase<DerivedP>& p,
+                                             const Eigen::MatrixBase<DerivedB>& params_b,
+                                             Eigen::Ref<Eigen::Matrix<double,10,1> > params_a)
+{
+    const double mass = params_b(0);
+    Eigen::Matrix3d rotInertia_b;
+    rotInertia_b << params_b(4), params_b(5), params_b(6),
+                    params_b(5), params_b(7), params_b(8),
+                    params_b(6), params_b(8), params_b(9);
+
+    // First moment of mass, rotated in a and then translated in the origin of a
+    const Eigen::Vector3d rotatedMcom = R*params_b.template segment<3>(1);
+    const Eigen::Vector3d mcom_a = rotatedMcom + mass*p;
+
+    // Rotational inertia with respect to the origin of a, from Equation 2.66 in Featherstone 2008:
+    // R*I_b*R^T - skew(p)*skew(R*h) - skew(R*h+m*p)*skew(p), with skew(x)*skew(y) = y*x^T - (x^T*y)*1_3
+    Eigen::Matrix3d rotInertia_a = R*rotInertia_b*R.transpose();
+    rotInertia_a.noalias() -= rotatedMcom*p.transpose();
+    rotInertia_a.noalias() -= p*mcom_a.transpose();
+    rotInertia_a.diagonal().array() += p.dot(rotatedMcom) + p.dot(mcom_a);
+
+    params_a(0) += mass;
+    params_a.segment<3>(1) += mcom_a;
+    params_a(4) += rotInertia_a(0,0);
+    params_a(5) += rotInertia_a(0,1);
+    params_a(6) += rotInertia_a(0,2);
+    params_a(7) += rotInertia_a(1,1);
+    params_a(8) += rotInertia_a(1,2);
+    params_a(9) += rotInertia_a(2,2);
+}
+
+/**
+ * Add to the spatial inertia I_a (expressed in a) the spatial inertia I_b (expressed in b),
+ * i.e. compute I_a = I_a + a_X_b^* I_b b_X_a.
+ *
+ * \see addTransformedInertialParameters
+ */
+inline void addTransformedSpatialInertia(const Transform& a_H_b, const SpatialInertia& I_b, SpatialInertia& I_a)
+{
+    const Vector10 inertialParams_b = I_b.asVector();
+    Vector10 inertialParams_a = I_a.asVector();
+    addTransformedInertialParameters(toEigen(a_H_b.getRotation()), toEigen(a_H_b.getPosition()),
+                                     toEigen(inertialParams_b), toEigen(inertialParams_a));
+    I_a.fromVector(inertialParams_a);
+}
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef IDYNTREE_WORKER_POOL_H
+#define IDYNTREE_WORKER_POOL_H
+
+#include <cstddef>
+
+namespace iDynTree
+{
+    /**
+     * \ingroup iDynTreeCore
+     *
+     * Small pool of persistent worker threads, used to split a set of independent tasks on multiple threads.
+     *
+     * A call to run executes the tasks with indices 0, ..., nrOfTasks-1, distributing them between
+     * the worker threads and the calling thread, and returns when all of them have been executed.
+     * The threads are created by resize and are kept alive until the next resize or the destruction of the pool,
+     * so once the pool has been resized run does not allocate memory nor create threads.
+     *
+     * With 0 worker threads (the default) all the tasks are executed sequentially in the calling thread.
+     *
+     * \note run can not be called concurrently from multiple threads, and the tasks should not call run on the same pool.
+     */
+    class WorkerPool
+    {
+    public:
+        /**
+         * Signature of a task: context is the pointer passed to run, taskIndex the index of the task to execute.
+         */
+        typedef void (*TaskFunction)(void* context, std::size_t taskIndex);
+
+    private:
+        struct WorkerPoolPrivateAttributes;
+        WorkerPoolPrivateAttributes * pimpl;
+
+        // copy is disabled
+        WorkerPool(const WorkerPool& other) = delete;
+        WorkerPool& operator=(const WorkerPool& other) = delete;
+
+        template<typename Task>
+        static void invokeTask(void* context, std::size_t taskIndex)
+        {
+            (*static_cast<Task*>(context))(taskIndex);
+        }
+
+    public:
+        /**
+         * Constructor, create a pool with 0 worker threads.
+         */
+        WorkerPool();
+
+        /**
+         * Destructor, join all the worker threads.
+         */
+        ~WorkerPool();
+
+        /**
+         * Set the number of worker threads, in addition to the thread that calls run.
+         *
+         * @param[in] nrOfWorkerThreads the number of worker threads, 0 to execute all the tasks in the calling thread.
+         * @return true if all went well, false otherwise (if the threads could not be created,
+         *         in which case the pool is left with 0 worker threads).
+         */
+        bool resize(const std::size_t nrOfWorkerThreads);
+
+        /**
+         * Get the number of worker threads.
+         */
+        std::size_t getNrOfWorkerThreads() const;
+
+        /**
+         * Execute task(context, i) for i in 0, ..., nrOfTasks-1, and return once all the tasks are completed.
+         */
+        void run(const std::size_t nrOfTasks, TaskFunction task, void* context);
+
+        /**
+         * Execute task(i) for i in 0, ..., nrOfTasks-1, and return once all the tasks are completed.
+         *
+         * task can be any callable object (for example a lambda capturing its context by reference),
+         * that is invoked concurrently from multiple threads.
+         */
+        template<typename Task>
+        void run(const std::size_t nrOfTasks, Task& task)
+        {
+            run(nrOfTasks, &WorkerPool::invokeTask<Task>, static_cast<void*>(&task));
+        }
+    };
+}
+
+#endif
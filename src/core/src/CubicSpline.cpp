@@ -4,16 +4,102 @@
 #include <iDynTree/CubicSpline.h>
 #include <iDynTree/EigenHelpers.h>
 #include <Eigen/Dense>
-#include <Eigen/Sparse>
-#include <Eigen/SparseLU>
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
+namespace
+{
+    bool computeIntervalsDuration(const iDynTree::VectorDynSize& time, iDynTree::VectorDynSize& T)
+    {
+        for (size_t i = 0; i < time.size() - 1; ++i){
+
+            T(i) = time(i+1) - time(i);
+
+            if(T(i) == 0){
+                std::cerr << "[ERROR][CUBICSPLINE] Two consecutive points have the same time coordinate." << std::endl; //For stability purposes, the matrix below may not be invertible
+                return false;
+            }
+
+            if(T(i) < 0){
+                std::cerr << "[ERROR][CUBICSPLINE] The input points are expected to be consecutive, strictly increasing in the time variable." << std::endl; //For stability purposes
+                return false;
+            }
+
+        }
+        return true;
+    }
+
+    // Index i such that time(i) <= t < time(i+1), with time(0) <= t < time(time.size()-1).
+    // The interval of the previous query and the following one are checked before searching,
+    // so that monotone queries take constant time.
+    size_t findInterval(const iDynTree::VectorDynSize& time, double t, size_t& lastInterval)
+    {
+        size_t n = time.size();
+
+        if ((lastInterval + 1 < n) && (time(lastInterval) <= t)) {
+            if (t < time(lastInterval + 1)) {
+                return lastInterval;
+            }
+            if ((lastInterval + 2 < n) && (t < time(lastInterval + 2))) {
+                return ++lastInterval;
+            }
+        }
+
+        const double* begin = time.data();
+        lastInterval = static_cast<size_t>(std::upper_bound(begin, begin + n, t) - begin) - 1;
+        return lastInterval;
+    }
+
+    // Compute the intermediate velocities of all the channels, such that the accelerations are continuous at the knots.
+    // y and velocities are row-major (knots x channels) matrices, with the initial and final velocities already in the
+    // first and last rows of velocities. The system is tridiagonal and strictly diagonally dominant, hence it is
+    // solved with the Thomas algorithm without pivoting, in O(knots) and once for all the channels.
+    void computeTridiagonalVelocities(const iDynTree::VectorDynSize& T, const double* y, double* velocities,
+                                      size_t channels, iDynTree::VectorDynSize& upperBuffer)
+    {
+        typedef Eigen::Map<Eigen::VectorXd> ChannelsMap;
+        typedef Eigen::Map<const Eigen::VectorXd> ConstChannelsMap;
+        Eigen::Index n = static_cast<Eigen::Index>(channels);
+
+        size_t unknowns = T.size() - 1;
+        auto yRow = [&](size_t knot) { return ConstChannelsMap(y + knot * channels, n); };
+        auto velocitiesRow = [&](size_t knot) { return ChannelsMap(velocities + knot * channels, n); };
+
+        if (upperBuffer.size() != unknowns) {
+            upperBuffer.resize(unknowns);
+        }
+
+        // Right hand side, stored directly in the rows of the unknown velocities
+        for (size_t i = 0; i < unknowns; ++i) {
+            velocitiesRow(i+1) = (T(i)*T(i)*(yRow(i+2) - yRow(i+1)) + T(i+1)*T(i+1)*(yRow(i+1) - yRow(i))) * (3.0 / (T(i)*T(i+1)));
+        }
+        velocitiesRow(1) -= T(1) * velocitiesRow(0);
+        velocitiesRow(unknowns) -= T(unknowns - 1) * velocitiesRow(unknowns + 1);
+
+        // Forward elimination. Row i has T(i+1) on the lower diagonal, 2*(T(i) + T(i+1)) on the diagonal and T(i) on the upper one
+        double denominator = 2*(T(0) + T(1));
+        upperBuffer(0) = T(0) / denominator;
+        velocitiesRow(1) /= denominator;
+        for (size_t i = 1; i < unknowns; ++i) {
+            denominator = 2*(T(i) + T(i+1)) - T(i+1) * upperBuffer(i-1);
+            upperBuffer(i) = T(i) / denominator;
+            velocitiesRow(i+1) = (velocitiesRow(i+1) - T(i+1) * velocitiesRow(i)) / denominator;
+        }
+
+        // Back substitution
+        for (size_t i = unknowns - 1; i > 0; --i) {
+            velocitiesRow(i) -= upperBuffer(i-1) * velocitiesRow(i+1);
+        }
+    }
+}
+
 iDynTree::CubicSpline::CubicSpline()
 :m_v0(0)
 ,m_vf(0)
 ,m_a0(0)
 ,m_af(0)
+,m_lastInterval(0)
 ,m_areCoefficientsUpdated{false}
 {
     m_coefficients.clear();
@@ -33,6 +119,7 @@ iDynTree::CubicSpline::CubicSpline(unsigned int buffersDimension)
     ,m_vf(0)
     ,m_a0(0)
     ,m_af(0)
+    ,m_lastInterval(0)
     ,m_areCoefficientsUpdated{false}
 {
 }
@@ -66,6 +153,7 @@ bool iDynTree::CubicSpline::setData(const iDynTree::VectorDynSize& time, const i
 
     m_y = yData;
 
+    m_lastInterval = 0;
     m_areCoefficientsUpdated = false;
 
     return true;
@@ -104,65 +192,13 @@ bool iDynTree::CubicSpline::computeCoefficients()
 
 bool iDynTree::CubicSpline::computeIntermediateVelocities()
 {
-    Eigen::SparseMatrix<double> A(m_velocities.size()-2, m_velocities.size()-2);
-    std::vector<Eigen::Triplet<double> > A_triplets;
-
-    //Eigen::MatrixXd A(m_velocities.size()-2, m_velocities.size()-2);
-    Eigen::VectorXd b(m_velocities.size()-2);
-
-    //A.setZero();
-
-    //A(0,0) = 2*(m_T(0) + m_T(1));
-    A_triplets.push_back(Eigen::Triplet<double>(0, 0, 2*(m_T(0) + m_T(1))));
-    b(0) = ( std::pow(m_T(0), 2)*(m_y(2) - m_y(1)) + std::pow(m_T(1), 2)*(m_y(1) - m_y(0)) )*3/(m_T(0)*m_T(1)) - m_T(1)*m_velocities(0);
-
-    if(m_velocities.size() > 3){
-        //A(0,1) = m_T(0);
-        A_triplets.push_back(Eigen::Triplet<double>(0, 1, m_T(0)));
-        for(int i = 1; i < A.rows()-1; ++i){
-            //A(i,i-1) = m_T(i+1);
-            A_triplets.push_back(Eigen::Triplet<double>(i, i-1, m_T(i+1)));
-            //A(i,i) = 2*(m_T(i) + m_T(i+1));
-            A_triplets.push_back(Eigen::Triplet<double>(i, i, 2*(m_T(i) + m_T(i+1))));
-            //A(i,i+1) = m_T(i);
-            A_triplets.push_back(Eigen::Triplet<double>(i, i+1, m_T(i)));
-
-            b(i) = ( std::pow(m_T(i), 2)*(m_y(i+2) - m_y(i+1)) + std::pow(m_T(i+1), 2)*(m_y(i+1) - m_y(i)) )*3/(m_T(i)*m_T(i+1));
-        }
-        size_t T = m_T.size() - 1;
-        //A.bottomRightCorner<1,2>() << m_T(T), 2*(m_T(T) + m_T(T-1));
-        A_triplets.push_back(Eigen::Triplet<double>(A.rows() - 1, A.cols() - 2,  m_T(T)));
-        A_triplets.push_back(Eigen::Triplet<double>(A.rows() - 1, A.cols() - 1,  2*(m_T(T) + m_T(T-1))));
-        b.tail<1>() << ( std::pow(m_T(T-1), 2)*(m_y(T+1) - m_y(T)) + std::pow(m_T(T), 2)*(m_y(T) - m_y(T-1)) )*3/(m_T(T-1)*m_T(T)) - m_T(T-1)*m_velocities(T+1);
-    }
-    //iDynTree::toEigen(m_velocities).segment(1, m_velocities.size()-2) = A.colPivHouseholderQr().solve(b);
-    A.setFromTriplets(A_triplets.begin(), A_triplets.end());
-    A.makeCompressed();
-    Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<Eigen::SparseMatrix<double>::StorageIndex>> qrDecomposition;
-    qrDecomposition.compute(A);
-    iDynTree::toEigen(m_velocities).segment(1, m_velocities.size()-2) = qrDecomposition.solve(b);
-
+    computeTridiagonalVelocities(m_T, m_y.data(), m_velocities.data(), 1, m_tridiagonalBuffer);
     return true;
 }
 
 bool iDynTree::CubicSpline::computePhasesDuration()
 {
-    for (size_t i = 0; i < m_time.size() - 1; ++i){
-
-        m_T(i) = m_time(i+1) - m_time(i);
-
-        if(m_T(i) == 0){
-            std::cerr << "[ERROR][CUBICSPLINE] Two consecutive points have the same time coordinate." << std::endl; //For stability purposes, the matrix below may not be invertible
-            return false;
-        }
-
-        if(m_T(i) < 0){
-            std::cerr << "[ERROR][CUBICSPLINE] The input points are expected to be consecutive, strictly increasing in the time variable." << std::endl; //For stability purposes
-            return false;
-        }
-
-    }
-    return true;
+    return computeIntervalsDuration(m_time, m_T);
 }
 
 void iDynTree::CubicSpline::setInitialConditions(double initialVelocity, double initialAcceleration)
@@ -217,17 +253,241 @@ double iDynTree::CubicSpline::evaluatePoint(double t, double &velocity, double &
         return m_y(m_y.size()-1);
     }
 
-    size_t coeffIndex = 0;
-    while( (coeffIndex < m_time.size()) && (t >= m_time(coeffIndex)) ){
-        coeffIndex++;
-    }
-    coeffIndex--; //Actually we are interested in the last index for which t >= m_time(coeffIndex) holds
+    size_t coeffIndex = findInterval(m_time, t, m_lastInterval);
 
-    iDynTree::Vector4 coeff = m_coefficients[coeffIndex];
+    const iDynTree::Vector4& coeff = m_coefficients[coeffIndex];
     double dt = t - m_time(coeffIndex);
 
-    double position = coeff(0) + coeff(1)*(dt) + coeff(2)*std::pow(dt,2) + coeff(3)*std::pow(dt,3);
-    velocity = coeff(1) + 2*coeff(2)*(dt) + 3*coeff(3)*std::pow(dt,2);
+    double position = coeff(0) + dt*(coeff(1) + dt*(coeff(2) + dt*coeff(3)));
+    velocity = coeff(1) + dt*(2*coeff(2) + 3*coeff(3)*dt);
     acceleration = 2*coeff(2) + 6*coeff(3)*(dt);
     return position;
 }
+
+
+iDynTree::MultiChannelCubicSpline::MultiChannelCubicSpline()
+:m_lastInterval(0)
+,m_areCoefficientsUpdated{false}
+{
+}
+
+iDynTree::MultiChannelCubicSpline::MultiChannelCubicSpline(unsigned int numberOfChannels, unsigned int buffersDimension)
+    :m_time(buffersDimension)
+    ,m_T(buffersDimension - 1)
+    ,m_y(buffersDimension, numberOfChannels)
+    ,m_velocities(buffersDimension, numberOfChannels)
+    ,m_coefficients(buffersDimension - 1, 4 * numberOfChannels)
+    ,m_tridiagonalBuffer(buffersDimension > 2 ? buffersDimension - 2 : 0)
+    ,m_v0(numberOfChannels)
+    ,m_vf(numberOfChannels)
+    ,m_a0(numberOfChannels)
+    ,m_af(numberOfChannels)
+    ,m_lastInterval(0)
+    ,m_areCoefficientsUpdated{false}
+{
+    m_v0.zero();
+    m_vf.zero();
+    m_a0.zero();
+    m_af.zero();
+}
+
+bool iDynTree::MultiChannelCubicSpline::setData(const iDynTree::VectorDynSize& time, const iDynTree::MatrixDynSize& yData)
+{
+    if((time.size() == 0) && (yData.cols() == 0)){
+        std::cerr << "[ERROR][CUBICSPLINE] The input data are empty!" << std::endl;
+        return false;
+    }
+
+    if(time.size() != yData.cols()){
+        std::cerr << "[ERROR][CUBICSPLINE] The input data are expected to have a column for each time instant: xData = " << time.size() << ", yData columns = " << yData.cols() << "." <<std::endl;
+        return false;
+    }
+
+    if(time.size() < 2){
+        std::cerr << "[ERROR][CUBICSPLINE] At least two data points are needed to compute the spline." << std::endl;
+        return false;
+    }
+
+    size_t channels = yData.rows();
+
+    m_time.resize(time.size());
+    m_time = time;
+    m_T.resize(time.size() - 1);
+
+    m_y.resize(time.size(), channels);
+    iDynTree::toEigen(m_y) = iDynTree::toEigen(yData).transpose();
+
+    m_velocities.resize(time.size(), channels);
+    m_coefficients.resize(time.size() - 1, 4 * channels);
+
+    // The boundary conditions that were not set are zero
+    iDynTree::VectorDynSize* conditions[] = {&m_v0, &m_vf, &m_a0, &m_af};
+    for (iDynTree::VectorDynSize* condition : conditions) {
+        if (condition->size() == 0) {
+            condition->resize(channels);
+            condition->zero();
+        }
+    }
+
+    m_lastInterval = 0;
+    m_areCoefficientsUpdated = false;
+
+    return true;
+}
+
+bool iDynTree::MultiChannelCubicSpline::setInitialConditions(const iDynTree::VectorDynSize& initialVelocities, const iDynTree::VectorDynSize& initialAccelerations)
+{
+    if (initialVelocities.size() != initialAccelerations.size()) {
+        std::cerr << "[ERROR][CUBICSPLINE] The initial velocities and accelerations are expected to have the same dimension." << std::endl;
+        return false;
+    }
+
+    m_v0 = initialVelocities;
+    m_a0 = initialAccelerations;
+
+    // The initial condition has been updated. The coefficients have to be recomputed.
+    m_areCoefficientsUpdated = false;
+    return true;
+}
+
+bool iDynTree::MultiChannelCubicSpline::setFinalConditions(const iDynTree::VectorDynSize& finalVelocities, const iDynTree::VectorDynSize& finalAccelerations)
+{
+    if (finalVelocities.size() != finalAccelerations.size()) {
+        std::cerr << "[ERROR][CUBICSPLINE] The final velocities and accelerations are expected to have the same dimension." << std::endl;
+        return false;
+    }
+
+    m_vf = finalVelocities;
+    m_af = finalAccelerations;
+
+    // The final condition has been updated. The coefficients have to be recomputed.
+    m_areCoefficientsUpdated = false;
+    return true;
+}
+
+size_t iDynTree::MultiChannelCubicSpline::getNrOfChannels() const
+{
+    return m_y.cols();
+}
+
+bool iDynTree::MultiChannelCubicSpline::computeCoefficients()
+{
+    // the coefficients are updated. No need to recompute them
+    if(m_areCoefficientsUpdated){
+        return true;
+    }
+
+    size_t channels = m_y.cols();
+    Eigen::Index n = static_cast<Eigen::Index>(channels);
+
+    if ((m_v0.size() != channels) || (m_vf.size() != channels) || (m_a0.size() != channels) || (m_af.size() != channels)) {
+        std::cerr << "[ERROR][CUBICSPLINE] The initial and final conditions are expected to have a value for each of the " << channels << " channels." << std::endl;
+        return false;
+    }
+
+    if(!computeIntervalsDuration(m_time, m_T))
+        return false;
+
+    auto y = iDynTree::toEigen(m_y);
+    auto velocities = iDynTree::toEigen(m_velocities);
+    auto coefficients = iDynTree::toEigen(m_coefficients);
+
+    velocities.row(0) = iDynTree::toEigen(m_v0).transpose();
+    velocities.row(velocities.rows() - 1) = iDynTree::toEigen(m_vf).transpose();
+
+    if(m_time.size() > 2){
+        computeTridiagonalVelocities(m_T, m_y.data(), m_velocities.data(), channels, m_tridiagonalBuffer);
+    }
+
+    for(Eigen::Index i = 0; i < coefficients.rows(); ++i){
+        double T = m_T(static_cast<unsigned int>(i));
+        coefficients.row(i).segment(0, n) = y.row(i);
+        coefficients.row(i).segment(n, n) = velocities.row(i);
+        coefficients.row(i).segment(2*n, n) = ( 3*(y.row(i+1) - y.row(i))/T - 2*velocities.row(i) - velocities.row(i+1) )/T;
+        coefficients.row(i).segment(3*n, n) = ( 2*(y.row(i) - y.row(i+1))/T + velocities.row(i) + velocities.row(i+1) )/(T*T);
+    }
+
+    // The coefficients are now updated.
+    m_areCoefficientsUpdated = true;
+
+    return true;
+}
+
+bool iDynTree::MultiChannelCubicSpline::evaluatePoint(double t, iDynTree::VectorDynSize& positions)
+{
+    if(m_time.size() == 0){
+        std::cerr << "[ERROR][CUBICSPLINE] First you have to load data!" << std::endl;
+        return false;
+    }
+
+    // The coefficients are not updated. It's time to compute them.
+    if(!m_areCoefficientsUpdated){
+        if(!this->computeCoefficients()){
+            std::cerr << "[ERROR][CUBICSPLINE] Unable to compute the internal coefficients of the cubic spline." << std::endl;
+            return false;
+        }
+    }
+
+    size_t channels = m_y.cols();
+    Eigen::Index n = static_cast<Eigen::Index>(channels);
+
+    if (positions.size() != channels) {
+        positions.resize(channels);
+    }
+
+    if( t < m_time(0) ){
+        iDynTree::toEigen(positions) = iDynTree::toEigen(m_y).row(0).transpose();
+        return true;
+    }
+
+    if( t >= m_time(m_time.size()-1)){
+        iDynTree::toEigen(positions) = iDynTree::toEigen(m_y).row(m_y.rows() - 1).transpose();
+        return true;
+    }
+
+    size_t coeffIndex = findInterval(m_time, t, m_lastInterval);
+    Eigen::Map<const Eigen::VectorXd> coeff(m_coefficients.data() + coeffIndex * m_coefficients.cols(), 4 * n);
+    double dt = t - m_time(coeffIndex);
+
+    iDynTree::toEigen(positions) = coeff.segment(0, n) + dt*(coeff.segment(n, n) + dt*(coeff.segment(2*n, n) + dt*coeff.segment(3*n, n)));
+    return true;
+}
+
+bool iDynTree::MultiChannelCubicSpline::evaluatePoint(double t, iDynTree::VectorDynSize& positions, iDynTree::VectorDynSize& velocities, iDynTree::VectorDynSize& accelerations)
+{
+    if (!evaluatePoint(t, positions)) {
+        return false;
+    }
+
+    size_t channels = m_y.cols();
+    Eigen::Index n = static_cast<Eigen::Index>(channels);
+
+    if (velocities.size() != channels) {
+        velocities.resize(channels);
+    }
+
+    if (accelerations.size() != channels) {
+        accelerations.resize(channels);
+    }
+
+    if( t < m_time(0) ){
+        velocities = m_v0;
+        accelerations = m_a0;
+        return true;
+    }
+
+    if( t >= m_time(m_time.size()-1)){
+        velocities = m_vf;
+        accelerations = m_af;
+        return true;
+    }
+
+    // The interval has been already found when evaluating the positions
+    size_t coeffIndex = m_lastInterval;
+    Eigen::Map<const Eigen::VectorXd> coeff(m_coefficients.data() + coeffIndex * m_coefficients.cols(), 4 * n);
+    double dt = t - m_time(coeffIndex);
+
+    iDynTree::toEigen(velocities) = coeff.segment(n, n) + dt*(2*coeff.segment(2*n, n) + 3*dt*coeff.segment(3*n, n));
+    iDynTree::toEigen(accelerations) = 2*coeff.segment(2*n, n) + 6*dt*coeff.segment(3*n, n);
+    return true;
+}
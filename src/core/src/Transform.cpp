@@ -16,6 +16,7 @@
 
 #include <iDynTree/PrivateUtils.h>
 #include <iDynTree/Utils.h>
+#include <iDynTree/EigenSpatialKernels.h>
 
 #include <Eigen/Dense>
 
@@ -128,16 +129,15 @@ void Transform::setRotation(const Rotation& rotation)
 
 Transform Transform::compose(const Transform& op1, const Transform& op2)
 {
-    return Transform(op1.getRotation()*op2.getRotation(),op1.getRotation()*op2.getPosition()+op1.getPosition());
+    Transform result;
+    composeTransforms(op1,op2,result);
+    return result;
 }
 
 Transform Transform::inverse2(const Transform& trans)
 {
     Transform result;
-
-    result.setRotation(trans.getRotation().inverse());
-    result.setPosition(-(result.getRotation()*trans.getPosition()));
-
+    inverseTransform(trans,result);
     return result;
 }
 
@@ -320,26 +320,9 @@ std::string Transform::reservedToString() const
         /* The transform of a Spatial Inertia is defined as follows:
          * A^I = A^X_B^* * B^I * B^X_A
          */
-
-        // mass clearly remains the same
-        double newMass = op2.getMass();
-
-        // the com is transformed as any position
-        Position newCenterOfMass = transform<Position>(op1,Position(op2.getCenterOfMass()));
-
-        // the rotational inertial is rotated and then
-        // the parallel axis theorem applies
-        RotationalInertia newRotInertia;
-        Eigen::Map<Eigen::Matrix3d> newI(newRotInertia.data());
-        RotationalInertia oldRotInertiaWrtCom = op2.getRotationalInertiaWrtCenterOfMass();
-        Eigen::Map<const Eigen::Matrix3d> oldIWrtCom(oldRotInertiaWrtCom.data());
-
-        Eigen::Map<const Matrix3dRowMajor> R(op1.getRotation().data());
-        Eigen::Map<const Eigen::Vector3d> newCOM(newCenterOfMass.data());
-
-        newI =  R*oldIWrtCom*R.transpose() - newMass*squareCrossProductMatrix(newCOM);
-
-        return SpatialInertia(newMass,newCenterOfMass,newRotInertia);
+        SpatialInertia ret = SpatialInertia::Zero();
+        addTransformedSpatialInertia(op1,op2,ret);
+        return ret;
     }
 
     template<>
@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/WorkerPool.h>
+#include <iDynTree/Utils.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace iDynTree
+{
+
+struct WorkerPool::WorkerPoolPrivateAttributes
+{
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    // Signaled when a new set of tasks is available, or when the workers need to stop
+    std::condition_variable newTasksCondition;
+    // Signaled when all the workers completed the current set of tasks
+    std::condition_variable tasksCompletedCondition;
+
+    // Incremented at each call to run, protected by mutex
+    std::size_t generation;
+    // Number of workers that did not complete the current set of tasks yet, protected by mutex
+    std::size_t nrOfBusyWorkers;
+    bool stop;
+
+    // Current set of tasks, written by run while holding mutex
+    TaskFunction task;
+    void* context;
+    std::size_t nrOfTasks;
+    std::atomic<std::size_t> nextTask;
+
+    WorkerPoolPrivateAttributes():
+        generation(0), nrOfBusyWorkers(0), stop(false),
+        task(nullptr), context(nullptr), nrOfTasks(0), nextTask(0)
+    {
+    }
+
+    void executeTasks()
+    {
+        for (std::size_t taskIndex = nextTask.fetch_add(1); taskIndex < nrOfTasks; taskIndex = nextTask.fetch_add(1))
+        {
+            task(context, taskIndex);
+        }
+    }
+
+    // initialGeneration is the generation at the creation of the worker,
+    // so that the worker only executes the tasks of the following calls to run
+    void workerLoop(std::size_t initialGeneration)
+    {
+        std::size_t lastGeneration = initialGeneration;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            newTasksCondition.wait(lock, [&] { return stop || generation != lastGeneration; });
+            if (stop)
+            {
+                return;
+            }
+            lastGeneration = generation;
+
+            lock.unlock();
+            executeTasks();
+            lock.lock();
+
+            nrOfBusyWorkers--;
+            if (nrOfBusyWorkers == 0)
+            {
+                tasksCompletedCondition.notify_one();
+            }
+        }
+    }
+
+    void joinWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            stop = true;
+        }
+        newTasksCondition.notify_all();
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        workers.clear();
+        stop = false;
+    }
+};
+
+WorkerPool::WorkerPool():
+    pimpl(new WorkerPoolPrivateAttributes)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    pimpl->joinWorkers();
+    delete pimpl;
+    pimpl = nullptr;
+}
+
+bool WorkerPool::resize(const std::size_t nrOfWorkerThreads)
+{
+    if (nrOfWorkerThreads == pimpl->workers.size())
+    {
+        return true;
+    }
+
+    pimpl->joinWorkers();
+
+    try
+    {
+        pimpl->workers.reserve(nrOfWorkerThreads);
+        for (std::size_t i=0; i < nrOfWorkerThreads; i++)
+        {
+            pimpl->workers.emplace_back(&WorkerPoolPrivateAttributes::workerLoop, pimpl, pimpl->generation);
+        }
+    }
+    catch (const std::system_error&)
+    {
+        reportError("WorkerPool","resize","Impossible to create the worker threads");
+        pimpl->joinWorkers();
+        return false;
+    }
+
+    return true;
+}
+
+std::size_t WorkerPool::getNrOfWorkerThreads() const
+{
+    return pimpl->workers.size();
+}
+
+void WorkerPool::run(const std::size_t nrOfTasks, TaskFunction task, void* context)
+{
+    // With a single task (or without workers) waking up the workers only adds overhead
+    if (pimpl->workers.empty() || nrOfTasks <= 1)
+    {
+        for (std::size_t taskIndex=0; taskIndex < nrOfTasks; taskIndex++)
+        {
+            task(context, taskIndex);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(pimpl->mutex);
+        pimpl->task = task;
+        pimpl->context = context;
+        pimpl->nrOfTasks = nrOfTasks;
+        pimpl->nextTask = 0;
+        pimpl->nrOfBusyWorkers = pimpl->workers.size();
+        pimpl->generation++;
+    }
+    pimpl->newTasksCondition.notify_all();
+
+    // The calling thread executes the tasks as well
+    pimpl->executeTasks();
+
+    std::unique_lock<std::mutex> lock(pimpl->mutex);
+    pimpl->tasksCompletedCondition.wait(lock, [&] { return pimpl->nrOfBusyWorkers == 0; });
+}
+
+}
@@ -4,7 +4,9 @@
 #include "iDynTree/CubicSpline.h"
 #include "iDynTree/TestUtils.h"
 #include "iDynTree/VectorFixSize.h"
+#include "iDynTree/MatrixDynSize.h"
 #include <cmath>
+#include <vector>
 
 using namespace iDynTree;
 using namespace std;
@@ -73,10 +75,82 @@ bool splineTest(){
 
     assertTrue(setNpoints(100,initialTime,finalTime,parameters, spline));
     assertTrue(checkNpoints(500, initialTime, finalTime, parameters, spline));
+
+    // The smallest system of intermediate velocities, that depends on both the initial and the final velocity
+    assertTrue(setNpoints(2,initialTime,finalTime,parameters, spline));
+    assertTrue(checkNpoints(50, initialTime, finalTime, parameters, spline));
+
+    // Queries that are not monotone have to find the right interval as well
+    assertTrue(setNpoints(100,initialTime,finalTime,parameters, spline));
+    for (int i = 0; i < 200; ++i){
+        double t = getRandomDouble(initialTime, finalTime);
+        double expected = parameters(0) + parameters(1)*t + parameters(2)*pow(t,2) + parameters(3)*pow(t,3);
+        assertDoubleAreEqual(expected, spline.evaluatePoint(t), std::abs(expected)*DEFAULT_TOL, "Pos i = ", i);
+    }
+    return true;
+}
+
+bool multiChannelSplineTest(){
+    const size_t channels = 5, knots = 80;
+    double initialTime = -1.0;
+    double finalTime = 3.0;
+
+    std::vector<CubicSpline> singleSplines(channels);
+    MultiChannelCubicSpline spline;
+    VectorDynSize time(knots), initialVelocities(channels), finalVelocities(channels);
+    VectorDynSize initialAccelerations(channels), finalAccelerations(channels);
+    MatrixDynSize yData(channels, knots);
+
+    for (size_t k = 0; k < knots; ++k){
+        time(k) = initialTime + (finalTime - initialTime) * std::pow(static_cast<double>(k) / (knots - 1), 2);
+    }
+
+    for (size_t c = 0; c < channels; ++c){
+        VectorDynSize channelData(knots);
+        getRandomVector(channelData);
+        for (size_t k = 0; k < knots; ++k){
+            yData(c, k) = channelData(k);
+        }
+        initialVelocities(c) = getRandomDouble();
+        finalVelocities(c) = getRandomDouble();
+        initialAccelerations(c) = getRandomDouble();
+        finalAccelerations(c) = getRandomDouble();
+        singleSplines[c].setInitialConditions(initialVelocities(c), initialAccelerations(c));
+        singleSplines[c].setFinalConditions(finalVelocities(c), finalAccelerations(c));
+        assertTrue(singleSplines[c].setData(time, channelData));
+    }
+
+    assertTrue(spline.setData(time, yData));
+    assertTrue(spline.setInitialConditions(initialVelocities, initialAccelerations));
+    assertTrue(spline.setFinalConditions(finalVelocities, finalAccelerations));
+    assertTrue(spline.getNrOfChannels() == channels);
+
+    VectorDynSize positions, velocities, accelerations;
+    double velocity, acceleration;
+    for (int i = 0; i < 500; ++i){
+        // Monotone queries first, then random ones (including the ones outside the time range)
+        double t = (i < 250) ? initialTime + (finalTime - initialTime) * i / 249.0 : getRandomDouble(initialTime - 0.5, finalTime + 0.5);
+        assertTrue(spline.evaluatePoint(t, positions, velocities, accelerations));
+        for (size_t c = 0; c < channels; ++c){
+            assertDoubleAreEqual(singleSplines[c].evaluatePoint(t, velocity, acceleration), positions(c), DEFAULT_TOL, "Pos i = ", i);
+            assertDoubleAreEqual(velocity, velocities(c), DEFAULT_TOL, "Vel i = ", i);
+            assertDoubleAreEqual(acceleration, accelerations(c), DEFAULT_TOL, "Acc i = ", i);
+        }
+    }
+
+    assertTrue(spline.evaluatePoint(finalTime, positions));
+    for (size_t c = 0; c < channels; ++c){
+        assertDoubleAreEqual(yData(c, knots - 1), positions(c), DEFAULT_TOL, "Final position channel ", static_cast<int>(c));
+    }
+
+    // The conditions need a value for each channel
+    assertTrue(spline.setFinalConditions(VectorDynSize(channels + 1), VectorDynSize(channels + 1)));
+    assertTrue(!spline.evaluatePoint(0.0, positions));
     return true;
 }
 
 int main(){
     assertTrue(splineTest());
+    assertTrue(multiChannelSplineTest());
     return EXIT_SUCCESS;
 }
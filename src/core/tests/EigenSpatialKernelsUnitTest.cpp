@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/EigenSpatialKernels.h>
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/Transform.h>
+#include <iDynTree/Twist.h>
+#include <iDynTree/Wrench.h>
+#include <iDynTree/SpatialInertia.h>
+#include <iDynTree/TestUtils.h>
+
+#include <Eigen/Dense>
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace iDynTree;
+
+void checkTransformKernels(const Transform & a_H_b, const Transform & b_H_c)
+{
+    Transform a_H_c;
+    composeTransforms(a_H_b, b_H_c, a_H_c);
+    ASSERT_EQUAL_MATRIX(a_H_c.asHomogeneousTransform(),
+                        (toEigen(a_H_b.asHomogeneousTransform())*toEigen(b_H_c.asHomogeneousTransform())).eval());
+
+    // The output can be one of the inputs
+    Transform a_H_cInPlace = a_H_b;
+    composeTransforms(a_H_cInPlace, b_H_c, a_H_cInPlace);
+    ASSERT_EQUAL_TRANSFORM(a_H_cInPlace, a_H_c);
+
+    Transform b_H_a;
+    inverseTransform(a_H_b, b_H_a);
+    ASSERT_EQUAL_MATRIX(b_H_a.asHomogeneousTransform(), toEigen(a_H_b.asHomogeneousTransform()).inverse().eval());
+}
+
+void checkSpatialVectorKernels(const Transform & a_H_b, const Twist & v, const Wrench & f)
+{
+    ASSERT_EQUAL_VECTOR(transformMotionVector(a_H_b, toEigen(v)), toEigen(a_H_b*v));
+    ASSERT_EQUAL_VECTOR(inverseTransformMotionVector(a_H_b, toEigen(v)), toEigen(a_H_b.inverse()*v));
+    ASSERT_EQUAL_VECTOR(transformForceVector(a_H_b, toEigen(f)), toEigen(a_H_b*f));
+    ASSERT_EQUAL_VECTOR(inverseTransformForceVector(a_H_b, toEigen(f)), toEigen(a_H_b.inverse()*f));
+
+    Twist m = getRandomTwist();
+    ASSERT_EQUAL_VECTOR(crossMotion(toEigen(v), toEigen(m)), toEigen(v*m));
+    ASSERT_EQUAL_VECTOR(crossForce(toEigen(v), toEigen(f)), toEigen(v*f));
+}
+
+void checkSpatialInertiaKernel(const Transform & a_H_b, const SpatialInertia & I_b, const SpatialInertia & I_a)
+{
+    // I_a + a_X_b^* I_b b_X_a, computed with the 6x6 matrices
+    Matrix6x6 expected;
+    Eigen::Matrix<double,6,6> b_X_a = toEigen(a_H_b.inverse().asAdjointTransform());
+    toEigen(expected) = toEigen(I_a.asMatrix()) + b_X_a.transpose()*toEigen(I_b.asMatrix())*b_X_a;
+
+    SpatialInertia sum = I_a;
+    addTransformedSpatialInertia(a_H_b, I_b, sum);
+    ASSERT_EQUAL_MATRIX(sum.asMatrix(), expected);
+}
+
+int main()
+{
+    for (int i=0; i < 10; i++)
+    {
+        Transform a_H_b = getRandomTransform();
+        checkTransformKernels(a_H_b, getRandomTransform());
+        checkSpatialVectorKernels(a_H_b, getRandomTwist(), getRandomWrench());
+        checkSpatialInertiaKernel(a_H_b, getRandomInertia(), getRandomInertia());
+    }
+
+    // Inertias with zero mass are supported as well
+    Transform a_H_b = getRandomTransform();
+    SpatialInertia zeroMassInertia = getRandomInertia();
+    Vector10 inertialParams = zeroMassInertia.asVector();
+    inertialParams(0) = inertialParams(1) = inertialParams(2) = inertialParams(3) = 0.0;
+    zeroMassInertia.fromVector(inertialParams);
+    checkSpatialInertiaKernel(a_H_b, zeroMassInertia, SpatialInertia::Zero());
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/TestUtils.h>
+#include <iDynTree/WorkerPool.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
+using namespace iDynTree;
+
+void checkAllTasksAreExecutedOnce(WorkerPool & pool, const size_t nrOfTasks)
+{
+    std::vector<int> executions(nrOfTasks, 0);
+    std::atomic<size_t> nrOfExecutedTasks(0);
+
+    auto task = [&](size_t taskIndex)
+    {
+        executions[taskIndex]++;
+        nrOfExecutedTasks++;
+    };
+    pool.run(nrOfTasks, task);
+
+    ASSERT_IS_TRUE(nrOfExecutedTasks == nrOfTasks);
+    for (size_t i=0; i < nrOfTasks; i++)
+    {
+        ASSERT_IS_TRUE(executions[i] == 1);
+    }
+}
+
+void checkWorkerPool(WorkerPool & pool)
+{
+    // Repeated calls, with a number of tasks smaller and larger than the number of threads
+    for (size_t call=0; call < 100; call++)
+    {
+        checkAllTasksAreExecutedOnce(pool, 0);
+        checkAllTasksAreExecutedOnce(pool, 1);
+        checkAllTasksAreExecutedOnce(pool, 3);
+        checkAllTasksAreExecutedOnce(pool, 1000);
+    }
+}
+
+int main()
+{
+    WorkerPool pool;
+    ASSERT_IS_TRUE(pool.getNrOfWorkerThreads() == 0);
+    checkWorkerPool(pool);
+
+    ASSERT_IS_TRUE(pool.resize(4));
+    ASSERT_IS_TRUE(pool.getNrOfWorkerThreads() == 4);
+    checkWorkerPool(pool);
+
+    ASSERT_IS_TRUE(pool.resize(1));
+    ASSERT_IS_TRUE(pool.getNrOfWorkerThreads() == 1);
+    checkWorkerPool(pool);
+
+    ASSERT_IS_TRUE(pool.resize(0));
+    ASSERT_IS_TRUE(pool.getNrOfWorkerThreads() == 0);
+    checkWorkerPool(pool);
+
+    // The destructor joins the worker threads
+    ASSERT_IS_TRUE(pool.resize(2));
+
+    return EXIT_SUCCESS;
+}
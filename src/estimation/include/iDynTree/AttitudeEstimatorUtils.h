@@ -16,7 +16,7 @@
  * @param[in] a vector3
  * @return bool true/false
  */
-bool checkValidMeasurement(const iDynTree::Vector3& in, const std::string& measurement_type, bool check_also_zero_vector);
+bool checkValidMeasurement(const iDynTree::Vector3& in, const char* measurement_type, bool check_also_zero_vector);
 
 /**
  *
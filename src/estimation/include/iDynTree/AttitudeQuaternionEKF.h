@@ -13,6 +13,7 @@ namespace iDynTree
     const unsigned int output_dimensions_with_magnetometer = 4;        ///< dimension of \f$ \mathbb{R}^3 \times \mathbb{R} \f$ accelerometer measurements and magnetometer yaw measurement
     const unsigned int output_dimensions_without_magnetometer = 3;     ///< dimension of \f$ \mathbb{R}^3 \f$ accelerometer measurements
     const unsigned int input_dimensions = 3;                           ///< dimension of \f$ \mathbb{R}^3 \f$ gyroscope measurements
+    const unsigned int state_dimensions = 10;                          ///< dimension of \f$ \mathbb{R}^4 \times \mathbb{R}^3 \times \mathbb{R}^3 \f$ orientation, angular velocity and gyroscope bias
 
     /**
      * @struct AttitudeQuaternionEKFParameters Parameters to set up the quaternion EKF
@@ -101,10 +102,13 @@ namespace iDynTree
      * @warning calling the method useMagnetometerMeasurements() while the estimator is running, will reset the filter, reinitialize the filter to resize buffers
      * and sets the previous estiamted state as the inital state.
      * @note calling other set parameter methods does not reset the filter, since they are not associated with changing the output dimensions
+     * @note the filter is implemented on DiscreteExtendedKalmanFilterFixedSizeHelper, so the predict and update steps do not allocate memory
      *
      */
     class AttitudeQuaternionEKF : public IAttitudeEstimator,
-                                  public DiscreteExtendedKalmanFilterHelper
+                                  public DiscreteExtendedKalmanFilterFixedSizeHelper<state_dimensions,
+                                                                                     input_dimensions,
+                                                                                     output_dimensions_with_magnetometer>
     {
     public:
         AttitudeQuaternionEKF();
@@ -225,9 +229,9 @@ namespace iDynTree
          * \f$ u = \begin{bmatrix} {y_{gyro}}_x & {y_{gyro}}_y & {y_{gyro}}_z \end{bmatrix}^T \f$
          * \f$ f(X, u) = \begin{bmatrix} q_{k} \otimes \text{exp}(\omega \Delta T) \\ y_{gyro} - b \\ (1 - \lambda_{b} \Delta t)b \end{bmatrix}\f$
          */
-        bool ekf_f(const iDynTree::VectorDynSize& x_k,
-               const iDynTree::VectorDynSize& u_k,
-               iDynTree::VectorDynSize& xhat_k_plus_one) override;
+        bool ekf_f(const StateVector& x_k,
+               const InputVector& u_k,
+               StateVector& xhat_k_plus_one) override;
 
         /**
          * discrete measurement prediction
@@ -235,18 +239,18 @@ namespace iDynTree
          * \f$ h_{acc}(X) = R^T \begin{bmatrix} 0 \\  0 \\ -1 \end{bmatrix} \f$
          * \f$ h_{mag}(X) = atan2(tan(yaw))\f$
          */
-        bool ekf_h(const iDynTree::VectorDynSize& xhat_k_plus_one,
-               iDynTree::VectorDynSize& zhat_k_plus_one) override;
+        bool ekf_h(const StateVector& xhat_k_plus_one,
+               OutputVector& zhat_k_plus_one) override;
 
         /**
          * @brief Describes the system Jacobian necessary for the propagation of predicted state covariance
          *        The analytical Jacobian describing the partial derivative of the system propagation with respect to the state
          * @param[in] x system state
+         * @param[in] u system input
          * @param[out] F system Jacobian
          * @return bool true/false if successful or not
          */
-        bool ekfComputeJacobianF(iDynTree::VectorDynSize& x, iDynTree::MatrixDynSize& F) override;
-        bool ekfComputeJacobianF(iDynTree::VectorDynSize& x, iDynTree::VectorDynSize& u, iDynTree::MatrixDynSize& F) override;
+        bool ekfComputeJacobianF(const StateVector& x, const InputVector& u, StateMatrix& F) override;
 
         /**
          * @brief Describes the measurement Jacobian necessary for computing Kalman gain and updating the predicted state and its covariance
@@ -255,7 +259,7 @@ namespace iDynTree
          * @param[out] H measurement Jacobian
          * @return bool true/false if successful or not
          */
-        bool ekfComputeJacobianH(iDynTree::VectorDynSize& x, iDynTree::MatrixDynSize& H) override;
+        bool ekfComputeJacobianH(const StateVector& x, OutputJacobian& H) override;
 
         /** @brief prepares the system noise covariance matrix using internal struct params
          * system  model is as good as gyroscope measurement and bias estimate
@@ -265,7 +269,7 @@ namespace iDynTree
          * \f$ U = diag(\begin{bmatrix} \sigma_{gyro}^{2} I_{3 \times 3} & \sigma_{gyrobias}^{2} I_{3 \times 3} \end{bmatrix}) \f$
          * @param[in] Q matrix container as reference
          */
-        void prepareSystemNoiseCovarianceMatrix(iDynTree::MatrixDynSize &Q);
+        void prepareSystemNoiseCovarianceMatrix(StateMatrix &Q);
 
         /** @brief prepares the measurement noise covariance matrix using internal struct parameters
          * measurement noise depends only on accelerometer measurement along x-,y- and z- directions
@@ -279,18 +283,18 @@ namespace iDynTree
         void prepareMeasurementNoiseCovarianceMatrix(iDynTree::MatrixDynSize &R);
 
         /**
-         * @brief serializes the state struct to state x of VectorDynSize
+         * @brief serializes the state struct to state vector x
          */
         void serializeStateVector();
 
         /**
-         * @brief deserializes state x of VectorDynSize to the state struct
+         * @brief deserializes state vector x to the state struct
          */
         void deserializeStateVector();
 
         /**
          * @brief serializes the accelerometer and magenetometer measurements into y vector
-         * since DiscreteExtendedKalmanFilter expects a VectorDynSize including all necessary measurements
+         * since the EKF expects a vector including all necessary measurements
          */
         void serializeMeasurementVector();
 
@@ -310,13 +314,13 @@ namespace iDynTree
         iDynTree::LinearAccelerometerMeasurements m_Acc_y;       ///< 3d accelerometer measurement giving proper classical acceleration expressed in body frame
         double m_Mag_y;                                          ///< magnetometer yaw measurement expressed in body frame
 
-        iDynTree::VectorDynSize m_x;                             ///< state vector for the EKF - orientation, angular velocity, gyro bias
-        iDynTree::VectorDynSize m_y;                             ///< measurement vector for the EKF - accelerometer (and magnetometer yaw)
-        iDynTree::VectorDynSize m_u;                             ///< input vector for the EKF - gyroscope measurement
+        StateVector m_x;                                         ///< state vector for the EKF - orientation, angular velocity, gyro bias
+        OutputVector m_y;                                        ///< measurement vector for the EKF - accelerometer (and magnetometer yaw), of which the first m_output_size elements are used
+        InputVector m_u;                                         ///< input vector for the EKF - gyroscope measurement
 
-        size_t m_state_size;                                     ///< state dimensions
-        size_t m_output_size;                                    ///< output dimensions
-        size_t m_input_size;                                     ///< input dimensions
+        size_t m_state_size{state_dimensions};                   ///< state dimensions
+        size_t m_output_size{output_dimensions_without_magnetometer}; ///< output dimensions
+        size_t m_input_size{input_dimensions};                   ///< input dimensions
         bool m_initialized{false};                               ///< flag to check if QEKF is initialized
 
         iDynTree::Matrix4x4 m_Id4;                               ///< \f$ 4 \times 4 \f$  identity matrix
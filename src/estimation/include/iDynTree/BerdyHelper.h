@@ -11,6 +11,7 @@
 #include <iDynTree/VectorFixSize.h>
 #include <iDynTree/Utils.h>
 #include <iDynTree/Triplets.h>
+#include <iDynTree/SparseMatrix.h>
 
 #include <iDynTree/Indices.h>
 #include <iDynTree/LinkState.h>
@@ -430,6 +431,19 @@ class BerdyHelper
     bool computeBerdyDynamicsMatricesFixedBase(SparseMatrix<iDynTree::ColumnMajor>& D, VectorDynSize& bD);
     bool computeBerdyDynamicsMatricesFloatingBase(SparseMatrix<iDynTree::ColumnMajor>& D, VectorDynSize& bD);
 
+    /**
+     * Write the elements of a Berdy matrix in matrix.
+     *
+     * The first time (after init) the sparsity pattern is computed from the elements and saved in pattern,
+     * together with the position in the values of the pattern of each element. As the elements are always
+     * generated in the same order, the following times the pattern is copied in matrix (if different)
+     * and the elements are only summed in its values, without sorting them.
+     */
+    void setBerdyMatrixFromTriplets(const Triplets& elements,
+                                    SparseMatrix<iDynTree::ColumnMajor>& pattern,
+                                    std::vector<size_t>& elementsToValues,
+                                    SparseMatrix<iDynTree::ColumnMajor>& matrix);
+
     // Helper method
     Matrix6x1 getBiasTermJointAccelerationPropagation(IJointConstPtr joint,
                                                       const LinkIndex parentLinkIdx,
@@ -488,6 +502,16 @@ class BerdyHelper
     Triplets matrixDElements;
     Triplets matrixYElements;
 
+    /**
+     * Sparsity patterns of the D and Y matrices, and position in their values
+     * of each element of matrixDElements and matrixYElements.
+     * Computed by the first call to getBerdyMatrices after init.
+     */
+    SparseMatrix<iDynTree::ColumnMajor> m_matrixDPattern;
+    SparseMatrix<iDynTree::ColumnMajor> m_matrixYPattern;
+    std::vector<size_t> m_matrixDElementsToValues;
+    std::vector<size_t> m_matrixYElementsToValues;
+
     /**
      * Transform between the frame in which the external net wrench measurements are expressed
      * and the link frames.
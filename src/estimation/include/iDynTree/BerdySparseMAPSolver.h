@@ -22,6 +22,10 @@ namespace iDynTree {
     /**
      * @warning This class is still in active development, and so API interface can change between iDynTree versions.
      * \ingroup iDynTreeExperimental
+     *
+     * @note After initialize, updateEstimateInformationFixedBase, updateEstimateInformationFloatingBase and
+     *       doEstimate do not allocate memory on the heap, as long as the sparsity pattern of the priors
+     *       does not change. If it changes, the sparsity pattern of the decomposition is recomputed.
      */
     class BerdySparseMAPSolver
     {
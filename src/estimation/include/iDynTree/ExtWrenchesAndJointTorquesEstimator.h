@@ -43,6 +43,11 @@ namespace iDynTree
  *   * ExtWrenchesAndJointTorquesEstimator::computeExpectedFTSensorsMeasurements
  *   * ExtWrenchesAndJointTorquesEstimator::computeSubModelMatrixRelatingFTSensorsMeasuresAndKinematics
  * Details of each method can be found in the method documentation
+ *
+ * After the model and sensors have been loaded, updateKinematicsFromFloatingBase, updateKinematicsFromFixedBase,
+ * computeExpectedFTSensorsMeasurements and estimateExtWrenchesAndJointTorques do not allocate memory
+ * on the heap once they have been called for a given set of unknown wrenches, so they can be used
+ * in real-time control loops.
  */
 class ExtWrenchesAndJointTorquesEstimator
 {
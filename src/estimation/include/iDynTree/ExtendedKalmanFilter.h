@@ -6,7 +6,10 @@
 
 #include <iDynTree/VectorDynSize.h>
 #include <iDynTree/MatrixDynSize.h>
+#include <iDynTree/VectorFixSize.h>
+#include <iDynTree/MatrixFixSize.h>
 #include <iDynTree/Utils.h>
+#include <iDynTree/EigenHelpers.h>
 #include <vector>
 
 namespace iDynTree
@@ -315,6 +318,517 @@ namespace iDynTree
         bool m_initial_state_set{false};               ///< flag to check if the initial state of the filter is set
         bool m_initial_state_covariance_set{false};    ///< flag to check if the initial covariance is set properly
     };
+
+    /**
+     * @class DiscreteExtendedKalmanFilterFixedSizeHelper discrete EKF with additive Gaussian noise and compile-time dimensions
+     *
+     * Same filter of DiscreteExtendedKalmanFilterHelper (with the same workflow, the same flags and the same
+     * Span based interface), for estimators whose state and input sizes are known at compile time.
+     * All the vectors and matrices are fixed-size members, so predict and update steps never allocate memory.
+     *
+     * The number of measurements can change at run time (for example when a sensor is enabled or disabled),
+     * but it can not exceed the maxOutputSize template parameter: the number of measurements actually used is set with
+     * ekfSetOutputSize() and only the first ekfGetOutputSize() elements of the measurement vector and rows of
+     * the measurement Jacobian are considered.
+     *
+     * Differently from DiscreteExtendedKalmanFilterHelper, the update step does not invert the innovation covariance.
+     * The measurements are decorrelated with the \f$ L D L^T \f$ decomposition of the measurement noise covariance
+     * (computed only when it is set), and then processed one at a time as scalar measurements,
+     * updating the state covariance with the Joseph form
+     * \f$ P = (I - k h) P (I - k h)^T + k d k^T \f$, that keeps it symmetric and positive semi-definite.
+     * In exact arithmetic the result is the same of the batch update.
+     *
+     * @note a derived class must implement ekf_f(), ekf_h(), ekfComputeJacobianF() and ekfComputeJacobianH() using the fixed-size types.
+     */
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    class DiscreteExtendedKalmanFilterFixedSizeHelper
+    {
+    public:
+        typedef VectorFixSize<stateSize> StateVector;
+        typedef VectorFixSize<inputSize> InputVector;
+        typedef VectorFixSize<maxOutputSize> OutputVector;
+        typedef MatrixFixSize<stateSize, stateSize> StateMatrix;
+        typedef MatrixFixSize<maxOutputSize, stateSize> OutputJacobian;
+
+        DiscreteExtendedKalmanFilterFixedSizeHelper();
+
+        virtual ~DiscreteExtendedKalmanFilterFixedSizeHelper() {}
+
+        /**
+         * @brief Describes the state propagation for a given dynamical system, \f$ x_{k+1} = f(x_k, u_k) \f$.
+         * @param[in] x_k state at current time instant
+         * @param[in] u_k control input at current time instant
+         * @param[out] xhat_k_plus_one predicted state without any correction from measurements
+         * @return bool true/false if successful or not
+         */
+        virtual bool ekf_f(const StateVector& x_k,
+                           const InputVector& u_k,
+                                 StateVector& xhat_k_plus_one) = 0;
+
+        /**
+         * @brief Describes the measurement model of the system, \f$ z_{k+1} = h(\hat{x}_{k+1}) \f$.
+         * @param[in] xhat_k_plus_one predicted state of next time instant
+         * @param[out] zhat_k_plus_one predicted measurement of next time instant, only the first ekfGetOutputSize() elements are used
+         * @return bool true/false if successful or not
+         */
+        virtual bool ekf_h(const StateVector& xhat_k_plus_one,
+                                 OutputVector& zhat_k_plus_one) = 0;
+
+        /**
+         * @brief Describes the partial derivative of the system propagation with respect to the state
+         * @param[in] x system state
+         * @param[in] u system input
+         * @param[out] F system Jacobian
+         * @return bool true/false if successful or not
+         */
+        virtual bool ekfComputeJacobianF(const StateVector& x, const InputVector& u, StateMatrix& F) = 0;
+
+        /**
+         * @brief Describes the partial derivative of the measurement model with respect to the state
+         * @param[in] x system state
+         * @param[out] H measurement Jacobian, only the first ekfGetOutputSize() rows are used
+         * @return bool true/false if successful or not
+         */
+        virtual bool ekfComputeJacobianH(const StateVector& x, OutputJacobian& H) = 0;
+
+        /**
+         * @brief Implements the Discrete EKF prediction equation
+         *        \f$ \hat{x}_{k+1} = f(x_k, u_k) \f$ and \f$ \hat{P}_{k+1} = F_k P_k F_k^T + Q \f$
+         * @note the input vector should be set with ekfSetInputVector() before each call, as in DiscreteExtendedKalmanFilterHelper::ekfPredict()
+         * @return bool true/false if successful or not
+         */
+        bool ekfPredict();
+
+        /**
+         * @brief Implements the Discrete EKF update equation, processing the decorrelated measurements sequentially
+         * @note the measurement vector must be set with ekfSetMeasurementVector() before each call, as in DiscreteExtendedKalmanFilterHelper::ekfUpdate()
+         * @return bool true/false if successful or not
+         */
+        bool ekfUpdate();
+
+        /**
+         * @brief Resets the filter flags
+         * @see DiscreteExtendedKalmanFilterHelper::ekfReset()
+         */
+        void ekfReset();
+
+        /**
+         * @brief Set the number of measurements used by the update step
+         * @param[in] dim_Y output size, at most maxOutputSize
+         * @note the measurement noise covariance matrix is reset to zero, so it should be set again after calling this method
+         * @return bool true/false if successful or not
+         */
+        bool ekfSetOutputSize(size_t dim_Y);
+
+        /**
+         * @brief Get the number of measurements used by the update step
+         */
+        size_t ekfGetOutputSize() const { return m_dim_Y; }
+
+        /**
+         * @brief Set measurement vector at every time step, of size ekfGetOutputSize()
+         */
+        bool ekfSetMeasurementVector(const iDynTree::Span<double>& y);
+
+        /**
+         * @brief Set input vector at every time step, of size inputSize
+         */
+        bool ekfSetInputVector(const iDynTree::Span<double>& u);
+
+        /**
+         * @brief Set initial state, of size stateSize
+         */
+        bool ekfSetInitialState(const iDynTree::Span<double>& x0);
+
+        /**
+         * @brief Set state covariance matrix, of size (stateSize*stateSize) in row-major ordering
+         */
+        bool ekfSetStateCovariance(const iDynTree::Span<double>& P);
+
+        /**
+         * @brief Set system noise covariance matrix, of size (stateSize*stateSize) in row-major ordering
+         * @note default value is a zero matrix
+         */
+        bool ekfSetSystemNoiseCovariance(const iDynTree::Span<double>& Q);
+
+        /**
+         * @brief Set measurement noise covariance matrix, of size (output size*output size) in row-major ordering
+         * @note default value is a zero matrix
+         * @warning the matrix must be symmetric and positive semi-definite, otherwise it is reset to zero
+         */
+        bool ekfSetMeasurementNoiseCovariance(const iDynTree::Span<double>& R);
+
+        /**
+         * @brief Get current internal state of the filter, of size stateSize
+         */
+        bool ekfGetStates(const iDynTree::Span<double> &x) const;
+
+        /**
+         * @brief Get state covariance matrix, of size (stateSize*stateSize) in row-major ordering
+         */
+        bool ekfGetStateCovariance(const iDynTree::Span<double> &P) const;
+
+    protected:
+        /**
+        * function template to ignore unused parameters
+        */
+        template <typename T>
+        void ignore(T &&) { }
+
+    private:
+        size_t m_dim_Y{maxOutputSize};                 ///< output dimension
+        StateVector m_x;                               ///< state at time instant k
+        InputVector m_u;                               ///< input at time instant k
+        OutputVector m_y;                              ///< measurements at time instant k
+        OutputVector m_z;                              ///< predicted measurements
+        StateVector m_xhat;                            ///< predicted state at time instant k before updating measurements
+
+        StateMatrix m_F;                               ///< System jacobian
+        StateMatrix m_P;                               ///< State covariance
+        StateMatrix m_Phat;                            ///< State covariance estimate before updating measurements
+        StateMatrix m_Q;                               ///< system noise covariance
+        OutputJacobian m_H;                            ///< measurement jacobian
+        MatrixFixSize<maxOutputSize, maxOutputSize> m_R;                ///< measurement noise covariance
+        MatrixFixSize<maxOutputSize, maxOutputSize> m_RFactorL;         ///< unit lower triangular factor of \f$ R = L D L^T \f$
+        OutputVector m_RFactorD;                                        ///< diagonal of \f$ D \f$ in \f$ R = L D L^T \f$
+        bool m_measurement_updated{false};             ///< flag to check if measurement is updated at each update step
+        bool m_input_updated{false};                   ///< flag to check if control input is updated at each prediction step
+        bool m_initial_state_set{false};               ///< flag to check if the initial state of the filter is set
+        bool m_initial_state_covariance_set{false};    ///< flag to check if the initial covariance is set properly
+
+        /**
+         * Compute m_RFactorL and m_RFactorD from the first m_dim_Y rows and columns of m_R
+         */
+        bool factorizeMeasurementNoiseCovariance();
+    };
+
+    // Implementation
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::DiscreteExtendedKalmanFilterFixedSizeHelper()
+    {
+        m_x.zero();
+        m_u.zero();
+        m_y.zero();
+        m_z.zero();
+        m_xhat.zero();
+        m_F.zero();
+        m_P.zero();
+        m_Phat.zero();
+        m_Q.zero();
+        m_H.zero();
+        m_R.zero();
+        factorizeMeasurementNoiseCovariance();
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    void DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfReset()
+    {
+        m_measurement_updated = false;
+        m_input_updated = false;
+        m_initial_state_set = false;
+        m_initial_state_covariance_set = false;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfPredict()
+    {
+        if (!m_initial_state_set)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfPredict", "initial state not set.");
+            return false;
+        }
+
+        if (!m_initial_state_covariance_set)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfPredict", "initial state covariance not set.");
+            return false;
+        }
+
+        if (!m_input_updated)
+        {
+            iDynTree::reportWarning("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfPredict", "input not updated. using old input");
+        }
+
+        if (!ekf_f(m_x, m_u, m_xhat) ||                 ///< \f$ \hat{x}_{k+1} = f(x_k, u_k) \f$
+            !ekfComputeJacobianF(m_x, m_u, m_F))        ///< \f$ F \mid_{x = x_k} \f$
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfPredict", "unable to propagate the state.");
+            return false;
+        }
+
+        using iDynTree::toEigen;
+        auto P(toEigen(m_P));
+        auto Phat(toEigen(m_Phat));
+        auto F(toEigen(m_F));
+
+        Phat.noalias() = F*P*(F.transpose());       ///< \f$ \hat{P}_{k+1} = F_k P_k F_k^T + Q \f$
+        Phat += toEigen(m_Q);
+        m_input_updated = false;
+        return true;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfUpdate()
+    {
+        if (!m_initial_state_set)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfUpdate", "initial state not set.");
+            return false;
+        }
+
+        if (!m_initial_state_covariance_set)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfUpdate", "initial state covariance not set.");
+            return false;
+        }
+
+        if (!m_measurement_updated)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfUpdate", "measurements not updated.");
+            return false;
+        }
+
+        if (!ekf_h(m_xhat, m_z) ||                      ///< \f$ z_{k+1} = h(\hat{x}_{k+1}) \f$
+            !ekfComputeJacobianH(m_xhat, m_H))          ///< \f$ H \mid_{x = \hat{x}_{k+1}} \f$
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfUpdate", "unable to compute the predicted measurements.");
+            return false;
+        }
+
+        using iDynTree::toEigen;
+        auto P(toEigen(m_P));
+        auto H(toEigen(m_H));
+        auto L(toEigen(m_RFactorL));
+        auto innovation(toEigen(m_z));
+
+        // decorrelate the measurements, replacing the innovation and H with L^{-1} (y - z) and L^{-1} H
+        innovation = toEigen(m_y) - innovation;
+        for (size_t i = 1; i < m_dim_Y; i++)
+        {
+            for (size_t j = 0; j < i; j++)
+            {
+                innovation(i) -= L(i, j)*innovation(j);
+                H.row(i) -= L(i, j)*H.row(j);
+            }
+        }
+
+        Eigen::Matrix<double, stateSize, 1> dx, b, k, c;
+        dx.setZero();
+        P = toEigen(m_Phat);
+        for (size_t i = 0; i < m_dim_Y; i++)
+        {
+            auto h(H.row(i));
+            b.noalias() = P*h.transpose();
+            double hb = h.dot(b);
+            double s = hb + m_RFactorD(i);           ///< scalar innovation covariance \f$ s = h P h^T + d \f$
+            if (!(s > 0.0))
+            {
+                if (hb == 0.0)
+                {
+                    // the measurement does not depend on the state
+                    continue;
+                }
+                iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfUpdate", "innovation covariance is not positive definite.");
+                return false;
+            }
+
+            k = b/s;                                   ///< \f$ k = P h^T s^{-1} \f$
+            dx += k*(innovation(i) - h.dot(dx));
+
+            // Joseph form, with (I - k h) P = P - k b^T and (I - k h) P h^T = b - k (h b)
+            P.noalias() -= k*b.transpose();
+            c = b - k*hb;
+            P.noalias() -= c*k.transpose();
+            P.noalias() += m_RFactorD(i)*k*k.transpose();
+        }
+        P = 0.5*(P + P.transpose()).eval();
+
+        toEigen(m_x) = toEigen(m_xhat) + dx;         ///< \f$ x_{k+1} = \hat{x}_{k+1} + K_{k+1} \tilde{y}_{k+1} \f$
+
+        m_measurement_updated = false;
+        return true;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::factorizeMeasurementNoiseCovariance()
+    {
+        m_RFactorL.zero();
+        m_RFactorD.zero();
+        for (size_t j = 0; j < m_dim_Y; j++)
+        {
+            m_RFactorL(j, j) = 1.0;
+            double d = m_R(j, j);
+            for (size_t k = 0; k < j; k++)
+            {
+                d -= m_RFactorL(j, k)*m_RFactorL(j, k)*m_RFactorD(k);
+            }
+
+            if (d < 0.0)
+            {
+                return false;
+            }
+            m_RFactorD(j) = d;
+
+            // with a zero pivot the rest of the column is zero for a positive semi-definite matrix
+            if (d == 0.0)
+            {
+                continue;
+            }
+
+            for (size_t i = j + 1; i < m_dim_Y; i++)
+            {
+                double l = m_R(i, j);
+                for (size_t k = 0; k < j; k++)
+                {
+                    l -= m_RFactorL(i, k)*m_RFactorL(j, k)*m_RFactorD(k);
+                }
+                m_RFactorL(i, j) = l/d;
+            }
+        }
+        return true;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfSetOutputSize(size_t dim_Y)
+    {
+        if (dim_Y == 0 || dim_Y > maxOutputSize)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfSetOutputSize", "output size must be positive and not greater than the maximum output size");
+            return false;
+        }
+
+        m_dim_Y = dim_Y;
+        m_y.zero();
+        m_R.zero();
+        m_measurement_updated = false;
+        return factorizeMeasurementNoiseCovariance();
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfSetInitialState(const iDynTree::Span<double>& x0)
+    {
+        if ((size_t)x0.size() != stateSize)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfSetInitialState", "state size mismatch");
+            return false;
+        }
+
+        toEigen(m_x) = toEigen(x0);
+        m_initial_state_set = true;
+        return true;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfSetInputVector(const iDynTree::Span<double>& u)
+    {
+        if ((size_t)u.size() != inputSize)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfSetInputVector", "input size mismatch");
+            return false;
+        }
+
+        toEigen(m_u) = toEigen(u);
+        m_input_updated = true;
+        return true;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfSetMeasurementVector(const iDynTree::Span<double>& y)
+    {
+        if ((size_t)y.size() != m_dim_Y)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfSetMeasurementVector", "measurement size mismatch");
+            return false;
+        }
+
+        toEigen(m_y).head(m_dim_Y) = toEigen(y);
+        m_measurement_updated = true;
+        return true;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfSetStateCovariance(const iDynTree::Span<double>& P)
+    {
+        if ((size_t)P.size() != stateSize*stateSize)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfSetStateCovariance", "state covariance matrix size mismatch");
+            return false;
+        }
+
+        m_P = StateMatrix(P.data(), stateSize, stateSize);
+        m_initial_state_covariance_set = true;
+        return true;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfSetSystemNoiseCovariance(const iDynTree::Span<double>& Q)
+    {
+        if ((size_t)Q.size() != stateSize*stateSize)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfSetSystemNoiseCovariance", "noise covariance matrix size mismatch");
+            return false;
+        }
+
+        m_Q = StateMatrix(Q.data(), stateSize, stateSize);
+        return true;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfSetMeasurementNoiseCovariance(const iDynTree::Span<double>& R)
+    {
+        if ((size_t)R.size() != m_dim_Y*m_dim_Y)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfSetMeasurementNoiseCovariance", "noise covariance matrix size mismatch");
+            return false;
+        }
+
+        m_R.zero();
+        for (size_t i = 0; i < m_dim_Y; i++)
+        {
+            for (size_t j = 0; j < m_dim_Y; j++)
+            {
+                m_R(i, j) = R(i*m_dim_Y + j);
+            }
+        }
+
+        if (!factorizeMeasurementNoiseCovariance())
+        {
+            m_R.zero();
+            factorizeMeasurementNoiseCovariance();
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfSetMeasurementNoiseCovariance", "noise covariance matrix is not positive semi-definite");
+            return false;
+        }
+        return true;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfGetStates(const iDynTree::Span<double>& x) const
+    {
+        if ((size_t)x.size() != stateSize)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfGetStates", "state size mismatch");
+            return false;
+        }
+
+        toEigen(x) = toEigen(m_x);
+        return true;
+    }
+
+    template<unsigned int stateSize, unsigned int inputSize, unsigned int maxOutputSize>
+    bool DiscreteExtendedKalmanFilterFixedSizeHelper<stateSize, inputSize, maxOutputSize>::ekfGetStateCovariance(const iDynTree::Span<double>& P) const
+    {
+        if ((size_t)P.size() != stateSize*stateSize)
+        {
+            iDynTree::reportError("DiscreteExtendedKalmanFilterFixedSizeHelper", "ekfGetStateCovariance", "state covariance size mismatch");
+            return false;
+        }
+
+        for (size_t i = 0; i < stateSize*stateSize; i++)
+        {
+            P(i) = m_P.data()[i];
+        }
+        return true;
+    }
 }
 
 #endif
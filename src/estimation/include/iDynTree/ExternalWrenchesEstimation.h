@@ -212,6 +212,9 @@ struct estimateExternalWrenchesBuffers
     estimateExternalWrenchesBuffers();
     estimateExternalWrenchesBuffers(const SubModelDecomposition& subModels);
     estimateExternalWrenchesBuffers(const size_t nrOfSubModels, const size_t nrOfLinks);
+    estimateExternalWrenchesBuffers(const estimateExternalWrenchesBuffers& other);
+    estimateExternalWrenchesBuffers& operator=(const estimateExternalWrenchesBuffers& other);
+    ~estimateExternalWrenchesBuffers();
 
     /**
      * Resize the struct for the number of submodel
@@ -228,6 +231,30 @@ struct estimateExternalWrenchesBuffers
      */
     bool isConsistent(const SubModelDecomposition& subModels) const;
 
+    /**
+     * Solve the LS problem argmin_x (Ax-b)^2 of a given submodel,
+     * storing the result in x[subModelIndex].
+     *
+     * The storage of the decomposition of A is kept for each submodel,
+     * so no memory is allocated if the size of A did not change since
+     * the last call.
+     */
+    void solveLeastSquaresProblem(const size_t subModelIndex);
+
+    /**
+     * Set the number of worker threads used by estimateExternalWrenches to estimate
+     * the external wrenches of the different submodels in parallel.
+     *
+     * @param[in] nrOfWorkerThreads the number of worker threads, 0 (the default) to estimate the submodels sequentially.
+     * @return true if all went well, false otherwise (for example if the threads could not be created).
+     */
+    bool setNrOfWorkerThreads(const size_t nrOfWorkerThreads);
+
+    /**
+     * Get the number of worker threads set with setNrOfWorkerThreads.
+     */
+    size_t getNrOfWorkerThreads() const;
+
     /**
      * The problem of external wrenches estimation boils down to
      * solve a LS problem in the form argmin_x (Ax-b)^2 .
@@ -249,6 +276,24 @@ struct estimateExternalWrenchesBuffers
      * A matrices
      */
     LinkPositions subModelBase_H_link;
+
+private:
+    /**
+     * Preallocated decompositions used to solve the LS problem of each submodel.
+     */
+    struct LeastSquaresSolvers;
+    LeastSquaresSolvers * m_solvers;
+
+    friend bool estimateExternalWrenches(const Model& model,
+                                         const SubModelDecomposition& subModels,
+                                         const SensorsList& sensors,
+                                         const LinkUnknownWrenchContacts & unknownWrenches,
+                                         const JointPosDoubleArray & jointPos,
+                                         const LinkVelArray & linkVel,
+                                         const LinkAccArray & linkProperAcc,
+                                         const SensorsMeasurements & ftSensorsMeasurements,
+                                               estimateExternalWrenchesBuffers & bufs,
+                                               LinkContactWrenches & outputContactWrenches);
 };
 
 /**
@@ -285,6 +330,8 @@ bool estimateExternalWrenchesWithoutInternalFT(const Model& model,
  * @param[out] outputContactWrenches the estimated contact wrenches.
  * @return true if all went well (the dimension of the inputs are consistent), false otherwise
  *
+ * \note The submodels are independent, so they are split between the worker threads
+ *       set with estimateExternalWrenchesBuffers::setNrOfWorkerThreads.
  */
 bool estimateExternalWrenches(const Model& model,
                               const SubModelDecomposition& subModels,
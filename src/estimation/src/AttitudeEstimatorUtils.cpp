@@ -5,14 +5,14 @@
 #include <vector>
 #include <cmath>
 
-bool checkValidMeasurement(const iDynTree::Vector3& in, const std::string& measurement_type, bool check_also_zero_vector)
+bool checkValidMeasurement(const iDynTree::Vector3& in, const char* measurement_type, bool check_also_zero_vector)
 {
     if (check_also_zero_vector)
     {
         if (isZeroVector(in))
         {
             iDynTree::reportError("AttitudeEstimator", "checkValidMeasurement",
-                                  (measurement_type + " measurements are invalid. Expecting a non-zero vector.").c_str());
+                                  (std::string(measurement_type) + " measurements are invalid. Expecting a non-zero vector.").c_str());
             return false;
         }
     }
@@ -20,7 +20,7 @@ bool checkValidMeasurement(const iDynTree::Vector3& in, const std::string& measu
     if (isVectorNaN(in))
     {
         iDynTree::reportError("AttitudeEstimator", "checkValidMeasurement",
-                              (measurement_type + " measurements are invalid. Has NaN elements.").c_str());
+                              (std::string(measurement_type) + " measurements are invalid. Has NaN elements.").c_str());
         return false;
     }
 
@@ -156,11 +156,11 @@ iDynTree::UnitQuaternion composeQuaternion(const iDynTree::UnitQuaternion &q1, c
 iDynTree::Matrix4x4 mapofYQuaternionToXYQuaternion(const iDynTree::UnitQuaternion &x)
 {
     // unitary matrix structure represented by 2 complex numbers z1 = q0+iq1 and z2 = q2+iq3
-    std::vector<double> v{x(0), -x(1), -x(2), -x(3),
-                          x(1),  x(0), -x(3),  x(2),
-                          x(2),  x(3),  x(0), -x(1),
-                          x(3), -x(2),  x(1),  x(0)};
-    return iDynTree::Matrix4x4(v.data(), 4, 4);
+    double v[16] = {x(0), -x(1), -x(2), -x(3),
+                    x(1),  x(0), -x(3),  x(2),
+                    x(2),  x(3),  x(0), -x(1),
+                    x(3), -x(2),  x(1),  x(0)};
+    return iDynTree::Matrix4x4(v, 4, 4);
 }
 
 iDynTree::UnitQuaternion composeQuaternion2(const iDynTree::UnitQuaternion &q1, const iDynTree::UnitQuaternion &q2)
@@ -12,11 +12,6 @@ void iDynTree::AttitudeQuaternionEKF::serializeStateVector()
     auto Omega(toEigen(m_state_qekf.m_angular_velocity));
     auto b(toEigen(m_state_qekf.m_gyroscope_bias));
 
-    if (m_x.size() != m_state_size)
-    {
-        m_x.resize(m_state_size);
-    }
-
     x.block<4, 1>(0, 0) = q;
     x.block<3, 1>(4, 0) = Omega;
     x.block<3, 1>(7, 0) = b;
@@ -35,17 +30,11 @@ void iDynTree::AttitudeQuaternionEKF::deserializeStateVector()
     b = x.block<3, 1>(7, 0);
 }
 
-void iDynTree::AttitudeQuaternionEKF::prepareSystemNoiseCovarianceMatrix(iDynTree::MatrixDynSize &Q)
+void iDynTree::AttitudeQuaternionEKF::prepareSystemNoiseCovarianceMatrix(StateMatrix &Q)
 {
     using iDynTree::toEigen;
 
-    if (Q.rows() != m_state_size && Q.cols() != m_state_size)
-    {
-        Q.resize(m_state_size, m_state_size);
-    }
-
-
-    iDynTree::MatrixDynSize Fu_dyn(m_state_size, m_input_size + m_state_qekf.m_gyroscope_bias.size());
+    iDynTree::MatrixFixSize<state_dimensions, input_dimensions + 3> Fu_dyn;
     Fu_dyn.zero();
     iDynTree::Matrix6x6 U_dyn;
     U_dyn.zero();
@@ -105,6 +94,11 @@ iDynTree::AttitudeQuaternionEKF::AttitudeQuaternionEKF()
     using iDynTree::toEigen;
     toEigen(m_Id4).setIdentity();
     toEigen(m_Id3).setIdentity();
+
+    m_x.zero();
+    m_y.zero();
+    m_u.zero();
+    ekfSetOutputSize(m_output_size);
 }
 
 bool iDynTree::AttitudeQuaternionEKF::initializeFilter()
@@ -120,23 +114,16 @@ bool iDynTree::AttitudeQuaternionEKF::initializeFilter()
         m_output_size = output_dimensions_without_magnetometer;
     }
 
-    ekfSetStateSize(m_state_size);
-    m_x.resize(m_state_size);
     serializeStateVector();
-    ekfSetOutputSize(m_output_size);
-
-    m_y.resize(m_output_size);
     m_input_size = input_dimensions;
-    ekfSetInputSize(m_input_size);
-    m_u.resize(m_input_size);
 
-    // ekfinit resizes and initializes the filter matrices and vectors to zero - dont move it frome here
-    if (!ekfInit())
+    // the measurement noise covariance is zeroed when the output size changes - dont move it frome here
+    if (!ekfSetOutputSize(m_output_size))
     {
         return false;
     }
 
-    // once the buffers are resized and zeroed, setup the matrices
+    // once the output size is set, setup the matrices
     if (!setInitialStateCovariance(m_params_qekf.initial_orientation_error_variance,
                                    m_params_qekf.initial_ang_vel_error_variance,
                                    m_params_qekf.initial_gyro_bias_error_variance))
@@ -183,11 +170,6 @@ bool iDynTree::AttitudeQuaternionEKF::propagateStates()
 void iDynTree::AttitudeQuaternionEKF::serializeMeasurementVector()
 {
     using iDynTree::toEigen;
-    if (m_y.size() != m_output_size)
-    {
-        m_y.resize(m_output_size);
-    }
-
     toEigen(m_y).block<3, 1>(0, 0) = toEigen(m_Acc_y);
     if (m_params_qekf.use_magnetometer_measurements)
     {
@@ -198,7 +180,7 @@ void iDynTree::AttitudeQuaternionEKF::serializeMeasurementVector()
 bool iDynTree::AttitudeQuaternionEKF::callEkfUpdate()
 {
     serializeMeasurementVector();
-    iDynTree::Span<double> y_span(m_y.data(), m_y.size());
+    iDynTree::Span<double> y_span(m_y.data(), m_output_size);
     bool ok = ekfSetMeasurementVector(y_span);
     ok = ekfUpdate() && ok;
 
@@ -220,11 +202,6 @@ bool iDynTree::AttitudeQuaternionEKF::callEkfUpdate()
 
 bool iDynTree::AttitudeQuaternionEKF::updateFilterWithMeasurements(const iDynTree::LinearAccelerometerMeasurements& linAccMeas, const iDynTree::GyroscopeMeasurements& gyroMeas, const iDynTree::MagnetometerMeasurements& magMeas)
 {
-    if (m_y.size() != m_output_size)
-    {
-        m_y.resize(m_output_size);
-    }
-
     if (!checkValidMeasurement(linAccMeas, "linear acceleration", true)) { return false; }
     if (!checkValidMeasurement(gyroMeas, "gyroscope", false)) { return false; }
     if (!checkValidMeasurement(magMeas, "magnetometer", true)) { return false; }
@@ -280,30 +257,10 @@ bool iDynTree::AttitudeQuaternionEKF::updateFilterWithMeasurements(const iDynTre
     return ok;
 }
 
-bool iDynTree::AttitudeQuaternionEKF::ekfComputeJacobianF(iDynTree::VectorDynSize& x, iDynTree::VectorDynSize& u, iDynTree::MatrixDynSize& F)
-{
-    ignore(u);
-    ignore(x);
-    ignore(F);
-    return false;
-}
-
-
-bool iDynTree::AttitudeQuaternionEKF::ekfComputeJacobianF(iDynTree::VectorDynSize& x, iDynTree::MatrixDynSize& F)
+bool iDynTree::AttitudeQuaternionEKF::ekfComputeJacobianF(const StateVector& x, const InputVector& u, StateMatrix& F)
 {
     using iDynTree::toEigen;
-
-    if (x.size() != m_state_size)
-    {
-        reportError("AttitudeQuaternionEKF", "computejacobianF", "state size mismatch");
-        return false;
-    }
-
-    if (F.rows() != m_state_size || F.cols() != m_state_size)
-    {
-        reportError("AttitudeQuaternionEKF", "computejacobianF", "jacobian matrix size mismatch");
-        return false;
-    }
+    ignore(u);
 
     F.zero();
 
@@ -323,8 +280,7 @@ bool iDynTree::AttitudeQuaternionEKF::ekfComputeJacobianF(iDynTree::VectorDynSiz
     dfq_by_dq(0, 3) = dfq_by_dq(2, 1) = -ang_vel(2);
     toEigen(dfq_by_dq) *= (m_params_qekf.time_step_in_seconds/2.0);
 
-    iDynTree::MatrixDynSize dfq_by_dangvel;
-    dfq_by_dangvel.resize(4, 3);
+    iDynTree::MatrixFixSize<4, 3> dfq_by_dangvel;
     dfq_by_dangvel(0, 0) = dfq_by_dangvel(2, 2) = -q(1);
     dfq_by_dangvel(0, 1) = dfq_by_dangvel(3, 0) = -q(2);
     dfq_by_dangvel(0, 2) = dfq_by_dangvel(1, 1) = -q(3);
@@ -348,28 +304,15 @@ bool iDynTree::AttitudeQuaternionEKF::ekfComputeJacobianF(iDynTree::VectorDynSiz
     return true;
 }
 
-bool iDynTree::AttitudeQuaternionEKF::ekfComputeJacobianH(iDynTree::VectorDynSize& x, iDynTree::MatrixDynSize& H)
+bool iDynTree::AttitudeQuaternionEKF::ekfComputeJacobianH(const StateVector& x, OutputJacobian& H)
 {
     using iDynTree::toEigen;
 
-    if (x.size() != m_state_size)
-    {
-        reportError("AttitudeQuaternionEKF", "computejacobianH", "state size mismatch");
-        return false;
-    }
-
-    if (H.rows() != m_output_size || H.cols() != m_state_size)
-    {
-        reportError("AttitudeQuaternionEKF", "computejacobianH", "jacobian matrix size mismatch");
-        return false;
-    }
-
     H.zero();
     iDynTree::UnitQuaternion q;
     toEigen(q) = toEigen(x).block<4,1>(0, 0);
 
-    iDynTree::MatrixDynSize dhacc_by_dq;
-    dhacc_by_dq.resize(3, 4);
+    iDynTree::MatrixFixSize<3, 4> dhacc_by_dq;
     dhacc_by_dq(0, 0) = dhacc_by_dq(2, 2) = q(2);
     dhacc_by_dq(0, 1) = dhacc_by_dq(1, 2) = -q(3);
     dhacc_by_dq(0, 3) = dhacc_by_dq(1, 0) = -q(1);
@@ -418,20 +361,8 @@ bool iDynTree::AttitudeQuaternionEKF::ekfComputeJacobianH(iDynTree::VectorDynSiz
     return true;
 }
 
-bool iDynTree::AttitudeQuaternionEKF::ekf_f(const iDynTree::VectorDynSize& x_k, const iDynTree::VectorDynSize& u_k, iDynTree::VectorDynSize& xhat_k_plus_one)
+bool iDynTree::AttitudeQuaternionEKF::ekf_f(const StateVector& x_k, const InputVector& u_k, StateVector& xhat_k_plus_one)
 {
-    if (x_k.size() != m_x.size() || xhat_k_plus_one.size() != m_x.size())
-    {
-        reportError("AttitudeQuaternionEKF", "ekf_f", "state size mismatch");
-        return false;
-    }
-
-    if (u_k.size() != m_u.size())
-    {
-        reportError("AttitudeQuaternionEKF", "ekf_f", "input size mismatch");
-        return false;
-    }
-
     iDynTree::UnitQuaternion orientation;
     iDynTree::Vector3 ang_vel, gyro_bias;
 
@@ -471,20 +402,8 @@ bool iDynTree::AttitudeQuaternionEKF::ekf_f(const iDynTree::VectorDynSize& x_k,
     return true;
 }
 
-bool iDynTree::AttitudeQuaternionEKF::ekf_h(const iDynTree::VectorDynSize& xhat_k_plus_one, iDynTree::VectorDynSize& zhat_k_plus_one)
+bool iDynTree::AttitudeQuaternionEKF::ekf_h(const StateVector& xhat_k_plus_one, OutputVector& zhat_k_plus_one)
 {
-    if (xhat_k_plus_one.size() != m_x.size())
-    {
-        reportError("AttitudeQuaternionEKF", "h", "predicted state size mismatch");
-        return false;
-    }
-
-    if (zhat_k_plus_one.size() != m_y.size())
-    {
-        reportError("AttitudeQuaternionEKF", "h", "output size mismatch");
-        return false;
-    }
-
     // following computation is the same as R^T e_3
     iDynTree::UnitQuaternion q;
     toEigen(q) = toEigen(xhat_k_plus_one).block<4,1>(0, 0);
@@ -543,9 +462,9 @@ bool iDynTree::AttitudeQuaternionEKF::setSystemNoiseVariance(double gyro, double
     m_params_qekf.gyroscope_noise_variance = gyro;
     m_params_qekf.gyro_bias_noise_variance = gyro_bias;
 
-    iDynTree::MatrixDynSize Q = iDynTree::MatrixDynSize(m_state_size, m_state_size);
+    StateMatrix Q;
     prepareSystemNoiseCovarianceMatrix(Q);
-    iDynTree::Span<double> Q_span(Q.data(), Q.capacity());
+    iDynTree::Span<double> Q_span(Q.data(), Q.rows()*Q.cols());
     bool ok = ekfSetSystemNoiseCovariance(Q_span);
     return ok;
 }
@@ -554,7 +473,8 @@ bool iDynTree::AttitudeQuaternionEKF::setInitialStateCovariance(double orientati
 {
     using iDynTree::toEigen;
 
-    iDynTree::MatrixDynSize P(m_state_size, m_state_size);
+    StateMatrix P;
+    P.zero();
 
     auto P_eig(toEigen(P));
     auto Id3(toEigen(m_Id3));
@@ -564,7 +484,7 @@ bool iDynTree::AttitudeQuaternionEKF::setInitialStateCovariance(double orientati
     P_eig.block<3,3>(4,4) = Id3*ang_vel_var;
     P_eig.block<3,3>(7,7) = Id3*gyro_bias_var;
 
-    iDynTree::Span<double> P_span(P.data(), P.capacity());
+    iDynTree::Span<double> P_span(P.data(), P.rows()*P.cols());
     bool ok = ekfSetStateCovariance(P_span);
     return ok;
 }
@@ -683,9 +603,9 @@ bool iDynTree::AttitudeQuaternionEKF::useMagnetometerMeasurements(bool use_magne
     }
 
     // store current state estimate and variance
-    iDynTree::VectorDynSize x(m_x);
-    iDynTree::MatrixDynSize P(m_x.size(), m_x.size());
-    iDynTree::Span<double> P_span(P.data(), P.capacity());
+    StateVector x(m_x);
+    StateMatrix P;
+    iDynTree::Span<double> P_span(P.data(), P.rows()*P.cols());
     if (!ekfGetStateCovariance(P_span))
     {
         return false;
@@ -163,6 +163,10 @@ bool BerdyHelper::init(const Model& model,
     // Reset the class
     m_kinematicsUpdated = false;
     m_areModelAndSensorsValid = false;
+    m_matrixDPattern.resize(0, 0);
+    m_matrixYPattern.resize(0, 0);
+    m_matrixDElementsToValues.clear();
+    m_matrixYElementsToValues.clear();
 
     m_model = model;
     m_options = options;
@@ -998,7 +1002,7 @@ bool BerdyHelper::computeBerdyDynamicsMatricesFixedBase(SparseMatrix<iDynTree::C
         }
     }
 
-    D.setFromTriplets(matrixDElements);
+    setBerdyMatrixFromTriplets(matrixDElements, m_matrixDPattern, m_matrixDElementsToValues, D);
     return true;
 }
 
@@ -1141,10 +1145,55 @@ bool BerdyHelper::computeBerdyDynamicsMatricesFloatingBase(SparseMatrix<iDynTree
 
     }
 
-    D.setFromTriplets(matrixDElements);
+    setBerdyMatrixFromTriplets(matrixDElements, m_matrixDPattern, m_matrixDElementsToValues, D);
     return true;
 }
 
+void BerdyHelper::setBerdyMatrixFromTriplets(const Triplets& elements,
+                                             SparseMatrix<iDynTree::ColumnMajor>& pattern,
+                                             std::vector<size_t>& elementsToValues,
+                                             SparseMatrix<iDynTree::ColumnMajor>& matrix)
+{
+    if (pattern.rows() != matrix.rows() || pattern.columns() != matrix.columns()
+        || elementsToValues.size() != elements.size())
+    {
+        pattern.resize(matrix.rows(), matrix.columns());
+        pattern.zero();
+        pattern.setFromConstTriplets(elements);
+
+        elementsToValues.resize(elements.size());
+        const int* outerStarts = pattern.outerIndicesBuffer();
+        const int* innerIndices = pattern.innerIndicesBuffer();
+        size_t k = 0;
+        for (Triplets::const_iterator it = elements.begin(); it != elements.end(); ++it, ++k)
+        {
+            const int* valueInColumn = std::lower_bound(innerIndices + outerStarts[it->column],
+                                                        innerIndices + outerStarts[it->column + 1],
+                                                        static_cast<int>(it->row));
+            elementsToValues[k] = valueInColumn - innerIndices;
+        }
+    }
+
+    // Copy the pattern only if the matrix was not already filled by this method
+    const size_t nonZeros = pattern.numberOfNonZeros();
+    if (matrix.numberOfNonZeros() != nonZeros
+        || !std::equal(pattern.outerIndicesBuffer(), pattern.outerIndicesBuffer() + pattern.columns() + 1,
+                       matrix.outerIndicesBuffer())
+        || !std::equal(pattern.innerIndicesBuffer(), pattern.innerIndicesBuffer() + nonZeros,
+                       matrix.innerIndicesBuffer()))
+    {
+        matrix = pattern;
+    }
+
+    double* values = matrix.valuesBuffer();
+    std::fill(values, values + nonZeros, 0.0);
+    size_t k = 0;
+    for (Triplets::const_iterator it = elements.begin(); it != elements.end(); ++it, ++k)
+    {
+        values[elementsToValues[k]] += it->value;
+    }
+}
+
 
 
 bool BerdyHelper::computeBerdySensorsMatricesFromModel(SparseMatrix<iDynTree::ColumnMajor>& Y, VectorDynSize& bY)
@@ -1483,7 +1532,7 @@ bool BerdyHelper::computeBerdySensorMatrices(SparseMatrix<iDynTree::ColumnMajor>
         // bY for the RCM sensor is zero
     }
 
-    Y.setFromTriplets(matrixYElements);
+    setBerdyMatrixFromTriplets(matrixYElements, m_matrixYPattern, m_matrixYElementsToValues, Y);
     return true;
 }
 
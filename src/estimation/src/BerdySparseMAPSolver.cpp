@@ -8,14 +8,351 @@
 #include <iDynTree/SparseMatrix.h>
 #include <iDynTree/EigenHelpers.h>
 #include <iDynTree/EigenSparseHelpers.h>
+#include <iDynTree/Utils.h>
 
+#include <Eigen/Dense>
 #include <Eigen/SparseCore>
 #include <Eigen/SparseCholesky>
 
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 namespace iDynTree {
 
+    namespace {
+        typedef Eigen::SparseMatrix<double, Eigen::ColMajor> EigenSparseMatrix;
+
+        /**
+         * LDLT decomposition of a matrix already permuted with a fill-reducing ordering.
+         *
+         * SimplicialLDLT::factorize always creates a temporary copy of the input matrix,
+         * so here the factorization of the permuted matrix is called directly, to avoid
+         * allocating memory.
+         */
+        class PreorderedSimplicialLDLT : public Eigen::SimplicialLDLT<EigenSparseMatrix, Eigen::Upper, Eigen::NaturalOrdering<int> >
+        {
+        public:
+            void factorizePreordered(const EigenSparseMatrix& permutedUpperMatrix)
+            {
+                this->template factorize_preordered<true>(permutedUpperMatrix);
+            }
+
+            // vectorD returns a copy of the diagonal
+            const VectorType& diagonal() const
+            {
+                return this->m_diag;
+            }
+        };
+
+        /**
+         * Copy of the sparsity pattern of a compressed column major sparse matrix.
+         */
+        class SparsityPattern
+        {
+            Eigen::Index m_rows;
+            std::vector<int> m_outerIndices;
+            std::vector<int> m_innerIndices;
+
+        public:
+            SparsityPattern(): m_rows(-1)
+            {
+            }
+
+            template<typename MatrixType>
+            void assign(const MatrixType& mat)
+            {
+                m_rows = mat.rows();
+                m_outerIndices.assign(mat.outerIndexPtr(), mat.outerIndexPtr() + mat.outerSize() + 1);
+                m_innerIndices.assign(mat.innerIndexPtr(), mat.innerIndexPtr() + mat.outerIndexPtr()[mat.outerSize()]);
+            }
+
+            template<typename MatrixType>
+            bool isEqualTo(const MatrixType& mat) const
+            {
+                return mat.rows() == m_rows
+                       && static_cast<size_t>(mat.outerSize() + 1) == m_outerIndices.size()
+                       && std::equal(m_outerIndices.begin(), m_outerIndices.end(), mat.outerIndexPtr())
+                       && std::equal(m_innerIndices.begin(), m_innerIndices.end(), mat.innerIndexPtr());
+            }
+        };
+
+        /**
+         * Solver of the linear system C x = b, with C = A^T W A + S symmetric positive definite.
+         *
+         * The sparsity pattern of C, its fill-reducing permutation and the symbolic analysis
+         * of the decomposition are computed by analyzePattern, that allocates memory.
+         * factorize and solve only update the numerical values stored in the buffers
+         * resized by analyzePattern, so they do not allocate memory.
+         */
+        class SparseNormalEquationsSolver
+        {
+            EigenSparseMatrix m_matrix;
+            EigenSparseMatrix m_permutedUpperMatrix;
+            // m_permutation(i) is the index of the i-th variable in the permuted matrix
+            Eigen::VectorXi m_permutation;
+            // Index in the values of m_permutedUpperMatrix of each value of m_matrix (-1 for the strictly lower part)
+            std::vector<int> m_matrixToPermutedUpperMatrix;
+            // Index in the values of m_matrix of each value of S
+            std::vector<int> m_addendToMatrix;
+            // Index in the values of m_matrix of the transposed element of each value of the strictly
+            // lower triangular part, if only the upper triangular part of A^T W A is computed (-1 otherwise)
+            std::vector<int> m_lowerToUpperMatrix;
+            bool m_computeOnlyUpperPart;
+            // Sparsity pattern of A by rows: columns of the elements of each row, and their index in the values of A
+            std::vector<int> m_rowsOfAOffset;
+            std::vector<int> m_rowsOfAColumns;
+            std::vector<int> m_rowsOfAValues;
+            // A^T W A is the sum of W(i,j) A(i,r) A(j,c) for each element W(i,j), each element A(i,r) of the row i
+            // and each element A(j,c) of the row j (with c >= r if only the upper part is computed). For each
+            // W(i,j) and A(i,r), the position in the row j of the first A(j,c) is stored in m_firstProductInRow,
+            // while for each product the index of the corresponding C(r,c) in the values of m_matrix is stored in m_productToMatrix
+            std::vector<int> m_firstProductInRow;
+            std::vector<int> m_productToMatrix;
+            Eigen::VectorXd m_permutedSolution;
+            PreorderedSimplicialLDLT m_decomposition;
+            // Sparsity patterns of the matrices passed to the last call to analyzePattern
+            SparsityPattern m_patternOfA;
+            SparsityPattern m_patternOfW;
+            SparsityPattern m_patternOfS;
+
+            static int findValueIndex(const EigenSparseMatrix& mat, const Eigen::Index row, const Eigen::Index col)
+            {
+                for (int k = mat.outerIndexPtr()[col]; k < mat.outerIndexPtr()[col+1]; k++)
+                {
+                    if (mat.innerIndexPtr()[k] == row)
+                    {
+                        return k;
+                    }
+                }
+                return -1;
+            }
+
+        public:
+            SparseNormalEquationsSolver()
+            : m_computeOnlyUpperPart(true)
+            {
+            }
+
+            const EigenSparseMatrix& matrix() const
+            {
+                return m_matrix;
+            }
+
+            /**
+             * Check if the matrices have the same sparsity pattern (i.e. the same sizes,
+             * outer and inner indices) of the ones passed to the last call to analyzePattern.
+             */
+            template<typename AType, typename WType, typename SType>
+            bool hasSamePattern(const AType& A, const WType& W, const SType& S) const
+            {
+                return hasSamePattern(A, W) && m_patternOfS.isEqualTo(S);
+            }
+
+            /**
+             * Check only the sparsity patterns of A and W, for when S is known to be unchanged.
+             */
+            template<typename AType, typename WType>
+            bool hasSamePattern(const AType& A, const WType& W) const
+            {
+                return m_patternOfA.isEqualTo(A) && m_patternOfW.isEqualTo(W);
+            }
+
+            template<typename AType, typename WType, typename SType>
+            void analyzePattern(const AType& A, const WType& W, const SType& S)
+            {
+                m_matrix = EigenSparseMatrix(A.transpose() * W * A) + S;
+                m_matrix.makeCompressed();
+
+                // Compute the fill-reducing permutation, as done by SimplicialLDLT::analyzePattern
+                Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> permutationInverse;
+                Eigen::AMDOrdering<int> ordering;
+                ordering(m_matrix, permutationInverse);
+                Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> permutation = permutationInverse.inverse();
+                m_permutation = permutation.indices();
+
+                m_permutedUpperMatrix.resize(m_matrix.rows(), m_matrix.cols());
+                m_permutedUpperMatrix.selfadjointView<Eigen::Upper>() = m_matrix.selfadjointView<Eigen::Upper>().twistedBy(permutation);
+                m_permutedUpperMatrix.makeCompressed();
+                m_decomposition.analyzePattern(m_permutedUpperMatrix);
+
+                m_matrixToPermutedUpperMatrix.assign(m_matrix.nonZeros(), -1);
+                for (Eigen::Index col = 0; col < m_matrix.outerSize(); col++)
+                {
+                    for (int k = m_matrix.outerIndexPtr()[col]; k < m_matrix.outerIndexPtr()[col+1]; k++)
+                    {
+                        Eigen::Index row = m_matrix.innerIndexPtr()[k];
+                        if (row <= col)
+                        {
+                            Eigen::Index permutedRow = m_permutation(row);
+                            Eigen::Index permutedCol = m_permutation(col);
+                            m_matrixToPermutedUpperMatrix[k] = findValueIndex(m_permutedUpperMatrix,
+                                                                              std::min(permutedRow, permutedCol),
+                                                                              std::max(permutedRow, permutedCol));
+                        }
+                    }
+                }
+
+                // As W is the inverse of a covariance, A^T W A is symmetric and only its upper
+                // triangular part needs to be computed, unless the pattern of W is not symmetric
+                m_lowerToUpperMatrix.assign(m_matrix.nonZeros(), -1);
+                m_computeOnlyUpperPart = true;
+                for (Eigen::Index col = 0; col < m_matrix.outerSize(); col++)
+                {
+                    for (int k = m_matrix.outerIndexPtr()[col]; k < m_matrix.outerIndexPtr()[col+1]; k++)
+                    {
+                        Eigen::Index row = m_matrix.innerIndexPtr()[k];
+                        if (row > col)
+                        {
+                            m_lowerToUpperMatrix[k] = findValueIndex(m_matrix, col, row);
+                            m_computeOnlyUpperPart = m_computeOnlyUpperPart && m_lowerToUpperMatrix[k] >= 0;
+                        }
+                    }
+                }
+                if (!m_computeOnlyUpperPart)
+                {
+                    m_lowerToUpperMatrix.assign(m_matrix.nonZeros(), -1);
+                }
+
+                // Transpose the sparsity pattern of A (the columns of each row are sorted)
+                m_rowsOfAOffset.assign(A.rows() + 1, 0);
+                for (int k = 0; k < A.nonZeros(); k++)
+                {
+                    m_rowsOfAOffset[A.innerIndexPtr()[k] + 1]++;
+                }
+                for (Eigen::Index row = 0; row < A.rows(); row++)
+                {
+                    m_rowsOfAOffset[row + 1] += m_rowsOfAOffset[row];
+                }
+                m_rowsOfAColumns.resize(A.nonZeros());
+                m_rowsOfAValues.resize(A.nonZeros());
+                std::vector<int> nextInRow(m_rowsOfAOffset.begin(), m_rowsOfAOffset.end() - 1);
+                for (Eigen::Index col = 0; col < A.outerSize(); col++)
+                {
+                    for (int k = A.outerIndexPtr()[col]; k < A.outerIndexPtr()[col+1]; k++)
+                    {
+                        int position = nextInRow[A.innerIndexPtr()[k]]++;
+                        m_rowsOfAColumns[position] = col;
+                        m_rowsOfAValues[position] = k;
+                    }
+                }
+
+                m_firstProductInRow.clear();
+                m_productToMatrix.clear();
+                for (Eigen::Index j = 0; j < W.outerSize(); j++)
+                {
+                    for (int kW = W.outerIndexPtr()[j]; kW < W.outerIndexPtr()[j+1]; kW++)
+                    {
+                        Eigen::Index i = W.innerIndexPtr()[kW];
+                        for (int p = m_rowsOfAOffset[i]; p < m_rowsOfAOffset[i+1]; p++)
+                        {
+                            int firstProduct = m_rowsOfAOffset[j];
+                            if (m_computeOnlyUpperPart)
+                            {
+                                firstProduct = std::lower_bound(m_rowsOfAColumns.begin() + m_rowsOfAOffset[j],
+                                                                m_rowsOfAColumns.begin() + m_rowsOfAOffset[j+1],
+                                                                m_rowsOfAColumns[p]) - m_rowsOfAColumns.begin();
+                            }
+                            m_firstProductInRow.push_back(firstProduct);
+                            for (int q = firstProduct; q < m_rowsOfAOffset[j+1]; q++)
+                            {
+                                m_productToMatrix.push_back(findValueIndex(m_matrix, m_rowsOfAColumns[p], m_rowsOfAColumns[q]));
+                            }
+                        }
+                    }
+                }
+
+                m_addendToMatrix.assign(S.nonZeros(), -1);
+                for (Eigen::Index col = 0; col < S.outerSize(); col++)
+                {
+                    for (int k = S.outerIndexPtr()[col]; k < S.outerIndexPtr()[col+1]; k++)
+                    {
+                        m_addendToMatrix[k] = findValueIndex(m_matrix, S.innerIndexPtr()[k], col);
+                    }
+                }
+
+                m_permutedSolution.resize(A.cols());
+                m_patternOfA.assign(A);
+                m_patternOfW.assign(W);
+                m_patternOfS.assign(S);
+            }
+
+            /**
+             * Update the values of C and compute its decomposition.
+             * The sparsity pattern of the matrices should be the one passed to analyzePattern.
+             */
+            template<typename AType, typename WType, typename SType>
+            bool factorize(const AType& A, const WType& W, const SType& S)
+            {
+                assert(hasSamePattern(A, W, S));
+
+                // A^T W A, accumulating the products of the elements of the rows of A
+                double * values = m_matrix.valuePtr();
+                std::fill(values, values + m_matrix.nonZeros(), 0.0);
+                const double * valuesOfA = A.valuePtr();
+                const int * firstProduct = m_firstProductInRow.data();
+                const int * productToMatrix = m_productToMatrix.data();
+                for (Eigen::Index j = 0; j < W.outerSize(); j++)
+                {
+                    const int lastProduct = m_rowsOfAOffset[j+1];
+                    for (int kW = W.outerIndexPtr()[j]; kW < W.outerIndexPtr()[j+1]; kW++)
+                    {
+                        Eigen::Index i = W.innerIndexPtr()[kW];
+                        for (int p = m_rowsOfAOffset[i]; p < m_rowsOfAOffset[i+1]; p++)
+                        {
+                            const double weightedValue = W.valuePtr()[kW] * valuesOfA[m_rowsOfAValues[p]];
+                            for (int q = *firstProduct++; q < lastProduct; q++)
+                            {
+                                values[*productToMatrix++] += weightedValue * valuesOfA[m_rowsOfAValues[q]];
+                            }
+                        }
+                    }
+                }
+
+                for (size_t k = 0; k < m_lowerToUpperMatrix.size(); k++)
+                {
+                    if (m_lowerToUpperMatrix[k] >= 0)
+                    {
+                        values[k] = values[m_lowerToUpperMatrix[k]];
+                    }
+                }
+
+                for (size_t k = 0; k < m_addendToMatrix.size(); k++)
+                {
+                    values[m_addendToMatrix[k]] += S.valuePtr()[k];
+                }
+
+                for (size_t k = 0; k < m_matrixToPermutedUpperMatrix.size(); k++)
+                {
+                    if (m_matrixToPermutedUpperMatrix[k] >= 0)
+                    {
+                        m_permutedUpperMatrix.valuePtr()[m_matrixToPermutedUpperMatrix[k]] = values[k];
+                    }
+                }
+
+                m_decomposition.factorizePreordered(m_permutedUpperMatrix);
+                return m_decomposition.info() == Eigen::Success;
+            }
+
+            void solve(const Eigen::Ref<const Eigen::VectorXd>& rhs, Eigen::Ref<Eigen::VectorXd> solution)
+            {
+                for (Eigen::Index i = 0; i < rhs.size(); i++)
+                {
+                    m_permutedSolution(m_permutation(i)) = rhs(i);
+                }
+
+                m_decomposition.matrixL().solveInPlace(m_permutedSolution);
+                m_permutedSolution.array() /= m_decomposition.diagonal().array();
+                m_decomposition.matrixU().solveInPlace(m_permutedSolution);
+
+                for (Eigen::Index i = 0; i < rhs.size(); i++)
+                {
+                    solution(i) = m_permutedSolution(m_permutation(i));
+                }
+            }
+        };
+    }
+
     class BerdySparseMAPSolver::BerdySparseMAPSolverPimpl
     {
     public:
@@ -43,20 +380,20 @@ namespace iDynTree {
         iDynTree::JointDOFsDoubleArray jointsVelocity;
         iDynTree::VectorDynSize measurements;
 
-        // Expected value and variance of the prior on the dynamics
+        // Expected value of the prior on the dynamics
         iDynTree::VectorDynSize expectedDynamicsPrior;
-        Eigen::SparseMatrix<double, Eigen::ColMajor> covarianceDynamicsPriorInverse;
-
         iDynTree::VectorDynSize expectedDynamicsPriorRHS;
+        iDynTree::VectorDynSize dynamicsConstraintsWeightedBias;
 
-        // Expected value and variance of the a-posteriori on the dynamics
+        // Expected value of the a-posteriori on the dynamics
         iDynTree::VectorDynSize expectedDynamicsAPosteriori;
-        Eigen::SparseMatrix<double, Eigen::ColMajor> covarianceDynamicsAPosterioriInverse;
         iDynTree::VectorDynSize expectedDynamicsAPosterioriRHS;
+        iDynTree::VectorDynSize measurementsResidual;
+        iDynTree::VectorDynSize measurementsWeightedResidual;
 
-        // Decomposition buffers
-        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::ColMajor> > covarianceDynamicsPriorInverseDecomposition;
-        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::ColMajor> > covarianceDynamicsAPosterioriInverseDecomposition;
+        // Inverse of the variance of the prior and of the a-posteriori on the dynamics, and their decompositions
+        SparseNormalEquationsSolver covarianceDynamicsPriorInverseSolver;
+        SparseNormalEquationsSolver covarianceDynamicsAPosterioriInverseSolver;
 
         BerdySparseMAPSolverPimpl(BerdyHelper& berdyHelper)
         : berdy(berdyHelper)
@@ -66,7 +403,10 @@ namespace iDynTree {
         }
 
         bool initialize();
-        void computeMAP(bool computePermutation);
+        bool computeMAP(bool computePermutation);
+        template<typename PriorCovarianceInverseType>
+        bool computeAPosteriori(const PriorCovarianceInverseType& covarianceDynamicsPriorInverse, bool computePermutation,
+                                bool checkPriorPattern);
         static bool invertSparseMatrix(const iDynTree::SparseMatrix<iDynTree::ColumnMajor>&in, iDynTree::SparseMatrix<iDynTree::ColumnMajor>& inverted);
     };
 
@@ -214,12 +554,16 @@ namespace iDynTree {
         Eigen::internal::set_is_malloc_allowed(false);
 #endif
         bool computePermutation = false;
-        m_pimpl->computeMAP(computePermutation);
+        bool ok = m_pimpl->computeMAP(computePermutation);
 
 #ifdef EIGEN_RUNTIME_NO_MALLOC
         Eigen::internal::set_is_malloc_allowed(true);
 #endif
-        return true;
+        if (!ok)
+        {
+            reportError("BerdySparseMAPSolver", "doEstimate", "Failed to factorize the inverse of the covariance of the dynamics");
+        }
+        return ok;
     }
 
     void BerdySparseMAPSolver::getLastEstimate(iDynTree::VectorDynSize& lastEstimate) const
@@ -234,7 +578,43 @@ namespace iDynTree {
         return m_pimpl->expectedDynamicsAPosteriori;
     }
 
-    void BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::computeMAP(bool computePermutation)
+    template<typename PriorCovarianceInverseType>
+    bool BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::computeAPosteriori(const PriorCovarianceInverseType& covarianceDynamicsPriorInverse,
+                                                                             bool computePermutation,
+                                                                             bool checkPriorPattern)
+    {
+        // Final result: covariance matrix of the whole-body dynamics, Eq. 11a
+        // var[p(d|y)]^-1 = Y^T Sigma_y^-1 Y + var[p(d)]^-1
+        bool hasSamePattern = checkPriorPattern ?
+            covarianceDynamicsAPosterioriInverseSolver.hasSamePattern(toEigen(measurementsMatrix),
+                                                                      toEigen(priorMeasurementsCovarianceInverse),
+                                                                      covarianceDynamicsPriorInverse) :
+            covarianceDynamicsAPosterioriInverseSolver.hasSamePattern(toEigen(measurementsMatrix),
+                                                                      toEigen(priorMeasurementsCovarianceInverse));
+        if (computePermutation || !hasSamePattern)
+        {
+            covarianceDynamicsAPosterioriInverseSolver.analyzePattern(toEigen(measurementsMatrix),
+                                                                      toEigen(priorMeasurementsCovarianceInverse),
+                                                                      covarianceDynamicsPriorInverse);
+        }
+        if (!covarianceDynamicsAPosterioriInverseSolver.factorize(toEigen(measurementsMatrix),
+                                                                  toEigen(priorMeasurementsCovarianceInverse),
+                                                                  covarianceDynamicsPriorInverse))
+        {
+            return false;
+        }
+
+        // Final result: expected value of the whole-body dynamics, Eq. 11b
+        toEigen(measurementsResidual) = toEigen(measurements) - toEigen(measurementsBias);
+        toEigen(measurementsWeightedResidual).noalias() = toEigen(priorMeasurementsCovarianceInverse) * toEigen(measurementsResidual);
+        toEigen(expectedDynamicsAPosterioriRHS).noalias() = toEigen(measurementsMatrix).transpose() * toEigen(measurementsWeightedResidual);
+        toEigen(expectedDynamicsAPosterioriRHS).noalias() += covarianceDynamicsPriorInverse * toEigen(expectedDynamicsPrior);
+
+        covarianceDynamicsAPosterioriInverseSolver.solve(toEigen(expectedDynamicsAPosterioriRHS), toEigen(expectedDynamicsAPosteriori));
+        return true;
+    }
+
+    bool BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::computeMAP(bool computePermutation)
     {
         /*
          * Get berdy matrices
@@ -249,59 +629,47 @@ namespace iDynTree {
         // See Latella et al., "Whole-Body Human Inverse Dynamics with
         // Distributed Micro-Accelerometers, Gyros and Force Sensing" in Sensors, 2016
 
-        // Intermediate quantities
+        // The sparsity pattern of the matrices is computed only if required (or if it changed),
+        // otherwise only the values are updated, without allocating memory.
 
         if(berdy.getOptions().berdyVariant!=BERDY_FLOATING_BASE_NON_COLLOCATED_EXT_WRENCHES)
         {
             // Covariance matrix of the prior of the dynamics: var[p(d)], Eq. 10a
-            //TODO: find a way to map to iDynTree::SparseMatrix
-            covarianceDynamicsPriorInverse
-            //    toEigen(m_intermediateQuantities.covarianceDynamicsPriorInverse)
-            //Better to assign the "sum" before, and adding the product part later
-            = toEigen(priorDynamicsRegularizationCovarianceInverse);
-
-            covarianceDynamicsPriorInverse += toEigen(dynamicsConstraintsMatrix).transpose() * toEigen(priorDynamicsConstraintsCovarianceInverse) * toEigen(dynamicsConstraintsMatrix);
-
-            // decompose m_covarianceDynamicsPriorInverse
-            if (computePermutation) {
-                covarianceDynamicsPriorInverseDecomposition.analyzePattern(covarianceDynamicsPriorInverse);
+            // var[p(d)]^-1 = D^T Sigma_D^-1 D + Sigma_d^-1
+            bool priorPatternChanged = computePermutation ||
+                                       !covarianceDynamicsPriorInverseSolver.hasSamePattern(toEigen(dynamicsConstraintsMatrix),
+                                                                                            toEigen(priorDynamicsConstraintsCovarianceInverse),
+                                                                                            toEigen(priorDynamicsRegularizationCovarianceInverse));
+            if (priorPatternChanged)
+            {
+                covarianceDynamicsPriorInverseSolver.analyzePattern(toEigen(dynamicsConstraintsMatrix),
+                                                                    toEigen(priorDynamicsConstraintsCovarianceInverse),
+                                                                    toEigen(priorDynamicsRegularizationCovarianceInverse));
+            }
+            if (!covarianceDynamicsPriorInverseSolver.factorize(toEigen(dynamicsConstraintsMatrix),
+                                                                toEigen(priorDynamicsConstraintsCovarianceInverse),
+                                                                toEigen(priorDynamicsRegularizationCovarianceInverse)))
+            {
+                return false;
             }
-            //    m_intermediateQuantities.covarianceDynamicsPriorInverseDecomposition.factorize(toEigen(m_intermediateQuantities.covarianceDynamicsPriorInverse));
-            covarianceDynamicsPriorInverseDecomposition.factorize(covarianceDynamicsPriorInverse);
 
             // Expected value of the prior of the dynamics: E[p(d)], Eq. 10b
-            toEigen(expectedDynamicsPriorRHS) = toEigen(priorDynamicsRegularizationCovarianceInverse) * toEigen(priorDynamicsRegularizationExpectedValue) - toEigen(dynamicsConstraintsMatrix).transpose() * toEigen(priorDynamicsConstraintsCovarianceInverse) * toEigen(dynamicsConstraintsBias);
+            toEigen(dynamicsConstraintsWeightedBias).noalias() = toEigen(priorDynamicsConstraintsCovarianceInverse) * toEigen(dynamicsConstraintsBias);
+            toEigen(expectedDynamicsPriorRHS).noalias() = toEigen(priorDynamicsRegularizationCovarianceInverse) * toEigen(priorDynamicsRegularizationExpectedValue);
+            toEigen(expectedDynamicsPriorRHS).noalias() -= toEigen(dynamicsConstraintsMatrix).transpose() * toEigen(dynamicsConstraintsWeightedBias);
+
+            covarianceDynamicsPriorInverseSolver.solve(toEigen(expectedDynamicsPriorRHS), toEigen(expectedDynamicsPrior));
 
-            toEigen(expectedDynamicsPrior) =
-            covarianceDynamicsPriorInverseDecomposition.solve(toEigen(expectedDynamicsPriorRHS));
+            // The pattern of var[p(d)]^-1 changes only when it is analyzed again, so it is not compared element by element
+            return computeAPosteriori(covarianceDynamicsPriorInverseSolver.matrix(), priorPatternChanged, false);
         }
         else
         {
             // Modified eq. 10a and 10b without the dynamics constraints
-            covarianceDynamicsPriorInverse = toEigen(priorDynamicsRegularizationCovarianceInverse);
             expectedDynamicsPrior = priorDynamicsRegularizationExpectedValue;
-        }
-        
-        // Final result: covariance matrix of the whole-body dynamics, Eq. 11a
-        //TODO: find a way to map to iDynTree::SparseMatrix
-        covarianceDynamicsAPosterioriInverse = toEigen(measurementsMatrix).transpose() * toEigen(priorMeasurementsCovarianceInverse) * toEigen(measurementsMatrix);
-        covarianceDynamicsAPosterioriInverse += covarianceDynamicsPriorInverse;
-
 
-        // decompose m_covarianceDynamicsAPosterioriInverse
-        if (computePermutation) {
-            //        m_intermediateQuantities.covarianceDynamicsAPosterioriInverseDecomposition.analyzePattern(toEigen(m_covarianceDynamicsAPosterioriInverse));
-            covarianceDynamicsAPosterioriInverseDecomposition.analyzePattern(covarianceDynamicsAPosterioriInverse);
+            return computeAPosteriori(toEigen(priorDynamicsRegularizationCovarianceInverse), computePermutation, true);
         }
-        //    m_intermediateQuantities.covarianceDynamicsAPosterioriInverseDecomposition.factorize(toEigen(m_covarianceDynamicsAPosterioriInverse));
-        covarianceDynamicsAPosterioriInverseDecomposition.factorize(covarianceDynamicsAPosterioriInverse);
-
-        // Final result: expected value of the whole-body dynamics, Eq. 11b
-        toEigen(expectedDynamicsAPosterioriRHS) = toEigen(measurementsMatrix).transpose() * toEigen(priorMeasurementsCovarianceInverse) * (toEigen(measurements) - toEigen(measurementsBias));
-        toEigen(expectedDynamicsAPosterioriRHS) += covarianceDynamicsPriorInverse * toEigen(expectedDynamicsPrior);
-        
-        toEigen(expectedDynamicsAPosteriori) =
-        covarianceDynamicsAPosterioriInverseDecomposition.solve(toEigen(expectedDynamicsAPosterioriRHS));
     }
 
     bool BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::initialize()
@@ -323,13 +691,14 @@ namespace iDynTree {
 
         expectedDynamicsAPosteriori.resize(numberOfDynVariables);
         expectedDynamicsAPosteriori.zero();
-        covarianceDynamicsAPosterioriInverse.resize(numberOfDynVariables, numberOfDynVariables);
 
-        covarianceDynamicsPriorInverse.resize(numberOfDynVariables, numberOfDynVariables);
         expectedDynamicsPrior.resize(numberOfDynVariables);
         expectedDynamicsPriorRHS.resize(numberOfDynVariables);
+        dynamicsConstraintsWeightedBias.resize(numberOfDynEquations);
         expectedDynamicsAPosterioriRHS.resize(numberOfDynVariables);
         expectedDynamicsAPosterioriRHS.zero();
+        measurementsResidual.resize(numberOfMeasurements);
+        measurementsWeightedResidual.resize(numberOfMeasurements);
 
         // Resize priors and set them to identity.
         // If a prior is specified in config file they will be cleared after
@@ -359,7 +728,11 @@ namespace iDynTree {
         initialGravity(2) = -9.81;
 
         berdy.updateKinematicsFromFixedBase(jointsConfiguration, jointsVelocity, berdy.dynamicTraversal().getBaseLink()->getIndex(), initialGravity);
-        computeMAP(true);
+        if (!computeMAP(true))
+        {
+            reportError("BerdySparseMAPSolver", "initialize", "Failed to factorize the inverse of the covariance of the dynamics");
+            return false;
+        }
 
         valid = true;
         return true;
@@ -369,20 +742,84 @@ namespace iDynTree {
     bool BerdySparseMAPSolver::BerdySparseMAPSolverPimpl::invertSparseMatrix(const iDynTree::SparseMatrix<iDynTree::ColumnMajor>&in,
                                                                              iDynTree::SparseMatrix<iDynTree::ColumnMajor>& inverted)
     {
-        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::ColMajor> > inversion;
-        inversion.compute(iDynTree::toEigen(in));
-        if (inversion.info() != Eigen::Success) return false;
-        
-        Eigen::SparseMatrix<double> identity(in.rows(), in.columns());
-        identity.setIdentity();
-        Eigen::SparseMatrix<double> result = inversion.solve(identity);
-        iDynTree::Triplets invertedElements;
-        invertedElements.reserve(result.nonZeros());
+        // The covariance matrices are block diagonal (up to a permutation), with small blocks (for example
+        // the 3x3 or 6x6 covariance of a sensor): the blocks are the connected components of the sparsity
+        // pattern, and the inverse is computed inverting each of them as a dense matrix.
+        const Eigen::Index size = in.rows();
+        if (size != static_cast<Eigen::Index>(in.columns())) return false;
+        const auto& matrix = iDynTree::toEigen(in);
+
+        std::vector<Eigen::Index> component(size);
+        for (Eigen::Index i = 0; i < size; i++)
+        {
+            component[i] = i;
+        }
+        auto findComponent = [&component](Eigen::Index i) {
+            while (component[i] != i)
+            {
+                component[i] = component[component[i]];
+                i = component[i];
+            }
+            return i;
+        };
+        for (Eigen::Index col = 0; col < matrix.outerSize(); col++)
+        {
+            for (Eigen::Index k = matrix.outerIndexPtr()[col]; k < matrix.outerIndexPtr()[col+1]; k++)
+            {
+                Eigen::Index first = findComponent(matrix.innerIndexPtr()[k]);
+                Eigen::Index second = findComponent(col);
+                if (first != second)
+                {
+                    component[std::max(first, second)] = std::min(first, second);
+                }
+            }
+        }
+
+        // Indices of each block, sorted
+        std::vector<std::vector<Eigen::Index>> blocks;
+        std::vector<Eigen::Index> blockOfComponent(size, -1);
+        std::vector<Eigen::Index> positionInBlock(size);
+        size_t nonZeros = 0;
+        for (Eigen::Index i = 0; i < size; i++)
+        {
+            Eigen::Index root = findComponent(i);
+            if (blockOfComponent[root] < 0)
+            {
+                blockOfComponent[root] = blocks.size();
+                blocks.emplace_back();
+            }
+            std::vector<Eigen::Index>& block = blocks[blockOfComponent[root]];
+            positionInBlock[i] = block.size();
+            block.push_back(i);
+            nonZeros += 2 * block.size() - 1;
+        }
 
-        for (Eigen::Index k = 0; k < result.outerSize(); ++k) {
-            for (Eigen::SparseMatrix<double>::InnerIterator it(result, k); it; ++it)
+        iDynTree::Triplets invertedElements;
+        invertedElements.reserve(nonZeros);
+        Eigen::MatrixXd dense;
+        for (const std::vector<Eigen::Index>& block : blocks)
+        {
+            const Eigen::Index blockSize = block.size();
+            dense.setZero(blockSize, blockSize);
+            for (Eigen::Index j = 0; j < blockSize; j++)
+            {
+                for (Eigen::Index k = matrix.outerIndexPtr()[block[j]]; k < matrix.outerIndexPtr()[block[j]+1]; k++)
+                {
+                    dense(positionInBlock[matrix.innerIndexPtr()[k]], j) = matrix.valuePtr()[k];
+                }
+            }
+            Eigen::LDLT<Eigen::MatrixXd> inversion(dense);
+            if (inversion.info() != Eigen::Success || (inversion.vectorD().array() == 0.0).any())
+            {
+                return false;
+            }
+            dense = inversion.solve(Eigen::MatrixXd::Identity(blockSize, blockSize));
+            for (Eigen::Index j = 0; j < blockSize; j++)
             {
-                invertedElements.pushTriplet(iDynTree::Triplet(it.row(), it.col(), it.value()));
+                for (Eigen::Index i = 0; i < blockSize; i++)
+                {
+                    invertedElements.pushTriplet(iDynTree::Triplet(block[i], block[j], dense(i, j)));
+                }
             }
         }
         inverted.setFromTriplets(invertedElements);
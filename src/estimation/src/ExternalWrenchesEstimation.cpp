@@ -17,6 +17,8 @@
 #include <iDynTree/Sensors.h>
 #include <iDynTree/SixAxisForceTorqueSensor.h>
 
+#include <iDynTree/WorkerPool.h>
+
 namespace iDynTree
 {
 
@@ -171,22 +173,87 @@ std::string LinkUnknownWrenchContacts::toString(const Model& model) const
     return ss.str();
 }
 
-estimateExternalWrenchesBuffers::estimateExternalWrenchesBuffers()
+struct estimateExternalWrenchesBuffers::LeastSquaresSolvers
+{
+    std::vector< Eigen::ColPivHouseholderQR<Eigen::MatrixXd> > qr;
+
+    /**
+     * Worker threads used to estimate the submodels in parallel, and
+     * flag set if the estimation of each submodel failed.
+     */
+    WorkerPool workerPool;
+    std::vector<char> subModelFailed;
+
+    LeastSquaresSolvers() = default;
+
+    LeastSquaresSolvers(const LeastSquaresSolvers& other):
+        qr(other.qr),
+        subModelFailed(other.subModelFailed)
+    {
+        workerPool.resize(other.workerPool.getNrOfWorkerThreads());
+    }
+
+    LeastSquaresSolvers& operator=(const LeastSquaresSolvers& other)
+    {
+        qr = other.qr;
+        subModelFailed = other.subModelFailed;
+        if (workerPool.getNrOfWorkerThreads() != other.workerPool.getNrOfWorkerThreads())
+        {
+            workerPool.resize(other.workerPool.getNrOfWorkerThreads());
+        }
+        return *this;
+    }
+};
+
+estimateExternalWrenchesBuffers::estimateExternalWrenchesBuffers():
+    m_solvers(new LeastSquaresSolvers())
 {
     resize(0,0);
 }
 
 
-estimateExternalWrenchesBuffers::estimateExternalWrenchesBuffers(const SubModelDecomposition& subModels)
+estimateExternalWrenchesBuffers::estimateExternalWrenchesBuffers(const SubModelDecomposition& subModels):
+    m_solvers(new LeastSquaresSolvers())
 {
     resize(subModels);
 }
 
-estimateExternalWrenchesBuffers::estimateExternalWrenchesBuffers(const size_t nrOfSubModels, const size_t nrOfLinks)
+estimateExternalWrenchesBuffers::estimateExternalWrenchesBuffers(const size_t nrOfSubModels, const size_t nrOfLinks):
+    m_solvers(new LeastSquaresSolvers())
 {
     resize(nrOfSubModels,nrOfLinks);
 }
 
+estimateExternalWrenchesBuffers::estimateExternalWrenchesBuffers(const estimateExternalWrenchesBuffers& other):
+    A(other.A),
+    x(other.x),
+    b(other.b),
+    b_contacts_subtree(other.b_contacts_subtree),
+    subModelBase_H_link(other.subModelBase_H_link),
+    m_solvers(new LeastSquaresSolvers(*(other.m_solvers)))
+{
+}
+
+estimateExternalWrenchesBuffers& estimateExternalWrenchesBuffers::operator=(const estimateExternalWrenchesBuffers& other)
+{
+    if (this != &other)
+    {
+        A = other.A;
+        x = other.x;
+        b = other.b;
+        b_contacts_subtree = other.b_contacts_subtree;
+        subModelBase_H_link = other.subModelBase_H_link;
+        *m_solvers = *(other.m_solvers);
+    }
+    return *this;
+}
+
+estimateExternalWrenchesBuffers::~estimateExternalWrenchesBuffers()
+{
+    delete m_solvers;
+    m_solvers = nullptr;
+}
+
 
 void estimateExternalWrenchesBuffers::resize(const SubModelDecomposition& subModels)
 {
@@ -198,6 +265,8 @@ void estimateExternalWrenchesBuffers::resize(const size_t nrOfSubModels, const s
     A.resize(nrOfSubModels);
     x.resize(nrOfSubModels);
     b.resize(nrOfSubModels);
+    m_solvers->qr.resize(nrOfSubModels);
+    m_solvers->subModelFailed.resize(nrOfSubModels);
 
     b_contacts_subtree.resize(nrOfLinks);
 
@@ -214,6 +283,26 @@ size_t estimateExternalWrenchesBuffers::getNrOfSubModels() const
     return A.size();
 }
 
+void estimateExternalWrenchesBuffers::solveLeastSquaresProblem(const size_t subModelIndex)
+{
+    assert(subModelIndex < m_solvers->qr.size());
+
+    // compute reuses the storage of the decomposition if the size of A did not change
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> & qr = m_solvers->qr[subModelIndex];
+    qr.compute(toEigen(A[subModelIndex]));
+    toEigen(x[subModelIndex]) = qr.solve(toEigen(b[subModelIndex]));
+}
+
+bool estimateExternalWrenchesBuffers::setNrOfWorkerThreads(const size_t nrOfWorkerThreads)
+{
+    return m_solvers->workerPool.resize(nrOfWorkerThreads);
+}
+
+size_t estimateExternalWrenchesBuffers::getNrOfWorkerThreads() const
+{
+    return m_solvers->workerPool.getNrOfWorkerThreads();
+}
+
 bool estimateExternalWrenchesBuffers::isConsistent(const SubModelDecomposition& subModels) const
 {
     return (subModels.getNrOfSubModels() == A.size()) &&
@@ -601,7 +690,7 @@ bool estimateExternalWrenchesWithoutInternalFT(const Model& model,
        //               tol);
 
        // Now we compute the unknowns
-       toEigen(bufs.x[subModelIndex]) = toEigen(bufs.A[subModelIndex]).colPivHouseholderQr().solve(toEigen(bufs.b[subModelIndex]));
+       bufs.solveLeastSquaresProblem(subModelIndex);
    }
 
    // We copy the estimated unknowns in the outputContactWrenches
@@ -630,8 +719,9 @@ bool estimateExternalWrenches(const Model& model,
     // Resize the output data structure
     outputContactWrenches.resize(model);
 
-    // Solve the problem for each submodel
-    for(size_t sm=0; sm < subModels.getNrOfSubModels(); sm++ )
+    // Solve the problem for each submodel. The submodels do not share any link,
+    // so they can be solved in parallel writing each the buffers of its own links.
+    auto estimateSubModel = [&](const size_t sm)
     {
         // Number of unknowns for this submodel
         const Traversal & subModelTraversal = subModels.getTraversal(sm);
@@ -651,7 +741,7 @@ bool estimateExternalWrenches(const Model& model,
         // If A has no unkowns then pseudoInverse can not be computed
         // In that case, we do not compute the x vector because it will have zero elements 
         if (bufs.A[sm].rows() > 0 && bufs.A[sm].cols() > 0) {
-	    toEigen(bufs.x[sm]) = toEigen(bufs.A[sm]).colPivHouseholderQr().solve(toEigen(bufs.b[sm]));	    
+            bufs.solveLeastSquaresProblem(sm);
         }
 
         // Check if there are any nan in the estimation results
@@ -665,21 +755,32 @@ bool estimateExternalWrenches(const Model& model,
             }
         }
 
+        bufs.m_solvers->subModelFailed[sm] = someResultIsNan;
         if (someResultIsNan)
         {
-            reportError("", "estimateExternalWrenches", "NaN found in estimation result, estimation failed");
-            return false;
+            return;
         }
 
         // We copy the estimated unknowns in the outputContactWrenches
         // Note that the logic of conversion between input/output contacts should be
         // the same used before in computeMatrixOfEstimationEquation
         storeResultsOfEstimation(subModelTraversal,unknownWrenches,sm,bufs,outputContactWrenches);
+    };
+    bufs.m_solvers->workerPool.run(subModels.getNrOfSubModels(), estimateSubModel);
+
+    for(size_t sm=0; sm < subModels.getNrOfSubModels(); sm++ )
+    {
+        if (bufs.m_solvers->subModelFailed[sm])
+        {
+            reportError("", "estimateExternalWrenches", "NaN found in estimation result, estimation failed");
+            return false;
+        }
     }
 
     return true;
 }
 
+
 bool dynamicsEstimationForwardVelAccKinematics(const iDynTree::Model & /*model*/,
                                                const iDynTree::Traversal & traversal,
                                                const Vector3 & base_classicalProperAcc,
@@ -358,6 +358,8 @@ void testBerdyHelpers(std::string fileName)
     ok = berdyHelper.init(estimator.model(), estimator.sensors(), options);
     ASSERT_IS_TRUE(ok);
     testBerdySensorMatrices(berdyHelper, fileName);
+    // The second time the matrices are filled using the sparsity pattern computed the first time
+    testBerdySensorMatrices(berdyHelper, fileName);
     
     // Test includeAllJointTorqueAsSensors option 
     options.berdyVariant = iDynTree::BERDY_FLOATING_BASE;
@@ -4,11 +4,15 @@
 #include <iDynTree/BerdySparseMAPSolver.h>
 
 #include <iDynTree/BerdyHelper.h>
+#include <iDynTree/ExtWrenchesAndJointTorquesEstimator.h>
 
+#include "testModels.h"
 #include <iDynTree/EigenHelpers.h>
 #include <iDynTree/EigenSparseHelpers.h>
 #include <iDynTree/TestUtils.h>
 
+#include <Eigen/Dense>
+
 #include <cstdio>
 #include <cstdlib>
 
@@ -22,9 +26,197 @@ void testEmptyHelper()
     ASSERT_IS_FALSE(solver.isValid());
 }
 
+/**
+ * Get a random symmetric positive definite covariance, that is
+ * block diagonal with 2x2 blocks if blockDiagonal is true, diagonal otherwise.
+ */
+SparseMatrix<ColumnMajor> getRandomCovariance(const size_t size, bool blockDiagonal)
+{
+    Triplets triplets;
+    for (size_t i=0; i < size; i++)
+    {
+        triplets.pushTriplet(Triplet(i, i, getRandomDouble(1.0, 2.0)));
+        if (blockDiagonal && (i % 2 == 1))
+        {
+            double offDiagonal = getRandomDouble(-0.5, 0.5);
+            triplets.pushTriplet(Triplet(i-1, i, offDiagonal));
+            triplets.pushTriplet(Triplet(i, i-1, offDiagonal));
+        }
+    }
+
+    SparseMatrix<ColumnMajor> covariance(size, size);
+    covariance.setFromTriplets(triplets);
+    return covariance;
+}
+
+/**
+ * Get a random diagonal covariance, whose only off-diagonal elements are in (coupledIndex, coupledIndex+1)
+ * and (coupledIndex+1, coupledIndex). Changing coupledIndex changes the sparsity pattern but not the number of nonzeros.
+ */
+SparseMatrix<ColumnMajor> getRandomCovarianceWithCoupling(const size_t size, const size_t coupledIndex)
+{
+    Triplets triplets;
+    for (size_t i=0; i < size; i++)
+    {
+        triplets.pushTriplet(Triplet(i, i, getRandomDouble(1.0, 2.0)));
+    }
+    double offDiagonal = getRandomDouble(-0.5, 0.5);
+    triplets.pushTriplet(Triplet(coupledIndex, coupledIndex+1, offDiagonal));
+    triplets.pushTriplet(Triplet(coupledIndex+1, coupledIndex, offDiagonal));
+
+    SparseMatrix<ColumnMajor> covariance(size, size);
+    covariance.setFromTriplets(triplets);
+    return covariance;
+}
+
+void checkEstimate(BerdyHelper & berdy,
+                   BerdySparseMAPSolver & solver,
+                   const VectorDynSize & measurements)
+{
+    MatrixDynSize D(berdy.getNrOfDynamicEquations(), berdy.getNrOfDynamicVariables());
+    MatrixDynSize Y(berdy.getNrOfSensorsMeasurements(), berdy.getNrOfDynamicVariables());
+    VectorDynSize bD(berdy.getNrOfDynamicEquations()), bY(berdy.getNrOfSensorsMeasurements());
+    D.zero();
+    Y.zero();
+    bool ok = berdy.getBerdyMatrices(D, bD, Y, bY);
+    ASSERT_IS_TRUE(ok);
+
+    // Dense computation of the maximum a posteriori, Eq. 10 and 11 of Latella et al. 2016
+    Eigen::MatrixXd regularizationInverse = Eigen::MatrixXd(toEigen(solver.dynamicsRegularizationPriorCovarianceInverse()));
+    Eigen::MatrixXd priorInverse = regularizationInverse;
+    Eigen::VectorXd priorMean = toEigen(solver.dynamicsRegularizationPriorExpectedValue());
+    if (berdy.getOptions().berdyVariant != BERDY_FLOATING_BASE_NON_COLLOCATED_EXT_WRENCHES)
+    {
+        Eigen::MatrixXd constraintsInverse = Eigen::MatrixXd(toEigen(solver.dynamicsConstraintsPriorCovarianceInverse()));
+        priorInverse += toEigen(D).transpose()*constraintsInverse*toEigen(D);
+        priorMean = priorInverse.ldlt().solve(regularizationInverse*priorMean - toEigen(D).transpose()*constraintsInverse*toEigen(bD));
+    }
+
+    Eigen::MatrixXd measurementsInverse = Eigen::MatrixXd(toEigen(solver.measurementsPriorCovarianceInverse()));
+    Eigen::MatrixXd posteriorInverse = toEigen(Y).transpose()*measurementsInverse*toEigen(Y) + priorInverse;
+    Eigen::VectorXd posteriorMean = posteriorInverse.ldlt().solve(toEigen(Y).transpose()*measurementsInverse*(toEigen(measurements) - toEigen(bY))
+                                                                  + priorInverse*priorMean);
+
+    VectorDynSize expected(posteriorMean.size());
+    toEigen(expected) = posteriorMean;
+    ASSERT_EQUAL_VECTOR_TOL(solver.getLastEstimate(), expected, 1e-6);
+}
+
+void initBerdy(const std::string & fileName, const BerdyVariants variant, BerdyHelper & berdy)
+{
+    ExtWrenchesAndJointTorquesEstimator estimator;
+    bool ok = estimator.loadModelAndSensorsFromFile(fileName);
+    ASSERT_IS_TRUE(ok);
+
+    BerdyOptions options;
+    options.berdyVariant = variant;
+    options.includeAllNetExternalWrenchesAsDynamicVariables = true;
+    options.includeAllNetExternalWrenchesAsSensors = true;
+    options.includeAllJointAccelerationsAsSensors = (variant != BERDY_FLOATING_BASE_NON_COLLOCATED_EXT_WRENCHES);
+    ok = berdy.init(estimator.model(), options);
+    ASSERT_IS_TRUE(ok);
+}
+
+void testMAPConsistency(const std::string & fileName, const BerdyVariants variant)
+{
+    BerdyHelper berdy;
+    initBerdy(fileName, variant, berdy);
+
+    BerdySparseMAPSolver solver(berdy);
+    bool ok = solver.initialize();
+    ASSERT_IS_TRUE(ok);
+
+    if (variant != BERDY_FLOATING_BASE_NON_COLLOCATED_EXT_WRENCHES)
+    {
+        solver.setDynamicsConstraintsPriorCovariance(getRandomCovariance(berdy.getNrOfDynamicEquations(), false));
+    }
+    solver.setDynamicsRegularizationPriorCovariance(getRandomCovariance(berdy.getNrOfDynamicVariables(), false));
+    VectorDynSize regularizationMean(berdy.getNrOfDynamicVariables());
+    getRandomVector(regularizationMean);
+    solver.setDynamicsRegularizationPriorExpectedValue(regularizationMean);
+
+    JointPosDoubleArray jointPos(berdy.model());
+    JointDOFsDoubleArray jointVel(berdy.model());
+    Vector3 baseAngularVel;
+    VectorDynSize measurements(berdy.getNrOfSensorsMeasurements());
+
+    for (int i=0; i < 3; i++)
+    {
+        // The last iteration changes the sparsity pattern of the measurements covariance
+        solver.setMeasurementsPriorCovariance(getRandomCovariance(berdy.getNrOfSensorsMeasurements(), i == 2));
+
+        getRandomVector(jointPos);
+        getRandomVector(jointVel);
+        getRandomVector(baseAngularVel);
+        getRandomVector(measurements);
+        solver.updateEstimateInformationFloatingBase(jointPos, jointVel, berdy.model().getDefaultBaseLink(),
+                                                     baseAngularVel, measurements);
+        ok = solver.doEstimate();
+        ASSERT_IS_TRUE(ok);
+
+        checkEstimate(berdy, solver, measurements);
+    }
+}
+
+/**
+ * Change the sparsity pattern of the prior covariance of the dynamics, keeping its number of nonzeros,
+ * and check that the estimate is the one of a solver initialized with the new covariance.
+ */
+void testPriorCovariancePatternChange(const std::string & fileName, const BerdyVariants variant)
+{
+    BerdyHelper berdy;
+    initBerdy(fileName, variant, berdy);
+
+    BerdySparseMAPSolver solver(berdy);
+    bool ok = solver.initialize();
+    ASSERT_IS_TRUE(ok);
+
+    JointPosDoubleArray jointPos(berdy.model());
+    JointDOFsDoubleArray jointVel(berdy.model());
+    Vector3 baseAngularVel;
+    VectorDynSize measurements(berdy.getNrOfSensorsMeasurements());
+    getRandomVector(jointPos);
+    getRandomVector(jointVel);
+    getRandomVector(baseAngularVel);
+    getRandomVector(measurements);
+
+    const size_t nrOfDynamicVariables = berdy.getNrOfDynamicVariables();
+    solver.setDynamicsRegularizationPriorCovariance(getRandomCovarianceWithCoupling(nrOfDynamicVariables, 0));
+    solver.updateEstimateInformationFloatingBase(jointPos, jointVel, berdy.model().getDefaultBaseLink(),
+                                                 baseAngularVel, measurements);
+    ok = solver.doEstimate();
+    ASSERT_IS_TRUE(ok);
+
+    SparseMatrix<ColumnMajor> covariance = getRandomCovarianceWithCoupling(nrOfDynamicVariables, nrOfDynamicVariables/2);
+    solver.setDynamicsRegularizationPriorCovariance(covariance);
+    ok = solver.doEstimate();
+    ASSERT_IS_TRUE(ok);
+
+    BerdySparseMAPSolver freshSolver(berdy);
+    ok = freshSolver.initialize();
+    ASSERT_IS_TRUE(ok);
+    freshSolver.setDynamicsRegularizationPriorCovariance(covariance);
+    freshSolver.updateEstimateInformationFloatingBase(jointPos, jointVel, berdy.model().getDefaultBaseLink(),
+                                                      baseAngularVel, measurements);
+    ok = freshSolver.doEstimate();
+    ASSERT_IS_TRUE(ok);
+
+    ASSERT_EQUAL_VECTOR_TOL(solver.getLastEstimate(), freshSolver.getLastEstimate(), 1e-8);
+    checkEstimate(berdy, solver, measurements);
+}
+
 int main()
 {
     testEmptyHelper();
 
+    for (const std::string modelName : {"iCubGenova02.urdf", "iCubDarmstadt01.urdf"})
+    {
+        std::string fileName = getAbsModelPath(modelName);
+        testMAPConsistency(fileName, BERDY_FLOATING_BASE);
+        testMAPConsistency(fileName, BERDY_FLOATING_BASE_NON_COLLOCATED_EXT_WRENCHES);
+        testPriorCovariancePatternChange(fileName, BERDY_FLOATING_BASE);
+        testPriorCovariancePatternChange(fileName, BERDY_FLOATING_BASE_NON_COLLOCATED_EXT_WRENCHES);
+    }
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/ExtendedKalmanFilter.h>
+#include <iDynTree/TestUtils.h>
+
+#include <cmath>
+#include <iostream>
+
+using namespace iDynTree;
+
+// pendulum with a biased angle sensor, state is angle, angular velocity and sensor bias, input is the torque
+// measurements are the sine of the angle plus the bias and (optionally) the angular velocity
+const double dt = 0.01;
+const double g = 9.81;
+
+class PendulumEKF : public DiscreteExtendedKalmanFilterHelper
+{
+public:
+    bool ekf_f(const VectorDynSize& x, const VectorDynSize& u, VectorDynSize& xhat) override
+    {
+        xhat(0) = x(0) + dt*x(1);
+        xhat(1) = x(1) + dt*(u(0) - g*std::sin(x(0)));
+        xhat(2) = x(2);
+        return true;
+    }
+
+    bool ekf_h(const VectorDynSize& x, VectorDynSize& z) override
+    {
+        z(0) = std::sin(x(0)) + x(2);
+        if (z.size() > 1)
+        {
+            z(1) = x(1);
+        }
+        return true;
+    }
+
+    bool ekfComputeJacobianF(VectorDynSize& x, MatrixDynSize& F) override
+    {
+        F.zero();
+        F(0, 0) = 1.0; F(0, 1) = dt;
+        F(1, 0) = -dt*g*std::cos(x(0)); F(1, 1) = 1.0;
+        F(2, 2) = 1.0;
+        return true;
+    }
+
+    bool ekfComputeJacobianF(VectorDynSize& x, VectorDynSize& u, MatrixDynSize& F) override
+    {
+        ignore(u);
+        return ekfComputeJacobianF(x, F);
+    }
+
+    bool ekfComputeJacobianH(VectorDynSize& x, MatrixDynSize& H) override
+    {
+        H.zero();
+        H(0, 0) = std::cos(x(0)); H(0, 2) = 1.0;
+        if (H.rows() > 1)
+        {
+            H(1, 1) = 1.0;
+        }
+        return true;
+    }
+};
+
+class PendulumFixedSizeEKF : public DiscreteExtendedKalmanFilterFixedSizeHelper<3, 1, 2>
+{
+public:
+    bool ekf_f(const StateVector& x, const InputVector& u, StateVector& xhat) override
+    {
+        xhat(0) = x(0) + dt*x(1);
+        xhat(1) = x(1) + dt*(u(0) - g*std::sin(x(0)));
+        xhat(2) = x(2);
+        return true;
+    }
+
+    bool ekf_h(const StateVector& x, OutputVector& z) override
+    {
+        z(0) = std::sin(x(0)) + x(2);
+        z(1) = x(1);
+        return true;
+    }
+
+    bool ekfComputeJacobianF(const StateVector& x, const InputVector& u, StateMatrix& F) override
+    {
+        ignore(u);
+        F.zero();
+        F(0, 0) = 1.0; F(0, 1) = dt;
+        F(1, 0) = -dt*g*std::cos(x(0)); F(1, 1) = 1.0;
+        F(2, 2) = 1.0;
+        return true;
+    }
+
+    bool ekfComputeJacobianH(const StateVector& x, OutputJacobian& H) override
+    {
+        H.zero();
+        H(0, 0) = std::cos(x(0)); H(0, 2) = 1.0;
+        H(1, 1) = 1.0;
+        return true;
+    }
+};
+
+void runAndCompare(PendulumEKF& ekf, PendulumFixedSizeEKF& fixedEKF, size_t outputSize, size_t nrOfSteps)
+{
+    VectorDynSize x(3), xFixed(3);
+    MatrixDynSize P(3, 3), PFixed(3, 3);
+    VectorDynSize u(1), y(outputSize);
+    for (size_t step = 0; step < nrOfSteps; step++)
+    {
+        u(0) = std::sin(0.1*step);
+        ASSERT_IS_TRUE(ekf.ekfSetInputVector(make_span(u)));
+        ASSERT_IS_TRUE(fixedEKF.ekfSetInputVector(make_span(u)));
+        ASSERT_IS_TRUE(ekf.ekfPredict());
+        ASSERT_IS_TRUE(fixedEKF.ekfPredict());
+
+        y(0) = std::sin(0.3 + 0.02*step) + 0.1;
+        if (outputSize > 1)
+        {
+            y(1) = 0.02*std::cos(0.02*step);
+        }
+        ASSERT_IS_TRUE(ekf.ekfSetMeasurementVector(make_span(y)));
+        ASSERT_IS_TRUE(fixedEKF.ekfSetMeasurementVector(make_span(y)));
+        ASSERT_IS_TRUE(ekf.ekfUpdate());
+        ASSERT_IS_TRUE(fixedEKF.ekfUpdate());
+
+        ASSERT_IS_TRUE(ekf.ekfGetStates(make_span(x)));
+        ASSERT_IS_TRUE(fixedEKF.ekfGetStates(make_span(xFixed)));
+        ASSERT_IS_TRUE(ekf.ekfGetStateCovariance(make_span(P.data(), P.capacity())));
+        ASSERT_IS_TRUE(fixedEKF.ekfGetStateCovariance(make_span(PFixed.data(), PFixed.capacity())));
+        ASSERT_EQUAL_VECTOR_TOL(x, xFixed, 1e-9);
+        ASSERT_EQUAL_MATRIX_TOL(P, PFixed, 1e-9);
+    }
+}
+
+int main()
+{
+    PendulumEKF ekf;
+    PendulumFixedSizeEKF fixedEKF;
+
+    double x0[3] = {0.2, 0.0, 0.0};
+    double P0[9] = {0.5, 0.0, 0.0,
+                    0.0, 0.5, 0.0,
+                    0.0, 0.0, 0.1};
+    double Q[9] = {1e-6, 0.0, 0.0,
+                   0.0, 1e-4, 0.0,
+                   0.0, 0.0, 1e-8};
+    // correlated measurement noise, to check the decorrelation of the sequential update
+    double R[4] = {0.01, 0.004,
+                   0.004, 0.02};
+
+    ASSERT_IS_TRUE(ekf.ekfReset(3, 1, 2, make_span(x0, 3), make_span(P0, 9), make_span(Q, 9), make_span(R, 4)));
+
+    ASSERT_IS_FALSE(fixedEKF.ekfPredict());
+    ASSERT_IS_TRUE(fixedEKF.ekfSetOutputSize(2));
+    ASSERT_IS_FALSE(fixedEKF.ekfSetOutputSize(3));
+    ASSERT_IS_TRUE(fixedEKF.ekfSetInitialState(make_span(x0, 3)));
+    ASSERT_IS_TRUE(fixedEKF.ekfSetStateCovariance(make_span(P0, 9)));
+    ASSERT_IS_TRUE(fixedEKF.ekfSetSystemNoiseCovariance(make_span(Q, 9)));
+    ASSERT_IS_TRUE(fixedEKF.ekfSetMeasurementNoiseCovariance(make_span(R, 4)));
+    double indefiniteR[4] = {0.01, 0.1,
+                             0.1, 0.01};
+    ASSERT_IS_FALSE(fixedEKF.ekfSetMeasurementNoiseCovariance(make_span(indefiniteR, 4)));
+    ASSERT_IS_TRUE(fixedEKF.ekfSetMeasurementNoiseCovariance(make_span(R, 4)));
+
+    runAndCompare(ekf, fixedEKF, 2, 100);
+
+    // use only the first measurement, starting from the current estimate
+    double x1[3], P1[9];
+    ASSERT_IS_TRUE(fixedEKF.ekfGetStates(make_span(x1, 3)));
+    ASSERT_IS_TRUE(fixedEKF.ekfGetStateCovariance(make_span(P1, 9)));
+    double R1[1] = {0.01};
+    ASSERT_IS_TRUE(ekf.ekfReset(3, 1, 1, make_span(x1, 3), make_span(P1, 9), make_span(Q, 9), make_span(R1, 1)));
+    ASSERT_IS_TRUE(fixedEKF.ekfSetOutputSize(1));
+    ASSERT_IS_TRUE(fixedEKF.ekfSetMeasurementNoiseCovariance(make_span(R1, 1)));
+
+    runAndCompare(ekf, fixedEKF, 1, 100);
+
+    std::cout << "Fixed-size EKF is consistent with DiscreteExtendedKalmanFilterHelper." << std::endl;
+    return EXIT_SUCCESS;
+}
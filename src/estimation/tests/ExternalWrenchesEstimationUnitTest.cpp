@@ -320,6 +320,22 @@ void checkSimpleModelExternalWrenchEstimationWithFTSensors()
 
     estimateExternalWrenches(model,subModels,sensors,unknownWrenches,robotPos.jointPos(),vels,properAccs,measSens,bufs,contactWrenches);
 
+    // The estimation of the submodels split between worker threads should give the same result
+    estimateExternalWrenchesBuffers parallelBufs(subModels);
+    ASSERT_IS_TRUE(parallelBufs.setNrOfWorkerThreads(2));
+    LinkContactWrenches parallelContactWrenches(model);
+    bool ok = estimateExternalWrenches(model,subModels,sensors,unknownWrenches,robotPos.jointPos(),vels,properAccs,measSens,parallelBufs,parallelContactWrenches);
+    ASSERT_IS_TRUE(ok);
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+    {
+        ASSERT_EQUAL_DOUBLE(contactWrenches.getNrOfContactsForLink(lnk), parallelContactWrenches.getNrOfContactsForLink(lnk));
+        for(size_t contact=0; contact < contactWrenches.getNrOfContactsForLink(lnk); contact++)
+        {
+            ASSERT_EQUAL_SPATIAL_FORCE(contactWrenches.contactWrench(lnk,contact).contactWrench(),
+                                       parallelContactWrenches.contactWrench(lnk,contact).contactWrench());
+        }
+    }
+
     // Let's compute the new contact wrenches
     LinkNetExternalWrenches newContactWrenches(model);
     LinkInternalWrenches internalWrenches(model);
@@ -34,6 +34,33 @@ class Traversal;
 class Position;
 class FreeFloatingGeneralizedTorques;
 
+/**
+ * \ingroup iDynTreeHighLevel
+ *
+ * Number of times each intermediate quantity cached by KinDynComputations has been computed.
+ *
+ * @see KinDynComputations::getCacheCounters
+ */
+struct KinDynComputationsCacheCounters
+{
+    /** Number of computations of the link positions (forward position kinematics). */
+    size_t forwardPositionKinematics;
+    /**
+     * Number of link positions (world_H_link transforms) computed by the forward position kinematics.
+     * As only the links affected by a change of the state are updated, this can be smaller than
+     * forwardPositionKinematics times the number of links.
+     */
+    size_t linkPositions;
+    /** Number of computations of the link velocities (forward velocity kinematics). */
+    size_t forwardVelocityKinematics;
+    /** Number of computations of the body-fixed mass matrix (composite rigid body algorithm). */
+    size_t massMatrix;
+    /** Number of computations of the total momentum. */
+    size_t totalMomentum;
+    /** Number of computations of the link bias accelerations. */
+    size_t biasAccelerations;
+};
+
 /**
  * \ingroup iDynTreeHighLevel
  *
@@ -49,6 +76,30 @@ class FreeFloatingGeneralizedTorques;
  * and  its  Connection  to  Centroidal  Dynamics
  * https://traversaro.github.io/preprints/changebase.pdf
  *
+ * \section KinDynComputationsRealTime Real-time safe methods
+ *
+ * Once the model has been loaded, the following methods do not allocate memory on the heap
+ * (after they have been called at least once, and as long as the inputs have the correct size),
+ * so they can be used in real-time control loops:
+ *   * all the setRobotState overloads,
+ *   * getWorldTransform, getFrameVel and getFrameFreeFloatingJacobian,
+ *   * getFreeFloatingMassMatrix, generalizedBiasForces, generalizedGravityForces and inverseDynamics,
+ *   * getCenterOfMassPosition and getCenterOfMassJacobian.
+ *
+ * This is checked by the RealTimeAllocations integration test.
+ * Note that the methods returning a std::string or taking a frame name as input, and the error
+ * paths of all the methods (that call reportError), may allocate memory.
+ *
+ * \section KinDynComputationsCache Caching of intermediate results
+ *
+ * The intermediate quantities (link positions, link velocities, mass matrix, total momentum and
+ * link bias accelerations) are computed lazily and cached. When the state is modified (for example via
+ * setRobotState or setJointPos), only the cached quantities that depend on the components of the state
+ * that actually changed are invalidated: for example if only the joint velocities change, the link
+ * positions and the mass matrix are not recomputed. Furthermore, when only some joint positions change
+ * (for example via setJointPos), only the positions of the links in the subtrees rooted at the changed joints
+ * are recomputed (see iDynTree::ForwardPositionKinematicsIncremental). The number of times each cached quantity
+ * has been computed can be inspected with getCacheCounters.
  */
 class KinDynComputations {
 private:
@@ -80,6 +131,13 @@ private:
     // Resize internal data structures after a model has been successfully loaded
     void resizeInternalDataStructures();
 
+    // Common implementation of the setRobotState overloads, that does not allocate memory
+    bool setRobotStateImpl(const iDynTree::Transform & world_T_base,
+                           iDynTree::Span<const double> s,
+                           const iDynTree::Twist & base_velocity,
+                           iDynTree::Span<const double> s_dot,
+                           const iDynTree::Vector3 & world_gravity);
+
 public:
 
     /**
@@ -135,6 +193,23 @@ public:
      * @see setFrameVelocityRepresentation
      */
     FrameVelocityRepresentation getFrameVelocityRepresentation() const;
+
+    /**
+     * Set the number of worker threads that the class can use, in addition to the calling thread,
+     * to split the computations that involve many independent quantities (currently getFramesFreeFloatingJacobians).
+     *
+     * The threads are created by this method and are kept alive until the destruction of the class,
+     * so that the methods that use them do not create threads nor allocate memory.
+     * The default is 0, i.e. all the computations are performed in the calling thread.
+     *
+     * @return true if all went well, false otherwise (for example if the threads could not be created).
+     */
+    bool setNrOfWorkerThreads(const size_t nrOfWorkerThreads);
+
+    /**
+     * Get the number of worker threads set with setNrOfWorkerThreads.
+     */
+    size_t getNrOfWorkerThreads() const;
     //@}
 
 
@@ -712,6 +787,23 @@ public:
     bool getFrameFreeFloatingJacobian(const FrameIndex frameIndex,
                                       iDynTree::MatrixView<double> outJacobian);
 
+    /**
+     * Compute the free floating jacobians of several frames for the given representation.
+     *
+     * The result is the same of calling getFrameFreeFloatingJacobian for each frame, but the parts of the computation
+     * that are common to all the frames (the motion subspaces of all the joints, expressed in the inertial frame)
+     * are computed only once for a given state, and the frames are split between the worker threads set
+     * with setNrOfWorkerThreads.
+     *
+     * @param[in] frameIndices the indices of the k frames.
+     * @param[out] outJacobians the (6k)x(6+getNrOfDegreesOfFreedom()) matrix whose rows 6i, ..., 6i+5 contain
+     *                          the jacobian of the frame frameIndices[i].
+     * @warning the MatrixView objects should point an already existing memory. Memory allocation and resizing cannot be achieved with this kind of objects.
+     * @return true if all went well, false otherwise.
+     */
+    bool getFramesFreeFloatingJacobians(const std::vector<FrameIndex> & frameIndices,
+                                        iDynTree::MatrixView<double> outJacobians);
+
 
 
     /**
@@ -1358,6 +1450,25 @@ public:
 
     //@}
 
+    /**
+      * @name Methods to inspect the cache of intermediate results.
+      */
+    //@{
+
+    /**
+     * Get the number of times each cached intermediate quantity has been computed
+     * since the model was loaded or since the last call to resetCacheCounters.
+     *
+     * @see \ref KinDynComputationsCache
+     */
+    KinDynComputationsCacheCounters getCacheCounters() const;
+
+    /**
+     * Reset to zero the counters returned by getCacheCounters.
+     */
+    void resetCacheCounters();
+
+    //@}
 
 };
 
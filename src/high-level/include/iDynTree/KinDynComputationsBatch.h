@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef IDYNTREE_KINDYNCOMPUTATIONS_BATCH_H
+#define IDYNTREE_KINDYNCOMPUTATIONS_BATCH_H
+
+#include <string>
+
+#include <iDynTree/MatrixView.h>
+#include <iDynTree/Span.h>
+
+#include <iDynTree/Indices.h>
+#include <iDynTree/FreeFloatingMatrices.h>
+
+namespace iDynTree
+{
+
+class Model;
+
+/**
+ * \ingroup iDynTreeHighLevel
+ *
+ * \brief High level class to evaluate kinematics and dynamics quantities for many robot states at once.
+ *
+ * While KinDynComputations stores a single robot state, this class stores N states (set all together
+ * with setRobotStates) and computes the requested quantities for all of them in a single call.
+ * The outputs of the getters are returned stacked, i.e. the quantity related to the k-th state
+ * is contained in the k-th block of rows of the output matrix.
+ *
+ * Internally the data is stored with a structure-of-arrays layout: all the quantities of a given link
+ * (its transform, velocity, composite inertia, ...) for all the states are stored contiguously, and the
+ * algorithms loop over the links of the traversal in the outer loop and over the states in the inner loop.
+ * In this way the per-link overhead (access to the model topology, to the joint properties and to the link
+ * inertia) is paid once for all the states, instead that once for each state.
+ *
+ * The results are consistent with the ones of KinDynComputations, for all the supported
+ * FrameVelocityRepresentation. Only models with joints with 0 (fixed) or 1 degrees of freedom
+ * whose motion subspace is constant in the child frame (i.e. iDynTree::RevoluteJoint and
+ * iDynTree::PrismaticJoint) are supported.
+ *
+ * \note The computations are performed lazily and cached: a call to a getter only computes the
+ *       intermediate quantities that were not already computed after the last call to setRobotStates.
+ */
+class KinDynComputationsBatch
+{
+private:
+    struct KinDynComputationsBatchPrivateAttributes;
+    KinDynComputationsBatchPrivateAttributes * pimpl;
+
+    // copy is disabled
+    KinDynComputationsBatch(const KinDynComputationsBatch & other);
+    KinDynComputationsBatch& operator=(const KinDynComputationsBatch& other);
+
+    // Make sure that (if necessary) the link positions and velocities are updated
+    void computeFwdKinematics();
+
+    // Make sure that (if necessary) the body-fixed mass matrices are updated
+    void computeRawMassMatrices();
+
+public:
+    /**
+     * Constructor
+     */
+    KinDynComputationsBatch();
+
+    /**
+     * Destructor
+     */
+    virtual ~KinDynComputationsBatch();
+
+    /**
+     * Load the model of the robot from a iDynTree::Model class.
+     *
+     * @param model the model to use in this class.
+     * @return true if all went ok, false otherwise (for example if the model
+     *         contains joints not supported by this class).
+     */
+    bool loadRobotModel(const iDynTree::Model & model);
+
+    /**
+     * Return true if the model of the robot has been correctly loaded.
+     */
+    bool isValid() const;
+
+    /**
+     * Get the model used by the class.
+     */
+    const Model & model() const;
+
+    /**
+     * Set the used FrameVelocityRepresentation.
+     *
+     * @note As in KinDynComputations, the base velocities passed to setRobotStates are interpreted
+     *       with the FrameVelocityRepresentation set when setRobotStates is called.
+     */
+    bool setFrameVelocityRepresentation(const FrameVelocityRepresentation frameVelRepr);
+
+    /**
+     * Get the used FrameVelocityRepresentation.
+     */
+    FrameVelocityRepresentation getFrameVelocityRepresentation() const;
+
+    /**
+     * Set the link that is used as the floating base link.
+     *
+     * @return true if all went well, false otherwise (for example if the link name was not found).
+     */
+    bool setFloatingBase(const std::string & floatingBaseName);
+
+    /**
+     * Get the name of the link considered as the floating base.
+     */
+    std::string getFloatingBase() const;
+
+    /**
+     * Get the number of internal degrees of freedom of the robot model.
+     */
+    unsigned int getNrOfDegreesOfFreedom() const;
+
+    /**
+     * Get the number of robot states currently stored in the class.
+     */
+    size_t getNrOfStates() const;
+
+    /**
+     * Set N states of the robot.
+     *
+     * @param[in] world_T_bases the (4N)x4 matrix containing the N stacked homogeneous transforms world_T_base.
+     * @param[in] s the Nx(getNrOfDegreesOfFreedom()) matrix whose k-th row contains the joint positions of the k-th state.
+     * @param[in] base_velocities the Nx6 matrix whose k-th row contains the base velocity of the k-th state,
+     *                            expressed in the FrameVelocityRepresentation used by the class.
+     * @param[in] s_dot the Nx(getNrOfDegreesOfFreedom()) matrix whose k-th row contains the joint velocities of the k-th state.
+     * @param[in] world_gravity the 3d gravity vector, expressed in the world frame, shared by all the states.
+     * @return true if all went well, false otherwise (for example if the input sizes are not consistent).
+     */
+    bool setRobotStates(MatrixView<const double> world_T_bases,
+                        MatrixView<const double> s,
+                        MatrixView<const double> base_velocities,
+                        MatrixView<const double> s_dot,
+                        Span<const double> world_gravity);
+
+    /**
+     * Set N states of the robot, assuming that for all the states the base is
+     * at the origin of the world and its velocity is zero.
+     *
+     * @see setRobotStates
+     */
+    bool setRobotStates(MatrixView<const double> s,
+                        MatrixView<const double> s_dot,
+                        Span<const double> world_gravity);
+
+    /**
+     * Get the world_H_frame transform of a given frame for all the states.
+     *
+     * @param[in] frameIndex the index of the frame.
+     * @param[out] world_T_frames the (4N)x4 matrix of the stacked homogeneous transforms.
+     * @return true if all went well, false otherwise.
+     */
+    bool getWorldTransforms(const FrameIndex frameIndex,
+                            MatrixView<double> world_T_frames);
+
+    /**
+     * Get the free floating mass matrix of the system for all the states.
+     *
+     * @param[out] freeFloatingMassMatrices the (N*(6+getNrOfDegreesOfFreedom()))x(6+getNrOfDegreesOfFreedom())
+     *             matrix of the stacked mass matrices.
+     * @return true if all went well, false otherwise.
+     *
+     * @see KinDynComputations::getFreeFloatingMassMatrix
+     */
+    bool getFreeFloatingMassMatrices(MatrixView<double> freeFloatingMassMatrices);
+
+    /**
+     * Get the generalized bias forces (coriolis, centrifugal and gravity terms) for all the states.
+     *
+     * @param[out] generalizedBiasForces the Nx(6+getNrOfDegreesOfFreedom()) matrix whose k-th row
+     *             contains the generalized bias forces of the k-th state.
+     * @return true if all went well, false otherwise.
+     *
+     * @see KinDynComputations::generalizedBiasForces
+     */
+    bool generalizedBiasForces(MatrixView<double> generalizedBiasForces);
+
+    /**
+     * Get the free floating jacobian of a frame for all the states.
+     *
+     * @param[in] frameIndex the index of the frame.
+     * @param[out] outJacobians the (6N)x(6+getNrOfDegreesOfFreedom()) matrix of the stacked jacobians.
+     * @return true if all went well, false otherwise.
+     *
+     * @see KinDynComputations::getFrameFreeFloatingJacobian
+     */
+    bool getFrameFreeFloatingJacobians(const FrameIndex frameIndex,
+                                       MatrixView<double> outJacobians);
+};
+
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include <iDynTree/Transform.h>
 #include <iDynTree/Rotation.h>
 #include <iDynTree/Utils.h>
+#include <iDynTree/WorkerPool.h>
 #include <iDynTree/SpatialAcc.h>
 #include <iDynTree/SpatialInertia.h>
 #include <iDynTree/Wrench.h>
@@ -37,15 +38,61 @@ namespace iDynTree
 unsigned int DEFAULT_DYNAMICS_COMPUTATION_FRAME_INDEX=10000;
 std::string DEFAULT_DYNAMICS_COMPUTATION_FRAME_NAME="iDynTreeDynCompDefaultFrame";
 
-struct KinDynComputations::KinDynComputationsPrivateAttributes
+/**
+ * Components of the state of KinDynComputations, used to track
+ * which cached quantities need to be recomputed after a change of the state.
+ */
+enum KinDynStateComponent
+{
+    JOINT_POS_STATE          = 1 << 0,
+    JOINT_VEL_STATE          = 1 << 1,
+    BASE_POSE_STATE          = 1 << 2,
+    BASE_VEL_STATE           = 1 << 3,
+    GRAVITY_STATE            = 1 << 4,
+    FRAME_VEL_REPR_STATE     = 1 << 5,
+    TRAVERSAL_STATE          = 1 << 6,
+    ALL_STATE                = (1 << 7) - 1
+};
+
+/**
+ * A quantity that is computed lazily from the state of KinDynComputations.
+ *
+ * dependencies is the set of state components (KinDynStateComponent) on which
+ * the quantity depends, also indirectly through other cached quantities:
+ * the quantity is invalidated only if one of these components changes.
+ */
+struct KinDynCachedQuantity
 {
-private:
-    // Disable copy constructor and copy operator (move them to = delete when we support C++11)
-    KinDynComputationsPrivateAttributes(const KinDynComputationsPrivateAttributes&other)
+    unsigned int dependencies;
+    bool isUpdated;
+    size_t nrOfComputations;
+
+    KinDynCachedQuantity(unsigned int _dependencies):
+        dependencies(_dependencies), isUpdated(false), nrOfComputations(0)
     {
-        assert(false);
     }
 
+    void invalidate(unsigned int changedStateComponents)
+    {
+        if (dependencies & changedStateComponents)
+        {
+            isUpdated = false;
+        }
+    }
+
+    void setUpdated(bool ok)
+    {
+        isUpdated = ok;
+        nrOfComputations++;
+    }
+};
+
+struct KinDynComputations::KinDynComputationsPrivateAttributes
+{
+private:
+    // Disable copy constructor and copy operator
+    KinDynComputationsPrivateAttributes(const KinDynComputationsPrivateAttributes&other) = delete;
+
     KinDynComputationsPrivateAttributes& operator=(const Traversal& other)
     {
         assert(false);
@@ -93,18 +140,56 @@ public:
     // 3d gravity vector, expressed with the orientation of the base link frame
     iDynTree::Vector3 m_gravityAccInBaseLinkFrame;
 
-    // Forward kinematics data structure
-    // true whenever computePosition has been called
-    // since the last call to setRobotState
-    bool m_isFwdKinematicsUpdated;
+    // Cached quantities. Note that the gravity does not affect any cached quantity,
+    // as it is accounted for when the dynamics quantities are computed.
+    // The link velocities and the raw mass matrix are expressed in body-fixed representation,
+    // so they do not depend on the base pose nor on the used FrameVelocityRepresentation.
+    KinDynCachedQuantity m_fwdPosKinematics;
+    KinDynCachedQuantity m_fwdVelKinematics;
+    KinDynCachedQuantity m_rawMassMatrixCache;
+    KinDynCachedQuantity m_totalMomentumCache;
+    KinDynCachedQuantity m_biasAccelerationsCache;
+    KinDynCachedQuantity m_worldMotionSubspacesCache;
+
+    // Invalidate the cached quantities that depend on the changed state components
+    void invalidateCache(unsigned int changedStateComponents)
+    {
+        // The link positions stored in m_linkPos are not valid anymore for a different traversal
+        if( changedStateComponents & TRAVERSAL_STATE )
+        {
+            m_fwdPosKinematicsBuffers.invalidate();
+        }
+        m_fwdPosKinematics.invalidate(changedStateComponents);
+        m_fwdVelKinematics.invalidate(changedStateComponents);
+        m_rawMassMatrixCache.invalidate(changedStateComponents);
+        m_totalMomentumCache.invalidate(changedStateComponents);
+        m_biasAccelerationsCache.invalidate(changedStateComponents);
+        m_worldMotionSubspacesCache.invalidate(changedStateComponents);
+    }
 
     // storage of forward position kinematics results
     iDynTree::LinkPositions m_linkPos;
 
+    // buffers used to only recompute the link positions affected by a change of the state
+    iDynTree::ForwardPositionKinematicsIncrementalBuffers m_fwdPosKinematicsBuffers;
+    size_t m_nrOfLinkPositionsComputations;
+
     // storage of forward velocity kinematics results
     iDynTree::LinkVelArray m_linkVel;
 
-    bool m_isRawMassMatrixUpdated;
+    // Motion subspace vectors of all the degrees of freedom, expressed in the inertial frame.
+    // The column i is the column 6+i of the free floating jacobian (in INERTIAL_FIXED_REPRESENTATION)
+    // of any link that is in the subtree of the joint of the degree of freedom i.
+    Eigen::Matrix<double, 6, Eigen::Dynamic> m_worldMotionSubspaces;
+
+    // Worker threads used to split the computation of the jacobians of several frames
+    WorkerPool m_workerPool;
+
+    // Compute the free floating jacobian of a frame using m_worldMotionSubspaces. This method
+    // only reads the state of the class, so it can be called concurrently for different frames.
+    void computeFrameFreeFloatingJacobianUsingWorldMotionSubspaces(const FrameIndex frameIndex,
+                                                                   const Matrix6x6& world_X_jacobBaseFrame,
+                                                                   MatrixView<double> jacobian) const;
 
     // storage of the CRBs, used to extract
     LinkCompositeRigidBodyInertias m_linkCRBIs;
@@ -137,8 +222,6 @@ public:
     MatrixDynSize m_jacBuffer;
 
     // Bias accelerations buffers
-    bool m_areBiasAccelerationsUpdated;
-
     // Storate of base bias acceleration
     SpatialAcc m_baseBiasAcc;
 
@@ -180,13 +263,17 @@ public:
     /** Buffer of link proper accelerations, always set to zero for external forces */
     LinkAccArray m_invDynZeroLinkProperAcc;
 
-    KinDynComputationsPrivateAttributes()
+    KinDynComputationsPrivateAttributes():
+        m_fwdPosKinematics(JOINT_POS_STATE | BASE_POSE_STATE | TRAVERSAL_STATE),
+        m_fwdVelKinematics(JOINT_POS_STATE | JOINT_VEL_STATE | BASE_VEL_STATE | TRAVERSAL_STATE),
+        m_rawMassMatrixCache(JOINT_POS_STATE | TRAVERSAL_STATE),
+        m_totalMomentumCache(JOINT_POS_STATE | JOINT_VEL_STATE | BASE_POSE_STATE | BASE_VEL_STATE | TRAVERSAL_STATE),
+        m_biasAccelerationsCache(JOINT_POS_STATE | JOINT_VEL_STATE | BASE_POSE_STATE | BASE_VEL_STATE | FRAME_VEL_REPR_STATE | TRAVERSAL_STATE),
+        m_worldMotionSubspacesCache(JOINT_POS_STATE | BASE_POSE_STATE | TRAVERSAL_STATE)
     {
         m_isModelValid = false;
         m_frameVelRepr = MIXED_REPRESENTATION;
-        m_isFwdKinematicsUpdated = false;
-        m_isRawMassMatrixUpdated = false;
-        m_areBiasAccelerationsUpdated = false;
+        m_nrOfLinkPositionsComputations = 0;
         m_baseVelSetViaRobotState = iDynTree::Twist::Zero();
     }
 };
@@ -315,9 +402,29 @@ KinDynComputations::~KinDynComputations()
 
 void KinDynComputations::invalidateCache()
 {
-    this->pimpl->m_isFwdKinematicsUpdated = false;
-    this->pimpl->m_isRawMassMatrixUpdated = false;
-    this->pimpl->m_areBiasAccelerationsUpdated = false;
+    this->pimpl->invalidateCache(ALL_STATE);
+}
+
+KinDynComputationsCacheCounters KinDynComputations::getCacheCounters() const
+{
+    KinDynComputationsCacheCounters counters;
+    counters.forwardPositionKinematics = pimpl->m_fwdPosKinematics.nrOfComputations;
+    counters.linkPositions = pimpl->m_nrOfLinkPositionsComputations;
+    counters.forwardVelocityKinematics = pimpl->m_fwdVelKinematics.nrOfComputations;
+    counters.massMatrix = pimpl->m_rawMassMatrixCache.nrOfComputations;
+    counters.totalMomentum = pimpl->m_totalMomentumCache.nrOfComputations;
+    counters.biasAccelerations = pimpl->m_biasAccelerationsCache.nrOfComputations;
+    return counters;
+}
+
+void KinDynComputations::resetCacheCounters()
+{
+    pimpl->m_fwdPosKinematics.nrOfComputations = 0;
+    pimpl->m_nrOfLinkPositionsComputations = 0;
+    pimpl->m_fwdVelKinematics.nrOfComputations = 0;
+    pimpl->m_rawMassMatrixCache.nrOfComputations = 0;
+    pimpl->m_totalMomentumCache.nrOfComputations = 0;
+    pimpl->m_biasAccelerationsCache.nrOfComputations = 0;
 }
 
 void KinDynComputations::resizeInternalDataStructures()
@@ -327,7 +434,9 @@ void KinDynComputations::resizeInternalDataStructures()
     this->pimpl->m_pos.resize(this->pimpl->m_robot_model);
     this->pimpl->m_vel.resize(this->pimpl->m_robot_model);
     this->pimpl->m_linkPos.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_fwdPosKinematicsBuffers.resize(this->pimpl->m_robot_model);
     this->pimpl->m_linkVel.resize(this->pimpl->m_robot_model);
+    this->pimpl->m_worldMotionSubspaces.setZero(6, this->pimpl->m_robot_model.getNrOfDOFs());
     this->pimpl->m_linkCRBIs.resize(this->pimpl->m_robot_model);
     this->pimpl->m_rawMassMatrix.resize(this->pimpl->m_robot_model);
     this->pimpl->m_rawMassMatrix.zero();
@@ -371,55 +480,76 @@ std::string KinDynComputations::getFrameName(FrameIndex frameIndex) const
 
 void KinDynComputations::computeFwdKinematics()
 {
-    if( this->pimpl->m_isFwdKinematicsUpdated )
+    bool isPosUpdated = this->pimpl->m_fwdPosKinematics.isUpdated;
+    bool isVelUpdated = this->pimpl->m_fwdVelKinematics.isUpdated;
+
+    if( isPosUpdated && isVelUpdated )
     {
         return;
     }
 
-    // Compute position and velocity kinematics
-    bool ok = ForwardPosVelKinematics(this->pimpl->m_robot_model,
-                                      this->pimpl->m_traversal,
-                                      this->pimpl->m_pos,
-                                      this->pimpl->m_vel,
-                                      this->pimpl->m_linkPos,
-                                      this->pimpl->m_linkVel);
+    if( !isPosUpdated )
+    {
+        // Only the links whose position changed since the last computation are updated
+        bool ok = ForwardPositionKinematicsIncremental(this->pimpl->m_robot_model,
+                                                       this->pimpl->m_traversal,
+                                                       this->pimpl->m_pos,
+                                                       this->pimpl->m_fwdPosKinematicsBuffers,
+                                                       this->pimpl->m_linkPos);
+        if( !ok )
+        {
+            this->pimpl->m_fwdPosKinematicsBuffers.invalidate();
+        }
+        this->pimpl->m_nrOfLinkPositionsComputations += this->pimpl->m_fwdPosKinematicsBuffers.nrOfUpdatedLinks;
+        this->pimpl->m_fwdPosKinematics.setUpdated(ok);
+    }
 
-    this->pimpl->m_isFwdKinematicsUpdated = ok;
+    if( !isVelUpdated )
+    {
+        bool ok = ForwardVelKinematics(this->pimpl->m_robot_model,
+                                       this->pimpl->m_traversal,
+                                       this->pimpl->m_pos,
+                                       this->pimpl->m_vel,
+                                       this->pimpl->m_linkVel);
+        this->pimpl->m_fwdVelKinematics.setUpdated(ok);
+    }
 }
 
 void KinDynComputations::computeRawMassMatrixAndTotalMomentum()
 {
-    if( this->pimpl->m_isRawMassMatrixUpdated )
+    if( !this->pimpl->m_rawMassMatrixCache.isUpdated )
     {
-        return;
-    }
-
-    // Compute raw mass matrix
-    bool ok = CompositeRigidBodyAlgorithm(pimpl->m_robot_model,
-                                          pimpl->m_traversal,
-                                          pimpl->m_pos.jointPos(),
-                                          pimpl->m_linkCRBIs,
-                                          pimpl->m_rawMassMatrix);
+        // Compute raw mass matrix
+        bool ok = CompositeRigidBodyAlgorithm(pimpl->m_robot_model,
+                                              pimpl->m_traversal,
+                                              pimpl->m_pos.jointPos(),
+                                              pimpl->m_linkCRBIs,
+                                              pimpl->m_rawMassMatrix);
 
-    reportErrorIf(!ok,"KinDynComputations::computeRawMassMatrix","Error in computing mass matrix.");
+        reportErrorIf(!ok,"KinDynComputations::computeRawMassMatrix","Error in computing mass matrix.");
 
+        this->pimpl->m_rawMassMatrixCache.setUpdated(ok);
+    }
 
-    // m_linkPos and m_linkVel are used in the computation of the total momentum
-    // so we need to make sure that they are updated
-    this->computeFwdKinematics();
+    if( !this->pimpl->m_totalMomentumCache.isUpdated )
+    {
+        // m_linkPos and m_linkVel are used in the computation of the total momentum
+        // so we need to make sure that they are updated
+        this->computeFwdKinematics();
 
-    // Compute total momentum
-    ComputeLinearAndAngularMomentum(pimpl->m_robot_model,
-                                    pimpl->m_linkPos,
-                                    pimpl->m_linkVel,
-                                    pimpl->m_totalMomentum);
+        // Compute total momentum
+        bool ok = ComputeLinearAndAngularMomentum(pimpl->m_robot_model,
+                                                  pimpl->m_linkPos,
+                                                  pimpl->m_linkVel,
+                                                  pimpl->m_totalMomentum);
 
-    this->pimpl->m_isRawMassMatrixUpdated = ok;
+        this->pimpl->m_totalMomentumCache.setUpdated(ok);
+    }
 }
 
 void KinDynComputations::computeBiasAccFwdKinematics()
 {
-    if( this->pimpl->m_areBiasAccelerationsUpdated )
+    if( this->pimpl->m_biasAccelerationsCache.isUpdated )
     {
         return;
     }
@@ -454,7 +584,7 @@ void KinDynComputations::computeBiasAccFwdKinematics()
 
     reportErrorIf(!ok,"KinDynComputations::computeBiasAccFwdKinematics","Error in computing the bias accelerations.");
 
-    this->pimpl->m_areBiasAccelerationsUpdated = ok;
+    this->pimpl->m_biasAccelerationsCache.setUpdated(ok);
 }
 
 bool KinDynComputations::loadRobotModel(const Model& model)
@@ -477,6 +607,16 @@ FrameVelocityRepresentation KinDynComputations::getFrameVelocityRepresentation()
     return pimpl->m_frameVelRepr;
 }
 
+bool KinDynComputations::setNrOfWorkerThreads(const size_t nrOfWorkerThreads)
+{
+    return pimpl->m_workerPool.resize(nrOfWorkerThreads);
+}
+
+size_t KinDynComputations::getNrOfWorkerThreads() const
+{
+    return pimpl->m_workerPool.getNrOfWorkerThreads();
+}
+
 bool KinDynComputations::setFrameVelocityRepresentation(const FrameVelocityRepresentation frameVelRepr) const
 {
     if( frameVelRepr != INERTIAL_FIXED_REPRESENTATION &&
@@ -493,7 +633,7 @@ bool KinDynComputations::setFrameVelocityRepresentation(const FrameVelocityRepre
     // as they are converted on the fly when the relative retrieval method is called.
     if (frameVelRepr != pimpl->m_frameVelRepr)
     {
-        this->pimpl->m_areBiasAccelerationsUpdated = false;
+        this->pimpl->invalidateCache(FRAME_VEL_REPR_STATE);
     }
 
     pimpl->m_frameVelRepr = frameVelRepr;
@@ -509,7 +649,9 @@ std::string KinDynComputations::getFloatingBase() const
 bool KinDynComputations::setFloatingBase(const std::string& floatingBaseName)
 {
     LinkIndex newFloatingBaseLinkIndex = this->pimpl->m_robot_model.getLinkIndex(floatingBaseName);
-    return this->pimpl->m_robot_model.computeFullTreeTraversal(this->pimpl->m_traversal,newFloatingBaseLinkIndex);
+    bool ok = this->pimpl->m_robot_model.computeFullTreeTraversal(this->pimpl->m_traversal,newFloatingBaseLinkIndex);
+    this->pimpl->invalidateCache(TRAVERSAL_STATE);
+    return ok;
 }
 
 unsigned int KinDynComputations::getNrOfLinks() const
@@ -743,9 +885,9 @@ bool KinDynComputations::setRobotState(Span<const double> s,
     Transform world_T_base = Transform::Identity();
     Twist base_velocity = Twist::Zero();
 
-    return setRobotState(world_T_base, s,
-                         base_velocity, s_dot,
-                         world_gravity);
+    return setRobotStateImpl(world_T_base, s,
+                             base_velocity, s_dot,
+                             iDynTree::Vector3(world_gravity));
 }
 
 
@@ -775,11 +917,12 @@ bool KinDynComputations::setRobotState(iDynTree::MatrixView<const double> world_
     }
 
 
-    return this->setRobotState(iDynTree::Transform(world_T_base),
-                               s,
-                               iDynTree::SpatialMotionVector(base_velocity),
-                               s_dot,
-                               world_gravity);
+    // Avoid converting the spans to VectorDynSize, as it would allocate memory
+    return this->setRobotStateImpl(iDynTree::Transform(world_T_base),
+                                   s,
+                                   iDynTree::SpatialMotionVector(base_velocity),
+                                   s_dot,
+                                   iDynTree::Vector3(world_gravity));
 }
 
 bool KinDynComputations::setRobotState(const Transform& world_T_base,
@@ -788,6 +931,15 @@ bool KinDynComputations::setRobotState(const Transform& world_T_base,
                                        const VectorDynSize& s_dot,
                                        const Vector3& world_gravity)
 {
+    return this->setRobotStateImpl(world_T_base, s, base_velocity, s_dot, world_gravity);
+}
+
+bool KinDynComputations::setRobotStateImpl(const Transform& world_T_base,
+                                           Span<const double> s,
+                                           const Twist& base_velocity,
+                                           Span<const double> s_dot,
+                                           const Vector3& world_gravity)
+{
 
     bool ok = s.size() == pimpl->m_robot_model.getNrOfPosCoords();
     if( !ok )
@@ -803,7 +955,30 @@ bool KinDynComputations::setRobotState(const Transform& world_T_base,
         return false;
     }
 
-    this->invalidateCache();
+    // Keep track of the components of the state that actually changed,
+    // so that only the cached quantities that depend on them are invalidated
+    unsigned int changedStateComponents = 0;
+
+    if( !(toEigen(this->pimpl->m_pos.worldBasePos().getRotation()) == toEigen(world_T_base.getRotation())) ||
+        !(toEigen(this->pimpl->m_pos.worldBasePos().getPosition()) == toEigen(world_T_base.getPosition())) )
+    {
+        changedStateComponents |= BASE_POSE_STATE;
+    }
+
+    if( !(toEigen(this->pimpl->m_pos.jointPos()) == toEigen(s)) )
+    {
+        changedStateComponents |= JOINT_POS_STATE;
+    }
+
+    if( !(toEigen(this->pimpl->m_vel.jointVel()) == toEigen(s_dot)) )
+    {
+        changedStateComponents |= JOINT_VEL_STATE;
+    }
+
+    if( !(toEigen(this->pimpl->m_gravityAcc) == toEigen(world_gravity)) )
+    {
+        changedStateComponents |= GRAVITY_STATE;
+    }
 
     // Save pos
     this->pimpl->m_pos.worldBasePos() = world_T_base;
@@ -819,22 +994,32 @@ bool KinDynComputations::setRobotState(const Transform& world_T_base,
     this->pimpl->m_baseVelSetViaRobotState = base_velocity;
 
     // Account for the different possible representations
+    Twist baseVelInBodyFixed;
     if (pimpl->m_frameVelRepr == MIXED_REPRESENTATION)
     {
-        pimpl->m_vel.baseVel() = pimpl->m_pos.worldBasePos().getRotation().inverse()*base_velocity;
+        baseVelInBodyFixed = pimpl->m_pos.worldBasePos().getRotation().inverse()*base_velocity;
     }
     else if (pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION)
     {
         // Data is stored in body fixed
-        pimpl->m_vel.baseVel() = base_velocity;
+        baseVelInBodyFixed = base_velocity;
     }
     else
     {
         assert(pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
         // base_X_inertial \ls^inertial v_base
-        pimpl->m_vel.baseVel() = pimpl->m_pos.worldBasePos().inverse()*base_velocity;
+        baseVelInBodyFixed = pimpl->m_pos.worldBasePos().inverse()*base_velocity;
     }
 
+    // The base velocity is compared once converted to body fixed, as this is how it is stored
+    if( !(toEigen(pimpl->m_vel.baseVel()) == toEigen(baseVelInBodyFixed)) )
+    {
+        changedStateComponents |= BASE_VEL_STATE;
+    }
+    pimpl->m_vel.baseVel() = baseVelInBodyFixed;
+
+    this->pimpl->invalidateCache(changedStateComponents);
+
     return true;
 }
 
@@ -959,10 +1144,12 @@ bool KinDynComputations::setJointPos(Span<const double> s)
         return false;
     }
 
-    toEigen(this->pimpl->m_pos.jointPos()) = toEigen(s);
-
-    // Invalidate cache
-    this->invalidateCache();
+    // Invalidate the cached quantities only if the joint positions actually changed
+    if( !(toEigen(this->pimpl->m_pos.jointPos()) == toEigen(s)) )
+    {
+        toEigen(this->pimpl->m_pos.jointPos()) = toEigen(s);
+        this->pimpl->invalidateCache(JOINT_POS_STATE);
+    }
 
     return true;
 }
@@ -1307,7 +1494,7 @@ Transform KinDynComputations::getWorldTransform(const FrameIndex frameIndex)
     // compute fwd kinematics (if necessary)
     this->computeFwdKinematics();
 
-    if( !this->pimpl->m_isFwdKinematicsUpdated )
+    if( !this->pimpl->m_fwdPosKinematics.isUpdated )
     {
         reportError("KinDynComputations","getWorldTransform","error in computing fwd kinematics");
         return iDynTree::Transform::Identity();
@@ -1678,6 +1865,149 @@ bool KinDynComputations::getFrameFreeFloatingJacobian(const FrameIndex frameInde
                                             outJacobian);
 }
 
+void KinDynComputations::KinDynComputationsPrivateAttributes::computeFrameFreeFloatingJacobianUsingWorldMotionSubspaces(const FrameIndex frameIndex,
+                                                                                                                      const Matrix6x6& world_X_jacobBaseFrame,
+                                                                                                                      MatrixView<double> jacobian) const
+{
+    LinkIndex jacobLink = m_robot_model.getFrameLink(frameIndex);
+    const Transform & world_H_link = m_linkPos(jacobLink);
+
+    // The jacobian is expressed in (frame,frame) for BODY_FIXED_REPRESENTATION, (frame,world) for MIXED_REPRESENTATION
+    // and (world,world) for INERTIAL_FIXED_REPRESENTATION (see getFrameFreeFloatingJacobian). The columns computed
+    // in (world,world) are transformed to the jacobian frame directly in Eigen, as
+    // [v; w] -> [v - p \times w; w] for MIXED_REPRESENTATION, and [R^T (v - p \times w); R^T w] for BODY_FIXED_REPRESENTATION,
+    // where p and R are the position and the orientation of the frame with respect to the world.
+    const auto world_R_link = toEigen(world_H_link.getRotation());
+    Eigen::Vector3d world_p_frame = toEigen(world_H_link.getPosition());
+    Eigen::Matrix3d frame_R_world = world_R_link.transpose();
+    if (frameIndex != static_cast<FrameIndex>(jacobLink))
+    {
+        // Additional frame, the link_H_frame transform is not the identity
+        const Transform link_H_frame = m_robot_model.getFrameTransform(frameIndex);
+        world_p_frame += world_R_link*toEigen(link_H_frame.getPosition());
+        frame_R_world = (world_R_link*toEigen(link_H_frame.getRotation())).transpose();
+    }
+    const FrameVelocityRepresentation frameVelRepr = m_frameVelRepr;
+
+    auto jacobianEig = toEigen(jacobian);
+    auto setColumn = [&](const Eigen::Index col, const Eigen::Matrix<double,6,1>& worldMotionVector)
+    {
+        if (frameVelRepr == INERTIAL_FIXED_REPRESENTATION)
+        {
+            jacobianEig.col(col) = worldMotionVector;
+            return;
+        }
+
+        Eigen::Vector3d lin = worldMotionVector.head<3>() - world_p_frame.cross(worldMotionVector.tail<3>());
+        if (frameVelRepr == MIXED_REPRESENTATION)
+        {
+            jacobianEig.col(col).head<3>() = lin;
+            jacobianEig.col(col).tail<3>() = worldMotionVector.tail<3>();
+        }
+        else
+        {
+            assert(frameVelRepr == BODY_FIXED_REPRESENTATION);
+            jacobianEig.col(col).head<3>() = frame_R_world*lin;
+            jacobianEig.col(col).tail<3>() = frame_R_world*worldMotionVector.tail<3>();
+        }
+    };
+
+    const auto world_X_jacobBaseFrame_eig = toEigen(world_X_jacobBaseFrame);
+    for (Eigen::Index i=0; i < 6; i++)
+    {
+        setColumn(i, world_X_jacobBaseFrame_eig.col(i));
+    }
+    jacobianEig.rightCols(m_robot_model.getNrOfDOFs()).setZero();
+
+    // Only the degrees of freedom in the path from the frame link to the base contribute to the jacobian
+    LinkIndex visitedLinkIdx = jacobLink;
+    const LinkIndex baseLinkIdx = m_traversal.getBaseLink()->getIndex();
+    while (visitedLinkIdx != baseLinkIdx)
+    {
+        IJointConstPtr joint = m_traversal.getParentJointFromLinkIndex(visitedLinkIdx);
+        const size_t dofOffset = joint->getDOFsOffset();
+        for (unsigned int i=0; i < joint->getNrOfDOFs(); i++)
+        {
+            setColumn(6+dofOffset+i, m_worldMotionSubspaces.col(dofOffset+i));
+        }
+
+        visitedLinkIdx = m_traversal.getParentLinkFromLinkIndex(visitedLinkIdx)->getIndex();
+    }
+}
+
+bool KinDynComputations::getFramesFreeFloatingJacobians(const std::vector<FrameIndex>& frameIndices,
+                                                        MatrixView<double> outJacobians)
+{
+    const size_t nrOfFrames = frameIndices.size();
+
+    bool ok = (outJacobians.rows() == static_cast<MatrixView<double>::index_type>(6*nrOfFrames))
+        && (outJacobians.cols() == pimpl->m_robot_model.getNrOfDOFs() + 6);
+
+    if( !ok )
+    {
+        reportError("KinDynComputations",
+                    "getFramesFreeFloatingJacobians",
+                    "Wrong size in input outJacobians");
+        return false;
+    }
+
+    // The frames are checked in advance, as the jacobians may be computed in the worker threads
+    for (FrameIndex frameIndex : frameIndices)
+    {
+        if (!pimpl->m_robot_model.isValidFrameIndex(frameIndex))
+        {
+            reportError("KinDynComputations","getFramesFreeFloatingJacobians","Frame index out of bounds");
+            return false;
+        }
+    }
+
+    // compute fwd kinematics (if necessary)
+    this->computeFwdKinematics();
+
+    // compute the motion subspaces in the inertial frame (if necessary), that are shared by all the frames
+    if (!pimpl->m_worldMotionSubspacesCache.isUpdated)
+    {
+        for (unsigned int traversalEl = 1; traversalEl < pimpl->m_traversal.getNrOfVisitedLinks(); traversalEl++)
+        {
+            LinkIndex visitedLinkIdx = pimpl->m_traversal.getLink(traversalEl)->getIndex();
+            LinkIndex parentLinkIdx = pimpl->m_traversal.getParentLink(traversalEl)->getIndex();
+            IJointConstPtr joint = pimpl->m_traversal.getParentJoint(traversalEl);
+            for (unsigned int i=0; i < joint->getNrOfDOFs(); i++)
+            {
+                pimpl->m_worldMotionSubspaces.col(joint->getDOFsOffset()+i) =
+                    toEigen(pimpl->m_linkPos(visitedLinkIdx)*joint->getMotionSubspaceVector(i,visitedLinkIdx,parentLinkIdx));
+            }
+        }
+        pimpl->m_worldMotionSubspacesCache.setUpdated(true);
+    }
+
+    // See getFrameFreeFloatingJacobian for the frame in which the base velocity is expressed
+    const Transform & world_H_base = pimpl->m_linkPos(pimpl->m_traversal.getBaseLink()->getIndex());
+    Transform world_X_jacobBaseFrame;
+    if (pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION)
+    {
+        world_X_jacobBaseFrame = world_H_base;
+    }
+    else if (pimpl->m_frameVelRepr == MIXED_REPRESENTATION)
+    {
+        world_X_jacobBaseFrame = Transform(Rotation::Identity(), world_H_base.getPosition());
+    }
+    else
+    {
+        assert(pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
+        world_X_jacobBaseFrame = Transform::Identity();
+    }
+
+    const Matrix6x6 world_X_jacobBaseFrame_adj = world_X_jacobBaseFrame.asAdjointTransform();
+    auto computeFrameJacobian = [&](size_t i)
+    {
+        pimpl->computeFrameFreeFloatingJacobianUsingWorldMotionSubspaces(frameIndices[i], world_X_jacobBaseFrame_adj,
+                                                                          outJacobians.block(6*i, 0, 6, outJacobians.cols()));
+    };
+    pimpl->m_workerPool.run(nrOfFrames, computeFrameJacobian);
+
+    return true;
+}
 
 bool KinDynComputations::getRelativeJacobian(const iDynTree::FrameIndex refFrameIndex,
                                              const iDynTree::FrameIndex frameIndex,
@@ -1998,7 +2328,7 @@ bool KinDynComputations::getCenterOfMassJacobian(MatrixView<double> comJacobian)
     Matrix6x6 invLockedInertia = lockedInertia.getInverse();
 
     // The first six rows of the mass matrix are the base-base average velocity jacobian
-    toEigen(pimpl->m_jacBuffer) = toEigen(invLockedInertia)*toEigen(pimpl->m_rawMassMatrix).block(0,0,6,6+pimpl->m_robot_model.getNrOfDOFs());
+    toEigen(pimpl->m_jacBuffer).noalias() = toEigen(invLockedInertia)*toEigen(pimpl->m_rawMassMatrix).block(0,0,6,6+pimpl->m_robot_model.getNrOfDOFs());
 
     // Process right side of the jacobian
     pimpl->processOnRightSideMatrixExpectingBodyFixedModelVelocity(pimpl->m_jacBuffer);
@@ -2071,6 +2401,22 @@ const SpatialInertia& KinDynComputations::KinDynComputationsPrivateAttributes::g
     return m_linkCRBIs(m_traversal.getBaseLink()->getIndex());
 }
 
+/**
+ * Compute jac = transform*jac for a 6 x n matrix jac, one column at a time
+ * using a fixed size temporary, to avoid allocating memory.
+ */
+static void multiplyOnLeftSideInPlace(const Matrix6x6 & transform, MatrixView<double> jac)
+{
+    assert(jac.rows() == 6);
+
+    Eigen::Matrix<double, 6, 1> col;
+    for (int j=0; j < jac.cols(); j++)
+    {
+        col.noalias() = toEigen(transform)*toEigen(jac).block<6,1>(0,j);
+        toEigen(jac).block<6,1>(0,j) = col;
+    }
+}
+
 void KinDynComputations::KinDynComputationsPrivateAttributes::processOnRightSideMatrixExpectingBodyFixedModelVelocity(
     MatrixView<double> mat)
 {
@@ -2097,8 +2443,14 @@ void KinDynComputations::KinDynComputationsPrivateAttributes::processOnRightSide
 
     // The first six columns of the matrix needs to be modified to account for a different representation
     // for the base velocity. This can be written as as a modification of the rows \times 6 left submatrix.
+    // The product is computed one row at a time using a fixed size temporary, to avoid allocating memory
     int rows = mat.rows();
-    toEigen(mat).block(0,0,rows,6) = toEigen(mat).block(0,0,rows,6)*toEigen(baseFrame_X_newJacobBaseFrame_);
+    Eigen::Matrix<double, 1, 6> row;
+    for (int i=0; i < rows; i++)
+    {
+        row.noalias() = toEigen(mat).block<1,6>(i,0)*toEigen(baseFrame_X_newJacobBaseFrame_);
+        toEigen(mat).block<1,6>(i,0) = row;
+    }
 }
 
 void KinDynComputations::KinDynComputationsPrivateAttributes::processOnLeftSideBodyFixedAvgVelocityJacobian(
@@ -2124,7 +2476,7 @@ void KinDynComputations::KinDynComputationsPrivateAttributes::processOnLeftSideB
 
     Matrix6x6 newOutputFrame_X_oldOutputFrame_ = newOutputFrame_X_oldOutputFrame.asAdjointTransform();
 
-    toEigen(jac) = toEigen(newOutputFrame_X_oldOutputFrame_)*toEigen(jac);
+    multiplyOnLeftSideInPlace(newOutputFrame_X_oldOutputFrame_, jac);
 }
 
 void KinDynComputations::KinDynComputationsPrivateAttributes::processOnLeftSideBodyFixedBaseMomentumJacobian(MatrixView<double> jac)
@@ -2147,8 +2499,7 @@ void KinDynComputations::KinDynComputationsPrivateAttributes::processOnLeftSideB
 
     Matrix6x6 newOutputFrame_X_oldOutputFrame_ = newOutputFrame_X_oldOutputFrame.asAdjointTransformWrench();
 
-    int cols = jac.cols();
-    toEigen(jac).block(0,0,6,cols) = toEigen(newOutputFrame_X_oldOutputFrame_)*toEigen(jac).block(0,0,6,cols);
+    multiplyOnLeftSideInPlace(newOutputFrame_X_oldOutputFrame_, jac);
 }
 
 
@@ -2218,7 +2569,7 @@ bool KinDynComputations::getAverageVelocityJacobian(MatrixView<double> avgVeloci
     Matrix6x6 invLockedInertia = lockedInertia.getInverse();
 
     // The first six rows of the mass matrix are the base-base average velocity jacobian
-    toEigen(avgVelocityJacobian) = toEigen(invLockedInertia)*toEigen(pimpl->m_rawMassMatrix).block(0,0,6,6+pimpl->m_robot_model.getNrOfDOFs());
+    toEigen(avgVelocityJacobian).noalias() = toEigen(invLockedInertia)*toEigen(pimpl->m_rawMassMatrix).block(0,0,6,6+pimpl->m_robot_model.getNrOfDOFs());
 
     // Handle the different representations
     pimpl->processOnRightSideMatrixExpectingBodyFixedModelVelocity(avgVelocityJacobian);
@@ -2278,7 +2629,7 @@ void KinDynComputations::KinDynComputationsPrivateAttributes::processOnLeftSideB
 
     Matrix6x6 newOutputFrame_X_oldOutputFrame_ = newOutputFrame_X_oldOutputFrame.asAdjointTransform();
 
-    toEigen(jac) = toEigen(newOutputFrame_X_oldOutputFrame_)*toEigen(jac);
+    multiplyOnLeftSideInPlace(newOutputFrame_X_oldOutputFrame_, jac);
 }
 
 Twist KinDynComputations::getCentroidalAverageVelocity()
@@ -2384,7 +2735,7 @@ bool KinDynComputations::getCentroidalAverageVelocityJacobian(MatrixView<double>
     const SpatialInertia & lockedInertia = pimpl->getRobotLockedInertia();
     Matrix6x6 invLockedInertia = lockedInertia.getInverse();
     // The first six rows of the mass matrix are the base-base average velocity jacobian
-    toEigen(centroidalAvgVelocityJacobian) = toEigen(invLockedInertia)*toEigen(pimpl->m_rawMassMatrix).block(0,0,6,6+pimpl->m_robot_model.getNrOfDOFs());
+    toEigen(centroidalAvgVelocityJacobian).noalias() = toEigen(invLockedInertia)*toEigen(pimpl->m_rawMassMatrix).block(0,0,6,6+pimpl->m_robot_model.getNrOfDOFs());
 
     // Handle the different representations
     pimpl->processOnRightSideMatrixExpectingBodyFixedModelVelocity(centroidalAvgVelocityJacobian);
@@ -0,0 +1,1054 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/KinDynComputationsBatch.h>
+
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/EigenSpatialKernels.h>
+#include <iDynTree/SpatialInertia.h>
+#include <iDynTree/Transform.h>
+#include <iDynTree/Utils.h>
+
+#include <iDynTree/Model.h>
+#include <iDynTree/Traversal.h>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <cassert>
+#include <vector>
+
+namespace iDynTree
+{
+
+namespace
+{
+    typedef Eigen::Matrix<double,6,1> Vector6d;
+    typedef Eigen::Matrix<double,6,6> Matrix6d;
+    typedef Eigen::Matrix<double,10,1> Vector10d;
+    typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> MatrixXdRowMajor;
+
+    /**
+     * Compute the relative transform exp(S^ q) of a joint with a constant motion subspace S,
+     * that is the displacement of the child link with respect to its rest position,
+     * expressed in the child frame. The spatial vectors are serialized linear first,
+     * as in the rest of iDynTree.
+     */
+    inline void jointDisplacement(const Vector6d & S, const double q,
+                                  Eigen::Matrix3d & R, Eigen::Vector3d & p)
+    {
+        const double omegaNorm = S.tail<3>().norm();
+
+        if (omegaNorm == 0.0)
+        {
+            // Prismatic joint
+            R.setIdentity();
+            p = S.head<3>()*q;
+            return;
+        }
+
+        // Revolute (or helical) joint
+        const Eigen::Vector3d w = S.tail<3>()/omegaNorm;
+        const Eigen::Vector3d v = S.head<3>()/omegaNorm;
+        const double theta = omegaNorm*q;
+        R = Eigen::AngleAxisd(theta, w).toRotationMatrix();
+        p = (Eigen::Matrix3d::Identity() - R)*w.cross(v) + w*(w.dot(v))*theta;
+    }
+
+    /**
+     * Given parent_H_child = (R,p), transform the twist of the parent in the child frame.
+     */
+    inline Vector6d childTwistFromParent(const Eigen::Matrix3d & R, const Eigen::Vector3d & p,
+                                         const Vector6d & parentTwist)
+    {
+        Vector6d ret;
+        ret.head<3>() = R.transpose()*(parentTwist.head<3>() + parentTwist.tail<3>().cross(p));
+        ret.tail<3>() = R.transpose()*parentTwist.tail<3>();
+        return ret;
+    }
+
+    /**
+     * Given parent_H_child = (R,p), transform the wrench of the child in the parent frame.
+     */
+    inline Vector6d parentWrenchFromChild(const Eigen::Matrix3d & R, const Eigen::Vector3d & p,
+                                          const Vector6d & childWrench)
+    {
+        Vector6d ret;
+        ret.head<3>() = R*childWrench.head<3>();
+        ret.tail<3>() = R*childWrench.tail<3>() + p.cross(ret.head<3>());
+        return ret;
+    }
+
+    /**
+     * Given a_H_b = (R,p), compute the 6x6 adjoint matrix that transforms twists from b to a.
+     */
+    inline Matrix6d adjointMatrix(const Eigen::Matrix3d & R, const Eigen::Vector3d & p)
+    {
+        Matrix6d ret;
+        ret.topLeftCorner<3,3>() = R;
+        ret.topRightCorner<3,3>() = skew(p)*R;
+        ret.bottomLeftCorner<3,3>().setZero();
+        ret.bottomRightCorner<3,3>() = R;
+        return ret;
+    }
+
+    /**
+     * Product of the spatial inertia with inertial parameters params (ordered as in SpatialInertia::asVector)
+     * and of the twist v, i.e. [m v - h x w; h x v + I w], where h is the first moment of mass.
+     */
+    template<typename Derived>
+    inline Vector6d inertiaTimesTwist(const Eigen::MatrixBase<Derived> & params, const Vector6d & v)
+    {
+        const Eigen::Vector3d h = params.template segment<3>(1);
+        Vector6d ret;
+        ret.head<3>() = params(0)*v.head<3>() - h.cross(v.tail<3>());
+        ret.tail<3>() = h.cross(v.head<3>());
+        ret(3) += params(4)*v(3) + params(5)*v(4) + params(6)*v(5);
+        ret(4) += params(5)*v(3) + params(7)*v(4) + params(8)*v(5);
+        ret(5) += params(6)*v(3) + params(8)*v(4) + params(9)*v(5);
+        return ret;
+    }
+
+    /**
+     * 6x6 spatial inertia matrix with inertial parameters params (ordered as in SpatialInertia::asVector).
+     */
+    template<typename Derived>
+    inline Matrix6d inertiaMatrix(const Eigen::MatrixBase<Derived> & params)
+    {
+        const Eigen::Vector3d h = params.template segment<3>(1);
+        Matrix6d ret;
+        ret.topLeftCorner<3,3>() = params(0)*Eigen::Matrix3d::Identity();
+        ret.bottomLeftCorner<3,3>() = skew(h);
+        ret.topRightCorner<3,3>() = -skew(h);
+        ret.bottomRightCorner<3,3>() << params(4), params(5), params(6),
+                                        params(5), params(7), params(8),
+                                        params(6), params(8), params(9);
+        return ret;
+    }
+
+    /**
+     * Spatial motion cross product v \times m.
+     */
+    inline Vector6d motionCross(const Vector6d & v, const Vector6d & m)
+    {
+        Vector6d ret;
+        ret.head<3>() = v.tail<3>().cross(m.head<3>()) + v.head<3>().cross(m.tail<3>());
+        ret.tail<3>() = v.tail<3>().cross(m.tail<3>());
+        return ret;
+    }
+
+    /**
+     * Spatial force cross product v \times^* f.
+     */
+    inline Vector6d forceCross(const Vector6d & v, const Vector6d & f)
+    {
+        Vector6d ret;
+        ret.head<3>() = v.tail<3>().cross(f.head<3>());
+        ret.tail<3>() = v.head<3>().cross(f.head<3>()) + v.tail<3>().cross(f.tail<3>());
+        return ret;
+    }
+}
+
+struct KinDynComputationsBatch::KinDynComputationsBatchPrivateAttributes
+{
+    // True if the the model is valid, false otherwise.
+    bool m_isModelValid;
+
+    // Frame velocity representation used by the class
+    FrameVelocityRepresentation m_frameVelRepr;
+
+    // Model used for the computations
+    iDynTree::Model m_robot_model;
+
+    // Traversal used for the computations, defines the floating base
+    iDynTree::Traversal m_traversal;
+
+    // Model topology, serialized in traversal order once at load time
+    // (or when the floating base is changed) so that the inner loops on the
+    // states do not need to access the Model and the Traversal data structures.
+
+    // Traversal index of the parent of each traversal element (-1 for the base)
+    std::vector<int> m_parent;
+
+    // Link index of each traversal element
+    std::vector<LinkIndex> m_linkIndex;
+
+    // Traversal index of each link
+    std::vector<int> m_traversalIndexOfLink;
+
+    // Offset of the dof of the joint connecting each traversal element
+    // to its parent (-1 for fixed joints and for the base)
+    std::vector<int> m_dofOffset;
+
+    // Offset of the position coordinate of the joint connecting each traversal element
+    // to its parent (-1 for fixed joints and for the base)
+    std::vector<int> m_posCoordOffset;
+
+    // Motion subspace vector (expressed in the child frame) of each joint
+    std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > m_S;
+
+    // parent_H_child transform at rest of each joint
+    std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> > m_restRotation;
+    std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d> > m_restPosition;
+
+    // 6D inertia matrix of each traversal element
+    std::vector<Matrix6d, Eigen::aligned_allocator<Matrix6d> > m_inertia;
+
+    // Inertial parameters of each traversal element, ordered as in SpatialInertia::asVector
+    std::vector<Vector10d, Eigen::aligned_allocator<Vector10d> > m_inertialParams;
+
+    // Number of states
+    size_t m_nrOfStates;
+
+    // Inputs: the column k is related to the state k
+    MatrixXdRowMajor m_jointPos;
+    MatrixXdRowMajor m_jointVel;
+    Eigen::Matrix<double,9,Eigen::Dynamic> m_world_R_base;
+    Eigen::Matrix<double,3,Eigen::Dynamic> m_world_p_base;
+    // Base velocity, always stored with the BODY_FIXED representation
+    Eigen::Matrix<double,6,Eigen::Dynamic> m_baseVel;
+    Eigen::Vector3d m_gravityAcc;
+
+    // Per-link buffers (structure of arrays): the quantity of the link with
+    // traversal index t for the state k is stored in the column t*N+k
+
+    // parent_H_link transforms
+    Eigen::Matrix<double,9,Eigen::Dynamic> m_parent_R_link;
+    Eigen::Matrix<double,3,Eigen::Dynamic> m_parent_p_link;
+
+    // world_H_link transforms
+    Eigen::Matrix<double,9,Eigen::Dynamic> m_world_R_link;
+    Eigen::Matrix<double,3,Eigen::Dynamic> m_world_p_link;
+
+    // Link velocities, in BODY_FIXED representation
+    Eigen::Matrix<double,6,Eigen::Dynamic> m_linkVel;
+
+    // Link proper accelerations and link wrenches, used in the bias forces computations
+    Eigen::Matrix<double,6,Eigen::Dynamic> m_linkAcc;
+    Eigen::Matrix<double,6,Eigen::Dynamic> m_linkWrench;
+
+    // Inertial parameters of the composite rigid bodies
+    Eigen::Matrix<double,10,Eigen::Dynamic> m_linkCRBI;
+
+    // Mass matrices, with BODY_FIXED base velocity: the columns
+    // from k*(n+6) to (k+1)*(n+6) contain the mass matrix of the state k
+    Eigen::MatrixXd m_rawMassMatrices;
+
+    // Cache flags
+    bool m_isFwdKinematicsUpdated;
+    bool m_isRawMassMatrixUpdated;
+
+    KinDynComputationsBatchPrivateAttributes()
+    {
+        m_isModelValid = false;
+        m_frameVelRepr = MIXED_REPRESENTATION;
+        m_nrOfStates = 0;
+        m_gravityAcc.setZero();
+        m_isFwdKinematicsUpdated = false;
+        m_isRawMassMatrixUpdated = false;
+    }
+
+    size_t col(const int traversalIndex, const size_t state) const
+    {
+        return static_cast<size_t>(traversalIndex)*m_nrOfStates + state;
+    }
+
+    void invalidateCache()
+    {
+        m_isFwdKinematicsUpdated = false;
+        m_isRawMassMatrixUpdated = false;
+    }
+
+    bool serializeTopology();
+    void resizeStateBuffers(const size_t nrOfStates);
+
+    // Check the sizes of the joint states and of the gravity passed to setRobotStates
+    bool checkJointStatesAndGravity(MatrixView<const double> s,
+                                    MatrixView<const double> s_dot,
+                                    Span<const double> world_gravity) const;
+
+    // Resize the state buffers, invalidate the cache and copy the joint states and the gravity
+    void setJointStatesAndGravity(MatrixView<const double> s,
+                                  MatrixView<const double> s_dot,
+                                  Span<const double> world_gravity);
+
+    // Compute the transform (R,p) world_H_base*baseFrame_X_jacobBaseFrame used to
+    // convert the base part of the quantities to the used representation
+    void getBaseToUsedRepresentation(const size_t state, Eigen::Matrix3d & R, Eigen::Vector3d & p) const;
+};
+
+bool KinDynComputationsBatch::KinDynComputationsBatchPrivateAttributes::serializeTopology()
+{
+    const unsigned int nrOfLinks = m_traversal.getNrOfVisitedLinks();
+
+    m_parent.resize(nrOfLinks);
+    m_linkIndex.resize(nrOfLinks);
+    m_traversalIndexOfLink.assign(m_robot_model.getNrOfLinks(), -1);
+    m_dofOffset.resize(nrOfLinks);
+    m_posCoordOffset.resize(nrOfLinks);
+    m_S.resize(nrOfLinks);
+    m_restRotation.resize(nrOfLinks);
+    m_restPosition.resize(nrOfLinks);
+    m_inertia.resize(nrOfLinks);
+    m_inertialParams.resize(nrOfLinks);
+
+    for (unsigned int t=0; t < nrOfLinks; t++)
+    {
+        LinkConstPtr visitedLink = m_traversal.getLink(t);
+        LinkConstPtr parentLink = m_traversal.getParentLink(t);
+        IJointConstPtr toParentJoint = m_traversal.getParentJoint(t);
+
+        LinkIndex visitedLinkIndex = visitedLink->getIndex();
+        m_linkIndex[t] = visitedLinkIndex;
+        m_traversalIndexOfLink[visitedLinkIndex] = t;
+        m_inertia[t] = toEigen(visitedLink->getInertia().asMatrix());
+        m_inertialParams[t] = toEigen(visitedLink->getInertia().asVector());
+        m_dofOffset[t] = -1;
+        m_posCoordOffset[t] = -1;
+        m_S[t].setZero();
+        m_restRotation[t].setIdentity();
+        m_restPosition[t].setZero();
+
+        if (!parentLink)
+        {
+            m_parent[t] = -1;
+            continue;
+        }
+
+        LinkIndex parentLinkIndex = parentLink->getIndex();
+        m_parent[t] = m_traversal.getTraversalIndexFromLinkIndex(parentLinkIndex);
+
+        Transform parent_H_child = toParentJoint->getRestTransform(parentLinkIndex, visitedLinkIndex);
+        m_restRotation[t] = toEigen(parent_H_child.getRotation());
+        m_restPosition[t] = toEigen(parent_H_child.getPosition());
+
+        if (toParentJoint->getNrOfDOFs() > 1 ||
+            toParentJoint->getNrOfDOFs() != toParentJoint->getNrOfPosCoords())
+        {
+            reportError("KinDynComputationsBatch", "loadRobotModel",
+                        "Only joints with 0 or 1 degrees of freedom are supported.");
+            return false;
+        }
+
+        if (toParentJoint->getNrOfDOFs() == 1)
+        {
+            m_dofOffset[t] = static_cast<int>(toParentJoint->getDOFsOffset());
+            m_posCoordOffset[t] = static_cast<int>(toParentJoint->getPosCoordsOffset());
+            m_S[t] = toEigen(toParentJoint->getMotionSubspaceVector(0, visitedLinkIndex, parentLinkIndex));
+        }
+    }
+
+    return true;
+}
+
+void KinDynComputationsBatch::KinDynComputationsBatchPrivateAttributes::resizeStateBuffers(const size_t nrOfStates)
+{
+    if (nrOfStates == m_nrOfStates && m_linkVel.cols() == static_cast<Eigen::Index>(m_parent.size()*nrOfStates))
+    {
+        return;
+    }
+
+    m_nrOfStates = nrOfStates;
+
+    const Eigen::Index nrOfLinks = static_cast<Eigen::Index>(m_parent.size());
+    const Eigen::Index N = static_cast<Eigen::Index>(nrOfStates);
+    const Eigen::Index nrOfDOFs = static_cast<Eigen::Index>(m_robot_model.getNrOfDOFs());
+
+    m_jointPos.resize(m_robot_model.getNrOfPosCoords(), N);
+    m_jointVel.resize(nrOfDOFs, N);
+    m_world_R_base.resize(9, N);
+    m_world_p_base.resize(3, N);
+    m_baseVel.resize(6, N);
+
+    m_parent_R_link.resize(9, nrOfLinks*N);
+    m_parent_p_link.resize(3, nrOfLinks*N);
+    m_world_R_link.resize(9, nrOfLinks*N);
+    m_world_p_link.resize(3, nrOfLinks*N);
+    m_linkVel.resize(6, nrOfLinks*N);
+    m_linkAcc.resize(6, nrOfLinks*N);
+    m_linkWrench.resize(6, nrOfLinks*N);
+    m_linkCRBI.resize(10, nrOfLinks*N);
+    m_rawMassMatrices.setZero(nrOfDOFs+6, (nrOfDOFs+6)*N);
+}
+
+void KinDynComputationsBatch::KinDynComputationsBatchPrivateAttributes::getBaseToUsedRepresentation(const size_t k,
+                                                                                                     Eigen::Matrix3d & R,
+                                                                                                     Eigen::Vector3d & p) const
+{
+    if (m_frameVelRepr == BODY_FIXED_REPRESENTATION)
+    {
+        R = Eigen::Map<const Eigen::Matrix3d>(m_world_R_base.col(k).data());
+        p = m_world_p_base.col(k);
+    }
+    else if (m_frameVelRepr == MIXED_REPRESENTATION)
+    {
+        R.setIdentity();
+        p = m_world_p_base.col(k);
+    }
+    else
+    {
+        assert(m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
+        R.setIdentity();
+        p.setZero();
+    }
+}
+
+KinDynComputationsBatch::KinDynComputationsBatch():
+pimpl(new KinDynComputationsBatchPrivateAttributes)
+{
+}
+
+KinDynComputationsBatch::~KinDynComputationsBatch()
+{
+    delete this->pimpl;
+}
+
+bool KinDynComputationsBatch::loadRobotModel(const Model& model)
+{
+    pimpl->m_robot_model = model;
+    pimpl->m_robot_model.computeFullTreeTraversal(pimpl->m_traversal);
+    pimpl->m_isModelValid = pimpl->serializeTopology();
+    pimpl->m_nrOfStates = 0;
+    pimpl->resizeStateBuffers(0);
+    pimpl->invalidateCache();
+    return pimpl->m_isModelValid;
+}
+
+bool KinDynComputationsBatch::isValid() const
+{
+    return pimpl->m_isModelValid;
+}
+
+const Model& KinDynComputationsBatch::model() const
+{
+    return pimpl->m_robot_model;
+}
+
+bool KinDynComputationsBatch::setFrameVelocityRepresentation(const FrameVelocityRepresentation frameVelRepr)
+{
+    if( frameVelRepr != INERTIAL_FIXED_REPRESENTATION &&
+        frameVelRepr != BODY_FIXED_REPRESENTATION &&
+        frameVelRepr != MIXED_REPRESENTATION )
+    {
+        reportError("KinDynComputationsBatch","setFrameVelocityRepresentation","unknown frame velocity representation");
+        return false;
+    }
+
+    // The internal buffers are always stored in BODY_FIXED and converted on the fly,
+    // so there is no need to invalidate the cache
+    pimpl->m_frameVelRepr = frameVelRepr;
+    return true;
+}
+
+FrameVelocityRepresentation KinDynComputationsBatch::getFrameVelocityRepresentation() const
+{
+    return pimpl->m_frameVelRepr;
+}
+
+bool KinDynComputationsBatch::setFloatingBase(const std::string& floatingBaseName)
+{
+    LinkIndex newFloatingBaseLinkIndex = pimpl->m_robot_model.getLinkIndex(floatingBaseName);
+    if (newFloatingBaseLinkIndex == LINK_INVALID_INDEX)
+    {
+        reportError("KinDynComputationsBatch","setFloatingBase","link not found in the model");
+        return false;
+    }
+
+    bool ok = pimpl->m_robot_model.computeFullTreeTraversal(pimpl->m_traversal,newFloatingBaseLinkIndex);
+    ok = ok && pimpl->serializeTopology();
+    pimpl->invalidateCache();
+    return ok;
+}
+
+bool KinDynComputationsBatch::KinDynComputationsBatchPrivateAttributes::checkJointStatesAndGravity(MatrixView<const double> s,
+                                                                                                  MatrixView<const double> s_dot,
+                                                                                                  Span<const double> world_gravity) const
+{
+    if (s.cols() != m_robot_model.getNrOfPosCoords())
+    {
+        reportError("KinDynComputationsBatch","setRobotStates","Wrong size in input joint positions");
+        return false;
+    }
+
+    if (s_dot.rows() != s.rows() || s_dot.cols() != m_robot_model.getNrOfDOFs())
+    {
+        reportError("KinDynComputationsBatch","setRobotStates","Wrong size in input joint velocities");
+        return false;
+    }
+
+    constexpr int expected_gravity_size = 3;
+    if (world_gravity.size() != expected_gravity_size)
+    {
+        reportError("KinDynComputationsBatch","setRobotStates","Wrong size in input world_gravity");
+        return false;
+    }
+
+    return true;
+}
+
+void KinDynComputationsBatch::KinDynComputationsBatchPrivateAttributes::setJointStatesAndGravity(MatrixView<const double> s,
+                                                                                                MatrixView<const double> s_dot,
+                                                                                                Span<const double> world_gravity)
+{
+    resizeStateBuffers(s.rows());
+    invalidateCache();
+
+    m_jointPos = toEigen(s).transpose();
+    m_jointVel = toEigen(s_dot).transpose();
+    m_gravityAcc = toEigen(world_gravity);
+}
+
+std::string KinDynComputationsBatch::getFloatingBase() const
+{
+    return pimpl->m_robot_model.getLinkName(pimpl->m_traversal.getBaseLink()->getIndex());
+}
+
+unsigned int KinDynComputationsBatch::getNrOfDegreesOfFreedom() const
+{
+    return static_cast<unsigned int>(pimpl->m_robot_model.getNrOfDOFs());
+}
+
+size_t KinDynComputationsBatch::getNrOfStates() const
+{
+    return pimpl->m_nrOfStates;
+}
+
+bool KinDynComputationsBatch::setRobotStates(MatrixView<const double> world_T_bases,
+                                             MatrixView<const double> s,
+                                             MatrixView<const double> base_velocities,
+                                             MatrixView<const double> s_dot,
+                                             Span<const double> world_gravity)
+{
+    if (!pimpl->m_isModelValid)
+    {
+        reportError("KinDynComputationsBatch","setRobotStates","Model not correctly loaded");
+        return false;
+    }
+
+    if (!pimpl->checkJointStatesAndGravity(s, s_dot, world_gravity))
+    {
+        return false;
+    }
+
+    const size_t N = s.rows();
+
+    if (world_T_bases.rows() != 4*N || world_T_bases.cols() != 4)
+    {
+        reportError("KinDynComputationsBatch","setRobotStates","Wrong size in input world_T_bases");
+        return false;
+    }
+
+    if (base_velocities.rows() != N || base_velocities.cols() != 6)
+    {
+        reportError("KinDynComputationsBatch","setRobotStates","Wrong size in input base_velocities");
+        return false;
+    }
+
+    pimpl->setJointStatesAndGravity(s, s_dot, world_gravity);
+
+    const auto world_T_bases_eig = toEigen(world_T_bases);
+    const auto base_velocities_eig = toEigen(base_velocities);
+
+    for (size_t k=0; k < N; k++)
+    {
+        Eigen::Map<Eigen::Matrix3d> world_R_base(pimpl->m_world_R_base.col(k).data());
+        world_R_base = world_T_bases_eig.block<3,3>(4*k,0);
+        pimpl->m_world_p_base.col(k) = world_T_bases_eig.block<3,1>(4*k,3);
+        const Eigen::Vector3d world_p_base = pimpl->m_world_p_base.col(k);
+
+        // Store the base velocity in BODY_FIXED representation
+        const Vector6d baseVel = base_velocities_eig.row(k).transpose();
+        if (pimpl->m_frameVelRepr == MIXED_REPRESENTATION)
+        {
+            pimpl->m_baseVel.col(k).head<3>() = world_R_base.transpose()*baseVel.head<3>();
+            pimpl->m_baseVel.col(k).tail<3>() = world_R_base.transpose()*baseVel.tail<3>();
+        }
+        else if (pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION)
+        {
+            pimpl->m_baseVel.col(k) = baseVel;
+        }
+        else
+        {
+            assert(pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
+            pimpl->m_baseVel.col(k) = childTwistFromParent(world_R_base, world_p_base, baseVel);
+        }
+    }
+
+    return true;
+}
+
+bool KinDynComputationsBatch::setRobotStates(MatrixView<const double> s,
+                                             MatrixView<const double> s_dot,
+                                             Span<const double> world_gravity)
+{
+    if (!pimpl->m_isModelValid)
+    {
+        reportError("KinDynComputationsBatch","setRobotStates","Model not correctly loaded");
+        return false;
+    }
+
+    if (!pimpl->checkJointStatesAndGravity(s, s_dot, world_gravity))
+    {
+        return false;
+    }
+
+    pimpl->setJointStatesAndGravity(s, s_dot, world_gravity);
+
+    // The base pose and velocity are written directly in the state buffers, to avoid
+    // allocating the world_T_bases and base_velocities inputs at each call
+    for (size_t k=0; k < pimpl->m_nrOfStates; k++)
+    {
+        Eigen::Map<Eigen::Matrix3d>(pimpl->m_world_R_base.col(k).data()).setIdentity();
+    }
+    pimpl->m_world_p_base.setZero();
+    // A zero velocity is zero in any representation
+    pimpl->m_baseVel.setZero();
+
+    return true;
+}
+
+void KinDynComputationsBatch::computeFwdKinematics()
+{
+    if (pimpl->m_isFwdKinematicsUpdated)
+    {
+        return;
+    }
+
+    const size_t N = pimpl->m_nrOfStates;
+
+    for (size_t t=0; t < pimpl->m_parent.size(); t++)
+    {
+        const int parent = pimpl->m_parent[t];
+
+        if (parent < 0)
+        {
+            for (size_t k=0; k < N; k++)
+            {
+                const size_t c = pimpl->col(t,k);
+                pimpl->m_parent_R_link.col(c) = pimpl->m_world_R_base.col(k);
+                pimpl->m_parent_p_link.col(c) = pimpl->m_world_p_base.col(k);
+                pimpl->m_world_R_link.col(c) = pimpl->m_world_R_base.col(k);
+                pimpl->m_world_p_link.col(c) = pimpl->m_world_p_base.col(k);
+                pimpl->m_linkVel.col(c) = pimpl->m_baseVel.col(k);
+            }
+            continue;
+        }
+
+        // Per-link quantities, loaded once for all the states
+        const Eigen::Matrix3d restR = pimpl->m_restRotation[t];
+        const Eigen::Vector3d restP = pimpl->m_restPosition[t];
+        const Vector6d S = pimpl->m_S[t];
+        const int dofOffset = pimpl->m_dofOffset[t];
+        const int posCoordOffset = pimpl->m_posCoordOffset[t];
+
+        Eigen::Matrix3d jointR;
+        Eigen::Vector3d jointP;
+
+        for (size_t k=0; k < N; k++)
+        {
+            const size_t c = pimpl->col(t,k);
+            const size_t pc = pimpl->col(parent,k);
+
+            Eigen::Map<Eigen::Matrix3d> parent_R_link(pimpl->m_parent_R_link.col(c).data());
+            Eigen::Map<Eigen::Vector3d> parent_p_link(pimpl->m_parent_p_link.col(c).data());
+
+            // parent_H_link = parent_H_link_at_rest * exp(S^ q)
+            if (dofOffset >= 0)
+            {
+                jointDisplacement(S, pimpl->m_jointPos(posCoordOffset,k), jointR, jointP);
+                parent_R_link = restR*jointR;
+                parent_p_link = restR*jointP + restP;
+            }
+            else
+            {
+                parent_R_link = restR;
+                parent_p_link = restP;
+            }
+
+            // world_H_link = world_H_parent * parent_H_link
+            Eigen::Map<const Eigen::Matrix3d> world_R_parent(pimpl->m_world_R_link.col(pc).data());
+            Eigen::Map<Eigen::Matrix3d> world_R_link(pimpl->m_world_R_link.col(c).data());
+            world_R_link = world_R_parent*parent_R_link;
+            pimpl->m_world_p_link.col(c) = world_R_parent*parent_p_link + pimpl->m_world_p_link.col(pc);
+
+            // v_link = link_X_parent v_parent + S dq
+            Vector6d linkVel = childTwistFromParent(parent_R_link, parent_p_link, pimpl->m_linkVel.col(pc));
+            if (dofOffset >= 0)
+            {
+                linkVel += S*pimpl->m_jointVel(dofOffset,k);
+            }
+            pimpl->m_linkVel.col(c) = linkVel;
+        }
+    }
+
+    pimpl->m_isFwdKinematicsUpdated = true;
+}
+
+void KinDynComputationsBatch::computeRawMassMatrices()
+{
+    if (pimpl->m_isRawMassMatrixUpdated)
+    {
+        return;
+    }
+
+    this->computeFwdKinematics();
+
+    const size_t N = pimpl->m_nrOfStates;
+    const int nrOfLinks = static_cast<int>(pimpl->m_parent.size());
+    const Eigen::Index n = static_cast<Eigen::Index>(pimpl->m_robot_model.getNrOfDOFs());
+
+    // Initialize the composite rigid body inertias with the link inertias
+    for (int t=0; t < nrOfLinks; t++)
+    {
+        for (size_t k=0; k < N; k++)
+        {
+            pimpl->m_linkCRBI.col(pimpl->col(t,k)) = pimpl->m_inertialParams[t];
+        }
+    }
+
+    // Backward pass: Featherstone 2008, Table 6.2
+    for (int t=nrOfLinks-1; t > 0; t--)
+    {
+        const int parent = pimpl->m_parent[t];
+        const int dofOffset = pimpl->m_dofOffset[t];
+        const Vector6d S = pimpl->m_S[t];
+
+        for (size_t k=0; k < N; k++)
+        {
+            const size_t c = pimpl->col(t,k);
+            Eigen::Map<const Eigen::Matrix3d> parent_R_link(pimpl->m_parent_R_link.col(c).data());
+            Eigen::Map<const Eigen::Vector3d> parent_p_link(pimpl->m_parent_p_link.col(c).data());
+
+            // I_parent += parent_X*_link I_link link_X_parent, computed on the inertial parameters
+            addTransformedInertialParameters(parent_R_link, parent_p_link, pimpl->m_linkCRBI.col(c),
+                                             pimpl->m_linkCRBI.col(pimpl->col(parent,k)));
+
+            if (dofOffset < 0)
+            {
+                continue;
+            }
+
+            Eigen::Map<Eigen::MatrixXd> H(pimpl->m_rawMassMatrices.data() + k*(n+6)*(n+6), n+6, n+6);
+
+            Vector6d F = inertiaTimesTwist(pimpl->m_linkCRBI.col(c), S);
+            H(6+dofOffset,6+dofOffset) = S.dot(F);
+
+            int j = t;
+            while (pimpl->m_parent[j] > 0)
+            {
+                const size_t jc = pimpl->col(j,k);
+                F = parentWrenchFromChild(Eigen::Map<const Eigen::Matrix3d>(pimpl->m_parent_R_link.col(jc).data()),
+                                          pimpl->m_parent_p_link.col(jc), F);
+                j = pimpl->m_parent[j];
+
+                if (pimpl->m_dofOffset[j] >= 0)
+                {
+                    const int ancestorDofOffset = pimpl->m_dofOffset[j];
+                    H(6+dofOffset,6+ancestorDofOffset) = pimpl->m_S[j].dot(F);
+                    H(6+ancestorDofOffset,6+dofOffset) = H(6+dofOffset,6+ancestorDofOffset);
+                }
+            }
+
+            // Express F in the base frame
+            const size_t jc = pimpl->col(j,k);
+            F = parentWrenchFromChild(Eigen::Map<const Eigen::Matrix3d>(pimpl->m_parent_R_link.col(jc).data()),
+                                      pimpl->m_parent_p_link.col(jc), F);
+            H.block<6,1>(0,6+dofOffset) = F;
+            H.block<1,6>(6+dofOffset,0) = F.transpose();
+        }
+    }
+
+    // The top left 6x6 block is the composite rigid body inertia of the whole robot
+    for (size_t k=0; k < N; k++)
+    {
+        Eigen::Map<Eigen::MatrixXd> H(pimpl->m_rawMassMatrices.data() + k*(n+6)*(n+6), n+6, n+6);
+        H.topLeftCorner<6,6>() = inertiaMatrix(pimpl->m_linkCRBI.col(pimpl->col(0,k)));
+    }
+
+    pimpl->m_isRawMassMatrixUpdated = true;
+}
+
+bool KinDynComputationsBatch::getWorldTransforms(const FrameIndex frameIndex,
+                                                 MatrixView<double> world_T_frames)
+{
+    if (!pimpl->m_robot_model.isValidFrameIndex(frameIndex))
+    {
+        reportError("KinDynComputationsBatch","getWorldTransforms","Frame index out of bounds");
+        return false;
+    }
+
+    const size_t N = pimpl->m_nrOfStates;
+    if (world_T_frames.rows() != 4*N || world_T_frames.cols() != 4)
+    {
+        reportError("KinDynComputationsBatch","getWorldTransforms","Wrong size in input world_T_frames");
+        return false;
+    }
+
+    this->computeFwdKinematics();
+
+    const int t = pimpl->m_traversalIndexOfLink[pimpl->m_robot_model.getFrameLink(frameIndex)];
+    const Transform link_H_frame = pimpl->m_robot_model.getFrameTransform(frameIndex);
+    const Eigen::Matrix3d link_R_frame = toEigen(link_H_frame.getRotation());
+    const Eigen::Vector3d link_p_frame = toEigen(link_H_frame.getPosition());
+
+    auto out = toEigen(world_T_frames);
+    for (size_t k=0; k < N; k++)
+    {
+        const size_t c = pimpl->col(t,k);
+        Eigen::Map<const Eigen::Matrix3d> world_R_link(pimpl->m_world_R_link.col(c).data());
+        out.block<3,3>(4*k,0) = world_R_link*link_R_frame;
+        out.block<3,1>(4*k,3) = world_R_link*link_p_frame + pimpl->m_world_p_link.col(c);
+        out.block<1,4>(4*k+3,0) << 0.0, 0.0, 0.0, 1.0;
+    }
+
+    return true;
+}
+
+bool KinDynComputationsBatch::getFreeFloatingMassMatrices(MatrixView<double> freeFloatingMassMatrices)
+{
+    const size_t N = pimpl->m_nrOfStates;
+    const Eigen::Index n = static_cast<Eigen::Index>(pimpl->m_robot_model.getNrOfDOFs());
+
+    if (freeFloatingMassMatrices.rows() != N*(n+6) || freeFloatingMassMatrices.cols() != n+6)
+    {
+        reportError("KinDynComputationsBatch","getFreeFloatingMassMatrices","Wrong size in input freeFloatingMassMatrices");
+        return false;
+    }
+
+    this->computeRawMassMatrices();
+
+    auto out = toEigen(freeFloatingMassMatrices);
+    for (size_t k=0; k < N; k++)
+    {
+        Eigen::Map<const Eigen::MatrixXd> H(pimpl->m_rawMassMatrices.data() + k*(n+6)*(n+6), n+6, n+6);
+        auto M = out.block(k*(n+6), 0, n+6, n+6);
+        M = H;
+
+        if (pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION)
+        {
+            continue;
+        }
+
+        // M = T^T H T, where T maps the base velocity in the used representation
+        // to the base velocity in the BODY_FIXED representation
+        Eigen::Map<const Eigen::Matrix3d> world_R_base(pimpl->m_world_R_base.col(k).data());
+        Eigen::Matrix3d base_R_world = world_R_base.transpose();
+        Eigen::Vector3d base_p_world = Eigen::Vector3d::Zero();
+        if (pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION)
+        {
+            base_p_world = -base_R_world*pimpl->m_world_p_base.col(k);
+        }
+        const Matrix6d T = adjointMatrix(base_R_world, base_p_world);
+
+        M.leftCols<6>() = (M.leftCols<6>()*T).eval();
+        M.topRows<6>() = (T.transpose()*M.topRows<6>()).eval();
+    }
+
+    return true;
+}
+
+bool KinDynComputationsBatch::generalizedBiasForces(MatrixView<double> generalizedBiasForces)
+{
+    const size_t N = pimpl->m_nrOfStates;
+    const Eigen::Index n = static_cast<Eigen::Index>(pimpl->m_robot_model.getNrOfDOFs());
+
+    if (generalizedBiasForces.rows() != N || generalizedBiasForces.cols() != n+6)
+    {
+        reportError("KinDynComputationsBatch","generalizedBiasForces","Wrong size in input generalizedBiasForces");
+        return false;
+    }
+
+    this->computeFwdKinematics();
+
+    const int nrOfLinks = static_cast<int>(pimpl->m_parent.size());
+    auto out = toEigen(generalizedBiasForces);
+
+    // Forward pass: proper accelerations of the links, with zero base
+    // acceleration in the used representation and zero joint accelerations
+    for (size_t k=0; k < N; k++)
+    {
+        const size_t c = pimpl->col(0,k);
+        Eigen::Map<const Eigen::Matrix3d> world_R_base(pimpl->m_world_R_base.col(k).data());
+        Vector6d baseAcc = Vector6d::Zero();
+        if (pimpl->m_frameVelRepr == MIXED_REPRESENTATION)
+        {
+            // A zero mixed acceleration is a non-zero body fixed acceleration
+            const Vector6d baseVel = pimpl->m_baseVel.col(k);
+            baseAcc.head<3>() = -baseVel.tail<3>().cross(baseVel.head<3>());
+        }
+        baseAcc.head<3>() -= world_R_base.transpose()*pimpl->m_gravityAcc;
+        pimpl->m_linkAcc.col(c) = baseAcc;
+    }
+
+    for (int t=1; t < nrOfLinks; t++)
+    {
+        const int parent = pimpl->m_parent[t];
+        const int dofOffset = pimpl->m_dofOffset[t];
+        const Vector6d S = pimpl->m_S[t];
+
+        for (size_t k=0; k < N; k++)
+        {
+            const size_t c = pimpl->col(t,k);
+            Vector6d linkAcc = childTwistFromParent(Eigen::Map<const Eigen::Matrix3d>(pimpl->m_parent_R_link.col(c).data()),
+                                                    pimpl->m_parent_p_link.col(c),
+                                                    pimpl->m_linkAcc.col(pimpl->col(parent,k)));
+            if (dofOffset >= 0)
+            {
+                linkAcc += motionCross(pimpl->m_linkVel.col(c), S*pimpl->m_jointVel(dofOffset,k));
+            }
+            pimpl->m_linkAcc.col(c) = linkAcc;
+        }
+    }
+
+    // Initialize the link wrenches with the inertial wrenches
+    for (int t=0; t < nrOfLinks; t++)
+    {
+        const Matrix6d & I = pimpl->m_inertia[t];
+        for (size_t k=0; k < N; k++)
+        {
+            const size_t c = pimpl->col(t,k);
+            const Vector6d v = pimpl->m_linkVel.col(c);
+            pimpl->m_linkWrench.col(c) = I*pimpl->m_linkAcc.col(c) + forceCross(v, I*v);
+        }
+    }
+
+    // Backward pass: propagate the wrenches to the base and project them on the joints
+    for (int t=nrOfLinks-1; t > 0; t--)
+    {
+        const int parent = pimpl->m_parent[t];
+        const int dofOffset = pimpl->m_dofOffset[t];
+        const Vector6d S = pimpl->m_S[t];
+
+        for (size_t k=0; k < N; k++)
+        {
+            const size_t c = pimpl->col(t,k);
+            const Vector6d f = pimpl->m_linkWrench.col(c);
+            pimpl->m_linkWrench.col(pimpl->col(parent,k)) +=
+                parentWrenchFromChild(Eigen::Map<const Eigen::Matrix3d>(pimpl->m_parent_R_link.col(c).data()),
+                                      pimpl->m_parent_p_link.col(c), f);
+            if (dofOffset >= 0)
+            {
+                out(k,6+dofOffset) = S.dot(f);
+            }
+        }
+    }
+
+    // Convert the base wrench to the used representation
+    for (size_t k=0; k < N; k++)
+    {
+        const Vector6d baseWrench = pimpl->m_linkWrench.col(pimpl->col(0,k));
+        Eigen::Map<const Eigen::Matrix3d> world_R_base(pimpl->m_world_R_base.col(k).data());
+        if (pimpl->m_frameVelRepr == BODY_FIXED_REPRESENTATION)
+        {
+            out.block<1,6>(k,0) = baseWrench.transpose();
+        }
+        else if (pimpl->m_frameVelRepr == MIXED_REPRESENTATION)
+        {
+            out.block<1,3>(k,0) = (world_R_base*baseWrench.head<3>()).transpose();
+            out.block<1,3>(k,3) = (world_R_base*baseWrench.tail<3>()).transpose();
+        }
+        else
+        {
+            assert(pimpl->m_frameVelRepr == INERTIAL_FIXED_REPRESENTATION);
+            out.block<1,6>(k,0) = parentWrenchFromChild(world_R_base, pimpl->m_world_p_base.col(k), baseWrench).transpose();
+        }
+    }
+
+    return true;
+}
+
+bool KinDynComputationsBatch::getFrameFreeFloatingJacobians(const FrameIndex frameIndex,
+                                                            MatrixView<double> outJacobians)
+{
+    if (!pimpl->m_robot_model.isValidFrameIndex(frameIndex))
+    {
+        reportError("KinDynComputationsBatch","getFrameFreeFloatingJacobians","Frame index out of bounds");
+        return false;
+    }
+
+    const size_t N = pimpl->m_nrOfStates;
+    const Eigen::Index n = static_cast<Eigen::Index>(pimpl->m_robot_model.getNrOfDOFs());
+
+    if (outJacobians.rows() != 6*N || outJacobians.cols() != n+6)
+    {
+        reportError("KinDynComputationsBatch","getFrameFreeFloatingJacobians","Wrong size in input outJacobians");
+        return false;
+    }
+
+    this->computeFwdKinematics();
+
+    const int frameTraversalIndex = pimpl->m_traversalIndexOfLink[pimpl->m_robot_model.getFrameLink(frameIndex)];
+    const Transform link_H_frame = pimpl->m_robot_model.getFrameTransform(frameIndex);
+    const Eigen::Matrix3d link_R_frame = toEigen(link_H_frame.getRotation());
+    const Eigen::Vector3d link_p_frame = toEigen(link_H_frame.getPosition());
+
+    auto out = toEigen(outJacobians);
+    out.setZero();
+
+    // Each column is first computed as a twist expressed in the inertial frame,
+    // and then converted to the (frame, world) frame for the MIXED representation
+    // or to the frame for the BODY_FIXED representation
+    const FrameVelocityRepresentation repr = pimpl->m_frameVelRepr;
+    auto toUsedRepresentation = [repr](const Eigen::Matrix3d & world_R_frame,
+                                       const Eigen::Vector3d & world_p_frame,
+                                       const Vector6d & inertialTwist) -> Vector6d
+    {
+        if (repr == INERTIAL_FIXED_REPRESENTATION)
+        {
+            return inertialTwist;
+        }
+
+        Vector6d ret;
+        ret.head<3>() = inertialTwist.head<3>() - world_p_frame.cross(inertialTwist.tail<3>());
+        ret.tail<3>() = inertialTwist.tail<3>();
+
+        if (repr == BODY_FIXED_REPRESENTATION)
+        {
+            ret.head<3>() = world_R_frame.transpose()*ret.head<3>();
+            ret.tail<3>() = world_R_frame.transpose()*ret.tail<3>();
+        }
+        return ret;
+    };
+
+    Eigen::Matrix3d R;
+    Eigen::Vector3d p;
+
+    for (size_t k=0; k < N; k++)
+    {
+        auto J = out.block(6*k, 0, 6, n+6);
+
+        const size_t fc = pimpl->col(frameTraversalIndex,k);
+        Eigen::Map<const Eigen::Matrix3d> world_R_link(pimpl->m_world_R_link.col(fc).data());
+        const Eigen::Matrix3d world_R_frame = world_R_link*link_R_frame;
+        const Eigen::Vector3d world_p_frame = world_R_link*link_p_frame + pimpl->m_world_p_link.col(fc);
+
+        // Base part
+        pimpl->getBaseToUsedRepresentation(k, R, p);
+        const Matrix6d world_X_jacobBase = adjointMatrix(R, p);
+        for (int i=0; i < 6; i++)
+        {
+            J.col(i) = toUsedRepresentation(world_R_frame, world_p_frame, world_X_jacobBase.col(i));
+        }
+
+        // Joint part: we iterate from the link up in the traversal until we reach the base
+        int t = frameTraversalIndex;
+        while (pimpl->m_parent[t] >= 0)
+        {
+            if (pimpl->m_dofOffset[t] >= 0)
+            {
+                const size_t c = pimpl->col(t,k);
+                Eigen::Map<const Eigen::Matrix3d> world_R_visited(pimpl->m_world_R_link.col(c).data());
+                Vector6d inertialTwist;
+                inertialTwist.tail<3>() = world_R_visited*pimpl->m_S[t].tail<3>();
+                inertialTwist.head<3>() = world_R_visited*pimpl->m_S[t].head<3>()
+                                          + pimpl->m_world_p_link.col(c).cross(inertialTwist.tail<3>());
+                J.col(6+pimpl->m_dofOffset[t]) = toUsedRepresentation(world_R_frame, world_p_frame, inertialTwist);
+            }
+            t = pimpl->m_parent[t];
+        }
+    }
+
+    return true;
+}
+
+}
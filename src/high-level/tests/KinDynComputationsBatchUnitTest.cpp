@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testModels.h"
+#include <iDynTree/TestUtils.h>
+
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/MatrixDynSize.h>
+#include <iDynTree/VectorDynSize.h>
+#include <iDynTree/Transform.h>
+#include <iDynTree/Twist.h>
+
+#include <iDynTree/KinDynComputations.h>
+#include <iDynTree/KinDynComputationsBatch.h>
+#include <iDynTree/Model.h>
+#include <iDynTree/ModelLoader.h>
+
+#include <cstdlib>
+
+using namespace iDynTree;
+
+void testBatchConsistency(const std::string & modelName,
+                          const FrameVelocityRepresentation frameVelRepr)
+{
+    std::string urdfFileName = getAbsModelPath(modelName);
+    std::cout << "Testing file " << urdfFileName << std::endl;
+
+    ModelLoader mdlLoader;
+    bool ok = mdlLoader.loadModelFromFile(urdfFileName);
+    ASSERT_IS_TRUE(ok);
+    const Model & model = mdlLoader.model();
+
+    KinDynComputations kinDyn;
+    ok = kinDyn.loadRobotModel(model);
+    ASSERT_IS_TRUE(ok);
+    ok = kinDyn.setFrameVelocityRepresentation(frameVelRepr);
+    ASSERT_IS_TRUE(ok);
+
+    KinDynComputationsBatch batch;
+    ok = batch.loadRobotModel(model);
+    ASSERT_IS_TRUE(ok);
+    ok = batch.setFrameVelocityRepresentation(frameVelRepr);
+    ASSERT_IS_TRUE(ok);
+
+    const size_t N = 7;
+    const size_t dofs = model.getNrOfDOFs();
+
+    MatrixDynSize world_T_bases(4*N, 4), s(N, dofs), base_velocities(N, 6), s_dot(N, dofs);
+    Vector3 gravity;
+    getRandomVector(gravity, -10.0, 10.0);
+
+    for (size_t k=0; k < N; k++)
+    {
+        toEigen(world_T_bases).block<4,4>(4*k,0) = toEigen(getRandomTransform().asHomogeneousTransform());
+        toEigen(base_velocities).row(k) = toEigen(getRandomTwist()).transpose();
+        for (size_t dof=0; dof < dofs; dof++)
+        {
+            s(k,dof) = getRandomDouble(-3.0, 3.0);
+            s_dot(k,dof) = getRandomDouble(-3.0, 3.0);
+        }
+    }
+
+    ok = batch.setRobotStates(world_T_bases, s, base_velocities, s_dot, make_span(gravity));
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(batch.getNrOfStates() == N);
+
+    MatrixDynSize massMatrices(N*(dofs+6), dofs+6), biasForces(N, dofs+6);
+    MatrixDynSize worldTransforms(4*N, 4), jacobians(6*N, dofs+6);
+    ok = batch.getFreeFloatingMassMatrices(massMatrices);
+    ASSERT_IS_TRUE(ok);
+    ok = batch.generalizedBiasForces(biasForces);
+    ASSERT_IS_TRUE(ok);
+
+    MatrixDynSize massMatrix(dofs+6, dofs+6), jacobian(6, dofs+6);
+    VectorDynSize biasForce(dofs+6);
+
+    for (size_t k=0; k < N; k++)
+    {
+        VectorDynSize qj(dofs), dqj(dofs);
+        toEigen(qj) = toEigen(s).row(k).transpose();
+        toEigen(dqj) = toEigen(s_dot).row(k).transpose();
+        Matrix4x4 world_T_base;
+        toEigen(world_T_base) = toEigen(world_T_bases).block<4,4>(4*k,0);
+        Twist baseVel;
+        for (int i=0; i < 6; i++)
+        {
+            baseVel(i) = base_velocities(k,i);
+        }
+
+        ok = kinDyn.setRobotState(Transform(world_T_base), qj, baseVel, dqj, gravity);
+        ASSERT_IS_TRUE(ok);
+
+        kinDyn.getFreeFloatingMassMatrix(massMatrix);
+        MatrixDynSize batchMassMatrix(dofs+6, dofs+6);
+        toEigen(batchMassMatrix) = toEigen(massMatrices).block(k*(dofs+6), 0, dofs+6, dofs+6);
+        ASSERT_EQUAL_MATRIX_TOL(massMatrix, batchMassMatrix, 1e-8);
+
+        kinDyn.generalizedBiasForces(make_span(biasForce));
+        VectorDynSize batchBiasForce(dofs+6);
+        toEigen(batchBiasForce) = toEigen(biasForces).row(k).transpose();
+        ASSERT_EQUAL_VECTOR_TOL(biasForce, batchBiasForce, 1e-8);
+    }
+
+    // Check the kinematic quantities on a subset of the frames
+    for (FrameIndex frame=0; frame < static_cast<FrameIndex>(model.getNrOfFrames()); frame += 5)
+    {
+        ok = batch.getWorldTransforms(frame, worldTransforms);
+        ASSERT_IS_TRUE(ok);
+        ok = batch.getFrameFreeFloatingJacobians(frame, jacobians);
+        ASSERT_IS_TRUE(ok);
+
+        for (size_t k=0; k < N; k++)
+        {
+            VectorDynSize qj(dofs), dqj(dofs);
+            toEigen(qj) = toEigen(s).row(k).transpose();
+            toEigen(dqj) = toEigen(s_dot).row(k).transpose();
+            Matrix4x4 world_T_base;
+            toEigen(world_T_base) = toEigen(world_T_bases).block<4,4>(4*k,0);
+            Twist baseVel;
+            for (int i=0; i < 6; i++)
+            {
+                baseVel(i) = base_velocities(k,i);
+            }
+            kinDyn.setRobotState(Transform(world_T_base), qj, baseVel, dqj, gravity);
+
+            Matrix4x4 batchTransform;
+            toEigen(batchTransform) = toEigen(worldTransforms).block<4,4>(4*k,0);
+            ASSERT_EQUAL_MATRIX_TOL(kinDyn.getWorldTransform(frame).asHomogeneousTransform(), batchTransform, 1e-8);
+
+            kinDyn.getFrameFreeFloatingJacobian(frame, jacobian);
+            MatrixDynSize batchJacobian(6, dofs+6);
+            toEigen(batchJacobian) = toEigen(jacobians).block(6*k, 0, 6, dofs+6);
+            ASSERT_EQUAL_MATRIX_TOL(jacobian, batchJacobian, 1e-8);
+        }
+    }
+
+    // Wrong input sizes should be detected
+    MatrixDynSize wrongSize(N+1, dofs+6);
+    ASSERT_IS_FALSE(batch.generalizedBiasForces(wrongSize));
+
+    // The overload without the base state is equivalent to an identity base pose and a zero base velocity
+    for (size_t k=0; k < N; k++)
+    {
+        toEigen(world_T_bases).block<4,4>(4*k,0).setIdentity();
+    }
+    toEigen(base_velocities).setZero();
+    MatrixDynSize expectedMassMatrices(N*(dofs+6), dofs+6), expectedBiasForces(N, dofs+6), expectedWorldTransforms(4*N, 4);
+    ok = batch.setRobotStates(world_T_bases, s, base_velocities, s_dot, make_span(gravity));
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(batch.getFreeFloatingMassMatrices(expectedMassMatrices));
+    ASSERT_IS_TRUE(batch.generalizedBiasForces(expectedBiasForces));
+    ASSERT_IS_TRUE(batch.getWorldTransforms(model.getNrOfFrames()-1, expectedWorldTransforms));
+
+    ok = batch.setRobotStates(s, s_dot, make_span(gravity));
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(batch.getFreeFloatingMassMatrices(massMatrices));
+    ASSERT_IS_TRUE(batch.generalizedBiasForces(biasForces));
+    ASSERT_IS_TRUE(batch.getWorldTransforms(model.getNrOfFrames()-1, worldTransforms));
+    ASSERT_EQUAL_MATRIX_TOL(massMatrices, expectedMassMatrices, 1e-10);
+    ASSERT_EQUAL_MATRIX_TOL(biasForces, expectedBiasForces, 1e-10);
+    ASSERT_EQUAL_MATRIX_TOL(worldTransforms, expectedWorldTransforms, 1e-10);
+
+    ASSERT_IS_FALSE(batch.setRobotStates(s, wrongSize, make_span(gravity)));
+}
+
+void testBatchConsistencyAllRepresentations(const std::string & modelName)
+{
+    testBatchConsistency(modelName, MIXED_REPRESENTATION);
+    testBatchConsistency(modelName, BODY_FIXED_REPRESENTATION);
+    testBatchConsistency(modelName, INERTIAL_FIXED_REPRESENTATION);
+}
+
+int main()
+{
+    testBatchConsistencyAllRepresentations("oneLink.urdf");
+    testBatchConsistencyAllRepresentations("twoLinks.urdf");
+    testBatchConsistencyAllRepresentations("threeLinks.urdf");
+    testBatchConsistencyAllRepresentations("bigman.urdf");
+    testBatchConsistencyAllRepresentations("icub_skin_frames.urdf");
+    testBatchConsistencyAllRepresentations("iCubGenova02.urdf");
+
+    return EXIT_SUCCESS;
+}
@@ -541,6 +541,55 @@ void testAbsoluteJacobiansAndFrameBiasAcc(KinDynComputations & dynComp)
     ASSERT_EQUAL_VECTOR(frameAcc, frameAccJac);
 }
 
+void checkFramesFreeFloatingJacobians(KinDynComputations & dynComp, const std::vector<FrameIndex> & frames)
+{
+    MatrixDynSize stackedJacobians(6*frames.size(), 6+dynComp.getNrOfDegreesOfFreedom());
+    bool ok = dynComp.getFramesFreeFloatingJacobians(frames, stackedJacobians);
+    ASSERT_IS_TRUE(ok);
+
+    FrameFreeFloatingJacobian jac(dynComp.model());
+    for(size_t i=0; i < frames.size(); i++)
+    {
+        ok = dynComp.getFrameFreeFloatingJacobian(frames[i], jac);
+        ASSERT_IS_TRUE(ok);
+        ASSERT_EQUAL_MATRIX_TOL(toEigen(stackedJacobians).middleRows<6>(6*i), toEigen(jac), 1e-10);
+    }
+}
+
+void testFramesFreeFloatingJacobians(KinDynComputations & dynComp)
+{
+    // All the frames, and a frame repeated twice
+    std::vector<FrameIndex> frames;
+    for(FrameIndex frame=0; frame < static_cast<FrameIndex>(dynComp.getNrOfFrames()); frame++)
+    {
+        frames.push_back(frame);
+    }
+    frames.push_back(0);
+
+    checkFramesFreeFloatingJacobians(dynComp, frames);
+
+    ASSERT_IS_TRUE(dynComp.setNrOfWorkerThreads(3));
+    ASSERT_IS_TRUE(dynComp.getNrOfWorkerThreads() == 3);
+    checkFramesFreeFloatingJacobians(dynComp, frames);
+
+    // The quantities shared by the frames are recomputed after a change of the state
+    VectorDynSize jointPos(dynComp.getNrOfDegreesOfFreedom());
+    dynComp.getJointPos(jointPos);
+    for(size_t dof=0; dof < jointPos.size(); dof++)
+    {
+        jointPos(dof) += 0.1;
+    }
+    dynComp.setJointPos(jointPos);
+    checkFramesFreeFloatingJacobians(dynComp, frames);
+
+    ASSERT_IS_TRUE(dynComp.setNrOfWorkerThreads(0));
+    checkFramesFreeFloatingJacobians(dynComp, frames);
+
+    // Wrong output size
+    MatrixDynSize wrongSizeJacobians(6*frames.size()+1, 6+dynComp.getNrOfDegreesOfFreedom());
+    ASSERT_IS_FALSE(dynComp.getFramesFreeFloatingJacobians(frames, wrongSizeJacobians));
+}
+
 void testInverseDynamicsWithInternalJointForceTorques(KinDynComputations & dynComp)
 {
     // Comute inverseDynamicsWithInternalJointForceTorques
@@ -719,6 +768,7 @@ void testModelConsistency(std::string modelFilePath, const FrameVelocityRepresen
         testInverseDynamics(dynComp);
         testRelativeJacobians(dynComp);
         testAbsoluteJacobiansAndFrameBiasAcc(dynComp);
+        testFramesFreeFloatingJacobians(dynComp);
     }
 
 }
@@ -851,6 +901,126 @@ void testSparsityPatternAllRepresentations(std::string modelName)
     testSparsityPattern(urdfFileName,iDynTree::INERTIAL_FIXED_REPRESENTATION);
 }
 
+void testCacheInvalidation(std::string modelFilePath, const FrameVelocityRepresentation frameVelRepr)
+{
+    iDynTree::ModelLoader mdlLoader;
+    bool ok = mdlLoader.loadModelFromFile(modelFilePath);
+    ASSERT_IS_TRUE(ok);
+
+    // dynComp uses the cache across state changes, while dynCompRef is always reset
+    iDynTree::KinDynComputations dynComp, dynCompRef;
+    ok = dynComp.loadRobotModel(mdlLoader.model());
+    ok = ok && dynCompRef.loadRobotModel(mdlLoader.model());
+    ok = ok && dynComp.setFrameVelocityRepresentation(frameVelRepr);
+    ok = ok && dynCompRef.setFrameVelocityRepresentation(frameVelRepr);
+    ASSERT_IS_TRUE(ok);
+
+    size_t dofs = dynComp.getNrOfDegreesOfFreedom();
+    FrameIndex frame = static_cast<FrameIndex>(dynComp.getNrOfFrames()-1);
+    Transform worldTbase;
+    Twist baseVel;
+    Vector3 gravity;
+    VectorDynSize qj(dofs), dqj(dofs);
+    MatrixDynSize massMatrix(dofs+6, dofs+6), massMatrixRef(dofs+6, dofs+6);
+    VectorDynSize biasForces(dofs+6), biasForcesRef(dofs+6);
+
+    setRandomState(dynComp);
+    dynComp.getRobotState(worldTbase, qj, baseVel, dqj, gravity);
+    dynComp.setRobotState(worldTbase, qj, baseVel, dqj, gravity);
+
+    auto checkConsistency = [&]()
+    {
+        dynCompRef.setRobotState(worldTbase, qj, baseVel, dqj, gravity);
+        dynComp.getFreeFloatingMassMatrix(massMatrix);
+        dynCompRef.getFreeFloatingMassMatrix(massMatrixRef);
+        ASSERT_EQUAL_MATRIX(massMatrix, massMatrixRef);
+        dynComp.generalizedBiasForces(biasForces);
+        dynCompRef.generalizedBiasForces(biasForcesRef);
+        ASSERT_EQUAL_VECTOR(biasForces, biasForcesRef);
+        ASSERT_EQUAL_TRANSFORM(dynComp.getWorldTransform(frame), dynCompRef.getWorldTransform(frame));
+        ASSERT_EQUAL_VECTOR(dynComp.getFrameVel(frame), dynCompRef.getFrameVel(frame));
+        ASSERT_EQUAL_VECTOR(dynComp.getFrameBiasAcc(frame), dynCompRef.getFrameBiasAcc(frame));
+        ASSERT_EQUAL_VECTOR(dynComp.getLinearAngularMomentum(), dynCompRef.getLinearAngularMomentum());
+    };
+
+    checkConsistency();
+    dynComp.resetCacheCounters();
+
+    // Setting again the same state does not invalidate anything
+    ok = dynComp.setRobotState(worldTbase, qj, baseVel, dqj, gravity);
+    ASSERT_IS_TRUE(ok);
+    checkConsistency();
+    KinDynComputationsCacheCounters counters = dynComp.getCacheCounters();
+    ASSERT_IS_TRUE(counters.forwardPositionKinematics == 0);
+    ASSERT_IS_TRUE(counters.forwardVelocityKinematics == 0);
+    ASSERT_IS_TRUE(counters.massMatrix == 0);
+    ASSERT_IS_TRUE(counters.totalMomentum == 0);
+    ASSERT_IS_TRUE(counters.biasAccelerations == 0);
+
+    // A change in the velocities does not require to recompute positions and mass matrix
+    for(size_t dof=0; dof < dofs; dof++)
+    {
+        dqj(dof) = random_double();
+    }
+    baseVel(0) += 0.1;
+    ok = dynComp.setRobotState(worldTbase, qj, baseVel, dqj, gravity);
+    ASSERT_IS_TRUE(ok);
+    checkConsistency();
+    counters = dynComp.getCacheCounters();
+    ASSERT_IS_TRUE(counters.forwardPositionKinematics == 0);
+    ASSERT_IS_TRUE(counters.massMatrix == 0);
+    ASSERT_IS_TRUE(counters.forwardVelocityKinematics == 1);
+    ASSERT_IS_TRUE(counters.totalMomentum == 1);
+    ASSERT_IS_TRUE(counters.biasAccelerations == 1);
+
+    // A change in the gravity does not invalidate any cached quantity
+    dynComp.resetCacheCounters();
+    gravity(2) += 1.0;
+    ok = dynComp.setRobotState(worldTbase, qj, baseVel, dqj, gravity);
+    ASSERT_IS_TRUE(ok);
+    checkConsistency();
+    counters = dynComp.getCacheCounters();
+    ASSERT_IS_TRUE(counters.forwardPositionKinematics == 0);
+    ASSERT_IS_TRUE(counters.forwardVelocityKinematics == 0);
+    ASSERT_IS_TRUE(counters.massMatrix == 0);
+    ASSERT_IS_TRUE(counters.biasAccelerations == 0);
+
+    // A change in the joint positions invalidates everything
+    dynComp.resetCacheCounters();
+    if (dofs > 0)
+    {
+        qj(0) += 0.1;
+        ok = dynComp.setJointPos(qj);
+        ASSERT_IS_TRUE(ok);
+        checkConsistency();
+        counters = dynComp.getCacheCounters();
+        ASSERT_IS_TRUE(counters.forwardPositionKinematics == 1);
+        ASSERT_IS_TRUE(counters.massMatrix == 1);
+        ASSERT_IS_TRUE(counters.biasAccelerations == 1);
+        // Only the links in the subtree of the changed joint are updated, the base is not
+        ASSERT_IS_TRUE(counters.linkPositions < dynComp.getNrOfLinks());
+    }
+
+    // A change of the floating base invalidates everything
+    dynComp.resetCacheCounters();
+    std::string newBase = dynComp.model().getLinkName(dynComp.model().getNrOfLinks()-1);
+    ok = dynComp.setFloatingBase(newBase) && dynCompRef.setFloatingBase(newBase);
+    ASSERT_IS_TRUE(ok);
+    checkConsistency();
+    counters = dynComp.getCacheCounters();
+    ASSERT_IS_TRUE(counters.forwardPositionKinematics == 1);
+    ASSERT_IS_TRUE(counters.massMatrix == 1);
+}
+
+void testCacheInvalidationAllRepresentations(std::string modelName)
+{
+    std::string urdfFileName = getAbsModelPath(modelName);
+    std::cout << "Testing file " << urdfFileName <<  std::endl;
+    testCacheInvalidation(urdfFileName,iDynTree::MIXED_REPRESENTATION);
+    testCacheInvalidation(urdfFileName,iDynTree::BODY_FIXED_REPRESENTATION);
+    testCacheInvalidation(urdfFileName,iDynTree::INERTIAL_FIXED_REPRESENTATION);
+}
+
 int main()
 {
     // Just run the tests on a handful of models to avoid
@@ -877,6 +1047,10 @@ int main()
     testSparsityPatternAllRepresentations("bigman.urdf");
     testSparsityPatternAllRepresentations("icub_skin_frames.urdf");
 
+    testCacheInvalidationAllRepresentations("oneLink.urdf");
+    testCacheInvalidationAllRepresentations("threeLinks.urdf");
+    testCacheInvalidationAllRepresentations("iCubGenova02.urdf");
+
 
 
     return EXIT_SUCCESS;
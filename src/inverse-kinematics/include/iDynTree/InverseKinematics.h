@@ -10,6 +10,8 @@
 
 #include <iDynTree/ConvexHullHelpers.h>
 #include <iDynTree/Direction.h>
+#include <iDynTree/Transform.h>
+#include <iDynTree/VectorDynSize.h>
 
 namespace iDynTree {
     class VectorDynSize;
@@ -69,6 +71,99 @@ namespace iDynTree {
         InverseKinematicsTreatTargetAsConstraintRotationOnly = 1 << 1, //rotation as constraint, position as cost
         InverseKinematicsTreatTargetAsConstraintFull = InverseKinematicsTreatTargetAsConstraintPositionOnly | InverseKinematicsTreatTargetAsConstraintRotationOnly, //both as constraints
     };
+
+    /*!
+     * @brief How the Hessian of the Lagrangian of the optimization problem is obtained
+     */
+    enum InverseKinematicsHessianApproximation {
+        /**
+         * The Hessian is approximated by the solver with a limited-memory quasi-Newton method.
+         * This is the default.
+         */
+        InverseKinematicsHessianApproximationLimitedMemory,
+        /**
+         * The Hessian is computed analytically from the second derivatives of the frame
+         * constraints and targets, and passed to the solver with a sparsity pattern
+         * that couples only the variables moving the same frame.
+         * The limited-memory approximation is still used if a center of mass target or
+         * a center of mass projection constraint is active.
+         */
+        InverseKinematicsHessianApproximationExact,
+    };
+
+    /*!
+     * @brief How the inverse kinematics problem is solved by InverseKinematics::solve
+     */
+    enum InverseKinematicsSolverMode {
+        /**
+         * The full nonlinear optimization problem is solved with IPOPT.
+         * This is the default.
+         */
+        InverseKinematicsSolverModeNonlinear,
+        /**
+         * Differential inverse kinematics: the kinematics is linearized once around the
+         * initial condition, and a single QP is solved with OSQP to compute the configuration
+         * increment that moves the frames towards their targets. The frame constraints and the
+         * targets treated as constraints become equality constraints on the increment, the other
+         * targets least squares costs, and the joint limits bounds.
+         * It is meant to be called at each cycle of a control loop: the solution of a call is the
+         * initial condition of the next one (unless a new initial condition is set), and the QP solver
+         * is warm-started with the previous solution.
+         * It requires iDynTree to be compiled with the optimal control component and with OSQP.
+         */
+        InverseKinematicsSolverModeDifferential,
+    };
+
+    /*!
+     * @brief One of the problems solved by InverseKinematics::solveBatch
+     *
+     * A problem is the problem configured in the InverseKinematics object, with the desired
+     * transforms of some of its targets replaced. Each problem can be solved from multiple
+     * initial conditions (multi-start), and the best solution is kept.
+     */
+    struct InverseKinematicsBatchProblem
+    {
+        /**
+         * Frames of the targets whose desired transform is replaced in this problem.
+         * The targets must have been already added to the InverseKinematics object.
+         */
+        std::vector<std::string> targetFrames;
+
+        /**
+         * Desired transforms of the frames in targetFrames. For position (rotation) targets
+         * only the position (rotation) part is used.
+         */
+        std::vector<iDynTree::Transform> targetTransforms;
+
+        /**
+         * Initial base transforms, one for each start.
+         * If empty, the base initial condition of the InverseKinematics object is used.
+         */
+        std::vector<iDynTree::Transform> initialBaseTransforms;
+
+        /**
+         * Initial configurations of all the joints of the full model, one for each start.
+         * If empty, the joints initial condition of the InverseKinematics object is used.
+         * If both initialBaseTransforms and initialJointsConfigurations are not empty, they must have the same size.
+         */
+        std::vector<iDynTree::VectorDynSize> initialJointsConfigurations;
+    };
+
+    /*!
+     * @brief Best solution of an InverseKinematicsBatchProblem, with the statistics of its solution
+     */
+    struct InverseKinematicsBatchSolution
+    {
+        bool isValid; /*!< true if the problem has been solved from at least one initial condition */
+        iDynTree::Transform baseTransform; /*!< base transform of the best solution */
+        iDynTree::VectorDynSize jointsConfiguration; /*!< joints configuration (full model) of the best solution */
+        double cost; /*!< value of the cost at the best solution */
+        size_t bestStart; /*!< index of the initial condition leading to the best solution */
+        size_t nrOfStarts; /*!< number of initial conditions tried */
+        size_t nrOfSuccessfulStarts; /*!< number of initial conditions from which the problem has been solved */
+        size_t nrOfIterations; /*!< total number of iterations of the solver, for all the initial conditions */
+        double solveTime; /*!< total wall clock time spent solving the problem, in seconds */
+    };
 }
 
 /*!
@@ -296,6 +391,76 @@ public:
     std::string linearSolverName();
     void setLinearSolverName(const std::string &solverName);
 
+    /**
+     * Sets how the Hessian of the Lagrangian is obtained.
+     *
+     * The default value for this parameter is InverseKinematicsHessianApproximationLimitedMemory.
+     * The exact Hessian usually reduces the number of iterations needed to converge,
+     * at the cost of a more expensive iteration.
+     *
+     * @param hessianApproximation the type of Hessian used by the solver.
+     */
+    void setHessianApproximation(const enum InverseKinematicsHessianApproximation hessianApproximation);
+
+    /**
+     * Retrieves how the Hessian of the Lagrangian is obtained.
+     * @return the type of Hessian used by the solver.
+     */
+    enum InverseKinematicsHessianApproximation hessianApproximation() const;
+
+    /**
+     * Sets how the problem is solved.
+     *
+     * The default value for this parameter is InverseKinematicsSolverModeNonlinear.
+     * In the InverseKinematicsSolverModeDifferential mode, the maximum number of iterations
+     * and the maximum CPU time bound the time spent by the QP solver at each call.
+     *
+     * @param mode the solver mode.
+     * @return true if successful, false if the mode is not available.
+     */
+    bool setSolverMode(const enum InverseKinematicsSolverMode mode);
+
+    /**
+     * Retrieves how the problem is solved.
+     * @return the solver mode.
+     */
+    enum InverseKinematicsSolverMode solverMode() const;
+
+    /**
+     * Sets the fraction of the error of targets and constraints recovered at each call
+     * in the InverseKinematicsSolverModeDifferential mode.
+     *
+     * The default value for this parameter is 1.
+     *
+     * @param gain a value in (0, 1].
+     * @return true if successful, false otherwise.
+     */
+    bool setDifferentialModeGain(const double gain);
+
+    /**
+     * Retrieves the fraction of the error recovered at each call in the differential mode.
+     * @return the gain.
+     */
+    double differentialModeGain() const;
+
+    /**
+     * Sets the weight of the damping term (the squared norm of the configuration increment)
+     * added to the cost in the InverseKinematicsSolverModeDifferential mode.
+     *
+     * Larger values limit the increments close to kinematic singularities.
+     * The default value for this parameter is \f$ 10^{-6} \f$ .
+     *
+     * @param damping a non negative weight.
+     * @return true if successful, false otherwise.
+     */
+    bool setDifferentialModeDamping(const double damping);
+
+    /**
+     * Retrieves the weight of the damping term in the differential mode.
+     * @return the damping weight.
+     */
+    double differentialModeDamping() const;
+
     ///@}
 
 
@@ -1019,6 +1184,39 @@ public:
     // This is one part should be checked so as to properly enable warm start
     bool solve();
 
+    /*!
+     * Set the number of worker threads used by solveBatch, in addition to the calling thread.
+     *
+     * Each thread uses its own copy of the problem and of the solver.
+     * @note the linear solver used by IPOPT must support being called concurrently from
+     * multiple threads (e.g. the HSL solvers, or MUMPS with IPOPT >= 3.14 that serializes its calls).
+     * @param[in] nrOfWorkerThreads the number of worker threads, 0 (the default) to solve all the problems in the calling thread
+     * @return true if successful, false otherwise
+     */
+    bool setNrOfWorkerThreads(const size_t nrOfWorkerThreads);
+
+    /*!
+     * Get the number of worker threads used by solveBatch.
+     */
+    size_t getNrOfWorkerThreads() const;
+
+    /*!
+     * Solve a batch of problems, distributing them between the worker threads.
+     *
+     * Each problem is the problem configured in this object (model, constraints, targets and
+     * parameters) with the target transforms replaced as specified in the problem, solved from
+     * each of its initial conditions. The solution with the lowest cost is returned.
+     * The problems are always solved with InverseKinematicsSolverModeNonlinear, and they
+     * do not modify the targets, the initial condition or the solution of this object.
+     *
+     * @param[in] problems the problems to be solved
+     * @param[out] solutions the best solution of each problem (resized to the number of problems)
+     * @return true if the batch could be solved (even if some problems were not solved, see
+     *         InverseKinematicsBatchSolution::isValid), false if the problems are not consistent with this object.
+     */
+    bool solveBatch(const std::vector<InverseKinematicsBatchProblem>& problems,
+                    std::vector<InverseKinematicsBatchSolution>& solutions);
+
     /*! @name Solution-related methods
       */
     ///@{
@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef IDYNTREE_INTERNAL_DIFFERENTIALINVERSEKINEMATICSQP_H
+#define IDYNTREE_INTERNAL_DIFFERENTIALINVERSEKINEMATICSQP_H
+
+#include "TransformConstraint.h"
+
+#include <iDynTree/OptimizationProblem.h>
+#include <iDynTree/Indices.h>
+#include <iDynTree/VectorDynSize.h>
+#include <iDynTree/MatrixDynSize.h>
+#include <iDynTree/Transform.h>
+
+#include <utility>
+#include <vector>
+
+namespace iDynTree {
+    class KinDynComputations;
+    class ConvexHullProjectionConstraint;
+}
+
+namespace internal {
+namespace kinematics {
+    class DifferentialInverseKinematicsQP;
+    struct DifferentialInverseKinematicsProblem;
+}
+}
+
+/*!
+ * @brief Inverse kinematics problem linearized by DifferentialInverseKinematicsQP
+ *
+ * The members point to the data of the problem, which is owned by the caller (i.e. InverseKinematicsData)
+ * and is read each time the QP is prepared. This keeps the QP independent of the NLP and of IPOPT.
+ */
+struct internal::kinematics::DifferentialInverseKinematicsProblem
+{
+    iDynTree::KinDynComputations* dynamics; /*!< kinematics of the model, moved to the linearization point */
+    const TransformMap* constraints; /*!< frame constraints */
+    const TransformMap* targets; /*!< targets, with their resolution mode */
+    iDynTree::ConvexHullProjectionConstraint* comHullConstraint; /*!< center of mass projection constraint */
+    const bool* comTargetIsActive;
+    const bool* comTargetIsConstraint;
+    const iDynTree::Position* comTargetDesiredPosition;
+    const double* comTargetWeight;
+    const double* comTargetConstraintTolerance;
+    const iDynTree::Transform* baseInitialCondition; /*!< linearization point of the base */
+    const iDynTree::VectorDynSize* jointInitialConditions; /*!< linearization point of the joints */
+    const std::vector<std::pair<double, double> >* jointLimits; /*!< limits of the joints, ordered as min and max */
+    const std::vector<bool>* fixedJoints; /*!< for each joint, true if it is not optimized */
+    const iDynTree::VectorDynSize* preferredJointsConfiguration;
+    const iDynTree::VectorDynSize* preferredJointsWeight;
+    const double* gain; /*!< fraction of the errors recovered by the increment */
+    const double* damping; /*!< weight of the squared norm of the increment */
+};
+
+/*!
+ * @brief QP solved by the differential mode of the inverse kinematics
+ *
+ * The kinematics is linearized around the initial condition of the problem.
+ * The variables \f$ \delta \in \mathbb{R}^{6 + n} \f$ are the increment of the base position,
+ * the increment of the base orientation (as a rotation vector expressed in the inertial frame)
+ * and the increment of the joints, i.e. they are ordered as the free floating Jacobians in
+ * mixed representation. Given the gain \f$ k \f$, the increment should recover the fraction
+ * \f$ k \f$ of the errors \f$ e \f$ of the frames, i.e. \f$ J \delta = k e \f$, where the
+ * rotation error is the logarithm of \f$ R_d R^\top \f$.
+ * - frame constraints and targets treated as constraints are equality constraints;
+ * - the other targets, the center of mass target and the preferred joint configuration are
+ *   weighted least squares costs, as in the NLP, plus a damping term on the whole increment;
+ * - the center of mass projection constraint is linearized into inequality constraints;
+ * - the joint limits are bounds on the increment of the joints.
+ */
+class internal::kinematics::DifferentialInverseKinematicsQP : public iDynTree::optimization::OptimizationProblem
+{
+    DifferentialInverseKinematicsProblem m_problem;
+    size_t m_dofs;
+
+    size_t m_numberOfVariables;
+    size_t m_numberOfConstraints;
+    size_t m_numberOfCostRows;
+    bool m_isInitialized;
+
+    /*! Rows of the linearized tasks, stacked in the same order used to count them */
+    iDynTree::MatrixDynSize m_costJacobian; /*!< Jacobians of the least squares terms */
+    iDynTree::VectorDynSize m_costReference; /*!< desired value of m_costJacobian * increment */
+    iDynTree::VectorDynSize m_costWeights; /*!< weight of each row of m_costJacobian */
+    iDynTree::MatrixDynSize m_constraintsJacobian;
+    iDynTree::VectorDynSize m_constraintsLowerBounds;
+    iDynTree::VectorDynSize m_constraintsUpperBounds;
+
+    iDynTree::MatrixDynSize m_hessian;
+    iDynTree::VectorDynSize m_gradient; /*!< gradient of the cost for a zero increment */
+    iDynTree::VectorDynSize m_variables;
+
+    iDynTree::MatrixDynSize m_frameJacobian;
+    iDynTree::MatrixDynSize m_comJacobian;
+    iDynTree::MatrixDynSize m_jacobianPattern;
+
+    std::vector<size_t> m_hessianNonZeroRows;
+    std::vector<size_t> m_hessianNonZeroColumns;
+    std::vector<size_t> m_jacobianNonZeroRows;
+    std::vector<size_t> m_jacobianNonZeroColumns;
+
+    /*!
+     * Count the rows of the costs and of the constraints for the current targets and constraints
+     */
+    void countRows(size_t& costRows, size_t& constraintRows);
+
+    /*!
+     * Add the nonzero columns of the frame Jacobian rows [firstRow, firstRow + 3) to the patterns
+     * of the next rows of the constraints Jacobian (if constraintRow is not null) or of the Hessian
+     */
+    void addFrameSparsity(iDynTree::FrameIndex frame, unsigned int firstRow, size_t* constraintRow,
+                          std::vector<std::vector<bool>>& hessianPattern);
+
+    /*!
+     * Linearize the tasks around the current state of the KinDynComputations object
+     */
+    bool linearizeTasks();
+
+public:
+
+    /*!
+     * Constructor
+     * @param problem pointers to the data of the problem, which must outlive the QP
+     */
+    DifferentialInverseKinematicsQP(const DifferentialInverseKinematicsProblem& problem);
+
+    virtual ~DifferentialInverseKinematicsQP() override;
+
+    /*!
+     * Compute the size and the sparsity pattern of the problem, given the
+     * current targets and constraints
+     */
+    void initializeInternalData();
+
+    /*!
+     * Compute the configuration obtained applying the increments to the initial condition
+     *
+     * @param[in] increments the solution of the QP
+     * @param[out] basePose the resulting base pose
+     * @param[out] joints the resulting joints configuration
+     */
+    void applyIncrements(const iDynTree::VectorDynSize& increments, iDynTree::Transform& basePose, iDynTree::VectorDynSize& joints);
+
+    virtual bool prepare() override;
+
+    virtual unsigned int numberOfVariables() override;
+
+    virtual unsigned int numberOfConstraints() override;
+
+    virtual bool getConstraintsBounds(iDynTree::VectorDynSize& constraintsLowerBounds, iDynTree::VectorDynSize& constraintsUpperBounds) override;
+
+    virtual bool getVariablesUpperBound(iDynTree::VectorDynSize& variablesUpperBound) override;
+
+    virtual bool getVariablesLowerBound(iDynTree::VectorDynSize& variablesLowerBound) override;
+
+    virtual bool getConstraintsJacobianInfo(std::vector<size_t>& nonZeroElementRows, std::vector<size_t>& nonZeroElementColumns) override;
+
+    virtual bool getHessianInfo(std::vector<size_t>& nonZeroElementRows, std::vector<size_t>& nonZeroElementColumns) override;
+
+    virtual bool setVariables(const iDynTree::VectorDynSize& variables) override;
+
+    virtual bool evaluateCostFunction(double& costValue) override;
+
+    virtual bool evaluateCostGradient(iDynTree::VectorDynSize& gradient) override;
+
+    virtual bool evaluateCostHessian(iDynTree::MatrixDynSize& hessian) override;
+
+    virtual bool evaluateConstraints(iDynTree::VectorDynSize& constraints) override;
+
+    virtual bool evaluateConstraintsJacobian(iDynTree::MatrixDynSize& jacobian) override;
+
+    virtual bool evaluateConstraintsHessian(const iDynTree::VectorDynSize& constraintsMultipliers, iDynTree::MatrixDynSize& hessian) override;
+};
+
+#endif /* end of include guard: IDYNTREE_INTERNAL_DIFFERENTIALINVERSEKINEMATICSQP_H */
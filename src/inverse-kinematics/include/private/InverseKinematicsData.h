@@ -5,6 +5,7 @@
 #define IDYNTREE_INTERNAL_INVERSEKINEMATICSDATA_H
 
 #include "InverseKinematicsNLP.h"
+#include "TransformConstraint.h"
 #include <iDynTree/ConvexHullHelpers.h>
 #include <iDynTree/InverseKinematics.h>
 
@@ -14,22 +15,29 @@
 #include <iDynTree/MatrixDynSize.h>
 #include <iDynTree/Transform.h>
 #include <iDynTree/Twist.h>
+#include <iDynTree/WorkerPool.h>
 
 #include <IpIpoptApplication.hpp>
 
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <unordered_map>
 
+namespace iDynTree {
+namespace optimization {
+    class OsqpInterface;
+}
+}
+
 namespace internal {
 namespace kinematics{
 
     class InverseKinematicsData;
-    class TransformConstraint;
-    typedef std::map<int, internal::kinematics::TransformConstraint> TransformMap; //ordered map. Order is important
 
     class InverseKinematicsNLP;
+    class DifferentialInverseKinematicsQP;
 }
 }
 
@@ -128,6 +136,7 @@ public:
     iDynTree::VectorDynSize m_constraintMultipliers;
     iDynTree::VectorDynSize m_lowerBoundMultipliers;
     iDynTree::VectorDynSize m_upperBoundMultipliers;
+    double m_optimalCost; /*!< value of the cost at the last solution of the NLP */
 
     ///@}
 
@@ -138,6 +147,13 @@ public:
     Ipopt::SmartPtr<Ipopt::IpoptApplication> m_solver; /*!< Instance of IPOPT solver */
     Ipopt::SmartPtr<internal::kinematics::InverseKinematicsNLP> m_nlpProblem;
 
+    std::shared_ptr<internal::kinematics::DifferentialInverseKinematicsQP> m_differentialProblem; /*!< QP of the differential mode (null if not available) */
+    std::shared_ptr<iDynTree::optimization::OsqpInterface> m_differentialSolver; /*!< Instance of the QP solver of the differential mode */
+    iDynTree::VectorDynSize m_differentialIncrements; /*!< Solution of the differential mode QP */
+
+    iDynTree::WorkerPool m_workerPool; /*!< Worker threads used by solveBatch */
+    std::vector<std::unique_ptr<InverseKinematicsData> > m_batchWorkspaces; /*!< Copy of the problem for each thread used by solveBatch */
+
     /*!
      * Update internal variables given a change in the robot state
      */
@@ -158,6 +174,43 @@ public:
      */
     void configureCenterOfMassProjectionConstraint();
 
+    /*!
+     * Disable the warm start of IPOPT, so that the next optimization starts from the initial condition only
+     */
+    void disableWarmStart();
+
+    /*!
+     * Configure this object to solve the same problem of another object
+     *
+     * The model, the limits, the constraints, the targets, the initial condition and
+     * the parameters are copied, while the solver is not shared. The problem is always
+     * solved with the nonlinear mode.
+     * @param other the object to copy the problem from
+     * @return true if successfull, false otherwise
+     */
+    bool copyProblemFrom(const InverseKinematicsData& other);
+
+    /*!
+     * Solve one of the problems of a batch, starting from each of its initial conditions
+     *
+     * The targets and the initial condition are reset to the ones of the problem of
+     * templateData before solving, so this method can be called with the problems of a batch in any order.
+     * @param templateData the object whose problem was copied with copyProblemFrom
+     * @param problem the problem to be solved
+     * @param solution the best solution of the problem
+     */
+    void solveBatchProblem(const InverseKinematicsData& templateData,
+                           const iDynTree::InverseKinematicsBatchProblem& problem,
+                           iDynTree::InverseKinematicsBatchSolution& solution);
+
+    /*!
+     * Solve a batch of problems on the worker threads
+     *
+     * @see iDynTree::InverseKinematics::solveBatch
+     */
+    bool solveBatch(const std::vector<iDynTree::InverseKinematicsBatchProblem>& problems,
+                    std::vector<iDynTree::InverseKinematicsBatchSolution>& solutions);
+
     /*! @name Optimization-related parameters
      */
     ///@{
@@ -168,6 +221,10 @@ public:
     double m_constrTol; /*!< Tolerance for the constraints */
     int m_verbosityLevel; /*!< Verbosity level */
     std::string m_solverName;
+    enum iDynTree::InverseKinematicsHessianApproximation m_hessianApproximation; /*!< How the Hessian of the Lagrangian is obtained */
+    enum iDynTree::InverseKinematicsSolverMode m_solverMode; /*!< Nonlinear or differential solution of the problem */
+    double m_differentialGain; /*!< Fraction of the error recovered by a call in differential mode */
+    double m_differentialDamping; /*!< Weight of the squared norm of the increment in differential mode */
 
     ///@}
 
@@ -305,12 +362,27 @@ public:
      */
     enum iDynTree::InverseKinematicsTreatTargetAsConstraint targetResolutionMode(TransformMap::iterator target) const;
 
-    /*! Solve the NLP problem
+    /*! Solve the NLP problem, or the QP of the differential mode
      *
      * @return true if the problem is solved. False otherwise
      */
     bool solveProblem();
 
+    /*! Solve the QP of the differential mode
+     *
+     * On success the solution becomes the initial condition of the next call
+     * @return true if the problem is solved. False otherwise
+     */
+    bool solveDifferentialProblem();
+
+    /*!
+     * Set how the problem is solved
+     *
+     * @param mode the solver mode
+     * @return true if successfull, false if the mode is not available
+     */
+    bool setSolverMode(enum iDynTree::InverseKinematicsSolverMode mode);
+
     /*!
      * Access the Kinematics and Dynamics object used by the solver
      *
@@ -330,6 +402,12 @@ public:
 
     void setCoMTargetInactive();
 
+    /*!
+     * Return true if the exact Hessian of the Lagrangian is requested and
+     * it can be computed for the current problem (i.e. no center of mass terms are active)
+     */
+    bool isExactHessianActive();
+
 };
 
 #endif /* end of include guard: IDYNTREE_INTERNAL_INVERSEKINEMATICSDATA_H */
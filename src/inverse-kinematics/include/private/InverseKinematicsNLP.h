@@ -12,6 +12,7 @@
 #include <iDynTree/Transform.h>
 
 #include <map>
+#include <vector>
 
 // use expression as sub-expression,
 // then make type of full expression int, discard result
@@ -214,6 +215,7 @@ public:
 class internal::kinematics::InverseKinematicsNLP : public Ipopt::TNLP {
 
     SparsityHelper m_jacobianSparsityHelper;
+    SparsityHelper m_hessianSparsityHelper; /*!< lower triangular part of the Hessian of the Lagrangian */
 
     /*! @brief information about a Frame during optimization
      * All the values are computed given the current robot configuration
@@ -223,6 +225,7 @@ class internal::kinematics::InverseKinematicsNLP : public Ipopt::TNLP {
         iDynTree::Transform transform; /*!< frame w.r.t. global frame, i.e. \f$ {}^w R_f \f$ */
         iDynTree::MatrixDynSize jacobian; /*!< Jacobian */
         iDynTree::MatrixFixSize<4, 3> quaternionDerivativeMap; /*!< map used during the derivative if the quaternion representation is used */
+        std::vector<size_t> jacobianColumns; /*!< columns of the Jacobian which are not structurally zero */
     };
     typedef std::map<int, FrameInfo> FrameInfoMap;
 
@@ -232,6 +235,12 @@ class internal::kinematics::InverseKinematicsNLP : public Ipopt::TNLP {
     iDynTree::MatrixFixSize<3, 4> quaternionDerivativeInverseMapBuffer; /*!< this is used to contain the quaternionDerivativeInverseMap, computed once for each optimization step */
     iDynTree::MatrixDynSize finalJacobianBuffer; /*!< Buffer to contain the Jacobian as modified to handle quaternions */
 
+    iDynTree::MatrixDynSize hessianBuffer; /*!< Dense Hessian of the Lagrangian, of which only the pattern in m_hessianSparsityHelper is passed to IPOPT */
+    iDynTree::MatrixDynSize generatorsHessianBuffer; /*!< Second derivatives w.r.t. the iDynTree velocity variables (base twist and joints), see addFrameHessian */
+    iDynTree::MatrixDynSize velocityToVariablesMapBuffer; /*!< Map from the derivative of the optimization variables to the iDynTree velocity variables */
+    iDynTree::MatrixDynSize mappedGeneratorsHessianBuffer; /*!< Product between generatorsHessianBuffer and velocityToVariablesMapBuffer */
+    std::vector<size_t> dofsDepth; /*!< number of DoFs between the base and each DoF (included), used to know if a joint moves the axis of another one */
+
     FrameInfoMap constraintsInfo; /*!< FrameInfo map for the constraints */
     FrameInfoMap targetsInfo; /*!< FrameInfo map for the targets */
 
@@ -317,13 +326,54 @@ class internal::kinematics::InverseKinematicsNLP : public Ipopt::TNLP {
                               iDynTree::Matrix3x3& map);
 
 
+    /*!
+     * @brief Add the second derivatives of a frame term to the Hessian of the Lagrangian
+     *
+     * The term is
+     * \f[
+     * \mu^\top p_f + \nu^\top \phi(R_f),
+     * \f]
+     * where \f$ p_f \f$ is the frame position and \f$ \phi \f$ is the parametrization of a rotation
+     * whose angular velocity (in the inertial frame) is \f$ A \, {}^I \omega_f \f$, i.e.
+     * \f$ \dot{\phi} = G(\phi) A \, {}^I \omega_f \f$.
+     * The second derivatives of the frame w.r.t. the iDynTree velocity variables are obtained
+     * from the columns of the Jacobian: the derivative of the column of a joint b w.r.t. a joint a
+     * that moves its axis is \f$ [\omega_a \times J_{v,b}; \omega_a \times \omega_b] \f$,
+     * otherwise it is \f$ [\omega_b \times J_{v,a}; 0] \f$.
+     * They are then mapped to the optimization variables, including the second derivatives
+     * of the base orientation parametrization.
+     *
+     * @note updateState must have been called with the current optimization variables
+     * @param[in] frameInfo the frame
+     * @param[in] positionMultipliers \f$ \mu \f$
+     * @param[in] rotationMultipliers \f$ \nu \f$, only the first sizeOfRotationParametrization elements are used
+     * @param[in] rotationParameters \f$ \phi \f$ at the current configuration
+     * @param[in] angularVelocityMap \f$ A \f$
+     * @param[in,out] hessian the Hessian of the Lagrangian w.r.t. the optimization variables
+     */
+    void addFrameHessian(const FrameInfo& frameInfo,
+                         const iDynTree::Vector3& positionMultipliers,
+                         const iDynTree::Vector4& rotationMultipliers,
+                         const iDynTree::Vector4& rotationParameters,
+                         const iDynTree::Matrix3x3& angularVelocityMap,
+                         iDynTree::MatrixDynSize& hessian);
+
+    /**
+     * Helper method to add the Hessian sparsity of a frame (constraint or target)
+     *
+     * @param frameInfo information of the frame, with the jacobianColumns already computed
+     * @param hessianPattern pattern of the Hessian of the Lagrangian (1 for nonzero, 0 otherwise)
+     */
+    void addHessianSparsityForFrame(const FrameInfo& frameInfo, iDynTree::MatrixDynSize& hessianPattern);
+
     /**
      * Helper method to create sparity information for a specific constraint
      *
      * @param constraintID id of the constraint
      * @param constraint constraint object
+     * @param computationOption bitwise mask of ComputeContraintJacobianOption, selecting the parts enforced as constraints
      */
-    void addSparsityInformationForConstraint(int constraintID, const internal::kinematics::TransformConstraint& constraint);
+    void addSparsityInformationForConstraint(int constraintID, const internal::kinematics::TransformConstraint& constraint, int computationOption);
 
     /**
      * Initialize the sparsity information
@@ -7,9 +7,12 @@
 #include <iDynTree/Transform.h>
 #include <iDynTree/InverseKinematics.h>
 
+#include <map>
+
 namespace internal {
     namespace kinematics {
         class TransformConstraint;
+        typedef std::map<int, internal::kinematics::TransformConstraint> TransformMap; //ordered map. Order is important
     }
 }
 
@@ -0,0 +1,492 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "DifferentialInverseKinematicsQP.h"
+#include "TransformConstraint.h"
+
+#include <iDynTree/ConvexHullHelpers.h>
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/GeomVector3.h>
+#include <iDynTree/KinDynComputations.h>
+#include <iDynTree/Utils.h>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace internal {
+namespace kinematics {
+
+    namespace {
+        const double infinity = std::numeric_limits<double>::infinity();
+
+        bool isPositionTreatedAsConstraint(const TransformConstraint& target)
+        {
+            return (target.targetResolutionMode() & iDynTree::InverseKinematicsTreatTargetAsConstraintPositionOnly) != 0;
+        }
+
+        bool isRotationTreatedAsConstraint(const TransformConstraint& target)
+        {
+            return (target.targetResolutionMode() & iDynTree::InverseKinematicsTreatTargetAsConstraintRotationOnly) != 0;
+        }
+    }
+
+    DifferentialInverseKinematicsQP::DifferentialInverseKinematicsQP(const DifferentialInverseKinematicsProblem& problem)
+    : m_problem(problem)
+    , m_dofs(0)
+    , m_numberOfVariables(0)
+    , m_numberOfConstraints(0)
+    , m_numberOfCostRows(0)
+    , m_isInitialized(false)
+    {
+    }
+
+    DifferentialInverseKinematicsQP::~DifferentialInverseKinematicsQP() {}
+
+    void DifferentialInverseKinematicsQP::countRows(size_t& costRows, size_t& constraintRows)
+    {
+        costRows = 0;
+        constraintRows = 0;
+
+        for (TransformMap::const_iterator constraint = m_problem.constraints->begin();
+             constraint != m_problem.constraints->end(); ++constraint) {
+            if (!constraint->second.isActive()) continue;
+            if (constraint->second.hasPositionConstraint()) constraintRows += 3;
+            if (constraint->second.hasRotationConstraint()) constraintRows += 3;
+        }
+
+        if (m_problem.comHullConstraint->isActive()) {
+            constraintRows += m_problem.comHullConstraint->getNrOfConstraints();
+        }
+
+        if (*m_problem.comTargetIsActive) {
+            if (*m_problem.comTargetIsConstraint) {
+                constraintRows += 3;
+            } else {
+                costRows += 3;
+            }
+        }
+
+        for (TransformMap::const_iterator target = m_problem.targets->begin();
+             target != m_problem.targets->end(); ++target) {
+            if (target->second.hasPositionConstraint()) {
+                (isPositionTreatedAsConstraint(target->second) ? constraintRows : costRows) += 3;
+            }
+            if (target->second.hasRotationConstraint()) {
+                (isRotationTreatedAsConstraint(target->second) ? constraintRows : costRows) += 3;
+            }
+        }
+    }
+
+    void DifferentialInverseKinematicsQP::addFrameSparsity(iDynTree::FrameIndex frame, unsigned int firstRow, size_t* constraintRow,
+                                                           std::vector<std::vector<bool>>& hessianPattern)
+    {
+        m_problem.dynamics->getFrameFreeFloatingJacobianSparsityPattern(frame, m_jacobianPattern);
+
+        for (unsigned int row = firstRow; row < firstRow + 3; ++row) {
+            for (size_t col = 0; col < m_numberOfVariables; ++col) {
+                if (m_jacobianPattern(row, col) == 0) continue;
+
+                if (constraintRow) {
+                    m_jacobianNonZeroRows.push_back(*constraintRow);
+                    m_jacobianNonZeroColumns.push_back(col);
+                } else {
+                    // A least squares row couples all the variables it depends on
+                    for (size_t otherCol = 0; otherCol < m_numberOfVariables; ++otherCol) {
+                        if (m_jacobianPattern(row, otherCol) != 0) {
+                            hessianPattern[col][otherCol] = true;
+                        }
+                    }
+                }
+            }
+            if (constraintRow) {
+                ++(*constraintRow);
+            }
+        }
+    }
+
+    void DifferentialInverseKinematicsQP::initializeInternalData()
+    {
+        m_dofs = m_problem.jointInitialConditions->size();
+        m_numberOfVariables = 6 + m_dofs;
+        countRows(m_numberOfCostRows, m_numberOfConstraints);
+
+        m_costJacobian.resize(m_numberOfCostRows, m_numberOfVariables);
+        m_costReference.resize(m_numberOfCostRows);
+        m_costWeights.resize(m_numberOfCostRows);
+        m_constraintsJacobian.resize(m_numberOfConstraints, m_numberOfVariables);
+        m_constraintsJacobian.zero();
+        m_constraintsLowerBounds.resize(m_numberOfConstraints);
+        m_constraintsUpperBounds.resize(m_numberOfConstraints);
+        m_hessian.resize(m_numberOfVariables, m_numberOfVariables);
+        m_gradient.resize(m_numberOfVariables);
+        m_variables.resize(m_numberOfVariables);
+        m_variables.zero();
+        m_frameJacobian.resize(6, m_numberOfVariables);
+        m_comJacobian.resize(3, m_numberOfVariables);
+        m_jacobianPattern.resize(6, m_numberOfVariables);
+
+        // The diagonal is always present because of the damping
+        std::vector<std::vector<bool>> hessianPattern(m_numberOfVariables, std::vector<bool>(m_numberOfVariables, false));
+        for (size_t i = 0; i < m_numberOfVariables; ++i) {
+            hessianPattern[i][i] = true;
+        }
+
+        m_jacobianNonZeroRows.clear();
+        m_jacobianNonZeroColumns.clear();
+        size_t constraintRow = 0;
+
+        for (TransformMap::const_iterator constraint = m_problem.constraints->begin();
+             constraint != m_problem.constraints->end(); ++constraint) {
+            if (!constraint->second.isActive()) continue;
+            if (constraint->second.hasPositionConstraint()) {
+                addFrameSparsity(constraint->first, 0, &constraintRow, hessianPattern);
+            }
+            if (constraint->second.hasRotationConstraint()) {
+                addFrameSparsity(constraint->first, 3, &constraintRow, hessianPattern);
+            }
+        }
+
+        // The center of mass depends on all the variables
+        size_t comConstraintRows = 0;
+        if (m_problem.comHullConstraint->isActive()) {
+            comConstraintRows += m_problem.comHullConstraint->getNrOfConstraints();
+        }
+        if (*m_problem.comTargetIsActive) {
+            if (*m_problem.comTargetIsConstraint) {
+                comConstraintRows += 3;
+            } else {
+                for (size_t row = 0; row < m_numberOfVariables; ++row) {
+                    hessianPattern[row].assign(m_numberOfVariables, true);
+                }
+            }
+        }
+        for (size_t row = 0; row < comConstraintRows; ++row, ++constraintRow) {
+            for (size_t col = 0; col < m_numberOfVariables; ++col) {
+                m_jacobianNonZeroRows.push_back(constraintRow);
+                m_jacobianNonZeroColumns.push_back(col);
+            }
+        }
+
+        for (TransformMap::const_iterator target = m_problem.targets->begin();
+             target != m_problem.targets->end(); ++target) {
+            if (target->second.hasPositionConstraint()) {
+                addFrameSparsity(target->first, 0, isPositionTreatedAsConstraint(target->second) ? &constraintRow : nullptr, hessianPattern);
+            }
+            if (target->second.hasRotationConstraint()) {
+                addFrameSparsity(target->first, 3, isRotationTreatedAsConstraint(target->second) ? &constraintRow : nullptr, hessianPattern);
+            }
+        }
+        assert(constraintRow == m_numberOfConstraints);
+
+        m_hessianNonZeroRows.clear();
+        m_hessianNonZeroColumns.clear();
+        for (size_t row = 0; row < m_numberOfVariables; ++row) {
+            for (size_t col = 0; col < m_numberOfVariables; ++col) {
+                if (hessianPattern[row][col]) {
+                    m_hessianNonZeroRows.push_back(row);
+                    m_hessianNonZeroColumns.push_back(col);
+                }
+            }
+        }
+
+        m_isInitialized = true;
+    }
+
+    bool DifferentialInverseKinematicsQP::linearizeTasks()
+    {
+        const double gain = *m_problem.gain;
+        iDynTree::iDynTreeEigenMatrixMap costJacobian = iDynTree::toEigen(m_costJacobian);
+        iDynTree::iDynTreeEigenVector costReference = iDynTree::toEigen(m_costReference);
+        iDynTree::iDynTreeEigenVector costWeights = iDynTree::toEigen(m_costWeights);
+        iDynTree::iDynTreeEigenMatrixMap constraintsJacobian = iDynTree::toEigen(m_constraintsJacobian);
+        iDynTree::iDynTreeEigenVector lowerBounds = iDynTree::toEigen(m_constraintsLowerBounds);
+        iDynTree::iDynTreeEigenVector upperBounds = iDynTree::toEigen(m_constraintsUpperBounds);
+        iDynTree::iDynTreeEigenMatrixMap frameJacobian = iDynTree::toEigen(m_frameJacobian);
+
+        Eigen::Index costRow = 0;
+        Eigen::Index constraintRow = 0;
+
+        // The desired linear and angular velocities of the frame are the fraction gain of its errors
+        auto addFrameRows = [&](const TransformConstraint& task, const iDynTree::Transform& transform,
+                                bool position, bool asConstraint, double weight) {
+            Eigen::Vector3d error;
+            if (position) {
+                error = iDynTree::toEigen(task.getPosition()) - iDynTree::toEigen(transform.getPosition());
+            } else {
+                error = iDynTree::toEigen((task.getRotation() * transform.getRotation().inverse()).log());
+            }
+            error *= gain;
+
+            Eigen::Index jacobianRow = position ? 0 : 3;
+            if (asConstraint) {
+                constraintsJacobian.middleRows<3>(constraintRow) = frameJacobian.middleRows<3>(jacobianRow);
+                lowerBounds.segment<3>(constraintRow) = error;
+                upperBounds.segment<3>(constraintRow) = error;
+                constraintRow += 3;
+            } else {
+                costJacobian.middleRows<3>(costRow) = frameJacobian.middleRows<3>(jacobianRow);
+                costReference.segment<3>(costRow) = error;
+                costWeights.segment<3>(costRow).setConstant(weight);
+                costRow += 3;
+            }
+        };
+
+        for (TransformMap::const_iterator constraint = m_problem.constraints->begin();
+             constraint != m_problem.constraints->end(); ++constraint) {
+            if (!constraint->second.isActive()) continue;
+            if (!m_problem.dynamics->getFrameFreeFloatingJacobian(constraint->first, m_frameJacobian)) {
+                return false;
+            }
+            iDynTree::Transform transform = m_problem.dynamics->getWorldTransform(constraint->first);
+            if (constraint->second.hasPositionConstraint()) {
+                addFrameRows(constraint->second, transform, true, true, 0.0);
+            }
+            if (constraint->second.hasRotationConstraint()) {
+                addFrameRows(constraint->second, transform, false, true, 0.0);
+            }
+        }
+
+        if (m_problem.comHullConstraint->isActive() || *m_problem.comTargetIsActive) {
+            if (!m_problem.dynamics->getCenterOfMassJacobian(m_comJacobian)) {
+                return false;
+            }
+            iDynTree::Position com = m_problem.dynamics->getCenterOfMassPosition();
+
+            if (m_problem.comHullConstraint->isActive()) {
+                // A P (c + J_c delta - o) <= b
+                Eigen::Index hullRows = static_cast<Eigen::Index>(m_problem.comHullConstraint->getNrOfConstraints());
+                iDynTree::Vector2 projectedCom = m_problem.comHullConstraint->projectAlongDirection(com);
+                constraintsJacobian.middleRows(constraintRow, hullRows) = iDynTree::toEigen(m_problem.comHullConstraint->A)
+                    * iDynTree::toEigen(m_problem.comHullConstraint->Pdirection) * iDynTree::toEigen(m_comJacobian);
+                lowerBounds.segment(constraintRow, hullRows).setConstant(-infinity);
+                upperBounds.segment(constraintRow, hullRows) = iDynTree::toEigen(m_problem.comHullConstraint->b)
+                    - iDynTree::toEigen(m_problem.comHullConstraint->A) * iDynTree::toEigen(projectedCom);
+                constraintRow += hullRows;
+            }
+
+            if (*m_problem.comTargetIsActive) {
+                Eigen::Vector3d error = gain * (iDynTree::toEigen(*m_problem.comTargetDesiredPosition) - iDynTree::toEigen(com));
+                if (*m_problem.comTargetIsConstraint) {
+                    constraintsJacobian.middleRows<3>(constraintRow) = iDynTree::toEigen(m_comJacobian);
+                    lowerBounds.segment<3>(constraintRow) = error.array() - *m_problem.comTargetConstraintTolerance;
+                    upperBounds.segment<3>(constraintRow) = error.array() + *m_problem.comTargetConstraintTolerance;
+                    constraintRow += 3;
+                } else {
+                    costJacobian.middleRows<3>(costRow) = iDynTree::toEigen(m_comJacobian);
+                    costReference.segment<3>(costRow) = error;
+                    costWeights.segment<3>(costRow).setConstant(*m_problem.comTargetWeight);
+                    costRow += 3;
+                }
+            }
+        }
+
+        for (TransformMap::const_iterator target = m_problem.targets->begin();
+             target != m_problem.targets->end(); ++target) {
+            if (!target->second.hasPositionConstraint() && !target->second.hasRotationConstraint()) continue;
+            if (!m_problem.dynamics->getFrameFreeFloatingJacobian(target->first, m_frameJacobian)) {
+                return false;
+            }
+            iDynTree::Transform transform = m_problem.dynamics->getWorldTransform(target->first);
+            if (target->second.hasPositionConstraint()) {
+                addFrameRows(target->second, transform, true, isPositionTreatedAsConstraint(target->second),
+                             target->second.getPositionWeight());
+            }
+            if (target->second.hasRotationConstraint()) {
+                addFrameRows(target->second, transform, false, isRotationTreatedAsConstraint(target->second),
+                             target->second.getRotationWeight());
+            }
+        }
+
+        assert(static_cast<size_t>(costRow) == m_numberOfCostRows);
+        assert(static_cast<size_t>(constraintRow) == m_numberOfConstraints);
+        return true;
+    }
+
+    void DifferentialInverseKinematicsQP::applyIncrements(const iDynTree::VectorDynSize& increments,
+                                                          iDynTree::Transform& basePose, iDynTree::VectorDynSize& joints)
+    {
+        assert(increments.size() == m_numberOfVariables);
+        iDynTree::iDynTreeEigenConstVector delta = iDynTree::toEigen(increments);
+
+        const iDynTree::Transform& initialBasePose = *m_problem.baseInitialCondition;
+        iDynTree::Position basePosition;
+        iDynTree::toEigen(basePosition) = iDynTree::toEigen(initialBasePose.getPosition()) + delta.head<3>();
+
+        // The angular increment is expressed in the inertial frame (mixed representation)
+        iDynTree::AngularMotionVector3 baseRotationIncrement;
+        iDynTree::toEigen(baseRotationIncrement) = delta.segment<3>(3);
+
+        basePose.setPosition(basePosition);
+        basePose.setRotation(baseRotationIncrement.exp() * initialBasePose.getRotation());
+
+        joints.resize(m_dofs);
+        for (size_t i = 0; i < m_dofs; ++i) {
+            joints(i) = (*m_problem.jointInitialConditions)(i);
+            if ((*m_problem.fixedJoints)[i]) continue;
+            const std::pair<double, double>& limits = (*m_problem.jointLimits)[i];
+            joints(i) = std::min(std::max(joints(i) + increments(6 + i), limits.first), limits.second);
+        }
+    }
+
+    bool DifferentialInverseKinematicsQP::prepare()
+    {
+        size_t costRows, constraintRows;
+        countRows(costRows, constraintRows);
+        if (!m_isInitialized || costRows != m_numberOfCostRows || constraintRows != m_numberOfConstraints
+            || m_dofs != m_problem.jointInitialConditions->size()) {
+            initializeInternalData();
+        }
+
+        // Linearize around the initial condition
+        if (!m_problem.dynamics->setWorldBaseTransform(*m_problem.baseInitialCondition)
+            || !m_problem.dynamics->setJointPos(*m_problem.jointInitialConditions)) {
+            return false;
+        }
+
+        if (!linearizeTasks()) {
+            iDynTree::reportError("DifferentialInverseKinematicsQP", "prepare", "Error while linearizing the targets and the constraints.");
+            return false;
+        }
+
+        // 0.5 |J delta - r|^2_W + 0.5 |delta_s - k (s_pref - s)|^2_Wp + 0.5 damping |delta|^2
+        iDynTree::iDynTreeEigenMatrixMap hessian = iDynTree::toEigen(m_hessian);
+        iDynTree::iDynTreeEigenVector gradient = iDynTree::toEigen(m_gradient);
+        iDynTree::iDynTreeEigenMatrixMap costJacobian = iDynTree::toEigen(m_costJacobian);
+
+        hessian.noalias() = costJacobian.transpose() * iDynTree::toEigen(m_costWeights).asDiagonal() * costJacobian;
+        gradient.noalias() = -costJacobian.transpose() * iDynTree::toEigen(m_costWeights).cwiseProduct(iDynTree::toEigen(m_costReference));
+
+        Eigen::Index dofs = static_cast<Eigen::Index>(m_dofs);
+        hessian.diagonal().tail(dofs) += iDynTree::toEigen(*m_problem.preferredJointsWeight);
+        gradient.tail(dofs) -= *m_problem.gain * iDynTree::toEigen(*m_problem.preferredJointsWeight).cwiseProduct(
+            iDynTree::toEigen(*m_problem.preferredJointsConfiguration) - iDynTree::toEigen(*m_problem.jointInitialConditions));
+        hessian.diagonal().array() += *m_problem.damping;
+
+        m_infoData->hasLinearConstraints = true;
+        m_infoData->hasNonLinearConstraints = false;
+        m_infoData->costIsLinear = false;
+        m_infoData->costIsQuadratic = true;
+        m_infoData->costIsNonLinear = false;
+        m_infoData->hasSparseConstraintJacobian = true;
+        m_infoData->hasSparseHessian = true;
+        m_infoData->hessianIsProvided = true;
+        // The Jacobians change with the linearization point
+        m_infoData->hessianIsUnchanged = false;
+        m_infoData->constraintsJacobianIsUnchanged = false;
+
+        return true;
+    }
+
+    unsigned int DifferentialInverseKinematicsQP::numberOfVariables()
+    {
+        return static_cast<unsigned int>(m_numberOfVariables);
+    }
+
+    unsigned int DifferentialInverseKinematicsQP::numberOfConstraints()
+    {
+        return static_cast<unsigned int>(m_numberOfConstraints);
+    }
+
+    bool DifferentialInverseKinematicsQP::getConstraintsBounds(iDynTree::VectorDynSize& constraintsLowerBounds, iDynTree::VectorDynSize& constraintsUpperBounds)
+    {
+        constraintsLowerBounds = m_constraintsLowerBounds;
+        constraintsUpperBounds = m_constraintsUpperBounds;
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::getVariablesUpperBound(iDynTree::VectorDynSize& variablesUpperBound)
+    {
+        variablesUpperBound.resize(m_numberOfVariables);
+        for (size_t i = 0; i < 6; ++i) {
+            variablesUpperBound(i) = infinity;
+        }
+        for (size_t i = 0; i < m_dofs; ++i) {
+            variablesUpperBound(6 + i) = (*m_problem.fixedJoints)[i] ?
+                0.0 : (*m_problem.jointLimits)[i].second - (*m_problem.jointInitialConditions)(i);
+        }
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::getVariablesLowerBound(iDynTree::VectorDynSize& variablesLowerBound)
+    {
+        variablesLowerBound.resize(m_numberOfVariables);
+        for (size_t i = 0; i < 6; ++i) {
+            variablesLowerBound(i) = -infinity;
+        }
+        for (size_t i = 0; i < m_dofs; ++i) {
+            variablesLowerBound(6 + i) = (*m_problem.fixedJoints)[i] ?
+                0.0 : (*m_problem.jointLimits)[i].first - (*m_problem.jointInitialConditions)(i);
+        }
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::getConstraintsJacobianInfo(std::vector<size_t>& nonZeroElementRows, std::vector<size_t>& nonZeroElementColumns)
+    {
+        nonZeroElementRows = m_jacobianNonZeroRows;
+        nonZeroElementColumns = m_jacobianNonZeroColumns;
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::getHessianInfo(std::vector<size_t>& nonZeroElementRows, std::vector<size_t>& nonZeroElementColumns)
+    {
+        nonZeroElementRows = m_hessianNonZeroRows;
+        nonZeroElementColumns = m_hessianNonZeroColumns;
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::setVariables(const iDynTree::VectorDynSize& variables)
+    {
+        if (variables.size() != m_numberOfVariables) {
+            iDynTree::reportError("DifferentialInverseKinematicsQP", "setVariables", "The input variables have a dimension different from the expected one.");
+            return false;
+        }
+        m_variables = variables;
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::evaluateCostFunction(double& costValue)
+    {
+        iDynTree::iDynTreeEigenVector delta = iDynTree::toEigen(m_variables);
+        costValue = 0.5 * delta.dot(iDynTree::toEigen(m_hessian) * delta) + iDynTree::toEigen(m_gradient).dot(delta);
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::evaluateCostGradient(iDynTree::VectorDynSize& gradient)
+    {
+        gradient.resize(m_numberOfVariables);
+        iDynTree::toEigen(gradient).noalias() = iDynTree::toEigen(m_hessian) * iDynTree::toEigen(m_variables);
+        iDynTree::toEigen(gradient) += iDynTree::toEigen(m_gradient);
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::evaluateCostHessian(iDynTree::MatrixDynSize& hessian)
+    {
+        hessian = m_hessian;
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::evaluateConstraints(iDynTree::VectorDynSize& constraints)
+    {
+        constraints.resize(m_numberOfConstraints);
+        iDynTree::toEigen(constraints).noalias() = iDynTree::toEigen(m_constraintsJacobian) * iDynTree::toEigen(m_variables);
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::evaluateConstraintsJacobian(iDynTree::MatrixDynSize& jacobian)
+    {
+        jacobian = m_constraintsJacobian;
+        return true;
+    }
+
+    bool DifferentialInverseKinematicsQP::evaluateConstraintsHessian(const iDynTree::VectorDynSize& /*constraintsMultipliers*/, iDynTree::MatrixDynSize& hessian)
+    {
+        hessian.resize(m_numberOfVariables, m_numberOfVariables);
+        hessian.zero();
+        return true;
+    }
+
+}
+}
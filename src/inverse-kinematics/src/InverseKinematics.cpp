@@ -290,6 +290,100 @@ namespace iDynTree {
 #endif
     }
 
+    void InverseKinematics::setHessianApproximation(const enum InverseKinematicsHessianApproximation hessianApproximation)
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        IK_PIMPL(m_pimpl)->m_hessianApproximation = hessianApproximation;
+#else
+        missingIpoptErrorReport();
+#endif
+    }
+
+    enum InverseKinematicsHessianApproximation InverseKinematics::hessianApproximation() const
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        return IK_PIMPL(m_pimpl)->m_hessianApproximation;
+#else
+        missingIpoptErrorReport();
+        return InverseKinematicsHessianApproximationLimitedMemory;
+#endif
+    }
+
+    bool InverseKinematics::setSolverMode(const enum InverseKinematicsSolverMode mode)
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        return IK_PIMPL(m_pimpl)->setSolverMode(mode);
+#else
+        return missingIpoptErrorReport();
+#endif
+    }
+
+    enum InverseKinematicsSolverMode InverseKinematics::solverMode() const
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        return IK_PIMPL(m_pimpl)->m_solverMode;
+#else
+        missingIpoptErrorReport();
+        return InverseKinematicsSolverModeNonlinear;
+#endif
+    }
+
+    bool InverseKinematics::setDifferentialModeGain(const double gain)
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        if (!(gain > 0.0 && gain <= 1.0)) {
+            reportError("InverseKinematics", "setDifferentialModeGain", "The gain is expected to be in (0, 1].");
+            return false;
+        }
+        IK_PIMPL(m_pimpl)->m_differentialGain = gain;
+        return true;
+#else
+        return missingIpoptErrorReport();
+#endif
+    }
+
+    double InverseKinematics::differentialModeGain() const
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        return IK_PIMPL(m_pimpl)->m_differentialGain;
+#else
+        missingIpoptErrorReport();
+        return 0.0;
+#endif
+    }
+
+    bool InverseKinematics::setDifferentialModeDamping(const double damping)
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        if (damping < 0.0) {
+            reportError("InverseKinematics", "setDifferentialModeDamping", "The damping is expected to be non negative.");
+            return false;
+        }
+        IK_PIMPL(m_pimpl)->m_differentialDamping = damping;
+        return true;
+#else
+        return missingIpoptErrorReport();
+#endif
+    }
+
+    double InverseKinematics::differentialModeDamping() const
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        return IK_PIMPL(m_pimpl)->m_differentialDamping;
+#else
+        missingIpoptErrorReport();
+        return 0.0;
+#endif
+    }
+
     bool InverseKinematics::addFrameConstraint(const std::string& frameName)
     {
 #ifdef IDYNTREE_USES_IPOPT
@@ -1158,6 +1252,38 @@ namespace iDynTree {
 #endif
     }
 
+    bool InverseKinematics::setNrOfWorkerThreads(const size_t nrOfWorkerThreads)
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        return IK_PIMPL(m_pimpl)->m_workerPool.resize(nrOfWorkerThreads);
+#else
+        return missingIpoptErrorReport();
+#endif
+    }
+
+    size_t InverseKinematics::getNrOfWorkerThreads() const
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        return IK_PIMPL(m_pimpl)->m_workerPool.getNrOfWorkerThreads();
+#else
+        missingIpoptErrorReport();
+        return 0;
+#endif
+    }
+
+    bool InverseKinematics::solveBatch(const std::vector<InverseKinematicsBatchProblem>& problems,
+                                       std::vector<InverseKinematicsBatchSolution>& solutions)
+    {
+#ifdef IDYNTREE_USES_IPOPT
+        assert(m_pimpl);
+        return IK_PIMPL(m_pimpl)->solveBatch(problems, solutions);
+#else
+        return missingIpoptErrorReport();
+#endif
+    }
+
     void InverseKinematics::getFullJointsSolution(iDynTree::Transform & baseTransformSolution,
                                                   iDynTree::VectorDynSize & shapeSolution)
     {
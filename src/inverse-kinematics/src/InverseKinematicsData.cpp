@@ -10,8 +10,18 @@
 #include <iDynTree/SpatialAcc.h>
 #include <iDynTree/ModelLoader.h>
 #include <iDynTree/EigenHelpers.h>
+#include <iDynTree/Utils.h>
 
+#ifdef IDYNTREE_COMPILES_OPTIMALCONTROL
+#include "DifferentialInverseKinematicsQP.h"
+#include <iDynTree/Optimizers/OsqpInterface.h>
+#endif
+
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <limits>
+#include <sstream>
 #include <private/InverseKinematicsData.h>
 
 namespace internal {
@@ -26,6 +36,7 @@ namespace kinematics {
     , m_rotationParametrization(iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw)
     , m_areBaseInitialConditionsSet(false)
     , m_areJointsInitialConditionsSet(InverseKinematicsInitialConditionNotSet)
+    , m_optimalCost(0)
     , m_problemInitialized(false)
     , m_warmStartEnabled(false)
     , m_numberOfOptimisationVariables(0)
@@ -40,6 +51,10 @@ namespace kinematics {
     , m_tol(1e-8)
     , m_constrTol(1e-4)
     , m_verbosityLevel(0)
+    , m_hessianApproximation(iDynTree::InverseKinematicsHessianApproximationLimitedMemory)
+    , m_solverMode(iDynTree::InverseKinematicsSolverModeNonlinear)
+    , m_differentialGain(1.0)
+    , m_differentialDamping(1e-6)
     {
         //These variables are touched only once.
         m_state.worldGravity.zero();
@@ -157,6 +172,11 @@ namespace kinematics {
         m_comTarget.constraintTolerance = 1e-8;
 
         m_problemInitialized = false;
+        disableWarmStart();
+    }
+
+    void InverseKinematicsData::disableWarmStart()
+    {
         if (m_warmStartEnabled) {
             m_warmStartEnabled = false;
             if (!Ipopt::IsNull(m_solver)) {
@@ -332,8 +352,59 @@ namespace kinematics {
         return target->second.targetResolutionMode();
     }
 
+    bool InverseKinematicsData::setSolverMode(enum iDynTree::InverseKinematicsSolverMode mode)
+    {
+        if (mode == iDynTree::InverseKinematicsSolverModeDifferential) {
+#ifdef IDYNTREE_COMPILES_OPTIMALCONTROL
+            if (!m_differentialSolver) {
+                std::shared_ptr<iDynTree::optimization::OsqpInterface> solver = std::make_shared<iDynTree::optimization::OsqpInterface>();
+                if (!solver->isAvailable()) {
+                    iDynTree::reportError("InverseKinematics", "setSolverMode", "The differential mode needs iDynTree to be compiled with OSQP.");
+                    return false;
+                }
+                // The QP reads the problem from this object each time it is prepared
+                internal::kinematics::DifferentialInverseKinematicsProblem problem;
+                problem.dynamics = &m_dynamics;
+                problem.constraints = &m_constraints;
+                problem.targets = &m_targets;
+                problem.comHullConstraint = &m_comHullConstraint;
+                problem.comTargetIsActive = &m_comTarget.isActive;
+                problem.comTargetIsConstraint = &m_comTarget.isConstraint;
+                problem.comTargetDesiredPosition = &m_comTarget.desiredPosition;
+                problem.comTargetWeight = &m_comTarget.weight;
+                problem.comTargetConstraintTolerance = &m_comTarget.constraintTolerance;
+                problem.baseInitialCondition = &m_baseInitialCondition;
+                problem.jointInitialConditions = &m_jointInitialConditions;
+                problem.jointLimits = &m_jointLimits;
+                problem.fixedJoints = &m_reducedVariablesInfo.fixedVariables;
+                problem.preferredJointsConfiguration = &m_preferredJointsConfiguration;
+                problem.preferredJointsWeight = &m_preferredJointsWeight;
+                problem.gain = &m_differentialGain;
+                problem.damping = &m_differentialDamping;
+                m_differentialProblem = std::make_shared<internal::kinematics::DifferentialInverseKinematicsQP>(problem);
+                if (!solver->setProblem(m_differentialProblem)) {
+                    m_differentialProblem.reset();
+                    return false;
+                }
+                m_differentialSolver = solver;
+                // The QP has to be initialized with the current targets and constraints
+                m_problemInitialized = false;
+            }
+#else
+            iDynTree::reportError("InverseKinematics", "setSolverMode", "The differential mode needs iDynTree to be compiled with the optimal control component.");
+            return false;
+#endif
+        }
+        m_solverMode = mode;
+        return true;
+    }
+
     bool InverseKinematicsData::solveProblem()
     {
+        if (m_solverMode == iDynTree::InverseKinematicsSolverModeDifferential) {
+            return solveDifferentialProblem();
+        }
+
         Ipopt::ApplicationReturnStatus solverStatus;
 
         if (Ipopt::IsNull(m_solver)) {
@@ -342,7 +413,6 @@ namespace kinematics {
             //TODO: set options
             //For example, one needed option is the linear solver type
             //Best thing is to wrap the IPOPT options with new structure so as to abstract them
-            m_solver->Options()->SetStringValue("hessian_approximation", "limited-memory");
             m_solver->Options()->SetIntegerValue("print_level",m_verbosityLevel);
             m_solver->Options()->SetIntegerValue("max_iter", m_maxIter);
             m_solver->Options()->SetNumericValue("max_cpu_time", m_maxCpuTime);
@@ -376,6 +446,8 @@ namespace kinematics {
         }
 
         prepareForOptimization();
+        // The Hessian approximation can be changed between two calls, so the option is set every time
+        m_solver->Options()->SetStringValue("hessian_approximation", isExactHessianActive() ? "exact" : "limited-memory");
         // Ask Ipopt to solve the problem
         solverStatus = m_solver->OptimizeTNLP(m_nlpProblem);
 
@@ -390,6 +462,237 @@ namespace kinematics {
         }
     }
 
+    bool InverseKinematicsData::solveDifferentialProblem()
+    {
+#ifdef IDYNTREE_COMPILES_OPTIMALCONTROL
+        assert(m_differentialProblem && m_differentialSolver);
+
+        if (!m_problemInitialized) {
+            computeProblemSizeAndResizeBuffers();
+        }
+
+        prepareForOptimization();
+
+        // The iterations and the time of the QP solver are bounded by the same parameters of the NLP
+        iDynTree::optimization::OsqpSettings& settings = m_differentialSolver->settings();
+        settings.verbose = m_verbosityLevel > 0;
+        settings.max_iter = static_cast<unsigned int>(m_maxIter);
+        settings.time_limit = m_maxCpuTime;
+
+        if (!m_differentialSolver->solve()) {
+            return false;
+        }
+
+        if (!m_differentialSolver->getPrimalVariables(m_differentialIncrements)) {
+            return false;
+        }
+
+        m_differentialProblem->applyIncrements(m_differentialIncrements, m_baseResults, m_jointsResults);
+
+        // The next call is linearized around this solution
+        m_baseInitialCondition = m_baseResults;
+        m_areBaseInitialConditionsSet = true;
+        m_jointInitialConditions = m_jointsResults;
+        m_areJointsInitialConditionsSet = InverseKinematicsInitialConditionFull;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool InverseKinematicsData::copyProblemFrom(const InverseKinematicsData& other)
+    {
+        bool result = m_dynamics.loadRobotModel(other.m_dynamics.model())
+                      && m_dynamics.setFloatingBase(other.m_dynamics.getFloatingBase());
+        if (!result || !m_dynamics.isValid()) {
+            iDynTree::reportError("InverseKinematics", "copyProblemFrom", "Error loading robot model");
+            return false;
+        }
+
+        m_dofs = other.m_dofs;
+        m_reducedVariablesInfo.fixedVariables = other.m_reducedVariablesInfo.fixedVariables;
+        m_reducedVariablesInfo.modelJointsToOptimisedJoints = other.m_reducedVariablesInfo.modelJointsToOptimisedJoints;
+        m_jointLimits = other.m_jointLimits;
+        m_state.jointsConfiguration = other.m_state.jointsConfiguration;
+        m_state.basePose = other.m_state.basePose;
+        m_state.jointsVelocity = other.m_state.jointsVelocity;
+        m_state.baseTwist = other.m_state.baseTwist;
+        m_state.worldGravity = other.m_state.worldGravity;
+
+        m_rotationParametrization = other.m_rotationParametrization;
+        m_defaultTargetResolutionMode = other.m_defaultTargetResolutionMode;
+        m_constraints = other.m_constraints;
+        m_targets = other.m_targets;
+        m_comTarget.isActive = other.m_comTarget.isActive;
+        m_comTarget.desiredPosition = other.m_comTarget.desiredPosition;
+        m_comTarget.weight = other.m_comTarget.weight;
+        m_comTarget.isConstraint = other.m_comTarget.isConstraint;
+        m_comTarget.constraintTolerance = other.m_comTarget.constraintTolerance;
+        m_comHullConstraint = other.m_comHullConstraint;
+        m_comHullConstraint_projDirection = other.m_comHullConstraint_projDirection;
+        m_comHullConstraint_supportFramesIndeces = other.m_comHullConstraint_supportFramesIndeces;
+        m_comHullConstraint_supportPolygons = other.m_comHullConstraint_supportPolygons;
+        m_comHullConstraint_xAxisOfPlaneInWorld = other.m_comHullConstraint_xAxisOfPlaneInWorld;
+        m_comHullConstraint_yAxisOfPlaneInWorld = other.m_comHullConstraint_yAxisOfPlaneInWorld;
+        m_comHullConstraint_originOfPlaneInWorld = other.m_comHullConstraint_originOfPlaneInWorld;
+        m_preferredJointsConfiguration = other.m_preferredJointsConfiguration;
+        m_preferredJointsWeight = other.m_preferredJointsWeight;
+
+        m_areBaseInitialConditionsSet = other.m_areBaseInitialConditionsSet;
+        m_areJointsInitialConditionsSet = other.m_areJointsInitialConditionsSet;
+        m_baseInitialCondition = other.m_baseInitialCondition;
+        m_jointInitialConditions = other.m_jointInitialConditions;
+        m_baseResults = other.m_baseResults;
+        m_jointsResults = other.m_jointsResults;
+
+        m_maxIter = other.m_maxIter;
+        m_maxCpuTime = other.m_maxCpuTime;
+        m_tol = other.m_tol;
+        m_constrTol = other.m_constrTol;
+        m_verbosityLevel = other.m_verbosityLevel;
+        m_solverName = other.m_solverName;
+        m_hessianApproximation = other.m_hessianApproximation;
+        m_solverMode = iDynTree::InverseKinematicsSolverModeNonlinear;
+
+        // The options of IPOPT are set when the solver is created, so it is created again with the new parameters
+        m_solver = NULL;
+        m_warmStartEnabled = false;
+        m_problemInitialized = false;
+
+        updateRobotConfiguration();
+        return true;
+    }
+
+    void InverseKinematicsData::solveBatchProblem(const InverseKinematicsData& templateData,
+                                                  const iDynTree::InverseKinematicsBatchProblem& problem,
+                                                  iDynTree::InverseKinematicsBatchSolution& solution)
+    {
+        solution.isValid = false;
+        solution.cost = std::numeric_limits<double>::infinity();
+        solution.bestStart = 0;
+        solution.nrOfSuccessfulStarts = 0;
+        solution.nrOfIterations = 0;
+        solution.solveTime = 0;
+        solution.nrOfStarts = std::max<size_t>(1, std::max(problem.initialBaseTransforms.size(),
+                                                           problem.initialJointsConfigurations.size()));
+
+        // The targets of the previous problem are overwritten (the structure of the problem does not change)
+        m_targets = templateData.m_targets;
+        for (size_t i = 0; i < problem.targetFrames.size(); ++i) {
+            TransformMap::iterator target = getTargetRefIfItExists(problem.targetFrames[i]);
+            assert(target != m_targets.end());
+            target->second.setPosition(problem.targetTransforms[i].getPosition());
+            target->second.setRotation(problem.targetTransforms[i].getRotation());
+        }
+
+        for (size_t start = 0; start < solution.nrOfStarts; ++start) {
+            if (problem.initialBaseTransforms.empty()) {
+                m_baseInitialCondition = templateData.m_baseInitialCondition;
+                m_areBaseInitialConditionsSet = templateData.m_areBaseInitialConditionsSet;
+            } else {
+                m_baseInitialCondition = problem.initialBaseTransforms[start];
+                m_areBaseInitialConditionsSet = true;
+            }
+
+            if (problem.initialJointsConfigurations.empty()) {
+                m_jointInitialConditions = templateData.m_jointInitialConditions;
+                m_areJointsInitialConditionsSet = templateData.m_areJointsInitialConditionsSet;
+            } else {
+                m_jointInitialConditions = problem.initialJointsConfigurations[start];
+                m_areJointsInitialConditionsSet = InverseKinematicsInitialConditionFull;
+            }
+
+            // Each start must not depend on the solution of the previous one
+            disableWarmStart();
+
+            std::chrono::steady_clock::time_point tic = std::chrono::steady_clock::now();
+            bool solved = solveProblem();
+            solution.solveTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - tic).count();
+
+            if (!Ipopt::IsNull(m_solver)) {
+                Ipopt::SmartPtr<Ipopt::SolveStatistics> statistics = m_solver->Statistics();
+                if (Ipopt::IsValid(statistics)) {
+                    solution.nrOfIterations += static_cast<size_t>(statistics->IterationCount());
+                }
+            }
+
+            if (!solved) {
+                continue;
+            }
+
+            solution.nrOfSuccessfulStarts++;
+            if (!solution.isValid || m_optimalCost < solution.cost) {
+                solution.isValid = true;
+                solution.cost = m_optimalCost;
+                solution.bestStart = start;
+                solution.baseTransform = m_baseResults;
+                solution.jointsConfiguration = m_jointsResults;
+            }
+        }
+    }
+
+    bool InverseKinematicsData::solveBatch(const std::vector<iDynTree::InverseKinematicsBatchProblem>& problems,
+                                           std::vector<iDynTree::InverseKinematicsBatchSolution>& solutions)
+    {
+        for (size_t problemIndex = 0; problemIndex < problems.size(); ++problemIndex) {
+            const iDynTree::InverseKinematicsBatchProblem& problem = problems[problemIndex];
+            std::ostringstream errorMsg;
+
+            if (problem.targetFrames.size() != problem.targetTransforms.size()) {
+                errorMsg << "Problem " << problemIndex << " has " << problem.targetFrames.size()
+                         << " target frames, but " << problem.targetTransforms.size() << " target transforms.";
+            }
+            for (const std::string& frameName : problem.targetFrames) {
+                if (getTargetRefIfItExists(frameName) == m_targets.end()) {
+                    errorMsg << "Problem " << problemIndex << " uses the frame " << frameName << " that is not a target.";
+                    break;
+                }
+            }
+            if (!problem.initialBaseTransforms.empty() && !problem.initialJointsConfigurations.empty()
+                && problem.initialBaseTransforms.size() != problem.initialJointsConfigurations.size()) {
+                errorMsg << "Problem " << problemIndex << " has a different number of initial base transforms and of initial joints configurations.";
+            }
+            for (const iDynTree::VectorDynSize& initialJoints : problem.initialJointsConfigurations) {
+                if (initialJoints.size() != m_dofs) {
+                    errorMsg << "Problem " << problemIndex << " has an initial joints configuration of size " << initialJoints.size()
+                             << ", while the model has " << m_dofs << " DoFs.";
+                    break;
+                }
+            }
+
+            if (!errorMsg.str().empty()) {
+                iDynTree::reportError("InverseKinematics", "solveBatch", errorMsg.str().c_str());
+                return false;
+            }
+        }
+
+        // A copy of the problem for each thread, including the calling one
+        size_t nrOfWorkspaces = m_workerPool.getNrOfWorkerThreads() + 1;
+        m_batchWorkspaces.resize(nrOfWorkspaces);
+        for (std::unique_ptr<InverseKinematicsData>& workspace : m_batchWorkspaces) {
+            if (!workspace) {
+                workspace.reset(new InverseKinematicsData());
+            }
+            if (!workspace->copyProblemFrom(*this)) {
+                return false;
+            }
+        }
+
+        solutions.resize(problems.size());
+
+        // The problems are assigned to the workspaces one at a time, as the time to solve them varies a lot
+        std::atomic<size_t> nextProblem(0);
+        auto solveProblems = [&](size_t workspaceIndex) {
+            InverseKinematicsData& workspace = *m_batchWorkspaces[workspaceIndex];
+            for (size_t problemIndex = nextProblem.fetch_add(1); problemIndex < problems.size(); problemIndex = nextProblem.fetch_add(1)) {
+                workspace.solveBatchProblem(*this, problems[problemIndex], solutions[problemIndex]);
+            }
+        };
+        m_workerPool.run(nrOfWorkspaces, solveProblems);
+
+        return true;
+    }
+
     void InverseKinematicsData::setCoMTarget(const iDynTree::Position& desiredPosition, double weight){
         this->m_comTarget.desiredPosition = desiredPosition;
 
@@ -431,6 +734,13 @@ namespace kinematics {
         this->m_comTarget.desiredPosition.zero();
     }
 
+    bool InverseKinematicsData::isExactHessianActive()
+    {
+        // The second derivatives of the center of mass are not implemented
+        return m_hessianApproximation == iDynTree::InverseKinematicsHessianApproximationExact
+            && !m_comHullConstraint.isActive() && !isCoMTargetActive();
+    }
+
     void InverseKinematicsData::computeProblemSizeAndResizeBuffers()
     {
         //Size of optimization variables is 3 + Orientation (base) + size of joints we optimize
@@ -486,6 +796,11 @@ namespace kinematics {
         m_upperBoundMultipliers.resize(m_numberOfOptimisationVariables);
         m_upperBoundMultipliers.zero();
         m_nlpProblem->initializeInternalData();
+#ifdef IDYNTREE_COMPILES_OPTIMALCONTROL
+        if (m_differentialProblem) {
+            m_differentialProblem->initializeInternalData();
+        }
+#endif
 
         m_problemInitialized = true;
     }
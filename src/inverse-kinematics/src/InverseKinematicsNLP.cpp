@@ -13,6 +13,8 @@
 
 #include <Eigen/Core>
 #include <iDynTree/EigenHelpers.h>
+#include <iDynTree/Model.h>
+#include <iDynTree/Traversal.h>
 #include <cassert>
 #include <cmath>
 
@@ -27,6 +29,93 @@ namespace kinematics {
     template<unsigned row, unsigned col>
     struct is_matrixfixsize<iDynTree::MatrixFixSize<row, col>> : std::true_type {};
 
+    namespace {
+        /*!
+         * Direct map: from omega (in the inertial frame) to the quaternion derivative
+         *
+         * \f[
+         * G(z) = \frac{1}{2} \begin{bmatrix}
+         * -r^\top \\
+         * -r^\wedge + s 1_3
+         * \end{bmatrix}.
+         * \f]
+         * Note that the map is linear in the quaternion.
+         */
+        void computeQuaternionDerivativeMap(const iDynTree::Vector4& quaternion, iDynTree::MatrixFixSize<4, 3>& quaternionDerivativeMap)
+        {
+            Eigen::Map<Eigen::Matrix<double, 4, 3, Eigen::RowMajor> > map = iDynTree::toEigen(quaternionDerivativeMap);
+            map.topRows<1>() = -iDynTree::toEigen(quaternion).tail<3>().transpose();
+            map.bottomRows<3>().setIdentity();
+            map.bottomRows<3>() *= quaternion(0);
+            map.bottomRows<3>() -= iDynTree::skew(iDynTree::toEigen(quaternion).tail<3>());
+
+            map *= 0.5;
+        }
+
+        /*!
+         * Map from omega (in the inertial frame) to the derivative of the rotation parameters.
+         * For RPY only the first 3 rows are used.
+         */
+        void computeRotationParametrizationMap(iDynTree::InverseKinematicsRotationParametrization parametrization,
+                                               const iDynTree::Vector4& rotationParameters,
+                                               iDynTree::MatrixFixSize<4, 3>& parametrizationMap)
+        {
+            parametrizationMap.zero();
+            if (parametrization == iDynTree::InverseKinematicsRotationParametrizationQuaternion) {
+                computeQuaternionDerivativeMap(rotationParameters, parametrizationMap);
+            } else if (parametrization == iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw) {
+                iDynTree::toEigen(parametrizationMap).topRows<3>() =
+                    iDynTree::toEigen(iDynTree::Rotation::RPYRightTrivializedDerivativeInverse(rotationParameters(0),
+                                                                                             rotationParameters(1),
+                                                                                             rotationParameters(2)));
+            }
+        }
+
+        /*!
+         * Derivative of computeRotationParametrizationMap along the specified variation of the rotation parameters.
+         */
+        void computeRotationParametrizationMapDerivative(iDynTree::InverseKinematicsRotationParametrization parametrization,
+                                                         const iDynTree::Vector4& rotationParameters,
+                                                         const iDynTree::Vector4& rotationParametersVariation,
+                                                         iDynTree::MatrixFixSize<4, 3>& parametrizationMapDerivative)
+        {
+            parametrizationMapDerivative.zero();
+            if (parametrization == iDynTree::InverseKinematicsRotationParametrizationQuaternion) {
+                computeQuaternionDerivativeMap(rotationParametersVariation, parametrizationMapDerivative);
+            } else if (parametrization == iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw) {
+                iDynTree::toEigen(parametrizationMapDerivative).topRows<3>() =
+                    iDynTree::toEigen(iDynTree::Rotation::RPYRightTrivializedDerivativeInverseRateOfChange(rotationParameters(0),
+                                                                                                         rotationParameters(1),
+                                                                                                         rotationParameters(2),
+                                                                                                         rotationParametersVariation(0),
+                                                                                                         rotationParametersVariation(1),
+                                                                                                         rotationParametersVariation(2)));
+            }
+        }
+
+        void getRotationParameters(iDynTree::InverseKinematicsRotationParametrization parametrization,
+                                   const iDynTree::Rotation& rotation,
+                                   iDynTree::Vector4& rotationParameters)
+        {
+            rotationParameters.zero();
+            if (parametrization == iDynTree::InverseKinematicsRotationParametrizationQuaternion) {
+                rotation.getQuaternion(rotationParameters);
+            } else if (parametrization == iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw) {
+                rotation.getRPY(rotationParameters(0), rotationParameters(1), rotationParameters(2));
+            }
+        }
+
+        void computeNonZeroColumns(const iDynTree::MatrixDynSize& sparsityPattern, std::vector<size_t>& columns)
+        {
+            columns.clear();
+            for (size_t col = 0; col < sparsityPattern.cols(); ++col) {
+                if (!iDynTree::toEigen(sparsityPattern).col(col).isZero()) {
+                    columns.push_back(col);
+                }
+            }
+        }
+    }
+
     //MARK: - SparsityHelper implementation
 
     const std::vector<size_t> SparsityHelper::s_nullVector = std::vector<size_t>();
@@ -189,6 +278,33 @@ namespace kinematics {
         finalJacobianBuffer.resize((3 + sizeOfRotationParametrization(m_data.m_rotationParametrization)),
                                    3 + sizeOfRotationParametrization(m_data.m_rotationParametrization) + m_data.m_dofs);
 
+        //buffers for the exact Hessian
+        size_t numberOfVariables = 3 + sizeOfRotationParametrization(m_data.m_rotationParametrization) + m_data.m_dofs;
+        hessianBuffer.resize(numberOfVariables, numberOfVariables);
+        generatorsHessianBuffer.resize(6 + m_data.m_dofs, 6 + m_data.m_dofs);
+        mappedGeneratorsHessianBuffer.resize(6 + m_data.m_dofs, numberOfVariables);
+        velocityToVariablesMapBuffer.resize(6 + m_data.m_dofs, numberOfVariables);
+        velocityToVariablesMapBuffer.zero();
+        //the base position and the joints are mapped with the identity,
+        //the base orientation block depends on the configuration
+        iDynTree::toEigen(velocityToVariablesMapBuffer).topLeftCorner<3, 3>().setIdentity();
+        iDynTree::toEigen(velocityToVariablesMapBuffer).bottomRightCorner(m_data.m_dofs, m_data.m_dofs).setIdentity();
+
+        //A joint can move the axis of another joint only if it comes before in the path from the base
+        const iDynTree::Model& model = m_data.m_dynamics.model();
+        iDynTree::Traversal traversal;
+        model.computeFullTreeTraversal(traversal, model.getLinkIndex(m_data.m_dynamics.getFloatingBase()));
+        std::vector<size_t> linksDepth(model.getNrOfLinks(), 0);
+        dofsDepth.assign(m_data.m_dofs, 0);
+        for (iDynTree::TraversalIndex traversalEl = 1; traversalEl < static_cast<iDynTree::TraversalIndex>(traversal.getNrOfVisitedLinks()); ++traversalEl) {
+            const iDynTree::IJoint* joint = traversal.getParentJoint(traversalEl);
+            iDynTree::LinkIndex link = traversal.getLink(traversalEl)->getIndex();
+            linksDepth[link] = linksDepth[traversal.getParentLink(traversalEl)->getIndex()] + joint->getNrOfDOFs();
+            for (unsigned dof = 0; dof < joint->getNrOfDOFs(); ++dof) {
+                dofsDepth[joint->getDOFsOffset() + dof] = linksDepth[link];
+            }
+        }
+
         constraintsInfo.clear();
         targetsInfo.clear();
 
@@ -197,6 +313,8 @@ namespace kinematics {
              target != m_data.m_targets.end(); ++target) {
             FrameInfo info;
             info.jacobian.resize(6, m_data.m_dofs + 6);
+            m_data.dynamics().getFrameFreeFloatingJacobianSparsityPattern(target->first, info.jacobian);
+            computeNonZeroColumns(info.jacobian, info.jacobianColumns);
             info.jacobian.zero();
             targetsInfo.insert(FrameInfoMap::value_type(target->first, info));
         }
@@ -205,6 +323,8 @@ namespace kinematics {
              constraint != m_data.m_constraints.end(); ++constraint) {
             FrameInfo info;
             info.jacobian.resize(6, m_data.m_dofs + 6);
+            m_data.dynamics().getFrameFreeFloatingJacobianSparsityPattern(constraint->first, info.jacobian);
+            computeNonZeroColumns(info.jacobian, info.jacobianColumns);
             info.jacobian.zero();
             constraintsInfo.insert(FrameInfoMap::value_type(constraint->first, info));
         }
@@ -219,7 +339,8 @@ namespace kinematics {
     }
 
 void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
-                                                               const internal::kinematics::TransformConstraint& constraint)
+                                                               const internal::kinematics::TransformConstraint& constraint,
+                                                               int computationOption)
     {
         //For each constraint compute its jacobian pattern
         FrameInfo &constraintInfo = constraintsInfo[constraintID];
@@ -287,11 +408,12 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
 
         //Now that we computed the actual Jacobian needed by IPOPT
         //We have to assign it to the correct variable
-        if (constraint.hasPositionConstraint()) {
+        //The rows must be the same of eval_g, i.e. only the parts enforced as constraints
+        if ((computationOption & ComputeContraintJacobianOptionLinearPart) && constraint.hasPositionConstraint()) {
             //Position part
             m_jacobianSparsityHelper.addConstraintSparsityPattern(finalJacobianBuffer, {0, 3});
         }
-        if (constraint.hasRotationConstraint()) {
+        if ((computationOption & ComputeContraintJacobianOptionAngularPart) && constraint.hasRotationConstraint()) {
             //Orientation part
             m_jacobianSparsityHelper.addConstraintSparsityPattern(finalJacobianBuffer, {3, sizeOfRotationParametrization(m_data.m_rotationParametrization)});
         }
@@ -304,7 +426,8 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
         for (TransformMap::const_iterator constraint = m_data.m_constraints.begin();
              constraint != m_data.m_constraints.end(); ++constraint) {
             if (constraint->second.isActive()) {
-                addSparsityInformationForConstraint(constraint->first, constraint->second);
+                addSparsityInformationForConstraint(constraint->first, constraint->second,
+                                                    ComputeContraintJacobianOptionLinearPart | ComputeContraintJacobianOptionAngularPart);
             }
         }
 
@@ -343,7 +466,7 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
 
                 if (computationOption == 0) continue; // no need for further computations
 
-                addSparsityInformationForConstraint(target->first, target->second);
+                addSparsityInformationForConstraint(target->first, target->second, computationOption);
             }
 
         }
@@ -357,8 +480,66 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
             m_jacobianSparsityHelper.addConstraintSparsityPattern(baseQuaternionConstraint);
         }
 
+        //Hessian of the Lagrangian (lower triangular part)
+        m_hessianSparsityHelper.clear();
+        Ipopt::Index baseSize = 3 + sizeOfRotationParametrization(m_data.m_rotationParametrization);
+        iDynTree::MatrixDynSize hessianPattern(baseSize + m_data.m_dofs, baseSize + m_data.m_dofs);
+        hessianPattern.zero();
+
+        //The base orientation parametrization has nonzero second derivatives (and the quaternion its norm constraint)
+        for (Ipopt::Index row = 3; row < baseSize; ++row) {
+            for (Ipopt::Index col = 3; col <= row; ++col) {
+                hessianPattern(row, col) = 1.0;
+            }
+        }
+        //Joints regularization
+        for (Ipopt::Index row = baseSize; row < baseSize + static_cast<Ipopt::Index>(m_data.m_dofs); ++row) {
+            hessianPattern(row, row) = 1.0;
+        }
+        //Each frame couples all the variables which move it
+        for (TransformMap::const_iterator constraint = m_data.m_constraints.begin();
+             constraint != m_data.m_constraints.end(); ++constraint) {
+            if (constraint->second.isActive()) {
+                addHessianSparsityForFrame(constraintsInfo[constraint->first], hessianPattern);
+            }
+        }
+        for (TransformMap::const_iterator target = m_data.m_targets.begin();
+             target != m_data.m_targets.end(); ++target) {
+            addHessianSparsityForFrame(targetsInfo[target->first], hessianPattern);
+        }
+
+        m_hessianSparsityHelper.addConstraintSparsityPattern(hessianPattern);
+    }
+
+    void InverseKinematicsNLP::addHessianSparsityForFrame(const FrameInfo& frameInfo, iDynTree::MatrixDynSize& hessianPattern)
+    {
+        Ipopt::Index baseSize = 3 + sizeOfRotationParametrization(m_data.m_rotationParametrization);
 
+        //Optimization variables corresponding to the nonzero columns of the Jacobian
+        std::vector<size_t> variables;
+        bool baseOrientationAdded = false;
+        for (size_t column : frameInfo.jacobianColumns) {
+            if (column < 3) {
+                variables.push_back(column);
+            } else if (column < 6) {
+                if (!baseOrientationAdded) {
+                    for (Ipopt::Index i = 3; i < baseSize; ++i) {
+                        variables.push_back(i);
+                    }
+                    baseOrientationAdded = true;
+                }
+            } else {
+                variables.push_back(baseSize + column - 6);
+            }
+        }
 
+        for (size_t row : variables) {
+            for (size_t col : variables) {
+                if (col <= row) {
+                    hessianPattern(row, col) = 1.0;
+                }
+            }
+        }
     }
 
     bool InverseKinematicsNLP::updateState(const Ipopt::Number * x)
@@ -473,25 +654,9 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
             iDynTree::Vector4 transformQuat;
             frameInfo.transform.getRotation().getQuaternion(transformQuat);
             //compute quaternionDerivativeMapBuffer
-            /*!
-             * Direct map: from omega to quaternion derivative to omega
-             * As this depends on the frame we have to compute it for each frame
-             *
-             * \f[
-             * G(z) = \frac{1}{2} \begin{bmatrix}
-             * -r^\top \\
-             * r^\wedge + s 1_3
-             * \end{bmatrix}.
-             * \f]
-             */
-
-            Eigen::Map<Eigen::Matrix<double, 4, 3, Eigen::RowMajor> > map = iDynTree::toEigen(frameInfo.quaternionDerivativeMap);
-            map.topRows<1>() = -iDynTree::toEigen(transformQuat).tail<3>().transpose();
-            map.bottomRows<3>().setIdentity();
-            map.bottomRows<3>() *= transformQuat(0);
-            map.bottomRows<3>() -= iDynTree::skew(iDynTree::toEigen(transformQuat).tail<3>());
-
-            map *= 0.5;
+            //Direct map: from omega to quaternion derivative
+            //As this depends on the frame we have to compute it for each frame
+            computeQuaternionDerivativeMap(transformQuat, frameInfo.quaternionDerivativeMap);
         }
 
         for (TransformMap::const_iterator constraint = m_data.m_constraints.begin();
@@ -506,14 +671,7 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
                 frameInfo.transform.getRotation().getQuaternion(transformQuat);
                 //compute quaternionDerivativeMapBuffer
                 //See in target for details on the computation
-                Eigen::Map<Eigen::Matrix<double, 4, 3, Eigen::RowMajor> > map = iDynTree::toEigen(
-                        frameInfo.quaternionDerivativeMap);
-                map.topRows<1>() = -iDynTree::toEigen(transformQuat).tail<3>().transpose();
-                map.bottomRows<3>().setIdentity();
-                map.bottomRows<3>() *= transformQuat(0);
-                map.bottomRows<3>() -= iDynTree::skew(iDynTree::toEigen(transformQuat).tail<3>());
-
-                map *= 0.5;
+                computeQuaternionDerivativeMap(transformQuat, frameInfo.quaternionDerivativeMap);
             }
         }
 
@@ -542,7 +700,8 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
 
         nnz_jac_g = m_jacobianSparsityHelper.numberOfNonZeros();
 
-        nnz_h_lag = n * n; //this is currently ignored
+        //this is used only if the exact Hessian is requested
+        nnz_h_lag = m_hessianSparsityHelper.numberOfNonZeros();
 
         index_style = C_STYLE;
 
@@ -935,11 +1094,13 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
                     iDynTree::Vector4 identityQuaternion;
                     iDynTree::Rotation::Identity().getQuaternion(identityQuaternion);
 
-                    //assert(m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationQuaternion);
-
+                    //The derivative of the error quaternion is G(\tilde{Q}) omega, with omega the angular
+                    //velocity of the frame, as the desired orientation multiplies from the right
+                    iDynTree::MatrixFixSize<4, 3> errorQuaternionDerivativeMap;
+                    computeQuaternionDerivativeMap(orientationErrorQuaternion, errorQuaternionDerivativeMap);
 
                     computeConstraintJacobian(targetsInfo[target->first].jacobian,
-                                            targetsInfo[target->first].quaternionDerivativeMap,
+                                            errorQuaternionDerivativeMap,
                                             quaternionDerivativeInverseMapBuffer,
                                             ComputeContraintJacobianOptionAngularPart,
                                             finalJacobianBuffer);
@@ -1307,7 +1468,7 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
             if (m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationQuaternion) {
                 //Quaternion norm derivative
                 // = 2 * Q^\top
-                Eigen::Map<Eigen::VectorXd> quaternionDerivative(&values[constraintIndex * n], 4);
+                Eigen::Map<Eigen::VectorXd> quaternionDerivative(&values[m_jacobianSparsityHelper.totalNumberOfNonZerosBeforeRow(constraintIndex)], 4);
                 quaternionDerivative = 2 * iDynTree::toEigen(this->optimizedBaseOrientation).transpose();
                 constraintIndex++;
             }
@@ -1323,12 +1484,285 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
                                       bool new_lambda, Ipopt::Index nele_hess, Ipopt::Index* iRow,
                                       Ipopt::Index* jCol, Ipopt::Number* values)
     {
+        UNUSED_VARIABLE(new_lambda);
+        if (!values) {
+            //Define the sparsity pattern of the Hessian (lower triangular part)
+            Ipopt::Index index = 0;
+
+            for (Ipopt::Index row = 0; row < n; row++) {
+                const std::vector<size_t>& columnIndices = m_hessianSparsityHelper.nonZeroIndicesForRow(row);
+                size_t numberOfPreviousNonzeros = m_hessianSparsityHelper.totalNumberOfNonZerosBeforeRow(row);
+                for (size_t col = 0; col < columnIndices.size(); ++col) {
+                    iRow[numberOfPreviousNonzeros + col] = row;
+                    jCol[numberOfPreviousNonzeros + col] = columnIndices[col];
+                    ++index;
+                }
+            }
+            assert(nele_hess == index);
+            return true;
+        }
+
+        //The second derivatives of the center of mass are not available
+        if (!m_data.isExactHessianActive())
+            return false;
+
         if (new_x) {
+#ifndef NDEBUG
+            eval_f_called = false;
+            eval_grad_f_called = false;
+            eval_g_called = false;
+            eval_jac_g_called = false;
+#endif
+            //First time we get called with this new value for the solution
+            //Update the state and variables
             if (!updateState(x))
                 return false;
         }
-        //TODO: hessian of Lagrangian
-        return false;
+
+        const Ipopt::Index rotationSize = sizeOfRotationParametrization(m_data.m_rotationParametrization);
+        const Ipopt::Index baseSize = 3 + rotationSize;
+        Eigen::Map<const Eigen::VectorXd> multipliers(lambda, m);
+        iDynTree::iDynTreeEigenMatrixMap hessian = iDynTree::toEigen(hessianBuffer);
+        hessian.setZero();
+
+        //Regularization term on the joints
+        for (size_t i = 0; i < m_data.m_dofs; ++i) {
+            hessian(baseSize + i, baseSize + i) = obj_factor * m_data.m_preferredJointsWeight(i);
+        }
+
+        //Map from the derivative of the base orientation parametrization to the base angular velocity
+        iDynTree::Matrix3x3 RPYToOmega;
+        if (m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationQuaternion) {
+            iDynTree::toEigen(velocityToVariablesMapBuffer).block<3, 4>(3, 3) = iDynTree::toEigen(quaternionDerivativeInverseMapBuffer);
+        } else if (m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw) {
+            RPYToOmega = iDynTree::Rotation::RPYRightTrivializedDerivative(optimizedBaseOrientation(0), optimizedBaseOrientation(1), optimizedBaseOrientation(2));
+            iDynTree::toEigen(velocityToVariablesMapBuffer).block<3, 3>(3, 3) = iDynTree::toEigen(RPYToOmega);
+        }
+
+        iDynTree::Matrix3x3 identity;
+        iDynTree::toEigen(identity).setIdentity();
+        iDynTree::Vector3 positionMultipliers;
+        iDynTree::Vector4 rotationMultipliers;
+        iDynTree::Vector4 rotationParameters;
+        Ipopt::Index constraintIndex = 0;
+
+        //Constraints, in the same order of eval_g
+        for (TransformMap::const_iterator constraint = m_data.m_constraints.begin();
+             constraint != m_data.m_constraints.end(); ++constraint) {
+            if (!constraint->second.isActive()) continue;
+
+            FrameInfo &constraintInfo = constraintsInfo[constraint->first];
+            positionMultipliers.zero();
+            rotationMultipliers.zero();
+            if (constraint->second.hasPositionConstraint()) {
+                iDynTree::toEigen(positionMultipliers) = multipliers.segment<3>(constraintIndex);
+                constraintIndex += 3;
+            }
+            if (constraint->second.hasRotationConstraint()) {
+                iDynTree::toEigen(rotationMultipliers).head(rotationSize) = multipliers.segment(constraintIndex, rotationSize);
+                constraintIndex += rotationSize;
+            }
+            getRotationParameters(m_data.m_rotationParametrization, constraintInfo.transform.getRotation(), rotationParameters);
+            addFrameHessian(constraintInfo, positionMultipliers, rotationMultipliers, rotationParameters, identity, hessianBuffer);
+        }
+
+        //Targets, either as constraints or as costs
+        for (TransformMap::const_iterator target = m_data.m_targets.begin();
+             target != m_data.m_targets.end(); ++target) {
+
+            FrameInfo &targetInfo = targetsInfo[target->first];
+            const TransformConstraint& targetConstraint = target->second;
+            positionMultipliers.zero();
+            rotationMultipliers.zero();
+            getRotationParameters(m_data.m_rotationParametrization, targetInfo.transform.getRotation(), rotationParameters);
+            iDynTree::Matrix3x3 angularVelocityMap = identity;
+
+            if (targetConstraint.targetResolutionMode() & iDynTree::InverseKinematicsTreatTargetAsConstraintPositionOnly
+                && targetConstraint.hasPositionConstraint()) {
+                iDynTree::toEigen(positionMultipliers) = multipliers.segment<3>(constraintIndex);
+                constraintIndex += 3;
+            } else if ((targetConstraint.targetResolutionMode() == iDynTree::InverseKinematicsTreatTargetAsConstraintRotationOnly ||
+                        targetConstraint.targetResolutionMode() == iDynTree::InverseKinematicsTreatTargetAsConstraintNone)
+                       && targetConstraint.hasPositionConstraint()) {
+                //Cost 0.5 w || p - p^d ||^2: the Hessian is w J^T J + w (p - p^d)^T \partial^2 p
+                double weight = obj_factor * targetConstraint.getPositionWeight();
+                iDynTree::Position positionError = targetInfo.transform.getPosition() - targetConstraint.getPosition();
+                iDynTree::toEigen(positionMultipliers) = weight * iDynTree::toEigen(positionError);
+
+                if (m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationQuaternion) {
+                    computeConstraintJacobian(targetInfo.jacobian,
+                                              targetInfo.quaternionDerivativeMap,
+                                              quaternionDerivativeInverseMapBuffer,
+                                              ComputeContraintJacobianOptionLinearPart,
+                                              finalJacobianBuffer);
+                } else if (m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw) {
+                    computeConstraintJacobianRPY(targetInfo.jacobian,
+                                                 identity,
+                                                 RPYToOmega,
+                                                 ComputeContraintJacobianOptionLinearPart,
+                                                 finalJacobianBuffer);
+                }
+                hessian.noalias() += weight * iDynTree::toEigen(finalJacobianBuffer).topRows<3>().transpose() * iDynTree::toEigen(finalJacobianBuffer).topRows<3>();
+            }
+
+            if (targetConstraint.targetResolutionMode() & iDynTree::InverseKinematicsTreatTargetAsConstraintRotationOnly
+                && targetConstraint.hasRotationConstraint()) {
+                iDynTree::toEigen(rotationMultipliers).head(rotationSize) = multipliers.segment(constraintIndex, rotationSize);
+                constraintIndex += rotationSize;
+            } else if ((targetConstraint.targetResolutionMode() == iDynTree::InverseKinematicsTreatTargetAsConstraintPositionOnly ||
+                        targetConstraint.targetResolutionMode() == iDynTree::InverseKinematicsTreatTargetAsConstraintNone)
+                       && targetConstraint.hasRotationConstraint()) {
+                //Cost 0.5 w || \phi(error) - \phi(identity) ||^2 (see eval_f)
+                double weight = obj_factor * targetConstraint.getRotationWeight();
+
+                if (m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationQuaternion) {
+                    //error w_R_f * (w_R_f^d)^{-1}, whose angular velocity is the one of the frame
+                    iDynTree::Rotation rotationError = targetInfo.transform.getRotation() * targetConstraint.getRotation().inverse();
+                    getRotationParameters(m_data.m_rotationParametrization, rotationError, rotationParameters);
+                    iDynTree::Vector4 identityQuaternion;
+                    iDynTree::Rotation::Identity().getQuaternion(identityQuaternion);
+                    iDynTree::toEigen(rotationMultipliers) = weight * (iDynTree::toEigen(rotationParameters) - iDynTree::toEigen(identityQuaternion));
+
+                    iDynTree::MatrixFixSize<4, 3> errorQuaternionDerivativeMap;
+                    computeQuaternionDerivativeMap(rotationParameters, errorQuaternionDerivativeMap);
+                    computeConstraintJacobian(targetInfo.jacobian,
+                                              errorQuaternionDerivativeMap,
+                                              quaternionDerivativeInverseMapBuffer,
+                                              ComputeContraintJacobianOptionAngularPart,
+                                              finalJacobianBuffer);
+                } else if (m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw) {
+                    //error (w_R_f^d)^T * w_R_f, whose angular velocity is (w_R_f^d)^T omega
+                    iDynTree::Rotation rotationError;
+                    iDynTree::toEigen(rotationError) = iDynTree::toEigen(targetConstraint.getRotation()).transpose() * iDynTree::toEigen(targetInfo.transform.getRotation());
+                    getRotationParameters(m_data.m_rotationParametrization, rotationError, rotationParameters);
+                    iDynTree::toEigen(rotationMultipliers) = weight * iDynTree::toEigen(rotationParameters);
+                    iDynTree::toEigen(angularVelocityMap) = iDynTree::toEigen(targetConstraint.getRotation()).transpose();
+
+                    iDynTree::Matrix3x3 omegaToRPYMap_target;
+                    iDynTree::toEigen(omegaToRPYMap_target) = iDynTree::toEigen(iDynTree::Rotation::RPYRightTrivializedDerivativeInverse(rotationParameters(0), rotationParameters(1), rotationParameters(2))) * iDynTree::toEigen(angularVelocityMap);
+                    computeConstraintJacobianRPY(targetInfo.jacobian,
+                                                 omegaToRPYMap_target,
+                                                 RPYToOmega,
+                                                 ComputeContraintJacobianOptionAngularPart,
+                                                 finalJacobianBuffer);
+                }
+                hessian.noalias() += weight * iDynTree::toEigen(finalJacobianBuffer).bottomRows(rotationSize).transpose() * iDynTree::toEigen(finalJacobianBuffer).bottomRows(rotationSize);
+            }
+
+            addFrameHessian(targetInfo, positionMultipliers, rotationMultipliers, rotationParameters, angularVelocityMap, hessianBuffer);
+        }
+
+        //Norm of the base quaternion
+        if (m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationQuaternion) {
+            hessian.block<4, 4>(3, 3).diagonal().array() += 2 * multipliers(constraintIndex);
+            constraintIndex++;
+        }
+        assert(constraintIndex == m);
+
+        m_hessianSparsityHelper.assignActualMatrixValues({0, n}, hessianBuffer, 0, values);
+        return true;
+    }
+
+    void InverseKinematicsNLP::addFrameHessian(const FrameInfo& frameInfo,
+                                               const iDynTree::Vector3& positionMultipliers,
+                                               const iDynTree::Vector4& rotationMultipliers,
+                                               const iDynTree::Vector4& rotationParameters,
+                                               const iDynTree::Matrix3x3& angularVelocityMap,
+                                               iDynTree::MatrixDynSize& hessian)
+    {
+        iDynTree::iDynTreeEigenConstMatrixMap jacobian = iDynTree::toEigen(frameInfo.jacobian);
+        iDynTree::iDynTreeEigenMatrixMap generatorsHessian = iDynTree::toEigen(generatorsHessianBuffer);
+        Eigen::Map<const Eigen::Vector3d> mu = iDynTree::toEigen(positionMultipliers);
+        Eigen::Map<const Eigen::Vector4d> nu = iDynTree::toEigen(rotationMultipliers);
+        Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor> > A = iDynTree::toEigen(angularVelocityMap);
+
+        //nu^T G(phi) A, i.e. the derivative of nu^T phi w.r.t. the angular velocity of the frame
+        iDynTree::MatrixFixSize<4, 3> parametrizationMap;
+        computeRotationParametrizationMap(m_data.m_rotationParametrization, rotationParameters, parametrizationMap);
+        Eigen::Vector3d angularMultipliers = A.transpose() * iDynTree::toEigen(parametrizationMap).transpose() * nu;
+
+        //The base moves the axes of all the joints, but its axes are fixed in the inertial frame.
+        //Between two joints in the path from the base to the frame, the one closer to the base moves the other
+        auto movesAxisOf = [this](size_t a, size_t b) {
+            if (b < 6) return false;
+            if (a < 6) return true;
+            return dofsDepth[a - 6] <= dofsDepth[b - 6];
+        };
+
+        generatorsHessian.setZero();
+        //derivative of the term w.r.t. the base angular velocity
+        Eigen::Vector3d baseAngularMultipliers = Eigen::Vector3d::Zero();
+        iDynTree::Vector4 parametersVariation;
+        iDynTree::MatrixFixSize<4, 3> parametrizationMapDerivative;
+
+        for (size_t a : frameInfo.jacobianColumns) {
+            Eigen::Vector3d linearA = jacobian.block<3, 1>(0, a);
+            Eigen::Vector3d angularA = jacobian.block<3, 1>(3, a);
+
+            if (a >= 3 && a < 6) {
+                baseAngularMultipliers(a - 3) = mu.dot(linearA) + angularMultipliers.dot(angularA);
+            }
+
+            //Variation of G(phi) due to the motion along a
+            iDynTree::toEigen(parametersVariation) = iDynTree::toEigen(parametrizationMap) * A * angularA;
+            computeRotationParametrizationMapDerivative(m_data.m_rotationParametrization, rotationParameters,
+                                                        parametersVariation, parametrizationMapDerivative);
+            Eigen::Vector3d mapDerivativeMultipliers = A.transpose() * iDynTree::toEigen(parametrizationMapDerivative).transpose() * nu;
+
+            for (size_t b : frameInfo.jacobianColumns) {
+                Eigen::Vector3d linearB = jacobian.block<3, 1>(0, b);
+                Eigen::Vector3d angularB = jacobian.block<3, 1>(3, b);
+
+                //Derivative of the column b along the motion generated by a
+                double value = mapDerivativeMultipliers.dot(angularB);
+                if (movesAxisOf(a, b)) {
+                    value += mu.dot(angularA.cross(linearB)) + angularMultipliers.dot(angularA.cross(angularB));
+                } else {
+                    value += mu.dot(angularB.cross(linearA));
+                }
+                generatorsHessian(a, b) = value;
+            }
+        }
+
+        //Map to the optimization variables
+        iDynTree::iDynTreeEigenMatrixMap velocityToVariablesMap = iDynTree::toEigen(velocityToVariablesMapBuffer);
+        iDynTree::iDynTreeEigenMatrixMap mappedGeneratorsHessian = iDynTree::toEigen(mappedGeneratorsHessianBuffer);
+        iDynTree::iDynTreeEigenMatrixMap variablesHessian = iDynTree::toEigen(hessian);
+        mappedGeneratorsHessian.noalias() = generatorsHessian * velocityToVariablesMap;
+        variablesHessian.noalias() += velocityToVariablesMap.transpose() * mappedGeneratorsHessian;
+
+        //Second derivatives of the map from the base orientation parametrization to the base angular velocity
+        if (m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationQuaternion) {
+            //The map is G^{-1}(z) \partial z / \partial \bar{z}, see updateState
+            Eigen::Vector4d quaternion = iDynTree::toEigen(optimizedBaseOrientation);
+            double norm = quaternion.norm();
+            Eigen::Vector4d normalizedQuaternion = quaternion / norm;
+            Eigen::Matrix4d normalizedQuaternionDerivative = (norm * norm * Eigen::Matrix4d::Identity() - quaternion * quaternion.transpose()) / std::pow(norm, 3);
+
+            //c^T G^{-1}(z) = z^T C, as G^{-1} is linear in z
+            Eigen::Matrix4d inverseMapMultipliers;
+            inverseMapMultipliers(0, 0) = 0;
+            inverseMapMultipliers.block<1, 3>(0, 1) = 2 * baseAngularMultipliers.transpose();
+            inverseMapMultipliers.block<3, 1>(1, 0) = -2 * baseAngularMultipliers;
+            inverseMapMultipliers.block<3, 3>(1, 1) = -2 * iDynTree::skew(baseAngularMultipliers);
+
+            Eigen::Vector4d u = inverseMapMultipliers.transpose() * normalizedQuaternion;
+            double uDotQuaternion = u.dot(quaternion);
+            variablesHessian.block<4, 4>(3, 3) += normalizedQuaternionDerivative * inverseMapMultipliers * normalizedQuaternionDerivative
+                - (quaternion * u.transpose() + u * quaternion.transpose() + uDotQuaternion * Eigen::Matrix4d::Identity()) / std::pow(norm, 3)
+                + 3 * uDotQuaternion * quaternion * quaternion.transpose() / std::pow(norm, 5);
+
+        } else if (m_data.m_rotationParametrization == iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw) {
+            for (unsigned i = 0; i < 3; ++i) {
+                iDynTree::Matrix3x3 RPYToOmegaDerivative = iDynTree::Rotation::RPYRightTrivializedDerivativeRateOfChange(optimizedBaseOrientation(0),
+                                                                                                                        optimizedBaseOrientation(1),
+                                                                                                                        optimizedBaseOrientation(2),
+                                                                                                                        i == 0 ? 1.0 : 0.0,
+                                                                                                                        i == 1 ? 1.0 : 0.0,
+                                                                                                                        i == 2 ? 1.0 : 0.0);
+                variablesHessian.block<1, 3>(3 + i, 3) += baseAngularMultipliers.transpose() * iDynTree::toEigen(RPYToOmegaDerivative);
+            }
+        }
     }
 
     void InverseKinematicsNLP::finalize_solution(Ipopt::SolverReturn status, Ipopt::Index n,
@@ -1340,6 +1774,7 @@ void InverseKinematicsNLP::addSparsityInformationForConstraint(int constraintID,
     {
         //TODO: save the status
 
+        m_data.m_optimalCost = obj_value;
 
         //Obtain base position
         iDynTree::Position basePosition;
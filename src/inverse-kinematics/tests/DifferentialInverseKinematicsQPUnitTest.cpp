@@ -0,0 +1,362 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "DifferentialInverseKinematicsQP.h"
+#include "TransformConstraint.h"
+
+#include <iDynTree/ConvexHullHelpers.h>
+#include <iDynTree/KinDynComputations.h>
+#include <iDynTree/ModelTestUtils.h>
+#include <iDynTree/TestUtils.h>
+#include <iDynTree/EigenHelpers.h>
+
+#include <Eigen/Dense>
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+using namespace iDynTree;
+using internal::kinematics::DifferentialInverseKinematicsProblem;
+using internal::kinematics::DifferentialInverseKinematicsQP;
+using internal::kinematics::TransformConstraint;
+using internal::kinematics::TransformMap;
+
+/**
+ * Data of the problem, owned by the test as InverseKinematicsData does in the library.
+ */
+struct ProblemData
+{
+    KinDynComputations dynamics;
+    TransformMap constraints;
+    TransformMap targets;
+    ConvexHullProjectionConstraint comHullConstraint;
+    bool comTargetIsActive;
+    bool comTargetIsConstraint;
+    Position comTargetDesiredPosition;
+    double comTargetWeight;
+    double comTargetConstraintTolerance;
+    Transform baseInitialCondition;
+    VectorDynSize jointInitialConditions;
+    std::vector<std::pair<double, double> > jointLimits;
+    std::vector<bool> fixedJoints;
+    VectorDynSize preferredJointsConfiguration;
+    VectorDynSize preferredJointsWeight;
+    double gain;
+    double damping;
+
+    DifferentialInverseKinematicsProblem problem()
+    {
+        DifferentialInverseKinematicsProblem problem;
+        problem.dynamics = &dynamics;
+        problem.constraints = &constraints;
+        problem.targets = &targets;
+        problem.comHullConstraint = &comHullConstraint;
+        problem.comTargetIsActive = &comTargetIsActive;
+        problem.comTargetIsConstraint = &comTargetIsConstraint;
+        problem.comTargetDesiredPosition = &comTargetDesiredPosition;
+        problem.comTargetWeight = &comTargetWeight;
+        problem.comTargetConstraintTolerance = &comTargetConstraintTolerance;
+        problem.baseInitialCondition = &baseInitialCondition;
+        problem.jointInitialConditions = &jointInitialConditions;
+        problem.jointLimits = &jointLimits;
+        problem.fixedJoints = &fixedJoints;
+        problem.preferredJointsConfiguration = &preferredJointsConfiguration;
+        problem.preferredJointsWeight = &preferredJointsWeight;
+        problem.gain = &gain;
+        problem.damping = &damping;
+        return problem;
+    }
+};
+
+/**
+ * Configure on a random chain a problem with a frame constraint, a target in the cost,
+ * a target with the position enforced as a constraint and the rotation in the cost
+ * and a center of mass target in the cost.
+ *
+ * The desired values are computed in a random configuration, so that the errors are not zero.
+ */
+void setupProblem(ProblemData& data, const Model& model)
+{
+    bool ok = data.dynamics.loadRobotModel(model);
+    ASSERT_IS_TRUE(ok);
+    const size_t dofs = model.getNrOfDOFs();
+
+    VectorDynSize desiredJoints(dofs);
+    getRandomVector(desiredJoints, -1.0, 1.0);
+    Transform desiredBase = getRandomTransform();
+    ok = data.dynamics.setWorldBaseTransform(desiredBase);
+    ASSERT_IS_TRUE(ok);
+    ok = data.dynamics.setJointPos(desiredJoints);
+    ASSERT_IS_TRUE(ok);
+
+    FrameIndex constrainedFrame = model.getFrameIndex("link2");
+    FrameIndex costFrame = model.getFrameIndex("link5");
+    FrameIndex positionConstrainedFrame = model.getFrameIndex("link" + int2string(dofs - 1));
+    ASSERT_IS_TRUE(constrainedFrame != FRAME_INVALID_INDEX);
+    ASSERT_IS_TRUE(costFrame != FRAME_INVALID_INDEX);
+    ASSERT_IS_TRUE(positionConstrainedFrame != FRAME_INVALID_INDEX);
+
+    data.constraints.clear();
+    data.constraints.insert(TransformMap::value_type(constrainedFrame,
+        TransformConstraint::fullTransformConstraint("link2", data.dynamics.getWorldTransform(constrainedFrame))));
+
+    data.targets.clear();
+    TransformConstraint costTarget = TransformConstraint::fullTransformConstraint("link5", data.dynamics.getWorldTransform(costFrame), 2.0, 3.0);
+    costTarget.setTargetResolutionMode(InverseKinematicsTreatTargetAsConstraintNone);
+    data.targets.insert(TransformMap::value_type(costFrame, costTarget));
+    TransformConstraint positionTarget = TransformConstraint::fullTransformConstraint(model.getFrameName(positionConstrainedFrame),
+                                                                                     data.dynamics.getWorldTransform(positionConstrainedFrame), 1.0, 0.5);
+    positionTarget.setTargetResolutionMode(InverseKinematicsTreatTargetAsConstraintPositionOnly);
+    data.targets.insert(TransformMap::value_type(positionConstrainedFrame, positionTarget));
+
+    data.comHullConstraint.setActive(false);
+    data.comTargetIsActive = true;
+    data.comTargetIsConstraint = false;
+    data.comTargetDesiredPosition = data.dynamics.getCenterOfMassPosition();
+    data.comTargetWeight = 0.7;
+    data.comTargetConstraintTolerance = 1e-8;
+
+    data.baseInitialCondition = getRandomTransform();
+    data.jointInitialConditions.resize(dofs);
+    getRandomVector(data.jointInitialConditions, -1.0, 1.0);
+    data.jointLimits.assign(dofs, std::make_pair(-10.0, 10.0));
+    data.fixedJoints.assign(dofs, false);
+    data.preferredJointsConfiguration.resize(dofs);
+    getRandomVector(data.preferredJointsConfiguration, -1.0, 1.0);
+    data.preferredJointsWeight.resize(dofs);
+    getRandomVector(data.preferredJointsWeight, 0.1, 1.0);
+    data.gain = 0.8;
+    data.damping = 1e-3;
+}
+
+/**
+ * Error of a frame with respect to its target, with the rotation error computed as the angle-axis of R_d R^T.
+ */
+Eigen::Matrix<double, 6, 1> frameError(const TransformConstraint& target, const Transform& transform)
+{
+    Eigen::Matrix<double, 6, 1> error;
+    error.head<3>() = toEigen(target.getPosition()) - toEigen(transform.getPosition());
+    Eigen::Matrix3d rotation = toEigen(target.getRotation()) * toEigen(transform.getRotation()).transpose();
+    Eigen::AngleAxisd angleAxis(rotation);
+    error.tail<3>() = angleAxis.angle() * angleAxis.axis();
+    return error;
+}
+
+/**
+ * Build the expected QP independently from the class, at the initial condition of the problem.
+ */
+void buildExpectedQP(ProblemData& data, Eigen::MatrixXd& hessian, Eigen::VectorXd& gradient,
+                     Eigen::MatrixXd& constraintsJacobian, Eigen::VectorXd& constraintsBounds)
+{
+    const Eigen::Index dofs = static_cast<Eigen::Index>(data.jointInitialConditions.size());
+    const Eigen::Index n = 6 + dofs;
+    bool ok = data.dynamics.setWorldBaseTransform(data.baseInitialCondition);
+    ASSERT_IS_TRUE(ok);
+    ok = data.dynamics.setJointPos(data.jointInitialConditions);
+    ASSERT_IS_TRUE(ok);
+
+    hessian = data.damping * Eigen::MatrixXd::Identity(n, n);
+    gradient = Eigen::VectorXd::Zero(n);
+    std::vector<Eigen::VectorXd> constraintRows;
+    std::vector<double> bounds;
+    MatrixDynSize jacobian(6, n);
+
+    auto addCost = [&](const Eigen::MatrixXd& J, const Eigen::VectorXd& reference, double weight) {
+        hessian += weight * J.transpose() * J;
+        gradient -= weight * J.transpose() * reference;
+    };
+    auto addConstraint = [&](const Eigen::MatrixXd& J, const Eigen::VectorXd& reference) {
+        for (Eigen::Index row = 0; row < J.rows(); ++row) {
+            constraintRows.push_back(J.row(row).transpose());
+            bounds.push_back(reference(row));
+        }
+    };
+
+    for (TransformMap::const_iterator constraint = data.constraints.begin(); constraint != data.constraints.end(); ++constraint) {
+        ok = data.dynamics.getFrameFreeFloatingJacobian(constraint->first, jacobian);
+        ASSERT_IS_TRUE(ok);
+        Eigen::Matrix<double, 6, 1> error = data.gain * frameError(constraint->second, data.dynamics.getWorldTransform(constraint->first));
+        addConstraint(toEigen(jacobian), error);
+    }
+
+    MatrixDynSize comJacobian(3, n);
+    ok = data.dynamics.getCenterOfMassJacobian(comJacobian);
+    ASSERT_IS_TRUE(ok);
+    Eigen::Vector3d comError = data.gain * (toEigen(data.comTargetDesiredPosition) - toEigen(data.dynamics.getCenterOfMassPosition()));
+    addCost(toEigen(comJacobian), comError, data.comTargetWeight);
+
+    for (TransformMap::const_iterator target = data.targets.begin(); target != data.targets.end(); ++target) {
+        ok = data.dynamics.getFrameFreeFloatingJacobian(target->first, jacobian);
+        ASSERT_IS_TRUE(ok);
+        Eigen::Matrix<double, 6, 1> error = data.gain * frameError(target->second, data.dynamics.getWorldTransform(target->first));
+        if (target->second.targetResolutionMode() & InverseKinematicsTreatTargetAsConstraintPositionOnly) {
+            addConstraint(toEigen(jacobian).topRows<3>(), error.head<3>());
+        } else {
+            addCost(toEigen(jacobian).topRows<3>(), error.head<3>(), target->second.getPositionWeight());
+        }
+        if (target->second.targetResolutionMode() & InverseKinematicsTreatTargetAsConstraintRotationOnly) {
+            addConstraint(toEigen(jacobian).bottomRows<3>(), error.tail<3>());
+        } else {
+            addCost(toEigen(jacobian).bottomRows<3>(), error.tail<3>(), target->second.getRotationWeight());
+        }
+    }
+
+    hessian.diagonal().tail(dofs) += toEigen(data.preferredJointsWeight);
+    gradient.tail(dofs) -= data.gain * toEigen(data.preferredJointsWeight).cwiseProduct(
+        toEigen(data.preferredJointsConfiguration) - toEigen(data.jointInitialConditions));
+
+    constraintsJacobian.resize(static_cast<Eigen::Index>(constraintRows.size()), n);
+    constraintsBounds.resize(static_cast<Eigen::Index>(bounds.size()));
+    for (size_t row = 0; row < constraintRows.size(); ++row) {
+        constraintsJacobian.row(row) = constraintRows[row].transpose();
+        constraintsBounds(row) = bounds[row];
+    }
+}
+
+/**
+ * Check that the nonzero elements of a matrix are all listed in its sparsity pattern.
+ */
+void checkSparsity(const MatrixDynSize& matrix, const std::vector<size_t>& rows, const std::vector<size_t>& columns)
+{
+    ASSERT_IS_TRUE(rows.size() == columns.size());
+    Eigen::MatrixXd pattern = Eigen::MatrixXd::Zero(matrix.rows(), matrix.cols());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        ASSERT_IS_TRUE(rows[i] < matrix.rows() && columns[i] < matrix.cols());
+        pattern(rows[i], columns[i]) = 1.0;
+    }
+    for (size_t row = 0; row < matrix.rows(); ++row) {
+        for (size_t col = 0; col < matrix.cols(); ++col) {
+            if (matrix(row, col) != 0.0) {
+                ASSERT_IS_TRUE(pattern(row, col) != 0.0);
+            }
+        }
+    }
+}
+
+void testQPConstruction(const Model& model)
+{
+    ProblemData data;
+    setupProblem(data, model);
+    const size_t n = 6 + model.getNrOfDOFs();
+
+    DifferentialInverseKinematicsQP qp(data.problem());
+    bool ok = qp.prepare();
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(qp.numberOfVariables() == n);
+    // 6 rows of the frame constraint and 3 rows of the position of the last target
+    ASSERT_IS_TRUE(qp.numberOfConstraints() == 9);
+
+    MatrixDynSize hessian, constraintsJacobian;
+    VectorDynSize gradient, lowerBounds, upperBounds, zero(n);
+    zero.zero();
+    ok = qp.setVariables(zero);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(qp.evaluateCostHessian(hessian));
+    ASSERT_IS_TRUE(qp.evaluateCostGradient(gradient));
+    ASSERT_IS_TRUE(qp.evaluateConstraintsJacobian(constraintsJacobian));
+    ASSERT_IS_TRUE(qp.getConstraintsBounds(lowerBounds, upperBounds));
+
+    Eigen::MatrixXd expectedHessian, expectedConstraintsJacobian;
+    Eigen::VectorXd expectedGradient, expectedBounds;
+    buildExpectedQP(data, expectedHessian, expectedGradient, expectedConstraintsJacobian, expectedBounds);
+
+    ASSERT_EQUAL_MATRIX_TOL(hessian, expectedHessian, 1e-10);
+    ASSERT_EQUAL_VECTOR_TOL(gradient, expectedGradient, 1e-10);
+    ASSERT_EQUAL_MATRIX_TOL(constraintsJacobian, expectedConstraintsJacobian, 1e-10);
+    ASSERT_EQUAL_VECTOR_TOL(lowerBounds, expectedBounds, 1e-10);
+    ASSERT_EQUAL_VECTOR_TOL(upperBounds, expectedBounds, 1e-10);
+
+    std::vector<size_t> rows, columns;
+    ASSERT_IS_TRUE(qp.getHessianInfo(rows, columns));
+    checkSparsity(hessian, rows, columns);
+    ASSERT_IS_TRUE(qp.getConstraintsJacobianInfo(rows, columns));
+    checkSparsity(constraintsJacobian, rows, columns);
+
+    // The joint limits are far, so that the solution of the equality constrained QP is the solution of the KKT system
+    VectorDynSize variablesLowerBound, variablesUpperBound;
+    ASSERT_IS_TRUE(qp.getVariablesLowerBound(variablesLowerBound));
+    ASSERT_IS_TRUE(qp.getVariablesUpperBound(variablesUpperBound));
+    for (size_t i = 0; i < model.getNrOfDOFs(); ++i) {
+        ASSERT_EQUAL_DOUBLE(variablesLowerBound(6 + i), -10.0 - data.jointInitialConditions(i));
+        ASSERT_EQUAL_DOUBLE(variablesUpperBound(6 + i), 10.0 - data.jointInitialConditions(i));
+    }
+
+    const Eigen::Index m = expectedConstraintsJacobian.rows();
+    Eigen::MatrixXd kkt = Eigen::MatrixXd::Zero(n + m, n + m);
+    kkt.topLeftCorner(n, n) = toEigen(hessian);
+    kkt.topRightCorner(n, m) = toEigen(constraintsJacobian).transpose();
+    kkt.bottomLeftCorner(m, n) = toEigen(constraintsJacobian);
+    Eigen::VectorXd kktVector(n + m);
+    kktVector.head(n) = -toEigen(gradient);
+    kktVector.tail(m) = toEigen(lowerBounds);
+    Eigen::VectorXd kktSolution = kkt.fullPivLu().solve(kktVector);
+    Eigen::VectorXd increments = kktSolution.head(n);
+
+    // Compare with the minimizer of the expected QP restricted to the null space of the expected constraints
+    Eigen::CompleteOrthogonalDecomposition<Eigen::MatrixXd> constraintsDecomposition(expectedConstraintsJacobian);
+    Eigen::VectorXd particularSolution = constraintsDecomposition.solve(expectedBounds);
+    Eigen::FullPivLU<Eigen::MatrixXd> constraintsLU(expectedConstraintsJacobian);
+    Eigen::MatrixXd nullSpace = constraintsLU.kernel();
+    Eigen::VectorXd nullSpaceVariables = (nullSpace.transpose() * expectedHessian * nullSpace).ldlt().solve(
+        -nullSpace.transpose() * (expectedHessian * particularSolution + expectedGradient));
+    Eigen::VectorXd expectedIncrements = particularSolution + nullSpace * nullSpaceVariables;
+    ASSERT_EQUAL_VECTOR_TOL(increments, expectedIncrements, 1e-7);
+    ASSERT_EQUAL_VECTOR_TOL(expectedConstraintsJacobian * increments, expectedBounds, 1e-8);
+
+    // The cost evaluated by the class is minimal at the solution along the null space of the constraints
+    VectorDynSize solution(n);
+    toEigen(solution) = increments;
+    ASSERT_IS_TRUE(qp.setVariables(solution));
+    double costValue;
+    ASSERT_IS_TRUE(qp.evaluateCostFunction(costValue));
+    for (Eigen::Index i = 0; i < nullSpace.cols(); ++i) {
+        toEigen(solution) = increments + 1e-3 * nullSpace.col(i);
+        ASSERT_IS_TRUE(qp.setVariables(solution));
+        double perturbedCostValue;
+        ASSERT_IS_TRUE(qp.evaluateCostFunction(perturbedCostValue));
+        ASSERT_IS_TRUE(perturbedCostValue > costValue);
+    }
+
+    // Applying the increments recovers the fraction gain of the errors of the constraints, up to the linearization error
+    data.gain = 0.01;
+    ok = qp.prepare();
+    ASSERT_IS_TRUE(ok);
+    buildExpectedQP(data, expectedHessian, expectedGradient, expectedConstraintsJacobian, expectedBounds);
+    ASSERT_IS_TRUE(qp.evaluateConstraintsJacobian(constraintsJacobian));
+    ASSERT_IS_TRUE(qp.getConstraintsBounds(lowerBounds, upperBounds));
+    ASSERT_EQUAL_VECTOR_TOL(lowerBounds, expectedBounds, 1e-10);
+    kkt.topRightCorner(n, m) = toEigen(constraintsJacobian).transpose();
+    kkt.bottomLeftCorner(m, n) = toEigen(constraintsJacobian);
+    kktVector.tail(m) = toEigen(lowerBounds);
+    ASSERT_IS_TRUE(qp.setVariables(zero));
+    ASSERT_IS_TRUE(qp.evaluateCostGradient(gradient));
+    kktVector.head(n) = -toEigen(gradient);
+    toEigen(solution) = kkt.fullPivLu().solve(kktVector).head(n);
+
+    Transform basePose;
+    VectorDynSize joints;
+    qp.applyIncrements(solution, basePose, joints);
+    ok = data.dynamics.setWorldBaseTransform(basePose);
+    ASSERT_IS_TRUE(ok);
+    ok = data.dynamics.setJointPos(joints);
+    ASSERT_IS_TRUE(ok);
+
+    TransformMap::const_iterator constraint = data.constraints.begin();
+    TransformMap::const_iterator positionTarget = --data.targets.end();
+    Eigen::VectorXd errors(m);
+    errors.head<6>() = frameError(constraint->second, data.dynamics.getWorldTransform(constraint->first));
+    errors.tail<3>() = frameError(positionTarget->second, data.dynamics.getWorldTransform(positionTarget->first)).head<3>();
+    Eigen::VectorXd expectedErrors = (1.0 - data.gain) / data.gain * expectedBounds;
+    ASSERT_EQUAL_VECTOR_TOL(errors, expectedErrors, 1e-3 * expectedErrors.norm());
+}
+
+int main()
+{
+    for (unsigned int i = 0; i < 5; ++i) {
+        Model model = getRandomChain(8, 0, true);
+        testQPConstruction(model);
+    }
+
+    return EXIT_SUCCESS;
+}
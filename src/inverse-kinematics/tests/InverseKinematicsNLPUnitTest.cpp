@@ -0,0 +1,312 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "InverseKinematicsData.h"
+#include "InverseKinematicsNLP.h"
+#include "TransformConstraint.h"
+
+#include <iDynTree/KinDynComputations.h>
+#include <iDynTree/ModelLoader.h>
+#include <iDynTree/ModelTestUtils.h>
+#include <iDynTree/TestUtils.h>
+#include <iDynTree/EigenHelpers.h>
+
+#include "testModels.h"
+
+#include <Eigen/Dense>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace iDynTree;
+using internal::kinematics::InverseKinematicsData;
+using internal::kinematics::InverseKinematicsNLP;
+using internal::kinematics::TransformConstraint;
+
+/**
+ * Size of the problem, as returned by InverseKinematicsNLP::get_nlp_info.
+ */
+struct NLPInfo
+{
+    Ipopt::Index n;
+    Ipopt::Index m;
+    Ipopt::Index nnz_jac_g;
+    Ipopt::Index nnz_h_lag;
+};
+
+/**
+ * Configure on iCubGenova02 a problem with a frame constraint, a target enforced as a constraint,
+ * a target in the cost and a target with the position enforced as a constraint and the rotation in the cost.
+ *
+ * The desired values are computed in a random configuration, so that the errors are not zero
+ * in the configurations where the derivatives are evaluated.
+ */
+void setupProblem(InverseKinematicsData& data,
+                  const InverseKinematicsRotationParametrization rotationParametrization,
+                  NLPInfo& info)
+{
+    ModelLoader loader;
+    bool ok = loader.loadModelFromFile(getAbsModelPath("iCubGenova02.urdf"));
+    ASSERT_IS_TRUE(ok);
+    ok = data.setModel(loader.model());
+    ASSERT_IS_TRUE(ok);
+    data.setRotationParametrization(rotationParametrization);
+
+    KinDynComputations kinDynDes;
+    ok = kinDynDes.loadRobotModel(loader.model());
+    ASSERT_IS_TRUE(ok);
+    JointPosDoubleArray s(loader.model());
+    getRandomJointPositions(s, loader.model());
+    ok = kinDynDes.setJointPos(s);
+    ASSERT_IS_TRUE(ok);
+
+    ok = data.addFrameConstraint(TransformConstraint::fullTransformConstraint("l_sole", kinDynDes.getWorldTransform("l_sole")));
+    ASSERT_IS_TRUE(ok);
+
+    data.setDefaultTargetResolutionMode(InverseKinematicsTreatTargetAsConstraintFull);
+    ok = data.addTarget(TransformConstraint::fullTransformConstraint("r_sole", kinDynDes.getWorldTransform("r_sole")));
+    ASSERT_IS_TRUE(ok);
+
+    data.setDefaultTargetResolutionMode(InverseKinematicsTreatTargetAsConstraintNone);
+    ok = data.addTarget(TransformConstraint::fullTransformConstraint("l_elbow_1", kinDynDes.getWorldTransform("l_elbow_1"), 2.0, 3.0));
+    ASSERT_IS_TRUE(ok);
+
+    data.setDefaultTargetResolutionMode(InverseKinematicsTreatTargetAsConstraintPositionOnly);
+    ok = data.addTarget(TransformConstraint::fullTransformConstraint("r_elbow_1", kinDynDes.getWorldTransform("r_elbow_1"), 1.0, 0.5));
+    ASSERT_IS_TRUE(ok);
+
+    JointPosDoubleArray initialJoints(loader.model());
+    getRandomJointPositions(initialJoints, loader.model());
+    ok = data.setRobotConfiguration(getRandomTransform(), initialJoints);
+    ASSERT_IS_TRUE(ok);
+
+    data.computeProblemSizeAndResizeBuffers();
+    data.prepareForOptimization();
+
+    InverseKinematicsNLP::IndexStyleEnum indexStyle;
+    ok = data.m_nlpProblem->get_nlp_info(info.n, info.m, info.nnz_jac_g, info.nnz_h_lag, indexStyle);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(indexStyle == InverseKinematicsNLP::C_STYLE);
+}
+
+/**
+ * Random value of the optimization variables, with a unit quaternion for the base orientation.
+ */
+Eigen::VectorXd getRandomOptimizationVariables(const InverseKinematicsData& data, const NLPInfo& info)
+{
+    Eigen::VectorXd x(info.n);
+    Transform basePose = getRandomTransform();
+    x.head<3>() = toEigen(basePose.getPosition());
+    Ipopt::Index baseSize = 6;
+    if (data.m_rotationParametrization == InverseKinematicsRotationParametrizationQuaternion) {
+        Vector4 quaternion;
+        basePose.getRotation().getQuaternion(quaternion);
+        x.segment<4>(3) = toEigen(quaternion);
+        baseSize = 7;
+    } else {
+        x.segment<3>(3) = toEigen(basePose.getRotation().asRPY());
+    }
+    for (Ipopt::Index i = baseSize; i < info.n; ++i) {
+        x(i) = getRandomDouble(-1.0, 1.0);
+    }
+    return x;
+}
+
+double evaluateCost(InverseKinematicsNLP& nlp, const Eigen::VectorXd& x)
+{
+    double cost = 0;
+    bool ok = nlp.eval_f(x.size(), x.data(), true, cost);
+    ASSERT_IS_TRUE(ok);
+    return cost;
+}
+
+Eigen::VectorXd evaluateCostGradient(InverseKinematicsNLP& nlp, const Eigen::VectorXd& x)
+{
+    Eigen::VectorXd gradient(x.size());
+    bool ok = nlp.eval_grad_f(x.size(), x.data(), true, gradient.data());
+    ASSERT_IS_TRUE(ok);
+    return gradient;
+}
+
+Eigen::VectorXd evaluateConstraints(InverseKinematicsNLP& nlp, const NLPInfo& info, const Eigen::VectorXd& x)
+{
+    Eigen::VectorXd constraints(info.m);
+    bool ok = nlp.eval_g(info.n, x.data(), true, info.m, constraints.data());
+    ASSERT_IS_TRUE(ok);
+    return constraints;
+}
+
+/**
+ * Dense constraints Jacobian from the sparse values returned by eval_jac_g.
+ *
+ * The values are written in a buffer larger than the number of nonzeros, whose
+ * tail is checked to be left untouched.
+ */
+Eigen::MatrixXd evaluateConstraintsJacobian(InverseKinematicsNLP& nlp, const NLPInfo& info, const Eigen::VectorXd& x)
+{
+    std::vector<Ipopt::Index> rows(info.nnz_jac_g), cols(info.nnz_jac_g);
+    bool ok = nlp.eval_jac_g(info.n, x.data(), true, info.m, info.nnz_jac_g, rows.data(), cols.data(), nullptr);
+    ASSERT_IS_TRUE(ok);
+
+    const double guardValue = 12345.0;
+    std::vector<double> values(info.nnz_jac_g + info.n * info.m, guardValue);
+    ok = nlp.eval_jac_g(info.n, x.data(), true, info.m, info.nnz_jac_g, nullptr, nullptr, values.data());
+    ASSERT_IS_TRUE(ok);
+    for (size_t i = info.nnz_jac_g; i < values.size(); ++i) {
+        ASSERT_EQUAL_DOUBLE(values[i], guardValue);
+    }
+
+    Eigen::MatrixXd jacobian = Eigen::MatrixXd::Zero(info.m, info.n);
+    for (Ipopt::Index i = 0; i < info.nnz_jac_g; ++i) {
+        ASSERT_IS_TRUE(rows[i] >= 0 && rows[i] < info.m && cols[i] >= 0 && cols[i] < info.n);
+        jacobian(rows[i], cols[i]) += values[i];
+    }
+    return jacobian;
+}
+
+/**
+ * Dense Hessian of the Lagrangian from the lower triangular values returned by eval_h.
+ */
+Eigen::MatrixXd evaluateLagrangianHessian(InverseKinematicsNLP& nlp, const NLPInfo& info, const Eigen::VectorXd& x,
+                                          const double objectiveFactor, const Eigen::VectorXd& lambda)
+{
+    std::vector<Ipopt::Index> rows(info.nnz_h_lag), cols(info.nnz_h_lag);
+    bool ok = nlp.eval_h(info.n, x.data(), true, objectiveFactor, info.m, lambda.data(), true,
+                         info.nnz_h_lag, rows.data(), cols.data(), nullptr);
+    ASSERT_IS_TRUE(ok);
+
+    std::vector<double> values(info.nnz_h_lag);
+    ok = nlp.eval_h(info.n, x.data(), true, objectiveFactor, info.m, lambda.data(), true,
+                    info.nnz_h_lag, nullptr, nullptr, values.data());
+    ASSERT_IS_TRUE(ok);
+
+    Eigen::MatrixXd hessian = Eigen::MatrixXd::Zero(info.n, info.n);
+    for (Ipopt::Index i = 0; i < info.nnz_h_lag; ++i) {
+        ASSERT_IS_TRUE(cols[i] <= rows[i] && rows[i] < info.n && cols[i] >= 0);
+        hessian(rows[i], cols[i]) += values[i];
+        if (rows[i] != cols[i]) {
+            hessian(cols[i], rows[i]) += values[i];
+        }
+    }
+    return hessian;
+}
+
+/**
+ * Central finite differences of the columns of a function of the optimization variables.
+ */
+template <typename Function>
+Eigen::MatrixXd finiteDifferences(Function function, const Eigen::VectorXd& x, const double epsilon)
+{
+    Eigen::MatrixXd derivative;
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        Eigen::VectorXd xPlus = x;
+        Eigen::VectorXd xMinus = x;
+        xPlus(i) += epsilon;
+        xMinus(i) -= epsilon;
+        Eigen::VectorXd column = (function(xPlus) - function(xMinus)) / (2 * epsilon);
+        if (i == 0) {
+            derivative.resize(column.size(), x.size());
+        }
+        derivative.col(i) = column;
+    }
+    return derivative;
+}
+
+/**
+ * Check that the gradient of the cost matches the finite differences of the cost.
+ * The rotation cost of the targets depends on the error between the frame and the desired rotation,
+ * so with the quaternion parametrization the gradient must use the map of the error quaternion.
+ */
+void testCostGradient(const InverseKinematicsRotationParametrization rotationParametrization)
+{
+    InverseKinematicsData data;
+    NLPInfo info;
+    setupProblem(data, rotationParametrization, info);
+    InverseKinematicsNLP& nlp = *data.m_nlpProblem;
+
+    for (int trial = 0; trial < 5; ++trial) {
+        Eigen::VectorXd x = getRandomOptimizationVariables(data, info);
+        Eigen::VectorXd gradient = evaluateCostGradient(nlp, x);
+        Eigen::MatrixXd numericalGradient = finiteDifferences([&nlp](const Eigen::VectorXd& xi) {
+            return Eigen::VectorXd::Constant(1, evaluateCost(nlp, xi));
+        }, x, 1e-6);
+
+        VectorDynSize gradientCheck(info.n), numericalGradientCheck(info.n);
+        toEigen(gradientCheck) = gradient;
+        toEigen(numericalGradientCheck) = numericalGradient.row(0).transpose();
+        ASSERT_EQUAL_VECTOR_TOL(gradientCheck, numericalGradientCheck, 1e-5);
+    }
+}
+
+/**
+ * Check that the constraints Jacobian matches the finite differences of the constraints.
+ * With the quaternion parametrization the last row is the norm of the base quaternion,
+ * whose values must be written in its own nonzeros.
+ */
+void testConstraintsJacobian(const InverseKinematicsRotationParametrization rotationParametrization)
+{
+    InverseKinematicsData data;
+    NLPInfo info;
+    setupProblem(data, rotationParametrization, info);
+    InverseKinematicsNLP& nlp = *data.m_nlpProblem;
+
+    for (int trial = 0; trial < 5; ++trial) {
+        Eigen::VectorXd x = getRandomOptimizationVariables(data, info);
+        Eigen::MatrixXd jacobian = evaluateConstraintsJacobian(nlp, info, x);
+        Eigen::MatrixXd numericalJacobian = finiteDifferences([&nlp, &info](const Eigen::VectorXd& xi) {
+            return evaluateConstraints(nlp, info, xi);
+        }, x, 1e-6);
+
+        MatrixDynSize jacobianCheck(info.m, info.n), numericalJacobianCheck(info.m, info.n);
+        toEigen(jacobianCheck) = jacobian;
+        toEigen(numericalJacobianCheck) = numericalJacobian;
+        ASSERT_EQUAL_MATRIX_TOL(jacobianCheck, numericalJacobianCheck, 1e-5);
+    }
+}
+
+/**
+ * Check that the exact Hessian of the Lagrangian matches the finite differences of the
+ * gradient of the Lagrangian, i.e. of obj_factor * grad_f + J_g^T lambda, with random multipliers.
+ */
+void testLagrangianHessian(const InverseKinematicsRotationParametrization rotationParametrization)
+{
+    InverseKinematicsData data;
+    NLPInfo info;
+    setupProblem(data, rotationParametrization, info);
+    data.m_hessianApproximation = InverseKinematicsHessianApproximationExact;
+    InverseKinematicsNLP& nlp = *data.m_nlpProblem;
+
+    for (int trial = 0; trial < 5; ++trial) {
+        Eigen::VectorXd x = getRandomOptimizationVariables(data, info);
+        const double objectiveFactor = getRandomDouble(0.5, 2.0);
+        Eigen::VectorXd lambda(info.m);
+        for (Ipopt::Index i = 0; i < info.m; ++i) {
+            lambda(i) = getRandomDouble(-1.0, 1.0);
+        }
+
+        Eigen::MatrixXd hessian = evaluateLagrangianHessian(nlp, info, x, objectiveFactor, lambda);
+        Eigen::MatrixXd numericalHessian = finiteDifferences([&nlp, &info, objectiveFactor, &lambda](const Eigen::VectorXd& xi) {
+            Eigen::VectorXd lagrangianGradient = objectiveFactor * evaluateCostGradient(nlp, xi);
+            lagrangianGradient += evaluateConstraintsJacobian(nlp, info, xi).transpose() * lambda;
+            return lagrangianGradient;
+        }, x, 1e-6);
+
+        MatrixDynSize hessianCheck(info.n, info.n), numericalHessianCheck(info.n, info.n);
+        toEigen(hessianCheck) = hessian;
+        // The finite differences are symmetric only up to their error
+        toEigen(numericalHessianCheck) = 0.5 * (numericalHessian + numericalHessian.transpose());
+        ASSERT_EQUAL_MATRIX_TOL(hessianCheck, numericalHessianCheck, 1e-5);
+    }
+}
+
+int main()
+{
+    testCostGradient(InverseKinematicsRotationParametrizationRollPitchYaw);
+    testCostGradient(InverseKinematicsRotationParametrizationQuaternion);
+    testConstraintsJacobian(InverseKinematicsRotationParametrizationRollPitchYaw);
+    testConstraintsJacobian(InverseKinematicsRotationParametrizationQuaternion);
+    testLagrangianHessian(InverseKinematicsRotationParametrizationRollPitchYaw);
+    testLagrangianHessian(InverseKinematicsRotationParametrizationQuaternion);
+
+    return EXIT_SUCCESS;
+}
@@ -80,7 +80,8 @@ struct simpleChainIKOptions
     bool useDesiredJointPositionsToRandomValue;
 };
 
-void simpleChainIK(int minNrOfJoints, int maxNrOfJoints, const iDynTree::InverseKinematicsRotationParametrization rotationParametrization)
+void simpleChainIK(int minNrOfJoints, int maxNrOfJoints, const iDynTree::InverseKinematicsRotationParametrization rotationParametrization,
+                   const iDynTree::InverseKinematicsHessianApproximation hessianApproximation = iDynTree::InverseKinematicsHessianApproximationLimitedMemory)
 {
     // Solve a simple IK problem for a chain, with no constraints
     for (int i = minNrOfJoints; i <= maxNrOfJoints; i++)
@@ -106,6 +107,7 @@ void simpleChainIK(int minNrOfJoints, int maxNrOfJoints, const iDynTree::Inverse
 
         // Use the requested parametrization
         ik.setRotationParametrization(rotationParametrization);
+        ik.setHessianApproximation(hessianApproximation);
 
         ik.setCostTolerance(1e-6);
         ik.setConstraintsTolerance(1e-7);
@@ -178,7 +180,8 @@ void simpleChainIK(int minNrOfJoints, int maxNrOfJoints, const iDynTree::Inverse
 }
 
 // Check the consistency of a simple humanoid wholebody IK test case
-void simpleHumanoidWholeBodyIKConsistency(const iDynTree::InverseKinematicsRotationParametrization rotationParametrization)
+void simpleHumanoidWholeBodyIKConsistency(const iDynTree::InverseKinematicsRotationParametrization rotationParametrization,
+                                          const iDynTree::InverseKinematicsHessianApproximation hessianApproximation = iDynTree::InverseKinematicsHessianApproximationLimitedMemory)
 {
     iDynTree::InverseKinematics ik;
 
@@ -188,6 +191,7 @@ void simpleHumanoidWholeBodyIKConsistency(const iDynTree::InverseKinematicsRotat
     //ik.setFloatingBaseOnFrameNamed("l_foot");
 
     ik.setRotationParametrization(rotationParametrization);
+    ik.setHessianApproximation(hessianApproximation);
 
     // Create also a KinDyn object to perform forward kinematics for the desired values
     iDynTree::KinDynComputations kinDynDes;
@@ -616,6 +620,143 @@ void COMConvexHullConstraintWithSwitchingConstraints()
 
 }
 
+void simpleHumanoidWholeBodyDifferentialIK()
+{
+    iDynTree::InverseKinematics ik;
+
+    bool ok = ik.loadModelFromFile(getAbsModelPath("iCubGenova02.urdf"));
+    ASSERT_IS_TRUE(ok);
+
+    if (!ik.setSolverMode(iDynTree::InverseKinematicsSolverModeDifferential))
+    {
+        std::cerr << "Differential inverse kinematics not available, skipping the test." << std::endl;
+        return;
+    }
+    ik.setDifferentialModeGain(1.0);
+
+    iDynTree::KinDynComputations kinDynDes;
+    ok = kinDynDes.loadRobotModel(ik.fullModel());
+    ASSERT_IS_TRUE(ok);
+
+    iDynTree::JointPosDoubleArray s = getRandomJointPositions(kinDynDes.model());
+    ok = kinDynDes.setJointPos(s);
+    ASSERT_IS_TRUE(ok);
+
+    ok = ik.addFrameConstraint("l_sole", kinDynDes.getWorldTransform("l_sole"));
+    ASSERT_IS_TRUE(ok);
+
+    ik.setDefaultTargetResolutionMode(iDynTree::InverseKinematicsTreatTargetAsConstraintNone);
+    ok = ik.addTarget("r_sole", kinDynDes.getWorldTransform("r_sole"));
+    ASSERT_IS_TRUE(ok);
+    ok = ik.addPositionTarget("l_elbow_1", kinDynDes.getWorldTransform("l_elbow_1"));
+    ASSERT_IS_TRUE(ok);
+
+    // Start close to the desired configuration, as in a tracking loop
+    iDynTree::Transform initialH = kinDynDes.getWorldBaseTransform();
+    iDynTree::JointPosDoubleArray sInitial = getRandomJointPositionsCloseTo(ik.fullModel(), s, 0.05);
+    ik.setFullJointsInitialCondition(&initialH, &sInitial);
+
+    // Each call solves a single QP, and its solution is the initial condition of the next one
+    iDynTree::Transform basePosOptimized;
+    iDynTree::JointPosDoubleArray sOptimized(ik.fullModel());
+    for (int i = 0; i < 50; i++)
+    {
+        ok = ik.solve();
+        ASSERT_IS_TRUE(ok);
+    }
+    ik.getFullJointsSolution(basePosOptimized, sOptimized);
+
+    iDynTree::KinDynComputations kinDynOpt;
+    kinDynOpt.loadRobotModel(ik.fullModel());
+    ok = kinDynOpt.setJointPos(sOptimized);
+    ASSERT_IS_TRUE(ok);
+    ok = kinDynOpt.setWorldBaseTransform(basePosOptimized);
+    ASSERT_IS_TRUE(ok);
+
+    double tolConstraints = 1e-6;
+    double tolTargets     = 1e-3;
+    ASSERT_EQUAL_TRANSFORM_TOL(kinDynDes.getWorldTransform("l_sole"), kinDynOpt.getWorldTransform("l_sole"), tolConstraints);
+    ASSERT_EQUAL_TRANSFORM_TOL(kinDynDes.getWorldTransform("r_sole"), kinDynOpt.getWorldTransform("r_sole"), tolTargets);
+    ASSERT_EQUAL_VECTOR_TOL(kinDynDes.getWorldTransform("l_elbow_1").getPosition(),
+                            kinDynOpt.getWorldTransform("l_elbow_1").getPosition(), tolTargets);
+}
+
+void simpleHumanoidWholeBodyBatchIK()
+{
+    iDynTree::InverseKinematics ik;
+
+    bool ok = ik.loadModelFromFile(getAbsModelPath("iCubGenova02.urdf"));
+    ASSERT_IS_TRUE(ok);
+    ok = ik.setNrOfWorkerThreads(2);
+    ASSERT_IS_TRUE(ok);
+
+    iDynTree::KinDynComputations kinDynDes;
+    ok = kinDynDes.loadRobotModel(ik.fullModel());
+    ASSERT_IS_TRUE(ok);
+
+    iDynTree::JointPosDoubleArray s = getRandomJointPositions(kinDynDes.model());
+    ok = kinDynDes.setJointPos(s);
+    ASSERT_IS_TRUE(ok);
+
+    ok = ik.addFrameConstraint("l_sole", kinDynDes.getWorldTransform("l_sole"));
+    ASSERT_IS_TRUE(ok);
+    ik.setDefaultTargetResolutionMode(iDynTree::InverseKinematicsTreatTargetAsConstraintNone);
+    ok = ik.addPositionTarget("l_elbow_1", kinDynDes.getWorldTransform("l_elbow_1"));
+    ASSERT_IS_TRUE(ok);
+
+    iDynTree::Transform initialH = kinDynDes.getWorldBaseTransform();
+    ik.setFullJointsInitialCondition(&initialH, &s);
+
+    // Each problem moves the elbow target to the one of a configuration close to s,
+    // and is solved from s and from a random configuration
+    std::vector<iDynTree::JointPosDoubleArray> desiredJoints;
+    std::vector<iDynTree::InverseKinematicsBatchProblem> problems(6);
+    for (iDynTree::InverseKinematicsBatchProblem& problem : problems)
+    {
+        desiredJoints.push_back(getRandomJointPositionsCloseTo(kinDynDes.model(), s, 0.1));
+        ok = kinDynDes.setJointPos(desiredJoints.back());
+        ASSERT_IS_TRUE(ok);
+        problem.targetFrames.push_back("l_elbow_1");
+        problem.targetTransforms.push_back(kinDynDes.getWorldTransform("l_elbow_1"));
+        problem.initialJointsConfigurations.push_back(s);
+        problem.initialJointsConfigurations.push_back(getRandomJointPositions(kinDynDes.model()));
+    }
+
+    std::vector<iDynTree::InverseKinematicsBatchSolution> solutions;
+    ok = ik.solveBatch(problems, solutions);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(solutions.size() == problems.size());
+
+    iDynTree::KinDynComputations kinDynOpt;
+    kinDynOpt.loadRobotModel(ik.fullModel());
+    ok = kinDynDes.setJointPos(s);
+    ASSERT_IS_TRUE(ok);
+
+    double tolConstraints = 1e-7;
+    double tolTargets     = 1e-6;
+    for (size_t i = 0; i < solutions.size(); i++)
+    {
+        ASSERT_IS_TRUE(solutions[i].isValid);
+        ASSERT_IS_TRUE(solutions[i].nrOfStarts == 2);
+        ASSERT_IS_TRUE(solutions[i].nrOfSuccessfulStarts >= 1);
+        ASSERT_IS_TRUE(solutions[i].bestStart < 2);
+
+        ok = kinDynOpt.setJointPos(solutions[i].jointsConfiguration);
+        ASSERT_IS_TRUE(ok);
+        ok = kinDynOpt.setWorldBaseTransform(solutions[i].baseTransform);
+        ASSERT_IS_TRUE(ok);
+
+        ASSERT_EQUAL_TRANSFORM_TOL(kinDynDes.getWorldTransform("l_sole"), kinDynOpt.getWorldTransform("l_sole"), tolConstraints);
+        ASSERT_EQUAL_VECTOR_TOL(problems[i].targetTransforms[0].getPosition(),
+                                kinDynOpt.getWorldTransform("l_elbow_1").getPosition(), tolTargets);
+    }
+
+    // Problems referring to frames that are not targets are rejected
+    problems[0].targetFrames[0] = "r_sole";
+    ok = ik.solveBatch(problems, solutions);
+    ASSERT_IS_FALSE(ok);
+}
+
 int main()
 {
     // Improve repetability (at least in the same platform)
@@ -626,6 +767,11 @@ int main()
     // This is not working at the moment, there is some problem with quaternion constraints
     //simpleChainIK(10,iDynTree::InverseKinematicsRotationParametrizationQuaternion);
     simpleHumanoidWholeBodyIKConsistency(iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw);
+
+    // Same problems, solved with the exact Hessian of the Lagrangian
+    simpleChainIK(2, 13, iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw, iDynTree::InverseKinematicsHessianApproximationExact);
+    simpleHumanoidWholeBodyIKConsistency(iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw, iDynTree::InverseKinematicsHessianApproximationExact);
+
     simpleHumanoidWholeBodyIKCoMConsistency(iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw, iDynTree::InverseKinematicsTreatTargetAsConstraintNone);
     simpleHumanoidWholeBodyIKCoMConsistency(iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw, iDynTree::InverseKinematicsTreatTargetAsConstraintFull);
     simpleHumanoidWholeBodyIKCoMandChestConsistency(iDynTree::InverseKinematicsRotationParametrizationRollPitchYaw, iDynTree::InverseKinematicsTreatTargetAsConstraintFull);
@@ -637,6 +783,9 @@ int main()
 
     COMConvexHullConstraintWithSwitchingConstraints();
 
+    simpleHumanoidWholeBodyDifferentialIK();
+
+    simpleHumanoidWholeBodyBatchIK();
 
     return EXIT_SUCCESS;
 }
@@ -121,6 +121,11 @@ namespace iDynTree
          */
         bool isConsistent(const Model& model);
 
+        /**
+         * Const version of isConsistent.
+         */
+        bool isConsistent(const Model& model) const;
+
         DOFSpatialMotionArray S;
         DOFSpatialForceArray U;
         JointDOFsDoubleArray D;
@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef IDYNTREE_DYNAMICS_DERIVATIVES_H
+#define IDYNTREE_DYNAMICS_DERIVATIVES_H
+
+#include <iDynTree/MatrixFixSize.h>
+#include <iDynTree/MatrixDynSize.h>
+#include <iDynTree/VectorFixSize.h>
+
+#include <iDynTree/Dynamics.h>
+#include <iDynTree/FreeFloatingMatrices.h>
+#include <iDynTree/FreeFloatingState.h>
+#include <iDynTree/LinkState.h>
+#include <iDynTree/MassMatrixFactorization.h>
+
+#include <vector>
+
+namespace iDynTree
+{
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Structure containing the internal buffers used
+     * by the InverseDynamicsDerivatives function.
+     */
+    struct InverseDynamicsDerivativesInternalBuffers
+    {
+        InverseDynamicsDerivativesInternalBuffers() {};
+
+        /**
+         * Call resize(model);
+         */
+        InverseDynamicsDerivativesInternalBuffers(const Model & model);
+
+        /**
+         * Resize all the buffers to the right size given the model,
+         * and reset all the buffers to 0.
+         */
+        void resize(const Model& model);
+
+        /**
+         * Check if the dimension of the buffer is consistent
+         * with a model (it should be after a call to resize(model) ).
+         */
+        bool isConsistent(const Model& model) const;
+
+        /**
+         * For each link, the 6x6 transform child_X_parent for motion vectors
+         * (computed at the given joint positions) and the 6x6 spatial inertia.
+         */
+        std::vector<Matrix6x6> linkTransforms;
+        std::vector<Matrix6x6> linkInertias;
+
+        /**
+         * For each link, the motion subspace vector of the joint connecting it
+         * to its parent, expressed in the link frame (zero for fixed joints and the base).
+         */
+        std::vector<Vector6> motionSubspaces;
+
+        /**
+         * Link velocities, proper accelerations and internal wrenches
+         * computed by the Recursive Newton-Euler algorithm (indexed by link).
+         */
+        std::vector<Vector6> linksVel;
+        std::vector<Vector6> linksAcc;
+        std::vector<Vector6> linksWrench;
+
+        /**
+         * Derivatives of the link velocities, proper accelerations and internal wrenches
+         * with respect to a single variable (indexed by link).
+         */
+        std::vector<Vector6> dLinksVel;
+        std::vector<Vector6> dLinksAcc;
+        std::vector<Vector6> dLinksWrench;
+
+        /**
+         * isDerivativeNonZero[l] is true if the derivative of the quantities of link l
+         * with respect to the current variable can be nonzero.
+         */
+        std::vector<bool> isDerivativeNonZero;
+    };
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Compute the inverse dynamics of a free floating model (see RNEADynamicPhase) and its analytical
+     * partial derivatives with respect to the joint positions and to the velocity of the system.
+     *
+     * The generalized torques \f$ \tau \in \mathbb{R}^{6+n} \f$ (the residual base wrench and the joint torques)
+     * are a function of the joint positions \f$ s \f$, of the body-fixed velocity \f$ \nu = ({}^B \mathrm{v}_{A,B}, \dot{s}) \f$
+     * and of the body-fixed proper acceleration \f$ \dot{\nu} \f$ of the system, for given external wrenches
+     * (expressed in the link frames). This function computes \f$ \tau \f$, \f$ \partial \tau / \partial s \f$
+     * and \f$ \partial \tau / \partial \nu \f$ with a recursive algorithm, in which the derivatives of the
+     * link velocities, accelerations and wrenches with respect to each variable are propagated only
+     * through the links on which they are nonzero (i.e. the subtree of the joint for the forward pass,
+     * and the subtree and the ancestors of the joint for the backward pass).
+     *
+     * Note that \f$ \partial \tau / \partial \dot{\nu} \f$ is the free floating mass matrix
+     * (see CompositeRigidBodyAlgorithm), and that with this choice of variables \f$ \tau \f$ does not depend on the
+     * world_H_base transform, as the gravity is included in the base proper acceleration.
+     *
+     * Only models with joints with 0 or 1 degrees of freedom whose motion subspace
+     * is constant in the child frame (i.e. iDynTree::RevoluteJoint and iDynTree::PrismaticJoint) are supported.
+     *
+     * @param[in] model the used model,
+     * @param[in] traversal the used traversal,
+     * @param[in] robotPos the robot position (only the joint positions are used),
+     * @param[in] robotVel the robot velocity, with the base velocity in body-fixed representation,
+     * @param[in] robotProperAcc the robot acceleration, with the base proper acceleration in body-fixed representation,
+     * @param[in] linkExtWrenches the external wrenches applied on the links,
+     * @param[in,out] bufs the internal buffers, consistent with the model,
+     * @param[out] baseForceAndJointTorques the generalized torques,
+     * @param[out] dTau_dJointPos the (6+n)xn matrix of the derivatives of the generalized torques with respect to the joint positions,
+     * @param[out] dTau_dVel the (6+n)x(6+n) matrix of the derivatives of the generalized torques with respect to the system velocity.
+     * @return true if all went well, false otherwise.
+     */
+    bool InverseDynamicsDerivatives(const Model& model,
+                                    const Traversal& traversal,
+                                    const FreeFloatingPos& robotPos,
+                                    const FreeFloatingVel& robotVel,
+                                    const FreeFloatingAcc& robotProperAcc,
+                                    const LinkNetExternalWrenches& linkExtWrenches,
+                                          InverseDynamicsDerivativesInternalBuffers& bufs,
+                                          FreeFloatingGeneralizedTorques& baseForceAndJointTorques,
+                                          MatrixDynSize& dTau_dJointPos,
+                                          MatrixDynSize& dTau_dVel);
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Structure containing the internal buffers used
+     * by the ForwardDynamicsDerivatives function.
+     */
+    struct ForwardDynamicsDerivativesInternalBuffers
+    {
+        ForwardDynamicsDerivativesInternalBuffers() {};
+
+        /**
+         * Call resize(model, traversal);
+         */
+        ForwardDynamicsDerivativesInternalBuffers(const Model & model, const Traversal & traversal);
+
+        /**
+         * Resize all the buffers to the right size given the model and the traversal,
+         * and reset all the buffers to 0.
+         */
+        void resize(const Model& model, const Traversal & traversal);
+
+        /**
+         * Check if the dimension of the buffer is consistent
+         * with a model (it should be after a call to resize(model, traversal) ).
+         */
+        bool isConsistent(const Model& model) const;
+
+        ArticulatedBodyAlgorithmInternalBuffers aba;
+        InverseDynamicsDerivativesInternalBuffers inverseDynamics;
+        LinkCompositeRigidBodyInertias linkCRBs;
+        FreeFloatingMassMatrix massMatrix;
+        MassMatrixLTLFactorization massMatrixFactorization;
+        FreeFloatingGeneralizedTorques generalizedTorques;
+    };
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Compute the forward dynamics of a free floating model (see ArticulatedBodyAlgorithm) and its analytical
+     * partial derivatives with respect to the joint positions, to the velocity of the system and to the joint torques.
+     *
+     * The derivatives are obtained from the ones of the inverse dynamics (see InverseDynamicsDerivatives) as
+     * \f[
+     *   \frac{\partial \dot{\nu}}{\partial s} = - M^{-1} \frac{\partial \tau}{\partial s}, \quad
+     *   \frac{\partial \dot{\nu}}{\partial \nu} = - M^{-1} \frac{\partial \tau}{\partial \nu}, \quad
+     *   \frac{\partial \dot{\nu}}{\partial \tau_s} = M^{-1} \begin{bmatrix} 0_{6 \times n} \\ 1_n \end{bmatrix},
+     * \f]
+     * where the inverse of the mass matrix is applied using its sparse factorization (see MassMatrixLTLFactorization).
+     *
+     * The same restrictions of InverseDynamicsDerivatives on the supported joints apply.
+     *
+     * @param[in] model the used model,
+     * @param[in] traversal the used traversal,
+     * @param[in] robotPos the robot position (only the joint positions are used),
+     * @param[in] robotVel the robot velocity, with the base velocity in body-fixed representation,
+     * @param[in] linkExtWrenches the external wrenches applied on the links,
+     * @param[in] jointTorques the joint torques,
+     * @param[in,out] bufs the internal buffers, consistent with the model and the traversal,
+     * @param[out] robotAcc the robot acceleration, with the base proper acceleration in body-fixed representation,
+     * @param[out] dAcc_dJointPos the (6+n)xn matrix of the derivatives of the acceleration with respect to the joint positions,
+     * @param[out] dAcc_dVel the (6+n)x(6+n) matrix of the derivatives of the acceleration with respect to the system velocity,
+     * @param[out] dAcc_dJointTorques the (6+n)xn matrix of the derivatives of the acceleration with respect to the joint torques.
+     * @return true if all went well, false otherwise.
+     */
+    bool ForwardDynamicsDerivatives(const Model& model,
+                                    const Traversal& traversal,
+                                    const FreeFloatingPos& robotPos,
+                                    const FreeFloatingVel& robotVel,
+                                    const LinkNetExternalWrenches& linkExtWrenches,
+                                    const JointDOFsDoubleArray& jointTorques,
+                                          ForwardDynamicsDerivativesInternalBuffers& bufs,
+                                          FreeFloatingAcc& robotAcc,
+                                          MatrixDynSize& dAcc_dJointPos,
+                                          MatrixDynSize& dAcc_dVel,
+                                          MatrixDynSize& dAcc_dJointTorques);
+}
+
+#endif
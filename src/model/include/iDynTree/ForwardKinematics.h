@@ -5,6 +5,10 @@
 #define IDYNTREE_FORWARD_KINEMATICS_H
 
 #include <iDynTree/Indices.h>
+#include <iDynTree/JointState.h>
+#include <iDynTree/Transform.h>
+
+#include <vector>
 
 namespace iDynTree
 {
@@ -50,6 +54,89 @@ namespace iDynTree
                                    const FreeFloatingPos & jointPos,
                                          LinkPositions   & linkPos);
 
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Buffers used by ForwardPositionKinematicsIncremental to store the
+     * robot position used in the last call, that is compared with the new one to
+     * find the links whose position changed.
+     */
+    struct ForwardPositionKinematicsIncrementalBuffers
+    {
+        ForwardPositionKinematicsIncrementalBuffers();
+
+        /**
+         * Call resize(model);
+         */
+        ForwardPositionKinematicsIncrementalBuffers(const Model & model);
+
+        /**
+         * Resize all the buffers to the right size given the model,
+         * and invalidate them.
+         */
+        void resize(const Model& model);
+
+        /**
+         * Check if the dimension of the buffer is consistent
+         * with a model (it should be after a call to resize(model) ).
+         */
+        bool isConsistent(const Model& model) const;
+
+        /**
+         * Invalidate the buffers, so that the next call to ForwardPositionKinematicsIncremental
+         * computes the position of all the links.
+         *
+         * This needs to be called if the traversal changes, or if the link positions
+         * passed to ForwardPositionKinematicsIncremental are modified by someone else.
+         */
+        void invalidate();
+
+        /**
+         * True if previousWorldHbase and previousJointPos contain the
+         * robot position for which the link positions were last computed.
+         */
+        bool isValid;
+
+        Transform previousWorldHbase;
+        JointPosDoubleArray previousJointPos;
+
+        /**
+         * isLinkPositionChanged[l] is true if the position of link l
+         * has been recomputed in the last call.
+         */
+        std::vector<bool> isLinkPositionChanged;
+
+        /**
+         * Number of links whose position has been recomputed in the last call.
+         */
+        size_t nrOfUpdatedLinks;
+    };
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Incremental version of ForwardPositionKinematics.
+     *
+     * The robot position is compared with the one used in the previous call (stored in buffers),
+     * and only the positions of the links in the subtrees rooted at the joints whose
+     * position changed are recomputed. If the world_H_base transform changed,
+     * or if the buffers are not valid, the position of all the links is computed.
+     *
+     * @param[in]  model the used model,
+     * @param[in]  traversal the used traversal,
+     * @param[in]  robotPos the robot floating base position,
+     * @param[in,out] buffers the buffers storing the robot position of the previous call,
+     * @param[in,out] linkPositions linkPositions(l) contains the world_H_link transform. It should
+     *                              not be modified between successive calls, otherwise buffers.invalidate()
+     *                              needs to be called.
+     * @return true if all went well, false otherwise.
+     */
+    bool ForwardPositionKinematicsIncremental(const Model & model,
+                                              const Traversal & traversal,
+                                              const FreeFloatingPos & robotPos,
+                                                    ForwardPositionKinematicsIncrementalBuffers & buffers,
+                                                    LinkPositions & linkPositions);
+
 
 
     /**
@@ -95,6 +182,19 @@ namespace iDynTree
                                        iDynTree::LinkPositions & linkPos,
                                        iDynTree::LinkVelArray & linkVel);
 
+    /**
+     * Function that computes the links velocities
+     * given the free floating robot position and velocities.
+     *
+     * The link velocities do not depend on the world_H_base transform,
+     * so only the joint positions contained in robotPos are used.
+     */
+    bool ForwardVelKinematics(const Model & model,
+                              const Traversal & traversal,
+                              const FreeFloatingPos & robotPos,
+                              const FreeFloatingVel & robotVel,
+                                    LinkVelArray & linkVel);
+
     /**
      * Function that computes the links accelerations
      * given the free floating robot velocities and accelerations.
@@ -149,10 +149,14 @@ namespace iDynTree
          * p_child = child_H_parent*p_parent,
          * where p_child is a quantity expressed in the child frame,
          * and   p_parent is a quantity expressed in the parent frame.
+         *
+         * \note The transform is returned by value and implementations must not
+         *       modify any internal state, so that a single Model can be used
+         *       concurrently by several threads.
          */
-        virtual const Transform & getTransform(const VectorDynSize & jntPos,
-                                               const LinkIndex child,
-                                               const LinkIndex parent) const = 0;
+        virtual Transform getTransform(const VectorDynSize & jntPos,
+                                       const LinkIndex child,
+                                       const LinkIndex parent) const = 0;
 
         /**
          * Get the derivative of the transform with
@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef IDYNTREE_MASS_MATRIX_FACTORIZATION_H
+#define IDYNTREE_MASS_MATRIX_FACTORIZATION_H
+
+#include <iDynTree/MatrixView.h>
+#include <iDynTree/Span.h>
+#include <iDynTree/SparseMatrix.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace iDynTree
+{
+    class Model;
+    class Traversal;
+
+    /**
+     * \ingroup iDynTreeModel
+     *
+     * Sparse factorization \f$ M = L^T L \f$ of the free floating mass matrix of a model,
+     * exploiting the sparsity induced by the branches of the kinematic tree.
+     *
+     * Once the degrees of freedom are ordered following the traversal (the six base degrees of freedom first,
+     * then the ones of each joint in the order in which they are visited), the element \f$ M_{ij} \f$ can be nonzero
+     * only if the degree of freedom \f$ j \f$ is an ancestor of \f$ i \f$ in the tree (or vice versa).
+     * The same holds for the lower triangular factor \f$ L \f$, that is computed without any fill-in using the
+     * LTL algorithm described in Section 6.5 of Featherstone's "Rigid Body Dynamics Algorithms" (2008),
+     * and it is stored in a compact form containing only its nonzero elements.
+     *
+     * For a model with \f$ n \f$ degrees of freedom and depth \f$ d \f$ of the tree,
+     * the factorization costs \f$ O(n d^2) \f$ and a solve costs \f$ O(n d) \f$, instead of the
+     * \f$ O(n^3) \f$ and \f$ O(n^2) \f$ of a dense Cholesky decomposition.
+     *
+     * The input mass matrix can be the one computed by iDynTree::CompositeRigidBodyAlgorithm, or the one returned by
+     * KinDynComputations::getFreeFloatingMassMatrix in any FrameVelocityRepresentation, as they share the same sparsity pattern.
+     * Once resize has been called, factorize and the solve methods do not allocate memory.
+     * The solve methods use a buffer of the object, so they are not re-entrant: the same object
+     * can not be used by multiple threads at the same time, not even only to solve.
+     */
+    class MassMatrixLTLFactorization
+    {
+    private:
+        // Number of rows (and columns) of the mass matrix
+        std::size_t m_size;
+
+        // m_permutation[p] is the index in the mass matrix of the p-th degree of freedom in the traversal order
+        std::vector<std::size_t> m_permutation;
+
+        // Row p of the factor (in traversal order) has nonzeros in the columns m_columns[m_rowStart[p]+t],
+        // for t in [0, m_rowStart[p+1]-m_rowStart[p]), i.e. p itself followed by all its ancestors in the tree.
+        // The values of these elements are stored in m_values, with the same layout.
+        std::vector<std::size_t> m_rowStart;
+        std::vector<std::size_t> m_columns;
+        std::vector<double> m_values;
+
+        // Buffer used in the solve methods
+        std::vector<double> m_buffer;
+
+        bool m_isFactorized;
+
+        // Solve M x = b in place, where b (and x) are in traversal order and stored in m_buffer
+        void solveInBuffer();
+
+    public:
+        /**
+         * Constructor.
+         */
+        MassMatrixLTLFactorization();
+
+        /**
+         * Constructor, call resize(model, traversal).
+         */
+        MassMatrixLTLFactorization(const Model& model, const Traversal& traversal);
+
+        /**
+         * Compute the sparsity pattern of the factor for a given model and traversal, and allocate the buffers.
+         *
+         * @return true if all went well, false otherwise (for example if the traversal does not contain all the links of the model).
+         */
+        bool resize(const Model& model, const Traversal& traversal);
+
+        /**
+         * Check if the buffers have been successfully resized for a model
+         * with the same number of degrees of freedom of the given one.
+         */
+        bool isConsistent(const Model& model) const;
+
+        /**
+         * Compute the factorization of the given free floating mass matrix.
+         *
+         * Only the elements of the mass matrix that belong to the sparsity pattern are accessed.
+         *
+         * @param[in] freeFloatingMassMatrix the (6+model.getNrOfDOFs())x(6+model.getNrOfDOFs()) free floating mass matrix.
+         * @return true if all went well, false otherwise (for example if the matrix is not positive definite).
+         */
+        bool factorize(MatrixView<const double> freeFloatingMassMatrix);
+
+        /**
+         * Return true if a factorization has been successfully computed.
+         */
+        bool isFactorized() const;
+
+        /**
+         * Compute \f$ x = M^{-1} b \f$.
+         *
+         * @param[in] b the vector of size 6+model.getNrOfDOFs().
+         * @param[out] x the vector of size 6+model.getNrOfDOFs(). It can be the same memory of b.
+         * @return true if all went well, false otherwise.
+         */
+        bool solve(Span<const double> b, Span<double> x);
+
+        /**
+         * Compute \f$ X = M^{-1} B \f$.
+         *
+         * @param[in] B a matrix with 6+model.getNrOfDOFs() rows.
+         * @param[out] X a matrix of the same size of B. It can be the same memory of B.
+         * @return true if all went well, false otherwise.
+         */
+        bool solve(MatrixView<const double> B, MatrixView<double> X);
+
+        /**
+         * Compute \f$ X = M^{-1} J^T \f$, without forming the transpose of J.
+         *
+         * @param[in] J a matrix with 6+model.getNrOfDOFs() columns, for example a free floating jacobian.
+         * @param[out] X a matrix with J.cols() rows and J.rows() columns.
+         * @return true if all went well, false otherwise.
+         */
+        bool multiplyInverseByTransposed(MatrixView<const double> J, MatrixView<double> X);
+
+        /**
+         * Get the factor \f$ L \f$ such that \f$ M = L^T L \f$.
+         *
+         * The rows and the columns of the returned matrix follow the ordering of the degrees of freedom
+         * of the mass matrix, so the matrix is lower triangular only if the degrees of freedom of the model
+         * are ordered as in the traversal.
+         *
+         * @note This method allocates memory.
+         */
+        bool getFactor(SparseMatrix<iDynTree::ColumnMajor>& L) const;
+
+        /**
+         * Get the number of nonzero elements of the factor.
+         */
+        std::size_t getNrOfNonZeros() const;
+    };
+}
+
+#endif
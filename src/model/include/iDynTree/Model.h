@@ -14,6 +14,7 @@
 
 #include <cstdlib>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace iDynTree
@@ -101,6 +102,18 @@ namespace iDynTree
          */
         std::vector<std::string> frameNames;
 
+        /**
+         * Hash indices from the names to the position in the linkNames, jointNames and frameNames
+         * vectors, used to implement the name-based lookups in constant time.
+         * As the names of links, joints and frames can't be modified once they are added to the
+         * model, the indices are only updated in addLink, addJoint and addAdditionalFrameToLink.
+         * The frameNameToOffset index stores the offset in the frameNames vector (and not the
+         * FrameIndex) as the FrameIndex of the additional frames changes whenever a link is added.
+         */
+        std::unordered_map<std::string, LinkIndex> linkNameToIndex;
+        std::unordered_map<std::string, JointIndex> jointNameToIndex;
+        std::unordered_map<std::string, size_t> frameNameToOffset;
+
         /** Adjacency lists: match each link index to a list of its neighbors,
             and the joint connecting to them. */
         std::vector< std::vector<Neighbor> > neighbors;
@@ -40,16 +40,16 @@ namespace iDynTree
         double m_damping;
         double m_static_friction;
 
-        // Cache attributes
-        mutable double q_previous;
-        mutable Transform link1_X_link2;
-        mutable Transform link2_X_link1;
-        mutable SpatialMotionVector S_link1_link2;
-        mutable SpatialMotionVector S_link2_link1;
+        // Buffers that depend only on the joint axis and rest transform: they are
+        // updated by the (non-const) setters, so the const methods of the joint
+        // do not modify any state and can be called concurrently by several threads
+        SpatialMotionVector S_link1_link2;
+        SpatialMotionVector S_link2_link1;
 
-        void updateBuffers(const double new_q) const;
-        void resetBuffers(const double new_q) const;
-        void resetAxisBuffers() const;
+        void resetAxisBuffers();
+
+        // Compute the link1_X_link2 transform for a given joint position
+        Transform computeLink1_X_link2(const double q) const;
 
     public:
         /**
@@ -136,9 +136,9 @@ namespace iDynTree
 
 
         // Documentation inherited
-        virtual const Transform & getTransform(const VectorDynSize & jntPos,
-                                               const LinkIndex child,
-                                               const LinkIndex parent) const;
+        virtual Transform getTransform(const VectorDynSize & jntPos,
+                                       const LinkIndex child,
+                                       const LinkIndex parent) const;
 
         // Documentation inherited
         TransformDerivative getTransformDerivative(const VectorDynSize & jntPos,
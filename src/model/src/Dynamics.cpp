@@ -15,6 +15,7 @@
 #include <iDynTree/SpatialInertia.h>
 #include <iDynTree/SpatialMomentum.h>
 #include <iDynTree/EigenHelpers.h>
+#include <iDynTree/EigenSpatialKernels.h>
 
 #include <iDynTree/Dynamics.h>
 
@@ -88,7 +89,7 @@ bool RNEADynamicPhase(const Model& model, const Traversal& traversal,
         const iDynTree::SpatialInertia & I = visitedLink->getInertia();
         const iDynTree::SpatialAcc     & a = linksAccs(visitedLinkIndex);
         const iDynTree::Twist          & v = linksVels(visitedLinkIndex);
-        f(visitedLinkIndex) = I*a + v*(I*v) - fext(visitedLinkIndex);
+        SpatialVector6d linkWrench = toEigen(I*a) + crossForce(toEigen(v),toEigen(I*v)) - toEigen(fext(visitedLinkIndex));
 
         // Iterate on childs of visitedLink
         // We obtain all the children as all the neighbors of the link, except
@@ -107,10 +108,12 @@ bool RNEADynamicPhase(const Model& model, const Traversal& traversal,
                  const Transform & visitedLink_X_child = neighborJoint->getTransform(jointPos,visitedLinkIndex,childIndex);
 
                  // One term of the sum in Equation 5.20 in Featherstone 2008
-                 f(visitedLinkIndex) = f(visitedLinkIndex) + visitedLink_X_child*f(childIndex);
+                 linkWrench += transformForceVector(visitedLink_X_child,toEigen(f(childIndex)));
              }
         }
 
+        fromEigen(f(visitedLinkIndex),linkWrench);
+
         if( parentLink == 0 )
         {
             // If the visited link is the base, the base has no parent, and hence no
@@ -183,8 +186,9 @@ bool CompositeRigidBodyAlgorithm(const Model& model,
         {
             LinkIndex parentLinkIndex = parentLink->getIndex();
 
-            linkCRBs(parentLinkIndex) = linkCRBs(parentLinkIndex) +
-                (toParentJoint->getTransform(jointPos,parentLinkIndex,visitedLinkIndex))*linkCRBs(visitedLinkIndex);
+            addTransformedSpatialInertia(toParentJoint->getTransform(jointPos,parentLinkIndex,visitedLinkIndex),
+                                         linkCRBs(visitedLinkIndex),
+                                         linkCRBs(parentLinkIndex));
 
             // For now we just implement the CRBA for 0 or 1 dofs joints.
             assert( toParentJoint->getNrOfDOFs() <= 1 );
@@ -201,12 +205,12 @@ bool CompositeRigidBodyAlgorithm(const Model& model,
                 // while S_ancestorDof (S_j in the book) is the motion subspace vector of its ancestor considered in the
                 // inner loop
                 SpatialMotionVector S_visitedDof = toParentJoint->getMotionSubspaceVector(0,visitedLink->getIndex(),parentLinkIndex);
-                SpatialForceVector  F = linkCRBs(visitedLinkIndex)*S_visitedDof;
+                SpatialVector6d F = toEigen(linkCRBs(visitedLinkIndex)*S_visitedDof);
 
                 // We compute the term of the mass matrix on the diagonal
                 // (in the book: H_ii = S_i^\top F
                 size_t dofIndex = toParentJoint->getDOFsOffset();
-                massMatrix(6+dofIndex,6+dofIndex) = S_visitedDof.dot(F);
+                massMatrix(6+dofIndex,6+dofIndex) = toEigen(S_visitedDof).dot(F);
 
                 // Then we compute all the off-diagonal terms relative to
                 // the ancestors of the currently visited link
@@ -220,8 +224,7 @@ bool CompositeRigidBodyAlgorithm(const Model& model,
                     {
                         IJointConstPtr ancestorToParentJoint = traversal.getParentJointFromLinkIndex(ancestor->getIndex());
                         LinkIndex      ancestorParent =        traversal.getParentLinkFromLinkIndex(ancestor->getIndex())->getIndex();
-                        Transform ancestorParent_X_ancestor = ancestorToParentJoint->getTransform(jointPos,ancestorParent,ancestor->getIndex());
-                        F = ancestorParent_X_ancestor*F;
+                        F = transformForceVector(ancestorToParentJoint->getTransform(jointPos,ancestorParent,ancestor->getIndex()),F);
                     }
 
                     // j = \lambda(j)
@@ -242,7 +245,7 @@ bool CompositeRigidBodyAlgorithm(const Model& model,
 
                         // H_ij = F^\top S_j
                         // H_ji = H_ij^\top
-                        massMatrix(6+dofIndex,6+ancestorDofIndex) = S_ancestorDof.dot(F);
+                        massMatrix(6+dofIndex,6+ancestorDofIndex) = toEigen(S_ancestorDof).dot(F);
                         massMatrix(6+ancestorDofIndex,6+dofIndex) = massMatrix(6+dofIndex,6+ancestorDofIndex);
                     }
                 }
@@ -251,15 +254,13 @@ bool CompositeRigidBodyAlgorithm(const Model& model,
                 {
                     IJointConstPtr ancestorToParentJoint = traversal.getParentJointFromLinkIndex(ancestor->getIndex());
                     LinkIndex      ancestorParent =        traversal.getParentLinkFromLinkIndex(ancestor->getIndex())->getIndex();
-                    Transform ancestorParent_X_ancestor = ancestorToParentJoint->getTransform(jointPos,ancestorParent,ancestor->getIndex());
-                    F = ancestorParent_X_ancestor*F;
+                    F = transformForceVector(ancestorToParentJoint->getTransform(jointPos,ancestorParent,ancestor->getIndex()),F);
                 }
 
                 // Fill the 6 \times nDof right top submatrix of the mass matrix
                 // (i.e. the jacobian of the momentum)
-                Eigen::Matrix<double,6,1> FEigen = toEigen(F);
-                massMatrixEigen.block<6,1>(0,6+dofIndex) = FEigen;
-                massMatrixEigen.block<1,6>(6+dofIndex,0) = FEigen;
+                massMatrixEigen.block<6,1>(0,6+dofIndex) = F;
+                massMatrixEigen.block<1,6>(6+dofIndex,0) = F.transpose();
             }
 
         }
@@ -293,6 +294,11 @@ void ArticulatedBodyAlgorithmInternalBuffers::resize(const Model& model)
 }
 
 bool ArticulatedBodyAlgorithmInternalBuffers::isConsistent(const Model& model)
+{
+    return static_cast<const ArticulatedBodyAlgorithmInternalBuffers*>(this)->isConsistent(model);
+}
+
+bool ArticulatedBodyAlgorithmInternalBuffers::isConsistent(const Model& model) const
 {
     bool ok = true;
 
@@ -343,21 +349,21 @@ bool ArticulatedBodyAlgorithm(const Model& model,
             // Otherwise we propagate velocity in the usual way
             if( toParentJoint->getNrOfDOFs() == 0 )
             {
-                bufs.linksVel(visitedLinkIndex) =
-                    toParentJoint->getTransform(robotPos.jointPos(),visitedLinkIndex,parentLink->getIndex())*bufs.linksVel(parentLinkIndex);
+                fromEigen(bufs.linksVel(visitedLinkIndex),
+                          inverseTransformMotionVector(toParentJoint->getTransform(robotPos.jointPos(),parentLinkIndex,visitedLinkIndex),
+                                                       toEigen(bufs.linksVel(parentLinkIndex))));
                 bufs.linksBiasAcceleration(visitedLinkIndex) = SpatialAcc::Zero();
             }
             else
             {
                 size_t dofIndex = toParentJoint->getDOFsOffset();
                 bufs.S(dofIndex) = toParentJoint->getMotionSubspaceVector(0,visitedLinkIndex,parentLinkIndex);
-                Twist vj;
-                toEigen(vj.getLinearVec3()) = robotVel.jointVel()(dofIndex)*toEigen(bufs.S(dofIndex).getLinearVec3());
-                toEigen(vj.getAngularVec3()) = robotVel.jointVel()(dofIndex)*toEigen(bufs.S(dofIndex).getAngularVec3());
-                bufs.linksVel(visitedLinkIndex) =
-                    toParentJoint->getTransform(robotPos.jointPos(),visitedLinkIndex,parentLinkIndex)*bufs.linksVel(parentLinkIndex)
-                    + vj;
-                bufs.linksBiasAcceleration(visitedLinkIndex) = bufs.linksVel(visitedLinkIndex)*vj;
+                SpatialVector6d vj = robotVel.jointVel()(dofIndex)*toEigen(bufs.S(dofIndex));
+                SpatialVector6d v =
+                    inverseTransformMotionVector(toParentJoint->getTransform(robotPos.jointPos(),parentLinkIndex,visitedLinkIndex),
+                                                 toEigen(bufs.linksVel(parentLinkIndex))) + vj;
+                fromEigen(bufs.linksVel(visitedLinkIndex),v);
+                fromEigen(bufs.linksBiasAcceleration(visitedLinkIndex),crossMotion(v,vj));
 
             }
         }
@@ -425,7 +431,8 @@ bool ArticulatedBodyAlgorithm(const Model& model,
             LinkIndex parentLinkIndex = parentLink->getIndex();
             Transform parent_X_visited = toParentJoint->getTransform(robotPos.jointPos(),parentLinkIndex,visitedLinkIndex);
             bufs.linkABIs(parentLinkIndex)        += parent_X_visited*Ia;
-            bufs.linksBiasWrench(parentLinkIndex) = bufs.linksBiasWrench(parentLinkIndex) + parent_X_visited*pa;
+            fromEigen(bufs.linksBiasWrench(parentLinkIndex),
+                      toEigen(bufs.linksBiasWrench(parentLinkIndex)) + transformForceVector(parent_X_visited,toEigen(pa)));
         }
     }
 
@@ -455,18 +462,20 @@ bool ArticulatedBodyAlgorithm(const Model& model,
            {
                size_t dofIndex = toParentJoint->getDOFsOffset();
                assert(toParentJoint->getNrOfDOFs()==1);
-               bufs.linksAccelerations(visitedLinkIndex) =
-                   toParentJoint->getTransform(robotPos.jointPos(),visitedLinkIndex,parentLinkIndex)*bufs.linksAccelerations(parentLinkIndex)
-                   + bufs.linksBiasAcceleration(visitedLinkIndex);
+               fromEigen(bufs.linksAccelerations(visitedLinkIndex),
+                         inverseTransformMotionVector(toParentJoint->getTransform(robotPos.jointPos(),parentLinkIndex,visitedLinkIndex),
+                                                      toEigen(bufs.linksAccelerations(parentLinkIndex)))
+                         + toEigen(bufs.linksBiasAcceleration(visitedLinkIndex)));
                robotAcc.jointAcc()(dofIndex) = (bufs.u(dofIndex)-bufs.U(dofIndex).dot(bufs.linksAccelerations(visitedLinkIndex)))/bufs.D(dofIndex);
                bufs.linksAccelerations(visitedLinkIndex) = bufs.linksAccelerations(visitedLinkIndex) + bufs.S(dofIndex)*robotAcc.jointAcc()(dofIndex);
            }
            else
            {
                //for fixed joints we just propagate the acceleration
-               bufs.linksAccelerations(visitedLinkIndex) =
-                   toParentJoint->getTransform(robotPos.jointPos(),visitedLinkIndex,parentLinkIndex)*bufs.linksAccelerations(parentLinkIndex)
-                   + bufs.linksBiasAcceleration(visitedLinkIndex);
+               fromEigen(bufs.linksAccelerations(visitedLinkIndex),
+                         inverseTransformMotionVector(toParentJoint->getTransform(robotPos.jointPos(),parentLinkIndex,visitedLinkIndex),
+                                                      toEigen(bufs.linksAccelerations(parentLinkIndex)))
+                         + toEigen(bufs.linksBiasAcceleration(visitedLinkIndex)));
            }
        }
     }
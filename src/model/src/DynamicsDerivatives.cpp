@@ -0,0 +1,402 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/DynamicsDerivatives.h>
+
+#include <iDynTree/Model.h>
+#include <iDynTree/Traversal.h>
+#include <iDynTree/FixedJoint.h>
+#include <iDynTree/RevoluteJoint.h>
+#include <iDynTree/PrismaticJoint.h>
+
+#include <iDynTree/FreeFloatingState.h>
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/EigenSpatialKernels.h>
+
+namespace iDynTree
+{
+
+namespace
+{
+    bool isJointSupportedByDerivatives(IJointConstPtr joint)
+    {
+        return dynamic_cast<const FixedJoint*>(joint) != nullptr ||
+               dynamic_cast<const RevoluteJoint*>(joint) != nullptr ||
+               dynamic_cast<const PrismaticJoint*>(joint) != nullptr;
+    }
+
+    /**
+     * Given the derivative of the velocity and of the acceleration of the link visited at the traversal
+     * element startEl (that are already stored in bufs.dLinksVel and bufs.dLinksAcc) with respect to a variable,
+     * propagate them to the subtree of the link, then compute the derivatives of the link wrenches and
+     * of the generalized torques. The result is stored in the column col of dTau.
+     *
+     * If isJointPosDerivative is true, the variable is the position of the joint connecting
+     * the link visited at startEl to its parent, so the derivative of the transform between the two links
+     * is also accounted for.
+     */
+    void propagateInverseDynamicsDerivative(const Traversal& traversal,
+                                            const FreeFloatingVel& robotVel,
+                                            const unsigned int startEl,
+                                            const bool isJointPosDerivative,
+                                            InverseDynamicsDerivativesInternalBuffers& bufs,
+                                            MatrixDynSize& dTau,
+                                            const size_t col)
+    {
+        Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> > dTauEigen = toEigen(dTau);
+        dTauEigen.col(col).setZero();
+
+        std::fill(bufs.isDerivativeNonZero.begin(), bufs.isDerivativeNonZero.end(), false);
+
+        LinkIndex startLinkIndex = traversal.getLink(startEl)->getIndex();
+        bufs.isDerivativeNonZero[startLinkIndex] = true;
+        toEigen(bufs.dLinksWrench[startLinkIndex]).setZero();
+
+        // Forward pass on the subtree of the start link (as the traversal visits the parents before the children,
+        // the links visited before startEl can not belong to its subtree)
+        for (unsigned int traversalEl=startEl+1; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+        {
+            LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+            LinkIndex parentLinkIndex  = traversal.getParentLink(traversalEl)->getIndex();
+
+            if (!bufs.isDerivativeNonZero[parentLinkIndex])
+            {
+                continue;
+            }
+
+            bufs.isDerivativeNonZero[visitedLinkIndex] = true;
+
+            const auto X = toEigen(bufs.linkTransforms[visitedLinkIndex]);
+            IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+            SpatialVector6d dv = X*toEigen(bufs.dLinksVel[parentLinkIndex]);
+            SpatialVector6d da = X*toEigen(bufs.dLinksAcc[parentLinkIndex]);
+            if (toParentJoint->getNrOfDOFs() > 0)
+            {
+                SpatialVector6d vj = toEigen(bufs.motionSubspaces[visitedLinkIndex])*robotVel.jointVel()(toParentJoint->getDOFsOffset());
+                da += crossMotion(dv, vj);
+            }
+            toEigen(bufs.dLinksVel[visitedLinkIndex]) = dv;
+            toEigen(bufs.dLinksAcc[visitedLinkIndex]) = da;
+            toEigen(bufs.dLinksWrench[visitedLinkIndex]).setZero();
+        }
+
+        // The wrenches of the ancestors of the start link also depend on the variable,
+        // through the wrenches transmitted by their children
+        for (LinkConstPtr ancestor = traversal.getParentLinkFromLinkIndex(startLinkIndex);
+             ancestor != 0;
+             ancestor = traversal.getParentLinkFromLinkIndex(ancestor->getIndex()))
+        {
+            LinkIndex ancestorIndex = ancestor->getIndex();
+            bufs.isDerivativeNonZero[ancestorIndex] = true;
+            toEigen(bufs.dLinksVel[ancestorIndex]).setZero();
+            toEigen(bufs.dLinksAcc[ancestorIndex]).setZero();
+            toEigen(bufs.dLinksWrench[ancestorIndex]).setZero();
+        }
+
+        // Backward pass on the subtree and on the ancestors of the start link
+        for (int traversalEl = traversal.getNrOfVisitedLinks()-1; traversalEl >= 0; traversalEl--)
+        {
+            LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+            if (!bufs.isDerivativeNonZero[visitedLinkIndex])
+            {
+                continue;
+            }
+
+            LinkConstPtr parentLink = traversal.getParentLink(traversalEl);
+            IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+            // Derivative of f = I*a + v \bar\times^* I*v - f_ext + \sum_c c_X_link^T f_c
+            const auto I = toEigen(bufs.linkInertias[visitedLinkIndex]);
+            auto df = toEigen(bufs.dLinksWrench[visitedLinkIndex]);
+            const auto v = toEigen(bufs.linksVel[visitedLinkIndex]);
+            const auto dv = toEigen(bufs.dLinksVel[visitedLinkIndex]);
+            df += I*toEigen(bufs.dLinksAcc[visitedLinkIndex]) + crossForce(dv, I*v) + crossForce(v, I*dv);
+
+            if (parentLink == 0)
+            {
+                dTauEigen.col(col).head<6>() = df;
+                continue;
+            }
+
+            LinkIndex parentLinkIndex = parentLink->getIndex();
+            const auto X = toEigen(bufs.linkTransforms[visitedLinkIndex]);
+
+            if (toParentJoint->getNrOfDOFs() > 0)
+            {
+                const auto S = toEigen(bufs.motionSubspaces[visitedLinkIndex]);
+                dTauEigen(6+toParentJoint->getDOFsOffset(), col) = S.dot(df);
+
+                if (isJointPosDerivative && traversalEl == static_cast<int>(startEl))
+                {
+                    // The derivative of the force transform parent_X_link^* = link_X_parent^T
+                    // is link_X_parent^T (S \bar\times^*)
+                    SpatialVector6d dfToParent = df + crossForce(S, toEigen(bufs.linksWrench[visitedLinkIndex]));
+                    toEigen(bufs.dLinksWrench[parentLinkIndex]) += X.transpose()*dfToParent;
+                    continue;
+                }
+            }
+
+            toEigen(bufs.dLinksWrench[parentLinkIndex]) += X.transpose()*df;
+        }
+    }
+}
+
+InverseDynamicsDerivativesInternalBuffers::InverseDynamicsDerivativesInternalBuffers(const Model& model)
+{
+    resize(model);
+}
+
+void InverseDynamicsDerivativesInternalBuffers::resize(const Model& model)
+{
+    linkTransforms.resize(model.getNrOfLinks());
+    linkInertias.resize(model.getNrOfLinks());
+    motionSubspaces.resize(model.getNrOfLinks());
+    for (LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+    {
+        linkTransforms[lnk].zero();
+        linkInertias[lnk] = model.getLink(lnk)->getInertia().asMatrix();
+        motionSubspaces[lnk].zero();
+    }
+
+    Vector6 zero;
+    zero.zero();
+    linksVel.assign(model.getNrOfLinks(), zero);
+    linksAcc.assign(model.getNrOfLinks(), zero);
+    linksWrench.assign(model.getNrOfLinks(), zero);
+    dLinksVel.assign(model.getNrOfLinks(), zero);
+    dLinksAcc.assign(model.getNrOfLinks(), zero);
+    dLinksWrench.assign(model.getNrOfLinks(), zero);
+    isDerivativeNonZero.assign(model.getNrOfLinks(), false);
+}
+
+bool InverseDynamicsDerivativesInternalBuffers::isConsistent(const Model& model) const
+{
+    return linkTransforms.size() == model.getNrOfLinks() &&
+           linkInertias.size() == model.getNrOfLinks() &&
+           motionSubspaces.size() == model.getNrOfLinks() &&
+           linksVel.size() == model.getNrOfLinks() &&
+           linksAcc.size() == model.getNrOfLinks() &&
+           linksWrench.size() == model.getNrOfLinks() &&
+           dLinksVel.size() == model.getNrOfLinks() &&
+           dLinksAcc.size() == model.getNrOfLinks() &&
+           dLinksWrench.size() == model.getNrOfLinks() &&
+           isDerivativeNonZero.size() == model.getNrOfLinks();
+}
+
+bool InverseDynamicsDerivatives(const Model& model,
+                                const Traversal& traversal,
+                                const FreeFloatingPos& robotPos,
+                                const FreeFloatingVel& robotVel,
+                                const FreeFloatingAcc& robotProperAcc,
+                                const LinkNetExternalWrenches& linkExtWrenches,
+                                      InverseDynamicsDerivativesInternalBuffers& bufs,
+                                      FreeFloatingGeneralizedTorques& baseForceAndJointTorques,
+                                      MatrixDynSize& dTau_dJointPos,
+                                      MatrixDynSize& dTau_dVel)
+{
+    if (!bufs.isConsistent(model))
+    {
+        reportError("","InverseDynamicsDerivatives","Buffers are not consistent with the model");
+        return false;
+    }
+
+    const size_t nrOfDOFs = model.getNrOfDOFs();
+    dTau_dJointPos.resize(6+nrOfDOFs, nrOfDOFs);
+    dTau_dVel.resize(6+nrOfDOFs, 6+nrOfDOFs);
+
+    // Forward pass: compute the transforms, the velocities and the proper accelerations of the links
+    for (unsigned int traversalEl=0; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+        LinkConstPtr parentLink = traversal.getParentLink(traversalEl);
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+        if (parentLink == 0)
+        {
+            toEigen(bufs.linksVel[visitedLinkIndex]) = toEigen(robotVel.baseVel());
+            toEigen(bufs.linksAcc[visitedLinkIndex]) = toEigen(robotProperAcc.baseAcc());
+            continue;
+        }
+
+        if (!isJointSupportedByDerivatives(toParentJoint))
+        {
+            reportError("","InverseDynamicsDerivatives","Only fixed, revolute and prismatic joints are supported");
+            return false;
+        }
+
+        LinkIndex parentLinkIndex = parentLink->getIndex();
+        bufs.linkTransforms[visitedLinkIndex] =
+            toParentJoint->getTransform(robotPos.jointPos(), visitedLinkIndex, parentLinkIndex).asAdjointTransform();
+        const auto X = toEigen(bufs.linkTransforms[visitedLinkIndex]);
+
+        SpatialVector6d v = X*toEigen(bufs.linksVel[parentLinkIndex]);
+        SpatialVector6d a = X*toEigen(bufs.linksAcc[parentLinkIndex]);
+
+        if (toParentJoint->getNrOfDOFs() > 0)
+        {
+            size_t dofIndex = toParentJoint->getDOFsOffset();
+            toEigen(bufs.motionSubspaces[visitedLinkIndex]) =
+                toEigen(toParentJoint->getMotionSubspaceVector(0, visitedLinkIndex, parentLinkIndex));
+            const auto S = toEigen(bufs.motionSubspaces[visitedLinkIndex]);
+            SpatialVector6d vj = S*robotVel.jointVel()(dofIndex);
+            v += vj;
+            a += S*robotProperAcc.jointAcc()(dofIndex) + crossMotion(v, vj);
+        }
+        else
+        {
+            bufs.motionSubspaces[visitedLinkIndex].zero();
+        }
+
+        toEigen(bufs.linksVel[visitedLinkIndex]) = v;
+        toEigen(bufs.linksAcc[visitedLinkIndex]) = a;
+    }
+
+    // Backward pass: compute the link wrenches and the generalized torques
+    for (unsigned int traversalEl=0; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+    {
+        LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+        const auto I = toEigen(bufs.linkInertias[visitedLinkIndex]);
+        const auto v = toEigen(bufs.linksVel[visitedLinkIndex]);
+        toEigen(bufs.linksWrench[visitedLinkIndex]) = I*toEigen(bufs.linksAcc[visitedLinkIndex])
+                                                      + crossForce(v, I*v)
+                                                      - toEigen(linkExtWrenches(visitedLinkIndex));
+    }
+
+    for (int traversalEl = traversal.getNrOfVisitedLinks()-1; traversalEl >= 0; traversalEl--)
+    {
+        LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+        LinkConstPtr parentLink = traversal.getParentLink(traversalEl);
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+        const auto f = toEigen(bufs.linksWrench[visitedLinkIndex]);
+
+        if (parentLink == 0)
+        {
+            fromEigen(baseForceAndJointTorques.baseWrench(), f);
+            continue;
+        }
+
+        if (toParentJoint->getNrOfDOFs() > 0)
+        {
+            baseForceAndJointTorques.jointTorques()(toParentJoint->getDOFsOffset()) =
+                toEigen(bufs.motionSubspaces[visitedLinkIndex]).dot(f);
+        }
+
+        toEigen(bufs.linksWrench[parentLink->getIndex()]) += toEigen(bufs.linkTransforms[visitedLinkIndex]).transpose()*f;
+    }
+
+    // Derivatives with respect to the base velocity: the derivatives of all the link velocities are nonzero
+    LinkIndex baseLinkIndex = traversal.getBaseLink()->getIndex();
+    for (size_t i=0; i < 6; i++)
+    {
+        toEigen(bufs.dLinksVel[baseLinkIndex]) = SpatialVector6d::Unit(i);
+        toEigen(bufs.dLinksAcc[baseLinkIndex]).setZero();
+        propagateInverseDynamicsDerivative(traversal, robotVel, 0, false, bufs, dTau_dVel, i);
+    }
+
+    // Derivatives with respect to the joint positions and velocities
+    for (unsigned int traversalEl=1; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+    {
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+        if (toParentJoint->getNrOfDOFs() == 0)
+        {
+            continue;
+        }
+
+        LinkIndex visitedLinkIndex = traversal.getLink(traversalEl)->getIndex();
+        LinkIndex parentLinkIndex = traversal.getParentLink(traversalEl)->getIndex();
+        size_t dofIndex = toParentJoint->getDOFsOffset();
+        const auto X = toEigen(bufs.linkTransforms[visitedLinkIndex]);
+        const auto S = toEigen(bufs.motionSubspaces[visitedLinkIndex]);
+        const auto v = toEigen(bufs.linksVel[visitedLinkIndex]);
+        SpatialVector6d vj = S*robotVel.jointVel()(dofIndex);
+
+        // Joint position: d(link_X_parent)/ds = -(S \times) link_X_parent
+        SpatialVector6d dv = -crossMotion(S, X*toEigen(bufs.linksVel[parentLinkIndex]));
+        toEigen(bufs.dLinksAcc[visitedLinkIndex]) = -crossMotion(S, X*toEigen(bufs.linksAcc[parentLinkIndex])) + crossMotion(dv, vj);
+        toEigen(bufs.dLinksVel[visitedLinkIndex]) = dv;
+        propagateInverseDynamicsDerivative(traversal, robotVel, traversalEl, true, bufs, dTau_dJointPos, dofIndex);
+
+        // Joint velocity: the derivative of v \times (S \dot{s}) is (S \times S) \dot{s} + v \times S = v \times S
+        toEigen(bufs.dLinksVel[visitedLinkIndex]) = S;
+        toEigen(bufs.dLinksAcc[visitedLinkIndex]) = crossMotion(v, S);
+        propagateInverseDynamicsDerivative(traversal, robotVel, traversalEl, false, bufs, dTau_dVel, 6+dofIndex);
+    }
+
+    return true;
+}
+
+ForwardDynamicsDerivativesInternalBuffers::ForwardDynamicsDerivativesInternalBuffers(const Model& model, const Traversal& traversal)
+{
+    resize(model, traversal);
+}
+
+void ForwardDynamicsDerivativesInternalBuffers::resize(const Model& model, const Traversal& traversal)
+{
+    aba.resize(model);
+    inverseDynamics.resize(model);
+    linkCRBs.resize(model);
+    massMatrix.resize(model);
+    massMatrixFactorization.resize(model, traversal);
+    generalizedTorques.resize(model);
+}
+
+bool ForwardDynamicsDerivativesInternalBuffers::isConsistent(const Model& model) const
+{
+    return aba.isConsistent(model) &&
+           inverseDynamics.isConsistent(model) &&
+           linkCRBs.isConsistent(model) &&
+           massMatrix.rows() == 6+model.getNrOfDOFs() &&
+           massMatrixFactorization.isConsistent(model) &&
+           generalizedTorques.jointTorques().size() == model.getNrOfDOFs();
+}
+
+bool ForwardDynamicsDerivatives(const Model& model,
+                                const Traversal& traversal,
+                                const FreeFloatingPos& robotPos,
+                                const FreeFloatingVel& robotVel,
+                                const LinkNetExternalWrenches& linkExtWrenches,
+                                const JointDOFsDoubleArray& jointTorques,
+                                      ForwardDynamicsDerivativesInternalBuffers& bufs,
+                                      FreeFloatingAcc& robotAcc,
+                                      MatrixDynSize& dAcc_dJointPos,
+                                      MatrixDynSize& dAcc_dVel,
+                                      MatrixDynSize& dAcc_dJointTorques)
+{
+    if (!bufs.isConsistent(model))
+    {
+        reportError("","ForwardDynamicsDerivatives","Buffers are not consistent with the model");
+        return false;
+    }
+
+    bool ok = ArticulatedBodyAlgorithm(model, traversal, robotPos, robotVel, linkExtWrenches, jointTorques, bufs.aba, robotAcc);
+
+    // The inverse dynamics derivatives are evaluated at the acceleration given by the forward dynamics,
+    // and are directly stored in the output matrices that are then multiplied by -M^{-1}
+    ok = ok && InverseDynamicsDerivatives(model, traversal, robotPos, robotVel, robotAcc, linkExtWrenches,
+                                          bufs.inverseDynamics, bufs.generalizedTorques, dAcc_dJointPos, dAcc_dVel);
+
+    ok = ok && CompositeRigidBodyAlgorithm(model, traversal, robotPos.jointPos(), bufs.linkCRBs, bufs.massMatrix);
+    ok = ok && bufs.massMatrixFactorization.factorize(bufs.massMatrix);
+
+    if (!ok)
+    {
+        reportError("","ForwardDynamicsDerivatives","Error in computing the forward dynamics derivatives");
+        return false;
+    }
+
+    toEigen(dAcc_dJointPos) = -toEigen(dAcc_dJointPos);
+    toEigen(dAcc_dVel) = -toEigen(dAcc_dVel);
+    ok = bufs.massMatrixFactorization.solve(dAcc_dJointPos, dAcc_dJointPos);
+    ok = ok && bufs.massMatrixFactorization.solve(dAcc_dVel, dAcc_dVel);
+
+    const size_t nrOfDOFs = model.getNrOfDOFs();
+    dAcc_dJointTorques.resize(6+nrOfDOFs, nrOfDOFs);
+    toEigen(dAcc_dJointTorques).topRows<6>().setZero();
+    toEigen(dAcc_dJointTorques).bottomRows(nrOfDOFs).setIdentity();
+    ok = ok && bufs.massMatrixFactorization.solve(dAcc_dJointTorques, dAcc_dJointTorques);
+
+    return ok;
+}
+
+}
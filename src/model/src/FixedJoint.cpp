@@ -95,7 +95,7 @@ Transform FixedJoint::getRestTransform(const LinkIndex child, const LinkIndex pa
     }
 }
 
-const Transform & FixedJoint::getTransform(const VectorDynSize & jntPos, const LinkIndex child, const LinkIndex parent) const
+Transform FixedJoint::getTransform(const VectorDynSize & jntPos, const LinkIndex child, const LinkIndex parent) const
 {
     if( child == this->link1 )
     {
@@ -9,6 +9,8 @@
 
 #include <iDynTree/FreeFloatingState.h>
 #include <iDynTree/LinkState.h>
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/EigenSpatialKernels.h>
 
 namespace iDynTree
 {
@@ -48,15 +50,118 @@ bool ForwardPositionKinematics(const Model& model,
         {
             // Otherwise we compute the world_H_link transform as:
             // world_H_link = world_H_parentLink * parentLink_H_link
-            linkPositions(visitedLink->getIndex()) =
-                linkPositions(parentLink->getIndex())*
-                    toParentJoint->getTransform(jointPositions,parentLink->getIndex(),visitedLink->getIndex());
+            composeTransforms(linkPositions(parentLink->getIndex()),
+                              toParentJoint->getTransform(jointPositions,parentLink->getIndex(),visitedLink->getIndex()),
+                              linkPositions(visitedLink->getIndex()));
         }
     }
 
     return retValue;
 }
 
+ForwardPositionKinematicsIncrementalBuffers::ForwardPositionKinematicsIncrementalBuffers():
+    isValid(false),
+    nrOfUpdatedLinks(0)
+{
+}
+
+ForwardPositionKinematicsIncrementalBuffers::ForwardPositionKinematicsIncrementalBuffers(const Model& model)
+{
+    resize(model);
+}
+
+void ForwardPositionKinematicsIncrementalBuffers::resize(const Model& model)
+{
+    previousJointPos.resize(model);
+    isLinkPositionChanged.assign(model.getNrOfLinks(), true);
+    invalidate();
+}
+
+bool ForwardPositionKinematicsIncrementalBuffers::isConsistent(const Model& model) const
+{
+    return previousJointPos.isConsistent(model) &&
+           isLinkPositionChanged.size() == model.getNrOfLinks();
+}
+
+void ForwardPositionKinematicsIncrementalBuffers::invalidate()
+{
+    isValid = false;
+    nrOfUpdatedLinks = 0;
+}
+
+bool ForwardPositionKinematicsIncremental(const Model& model,
+                                          const Traversal& traversal,
+                                          const FreeFloatingPos& robotPos,
+                                                ForwardPositionKinematicsIncrementalBuffers& buffers,
+                                                LinkPositions& linkPositions)
+{
+    if( !buffers.isConsistent(model) )
+    {
+        reportError("","ForwardPositionKinematicsIncremental","buffers are not consistent with the model");
+        return false;
+    }
+
+    const Transform & worldHbase = robotPos.worldBasePos();
+    const JointPosDoubleArray & jointPositions = robotPos.jointPos();
+
+    // If the base moved, all the links moved
+    bool isBaseChanged = !buffers.isValid ||
+                         !(toEigen(worldHbase.getRotation()) == toEigen(buffers.previousWorldHbase.getRotation())) ||
+                         !(toEigen(worldHbase.getPosition()) == toEigen(buffers.previousWorldHbase.getPosition()));
+
+    buffers.nrOfUpdatedLinks = 0;
+
+    for(unsigned int traversalEl=0; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+    {
+        LinkConstPtr visitedLink = traversal.getLink(traversalEl);
+        LinkConstPtr parentLink  = traversal.getParentLink(traversalEl);
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+        LinkIndex visitedLinkIndex = visitedLink->getIndex();
+
+        bool isChanged = isBaseChanged;
+
+        if( !isChanged && parentLink != 0 )
+        {
+            // As the traversal visits the parent before the child, the parent flag is already updated
+            isChanged = buffers.isLinkPositionChanged[parentLink->getIndex()];
+
+            // Otherwise, the link moved only if the position of the parent joint changed
+            size_t offset = toParentJoint->getPosCoordsOffset();
+            for(unsigned int i=0; !isChanged && i < toParentJoint->getNrOfPosCoords(); i++)
+            {
+                isChanged = (jointPositions(offset+i) != buffers.previousJointPos(offset+i));
+            }
+        }
+
+        buffers.isLinkPositionChanged[visitedLinkIndex] = isChanged;
+
+        if( !isChanged )
+        {
+            continue;
+        }
+
+        buffers.nrOfUpdatedLinks++;
+
+        if( parentLink == 0 )
+        {
+            linkPositions(visitedLinkIndex) = worldHbase;
+        }
+        else
+        {
+            // world_H_link = world_H_parentLink * parentLink_H_link
+            composeTransforms(linkPositions(parentLink->getIndex()),
+                              toParentJoint->getTransform(jointPositions,parentLink->getIndex(),visitedLinkIndex),
+                              linkPositions(visitedLinkIndex));
+        }
+    }
+
+    buffers.previousWorldHbase = worldHbase;
+    toEigen(buffers.previousJointPos) = toEigen(jointPositions);
+    buffers.isValid = true;
+
+    return true;
+}
+
 bool ForwardPosVelAccKinematics(const Model& model, const Traversal& traversal,
                                 const FreeFloatingPos& robotPos,
                                 const FreeFloatingVel& robotVel,
@@ -169,9 +274,9 @@ bool ForwardPosVelKinematics(const Model& model,
         {
             // Otherwise we compute the world_H_link transform as:
             // world_H_link = world_H_parentLink * parentLink_H_link
-            linkPos(visitedLink->getIndex()) =
-                linkPos(parentLink->getIndex()) *
-                    toParentJoint->getTransform(robotPos.jointPos(),parentLink->getIndex(),visitedLink->getIndex());
+            composeTransforms(linkPos(parentLink->getIndex()),
+                              toParentJoint->getTransform(robotPos.jointPos(),parentLink->getIndex(),visitedLink->getIndex()),
+                              linkPos(visitedLink->getIndex()));
 
             // The link velocity are recursivly
             // compute from the joint position, velocities
@@ -186,6 +291,38 @@ bool ForwardPosVelKinematics(const Model& model,
     return retValue;
 }
 
+bool ForwardVelKinematics(const Model& model,
+                          const Traversal& traversal,
+                          const FreeFloatingPos& robotPos,
+                          const FreeFloatingVel& robotVel,
+                                LinkVelArray& linkVel)
+{
+    bool retValue = true;
+
+    for (TraversalIndex traversalEl=0; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+    {
+        LinkConstPtr visitedLink = traversal.getLink(traversalEl);
+        LinkConstPtr parentLink  = traversal.getParentLink(traversalEl);
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+        if (parentLink == 0)
+        {
+            // If the visited link is the base, its velocity is the base velocity
+            linkVel(visitedLink->getIndex()) = robotVel.baseVel();
+        }
+        else
+        {
+            // Otherwise we compute the child velocity from the parent one
+            toParentJoint->computeChildVel(robotPos.jointPos(),
+                                           robotVel.jointVel(),
+                                           linkVel,
+                                           visitedLink->getIndex(),parentLink->getIndex());
+        }
+    }
+
+    return retValue;
+}
+
 bool ForwardAccKinematics(const Model& model,
                           const Traversal& traversal,
                           const FreeFloatingPos & robotPos,
@@ -0,0 +1,319 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/MassMatrixFactorization.h>
+
+#include <iDynTree/Model.h>
+#include <iDynTree/Traversal.h>
+#include <iDynTree/Triplets.h>
+
+#include <cmath>
+
+namespace iDynTree
+{
+
+MassMatrixLTLFactorization::MassMatrixLTLFactorization():
+    m_size(0),
+    m_isFactorized(false)
+{
+}
+
+MassMatrixLTLFactorization::MassMatrixLTLFactorization(const Model& model, const Traversal& traversal):
+    m_size(0),
+    m_isFactorized(false)
+{
+    resize(model, traversal);
+}
+
+bool MassMatrixLTLFactorization::resize(const Model& model, const Traversal& traversal)
+{
+    m_isFactorized = false;
+    m_size = 6 + model.getNrOfDOFs();
+
+    // Order the degrees of freedom following the traversal, and compute for each
+    // degree of freedom its parent (the previous degree of freedom in the path to the root)
+    std::vector<std::ptrdiff_t> parentDOF;
+    m_permutation.clear();
+    m_permutation.reserve(m_size);
+    parentDOF.reserve(m_size);
+
+    // The six degrees of freedom of the base are considered as a chain, as the 6x6 base block is dense
+    for (std::size_t i=0; i < 6; i++)
+    {
+        m_permutation.push_back(i);
+        parentDOF.push_back(static_cast<std::ptrdiff_t>(i)-1);
+    }
+
+    // lastDOFOfLink[l] is the last degree of freedom on the path from the root to the link l
+    std::vector<std::ptrdiff_t> lastDOFOfLink(model.getNrOfLinks(), -1);
+
+    for (unsigned int traversalEl=0; traversalEl < traversal.getNrOfVisitedLinks(); traversalEl++)
+    {
+        LinkConstPtr visitedLink = traversal.getLink(traversalEl);
+        LinkConstPtr parentLink  = traversal.getParentLink(traversalEl);
+        IJointConstPtr toParentJoint = traversal.getParentJoint(traversalEl);
+
+        if (parentLink == 0)
+        {
+            lastDOFOfLink[visitedLink->getIndex()] = 5;
+            continue;
+        }
+
+        std::ptrdiff_t lastDOF = lastDOFOfLink[parentLink->getIndex()];
+        for (unsigned int i=0; i < toParentJoint->getNrOfDOFs(); i++)
+        {
+            m_permutation.push_back(6 + toParentJoint->getDOFsOffset() + i);
+            parentDOF.push_back(lastDOF);
+            lastDOF = static_cast<std::ptrdiff_t>(m_permutation.size())-1;
+        }
+        lastDOFOfLink[visitedLink->getIndex()] = lastDOF;
+    }
+
+    if (m_permutation.size() != m_size)
+    {
+        reportError("MassMatrixLTLFactorization","resize","The traversal does not contain all the degrees of freedom of the model");
+        m_size = 0;
+        m_permutation.clear();
+        m_rowStart.assign(1, 0);
+        m_columns.clear();
+        m_values.clear();
+        m_buffer.clear();
+        return false;
+    }
+
+    // Each row of the factor contains the diagonal element and the elements corresponding to the ancestors
+    m_rowStart.resize(m_size+1);
+    m_columns.clear();
+    for (std::size_t p=0; p < m_size; p++)
+    {
+        m_rowStart[p] = m_columns.size();
+        for (std::ptrdiff_t ancestor = static_cast<std::ptrdiff_t>(p); ancestor >= 0; ancestor = parentDOF[ancestor])
+        {
+            m_columns.push_back(static_cast<std::size_t>(ancestor));
+        }
+    }
+    m_rowStart[m_size] = m_columns.size();
+
+    m_values.assign(m_columns.size(), 0.0);
+    m_buffer.assign(m_size, 0.0);
+
+    return true;
+}
+
+bool MassMatrixLTLFactorization::isConsistent(const Model& model) const
+{
+    return m_size == 6 + model.getNrOfDOFs() &&
+           m_permutation.size() == m_size;
+}
+
+bool MassMatrixLTLFactorization::factorize(MatrixView<const double> freeFloatingMassMatrix)
+{
+    m_isFactorized = false;
+
+    if (freeFloatingMassMatrix.rows() != static_cast<std::ptrdiff_t>(m_size) ||
+        freeFloatingMassMatrix.cols() != static_cast<std::ptrdiff_t>(m_size))
+    {
+        reportError("MassMatrixLTLFactorization","factorize","Wrong size of the input mass matrix");
+        return false;
+    }
+
+    // Copy the elements of the mass matrix that belong to the sparsity pattern
+    for (std::size_t p=0; p < m_size; p++)
+    {
+        for (std::size_t nz=m_rowStart[p]; nz < m_rowStart[p+1]; nz++)
+        {
+            m_values[nz] = freeFloatingMassMatrix(m_permutation[p], m_permutation[m_columns[nz]]);
+        }
+    }
+
+    // LTL factorization, see Table 6.3 of Featherstone 2008.
+    // As the ancestors of an ancestor i of k are the last elements of the row k,
+    // the row of i is aligned with the tail of the row of k.
+    for (std::size_t k=m_size; k-- > 0;)
+    {
+        double * row_k = m_values.data() + m_rowStart[k];
+        const std::size_t rowLength_k = m_rowStart[k+1]-m_rowStart[k];
+
+        if (!(row_k[0] > 0.0))
+        {
+            reportError("MassMatrixLTLFactorization","factorize","The input mass matrix is not positive definite");
+            return false;
+        }
+
+        row_k[0] = std::sqrt(row_k[0]);
+        for (std::size_t m=1; m < rowLength_k; m++)
+        {
+            row_k[m] /= row_k[0];
+        }
+
+        for (std::size_t m=1; m < rowLength_k; m++)
+        {
+            double * row_i = m_values.data() + m_rowStart[m_columns[m_rowStart[k]+m]];
+            for (std::size_t t=0; t < rowLength_k-m; t++)
+            {
+                row_i[t] -= row_k[m]*row_k[m+t];
+            }
+        }
+    }
+
+    m_isFactorized = true;
+    return true;
+}
+
+bool MassMatrixLTLFactorization::isFactorized() const
+{
+    return m_isFactorized;
+}
+
+void MassMatrixLTLFactorization::solveInBuffer()
+{
+    double * y = m_buffer.data();
+
+    // Solve L^T z = b, from the leaves to the root
+    for (std::size_t k=m_size; k-- > 0;)
+    {
+        const double * row_k = m_values.data() + m_rowStart[k];
+        y[k] /= row_k[0];
+        for (std::size_t nz=m_rowStart[k]+1; nz < m_rowStart[k+1]; nz++)
+        {
+            y[m_columns[nz]] -= m_values[nz]*y[k];
+        }
+    }
+
+    // Solve L x = z, from the root to the leaves
+    for (std::size_t k=0; k < m_size; k++)
+    {
+        const double * row_k = m_values.data() + m_rowStart[k];
+        for (std::size_t nz=m_rowStart[k]+1; nz < m_rowStart[k+1]; nz++)
+        {
+            y[k] -= m_values[nz]*y[m_columns[nz]];
+        }
+        y[k] /= row_k[0];
+    }
+}
+
+bool MassMatrixLTLFactorization::solve(Span<const double> b, Span<double> x)
+{
+    if (!m_isFactorized)
+    {
+        reportError("MassMatrixLTLFactorization","solve","The factorization has not been computed");
+        return false;
+    }
+
+    if (b.size() != static_cast<Span<const double>::index_type>(m_size) ||
+        x.size() != static_cast<Span<double>::index_type>(m_size))
+    {
+        reportError("MassMatrixLTLFactorization","solve","Wrong size of the input or output vector");
+        return false;
+    }
+
+    for (std::size_t p=0; p < m_size; p++)
+    {
+        m_buffer[p] = b(m_permutation[p]);
+    }
+
+    solveInBuffer();
+
+    for (std::size_t p=0; p < m_size; p++)
+    {
+        x(m_permutation[p]) = m_buffer[p];
+    }
+
+    return true;
+}
+
+bool MassMatrixLTLFactorization::solve(MatrixView<const double> B, MatrixView<double> X)
+{
+    if (!m_isFactorized)
+    {
+        reportError("MassMatrixLTLFactorization","solve","The factorization has not been computed");
+        return false;
+    }
+
+    if (B.rows() != static_cast<std::ptrdiff_t>(m_size) ||
+        X.rows() != B.rows() || X.cols() != B.cols())
+    {
+        reportError("MassMatrixLTLFactorization","solve","Wrong size of the input or output matrix");
+        return false;
+    }
+
+    for (std::ptrdiff_t col=0; col < B.cols(); col++)
+    {
+        for (std::size_t p=0; p < m_size; p++)
+        {
+            m_buffer[p] = B(m_permutation[p], col);
+        }
+
+        solveInBuffer();
+
+        for (std::size_t p=0; p < m_size; p++)
+        {
+            X(m_permutation[p], col) = m_buffer[p];
+        }
+    }
+
+    return true;
+}
+
+bool MassMatrixLTLFactorization::multiplyInverseByTransposed(MatrixView<const double> J, MatrixView<double> X)
+{
+    if (!m_isFactorized)
+    {
+        reportError("MassMatrixLTLFactorization","multiplyInverseByTransposed","The factorization has not been computed");
+        return false;
+    }
+
+    if (J.cols() != static_cast<std::ptrdiff_t>(m_size) ||
+        X.rows() != J.cols() || X.cols() != J.rows())
+    {
+        reportError("MassMatrixLTLFactorization","multiplyInverseByTransposed","Wrong size of the input or output matrix");
+        return false;
+    }
+
+    for (std::ptrdiff_t row=0; row < J.rows(); row++)
+    {
+        for (std::size_t p=0; p < m_size; p++)
+        {
+            m_buffer[p] = J(row, m_permutation[p]);
+        }
+
+        solveInBuffer();
+
+        for (std::size_t p=0; p < m_size; p++)
+        {
+            X(m_permutation[p], row) = m_buffer[p];
+        }
+    }
+
+    return true;
+}
+
+bool MassMatrixLTLFactorization::getFactor(SparseMatrix<iDynTree::ColumnMajor>& L) const
+{
+    if (!m_isFactorized)
+    {
+        reportError("MassMatrixLTLFactorization","getFactor","The factorization has not been computed");
+        return false;
+    }
+
+    Triplets triplets;
+    triplets.reserve(m_values.size());
+    for (std::size_t p=0; p < m_size; p++)
+    {
+        for (std::size_t nz=m_rowStart[p]; nz < m_rowStart[p+1]; nz++)
+        {
+            triplets.pushTriplet(Triplet(m_permutation[p], m_permutation[m_columns[nz]], m_values[nz]));
+        }
+    }
+
+    L.resize(m_size, m_size);
+    L.setFromTriplets(triplets);
+    return true;
+}
+
+std::size_t MassMatrixLTLFactorization::getNrOfNonZeros() const
+{
+    return m_values.size();
+}
+
+}
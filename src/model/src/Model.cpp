@@ -101,6 +101,9 @@ void Model::destroy()
     additionalFrames.resize(0);
     additionalFramesLinks.resize(0);
     frameNames.resize(0);
+    linkNameToIndex.clear();
+    jointNameToIndex.clear();
+    frameNameToOffset.clear();
     neighbors.resize(0);
     packageDirs.clear();
 }
@@ -150,12 +153,10 @@ size_t Model::getNrOfLinks() const
 
 LinkIndex Model::getLinkIndex(const std::string& linkName) const
 {
-    for(size_t i=0; i < this->getNrOfLinks(); i++ )
+    auto it = linkNameToIndex.find(linkName);
+    if( it != linkNameToIndex.end() )
     {
-        if( linkName == linkNames[i] )
-        {
-            return i;
-        }
+        return it->second;
     }
 
     // Report an error and return an invalid index
@@ -215,12 +216,10 @@ size_t Model::getNrOfJoints() const
 
 JointIndex Model::getJointIndex(const std::string& jointName) const
 {
-    for(size_t i=0; i < this->getNrOfJoints(); i++ )
+    auto it = jointNameToIndex.find(jointName);
+    if( it != jointNameToIndex.end() )
     {
-        if( jointName == jointNames[i] )
-        {
-            return i;
-        }
+        return it->second;
     }
 
     std::stringstream ss;
@@ -264,15 +263,7 @@ const IJoint* Model::getJoint(const JointIndex jointIndex) const
 
 bool Model::isLinkNameUsed(const std::string linkName) const
 {
-    for(size_t i=0; i < this->getNrOfLinks(); i++ )
-    {
-        if( linkName == linkNames[i] )
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return linkNameToIndex.find(linkName) != linkNameToIndex.end();
 }
 
 LinkIndex Model::addLink(const std::string& name, const Link& link)
@@ -296,6 +287,7 @@ LinkIndex Model::addLink(const std::string& name, const Link& link)
     LinkIndex newLinkIndex = (LinkIndex)(links.size()-1);
 
     links[newLinkIndex].setIndex(newLinkIndex);
+    linkNameToIndex[name] = newLinkIndex;
 
     // if this is the first link added to the model
     // and the defaultBaseLink has not been setted,
@@ -317,15 +309,7 @@ LinkIndex Model::addLink(const std::string& name, const Link& link)
 
 bool Model::isJointNameUsed(const std::string jointName) const
 {
-    for(size_t i=0; i < this->getNrOfJoints(); i++ )
-    {
-        if( jointName == jointNames[i] )
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return jointNameToIndex.find(jointName) != jointNameToIndex.end();
 }
 
 JointIndex Model::addJoint(const std::string & link1, const std::string & link2,
@@ -395,6 +379,7 @@ JointIndex Model::addJoint(const std::string& jointName, IJointConstPtr joint)
     joints.push_back(joint->clone());
 
     JointIndex thisJointIndex = (JointIndex)(joints.size()-1);
+    jointNameToIndex[jointName] = thisJointIndex;
 
     // Update the adjacency list
     Neighbor firstLinkNeighbor;
@@ -605,20 +590,16 @@ std::string Model::getFrameName(const FrameIndex frameIndex) const
 
 FrameIndex Model::getFrameIndex(const std::string& frameName) const
 {
-    for(size_t i=0; i < this->getNrOfLinks(); i++ )
+    auto linkIt = linkNameToIndex.find(frameName);
+    if( linkIt != linkNameToIndex.end() )
     {
-        if( frameName == linkNames[i] )
-        {
-            return (FrameIndex)i;
-        }
+        return (FrameIndex)linkIt->second;
     }
 
-    for(size_t i=this->getNrOfLinks(); i < this->getNrOfFrames(); i++ )
+    auto frameIt = frameNameToOffset.find(frameName);
+    if( frameIt != frameNameToOffset.end() )
     {
-        if( frameName == this->frameNames[i-getNrOfLinks()] )
-        {
-            return (FrameIndex)i;
-        }
+        return (FrameIndex)(this->getNrOfLinks() + frameIt->second);
     }
 
     std::stringstream ss;
@@ -635,23 +616,8 @@ bool Model::isValidFrameIndex(const FrameIndex index) const
 
 bool Model::isFrameNameUsed(const std::string frameName) const
 {
-    for(size_t i=0; i < this->getNrOfLinks(); i++ )
-    {
-        if( frameName == linkNames[i] )
-        {
-            return true;
-        }
-    }
-
-    for(size_t i=this->getNrOfLinks(); i < this->getNrOfFrames(); i++ )
-    {
-        if( frameName == this->frameNames[i-getNrOfLinks()] )
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return linkNameToIndex.find(frameName) != linkNameToIndex.end() ||
+           frameNameToOffset.find(frameName) != frameNameToOffset.end();
 }
 
 
@@ -683,6 +649,7 @@ bool Model::addAdditionalFrameToLink(const std::string& linkName,
     this->additionalFrames.push_back(link_H_frame);
     this->additionalFramesLinks.push_back(linkIndex);
     this->frameNames.push_back(frameName);
+    this->frameNameToOffset[frameName] = this->frameNames.size()-1;
 
     return true;
 }
@@ -9,6 +9,7 @@
 #include <iDynTree/LinkState.h>
 #include <iDynTree/Wrench.h>
 #include <iDynTree/Twist.h>
+#include <iDynTree/EigenSpatialKernels.h>
 
 #include <cassert>
 
@@ -25,7 +26,6 @@ PrismaticJoint::PrismaticJoint():
     this->setDOFsOffset(0);
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
     this->disablePosLimits();
     this->resetJointDynamics();
 }
@@ -39,7 +39,6 @@ PrismaticJoint::PrismaticJoint(const LinkIndex _link1, const LinkIndex _link2,
     this->setDOFsOffset(0);
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
     this->disablePosLimits();
     this->resetJointDynamics();
 }
@@ -57,7 +56,6 @@ PrismaticJoint::PrismaticJoint(const PrismaticJoint& other):
     this->setDOFsOffset(other.getDOFsOffset());
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
 }
 
 PrismaticJoint::~PrismaticJoint()
@@ -102,46 +100,32 @@ Transform PrismaticJoint::getRestTransform(const LinkIndex p_linkA, const LinkIn
     }
 }
 
-void PrismaticJoint::updateBuffers(const double new_q) const
+Transform PrismaticJoint::computeLink1_X_link2(const double q) const
 {
-    if( new_q != q_previous )
-    {
-        resetBuffers(new_q);
-    }
-
-    return;
+    return translation_axis_wrt_link1.getTranslationTransform(q)*link1_X_link2_at_rest;
 }
 
-void PrismaticJoint::resetBuffers(const double new_q) const
-{
-    this->link1_X_link2 = translation_axis_wrt_link1.getTranslationTransform(new_q)*link1_X_link2_at_rest;
-    this->link2_X_link1 = link1_X_link2.inverse();
-
-    q_previous = new_q;
-}
-
-void PrismaticJoint::resetAxisBuffers() const
+void PrismaticJoint::resetAxisBuffers()
 {
     this->S_link1_link2 = -translation_axis_wrt_link1.getTranslationTwist(1.0);
     this->S_link2_link1 = (link1_X_link2_at_rest.inverse()*translation_axis_wrt_link1).getTranslationTwist(1.0);
 }
 
-const Transform & PrismaticJoint::getTransform(const VectorDynSize& jntPos,
-                                              const LinkIndex p_linkA,
-                                              const LinkIndex p_linkB) const
+Transform PrismaticJoint::getTransform(const VectorDynSize& jntPos,
+                                       const LinkIndex p_linkA,
+                                       const LinkIndex p_linkB) const
 {
     const double dist = jntPos(this->getPosCoordsOffset());
-    updateBuffers(dist);
     if( p_linkA == link1 )
     {
         assert(p_linkB == link2);
-        return this->link1_X_link2;
+        return computeLink1_X_link2(dist);
     }
     else
     {
         assert(p_linkA == link2);
         assert(p_linkB == link1);
-        return this->link2_X_link1;
+        return computeLink1_X_link2(dist).inverse();
     }
 }
 
@@ -160,8 +144,7 @@ TransformDerivative PrismaticJoint::getTransformDerivative(const VectorDynSize&
     }
     else
     {
-        updateBuffers(dist);
-        TransformDerivative linkA_dX_linkB = link1_dX_link2.derivativeOfInverse(this->link1_X_link2);
+        TransformDerivative linkA_dX_linkB = link1_dX_link2.derivativeOfInverse(computeLink1_X_link2(dist));
         return linkA_dX_linkB;
     }
 }
@@ -233,7 +216,7 @@ void PrismaticJoint::computeChildVelAcc(const VectorDynSize & jntPos,
     double ddist = jntVel(this->getDOFsOffset());
     double d2dist = jntAcc(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
+    const Transform child_X_parent = this->getTransform(jntPos,child,parent);
 
     // Propagate twist and spatial acceleration: for a prismatic joint (as for any 1 dof joint)
     // we implement equation 5.14 and 5.15 of Feathestone RBDA, 2008
@@ -254,14 +237,13 @@ void PrismaticJoint::computeChildVel(const VectorDynSize & jntPos,
 {
     double ddist = jntVel(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
+    // parent_X_child is used to transform the parent velocity, to avoid computing the inverse transform
+    const Transform parent_X_child = this->getTransform(jntPos,parent,child);
 
     // Propagate twist and spatial acceleration: for a prismatic joint (as for any 1 dof joint)
     // we implement equation 5.14 and 5.15 of Feathestone RBDA, 2008
-    iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
-
-    SpatialMotionVector vj = S*ddist;
-    linkVels(child) = child_X_parent*linkVels(parent) + vj;
+    const SpatialVector6d vj = ddist*toEigen(this->getMotionSubspaceVector(0,child));
+    fromEigen(linkVels(child), inverseTransformMotionVector(parent_X_child,toEigen(linkVels(parent))) + vj);
 
     return;
 }
@@ -278,21 +260,20 @@ void PrismaticJoint::computeChildPosVelAcc(const VectorDynSize & jntPos,
     double ddist = jntVel(this->getDOFsOffset());
     double d2dist = jntAcc(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
+    const Transform parent_X_child = this->getTransform(jntPos,parent,child);
 
     // Propagate position : position of the frame is expressed as
     // transform between the link frame and a reference frame :
     // ref_H_child  = ref_H_parent*parent_H_child
-    linkPositions(child) = linkPositions(parent)*parent_X_child;
+    composeTransforms(linkPositions(parent),parent_X_child,linkPositions(child));
 
     // Propagate twist and spatial acceleration: for a prismatic joint (as for any 1 dof joint)
     // we implement equation 5.14 and 5.15 of Feathestone RBDA, 2008
-    iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
-
-    SpatialMotionVector vj = S*ddist;
-    linkVels(child) = child_X_parent*linkVels(parent) + vj;
-    linkAccs(child) = child_X_parent*linkAccs(parent) + S*d2dist + linkVels(child)*vj;
+    const SpatialVector6d S = toEigen(this->getMotionSubspaceVector(0,child));
+    const SpatialVector6d vj = S*ddist;
+    const SpatialVector6d v = inverseTransformMotionVector(parent_X_child,toEigen(linkVels(parent))) + vj;
+    fromEigen(linkVels(child), v);
+    fromEigen(linkAccs(child), inverseTransformMotionVector(parent_X_child,toEigen(linkAccs(parent))) + S*d2dist + crossMotion(v,vj));
 
     return;
 }
@@ -303,11 +284,11 @@ void PrismaticJoint::computeChildAcc(const VectorDynSize &jntPos, const VectorDy
 {
     double ddist = jntVel(this->getDOFsOffset());
     double d2dist = jntAcc(this->getDOFsOffset());
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
-    iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
-    SpatialMotionVector vj = S*ddist;
-    linkAccs(child) = child_X_parent*linkAccs(parent) + S*d2dist + linkVels(child)*vj;
+    const Transform parent_X_child = this->getTransform(jntPos,parent,child);
+    const SpatialVector6d S = toEigen(this->getMotionSubspaceVector(0,child));
+    const SpatialVector6d vj = S*ddist;
+    fromEigen(linkAccs(child), inverseTransformMotionVector(parent_X_child,toEigen(linkAccs(parent))) + S*d2dist
+                               + crossMotion(toEigen(linkVels(child)),vj));
 }
 
 void PrismaticJoint::computeChildBiasAcc(const VectorDynSize &jntPos,
@@ -317,11 +298,10 @@ void PrismaticJoint::computeChildBiasAcc(const VectorDynSize &jntPos,
                                          const LinkIndex child, const LinkIndex parent) const
 {
     double ddist = jntVel(this->getDOFsOffset());
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
-    iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
-    SpatialMotionVector vj = S*ddist;
-    linkBiasAccs(child) = child_X_parent*linkBiasAccs(parent) + linkVels(child)*vj;
+    const Transform parent_X_child = this->getTransform(jntPos,parent,child);
+    const SpatialVector6d vj = ddist*toEigen(this->getMotionSubspaceVector(0,child));
+    fromEigen(linkBiasAccs(child), inverseTransformMotionVector(parent_X_child,toEigen(linkBiasAccs(parent)))
+                                   + crossMotion(toEigen(linkVels(child)),vj));
 }
 
 void PrismaticJoint::computeJointTorque(const VectorDynSize& jntPos, const Wrench& internalWrench,
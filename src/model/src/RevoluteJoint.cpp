@@ -9,6 +9,7 @@
 #include <iDynTree/LinkState.h>
 #include <iDynTree/Wrench.h>
 #include <iDynTree/Twist.h>
+#include <iDynTree/EigenSpatialKernels.h>
 
 #include <cassert>
 
@@ -25,7 +26,6 @@ RevoluteJoint::RevoluteJoint():
     this->setDOFsOffset(0);
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
     this->disablePosLimits();
     this->resetJointDynamics();
 }
@@ -39,7 +39,6 @@ RevoluteJoint::RevoluteJoint(const LinkIndex _link1, const LinkIndex _link2,
     this->setDOFsOffset(0);
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
     this->disablePosLimits();
     this->resetJointDynamics();
 }
@@ -52,7 +51,6 @@ RevoluteJoint::RevoluteJoint(const Transform& _link1_X_link2, const Axis& _rotat
     this->setDOFsOffset(0);
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
     this->disablePosLimits();
     this->resetJointDynamics();
 }
@@ -70,7 +68,6 @@ RevoluteJoint::RevoluteJoint(const RevoluteJoint& other):
     this->setDOFsOffset(other.getDOFsOffset());
 
     this->resetAxisBuffers();
-    this->resetBuffers(0);
 }
 
 RevoluteJoint::~RevoluteJoint()
@@ -115,46 +112,32 @@ Transform RevoluteJoint::getRestTransform(const LinkIndex p_linkA, const LinkInd
     }
 }
 
-void RevoluteJoint::updateBuffers(const double new_q) const
+Transform RevoluteJoint::computeLink1_X_link2(const double q) const
 {
-    if( new_q != q_previous )
-    {
-        resetBuffers(new_q);
-    }
-
-    return;
+    return rotation_axis_wrt_link1.getRotationTransform(q)*link1_X_link2_at_rest;
 }
 
-void RevoluteJoint::resetBuffers(const double new_q) const
-{
-    this->link1_X_link2 = rotation_axis_wrt_link1.getRotationTransform(new_q)*link1_X_link2_at_rest;
-    this->link2_X_link1 = link1_X_link2.inverse();
-
-    q_previous = new_q;
-}
-
-void RevoluteJoint::resetAxisBuffers() const
+void RevoluteJoint::resetAxisBuffers()
 {
     this->S_link1_link2 = -(rotation_axis_wrt_link1).getRotationTwist(1.0);
     this->S_link2_link1 = (link1_X_link2_at_rest.inverse()*rotation_axis_wrt_link1).getRotationTwist(1.0);
 }
 
-const Transform & RevoluteJoint::getTransform(const VectorDynSize& jntPos,
-                                              const LinkIndex p_linkA,
-                                              const LinkIndex p_linkB) const
+Transform RevoluteJoint::getTransform(const VectorDynSize& jntPos,
+                                      const LinkIndex p_linkA,
+                                      const LinkIndex p_linkB) const
 {
     const double ang = jntPos(this->getPosCoordsOffset());
-    updateBuffers(ang);
     if( p_linkA == link1 )
     {
         assert(p_linkB == link2);
-        return this->link1_X_link2;
+        return computeLink1_X_link2(ang);
     }
     else
     {
         assert(p_linkA == link2);
         assert(p_linkB == link1);
-        return this->link2_X_link1;
+        return computeLink1_X_link2(ang).inverse();
     }
 }
 
@@ -173,8 +156,7 @@ TransformDerivative RevoluteJoint::getTransformDerivative(const VectorDynSize& j
     }
     else
     {
-        updateBuffers(ang);
-        TransformDerivative linkA_dX_linkB = link1_dX_link2.derivativeOfInverse(this->link1_X_link2);
+        TransformDerivative linkA_dX_linkB = link1_dX_link2.derivativeOfInverse(computeLink1_X_link2(ang));
         return linkA_dX_linkB;
     }
 }
@@ -248,7 +230,7 @@ void RevoluteJoint::computeChildVelAcc(const VectorDynSize & jntPos,
     double dang = jntVel(this->getDOFsOffset());
     double d2ang = jntAcc(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
+    const Transform child_X_parent = this->getTransform(jntPos,child,parent);
 
     // Propagate twist and spatial acceleration: for a revolute joint (as for any 1 dof joint)
     // we implement equation 5.14 and 5.15 of Feathestone RBDA, 2008
@@ -269,14 +251,13 @@ void RevoluteJoint::computeChildVel(const VectorDynSize & jntPos,
 {
     double dang = jntVel(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
+    // parent_X_child is used to transform the parent velocity, to avoid computing the inverse transform
+    const Transform parent_X_child = this->getTransform(jntPos,parent,child);
 
     // Propagate twist and spatial acceleration: for a revolute joint (as for any 1 dof joint)
     // we implement equation 5.14 and 5.15 of Feathestone RBDA, 2008
-    iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
-
-    SpatialMotionVector vj = S*dang;
-    linkVels(child) = child_X_parent*linkVels(parent) + vj;
+    const SpatialVector6d vj = dang*toEigen(this->getMotionSubspaceVector(0,child));
+    fromEigen(linkVels(child), inverseTransformMotionVector(parent_X_child,toEigen(linkVels(parent))) + vj);
 
     return;
 }
@@ -293,21 +274,20 @@ void RevoluteJoint::computeChildPosVelAcc(const VectorDynSize & jntPos,
     double dang = jntVel(this->getDOFsOffset());
     double d2ang = jntAcc(this->getDOFsOffset());
 
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
+    const Transform parent_X_child = this->getTransform(jntPos,parent,child);
 
     // Propagate position : position of the frame is expressed as
     // transform between the link frame and a reference frame :
     // ref_H_child  = ref_H_parent*parent_H_child
-    linkPositions(child) = linkPositions(parent)*parent_X_child;
+    composeTransforms(linkPositions(parent),parent_X_child,linkPositions(child));
 
     // Propagate twist and spatial acceleration: for a revolute joint (as for any 1 dof joint)
     // we implement equation 5.14 and 5.15 of Feathestone RBDA, 2008
-    iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
-
-    SpatialMotionVector vj = S*dang;
-    linkVels(child) = child_X_parent*linkVels(parent) + vj;
-    linkAccs(child) = child_X_parent*linkAccs(parent) + S*d2ang + linkVels(child)*vj;
+    const SpatialVector6d S = toEigen(this->getMotionSubspaceVector(0,child));
+    const SpatialVector6d vj = S*dang;
+    const SpatialVector6d v = inverseTransformMotionVector(parent_X_child,toEigen(linkVels(parent))) + vj;
+    fromEigen(linkVels(child), v);
+    fromEigen(linkAccs(child), inverseTransformMotionVector(parent_X_child,toEigen(linkAccs(parent))) + S*d2ang + crossMotion(v,vj));
 
     return;
 }
@@ -318,11 +298,11 @@ void RevoluteJoint::computeChildAcc(const VectorDynSize &jntPos, const VectorDyn
 {
     double dang = jntVel(this->getDOFsOffset());
     double d2ang = jntAcc(this->getDOFsOffset());
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
-    iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
-    SpatialMotionVector vj = S*dang;
-    linkAccs(child) = child_X_parent*linkAccs(parent) + S*d2ang + linkVels(child)*vj;
+    const Transform parent_X_child = this->getTransform(jntPos,parent,child);
+    const SpatialVector6d S = toEigen(this->getMotionSubspaceVector(0,child));
+    const SpatialVector6d vj = S*dang;
+    fromEigen(linkAccs(child), inverseTransformMotionVector(parent_X_child,toEigen(linkAccs(parent))) + S*d2ang
+                               + crossMotion(toEigen(linkVels(child)),vj));
 }
 
 void RevoluteJoint::computeChildBiasAcc(const VectorDynSize &jntPos,
@@ -332,11 +312,10 @@ void RevoluteJoint::computeChildBiasAcc(const VectorDynSize &jntPos,
                                          const LinkIndex child, const LinkIndex parent) const
 {
     double dang = jntVel(this->getDOFsOffset());
-    const Transform & child_X_parent = this->getTransform(jntPos,child,parent);
-    const Transform & parent_X_child = this->getTransform(jntPos,parent,child);
-    iDynTree::SpatialMotionVector S = this->getMotionSubspaceVector(0,child);
-    SpatialMotionVector vj = S*dang;
-    linkBiasAccs(child) = child_X_parent*linkBiasAccs(parent) + linkVels(child)*vj;
+    const Transform parent_X_child = this->getTransform(jntPos,parent,child);
+    const SpatialVector6d vj = dang*toEigen(this->getMotionSubspaceVector(0,child));
+    fromEigen(linkBiasAccs(child), inverseTransformMotionVector(parent_X_child,toEigen(linkBiasAccs(parent)))
+                                   + crossMotion(toEigen(linkVels(child)),vj));
 }
 
 void RevoluteJoint::computeJointTorque(const VectorDynSize& jntPos, const Wrench& internalWrench,
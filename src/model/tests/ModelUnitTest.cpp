@@ -317,9 +317,49 @@ void checkExtractSubModel(const Model & model)
     }
 }
 
+void checkNameLookups(const Model & model)
+{
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+    {
+        ASSERT_EQUAL_DOUBLE(model.getLinkIndex(model.getLinkName(lnk)), lnk);
+        ASSERT_IS_TRUE(model.isLinkNameUsed(model.getLinkName(lnk)));
+    }
+
+    for(JointIndex jnt=0; jnt < static_cast<JointIndex>(model.getNrOfJoints()); jnt++)
+    {
+        ASSERT_EQUAL_DOUBLE(model.getJointIndex(model.getJointName(jnt)), jnt);
+        ASSERT_IS_TRUE(model.isJointNameUsed(model.getJointName(jnt)));
+    }
+
+    for(FrameIndex frame=0; frame < static_cast<FrameIndex>(model.getNrOfFrames()); frame++)
+    {
+        ASSERT_EQUAL_DOUBLE(model.getFrameIndex(model.getFrameName(frame)), frame);
+        ASSERT_IS_TRUE(model.isFrameNameUsed(model.getFrameName(frame)));
+    }
+
+    ASSERT_IS_FALSE(model.isLinkNameUsed("nonExistingName"));
+    ASSERT_IS_FALSE(model.isJointNameUsed("nonExistingName"));
+    ASSERT_IS_FALSE(model.isFrameNameUsed("nonExistingName"));
+    ASSERT_EQUAL_DOUBLE(model.getLinkIndex("nonExistingName"), LINK_INVALID_INDEX);
+    ASSERT_EQUAL_DOUBLE(model.getJointIndex("nonExistingName"), JOINT_INVALID_INDEX);
+    ASSERT_EQUAL_DOUBLE(model.getFrameIndex("nonExistingName"), FRAME_INVALID_INDEX);
+
+    // Adding a link shifts the frame index of all the additional frames
+    Model modelCopy = model;
+    if( modelCopy.getNrOfFrames() > modelCopy.getNrOfLinks() )
+    {
+        std::string additionalFrameName = modelCopy.getFrameName(modelCopy.getNrOfLinks());
+        ASSERT_EQUAL_DOUBLE(modelCopy.getFrameIndex(additionalFrameName), modelCopy.getNrOfLinks());
+        modelCopy.addLink("newlyAddedLink", Link());
+        ASSERT_EQUAL_DOUBLE(modelCopy.getFrameIndex(additionalFrameName), modelCopy.getNrOfLinks());
+        ASSERT_EQUAL_DOUBLE(modelCopy.getFrameIndex("newlyAddedLink"), modelCopy.getNrOfLinks()-1);
+    }
+}
+
 void checkAll(const Model & model)
 {
     createCopyAndDestroy(model);
+    checkNameLookups(model);
     checkNeighborSanity(model,false);
     checkComputeTraversal(model);
     checkReducedModel(model);
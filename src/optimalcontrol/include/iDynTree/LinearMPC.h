@@ -11,17 +11,141 @@
 #ifndef IDYNTREE_OPTIMALCONTROL_LINEAR_MPC_H
 #define IDYNTREE_OPTIMALCONTROL_LINEAR_MPC_H
 
+#include <iDynTree/Controller.h>
+#include <iDynTree/Optimizer.h>
+
+#include <memory>
+#include <vector>
+
 namespace iDynTree {
+
+    class VectorDynSize;
+
     namespace optimalcontrol {
 
+        class LinearSystem;
+        class QuadraticCost;
+        class LinearConstraint;
+
+        /**
+         * @brief The way the MPC problem is transcribed into a QP.
+         */
+        enum class LinearMPCFormulation {
+            /**
+             * States and controls are both optimization variables, and the dynamics is imposed with equality constraints.
+             * The QP matrices are sparse and grow linearly with the horizon.
+             */
+            Sparse,
+            /**
+             * The states are eliminated using the dynamics, and only the controls are optimization variables.
+             * The QP is smaller but dense, and building it grows quadratically with the horizon.
+             */
+            Condensed
+        };
+
         /**
          * @warning This class is still in active development, and so API interface can change between iDynTree versions.
          * \ingroup iDynTreeExperimental
          */
 
-        class LinearMPC {
+        /**
+         * @brief Receding horizon controller for linear systems.
+         *
+         * The continuous time LinearSystem is discretized with the forward Euler method, x_{k+1} = (I + dt A) x_k + dt B u_k,
+         * and the QP
+         * min sum_{k=0}^{N-1} L(t_k, x_k, u_k) + M(t_N, x_N)
+         * s.t. lb <= C_x(t_k) x_k + C_u(t_k) u_k <= ub, k = 0, ..., N-1,
+         * is solved at each tick, where L is the stage cost, M the terminal cost and t_k = t + k dt, with t the time of the last state feedback.
+         * The cross terms between state and control of the costs are not considered.
+         *
+         * Between two ticks, only the vectors depending on the state feedback and on time varying references are recomputed.
+         * The matrices of the QP are rebuilt only if the system, the cost or the constraint matrices change, and otherwise the
+         * optimizer is informed through OptimizationProblemInfo::hessianIsUnchanged and OptimizationProblemInfo::constraintsJacobianIsUnchanged,
+         * so that it can keep its factorization (as done by the OsqpInterface). The previous solution, shifted by the elapsed
+         * number of steps, is provided to the optimizer as initial guess. The constraints multipliers of the previous solution
+         * are shifted in the same way and provided as dual guess (see OptimizationProblem::getDualGuess).
+         */
+        class LinearMPC : public Controller {
+
+        public:
+            LinearMPC(const std::shared_ptr<LinearSystem>& system);
+
+            LinearMPC(const LinearMPC& other) = delete;
+
+            ~LinearMPC() override;
+
+            /**
+             * @brief Set the horizon of the controller.
+             * @param[in] numberOfSteps The number of control inputs optimized at each tick.
+             * @param[in] samplingTime The time between two consecutive steps of the horizon.
+             * @return True if successfull.
+             */
+            bool setHorizon(size_t numberOfSteps, double samplingTime);
+
+            /**
+             * @brief Select how the problem is transcribed into a QP. The default is LinearMPCFormulation::Sparse.
+             * @return True if successfull.
+             */
+            bool setFormulation(LinearMPCFormulation formulation);
+
+            /**
+             * @brief Set the cost L evaluated at each step of the horizon (references can be given through time varying gradients).
+             * @return True if successfull.
+             */
+            bool setStageCost(std::shared_ptr<QuadraticCost> stageCost);
+
+            /**
+             * @brief Set the cost M evaluated on the last state of the horizon. Only its state part is considered.
+             * @return True if successfull.
+             */
+            bool setTerminalCost(std::shared_ptr<QuadraticCost> terminalCost);
+
+            /**
+             * @brief Add a constraint imposed at each step of the horizon.
+             * @return True if successfull.
+             */
+            bool addConstraint(std::shared_ptr<LinearConstraint> constraint);
+
+            bool setOptimizer(std::shared_ptr<optimization::Optimizer> optimizer);
+
+            /**
+             * @brief Set the measured state and the time at which the next problem starts.
+             * @return True if successfull.
+             */
+            virtual bool setStateFeedback(double time, const VectorDynSize& stateFeedback) override;
+
+            /**
+             * @brief Solve the problem starting from the last state feedback.
+             * @return True if successfull.
+             */
+            bool solve();
+
+            /**
+             * @brief Solve the problem and return the first control input of the solution.
+             * @param[out] controllerOutput The control input to be applied.
+             * @return True if successfull.
+             */
+            virtual bool doControl(VectorDynSize& controllerOutput) override;
+
+            /**
+             * @brief Get the last solution.
+             * @param[out] states The states x_0, ..., x_N, with x_0 the state feedback.
+             * @param[out] controls The controls u_0, ..., u_{N-1}.
+             * @return True if successfull.
+             */
+            bool getSolution(std::vector<VectorDynSize>& states, std::vector<VectorDynSize>& controls);
+
+            /**
+             * @brief Discard the QP matrices and the previous solution, so that the next tick builds the QP from scratch.
+             */
+            void reset();
+
+        private:
 
+            class LinearMPCTranscription;
 
+            std::shared_ptr<LinearMPCTranscription> m_transcription;
+            std::shared_ptr<optimization::Optimizer> m_optimizer;
         };
 
     }
@@ -47,6 +47,19 @@ namespace iDynTree {
 
             bool setIntegrator(const std::shared_ptr<Integrator> integrationMethod);
 
+            /**
+             * @brief Evaluate the collocation constraints of the mesh intervals, and their derivatives, on multiple threads.
+             *
+             * A worker thread is created for each of the provided integrators, in addition to the calling thread that keeps using
+             * the integrator set with setIntegrator. Each of them has to be of the same kind of the one set with setIntegrator,
+             * and has to integrate its own instance of the dynamical system of the OptimalControlProblem, since neither the
+             * integrators nor the dynamical systems can be used by multiple threads at the same time.
+             * The costs and the constraints of the OptimalControlProblem are still evaluated in the calling thread.
+             * An empty vector (the default) evaluates all the mesh intervals in the calling thread.
+             * @return True if successfull, false otherwise (for example if the threads could not be created).
+             */
+            bool setWorkerIntegrators(const std::vector<std::shared_ptr<Integrator>>& workerIntegrators);
+
             bool setControlPeriod(double period);
 
             bool setAdditionalStateMeshPoints(const std::vector<double>& stateMeshes);
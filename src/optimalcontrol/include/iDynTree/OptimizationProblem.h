@@ -48,6 +48,12 @@ namespace iDynTree {
             bool hasSparseHessian;
 
             bool hessianIsProvided;
+
+            // True if the hessian did not change since the previous call to prepare, so that solvers can reuse its factorization
+            bool hessianIsUnchanged;
+
+            // True if the constraints jacobian did not change since the previous call to prepare
+            bool constraintsJacobianIsUnchanged;
         };
 
         class OptimizationProblemInfo {
@@ -75,6 +81,10 @@ namespace iDynTree {
             bool hasSparseHessian() const;
 
             bool hessianIsProvided() const;
+
+            bool hessianIsUnchanged() const;
+
+            bool constraintsJacobianIsUnchanged() const;
         };
 
         class OptimizationProblem {
@@ -105,6 +115,14 @@ namespace iDynTree {
 
             virtual bool getGuess(VectorDynSize &guess);
 
+            /**
+             * Get an initial guess for the dual variables, with the same convention of Optimizer::getDualVariables.
+             *
+             * The default implementation returns false. In this case the optimizers that support warm start
+             * reuse the dual variables of their previous solution.
+             */
+            virtual bool getDualGuess(VectorDynSize &constraintsMultipliers, VectorDynSize &lowerBoundsMultipliers, VectorDynSize &upperBoundsMultipliers);
+
             virtual bool setVariables(const VectorDynSize& variables);
 
             virtual bool evaluateCostFunction(double& costValue);
@@ -119,11 +137,39 @@ namespace iDynTree {
 
             virtual bool evaluateConstraintsHessian(const VectorDynSize& constraintsMultipliers, MatrixDynSize& hessian); //using dense matrices, but the sparsity pattern is still obtained
 
+            /**
+             * Evaluate only the nonzero elements of the constraints jacobian.
+             *
+             * nonZeroElements is resized to the number of nonzeros, and its i-th element is the jacobian element
+             * of row nonZeroElementRows[i] and column nonZeroElementColumns[i], as returned by getConstraintsJacobianInfo.
+             * The default implementation evaluates the dense jacobian with evaluateConstraintsJacobian and extracts its nonzero elements.
+             * Problems with large sparse jacobians should override it, to avoid filling a dense matrix.
+             */
+            virtual bool evaluateConstraintsJacobianNonZeros(VectorDynSize& nonZeroElements);
+
+            /**
+             * Evaluate only the nonzero elements of the cost hessian, following the sparsity pattern returned by getHessianInfo.
+             *
+             * The default implementation evaluates the dense hessian with evaluateCostHessian and extracts its nonzero elements.
+             */
+            virtual bool evaluateCostHessianNonZeros(VectorDynSize& nonZeroElements);
+
+            /**
+             * Evaluate only the nonzero elements of the constraints hessian, following the sparsity pattern returned by getHessianInfo.
+             *
+             * The default implementation evaluates the dense hessian with evaluateConstraintsHessian and extracts its nonzero elements.
+             */
+            virtual bool evaluateConstraintsHessianNonZeros(const VectorDynSize& constraintsMultipliers, VectorDynSize& nonZeroElements);
+
             const OptimizationProblemInfo& info() const;
 
         protected:
             std::shared_ptr<OptimizationProblemInfoData> m_infoData;
             OptimizationProblemInfo m_info;
+
+        private:
+            class NonZerosEvaluationBuffers;
+            std::unique_ptr<NonZerosEvaluationBuffers> m_nonZerosBuffers;
         };
     }
 }
@@ -46,11 +46,14 @@ namespace iDynTree {
             VectorDynSize m_constraintsLowerBounds, m_constraintsUpperBounds, m_variablesLowerBounds, m_variablesUpperBounds;
             VectorDynSize m_variablesBuffer, m_costGradientBuffer, m_constraintsBuffer;
             MatrixDynSize m_jacobianBuffer, m_costHessianBuffer, m_constraintsHessianBuffer, m_lagrangianHessianBuffer;
+            VectorDynSize m_jacobianNonZerosBuffer, m_costHessianNonZerosBuffer, m_constraintsHessianNonZerosBuffer;
         public:
 
             unsigned int numberOfVariables, numberOfConstraints;
             std::vector<size_t> constraintsJacNNZRows, constraintsJacNNZCols, inputHessianNNZRows, inputHessianNNZCols,
                 lowerTriangularHessianNNZRows, lowerTriangularHessianNNZCols;
+            std::vector<size_t> lowerTriangularHessianNNZPositions; //position in the nonzeros of the input hessian, when sparse
+            bool sparseJacobian, sparseHessian; //when true, only the nonzero elements are evaluated
             std::shared_ptr<OptimizationProblem> problem;
             double minusInfinity, plusInfinity; //TODO. Set these before solving
             VectorDynSize solution;
@@ -62,7 +65,9 @@ namespace iDynTree {
             VectorDynSize lowerBoundMultipliers, upperBoundMultipliers, constraintMultipliers;
 
             NLPImplementation()
-            : minusInfinity(-1e19)
+            : sparseJacobian(false)
+            , sparseHessian(false)
+            , minusInfinity(-1e19)
             , plusInfinity(1e19)
             , initialGuessSet(false)
             , exitCode(-6)
@@ -83,16 +88,18 @@ namespace iDynTree {
                     m_costGradientBuffer.resize(numberOfVariables);
                 }
 
-                if ((m_costHessianBuffer.rows() != numberOfVariables) || (m_costHessianBuffer.cols() != numberOfVariables)) {
-                    m_costHessianBuffer.resize(numberOfVariables, numberOfVariables);
-                }
+                if (!sparseHessian) {
+                    if ((m_costHessianBuffer.rows() != numberOfVariables) || (m_costHessianBuffer.cols() != numberOfVariables)) {
+                        m_costHessianBuffer.resize(numberOfVariables, numberOfVariables);
+                    }
 
-                if ((m_constraintsHessianBuffer.rows() != numberOfVariables) || (m_constraintsHessianBuffer.cols() != numberOfVariables)) {
-                    m_constraintsHessianBuffer.resize(numberOfVariables, numberOfVariables);
-                }
+                    if ((m_constraintsHessianBuffer.rows() != numberOfVariables) || (m_constraintsHessianBuffer.cols() != numberOfVariables)) {
+                        m_constraintsHessianBuffer.resize(numberOfVariables, numberOfVariables);
+                    }
 
-                if ((m_lagrangianHessianBuffer.rows() != numberOfVariables) || (m_lagrangianHessianBuffer.cols() != numberOfVariables)) {
-                    m_lagrangianHessianBuffer.resize(numberOfVariables, numberOfVariables);
+                    if ((m_lagrangianHessianBuffer.rows() != numberOfVariables) || (m_lagrangianHessianBuffer.cols() != numberOfVariables)) {
+                        m_lagrangianHessianBuffer.resize(numberOfVariables, numberOfVariables);
+                    }
                 }
 
                 m = static_cast<Ipopt::Index>(numberOfConstraints); //set in the solve method
@@ -106,7 +113,7 @@ namespace iDynTree {
                     constraintMultipliers.zero();
                 }
 
-                if ((m_jacobianBuffer.rows() != numberOfConstraints) || (m_jacobianBuffer.cols() != numberOfVariables)) {
+                if (!sparseJacobian && ((m_jacobianBuffer.rows() != numberOfConstraints) || (m_jacobianBuffer.cols() != numberOfVariables))) {
                     m_jacobianBuffer.resize(numberOfConstraints, numberOfVariables);
                 }
 
@@ -292,6 +299,22 @@ namespace iDynTree {
                     }
                 }
 
+                if (values != nullptr && sparseJacobian){
+                    if (!(problem->evaluateConstraintsJacobianNonZeros(m_jacobianNonZerosBuffer))){
+                        reportError("NLPImplementation", "eval_jac_g", "Error while evaluating the constraints jacobian.");
+                        return false;
+                    }
+
+                    if (m_jacobianNonZerosBuffer.size() != static_cast<unsigned int>(nele_jac)) {
+                        reportError("NLPImplementation", "eval_jac_g", "The number of nonzero elements of the constraints jacobian changed.");
+                        return false;
+                    }
+
+                    Eigen::Map<Eigen::VectorXd> valuesMap(values, nele_jac);
+                    valuesMap = toEigen(m_jacobianNonZerosBuffer);
+                    return true;
+                }
+
                 if (values != nullptr){
                     if (!(problem->evaluateConstraintsJacobian(m_jacobianBuffer))){
                         reportError("NLPImplementation", "eval_jac_g", "Error while evaluating the constraints jacobian.");
@@ -324,6 +347,34 @@ namespace iDynTree {
                     }
                 }
 
+                if (values != nullptr && sparseHessian){
+                    if (!problem->evaluateCostHessianNonZeros(m_costHessianNonZerosBuffer)){
+                        reportError("NLPImplementation", "eval_h", "Error while evaluating the cost hessian.");
+                        return false;
+                    }
+
+                    if (new_x || new_lambda){
+                        Eigen::Map<const Eigen::VectorXd> lambdaMap(lambda, m);
+                        toEigen(constraintMultipliers) = lambdaMap;
+                        if (!problem->evaluateConstraintsHessianNonZeros(constraintMultipliers, m_constraintsHessianNonZerosBuffer)){
+                            reportError("NLPImplementation", "eval_h", "Error while evaluating the constraints hessian.");
+                            return false;
+                        }
+                    }
+
+                    if ((m_costHessianNonZerosBuffer.size() != inputHessianNNZRows.size()) ||
+                        (m_constraintsHessianNonZerosBuffer.size() != inputHessianNNZRows.size())) {
+                        reportError("NLPImplementation", "eval_h", "The number of nonzero elements of the hessian changed.");
+                        return false;
+                    }
+
+                    for (size_t i = 0; i < lowerTriangularHessianNNZPositions.size(); ++i){
+                        unsigned int position = static_cast<unsigned int>(lowerTriangularHessianNNZPositions[i]);
+                        values[i] = obj_factor * m_costHessianNonZerosBuffer(position) + m_constraintsHessianNonZerosBuffer(position);
+                    }
+                    return true;
+                }
+
                 if (values != nullptr){
                     if (!problem->evaluateCostHessian(m_costHessianBuffer)){
                         reportError("NLPImplementation", "eval_h", "Error while evaluating the cost hessian.");
@@ -543,6 +594,9 @@ namespace iDynTree {
                 }
             }
 
+            m_pimpl->nlpPointer->sparseJacobian = m_problem->info().hasSparseConstraintJacobian();
+            m_pimpl->nlpPointer->sparseHessian = m_problem->info().hasSparseHessian();
+
             if (m_problem->info().hasSparseConstraintJacobian()) {
                 if (!(m_problem->getConstraintsJacobianInfo(m_pimpl->nlpPointer->constraintsJacNNZRows,
                                                             m_pimpl->nlpPointer->constraintsJacNNZCols))){
@@ -572,6 +626,8 @@ namespace iDynTree {
 
                 std::vector<size_t>& iRowsLT = m_pimpl->nlpPointer->lowerTriangularHessianNNZRows;
                 std::vector<size_t>& jColsLT = m_pimpl->nlpPointer->lowerTriangularHessianNNZCols;
+                std::vector<size_t>& positionsLT = m_pimpl->nlpPointer->lowerTriangularHessianNNZPositions;
+                positionsLT.resize(iRowsLT.size());
 
                 size_t nnz = 0;
                 for (size_t i = 0; i < iRows.size(); ++i) {
@@ -579,15 +635,18 @@ namespace iDynTree {
                         if (nnz < iRowsLT.size()) {
                             iRowsLT[nnz] = iRows[i];
                             jColsLT[nnz] = jCols[i];
+                            positionsLT[nnz] = i;
                         } else {
                             iRowsLT.push_back(iRows[i]);
                             jColsLT.push_back(jCols[i]);
+                            positionsLT.push_back(i);
                         }
                         ++nnz;
                     }
                 }
                 iRowsLT.resize(nnz);
                 jColsLT.resize(nnz);
+                positionsLT.resize(nnz);
 
             } else { //dense hessian
                 m_pimpl->nlpPointer->lowerTriangularHessianNNZRows.clear();
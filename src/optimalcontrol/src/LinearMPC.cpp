@@ -0,0 +1,1160 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Originally developed for Prioritized Optimal Control (2014)
+ * Refactored in 2018.
+ * Design inspired by
+ * - ACADO toolbox (http://acado.github.io)
+ * - ADRL Control Toolbox (https://adrlab.bitbucket.io/ct/ct_doc/doc/html/index.html)
+ */
+
+#include <iDynTree/LinearMPC.h>
+#include <iDynTree/LinearSystem.h>
+#include <iDynTree/QuadraticCost.h>
+#include <iDynTree/LinearConstraint.h>
+#include <iDynTree/OptimizationProblem.h>
+
+#include <iDynTree/VectorDynSize.h>
+#include <iDynTree/MatrixDynSize.h>
+#include <iDynTree/Utils.h>
+
+#include <Eigen/Dense>
+#include <iDynTree/EigenHelpers.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace iDynTree {
+    namespace optimalcontrol {
+
+        // Copy newValue in stored, returning true if the stored value changed. Stored has to be already of the right size.
+        template <typename NewType, typename StoredType>
+        static bool updateIfChanged(const NewType& newValue, StoredType&& stored) {
+            if (stored == newValue) {
+                return false;
+            }
+            stored = newValue;
+            return true;
+        }
+
+        // Visitors of the nonzero elements of the QP matrices, see visitConstraintsJacobian and visitHessian
+
+        class NonZerosCounter {
+        public:
+            size_t count;
+            NonZerosCounter() : count(0) { }
+            void operator()(size_t /*row*/, size_t /*col*/, double /*value*/) {
+                count++;
+            }
+        };
+
+        class NonZerosIndicesCollector {
+        public:
+            std::vector<size_t>& rows;
+            std::vector<size_t>& cols;
+            NonZerosIndicesCollector(std::vector<size_t>& nonZeroRows, std::vector<size_t>& nonZeroCols)
+            : rows(nonZeroRows)
+            , cols(nonZeroCols)
+            { }
+            void operator()(size_t row, size_t col, double /*value*/) {
+                rows.push_back(row);
+                cols.push_back(col);
+            }
+        };
+
+        class DenseMatrixWriter {
+        public:
+            double* data;
+            size_t cols;
+            DenseMatrixWriter(double* matrixData, size_t matrixCols)
+            : data(matrixData)
+            , cols(matrixCols)
+            { }
+            void operator()(size_t row, size_t col, double value) {
+                data[row * cols + col] = value; //row major
+            }
+        };
+
+        class NonZerosWriter {
+        public:
+            double* data;
+            size_t index;
+            NonZerosWriter(double* nonZerosData)
+            : data(nonZerosData)
+            , index(0)
+            { }
+            void operator()(size_t /*row*/, size_t /*col*/, double value) {
+                data[index++] = value;
+            }
+        };
+
+        class LinearMPC::LinearMPCTranscription : public optimization::OptimizationProblem {
+        public:
+            std::shared_ptr<LinearSystem> m_system;
+            std::shared_ptr<QuadraticCost> m_stageCost, m_terminalCost;
+            std::vector<std::shared_ptr<LinearConstraint>> m_constraints;
+            LinearMPCFormulation m_formulation;
+            size_t m_steps;
+            double m_samplingTime;
+            double m_plusInfinity, m_minusInfinity;
+
+            double m_time;
+            Eigen::VectorXd m_initialState;
+            bool m_initialStateSet;
+
+            // Structure of the last prepared problem
+            bool m_prepared;
+            size_t m_nx, m_nu, m_nc, m_preparedSteps;
+            LinearMPCFormulation m_preparedFormulation;
+            size_t m_jacobianNNZ, m_hessianNNZ;
+
+            // Data of each step of the horizon. A and B are the discretized dynamics, Q and q are the state cost
+            // hessian and gradient (the last ones are given by the terminal cost), R and r the control ones.
+            std::vector<Eigen::MatrixXd> m_A, m_B, m_Q, m_R, m_Cx, m_Cu;
+            std::vector<Eigen::VectorXd> m_q, m_r;
+            std::vector<double> m_costBias;
+            Eigen::VectorXd m_constraintsLowerBound, m_constraintsUpperBound;
+
+            // Condensed formulation: m_propagation contains the blocks dx_k/du_j, while m_freeStates are the states obtained with zero controls
+            Eigen::MatrixXd m_propagation, m_condensedHessian, m_condensedJacobian;
+            Eigen::MatrixXd m_freeStates;
+            Eigen::MatrixXd m_adjointBlock, m_adjointBlockBuffer;
+            Eigen::VectorXd m_adjoint, m_adjointBuffer;
+
+            // Vectors updated at each tick
+            Eigen::VectorXd m_costLinearTerm, m_firstDynamicsBias, m_constraintsOffset;
+            double m_costConstant;
+
+            Eigen::VectorXd m_variables;
+            Eigen::MatrixXd m_states, m_controls;
+
+            // Warm start
+            Eigen::VectorXd m_solution, m_constraintsMultipliers;
+            double m_solutionTime;
+            bool m_hasSolution, m_guessIsValid, m_hasMultipliers;
+
+            VectorDynSize m_zeroState, m_zeroControl, m_vectorBuffer;
+            VectorDynSize m_multipliersBuffer, m_lowerBoundsMultipliersBuffer, m_upperBoundsMultipliersBuffer;
+            MatrixDynSize m_matrixBuffer;
+
+            LinearMPCTranscription()
+            : m_formulation(LinearMPCFormulation::Sparse)
+            , m_steps(0)
+            , m_samplingTime(0.0)
+            , m_plusInfinity(1e19)
+            , m_minusInfinity(-1e19)
+            , m_time(0.0)
+            , m_initialStateSet(false)
+            , m_prepared(false)
+            , m_nx(0)
+            , m_nu(0)
+            , m_nc(0)
+            , m_preparedSteps(0)
+            , m_preparedFormulation(LinearMPCFormulation::Sparse)
+            , m_jacobianNNZ(0)
+            , m_hessianNNZ(0)
+            , m_costConstant(0.0)
+            , m_solutionTime(0.0)
+            , m_hasSolution(false)
+            , m_guessIsValid(false)
+            , m_hasMultipliers(false)
+            { }
+
+            LinearMPCTranscription(const LinearMPCTranscription& other) = delete;
+
+            virtual ~LinearMPCTranscription() override;
+
+            bool isSparse() const {
+                return m_preparedFormulation == LinearMPCFormulation::Sparse;
+            }
+
+            // In the sparse formulation the variables are ordered as [u_0, x_1, u_1, x_2, ..., u_{N-1}, x_N]
+            size_t variablesPerStep() const {
+                return isSparse() ? m_nu + m_nx : m_nu;
+            }
+
+            size_t controlIndex(size_t step) const {
+                return step * variablesPerStep();
+            }
+
+            size_t stateIndex(size_t step) const { //only for the sparse formulation, step > 0
+                return (step - 1) * variablesPerStep() + m_nu;
+            }
+
+            // In the sparse formulation the constraints of each step are the dynamics x_{k+1} - A_k x_k - B_k u_k = 0 followed by the linear constraints.
+            size_t constraintsPerStep() const {
+                return isSparse() ? m_nx + m_nc : m_nc;
+            }
+
+            double shiftedBound(double bound, double offset) const {
+                if ((bound <= m_minusInfinity) || (bound >= m_plusInfinity)) {
+                    return bound;
+                }
+                return bound - offset;
+            }
+
+            void allocate() {
+                size_t N = m_preparedSteps;
+                m_A.assign(N, Eigen::MatrixXd::Zero(m_nx, m_nx));
+                m_B.assign(N, Eigen::MatrixXd::Zero(m_nx, m_nu));
+                m_Q.assign(N + 1, Eigen::MatrixXd::Zero(m_nx, m_nx));
+                m_q.assign(N + 1, Eigen::VectorXd::Zero(m_nx));
+                m_R.assign(N, Eigen::MatrixXd::Zero(m_nu, m_nu));
+                m_r.assign(N, Eigen::VectorXd::Zero(m_nu));
+                m_Cx.assign(N, Eigen::MatrixXd::Zero(m_nc, m_nx));
+                m_Cu.assign(N, Eigen::MatrixXd::Zero(m_nc, m_nu));
+                m_costBias.assign(N + 1, 0.0);
+                m_constraintsLowerBound.resize(m_nc);
+                m_constraintsUpperBound.resize(m_nc);
+
+                m_zeroState.resize(static_cast<unsigned int>(m_nx));
+                m_zeroState.zero();
+                m_zeroControl.resize(static_cast<unsigned int>(m_nu));
+                m_zeroControl.zero();
+
+                m_variables.setZero(numberOfVariables());
+                m_states.setZero(m_nx, N + 1);
+                m_controls.setZero(m_nu, N);
+                m_costLinearTerm.setZero(numberOfVariables());
+                m_firstDynamicsBias.setZero(m_nx);
+                m_adjoint.resize(m_nx);
+                m_adjointBuffer.resize(m_nx);
+
+                if (isSparse()) {
+                    m_constraintsOffset.setZero(m_nc);
+                    m_propagation.resize(0, 0);
+                    m_condensedHessian.resize(0, 0);
+                    m_condensedJacobian.resize(0, 0);
+                    m_freeStates.resize(0, 0);
+                } else {
+                    m_constraintsOffset.setZero(N * m_nc);
+                    m_propagation.setZero(N * m_nx, N * m_nu);
+                    m_condensedHessian.setZero(N * m_nu, N * m_nu);
+                    m_condensedJacobian.setZero(N * m_nc, N * m_nu);
+                    m_freeStates.setZero(m_nx, N + 1);
+                    m_adjointBlock.resize(m_nx, m_nu);
+                    m_adjointBlockBuffer.resize(m_nx, m_nu);
+                }
+
+                NonZerosCounter jacobianCounter, hessianCounter;
+                visitConstraintsJacobian(jacobianCounter);
+                visitHessian(hessianCounter);
+                m_jacobianNNZ = jacobianCounter.count;
+                m_hessianNNZ = hessianCounter.count;
+
+                m_hasSolution = false;
+                m_hasMultipliers = false;
+            }
+
+            bool checkMatrixBuffer(size_t rows, size_t cols, const char* description, double time) {
+                if ((m_matrixBuffer.rows() != rows) || (m_matrixBuffer.cols() != cols)) {
+                    std::ostringstream errorMsg;
+                    errorMsg << "The " << description << " at time " << time << " has dimensions " << m_matrixBuffer.rows() << "x" << m_matrixBuffer.cols();
+                    errorMsg << " while " << rows << "x" << cols << " was expected.";
+                    reportError("LinearMPC", "prepare", errorMsg.str().c_str());
+                    return false;
+                }
+                return true;
+            }
+
+            bool checkVectorBuffer(size_t size, const char* description, double time) {
+                if (m_vectorBuffer.size() != size) {
+                    std::ostringstream errorMsg;
+                    errorMsg << "The " << description << " at time " << time << " has dimension " << m_vectorBuffer.size() << " while " << size << " was expected.";
+                    reportError("LinearMPC", "prepare", errorMsg.str().c_str());
+                    return false;
+                }
+                return true;
+            }
+
+            bool evaluateStateCost(std::shared_ptr<QuadraticCost> cost, size_t step, double time, bool& hessianChanged) {
+                if (!cost) {
+                    hessianChanged = updateIfChanged(Eigen::MatrixXd::Zero(m_nx, m_nx), m_Q[step]) || hessianChanged;
+                    m_q[step].setZero();
+                    m_costBias[step] = 0.0;
+                    return true;
+                }
+
+                if (!cost->costSecondPartialDerivativeWRTState(time, m_zeroState, m_zeroControl, m_matrixBuffer) ||
+                    !checkMatrixBuffer(m_nx, m_nx, "state cost hessian", time)) {
+                    reportError("LinearMPC", "prepare", "Error while evaluating the state cost hessian.");
+                    return false;
+                }
+                hessianChanged = updateIfChanged(0.5 * (toEigen(m_matrixBuffer) + toEigen(m_matrixBuffer).transpose()), m_Q[step]) || hessianChanged;
+
+                if (!cost->costFirstPartialDerivativeWRTState(time, m_zeroState, m_zeroControl, m_vectorBuffer) ||
+                    !checkVectorBuffer(m_nx, "state cost gradient", time)) {
+                    reportError("LinearMPC", "prepare", "Error while evaluating the state cost gradient.");
+                    return false;
+                }
+                m_q[step] = toEigen(m_vectorBuffer);
+
+                if (!cost->costEvaluation(time, m_zeroState, m_zeroControl, m_costBias[step])) {
+                    reportError("LinearMPC", "prepare", "Error while evaluating the cost.");
+                    return false;
+                }
+
+                return true;
+            }
+
+            bool evaluateControlCost(size_t step, double time, bool& hessianChanged) {
+                if (!m_stageCost) {
+                    hessianChanged = updateIfChanged(Eigen::MatrixXd::Zero(m_nu, m_nu), m_R[step]) || hessianChanged;
+                    m_r[step].setZero();
+                    return true;
+                }
+
+                if (!m_stageCost->costSecondPartialDerivativeWRTControl(time, m_zeroState, m_zeroControl, m_matrixBuffer) ||
+                    !checkMatrixBuffer(m_nu, m_nu, "control cost hessian", time)) {
+                    reportError("LinearMPC", "prepare", "Error while evaluating the control cost hessian.");
+                    return false;
+                }
+                hessianChanged = updateIfChanged(0.5 * (toEigen(m_matrixBuffer) + toEigen(m_matrixBuffer).transpose()), m_R[step]) || hessianChanged;
+
+                if (!m_stageCost->costFirstPartialDerivativeWRTControl(time, m_zeroState, m_zeroControl, m_vectorBuffer) ||
+                    !checkVectorBuffer(m_nu, "control cost gradient", time)) {
+                    reportError("LinearMPC", "prepare", "Error while evaluating the control cost gradient.");
+                    return false;
+                }
+                m_r[step] = toEigen(m_vectorBuffer);
+
+                return true;
+            }
+
+            // Evaluate the matrices and the vectors of each step, keeping track of which matrices changed since the previous evaluation
+            bool evaluateSteps(bool& dynamicsChanged, bool& costChanged, bool& constraintsChanged) {
+                for (size_t k = 0; k <= m_preparedSteps; ++k) {
+                    double time = m_time + k * m_samplingTime;
+
+                    if (k == m_preparedSteps) {
+                        if (!evaluateStateCost(m_terminalCost, k, time, costChanged)) {
+                            return false;
+                        }
+                        break;
+                    }
+
+                    if (!m_system->dynamicsStateFirstDerivative(m_zeroState, time, m_matrixBuffer) ||
+                        !checkMatrixBuffer(m_nx, m_nx, "state matrix", time)) {
+                        reportError("LinearMPC", "prepare", "Error while evaluating the system state matrix.");
+                        return false;
+                    }
+                    dynamicsChanged = updateIfChanged(Eigen::MatrixXd::Identity(m_nx, m_nx) + m_samplingTime * toEigen(m_matrixBuffer), m_A[k]) || dynamicsChanged;
+
+                    if (!m_system->dynamicsControlFirstDerivative(m_zeroState, time, m_matrixBuffer) ||
+                        !checkMatrixBuffer(m_nx, m_nu, "control matrix", time)) {
+                        reportError("LinearMPC", "prepare", "Error while evaluating the system control matrix.");
+                        return false;
+                    }
+                    dynamicsChanged = updateIfChanged(m_samplingTime * toEigen(m_matrixBuffer), m_B[k]) || dynamicsChanged;
+
+                    if (!evaluateStateCost(m_stageCost, k, time, costChanged) || !evaluateControlCost(k, time, costChanged)) {
+                        return false;
+                    }
+
+                    Eigen::Index row = 0;
+                    for (auto& constraint : m_constraints) {
+                        Eigen::Index size = static_cast<Eigen::Index>(constraint->constraintSize());
+
+                        if (!constraint->constraintJacobianWRTState(time, m_zeroState, m_zeroControl, m_matrixBuffer) ||
+                            !checkMatrixBuffer(static_cast<size_t>(size), m_nx, "state constraint matrix", time)) {
+                            std::ostringstream errorMsg;
+                            errorMsg << "Error while evaluating the state matrix of the constraint " << constraint->name() << ".";
+                            reportError("LinearMPC", "prepare", errorMsg.str().c_str());
+                            return false;
+                        }
+                        constraintsChanged = updateIfChanged(toEigen(m_matrixBuffer), m_Cx[k].middleRows(row, size)) || constraintsChanged;
+
+                        if (!constraint->constraintJacobianWRTControl(time, m_zeroState, m_zeroControl, m_matrixBuffer) ||
+                            !checkMatrixBuffer(static_cast<size_t>(size), m_nu, "control constraint matrix", time)) {
+                            std::ostringstream errorMsg;
+                            errorMsg << "Error while evaluating the control matrix of the constraint " << constraint->name() << ".";
+                            reportError("LinearMPC", "prepare", errorMsg.str().c_str());
+                            return false;
+                        }
+                        constraintsChanged = updateIfChanged(toEigen(m_matrixBuffer), m_Cu[k].middleRows(row, size)) || constraintsChanged;
+
+                        if (k == 0) {
+                            if (constraint->getLowerBound(m_vectorBuffer)) {
+                                m_constraintsLowerBound.segment(row, size) = toEigen(m_vectorBuffer);
+                            } else {
+                                m_constraintsLowerBound.segment(row, size).setConstant(m_minusInfinity);
+                            }
+
+                            if (constraint->getUpperBound(m_vectorBuffer)) {
+                                m_constraintsUpperBound.segment(row, size) = toEigen(m_vectorBuffer);
+                            } else {
+                                m_constraintsUpperBound.segment(row, size).setConstant(m_plusInfinity);
+                            }
+                        }
+
+                        row += size;
+                    }
+                }
+                return true;
+            }
+
+            // dx_k/du_j = A_{k-1} ... A_{j+1} B_j, for k > j
+            void computePropagation() {
+                Eigen::Index nx = static_cast<Eigen::Index>(m_nx), nu = static_cast<Eigen::Index>(m_nu);
+                m_propagation.setZero();
+                for (size_t j = 0; j < m_preparedSteps; ++j) {
+                    Eigen::Index col = static_cast<Eigen::Index>(j) * nu;
+                    m_propagation.block(static_cast<Eigen::Index>(j) * nx, col, nx, nu) = m_B[j];
+                    for (size_t k = j + 1; k < m_preparedSteps; ++k) { //block of x_{k+1}
+                        m_propagation.block(static_cast<Eigen::Index>(k) * nx, col, nx, nu).noalias() =
+                                m_A[k] * m_propagation.block(static_cast<Eigen::Index>(k - 1) * nx, col, nx, nu);
+                    }
+                }
+            }
+
+            Eigen::Block<Eigen::MatrixXd> propagationBlock(size_t state, size_t control) { //dx_state/du_control, with state > control
+                Eigen::Index nx = static_cast<Eigen::Index>(m_nx), nu = static_cast<Eigen::Index>(m_nu);
+                return m_propagation.block(static_cast<Eigen::Index>(state - 1) * nx, static_cast<Eigen::Index>(control) * nu, nx, nu);
+            }
+
+            // H_ij = sum_{k > max(i,j)} (dx_k/du_i)^T Q_k dx_k/du_j + R_i delta_ij. For i >= j, H_ij = B_i^T mu_{i+1},
+            // where mu_k = Q_k dx_k/du_j + A_k^T mu_{k+1} is computed backward, avoiding the cubic cost of the products of the propagation blocks.
+            void computeCondensedHessian() {
+                Eigen::Index nu = static_cast<Eigen::Index>(m_nu);
+                for (size_t j = 0; j < m_preparedSteps; ++j) {
+                    Eigen::Index col = static_cast<Eigen::Index>(j) * nu;
+                    for (size_t k = m_preparedSteps; k > j; --k) {
+                        if (k == m_preparedSteps) {
+                            m_adjointBlock.noalias() = m_Q[k] * propagationBlock(k, j);
+                        } else {
+                            m_adjointBlockBuffer.noalias() = m_Q[k] * propagationBlock(k, j);
+                            m_adjointBlockBuffer.noalias() += m_A[k].transpose() * m_adjointBlock;
+                            m_adjointBlock.swap(m_adjointBlockBuffer);
+                        }
+                        size_t i = k - 1;
+                        m_condensedHessian.block(static_cast<Eigen::Index>(i) * nu, col, nu, nu).noalias() = m_B[i].transpose() * m_adjointBlock;
+                    }
+                    m_condensedHessian.block(col, col, nu, nu) += m_R[j];
+                    for (size_t i = j + 1; i < m_preparedSteps; ++i) {
+                        m_condensedHessian.block(col, static_cast<Eigen::Index>(i) * nu, nu, nu) =
+                                m_condensedHessian.block(static_cast<Eigen::Index>(i) * nu, col, nu, nu).transpose();
+                    }
+                }
+            }
+
+            void computeCondensedJacobian() {
+                Eigen::Index nu = static_cast<Eigen::Index>(m_nu), nc = static_cast<Eigen::Index>(m_nc);
+                m_condensedJacobian.setZero();
+                for (size_t k = 0; k < m_preparedSteps; ++k) {
+                    Eigen::Index row = static_cast<Eigen::Index>(k) * nc;
+                    for (size_t j = 0; j < k; ++j) {
+                        m_condensedJacobian.block(row, static_cast<Eigen::Index>(j) * nu, nc, nu).noalias() = m_Cx[k] * propagationBlock(k, j);
+                    }
+                    m_condensedJacobian.block(row, static_cast<Eigen::Index>(k) * nu, nc, nu) = m_Cu[k];
+                }
+            }
+
+            // Vectors depending on the initial state and on the cost gradients, recomputed at each tick
+            void computeVectors() {
+                Eigen::Index nx = static_cast<Eigen::Index>(m_nx), nu = static_cast<Eigen::Index>(m_nu), nc = static_cast<Eigen::Index>(m_nc);
+
+                m_costConstant = 0.0;
+                for (double bias : m_costBias) {
+                    m_costConstant += bias;
+                }
+
+                if (isSparse()) {
+                    m_firstDynamicsBias.noalias() = m_A[0] * m_initialState;
+                    m_constraintsOffset.noalias() = m_Cx[0] * m_initialState;
+                    for (size_t k = 0; k < m_preparedSteps; ++k) {
+                        m_costLinearTerm.segment(static_cast<Eigen::Index>(controlIndex(k)), nu) = m_r[k];
+                        m_costLinearTerm.segment(static_cast<Eigen::Index>(stateIndex(k + 1)), nx) = m_q[k + 1];
+                    }
+                    return;
+                }
+
+                m_freeStates.col(0) = m_initialState;
+                for (size_t k = 0; k < m_preparedSteps; ++k) {
+                    m_freeStates.col(static_cast<Eigen::Index>(k + 1)).noalias() = m_A[k] * m_freeStates.col(static_cast<Eigen::Index>(k));
+                    m_constraintsOffset.segment(static_cast<Eigen::Index>(k) * nc, nc).noalias() = m_Cx[k] * m_freeStates.col(static_cast<Eigen::Index>(k));
+                }
+
+                // The gradient is sum_k (dx_k/du)^T (Q_k x^free_k + q_k) + r, computed backward with the adjoint lambda_k = Q_k x^free_k + q_k + A_k^T lambda_{k+1}
+                for (size_t k = m_preparedSteps; k > 0; --k) {
+                    m_adjointBuffer = m_q[k];
+                    m_adjointBuffer.noalias() += m_Q[k] * m_freeStates.col(static_cast<Eigen::Index>(k));
+                    if (k < m_preparedSteps) {
+                        m_adjointBuffer.noalias() += m_A[k].transpose() * m_adjoint;
+                    }
+                    m_adjoint.swap(m_adjointBuffer);
+                    m_costLinearTerm.segment(static_cast<Eigen::Index>(k - 1) * nu, nu) = m_r[k - 1];
+                    m_costLinearTerm.segment(static_cast<Eigen::Index>(k - 1) * nu, nu).noalias() += m_B[k - 1].transpose() * m_adjoint;
+                }
+            }
+
+            // Calls visitor(row, col, value) for each nonzero element of the constraints jacobian, row by row
+            template <typename Visitor>
+            void visitConstraintsJacobian(Visitor& visitor) const {
+                if (!isSparse()) {
+                    for (size_t k = 0; k < m_preparedSteps; ++k) {
+                        for (size_t i = 0; i < m_nc; ++i) {
+                            size_t row = k * m_nc + i;
+                            for (size_t j = 0; j < (k + 1) * m_nu; ++j) {
+                                visitor(row, j, m_condensedJacobian.size() ? m_condensedJacobian(static_cast<Eigen::Index>(row), static_cast<Eigen::Index>(j)) : 0.0);
+                            }
+                        }
+                    }
+                    return;
+                }
+
+                for (size_t k = 0; k < m_preparedSteps; ++k) {
+                    size_t row = k * constraintsPerStep();
+                    size_t uCol = controlIndex(k);
+                    size_t nextStateCol = stateIndex(k + 1);
+                    const Eigen::MatrixXd& A = m_A[k];
+                    const Eigen::MatrixXd& B = m_B[k];
+                    const Eigen::MatrixXd& Cx = m_Cx[k];
+                    const Eigen::MatrixXd& Cu = m_Cu[k];
+
+                    for (size_t i = 0; i < m_nx; ++i) {
+                        if (k > 0) {
+                            size_t xCol = stateIndex(k);
+                            for (size_t j = 0; j < m_nx; ++j) {
+                                visitor(row + i, xCol + j, -A(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)));
+                            }
+                        }
+                        for (size_t j = 0; j < m_nu; ++j) {
+                            visitor(row + i, uCol + j, -B(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)));
+                        }
+                        visitor(row + i, nextStateCol + i, 1.0);
+                    }
+
+                    for (size_t i = 0; i < m_nc; ++i) {
+                        if (k > 0) {
+                            size_t xCol = stateIndex(k);
+                            for (size_t j = 0; j < m_nx; ++j) {
+                                visitor(row + m_nx + i, xCol + j, Cx(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)));
+                            }
+                        }
+                        for (size_t j = 0; j < m_nu; ++j) {
+                            visitor(row + m_nx + i, uCol + j, Cu(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)));
+                        }
+                    }
+                }
+            }
+
+            // Calls visitor(row, col, value) for each nonzero element of the cost hessian, row by row
+            template <typename Visitor>
+            void visitHessian(Visitor& visitor) const {
+                if (!isSparse()) {
+                    size_t nv = m_preparedSteps * m_nu;
+                    for (size_t i = 0; i < nv; ++i) {
+                        for (size_t j = 0; j < nv; ++j) {
+                            visitor(i, j, m_condensedHessian.size() ? m_condensedHessian(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)) : 0.0);
+                        }
+                    }
+                    return;
+                }
+
+                for (size_t k = 0; k < m_preparedSteps; ++k) {
+                    size_t uCol = controlIndex(k);
+                    for (size_t i = 0; i < m_nu; ++i) {
+                        for (size_t j = 0; j < m_nu; ++j) {
+                            visitor(uCol + i, uCol + j, m_R[k](static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)));
+                        }
+                    }
+                    size_t xCol = stateIndex(k + 1);
+                    for (size_t i = 0; i < m_nx; ++i) {
+                        for (size_t j = 0; j < m_nx; ++j) {
+                            visitor(xCol + i, xCol + j, m_Q[k + 1](static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)));
+                        }
+                    }
+                }
+            }
+
+            // Fill m_states and m_controls from the optimization variables
+            void computeTrajectory(const Eigen::VectorXd& variables) {
+                Eigen::Index nx = static_cast<Eigen::Index>(m_nx), nu = static_cast<Eigen::Index>(m_nu);
+                m_states.col(0) = m_initialState;
+                for (size_t k = 0; k < m_preparedSteps; ++k) {
+                    Eigen::Index col = static_cast<Eigen::Index>(k);
+                    m_controls.col(col) = variables.segment(static_cast<Eigen::Index>(controlIndex(k)), nu);
+                    if (isSparse()) {
+                        m_states.col(col + 1) = variables.segment(static_cast<Eigen::Index>(stateIndex(k + 1)), nx);
+                    } else {
+                        m_states.col(col + 1).noalias() = m_A[k] * m_states.col(col);
+                        m_states.col(col + 1).noalias() += m_B[k] * m_controls.col(col);
+                    }
+                }
+            }
+
+            virtual bool prepare() override {
+                if (!m_system) {
+                    reportError("LinearMPC", "prepare", "The linear system has not been set.");
+                    return false;
+                }
+
+                if (m_steps == 0) {
+                    reportError("LinearMPC", "prepare", "First you need to set the horizon.");
+                    return false;
+                }
+
+                if (!m_initialStateSet) {
+                    reportError("LinearMPC", "prepare", "First you need to set the state feedback.");
+                    return false;
+                }
+
+                size_t nx = m_system->stateSpaceSize();
+                size_t nu = m_system->controlSpaceSize();
+                size_t nc = 0;
+                for (auto& constraint : m_constraints) {
+                    nc += constraint->constraintSize();
+                }
+
+                if (static_cast<size_t>(m_initialState.size()) != nx) {
+                    reportError("LinearMPC", "prepare", "The state feedback dimension does not match the system state dimension.");
+                    return false;
+                }
+
+                bool structureChanged = !m_prepared || (nx != m_nx) || (nu != m_nu) || (nc != m_nc) ||
+                        (m_steps != m_preparedSteps) || (m_formulation != m_preparedFormulation);
+
+                if (structureChanged) {
+                    m_nx = nx;
+                    m_nu = nu;
+                    m_nc = nc;
+                    m_preparedSteps = m_steps;
+                    m_preparedFormulation = m_formulation;
+                    allocate();
+                }
+
+                m_prepared = false; //in case of failures, the next call rebuilds everything
+
+                bool dynamicsChanged = structureChanged, costChanged = structureChanged, constraintsChanged = structureChanged;
+                if (!evaluateSteps(dynamicsChanged, costChanged, constraintsChanged)) {
+                    return false;
+                }
+
+                bool hessianChanged = costChanged;
+                bool jacobianChanged = dynamicsChanged || constraintsChanged;
+
+                if (!isSparse()) {
+                    if (dynamicsChanged) {
+                        computePropagation();
+                    }
+                    if (dynamicsChanged || costChanged) {
+                        computeCondensedHessian();
+                        hessianChanged = true;
+                    }
+                    if (jacobianChanged) {
+                        computeCondensedJacobian();
+                    }
+                }
+
+                computeVectors();
+
+                m_infoData->hasLinearConstraints = true;
+                m_infoData->hasNonLinearConstraints = false;
+                m_infoData->costIsLinear = false;
+                m_infoData->costIsQuadratic = true;
+                m_infoData->costIsNonLinear = false;
+                m_infoData->hasSparseConstraintJacobian = true;
+                m_infoData->hasSparseHessian = isSparse();
+                m_infoData->hessianIsProvided = true;
+                m_infoData->hessianIsUnchanged = !hessianChanged;
+                m_infoData->constraintsJacobianIsUnchanged = !jacobianChanged;
+
+                m_guessIsValid = m_hasSolution;
+                m_prepared = true;
+                return true;
+            }
+
+            virtual void reset() override {
+                m_prepared = false;
+                m_hasSolution = false;
+                m_guessIsValid = false;
+                m_hasMultipliers = false;
+            }
+
+            virtual unsigned int numberOfVariables() override {
+                return static_cast<unsigned int>(m_preparedSteps * variablesPerStep());
+            }
+
+            virtual unsigned int numberOfConstraints() override {
+                return static_cast<unsigned int>(m_preparedSteps * constraintsPerStep());
+            }
+
+            virtual bool getConstraintsBounds(VectorDynSize& constraintsLowerBounds, VectorDynSize& constraintsUpperBounds) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "getConstraintsBounds", "First you need to call the prepare method.");
+                    return false;
+                }
+
+                unsigned int nc = numberOfConstraints();
+                constraintsLowerBounds.resize(nc);
+                constraintsUpperBounds.resize(nc);
+                double* lower = constraintsLowerBounds.data();
+                double* upper = constraintsUpperBounds.data();
+
+                for (size_t k = 0; k < m_preparedSteps; ++k) {
+                    size_t row = k * constraintsPerStep();
+                    if (isSparse()) {
+                        for (size_t i = 0; i < m_nx; ++i) {
+                            lower[row + i] = upper[row + i] = (k == 0) ? m_firstDynamicsBias(static_cast<Eigen::Index>(i)) : 0.0;
+                        }
+                        row += m_nx;
+                    }
+                    for (size_t i = 0; i < m_nc; ++i) {
+                        double offset = 0.0;
+                        if (!isSparse()) {
+                            offset = m_constraintsOffset(static_cast<Eigen::Index>(k * m_nc + i));
+                        } else if (k == 0) {
+                            offset = m_constraintsOffset(static_cast<Eigen::Index>(i));
+                        }
+                        lower[row + i] = shiftedBound(m_constraintsLowerBound(static_cast<Eigen::Index>(i)), offset);
+                        upper[row + i] = shiftedBound(m_constraintsUpperBound(static_cast<Eigen::Index>(i)), offset);
+                    }
+                }
+
+                return true;
+            }
+
+            virtual bool getVariablesUpperBound(VectorDynSize& /*variablesUpperBound*/) override {
+                return false;
+            }
+
+            virtual bool getVariablesLowerBound(VectorDynSize& /*variablesLowerBound*/) override {
+                return false;
+            }
+
+            virtual bool getConstraintsJacobianInfo(std::vector<size_t>& nonZeroElementRows, std::vector<size_t>& nonZeroElementColumns) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "getConstraintsJacobianInfo", "First you need to call the prepare method.");
+                    return false;
+                }
+                nonZeroElementRows.clear();
+                nonZeroElementColumns.clear();
+                nonZeroElementRows.reserve(m_jacobianNNZ);
+                nonZeroElementColumns.reserve(m_jacobianNNZ);
+                NonZerosIndicesCollector collector(nonZeroElementRows, nonZeroElementColumns);
+                visitConstraintsJacobian(collector);
+                return true;
+            }
+
+            virtual bool getHessianInfo(std::vector<size_t>& nonZeroElementRows, std::vector<size_t>& nonZeroElementColumns) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "getHessianInfo", "First you need to call the prepare method.");
+                    return false;
+                }
+                nonZeroElementRows.clear();
+                nonZeroElementColumns.clear();
+                nonZeroElementRows.reserve(m_hessianNNZ);
+                nonZeroElementColumns.reserve(m_hessianNNZ);
+                NonZerosIndicesCollector collector(nonZeroElementRows, nonZeroElementColumns);
+                visitHessian(collector);
+                return true;
+            }
+
+            // Number of steps elapsed since the previous solution, false if the solution cannot be used as guess
+            bool elapsedSteps(size_t& shift) const {
+                if (!m_prepared || !m_guessIsValid) {
+                    return false;
+                }
+
+                double elapsed = std::round((m_time - m_solutionTime) / m_samplingTime);
+                if (elapsed < 0) {
+                    return false;
+                }
+
+                shift = static_cast<size_t>(elapsed);
+                return true;
+            }
+
+            // Copy the blocks of each step of the horizon from previous, shifted by the number of elapsed steps. The last block is repeated.
+            void shiftBlocks(const Eigen::VectorXd& previous, size_t blockSize, size_t shift, VectorDynSize& shifted) const {
+                Eigen::Index size = static_cast<Eigen::Index>(blockSize);
+                shifted.resize(static_cast<unsigned int>(m_preparedSteps * blockSize));
+                for (size_t k = 0; k < m_preparedSteps; ++k) {
+                    size_t source = std::min(k + shift, m_preparedSteps - 1);
+                    toEigen(shifted).segment(static_cast<Eigen::Index>(k) * size, size) =
+                            previous.segment(static_cast<Eigen::Index>(source) * size, size);
+                }
+            }
+
+            // The previous solution, shifted by the number of steps elapsed since then
+            virtual bool getGuess(VectorDynSize& guess) override {
+                size_t shift;
+                if (!elapsedSteps(shift)) {
+                    return false;
+                }
+
+                shiftBlocks(m_solution, variablesPerStep(), shift, guess);
+                return true;
+            }
+
+            // The multipliers of the previous solution, shifted as the primal guess. There are no bounds on the variables.
+            virtual bool getDualGuess(VectorDynSize& constraintsMultipliers, VectorDynSize& lowerBoundsMultipliers, VectorDynSize& upperBoundsMultipliers) override {
+                size_t shift;
+                if (!m_hasMultipliers || !elapsedSteps(shift)) {
+                    return false;
+                }
+
+                shiftBlocks(m_constraintsMultipliers, constraintsPerStep(), shift, constraintsMultipliers);
+                lowerBoundsMultipliers.resize(numberOfVariables());
+                lowerBoundsMultipliers.zero();
+                upperBoundsMultipliers.resize(numberOfVariables());
+                upperBoundsMultipliers.zero();
+                return true;
+            }
+
+            virtual bool setVariables(const VectorDynSize& variables) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "setVariables", "First you need to call the prepare method.");
+                    return false;
+                }
+                if (variables.size() != numberOfVariables()) {
+                    reportError("LinearMPC", "setVariables", "The input variables have a dimension different from the expected one.");
+                    return false;
+                }
+                m_variables = toEigen(variables);
+                return true;
+            }
+
+            virtual bool evaluateCostFunction(double& costValue) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "evaluateCostFunction", "First you need to call the prepare method.");
+                    return false;
+                }
+
+                computeTrajectory(m_variables);
+
+                costValue = m_costConstant;
+                for (size_t k = 0; k <= m_preparedSteps; ++k) {
+                    Eigen::Index col = static_cast<Eigen::Index>(k);
+                    costValue += 0.5 * m_states.col(col).dot(m_Q[k] * m_states.col(col)) + m_q[k].dot(m_states.col(col));
+                    if (k < m_preparedSteps) {
+                        costValue += 0.5 * m_controls.col(col).dot(m_R[k] * m_controls.col(col)) + m_r[k].dot(m_controls.col(col));
+                    }
+                }
+                return true;
+            }
+
+            virtual bool evaluateCostGradient(VectorDynSize& gradient) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "evaluateCostGradient", "First you need to call the prepare method.");
+                    return false;
+                }
+
+                gradient.resize(numberOfVariables());
+                Eigen::Map<Eigen::VectorXd> gradientMap = toEigen(gradient);
+                gradientMap = m_costLinearTerm;
+
+                if (!isSparse()) {
+                    gradientMap.noalias() += m_condensedHessian * m_variables;
+                    return true;
+                }
+
+                Eigen::Index nx = static_cast<Eigen::Index>(m_nx), nu = static_cast<Eigen::Index>(m_nu);
+                for (size_t k = 0; k < m_preparedSteps; ++k) {
+                    Eigen::Index uIndex = static_cast<Eigen::Index>(controlIndex(k));
+                    Eigen::Index xIndex = static_cast<Eigen::Index>(stateIndex(k + 1));
+                    gradientMap.segment(uIndex, nu).noalias() += m_R[k] * m_variables.segment(uIndex, nu);
+                    gradientMap.segment(xIndex, nx).noalias() += m_Q[k + 1] * m_variables.segment(xIndex, nx);
+                }
+                return true;
+            }
+
+            virtual bool evaluateCostHessian(MatrixDynSize& hessian) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "evaluateCostHessian", "First you need to call the prepare method.");
+                    return false;
+                }
+                unsigned int nv = numberOfVariables();
+                hessian.resize(nv, nv);
+                hessian.zero();
+                DenseMatrixWriter writer(hessian.data(), nv);
+                visitHessian(writer);
+                return true;
+            }
+
+            virtual bool evaluateConstraints(VectorDynSize& constraints) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "evaluateConstraints", "First you need to call the prepare method.");
+                    return false;
+                }
+
+                constraints.resize(numberOfConstraints());
+                Eigen::Map<Eigen::VectorXd> constraintsMap = toEigen(constraints);
+
+                if (!isSparse()) {
+                    constraintsMap.noalias() = m_condensedJacobian * m_variables;
+                    return true;
+                }
+
+                Eigen::Index nx = static_cast<Eigen::Index>(m_nx), nu = static_cast<Eigen::Index>(m_nu), nc = static_cast<Eigen::Index>(m_nc);
+                for (size_t k = 0; k < m_preparedSteps; ++k) {
+                    Eigen::Index row = static_cast<Eigen::Index>(k * constraintsPerStep());
+                    Eigen::Index uIndex = static_cast<Eigen::Index>(controlIndex(k));
+                    auto dynamics = constraintsMap.segment(row, nx);
+                    auto linearConstraints = constraintsMap.segment(row + nx, nc);
+
+                    dynamics = m_variables.segment(static_cast<Eigen::Index>(stateIndex(k + 1)), nx);
+                    dynamics.noalias() -= m_B[k] * m_variables.segment(uIndex, nu);
+                    linearConstraints.noalias() = m_Cu[k] * m_variables.segment(uIndex, nu);
+                    if (k > 0) {
+                        Eigen::Index xIndex = static_cast<Eigen::Index>(stateIndex(k));
+                        dynamics.noalias() -= m_A[k] * m_variables.segment(xIndex, nx);
+                        linearConstraints.noalias() += m_Cx[k] * m_variables.segment(xIndex, nx);
+                    }
+                }
+                return true;
+            }
+
+            virtual bool evaluateConstraintsJacobian(MatrixDynSize& jacobian) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "evaluateConstraintsJacobian", "First you need to call the prepare method.");
+                    return false;
+                }
+                unsigned int nc = numberOfConstraints(), nv = numberOfVariables();
+                jacobian.resize(nc, nv);
+                jacobian.zero();
+                DenseMatrixWriter writer(jacobian.data(), nv);
+                visitConstraintsJacobian(writer);
+                return true;
+            }
+
+            virtual bool evaluateConstraintsHessian(const VectorDynSize& /*constraintsMultipliers*/, MatrixDynSize& hessian) override {
+                unsigned int nv = numberOfVariables();
+                hessian.resize(nv, nv);
+                hessian.zero();
+                return true;
+            }
+
+            virtual bool evaluateConstraintsJacobianNonZeros(VectorDynSize& nonZeroElements) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "evaluateConstraintsJacobianNonZeros", "First you need to call the prepare method.");
+                    return false;
+                }
+                nonZeroElements.resize(static_cast<unsigned int>(m_jacobianNNZ));
+                NonZerosWriter writer(nonZeroElements.data());
+                visitConstraintsJacobian(writer);
+                return true;
+            }
+
+            virtual bool evaluateCostHessianNonZeros(VectorDynSize& nonZeroElements) override {
+                if (!m_prepared) {
+                    reportError("LinearMPC", "evaluateCostHessianNonZeros", "First you need to call the prepare method.");
+                    return false;
+                }
+                nonZeroElements.resize(static_cast<unsigned int>(m_hessianNNZ));
+                NonZerosWriter writer(nonZeroElements.data());
+                visitHessian(writer);
+                return true;
+            }
+
+            virtual bool evaluateConstraintsHessianNonZeros(const VectorDynSize& /*constraintsMultipliers*/, VectorDynSize& nonZeroElements) override {
+                nonZeroElements.resize(static_cast<unsigned int>(m_hessianNNZ));
+                nonZeroElements.zero();
+                return true;
+            }
+
+            bool setSolution(const VectorDynSize& solution) {
+                if (!m_prepared || (solution.size() != numberOfVariables())) {
+                    reportError("LinearMPC", "solve", "The solution returned by the optimizer has an unexpected dimension.");
+                    return false;
+                }
+                m_solution = toEigen(solution);
+                m_solutionTime = m_time;
+                m_hasSolution = true;
+                m_hasMultipliers = false;
+                return true;
+            }
+
+            void setMultipliers(const VectorDynSize& constraintsMultipliers) {
+                m_hasMultipliers = (constraintsMultipliers.size() == numberOfConstraints());
+                if (m_hasMultipliers) {
+                    m_constraintsMultipliers = toEigen(constraintsMultipliers);
+                }
+            }
+        };
+
+        LinearMPC::LinearMPCTranscription::~LinearMPCTranscription() {}
+
+        // MARK: Class implementation
+
+        LinearMPC::LinearMPC(const std::shared_ptr<LinearSystem> &system)
+        : Controller(system ? system->controlSpaceSize() : 0)
+        , m_transcription(new LinearMPCTranscription)
+        {
+            assert(m_transcription);
+            m_transcription->m_system = system;
+        }
+
+        LinearMPC::~LinearMPC()
+        { }
+
+        bool LinearMPC::setHorizon(size_t numberOfSteps, double samplingTime)
+        {
+            if (numberOfSteps == 0) {
+                reportError("LinearMPC", "setHorizon", "The number of steps has to be positive.");
+                return false;
+            }
+
+            if (samplingTime <= 0) {
+                reportError("LinearMPC", "setHorizon", "The sampling time has to be positive.");
+                return false;
+            }
+
+            m_transcription->m_steps = numberOfSteps;
+            m_transcription->m_samplingTime = samplingTime;
+            return true;
+        }
+
+        bool LinearMPC::setFormulation(LinearMPCFormulation formulation)
+        {
+            m_transcription->m_formulation = formulation;
+            return true;
+        }
+
+        bool LinearMPC::setStageCost(std::shared_ptr<QuadraticCost> stageCost)
+        {
+            if (!stageCost) {
+                reportError("LinearMPC", "setStageCost", "Empty cost pointer.");
+                return false;
+            }
+            m_transcription->m_stageCost = stageCost;
+            return true;
+        }
+
+        bool LinearMPC::setTerminalCost(std::shared_ptr<QuadraticCost> terminalCost)
+        {
+            if (!terminalCost) {
+                reportError("LinearMPC", "setTerminalCost", "Empty cost pointer.");
+                return false;
+            }
+            m_transcription->m_terminalCost = terminalCost;
+            return true;
+        }
+
+        bool LinearMPC::addConstraint(std::shared_ptr<LinearConstraint> constraint)
+        {
+            if (!constraint) {
+                reportError("LinearMPC", "addConstraint", "Empty constraint pointer.");
+                return false;
+            }
+            m_transcription->m_constraints.push_back(constraint);
+            m_transcription->m_prepared = false;
+            return true;
+        }
+
+        bool LinearMPC::setOptimizer(std::shared_ptr<optimization::Optimizer> optimizer)
+        {
+            if (!optimizer) {
+                reportError("LinearMPC", "setOptimizer", "Empty optimizer pointer.");
+                return false;
+            }
+
+            if (!(optimizer->setProblem(m_transcription))){
+                reportError("LinearMPC", "setOptimizer", "Cannot use the selected optimizer to solve the MPC problem.");
+                return false;
+            }
+
+            m_optimizer = optimizer;
+
+            m_transcription->m_plusInfinity = m_optimizer->plusInfinity();
+
+            m_transcription->m_minusInfinity = m_optimizer->minusInfinity();
+
+            return true;
+        }
+
+        bool LinearMPC::setStateFeedback(double time, const VectorDynSize &stateFeedback)
+        {
+            if (!m_transcription->m_system) {
+                reportError("LinearMPC", "setStateFeedback", "The linear system has not been set.");
+                return false;
+            }
+
+            if (stateFeedback.size() != m_transcription->m_system->stateSpaceSize()) {
+                reportError("LinearMPC", "setStateFeedback", "The state feedback dimension does not match the system state dimension.");
+                return false;
+            }
+
+            m_transcription->m_time = time;
+            m_transcription->m_initialState = toEigen(stateFeedback);
+            m_transcription->m_initialStateSet = true;
+            return true;
+        }
+
+        bool LinearMPC::solve()
+        {
+            if (!m_optimizer){
+                reportError("LinearMPC", "solve", "No optimizer selected.");
+                return false;
+            }
+
+            if (!(m_optimizer->solve())) {
+                reportError("LinearMPC", "solve", "Error when calling the optimizer solve method.");
+                return false;
+            }
+
+            VectorDynSize& solution = m_transcription->m_vectorBuffer;
+            if (!(m_optimizer->getPrimalVariables(solution))){
+                reportError("LinearMPC", "solve", "Error while retrieving the primal variables from the optimizer.");
+                return false;
+            }
+
+            if (!m_transcription->setSolution(solution)) {
+                return false;
+            }
+
+            // The multipliers are only used as guess for the next solve, so the optimizer is not required to provide them
+            if (m_optimizer->getDualVariables(m_transcription->m_multipliersBuffer, m_transcription->m_lowerBoundsMultipliersBuffer,
+                                              m_transcription->m_upperBoundsMultipliersBuffer)) {
+                m_transcription->setMultipliers(m_transcription->m_multipliersBuffer);
+            }
+            return true;
+        }
+
+        bool LinearMPC::doControl(VectorDynSize &controllerOutput)
+        {
+            if (!solve()) {
+                reportError("LinearMPC", "doControl", "Failed to solve the MPC problem.");
+                return false;
+            }
+
+            controllerOutput.resize(static_cast<unsigned int>(m_transcription->m_nu));
+            toEigen(controllerOutput) = m_transcription->m_solution.head(static_cast<Eigen::Index>(m_transcription->m_nu));
+            return true;
+        }
+
+        bool LinearMPC::getSolution(std::vector<VectorDynSize> &states, std::vector<VectorDynSize> &controls)
+        {
+            if (!(m_transcription->m_hasSolution)) {
+                reportError("LinearMPC", "getSolution", "First you need to call the solve method.");
+                return false;
+            }
+
+            m_transcription->computeTrajectory(m_transcription->m_solution);
+
+            size_t steps = m_transcription->m_preparedSteps;
+            states.resize(steps + 1);
+            controls.resize(steps);
+            for (size_t k = 0; k <= steps; ++k) {
+                Eigen::Index col = static_cast<Eigen::Index>(k);
+                states[k].resize(static_cast<unsigned int>(m_transcription->m_nx));
+                toEigen(states[k]) = m_transcription->m_states.col(col);
+                if (k < steps) {
+                    controls[k].resize(static_cast<unsigned int>(m_transcription->m_nu));
+                    toEigen(controls[k]) = m_transcription->m_controls.col(col);
+                }
+            }
+            return true;
+        }
+
+        void LinearMPC::reset()
+        {
+            m_transcription->reset();
+        }
+
+    }
+}
@@ -19,6 +19,7 @@
 
 #include <iDynTree/VectorDynSize.h>
 #include <iDynTree/Utils.h>
+#include <iDynTree/WorkerPool.h>
 
 #include <Eigen/Dense>
 #include <iDynTree/EigenHelpers.h>
@@ -131,6 +132,250 @@ namespace iDynTree {
 
         };
 
+        // Position of each element of a sparsity pattern in the corresponding vector of nonzero elements,
+        // used to write the blocks of the jacobian and of the hessians directly in the vector of nonzero elements
+        class NonZerosPositionMap {
+            std::vector<size_t> m_rowBegin; //the elements of row i are in [m_rowBegin[i], m_rowBegin[i + 1])
+            std::vector<std::pair<size_t, size_t>> m_elements; //column and position of each element, ordered by row and column
+            typedef std::vector<std::pair<size_t, size_t>>::const_iterator ElementIterator;
+
+            ElementIterator firstElement(size_t row, size_t startColumn) const {
+                assert(row + 1 < m_rowBegin.size());
+                return std::lower_bound(m_elements.begin() + static_cast<std::ptrdiff_t>(m_rowBegin[row]),
+                                        m_elements.begin() + static_cast<std::ptrdiff_t>(m_rowBegin[row + 1]),
+                                        std::make_pair(startColumn, static_cast<size_t>(0)));
+            }
+
+            ElementIterator rowEnd(size_t row) const {
+                return m_elements.begin() + static_cast<std::ptrdiff_t>(m_rowBegin[row + 1]);
+            }
+
+        public:
+
+            void build(size_t numberOfRows, const std::vector<size_t>& rows, const std::vector<size_t>& columns, size_t nonZeros) {
+                m_rowBegin.assign(numberOfRows + 1, 0);
+                for (size_t i = 0; i < nonZeros; ++i) {
+                    assert(rows[i] < numberOfRows);
+                    m_rowBegin[rows[i] + 1]++;
+                }
+                for (size_t row = 0; row < numberOfRows; ++row) {
+                    m_rowBegin[row + 1] += m_rowBegin[row];
+                }
+
+                std::vector<size_t> nextElement(m_rowBegin.begin(), m_rowBegin.end() - 1);
+                m_elements.resize(nonZeros);
+                for (size_t i = 0; i < nonZeros; ++i) {
+                    m_elements[nextElement[rows[i]]++] = std::make_pair(columns[i], i);
+                }
+
+                for (size_t row = 0; row < numberOfRows; ++row) {
+                    std::sort(m_elements.begin() + static_cast<std::ptrdiff_t>(m_rowBegin[row]),
+                              m_elements.begin() + static_cast<std::ptrdiff_t>(m_rowBegin[row + 1]));
+                }
+            }
+
+            size_t numberOfNonZeros() const {
+                return m_elements.size();
+            }
+
+            static const size_t NotANonZero = static_cast<size_t>(-1);
+
+            // Position of each element of the block of size rows x cols starting at (startRow, startColumn), stored row by row,
+            // or NotANonZero for the elements not belonging to the sparsity pattern
+            void blockPositions(size_t startRow, size_t startColumn, size_t rows, size_t cols, size_t* positions) const {
+                std::fill(positions, positions + rows * cols, NotANonZero);
+                for (size_t i = 0; i < rows; ++i) {
+                    ElementIterator end = rowEnd(startRow + i);
+                    for (ElementIterator element = firstElement(startRow + i, startColumn);
+                         element != end && element->first < startColumn + cols; ++element) {
+                        positions[i * cols + element->first - startColumn] = element->second;
+                    }
+                }
+            }
+
+            void addToDiagonal(double value, VectorDynSize& nonZeros) const {
+                double* nonZerosData = nonZeros.data();
+                for (size_t row = 0; row + 1 < m_rowBegin.size(); ++row) {
+                    ElementIterator element = firstElement(row, row);
+                    if (element != rowEnd(row) && element->first == row) {
+                        nonZerosData[element->second] += value;
+                    }
+                }
+            }
+        };
+
+        // The jacobian and the hessians are evaluated block by block, and the blocks are written either
+        // in a dense matrix or in the vector of nonzero elements by the following two classes
+        class DenseMatrixBlocks {
+            MatrixDynSize& m_matrix;
+
+        public:
+            DenseMatrixBlocks(MatrixDynSize& matrix) : m_matrix(matrix) { }
+
+            void initialize(size_t rows, size_t cols) {
+                if ((m_matrix.rows() != rows) || (m_matrix.cols() != cols)) {
+                    m_matrix.resize(static_cast<unsigned int>(rows), static_cast<unsigned int>(cols));
+                }
+            }
+
+            void zero() {
+                m_matrix.zero();
+            }
+
+            void setBlock(const MatrixDynSize& block, size_t startRow, size_t startCol) {
+                toEigen(m_matrix).block(static_cast<Eigen::Index>(startRow), static_cast<Eigen::Index>(startCol), block.rows(), block.cols()) = toEigen(block);
+            }
+
+            void addBlock(const MatrixDynSize& block, size_t startRow, size_t startCol) {
+                toEigen(m_matrix).block(static_cast<Eigen::Index>(startRow), static_cast<Eigen::Index>(startCol), block.rows(), block.cols()) += toEigen(block);
+            }
+
+            void setTransposedBlock(const MatrixDynSize& block, size_t startRow, size_t startCol) {
+                toEigen(m_matrix).block(static_cast<Eigen::Index>(startRow), static_cast<Eigen::Index>(startCol), block.cols(), block.rows()) = toEigen(block).transpose();
+            }
+
+            void addTransposedBlock(const MatrixDynSize& block, size_t startRow, size_t startCol) {
+                toEigen(m_matrix).block(static_cast<Eigen::Index>(startRow), static_cast<Eigen::Index>(startCol), block.cols(), block.rows()) += toEigen(block).transpose();
+            }
+
+            void zeroDiagonal() {
+                toEigen(m_matrix).diagonal().setZero();
+            }
+
+            void addToDiagonal(double value) {
+                toEigen(m_matrix).diagonal().array() += value;
+            }
+        };
+
+        // The blocks are written always in the same order, hence the positions of their elements in the vector
+        // of nonzeros are searched only during the first evaluation after prepare, and then replayed
+        class NonZerosWritePlan {
+        public:
+            std::vector<size_t> positions;
+            bool recorded;
+
+            NonZerosWritePlan() : recorded(false) { }
+
+            void clear() {
+                positions.clear();
+                recorded = false;
+            }
+        };
+
+        // The nonzero elements are zeroed by initialize, hence the blocks are always accumulated
+        class NonZerosBlocks {
+            const NonZerosPositionMap& m_map;
+            NonZerosWritePlan& m_plan;
+            VectorDynSize& m_nonZeros;
+            size_t m_planIndex;
+
+            const size_t* nextPositions(size_t startRow, size_t startCol, size_t rows, size_t cols) {
+                size_t begin = m_planIndex;
+                m_planIndex += rows * cols;
+                if (!m_plan.recorded) {
+                    m_plan.positions.resize(m_planIndex);
+                    m_map.blockPositions(startRow, startCol, rows, cols, m_plan.positions.data() + begin);
+                }
+                assert(m_planIndex <= m_plan.positions.size());
+                return m_plan.positions.data() + begin;
+            }
+
+        public:
+            NonZerosBlocks(const NonZerosPositionMap& map, NonZerosWritePlan& plan, VectorDynSize& nonZeros)
+            : m_map(map)
+            , m_plan(plan)
+            , m_nonZeros(nonZeros)
+            , m_planIndex(0)
+            { }
+
+            void initialize(size_t /*rows*/, size_t /*cols*/) {
+                if (m_nonZeros.size() != m_map.numberOfNonZeros()) {
+                    m_nonZeros.resize(static_cast<unsigned int>(m_map.numberOfNonZeros()));
+                }
+                m_nonZeros.zero();
+            }
+
+            // To be called after a successful evaluation, so that the following ones replay the recorded positions
+            bool finalize(bool evaluationSucceeded) {
+                if (evaluationSucceeded) {
+                    m_plan.recorded = true;
+                } else if (!m_plan.recorded) {
+                    m_plan.clear();
+                }
+                return evaluationSucceeded;
+            }
+
+            void zero() {
+                m_nonZeros.zero();
+            }
+
+            void setBlock(const MatrixDynSize& block, size_t startRow, size_t startCol) {
+                addBlock(block, startRow, startCol);
+            }
+
+            void addBlock(const MatrixDynSize& block, size_t startRow, size_t startCol) {
+                const size_t* positions = nextPositions(startRow, startCol, block.rows(), block.cols());
+                const double* blockData = block.data(); //row major
+                double* nonZerosData = m_nonZeros.data();
+                for (size_t i = 0; i < block.rows() * block.cols(); ++i) {
+                    if (positions[i] != NonZerosPositionMap::NotANonZero) {
+                        nonZerosData[positions[i]] += blockData[i];
+                    }
+                }
+            }
+
+            void setTransposedBlock(const MatrixDynSize& block, size_t startRow, size_t startCol) {
+                addTransposedBlock(block, startRow, startCol);
+            }
+
+            void addTransposedBlock(const MatrixDynSize& block, size_t startRow, size_t startCol) {
+                const size_t* positions = nextPositions(startRow, startCol, block.cols(), block.rows());
+                const double* blockData = block.data();
+                double* nonZerosData = m_nonZeros.data();
+                for (size_t i = 0; i < block.cols(); ++i) {
+                    for (size_t j = 0; j < block.rows(); ++j) {
+                        size_t position = positions[i * block.rows() + j];
+                        if (position != NonZerosPositionMap::NotANonZero) {
+                            nonZerosData[position] += blockData[j * block.cols() + i];
+                        }
+                    }
+                }
+            }
+
+            void zeroDiagonal() { }
+
+            void addToDiagonal(double value) {
+                m_map.addToDiagonal(value, m_nonZeros);
+            }
+        };
+
+
+        // The collocation constraints of different mesh intervals can be evaluated concurrently. Each thread uses its own
+        // integrator and input buffers, while the outputs are stored per mesh point, and then written in the jacobian
+        // and in the hessian by the calling thread in the usual order.
+        enum class CollocationQuantity {
+            Value,
+            Jacobian,
+            Hessian
+        };
+
+        class CollocationWorkspace {
+        public:
+            std::shared_ptr<Integrator> integrator;
+            std::vector<VectorDynSize> states, controls;
+            VectorDynSize lambda;
+            bool failed;
+            double failureTime;
+
+            CollocationWorkspace() : integrator(nullptr), failed(false), failureTime(0.0) { }
+        };
+
+        class MeshCollocationOutput {
+        public:
+            VectorDynSize value;
+            std::vector<MatrixDynSize> stateJacobians, controlJacobians;
+            CollocationHessianMap stateHessians, controlHessians, mixedHessians;
+        };
 
         class MultipleShootingSolver::MultipleShootingTranscription : public optimization::OptimizationProblem {
 
@@ -151,7 +396,7 @@ namespace iDynTree {
             double m_plusInfinity, m_minusInfinity;
             VectorDynSize m_constraintsLowerBound, m_constraintsUpperBound;
             VectorDynSize m_constraintsBuffer, m_stateBuffer, m_controlBuffer, m_variablesBuffer, m_guessBuffer, m_costStateGradientBuffer, m_costControlGradientBuffer;
-            MatrixDynSize m_costHessianStateBuffer, m_costHessianControlBuffer, m_costHessianStateControlBuffer, m_costHessianControlStateBuffer;
+            MatrixDynSize m_costHessianStateBuffer, m_costHessianControlBuffer, m_costHessianStateControlBuffer;
             std::vector<VectorDynSize> m_collocationStateBuffer, m_collocationControlBuffer;
             std::vector<MatrixDynSize> m_collocationStateJacBuffer, m_collocationControlJacBuffer;
             MatrixDynSize m_constraintsStateJacBuffer, m_constraintsControlJacBuffer;
@@ -167,10 +412,17 @@ namespace iDynTree {
             SparsityStructure m_costsStateHessianSparsity, m_costsControlHessianSparsity, m_costsMixedHessianSparsity;
             CollocationHessianSparsityMap m_systemStateHessianSparsity, m_systemControlHessianSparsity, m_systemMixedHessianSparsity;
             SparsityStructure m_fullHessianSparsity;
+            NonZerosPositionMap m_jacobianNonZerosPositions, m_hessianNonZerosPositions;
+            NonZerosWritePlan m_jacobianWritePlan, m_costHessianWritePlan, m_constraintsHessianWritePlan;
 
             bool m_useCostRegularization, m_useConstraintsRegularization;
             double m_constraintsRegularization, m_costsRegularization;
 
+            std::vector<std::shared_ptr<Integrator>> m_workerIntegrators;
+            WorkerPool m_workerPool;
+            std::vector<CollocationWorkspace> m_collocationWorkspaces;
+            std::vector<MeshCollocationOutput> m_meshCollocations;
+
 
             friend class MultipleShootingSolver;
 
@@ -286,22 +538,24 @@ namespace iDynTree {
                 }
             }
 
-            void setHessianBlock(MatrixDynSize& hessian, const MatrixDynSize& block, size_t startRow, size_t startCol) {
+            template<typename Output>
+            void setHessianBlock(Output& hessian, const MatrixDynSize& block, size_t startRow, size_t startCol) {
                 if (m_hessianBlocks(startRow, startCol)) {
-                    toEigen(hessian).block(static_cast<Eigen::Index>(startRow), static_cast<unsigned int>(startCol), block.rows(), block.cols()) += toEigen(block);
+                    hessian.addBlock(block, startRow, startCol);
                 } else {
-                    toEigen(hessian).block(static_cast<Eigen::Index>(startRow), static_cast<unsigned int>(startCol), block.rows(), block.cols()) = toEigen(block);
+                    hessian.setBlock(block, startRow, startCol);
                     m_hessianBlocks(startRow, startCol) = true;
                 }
             }
 
-            void setHessianBlockAndItsTranspose(MatrixDynSize& hessian, const MatrixDynSize& block, size_t startRow, size_t startCol) {
+            template<typename Output>
+            void setHessianBlockAndItsTranspose(Output& hessian, const MatrixDynSize& block, size_t startRow, size_t startCol) {
                 setHessianBlock(hessian, block, startRow, startCol);
 
                 if (m_hessianBlocks(startCol, startRow)) {
-                    toEigen(hessian).block(static_cast<Eigen::Index>(startCol), static_cast<unsigned int>(startRow), block.cols(), block.rows()) += toEigen(block).transpose();
+                    hessian.addTransposedBlock(block, startCol, startRow);
                 } else {
-                    toEigen(hessian).block(static_cast<Eigen::Index>(startCol), static_cast<unsigned int>(startRow), block.cols(), block.rows()) = toEigen(block).transpose();
+                    hessian.setTransposedBlock(block, startCol, startRow);
                     m_hessianBlocks(startCol, startRow) = true;
                 }
             }
@@ -349,10 +603,6 @@ namespace iDynTree {
                     m_costHessianStateControlBuffer.resize(static_cast<unsigned int>(m_nx), static_cast<unsigned int>(m_nu));
                 }
 
-                if ((m_costHessianControlStateBuffer.rows() != m_nu) || (m_costHessianControlStateBuffer.cols() != m_nx)) {
-                    m_costHessianControlStateBuffer.resize(static_cast<unsigned int>(m_nu), static_cast<unsigned int>(m_nx));
-                }
-
 
                 //TODO: I should consider also the possibility to have auxiliary variables in the integrator
                 if (m_variablesBuffer.size() != m_numberOfVariables) {
@@ -434,6 +684,102 @@ namespace iDynTree {
                 m_stateControCollocationlHessians[CollocationHessianIndex(1,0)] = MatrixDynSize(static_cast<unsigned int>(m_nx), static_cast<unsigned int>(m_nu));
                 m_stateControCollocationlHessians[CollocationHessianIndex(1,1)] = MatrixDynSize(static_cast<unsigned int>(m_nx), static_cast<unsigned int>(m_nu));
 
+                if (m_workerIntegrators.empty()) {
+                    m_collocationWorkspaces.clear();
+                    m_meshCollocations.clear();
+                } else {
+                    m_collocationWorkspaces.resize(m_workerIntegrators.size() + 1);
+                    for (size_t i = 0; i < m_collocationWorkspaces.size(); ++i) {
+                        CollocationWorkspace& workspace = m_collocationWorkspaces[i];
+                        workspace.integrator = (i == 0) ? m_integrator : m_workerIntegrators[i - 1];
+                        workspace.states = m_collocationStateBuffer;
+                        workspace.controls = m_collocationControlBuffer;
+                        workspace.lambda = m_lambdaCollocation;
+                    }
+
+                    m_meshCollocations.resize(m_totalMeshes);
+                    for (MeshCollocationOutput& output : m_meshCollocations) {
+                        output.value.resize(static_cast<unsigned int>(m_nx));
+                        output.stateJacobians = m_collocationStateJacBuffer;
+                        output.controlJacobians = m_collocationControlJacBuffer;
+                        output.stateHessians = m_stateCollocationHessians;
+                        output.controlHessians = m_controlCollocationHessians;
+                        output.mixedHessians = m_stateControCollocationlHessians;
+                    }
+                }
+            }
+
+            bool evaluateCollocationsConcurrently(CollocationQuantity quantity, const VectorDynSize* constraintsMultipliers = nullptr) {
+                assert(m_meshPoints.begin()->origin == MeshPointOrigin::FirstPoint());
+
+                size_t numberOfMeshes = static_cast<size_t>(m_meshPointsEnd - m_meshPoints.begin());
+                size_t numberOfWorkspaces = m_collocationWorkspaces.size();
+                assert(m_meshCollocations.size() >= numberOfMeshes);
+
+                Eigen::Index nx = static_cast<Eigen::Index>(m_nx);
+                Eigen::Index nu = static_cast<Eigen::Index>(m_nu);
+                Eigen::Index nc = static_cast<Eigen::Index>(m_constraintsPerInstant);
+
+                auto evaluateMeshes = [&](size_t workspaceIndex) {
+                    CollocationWorkspace& workspace = m_collocationWorkspaces[workspaceIndex];
+                    Eigen::Map<Eigen::VectorXd> variablesBuffer = toEigen(m_variablesBuffer);
+                    workspace.failed = false;
+
+                    // Each workspace takes a contiguous set of meshes, skipping the first one that has no collocation constraint
+                    size_t begin = std::max<size_t>(1, workspaceIndex * numberOfMeshes / numberOfWorkspaces);
+                    size_t end = (workspaceIndex + 1) * numberOfMeshes / numberOfWorkspaces;
+
+                    for (size_t meshIndex = begin; meshIndex < end; ++meshIndex) {
+                        std::vector<MeshPoint>::const_iterator mesh = m_meshPoints.begin() + static_cast<long>(meshIndex);
+                        MeshCollocationOutput& output = m_meshCollocations[meshIndex];
+
+                        toEigen(workspace.states[0]) = variablesBuffer.segment(static_cast<Eigen::Index>((mesh - 1)->stateIndex), nx);
+                        toEigen(workspace.states[1]) = variablesBuffer.segment(static_cast<Eigen::Index>(mesh->stateIndex), nx);
+                        toEigen(workspace.controls[0]) = variablesBuffer.segment(static_cast<Eigen::Index>(mesh->previousControlIndex), nu);
+                        toEigen(workspace.controls[1]) = variablesBuffer.segment(static_cast<Eigen::Index>(mesh->controlIndex), nu);
+                        double dT = mesh->time - (mesh - 1)->time;
+
+                        bool ok = true;
+                        if (quantity == CollocationQuantity::Value) {
+                            ok = workspace.integrator->evaluateCollocationConstraint(mesh->time, workspace.states, workspace.controls, dT, output.value);
+                        } else if (quantity == CollocationQuantity::Jacobian) {
+                            ok = workspace.integrator->evaluateCollocationConstraintJacobian(mesh->time, workspace.states, workspace.controls, dT,
+                                                                                             output.stateJacobians, output.controlJacobians);
+                        } else {
+                            assert(constraintsMultipliers);
+                            // The collocation constraints of a mesh come after the ones of the previous meshes and after the constraints of the previous instants
+                            Eigen::Index constraintIndex = static_cast<Eigen::Index>(meshIndex) * nc + static_cast<Eigen::Index>(meshIndex - 1) * nx;
+                            toEigen(workspace.lambda) = toEigen(*constraintsMultipliers).segment(constraintIndex, nx);
+                            ok = workspace.integrator->evaluateCollocationConstraintSecondDerivatives(mesh->time, workspace.states, workspace.controls, dT, workspace.lambda,
+                                                                                                      output.stateHessians, output.controlHessians, output.mixedHessians);
+                        }
+
+                        if (!ok) {
+                            workspace.failed = true;
+                            workspace.failureTime = mesh->time;
+                            return;
+                        }
+                    }
+                };
+
+                m_workerPool.run(numberOfWorkspaces, evaluateMeshes);
+
+                for (const CollocationWorkspace& workspace : m_collocationWorkspaces) {
+                    if (workspace.failed) {
+                        std::ostringstream errorMsg;
+                        errorMsg << "Error while evaluating the collocation constraint";
+                        if (quantity == CollocationQuantity::Jacobian) {
+                            errorMsg << " jacobian";
+                        } else if (quantity == CollocationQuantity::Hessian) {
+                            errorMsg << " hessian";
+                        }
+                        errorMsg << " at time " << workspace.failureTime << ".";
+                        reportError("MultipleShootingTranscription", "evaluateCollocationsConcurrently", errorMsg.str().c_str());
+                        return false;
+                    }
+                }
+
+                return true;
             }
 
 
@@ -540,6 +886,35 @@ namespace iDynTree {
                     return false;
                 }
 
+                std::shared_ptr<DynamicalSystem> system = m_integrator->dynamicalSystem().lock();
+                for (auto& workerIntegrator : m_workerIntegrators) {
+                    if (workerIntegrator->info().name() != m_integrator->info().name()) {
+                        reportError("MultipleShootingTranscription", "prepare", "The worker integrators have to be of the same kind of the integrator set with setIntegrator.");
+                        return false;
+                    }
+
+                    std::shared_ptr<DynamicalSystem> workerSystem = workerIntegrator->dynamicalSystem().lock();
+                    if (!workerSystem) {
+                        reportError("MultipleShootingTranscription", "prepare", "A worker integrator has no dynamical system set.");
+                        return false;
+                    }
+
+                    if (workerSystem == system) {
+                        reportError("MultipleShootingTranscription", "prepare", "The worker integrators cannot share the dynamical system of the integrator set with setIntegrator.");
+                        return false;
+                    }
+
+                    if ((workerSystem->stateSpaceSize() != system->stateSpaceSize()) || (workerSystem->controlSpaceSize() != system->controlSpaceSize())) {
+                        reportError("MultipleShootingTranscription", "prepare", "The dynamical systems of the worker integrators have different dimensions from the one of the optimal control problem.");
+                        return false;
+                    }
+
+                    if (!(workerIntegrator->setMaximumStepSize(m_maxStepSize))){
+                        reportError("MultipleShootingTranscription", "prepare","Error while setting the maximum step size to a worker integrator.");
+                        return false;
+                    }
+                }
+
                 return true;
             }
 
@@ -835,6 +1210,37 @@ namespace iDynTree {
                 return true;
             }
 
+            bool setWorkerIntegrators(const std::vector<std::shared_ptr<Integrator>>& workerIntegrators) {
+                for (size_t i = 0; i < workerIntegrators.size(); ++i) {
+                    if (!workerIntegrators[i]) {
+                        reportError("MultipleShootingSolver", "setWorkerIntegrators", "Empty integrator pointer.");
+                        return false;
+                    }
+
+                    if (workerIntegrators[i]->dynamicalSystem().expired()) {
+                        reportError("MultipleShootingSolver", "setWorkerIntegrators", "The worker integrators need to have their own dynamical system already set.");
+                        return false;
+                    }
+
+                    for (size_t j = 0; j < i; ++j) {
+                        if ((workerIntegrators[j] == workerIntegrators[i]) ||
+                            (workerIntegrators[j]->dynamicalSystem().lock() == workerIntegrators[i]->dynamicalSystem().lock())) {
+                            reportError("MultipleShootingSolver", "setWorkerIntegrators", "Each worker integrator needs its own instance of the integrator and of the dynamical system.");
+                            return false;
+                        }
+                    }
+                }
+
+                if (!m_workerPool.resize(workerIntegrators.size())) {
+                    reportError("MultipleShootingSolver", "setWorkerIntegrators", "Error while creating the worker threads.");
+                    m_workerIntegrators.clear();
+                    return false;
+                }
+
+                m_workerIntegrators = workerIntegrators;
+                return true;
+            }
+
             bool setStepSizeBounds(const double minStepSize, const double maxStepsize) {
                 if (minStepSize <= 0){
                     reportError("MultipleShootingSolver", "setStepSizeBounds","The minimum step size is expected to be positive.");
@@ -1436,6 +1842,13 @@ namespace iDynTree {
                     m_fullHessianSparsity.addIdentityBlock(0, 0, m_numberOfVariables);
                 }
 
+                m_jacobianNonZerosPositions.build(m_numberOfConstraints, m_jacobianNZRows, m_jacobianNZCols, m_jacobianNonZeros);
+                m_hessianNonZerosPositions.build(m_numberOfVariables, m_fullHessianSparsity.nonZeroElementRows(),
+                                                 m_fullHessianSparsity.nonZeroElementColumns(), m_fullHessianSparsity.size());
+                m_jacobianWritePlan.clear();
+                m_costHessianWritePlan.clear();
+                m_constraintsHessianWritePlan.clear();
+
                 m_prepared = true;
                 return true;
             }
@@ -1447,6 +1860,9 @@ namespace iDynTree {
                 m_numberOfVariables = 0;
                 resetNonZerosCount();
                 resetMeshPoints();
+                m_jacobianWritePlan.clear();
+                m_costHessianWritePlan.clear();
+                m_constraintsHessianWritePlan.clear();
             }
 
             virtual unsigned int numberOfVariables() override {
@@ -1801,7 +2217,8 @@ namespace iDynTree {
                 return true;
             }
 
-            virtual bool evaluateCostHessian(MatrixDynSize& hessian) override {
+            template<typename Output>
+            bool evaluateCostHessianBlocks(Output& hessian) {
 
                 if (!(m_prepared)){
                     reportError("MultipleShootingTranscription", "evaluateCostHessian", "First you need to call the prepare method");
@@ -1811,25 +2228,15 @@ namespace iDynTree {
                 Eigen::Map<Eigen::VectorXd> stateBufferMap = toEigen(m_stateBuffer);
                 Eigen::Map<Eigen::VectorXd> controlBufferMap = toEigen(m_controlBuffer);
                 Eigen::Map<Eigen::VectorXd> variablesBuffer = toEigen(m_variablesBuffer);
-                iDynTreeEigenMatrixMap costStateHessian = toEigen(m_costHessianStateBuffer);
-                iDynTreeEigenMatrixMap costControlHessian = toEigen(m_costHessianControlBuffer);
-                iDynTreeEigenMatrixMap costStateControlHessian = toEigen(m_costHessianStateControlBuffer);
-                iDynTreeEigenMatrixMap costControlStateHessian = toEigen(m_costHessianControlStateBuffer);
 
 
                 Eigen::Index nx = static_cast<Eigen::Index>(m_nx);
                 Eigen::Index nu = static_cast<Eigen::Index>(m_nu);
 
-                if ((hessian.rows() != numberOfVariables()) || (hessian.cols() != numberOfVariables())) {
-                    hessian.resize(static_cast<unsigned int>(numberOfVariables()), static_cast<unsigned int>(numberOfVariables()));
-                }
-
-                iDynTreeEigenMatrixMap hessianMap = toEigen(hessian);
+                hessian.initialize(m_numberOfVariables, m_numberOfVariables);
 
                 if (m_useCostRegularization) {
-                    for (unsigned int i = 0; i < hessian.rows(); ++i) {
-                        hessian(i, i) = 0.0;
-                    }
+                    hessian.zeroDiagonal();
                 }
 
                 for (auto mesh = m_meshPoints.begin(); mesh != m_meshPointsEnd; ++mesh){
@@ -1844,7 +2251,7 @@ namespace iDynTree {
                         return false;
                     }
 
-                    hessianMap.block(static_cast<Eigen::Index>(mesh->stateIndex), static_cast<Eigen::Index>(mesh->stateIndex), nx, nx) = costStateHessian;
+                    hessian.setBlock(m_costHessianStateBuffer, mesh->stateIndex, mesh->stateIndex);
 
                     if (!(m_ocproblem->costsSecondPartialDerivativeWRTStateControl(mesh->time, m_stateBuffer, m_controlBuffer, m_costHessianStateControlBuffer))){
                         std::ostringstream errorMsg;
@@ -1853,9 +2260,8 @@ namespace iDynTree {
                         return false;
                     }
 
-                    hessianMap.block(static_cast<Eigen::Index>(mesh->stateIndex), static_cast<Eigen::Index>(mesh->controlIndex), nx, nu) = costStateControlHessian;
-                    costControlStateHessian = costStateControlHessian.transpose();
-                    hessianMap.block(static_cast<Eigen::Index>(mesh->controlIndex), static_cast<Eigen::Index>(mesh->stateIndex), nu, nx) = costControlStateHessian;
+                    hessian.setBlock(m_costHessianStateControlBuffer, mesh->stateIndex, mesh->controlIndex);
+                    hessian.setTransposedBlock(m_costHessianStateControlBuffer, mesh->controlIndex, mesh->stateIndex);
 
                     if (!(m_ocproblem->costsSecondPartialDerivativeWRTControl(mesh->time, m_stateBuffer, m_controlBuffer, m_costHessianControlBuffer))){
                         std::ostringstream errorMsg;
@@ -1865,16 +2271,14 @@ namespace iDynTree {
                     }
 
                     if (mesh->type == MeshPointType::Control){
-                        hessianMap.block(static_cast<Eigen::Index>(mesh->controlIndex), static_cast<Eigen::Index>(mesh->controlIndex), nu, nu) = costControlHessian;
+                        hessian.setBlock(m_costHessianControlBuffer, mesh->controlIndex, mesh->controlIndex);
                     } else if (mesh->type == MeshPointType::State) {
-                        hessianMap.block(static_cast<Eigen::Index>(mesh->controlIndex), static_cast<Eigen::Index>(mesh->controlIndex), nu, nu) += costControlHessian;
+                        hessian.addBlock(m_costHessianControlBuffer, mesh->controlIndex, mesh->controlIndex);
                     }
                 }
 
                 if (m_useCostRegularization) {
-                    for (unsigned int i = 0; i < hessian.rows(); ++i) {
-                        hessian(i, i) += m_costsRegularization;
-                    }
+                    hessian.addToDiagonal(m_costsRegularization);
                 }
 
                 return true;
@@ -1905,6 +2309,10 @@ namespace iDynTree {
 
                 Eigen::Map<Eigen::VectorXd> constraintsMap = toEigen(constraints);
 
+                bool concurrentCollocations = !m_collocationWorkspaces.empty();
+                if (concurrentCollocations && !evaluateCollocationsConcurrently(CollocationQuantity::Value)) {
+                    return false;
+                }
 
                 MeshPointOrigin first = MeshPointOrigin::FirstPoint();
                 Eigen::Index constraintIndex = 0;
@@ -1916,7 +2324,10 @@ namespace iDynTree {
                     currentControl  = variablesBuffer.segment(static_cast<Eigen::Index>(mesh->controlIndex), nu);
                     previousControl = variablesBuffer.segment(static_cast<Eigen::Index>(mesh->previousControlIndex), nu);
 
-                    if (mesh->origin != first) {
+                    if ((mesh->origin != first) && concurrentCollocations) {
+                        constraintsMap.segment(constraintIndex, nx) = toEigen(m_meshCollocations[static_cast<size_t>(mesh - m_meshPoints.begin())].value);
+                        constraintIndex += nx;
+                    } else if (mesh->origin != first) {
                         previousState = variablesBuffer.segment(static_cast<Eigen::Index>((mesh - 1)->stateIndex), nx);
                         dT = mesh->time - (mesh - 1)->time;
                         if (!(m_integrator->evaluateCollocationConstraint(mesh->time, m_collocationStateBuffer, m_collocationControlBuffer, dT, m_stateBuffer))){
@@ -1949,7 +2360,8 @@ namespace iDynTree {
                 return true;
             }
 
-            virtual bool evaluateConstraintsJacobian(MatrixDynSize& jacobian) override {
+            template<typename Output>
+            bool evaluateConstraintsJacobianBlocks(Output& jacobian) {
 
                 if (!(m_prepared)){
                     reportError("MultipleShootingTranscription", "evaluateConstraints", "First you need to call the prepare method");
@@ -1967,11 +2379,12 @@ namespace iDynTree {
                 Eigen::Index nu = static_cast<Eigen::Index>(m_nu);
                 Eigen::Index nc = static_cast<Eigen::Index>(m_constraintsPerInstant);
 
-                if (jacobian.rows() != numberOfConstraints() || jacobian.cols() != numberOfVariables()) {
-                    jacobian.resize(numberOfConstraints(), numberOfVariables());
-                }
+                jacobian.initialize(m_numberOfConstraints, m_numberOfVariables);
 
-                iDynTreeEigenMatrixMap jacobianMap = toEigen(jacobian);
+                bool concurrentCollocations = !m_collocationWorkspaces.empty();
+                if (concurrentCollocations && !evaluateCollocationsConcurrently(CollocationQuantity::Jacobian)) {
+                    return false;
+                }
 
                 MeshPointOrigin first = MeshPointOrigin::FirstPoint();
                 Eigen::Index constraintIndex = 0;
@@ -1983,26 +2396,36 @@ namespace iDynTree {
                     previousControl = variablesBuffer.segment(static_cast<Eigen::Index>(mesh->previousControlIndex), nu);
 
                     if (mesh->origin != first) {
-                        previousState = variablesBuffer.segment(static_cast<Eigen::Index>((mesh - 1)->stateIndex), nx);
-                        dT = mesh->time - (mesh - 1)->time;
-                        if (!(m_integrator->evaluateCollocationConstraintJacobian(mesh->time, m_collocationStateBuffer, m_collocationControlBuffer, dT, m_collocationStateJacBuffer, m_collocationControlJacBuffer))){
-                            std::ostringstream errorMsg;
-                            errorMsg << "Error while evaluating the collocation constraint jacobian at time " << mesh->time << ".";
-                            reportError("MultipleShootingTranscription", "evaluateConstraintsJacobian", errorMsg.str().c_str());
-                            return false;
+                        const std::vector<MatrixDynSize>* stateJacobians = &m_collocationStateJacBuffer;
+                        const std::vector<MatrixDynSize>* controlJacobians = &m_collocationControlJacBuffer;
+
+                        if (concurrentCollocations) {
+                            const MeshCollocationOutput& collocation = m_meshCollocations[static_cast<size_t>(mesh - m_meshPoints.begin())];
+                            stateJacobians = &collocation.stateJacobians;
+                            controlJacobians = &collocation.controlJacobians;
+                        } else {
+                            previousState = variablesBuffer.segment(static_cast<Eigen::Index>((mesh - 1)->stateIndex), nx);
+                            dT = mesh->time - (mesh - 1)->time;
+                            if (!(m_integrator->evaluateCollocationConstraintJacobian(mesh->time, m_collocationStateBuffer, m_collocationControlBuffer, dT, m_collocationStateJacBuffer, m_collocationControlJacBuffer))){
+                                std::ostringstream errorMsg;
+                                errorMsg << "Error while evaluating the collocation constraint jacobian at time " << mesh->time << ".";
+                                reportError("MultipleShootingTranscription", "evaluateConstraintsJacobian", errorMsg.str().c_str());
+                                return false;
+                            }
                         }
 
+                        size_t row = static_cast<size_t>(constraintIndex);
 
-                        jacobianMap.block(constraintIndex, static_cast<Eigen::Index>((mesh-1)->stateIndex), nx, nx) = toEigen(m_collocationStateJacBuffer[0]);
+                        jacobian.setBlock((*stateJacobians)[0], row, (mesh-1)->stateIndex);
 
-                        jacobianMap.block(constraintIndex, static_cast<Eigen::Index>(mesh->stateIndex), nx, nx) = toEigen(m_collocationStateJacBuffer[1]);
+                        jacobian.setBlock((*stateJacobians)[1], row, mesh->stateIndex);
 
-                        jacobianMap.block(constraintIndex, static_cast<Eigen::Index>(mesh->controlIndex), nx, nu) = toEigen(m_collocationControlJacBuffer[1]);
+                        jacobian.setBlock((*controlJacobians)[1], row, mesh->controlIndex);
 
                         if (mesh->type == MeshPointType::Control) {
-                            jacobianMap.block(constraintIndex, static_cast<Eigen::Index>(mesh->previousControlIndex), nx, nu) = toEigen(m_collocationControlJacBuffer[0]);
+                            jacobian.setBlock((*controlJacobians)[0], row, mesh->previousControlIndex);
                         } else if (mesh->type == MeshPointType::State) {
-                            jacobianMap.block(constraintIndex, static_cast<Eigen::Index>(mesh->previousControlIndex), nx, nu) += toEigen(m_collocationControlJacBuffer[0]); //the previous and the current control coincides
+                            jacobian.addBlock((*controlJacobians)[0], row, mesh->previousControlIndex); //the previous and the current control coincides
                         }
                         constraintIndex += nx;
                     }
@@ -2017,7 +2440,7 @@ namespace iDynTree {
                             return false;
                         }
 
-                        jacobianMap.block(constraintIndex, static_cast<Eigen::Index>(mesh->controlIndex), nc, nu) = toEigen(m_constraintsControlJacBuffer);
+                        jacobian.setBlock(m_constraintsControlJacBuffer, static_cast<size_t>(constraintIndex), mesh->controlIndex);
 
                     } else {
 
@@ -2028,7 +2451,7 @@ namespace iDynTree {
                             return false;
                         }
 
-                        jacobianMap.block(constraintIndex, static_cast<Eigen::Index>(mesh->stateIndex), nc, nx) = toEigen(m_constraintsStateJacBuffer);
+                        jacobian.setBlock(m_constraintsStateJacBuffer, static_cast<size_t>(constraintIndex), mesh->stateIndex);
 
                         if (!(m_ocproblem->constraintsJacobianWRTControl(mesh->time, m_collocationStateBuffer[1], m_collocationControlBuffer[1], m_constraintsControlJacBuffer))){
                             std::ostringstream errorMsg;
@@ -2037,7 +2460,7 @@ namespace iDynTree {
                             return false;
                         }
 
-                        jacobianMap.block(constraintIndex, static_cast<Eigen::Index>(mesh->controlIndex), nc, nu) = toEigen(m_constraintsControlJacBuffer);
+                        jacobian.setBlock(m_constraintsControlJacBuffer, static_cast<size_t>(constraintIndex), mesh->controlIndex);
                     }
                     constraintIndex += nc;
                 }
@@ -2045,15 +2468,17 @@ namespace iDynTree {
                 return true;
             }
 
-            virtual bool evaluateConstraintsHessian(const VectorDynSize& constraintsMultipliers, MatrixDynSize& hessian) override {
+            template<typename Output>
+            bool evaluateConstraintsHessianBlocks(const VectorDynSize& constraintsMultipliers, Output& hessian) {
 
                 if (!(m_prepared)){
                     reportError("MultipleShootingTranscription", "evaluateConstraints", "First you need to call the prepare method");
                     return false;
                 }
 
+                hessian.initialize(m_numberOfVariables, m_numberOfVariables);
+
                 if (!m_info.hasNonLinearConstraints()) {
-                    hessian.resize(static_cast<unsigned int>(m_numberOfVariables), static_cast<unsigned int>(m_numberOfVariables));
                     hessian.zero();
                     return true;
                 }
@@ -2072,18 +2497,17 @@ namespace iDynTree {
                 Eigen::Index nu = static_cast<Eigen::Index>(m_nu);
                 Eigen::Index nc = static_cast<Eigen::Index>(m_constraintsPerInstant);
 
-                if ((hessian.rows() != numberOfVariables()) || (hessian.cols() != numberOfVariables())) {
-                    hessian.resize(static_cast<unsigned int>(numberOfVariables()), static_cast<unsigned int>(numberOfVariables()));
-                }
-
                 if (m_useConstraintsRegularization) {
-                    for (unsigned int i = 0; i < hessian.rows(); ++i) {
-                        hessian(i, i) = 0.0;
-                    }
+                    hessian.zeroDiagonal();
                 }
 
                 m_hessianBlocks.reset();
 
+                bool concurrentCollocations = !m_collocationWorkspaces.empty();
+                if (concurrentCollocations && !evaluateCollocationsConcurrently(CollocationQuantity::Hessian, &constraintsMultipliers)) {
+                    return false;
+                }
+
                 MeshPointOrigin first = MeshPointOrigin::FirstPoint();
                 Eigen::Index constraintIndex = 0;
                 double dT = 0;
@@ -2094,31 +2518,42 @@ namespace iDynTree {
                     previousControl = variablesBuffer.segment(static_cast<Eigen::Index>(mesh->previousControlIndex), nu);
 
                     if (mesh->origin != first) {
-                        previousState = variablesBuffer.segment(static_cast<Eigen::Index>((mesh - 1)->stateIndex), nx);
-                        lambdaCollocation = fullLambda.segment(constraintIndex, nx);
-                        dT = mesh->time - (mesh - 1)->time;
+                        CollocationHessianMap* stateHessians = &m_stateCollocationHessians;
+                        CollocationHessianMap* controlHessians = &m_controlCollocationHessians;
+                        CollocationHessianMap* mixedHessians = &m_stateControCollocationlHessians;
+
+                        if (concurrentCollocations) {
+                            MeshCollocationOutput& collocation = m_meshCollocations[static_cast<size_t>(mesh - m_meshPoints.begin())];
+                            stateHessians = &collocation.stateHessians;
+                            controlHessians = &collocation.controlHessians;
+                            mixedHessians = &collocation.mixedHessians;
+                        } else {
+                            previousState = variablesBuffer.segment(static_cast<Eigen::Index>((mesh - 1)->stateIndex), nx);
+                            lambdaCollocation = fullLambda.segment(constraintIndex, nx);
+                            dT = mesh->time - (mesh - 1)->time;
 
-                        if (!(m_integrator->evaluateCollocationConstraintSecondDerivatives(mesh->time, m_collocationStateBuffer, m_collocationControlBuffer, dT,
-                                                                                           m_lambdaCollocation, m_stateCollocationHessians,
-                                                                                           m_controlCollocationHessians, m_stateControCollocationlHessians))){
-                            std::ostringstream errorMsg;
-                            errorMsg << "Error while evaluating the collocation constraint hessian at time " << mesh->time << ".";
-                            reportError("MultipleShootingTranscription", "evaluateConstraintsHessian", errorMsg.str().c_str());
-                            return false;
+                            if (!(m_integrator->evaluateCollocationConstraintSecondDerivatives(mesh->time, m_collocationStateBuffer, m_collocationControlBuffer, dT,
+                                                                                               m_lambdaCollocation, m_stateCollocationHessians,
+                                                                                               m_controlCollocationHessians, m_stateControCollocationlHessians))){
+                                std::ostringstream errorMsg;
+                                errorMsg << "Error while evaluating the collocation constraint hessian at time " << mesh->time << ".";
+                                reportError("MultipleShootingTranscription", "evaluateConstraintsHessian", errorMsg.str().c_str());
+                                return false;
+                            }
                         }
 
-                        setHessianBlock(hessian, m_stateCollocationHessians[CollocationHessianIndex(0, 0)], (mesh-1)->stateIndex, (mesh-1)->stateIndex);
-                        setHessianBlockAndItsTranspose(hessian, m_stateCollocationHessians[CollocationHessianIndex(0, 1)], (mesh-1)->stateIndex, mesh->stateIndex);
-                        setHessianBlock(hessian, m_stateCollocationHessians[CollocationHessianIndex(1, 1)], mesh->stateIndex, mesh->stateIndex);
+                        setHessianBlock(hessian, (*stateHessians)[CollocationHessianIndex(0, 0)], (mesh-1)->stateIndex, (mesh-1)->stateIndex);
+                        setHessianBlockAndItsTranspose(hessian, (*stateHessians)[CollocationHessianIndex(0, 1)], (mesh-1)->stateIndex, mesh->stateIndex);
+                        setHessianBlock(hessian, (*stateHessians)[CollocationHessianIndex(1, 1)], mesh->stateIndex, mesh->stateIndex);
 
-                        setHessianBlock(hessian, m_controlCollocationHessians[CollocationHessianIndex(0,0)], mesh->previousControlIndex, mesh->previousControlIndex);
-                        setHessianBlockAndItsTranspose(hessian, m_controlCollocationHessians[CollocationHessianIndex(0,1)], mesh->previousControlIndex, mesh->controlIndex);
-                        setHessianBlock(hessian, m_controlCollocationHessians[CollocationHessianIndex(1,1)], mesh->controlIndex, mesh->controlIndex);
+                        setHessianBlock(hessian, (*controlHessians)[CollocationHessianIndex(0,0)], mesh->previousControlIndex, mesh->previousControlIndex);
+                        setHessianBlockAndItsTranspose(hessian, (*controlHessians)[CollocationHessianIndex(0,1)], mesh->previousControlIndex, mesh->controlIndex);
+                        setHessianBlock(hessian, (*controlHessians)[CollocationHessianIndex(1,1)], mesh->controlIndex, mesh->controlIndex);
 
-                        setHessianBlockAndItsTranspose(hessian, m_stateControCollocationlHessians[CollocationHessianIndex(0,0)], (mesh-1)->stateIndex, mesh->previousControlIndex);
-                        setHessianBlockAndItsTranspose(hessian, m_stateControCollocationlHessians[CollocationHessianIndex(0,1)], (mesh-1)->stateIndex, mesh->controlIndex);
-                        setHessianBlockAndItsTranspose(hessian, m_stateControCollocationlHessians[CollocationHessianIndex(1,0)], mesh->stateIndex, mesh->previousControlIndex);
-                        setHessianBlockAndItsTranspose(hessian, m_stateControCollocationlHessians[CollocationHessianIndex(1,1)], mesh->stateIndex, mesh->controlIndex);
+                        setHessianBlockAndItsTranspose(hessian, (*mixedHessians)[CollocationHessianIndex(0,0)], (mesh-1)->stateIndex, mesh->previousControlIndex);
+                        setHessianBlockAndItsTranspose(hessian, (*mixedHessians)[CollocationHessianIndex(0,1)], (mesh-1)->stateIndex, mesh->controlIndex);
+                        setHessianBlockAndItsTranspose(hessian, (*mixedHessians)[CollocationHessianIndex(1,0)], mesh->stateIndex, mesh->previousControlIndex);
+                        setHessianBlockAndItsTranspose(hessian, (*mixedHessians)[CollocationHessianIndex(1,1)], mesh->stateIndex, mesh->controlIndex);
 
                         constraintIndex += nx;
                     }
@@ -2177,13 +2612,41 @@ namespace iDynTree {
                 assert(static_cast<size_t>(constraintIndex) == m_numberOfConstraints);
 
                 if (m_useConstraintsRegularization) {
-                    for (unsigned int i = 0; i < hessian.rows(); ++i) {
-                        hessian(i, i) += m_constraintsRegularization;
-                    }
+                    hessian.addToDiagonal(m_constraintsRegularization);
                 }
 
                 return true;
             }
+
+            virtual bool evaluateCostHessian(MatrixDynSize& hessian) override {
+                DenseMatrixBlocks output(hessian);
+                return evaluateCostHessianBlocks(output);
+            }
+
+            virtual bool evaluateConstraintsJacobian(MatrixDynSize& jacobian) override {
+                DenseMatrixBlocks output(jacobian);
+                return evaluateConstraintsJacobianBlocks(output);
+            }
+
+            virtual bool evaluateConstraintsHessian(const VectorDynSize& constraintsMultipliers, MatrixDynSize& hessian) override {
+                DenseMatrixBlocks output(hessian);
+                return evaluateConstraintsHessianBlocks(constraintsMultipliers, output);
+            }
+
+            virtual bool evaluateConstraintsJacobianNonZeros(VectorDynSize& nonZeroElements) override {
+                NonZerosBlocks output(m_jacobianNonZerosPositions, m_jacobianWritePlan, nonZeroElements);
+                return output.finalize(evaluateConstraintsJacobianBlocks(output));
+            }
+
+            virtual bool evaluateCostHessianNonZeros(VectorDynSize& nonZeroElements) override {
+                NonZerosBlocks output(m_hessianNonZerosPositions, m_costHessianWritePlan, nonZeroElements);
+                return output.finalize(evaluateCostHessianBlocks(output));
+            }
+
+            virtual bool evaluateConstraintsHessianNonZeros(const VectorDynSize& constraintsMultipliers, VectorDynSize& nonZeroElements) override {
+                NonZerosBlocks output(m_hessianNonZerosPositions, m_constraintsHessianWritePlan, nonZeroElements);
+                return output.finalize(evaluateConstraintsHessianBlocks(constraintsMultipliers, output));
+            }
         };
         MultipleShootingSolver::MultipleShootingTranscription::~MultipleShootingTranscription() {}
 
@@ -2207,6 +2670,11 @@ namespace iDynTree {
             return m_transcription->setIntegrator(integrationMethod);
         }
 
+        bool MultipleShootingSolver::setWorkerIntegrators(const std::vector<std::shared_ptr<Integrator>>& workerIntegrators)
+        {
+            return m_transcription->setWorkerIntegrators(workerIntegrators);
+        }
+
         bool MultipleShootingSolver::setControlPeriod(double period)
         {
             return m_transcription->setControlPeriod(period);
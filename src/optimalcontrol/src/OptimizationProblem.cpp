@@ -9,15 +9,38 @@
  */
 
 #include <iDynTree/OptimizationProblem.h>
+#include <iDynTree/VectorDynSize.h>
+#include <iDynTree/MatrixDynSize.h>
 #include <iDynTree/Utils.h>
 
+#include <vector>
+
 namespace iDynTree {
 
     namespace optimization {
 
+        // Buffers used by the default implementations of the *NonZeros methods
+        class OptimizationProblem::NonZerosEvaluationBuffers {
+        public:
+            std::vector<size_t> jacobianRows, jacobianCols, hessianRows, hessianCols;
+            MatrixDynSize denseJacobian, denseHessian;
+
+            static void extractNonZeros(const MatrixDynSize& denseMatrix, const std::vector<size_t>& rows,
+                                        const std::vector<size_t>& cols, VectorDynSize& nonZeroElements) {
+                if (nonZeroElements.size() != rows.size()) {
+                    nonZeroElements.resize(static_cast<unsigned int>(rows.size()));
+                }
+
+                for (size_t i = 0; i < rows.size(); ++i) {
+                    nonZeroElements(static_cast<unsigned int>(i)) = denseMatrix(static_cast<unsigned int>(rows[i]), static_cast<unsigned int>(cols[i]));
+                }
+            }
+        };
+
         OptimizationProblem::OptimizationProblem()
         :m_infoData(new OptimizationProblemInfoData)
         ,m_info(m_infoData)
+        ,m_nonZerosBuffers(new NonZerosEvaluationBuffers)
         {
         }
 
@@ -71,6 +94,11 @@ namespace iDynTree {
             return false;
         }
 
+        bool OptimizationProblem::getDualGuess(VectorDynSize &/*constraintsMultipliers*/, VectorDynSize &/*lowerBoundsMultipliers*/, VectorDynSize &/*upperBoundsMultipliers*/)
+        {
+            return false;
+        }
+
         bool OptimizationProblem::setVariables(const VectorDynSize &variables)
         {
             reportError("OptimizationProblem", "setVariables", "Method not implemented.");
@@ -113,6 +141,57 @@ namespace iDynTree {
             return false;
         }
 
+        bool OptimizationProblem::evaluateConstraintsJacobianNonZeros(VectorDynSize &nonZeroElements)
+        {
+            if (!getConstraintsJacobianInfo(m_nonZerosBuffers->jacobianRows, m_nonZerosBuffers->jacobianCols)) {
+                reportError("OptimizationProblem", "evaluateConstraintsJacobianNonZeros", "Error while retrieving the constraints jacobian sparsity.");
+                return false;
+            }
+
+            if (!evaluateConstraintsJacobian(m_nonZerosBuffers->denseJacobian)) {
+                reportError("OptimizationProblem", "evaluateConstraintsJacobianNonZeros", "Error while evaluating the constraints jacobian.");
+                return false;
+            }
+
+            NonZerosEvaluationBuffers::extractNonZeros(m_nonZerosBuffers->denseJacobian, m_nonZerosBuffers->jacobianRows,
+                                                       m_nonZerosBuffers->jacobianCols, nonZeroElements);
+            return true;
+        }
+
+        bool OptimizationProblem::evaluateCostHessianNonZeros(VectorDynSize &nonZeroElements)
+        {
+            if (!getHessianInfo(m_nonZerosBuffers->hessianRows, m_nonZerosBuffers->hessianCols)) {
+                reportError("OptimizationProblem", "evaluateCostHessianNonZeros", "Error while retrieving the hessian sparsity.");
+                return false;
+            }
+
+            if (!evaluateCostHessian(m_nonZerosBuffers->denseHessian)) {
+                reportError("OptimizationProblem", "evaluateCostHessianNonZeros", "Error while evaluating the cost hessian.");
+                return false;
+            }
+
+            NonZerosEvaluationBuffers::extractNonZeros(m_nonZerosBuffers->denseHessian, m_nonZerosBuffers->hessianRows,
+                                                       m_nonZerosBuffers->hessianCols, nonZeroElements);
+            return true;
+        }
+
+        bool OptimizationProblem::evaluateConstraintsHessianNonZeros(const VectorDynSize &constraintsMultipliers, VectorDynSize &nonZeroElements)
+        {
+            if (!getHessianInfo(m_nonZerosBuffers->hessianRows, m_nonZerosBuffers->hessianCols)) {
+                reportError("OptimizationProblem", "evaluateConstraintsHessianNonZeros", "Error while retrieving the hessian sparsity.");
+                return false;
+            }
+
+            if (!evaluateConstraintsHessian(constraintsMultipliers, m_nonZerosBuffers->denseHessian)) {
+                reportError("OptimizationProblem", "evaluateConstraintsHessianNonZeros", "Error while evaluating the constraints hessian.");
+                return false;
+            }
+
+            NonZerosEvaluationBuffers::extractNonZeros(m_nonZerosBuffers->denseHessian, m_nonZerosBuffers->hessianRows,
+                                                       m_nonZerosBuffers->hessianCols, nonZeroElements);
+            return true;
+        }
+
         const OptimizationProblemInfo &OptimizationProblem::info() const
         {
             return m_info;
@@ -127,6 +206,8 @@ namespace iDynTree {
         , hasSparseConstraintJacobian(false)
         , hasSparseHessian(false)
         , hessianIsProvided(false)
+        , hessianIsUnchanged(false)
+        , constraintsJacobianIsUnchanged(false)
         { }
 
         OptimizationProblemInfo::OptimizationProblemInfo(std::shared_ptr<OptimizationProblemInfoData> data)
@@ -173,5 +254,15 @@ namespace iDynTree {
             return m_data->hessianIsProvided;
         }
 
+        bool OptimizationProblemInfo::hessianIsUnchanged() const
+        {
+            return m_data->hessianIsUnchanged;
+        }
+
+        bool OptimizationProblemInfo::constraintsJacobianIsUnchanged() const
+        {
+            return m_data->constraintsJacobianIsUnchanged;
+        }
+
     }
 }
@@ -46,30 +46,31 @@ namespace iDynTree {
             }
         };
 
+        // Iterates over the nonzero elements evaluated with the *NonZeros methods of OptimizationProblem,
+        // optionally preceded by an identity of dimension identityOnTopDimension (used for the box constraints)
         class TripletIterator : public std::iterator<std::input_iterator_tag, Triplet> {
             Triplet m_triplet;
             std::shared_ptr<std::vector<size_t>> m_rowIndeces;
             std::shared_ptr<std::vector<size_t>> m_colIndeces;
-            std::shared_ptr<MatrixDynSize> m_denseMatrix;
-            size_t m_nnzIdentity, m_nnzIndex;
-            bool m_addIdentity;
+            std::shared_ptr<VectorDynSize> m_nonZeroValues;
+            size_t m_identityDimension, m_nnzIdentity, m_nnzIndex;
 
         public:
             TripletIterator(std::shared_ptr<std::vector<size_t>> rowIndeces,
                             std::shared_ptr<std::vector<size_t>> colIndeces,
-                            std::shared_ptr<MatrixDynSize> denseMatrix,
-                            bool addIdentityOnTop = false)
+                            std::shared_ptr<VectorDynSize> nonZeroValues,
+                            size_t identityOnTopDimension = 0)
             : m_rowIndeces(rowIndeces)
             , m_colIndeces(colIndeces)
-            , m_denseMatrix(denseMatrix)
+            , m_nonZeroValues(nonZeroValues)
+            , m_identityDimension(identityOnTopDimension)
             , m_nnzIdentity(0)
             , m_nnzIndex(0)
-            , m_addIdentity(addIdentityOnTop)
             {
             }
 
             TripletIterator& operator++() {
-                if (m_addIdentity && (m_nnzIdentity < m_denseMatrix->cols())) {
+                if (m_nnzIdentity < m_identityDimension) {
                     m_nnzIdentity++;
                 } else {
                     m_nnzIndex++;
@@ -78,19 +79,11 @@ namespace iDynTree {
             }
 
             bool  operator==(const TripletIterator& rhs) const {
-                if (m_addIdentity) {
-                    return ((rhs.m_nnzIndex == this->m_nnzIndex) && (rhs.m_nnzIdentity == this->m_nnzIdentity));
-                } else {
-                    return (rhs.m_nnzIndex == this->m_nnzIndex);
-                }
+                return ((rhs.m_nnzIndex == this->m_nnzIndex) && (rhs.m_nnzIdentity == this->m_nnzIdentity));
             }
 
             bool operator!=(const TripletIterator& rhs) const {
-                if (m_addIdentity) {
-                    return ((rhs.m_nnzIndex != this->m_nnzIndex) || (rhs.m_nnzIdentity != this->m_nnzIdentity));
-                } else {
-                    return (rhs.m_nnzIndex != this->m_nnzIndex);
-                }
+                return !(operator==(rhs));
             }
 
             Triplet* operator->() {
@@ -98,7 +91,7 @@ namespace iDynTree {
             }
 
             Triplet& operator*() {
-                if (m_addIdentity && (m_nnzIdentity < m_denseMatrix->cols())) {
+                if (m_nnzIdentity < m_identityDimension) {
                     m_triplet.m_row = m_nnzIdentity;
                     m_triplet.m_col = m_nnzIdentity;
                     m_triplet.m_value = 1.0;
@@ -109,29 +102,26 @@ namespace iDynTree {
 
                 m_triplet.m_row = m_rowIndeces->operator[](m_nnzIndex) + m_nnzIdentity;
                 m_triplet.m_col = m_colIndeces->operator[](m_nnzIndex);
-                unsigned int row = static_cast<unsigned int>(m_rowIndeces->operator[](m_nnzIndex));
-                unsigned int col = static_cast<unsigned int>(m_triplet.m_col);
-                m_triplet.m_value = m_denseMatrix->operator()(row, col);
+                m_triplet.m_value = m_nonZeroValues->operator()(static_cast<unsigned int>(m_nnzIndex));
                 return m_triplet;
             }
 
             static TripletIterator begin(std::shared_ptr<std::vector<size_t>> rowIndeces,
                                          std::shared_ptr<std::vector<size_t>> colIndeces,
-                                         std::shared_ptr<MatrixDynSize> denseMatrix,
-                                         bool addIdentityOnTop = false) {
-                TripletIterator m_begin(rowIndeces, colIndeces, denseMatrix, addIdentityOnTop);
+                                         std::shared_ptr<VectorDynSize> nonZeroValues,
+                                         size_t identityOnTopDimension = 0) {
+                TripletIterator m_begin(rowIndeces, colIndeces, nonZeroValues, identityOnTopDimension);
                 assert(rowIndeces->size() == colIndeces->size());
+                assert(rowIndeces->size() == nonZeroValues->size());
                 return m_begin;
             }
 
             static TripletIterator end(std::shared_ptr<std::vector<size_t>> rowIndeces,
                                        std::shared_ptr<std::vector<size_t>> colIndeces,
-                                       std::shared_ptr<MatrixDynSize> denseMatrix,
-                                       bool addIdentityOnTop = false) {
-                TripletIterator m_end(rowIndeces, colIndeces, denseMatrix, addIdentityOnTop);
-                if (addIdentityOnTop) {
-                    m_end.m_nnzIdentity = denseMatrix->cols();
-                }
+                                       std::shared_ptr<VectorDynSize> nonZeroValues,
+                                       size_t identityOnTopDimension = 0) {
+                TripletIterator m_end(rowIndeces, colIndeces, nonZeroValues, identityOnTopDimension);
+                m_end.m_nnzIdentity = identityOnTopDimension;
                 m_end.m_nnzIndex = rowIndeces->size();
                 return m_end;
             }
@@ -238,19 +228,42 @@ namespace iDynTree {
             std::shared_ptr<std::vector<size_t>> hessianNNZRows, hessianNNZCols;
             VectorDynSize variablesBuffer, solutionBuffer, constraintsBuffer;
             VectorDynSize costGradient, iDynTreeInitialGuess;
+            VectorDynSize constraintsMultipliersGuess, lowerBoundsMultipliersGuess, upperBoundsMultipliersGuess;
             std::shared_ptr<MatrixDynSize> costHessian;
             std::shared_ptr<MatrixDynSize> constraintJacobian;
+            std::shared_ptr<VectorDynSize> costHessianNonZeros, constraintJacobianNonZeros;
             unsigned int nv, nc, previous_nv, previous_nc;
 
             Eigen::SparseMatrix<double> eigenHessian;
             Eigen::SparseMatrix<double> eigenJacobian;
             Eigen::VectorXd eigenGradient, eigenInitialGuess, unifiedLowerBounds, unifiedUpperBounds;
-            Eigen::VectorXd eigenPrimalVariables, eigenDualVariables;
+            Eigen::VectorXd eigenPrimalVariables, eigenDualVariables, eigenDualGuess;
             bool alreadySolved = false;
             bool isLowerBounded = false;
             bool isUpperBounded = false;
             bool optionsAllowReoptimize = true;
 
+            // Convert the dual guess of the problem to OSQP, where each row has a single multiplier (as in getDualVariables)
+            bool computeDualGuess() {
+                unsigned int boxRows = hasBoxConstraints ? nv : 0;
+                if (constraintsMultipliersGuess.size() != nc - boxRows) {
+                    reportError("OsqpInterface", "solve", "The specified dual guess has dimension different from the number of constraints.");
+                    return false;
+                }
+                eigenDualGuess.resize(nc);
+                if (hasBoxConstraints) {
+                    if ((lowerBoundsMultipliersGuess.size() != nv) || (upperBoundsMultipliersGuess.size() != nv)) {
+                        reportError("OsqpInterface", "solve", "The specified dual guess of the variables bounds has dimension different from the number of variables.");
+                        return false;
+                    }
+                    for (unsigned int i = 0; i < nv; ++i) {
+                        eigenDualGuess(i) = (lowerBoundsMultipliersGuess(i) != 0.0) ? lowerBoundsMultipliersGuess(i) : upperBoundsMultipliersGuess(i);
+                    }
+                }
+                eigenDualGuess.tail(nc - boxRows) = toEigen(constraintsMultipliersGuess);
+                return true;
+            }
+
             bool checkAndSetSetting() {
                 if (!checkDoublesAreEqual(settings.rho, previousSettings.rho)) {
                     if (settings.rho <= 0) {
@@ -417,6 +430,8 @@ namespace iDynTree {
             m_problem = nullptr;
             m_pimpl->costHessian = std::make_shared<MatrixDynSize>();
             m_pimpl->constraintJacobian = std::make_shared<MatrixDynSize>();
+            m_pimpl->costHessianNonZeros = std::make_shared<VectorDynSize>();
+            m_pimpl->constraintJacobianNonZeros = std::make_shared<VectorDynSize>();
             m_pimpl->constraintNNZRows = std::make_shared<std::vector<size_t>>();
             m_pimpl->constraintNNZCols = std::make_shared<std::vector<size_t>>();
             m_pimpl->hessianNNZRows = std::make_shared<std::vector<size_t>>();
@@ -442,6 +457,9 @@ namespace iDynTree {
                 reportError("OsqpInterface", "setProblem", "Empty problem pointer.");
                 return false;
             }
+            if (problem != m_problem) {
+                m_pimpl->alreadySolved = false; //the matrices of the previous problem cannot be reused
+            }
             m_problem = problem;
             return true;
         }
@@ -538,28 +556,43 @@ namespace iDynTree {
             m_pimpl->eigenGradient.resize(m_pimpl->nv);
             m_pimpl->eigenGradient = toEigen(m_pimpl->costGradient);
 
-            if (m_problem->info().hasSparseHessian()) {
+            if (!(m_pimpl->checkAndSetSetting())) {
+                reportError("OsqpInterface", "solve", "The specified settings seems to be faulty.");
+                return false;
+            }
+
+            // When the matrices did not change since the previous solve, they are not updated so that the solver keeps its factorization
+            bool restart = m_pimpl->possibleReStart();
+            bool updateHessian = !(restart && m_problem->info().hessianIsUnchanged());
+            bool updateJacobian = !(restart && m_problem->info().constraintsJacobianIsUnchanged());
+
+            if (updateHessian && m_problem->info().hasSparseHessian()) {
                 if (!(m_problem->getHessianInfo(*(m_pimpl->hessianNNZRows), *(m_pimpl->hessianNNZCols)))) {
                     reportError("OsqpInterface", "solve", "Error while retrieving hessian sparsity structure.");
                     return false;
                 }
 
-                if (!(m_problem->evaluateCostHessian(*(m_pimpl->costHessian)))) {
+                if (!(m_problem->evaluateCostHessianNonZeros(*(m_pimpl->costHessianNonZeros)))) {
                     reportError("OsqpInterface", "solve", "Error while retrieving cost hessian.");
                     return false;
                 }
 
+                if (m_pimpl->costHessianNonZeros->size() != m_pimpl->hessianNNZRows->size()) {
+                    reportError("OsqpInterface", "solve", "The number of nonzero elements of the cost hessian is different from the one of its sparsity structure.");
+                    return false;
+                }
+
                 TripletIterator beginIterator = TripletIterator::begin(m_pimpl->hessianNNZRows,
                                                                        m_pimpl->hessianNNZCols,
-                                                                       m_pimpl->costHessian);
+                                                                       m_pimpl->costHessianNonZeros);
 
                 TripletIterator endIterator = TripletIterator::end(m_pimpl->hessianNNZRows,
                                                                    m_pimpl->hessianNNZCols,
-                                                                   m_pimpl->costHessian);
+                                                                   m_pimpl->costHessianNonZeros);
 
                 m_pimpl->eigenHessian.resize(m_pimpl->nv, m_pimpl->nv);
                 m_pimpl->eigenHessian.setFromTriplets(beginIterator, endIterator);
-            } else {
+            } else if (updateHessian) {
                 if (!(m_problem->evaluateCostHessian(*(m_pimpl->costHessian)))) {
                     reportError("OsqpInterface", "solve", "Error while retrieving cost hessian.");
                     return false;
@@ -573,30 +606,37 @@ namespace iDynTree {
                 m_pimpl->eigenHessian.setFromTriplets(beginIterator, endIterator);
             }
 
-            if (m_problem->info().hasSparseConstraintJacobian()) {
+            if (updateJacobian && m_problem->info().hasSparseConstraintJacobian()) {
                 if (!(m_problem->getConstraintsJacobianInfo(*(m_pimpl->constraintNNZRows), *(m_pimpl->constraintNNZCols)))) {
                     reportError("OsqpInterface", "solve", "Error while retrieving constraint jacobian sparsity structure.");
                     return false;
                 }
 
-                if (!(m_problem->evaluateConstraintsJacobian(*(m_pimpl->constraintJacobian)))) {
+                if (!(m_problem->evaluateConstraintsJacobianNonZeros(*(m_pimpl->constraintJacobianNonZeros)))) {
                     reportError("OsqpInterface", "solve", "Error while retrieving constraint jacobian.");
                     return false;
                 }
 
+                if (m_pimpl->constraintJacobianNonZeros->size() != m_pimpl->constraintNNZRows->size()) {
+                    reportError("OsqpInterface", "solve", "The number of nonzero elements of the constraint jacobian is different from the one of its sparsity structure.");
+                    return false;
+                }
+
+                size_t identityOnTopDimension = m_pimpl->hasBoxConstraints ? m_pimpl->nv : 0;
+
                 TripletIterator beginIterator = TripletIterator::begin(m_pimpl->constraintNNZRows,
                                                                        m_pimpl->constraintNNZCols,
-                                                                       m_pimpl->constraintJacobian,
-                                                                       m_pimpl->hasBoxConstraints);
+                                                                       m_pimpl->constraintJacobianNonZeros,
+                                                                       identityOnTopDimension);
 
                 TripletIterator endIterator = TripletIterator::end(m_pimpl->constraintNNZRows,
                                                                    m_pimpl->constraintNNZCols,
-                                                                   m_pimpl->constraintJacobian,
-                                                                   m_pimpl->hasBoxConstraints);
+                                                                   m_pimpl->constraintJacobianNonZeros,
+                                                                   identityOnTopDimension);
 
                 m_pimpl->eigenJacobian.resize(m_pimpl->nc, m_pimpl->nv);
                 m_pimpl->eigenJacobian.setFromTriplets(beginIterator, endIterator);
-            } else {
+            } else if (updateJacobian) {
                 if (!(m_problem->evaluateConstraintsJacobian(*(m_pimpl->constraintJacobian)))) {
                     reportError("OsqpInterface", "solve", "Error while retrieving constraint jacobian.");
                     return false;
@@ -612,14 +652,9 @@ namespace iDynTree {
                 m_pimpl->eigenJacobian.setFromTriplets(beginIterator, endIterator);
             }
 
-            if (!(m_pimpl->checkAndSetSetting())) {
-                reportError("OsqpInterface", "solve", "The specified settings seems to be faulty.");
-                return false;
-            }
+            if (restart) {
 
-            if (m_pimpl->possibleReStart()) {
-
-                if (!m_pimpl->solver.updateHessianMatrix(m_pimpl->eigenHessian)) {
+                if (updateHessian && !m_pimpl->solver.updateHessianMatrix(m_pimpl->eigenHessian)) {
                     reportError("OsqpInterface", "solve", "Error while updating the cost hessian.");
                     return false;
                 }
@@ -629,7 +664,7 @@ namespace iDynTree {
                     return false;
                 }
 
-                if (!m_pimpl->solver.updateLinearConstraintsMatrix(m_pimpl->eigenJacobian)) {
+                if (updateJacobian && !m_pimpl->solver.updateLinearConstraintsMatrix(m_pimpl->eigenJacobian)) {
                     reportError("OsqpInterface", "solve", "Error while updating the constraints jacobian.");
                     return false;
                 }
@@ -660,7 +695,16 @@ namespace iDynTree {
                     }
                 }
 
-                if (!(m_pimpl->solver.setDualVariable(m_pimpl->eigenDualVariables))) {
+                if (m_problem->getDualGuess(m_pimpl->constraintsMultipliersGuess, m_pimpl->lowerBoundsMultipliersGuess, m_pimpl->upperBoundsMultipliersGuess)) {
+                    if (!m_pimpl->computeDualGuess()) {
+                        return false;
+                    }
+
+                    if (!(m_pimpl->solver.setDualVariable(m_pimpl->eigenDualGuess))) {
+                        reportError("OsqpInterface", "solve", "Error while setting the initial guess for dual variables to the solver.");
+                        return false;
+                    }
+                } else if (!(m_pimpl->solver.setDualVariable(m_pimpl->eigenDualVariables))) {
                     reportError("OsqpInterface", "solve", "Error while setting the initial guess for dual variables to the solver.");
                     return false;
                 }
@@ -722,6 +766,17 @@ namespace iDynTree {
                         return false;
                     }
                 }
+
+                if (m_problem->getDualGuess(m_pimpl->constraintsMultipliersGuess, m_pimpl->lowerBoundsMultipliersGuess, m_pimpl->upperBoundsMultipliersGuess)) {
+                    if (!m_pimpl->computeDualGuess()) {
+                        return false;
+                    }
+
+                    if (!(m_pimpl->solver.setDualVariable(m_pimpl->eigenDualGuess))) {
+                        reportError("OsqpInterface", "solve", "Error while setting the initial guess for dual variables to the solver.");
+                        return false;
+                    }
+                }
             }
 
             if (!(m_pimpl->solver.isInitialized())) {
@@ -772,7 +827,7 @@ namespace iDynTree {
             if (!(m_pimpl->hasBoxConstraints)) {
                 lowerBoundsMultipliers.zero();
                 upperBoundsMultipliers.zero();
-                constraintsMultipliers = constraintsMultipliers;
+                toEigen(constraintsMultipliers) = m_pimpl->eigenDualVariables;
                 return true;
             }
 
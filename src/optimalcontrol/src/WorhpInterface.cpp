@@ -28,7 +28,7 @@ typedef struct {
 
 class MatrixElement {
 
-    bool prioritySign() const{
+    int prioritySign() const{
         int thisIndexDifference = static_cast<int>(row) - static_cast<int>(col);
         return (thisIndexDifference > 0) - (thisIndexDifference < 0); // +1 is the lower triangular part, 0 the diagonal, -1 the upper triangular part
     }
@@ -36,6 +36,7 @@ class MatrixElement {
 public:
     unsigned int row;
     unsigned int col;
+    size_t position; //position in the vector of nonzero elements of the problem
 
     bool operator < (const MatrixElement& other) const {
         return this->col < other.col
@@ -57,6 +58,7 @@ public:
     iDynTree::VectorDynSize variablesLowerBounds, variablesUpperBounds, constraintsLowerBounds, constraintsUpperBounds;
     iDynTree::VectorDynSize variablesBuffer, constraintsEvaluationBuffer, costGradientBuffer, constraintsMultipliersBuffer;
     iDynTree::MatrixDynSize constraintsJacobianBuffer, costHessianBuffer, constraintsHessianBuffer;
+    iDynTree::VectorDynSize constraintsJacobianNonZerosBuffer, costHessianNonZerosBuffer, constraintsHessianNonZerosBuffer;
     std::vector<MatrixElement> orderedJacobianNonZeros, orderedHessianNonZeros;
     unsigned int previousNumberOfVariables, previousNumberOfConstraints, previousJacobianNonZeros, previousHessianNonZeros;
     std::unordered_map<std::string, bool> boolParamsBackup;
@@ -72,12 +74,16 @@ public:
         variablesBuffer.resize(numberOfVariables);
         constraintsEvaluationBuffer.resize(numberOfConstraints);
         costGradientBuffer.resize(numberOfVariables);
-        constraintsJacobianBuffer.resize(numberOfConstraints,numberOfVariables);
-        constraintsJacobianBuffer.zero();
-        costHessianBuffer.resize(numberOfVariables, numberOfVariables);
-        costHessianBuffer.zero();
-        constraintsHessianBuffer.resize(numberOfVariables, numberOfVariables);
-        constraintsHessianBuffer.zero();
+        if (!sparseJacobian) { //otherwise only the nonzero elements are evaluated
+            constraintsJacobianBuffer.resize(numberOfConstraints,numberOfVariables);
+            constraintsJacobianBuffer.zero();
+        }
+        if (!sparseHessian) {
+            costHessianBuffer.resize(numberOfVariables, numberOfVariables);
+            costHessianBuffer.zero();
+            constraintsHessianBuffer.resize(numberOfVariables, numberOfVariables);
+            constraintsHessianBuffer.zero();
+        }
         constraintsMultipliersBuffer.resize(numberOfConstraints);
         initialPoint.resize(numberOfVariables);
 
@@ -187,6 +193,7 @@ bool WorhpInterface::solve()
         for (size_t i = 0; i < m_pimpl->constraintsJacNNZRows.size(); ++i) {
             m_pimpl->orderedJacobianNonZeros[i].row = static_cast<unsigned int>(m_pimpl->constraintsJacNNZRows[i]);
             m_pimpl->orderedJacobianNonZeros[i].col = static_cast<unsigned int>(m_pimpl->constraintsJacNNZCols[i]);
+            m_pimpl->orderedJacobianNonZeros[i].position = i;
         }
 
         std::sort(m_pimpl->orderedJacobianNonZeros.begin(), m_pimpl->orderedJacobianNonZeros.end());
@@ -234,6 +241,7 @@ bool WorhpInterface::solve()
         for (size_t i = 0; i < m_pimpl->hessianNNZRows.size(); ++i) {
             m_pimpl->orderedHessianNonZeros[i].row = static_cast<unsigned int>(m_pimpl->hessianNNZRows[i]);
             m_pimpl->orderedHessianNonZeros[i].col = static_cast<unsigned int>(m_pimpl->hessianNNZCols[i]);
+            m_pimpl->orderedHessianNonZeros[i].position = i;
         }
 
         std::sort(m_pimpl->orderedHessianNonZeros.begin(), m_pimpl->orderedHessianNonZeros.end(),
@@ -559,20 +567,30 @@ bool WorhpInterface::solve()
                     return false;
             }
 
-            if (!m_problem->evaluateConstraintsJacobian(m_pimpl->constraintsJacobianBuffer)) {
-                reportError("WorhpInterface", "solve", "Failed to evaluate constraints jacobian.");
-                m_pimpl->previouslySolved = false;
-                return false;
-            }
-
             if (m_pimpl->sparseJacobian) {
+                if (!m_problem->evaluateConstraintsJacobianNonZeros(m_pimpl->constraintsJacobianNonZerosBuffer)) {
+                    reportError("WorhpInterface", "solve", "Failed to evaluate constraints jacobian.");
+                    m_pimpl->previouslySolved = false;
+                    return false;
+                }
+
+                if (m_pimpl->constraintsJacobianNonZerosBuffer.size() != m_pimpl->orderedJacobianNonZeros.size()) {
+                    reportError("WorhpInterface", "solve", "The number of nonzero elements of the constraints jacobian changed.");
+                    m_pimpl->previouslySolved = false;
+                    return false;
+                }
+
                 for (size_t i = 0; i < m_pimpl->orderedJacobianNonZeros.size(); ++i) {
                     m_pimpl->worhp.wsp.DG.val[i] =
-                            m_pimpl->constraintsJacobianBuffer(
-                                m_pimpl->orderedJacobianNonZeros[i].row,
-                                m_pimpl->orderedJacobianNonZeros[i].col);
+                            m_pimpl->constraintsJacobianNonZerosBuffer(static_cast<unsigned int>(m_pimpl->orderedJacobianNonZeros[i].position));
                 }
             } else {
+                if (!m_problem->evaluateConstraintsJacobian(m_pimpl->constraintsJacobianBuffer)) {
+                    reportError("WorhpInterface", "solve", "Failed to evaluate constraints jacobian.");
+                    m_pimpl->previouslySolved = false;
+                    return false;
+                }
+
                 size_t element = 0;
                 for (unsigned int  col = 0; col < n; ++col) {
                     for (unsigned int row = 0; row < m; ++row) {
@@ -594,30 +612,61 @@ bool WorhpInterface::solve()
                     return false;
             }
 
-            if (!m_problem->evaluateCostHessian(m_pimpl->costHessianBuffer)) {
-                reportError("WorhpInterface", "solve", "Failed to get cost hessian.");
-                m_pimpl->previouslySolved = false;
-                return false;
-            }
-
             Eigen::Map<Eigen::VectorXd> constraintsMultipliersMap(m_pimpl->worhp.opt.Mu, m);
             iDynTree::toEigen(m_pimpl->constraintsMultipliersBuffer) = constraintsMultipliersMap;
 
-            if (!m_problem->evaluateConstraintsHessian(m_pimpl->constraintsMultipliersBuffer, m_pimpl->constraintsHessianBuffer)) {
-                reportError("WorhpInterface", "solve", "Failed to get constraints hessian.");
-                m_pimpl->previouslySolved = false;
-                return false;
-            }
+            // the diagonal elements are stored after the strictly lower triangular ones
+            size_t diagonalOffset = static_cast<size_t>(m_pimpl->worhp.wsp.HM.nnz) - n;
 
             if (m_pimpl->sparseHessian) {
-                for (size_t i = 0; i < m_pimpl->hessianLowerTriangularNonZeros; ++i) {
-                    unsigned int row = m_pimpl->orderedJacobianNonZeros[i].row;
-                    unsigned int col = m_pimpl->orderedJacobianNonZeros[i].col;
-                    m_pimpl->worhp.wsp.HM.val[i] =
-                            (m_pimpl->worhp.wsp.ScaleObj * m_pimpl->costHessianBuffer(row, col)) +
-                            m_pimpl->constraintsHessianBuffer(row,col);
+                if (!m_problem->evaluateCostHessianNonZeros(m_pimpl->costHessianNonZerosBuffer)) {
+                    reportError("WorhpInterface", "solve", "Failed to get cost hessian.");
+                    m_pimpl->previouslySolved = false;
+                    return false;
+                }
+
+                if (!m_problem->evaluateConstraintsHessianNonZeros(m_pimpl->constraintsMultipliersBuffer, m_pimpl->constraintsHessianNonZerosBuffer)) {
+                    reportError("WorhpInterface", "solve", "Failed to get constraints hessian.");
+                    m_pimpl->previouslySolved = false;
+                    return false;
+                }
+
+                if ((m_pimpl->costHessianNonZerosBuffer.size() != m_pimpl->orderedHessianNonZeros.size()) ||
+                    (m_pimpl->constraintsHessianNonZerosBuffer.size() != m_pimpl->orderedHessianNonZeros.size())) {
+                    reportError("WorhpInterface", "solve", "The number of nonzero elements of the hessian changed.");
+                    m_pimpl->previouslySolved = false;
+                    return false;
+                }
+
+                for (unsigned int i = 0; i < n; i++) { // diagonal elements outside the sparsity pattern
+                    m_pimpl->worhp.wsp.HM.val[diagonalOffset + i] = 0.0;
+                }
+
+                // the ordered nonzeros contain the strictly lower triangular elements first, and then the diagonal ones
+                for (size_t i = 0; i < m_pimpl->orderedHessianNonZeros.size(); ++i) {
+                    const MatrixElement& element = m_pimpl->orderedHessianNonZeros[i];
+                    if (element.row < element.col) {
+                        break;
+                    }
+                    unsigned int position = static_cast<unsigned int>(element.position);
+                    size_t worhpIndex = (i < m_pimpl->hessianLowerTriangularNonZeros) ? i : diagonalOffset + element.row;
+                    m_pimpl->worhp.wsp.HM.val[worhpIndex] =
+                            (m_pimpl->worhp.wsp.ScaleObj * m_pimpl->costHessianNonZerosBuffer(position)) +
+                            m_pimpl->constraintsHessianNonZerosBuffer(position);
                 }
             } else {
+                if (!m_problem->evaluateCostHessian(m_pimpl->costHessianBuffer)) {
+                    reportError("WorhpInterface", "solve", "Failed to get cost hessian.");
+                    m_pimpl->previouslySolved = false;
+                    return false;
+                }
+
+                if (!m_problem->evaluateConstraintsHessian(m_pimpl->constraintsMultipliersBuffer, m_pimpl->constraintsHessianBuffer)) {
+                    reportError("WorhpInterface", "solve", "Failed to get constraints hessian.");
+                    m_pimpl->previouslySolved = false;
+                    return false;
+                }
+
                 size_t element = 0;
                 for (unsigned int  col = 1; col < n; ++col) {
                     for (unsigned int row = 0; row < col; ++row) {
@@ -627,12 +676,12 @@ bool WorhpInterface::solve()
                         element++;
                     }
                 }
-            }
-            // diagonal
-            for (unsigned int i = 0; i < n; i++) {
-                m_pimpl->worhp.wsp.HM.val[i] =
-                        (m_pimpl->worhp.wsp.ScaleObj * m_pimpl->costHessianBuffer(i, i)) +
-                        m_pimpl->constraintsHessianBuffer(i,i);
+                // diagonal
+                for (unsigned int i = 0; i < n; i++) {
+                    m_pimpl->worhp.wsp.HM.val[diagonalOffset + i] =
+                            (m_pimpl->worhp.wsp.ScaleObj * m_pimpl->costHessianBuffer(i, i)) +
+                            m_pimpl->constraintsHessianBuffer(i,i);
+                }
             }
 
             DoneUserAction(&m_pimpl->worhp.cnt, evalHM);
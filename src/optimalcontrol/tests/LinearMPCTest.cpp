@@ -0,0 +1,361 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Originally developed for Prioritized Optimal Control (2014)
+ * Refactored in 2018.
+ * Design inspired by
+ * - ACADO toolbox (http://acado.github.io)
+ * - ADRL Control Toolbox (https://adrlab.bitbucket.io/ct/ct_doc/doc/html/index.html)
+ */
+
+#include <iDynTree/LinearMPC.h>
+#include <iDynTree/LinearSystem.h>
+#include <iDynTree/QuadraticCost.h>
+#include <iDynTree/LinearConstraint.h>
+#include <iDynTree/OptimizationProblem.h>
+#include <iDynTree/Optimizer.h>
+#include <iDynTree/Optimizers/OsqpInterface.h>
+#include <iDynTree/Utils.h>
+#include <iDynTree/TestUtils.h>
+#include <iDynTree/VectorDynSize.h>
+#include <iDynTree/MatrixDynSize.h>
+#include <Eigen/Dense>
+#include <iDynTree/EigenHelpers.h>
+
+#include <memory>
+#include <vector>
+
+using namespace iDynTree;
+using namespace iDynTree::optimalcontrol;
+
+// Solves the QP considering only the equality constraints, and checks the derivatives of the problem
+class EqualityConstrainedQPSolver : public optimization::Optimizer {
+    VectorDynSize m_solution, m_multipliers;
+public:
+    bool hessianIsUnchanged = false;
+    bool jacobianIsUnchanged = false;
+    bool guessProvided = false;
+    bool dualGuessProvided = false;
+    VectorDynSize guess, dualGuess, lowerBoundsDualGuess, upperBoundsDualGuess;
+
+    virtual bool isAvailable() const override {
+        return true;
+    }
+
+    void checkProblem() {
+        unsigned int nv = m_problem->numberOfVariables();
+        VectorDynSize variables(nv), perturbedVariables(nv), gradient, nonZeros, expectedNonZeros;
+        getRandomVector(variables);
+
+        // Cost gradient compared with finite differences (the cost is quadratic, so central differences are exact up to roundoff)
+        ASSERT_IS_TRUE(m_problem->setVariables(variables));
+        ASSERT_IS_TRUE(m_problem->evaluateCostGradient(gradient));
+        const double delta = 1e-3;
+        for (unsigned int i = 0; i < nv; ++i) {
+            double plusCost, minusCost;
+            perturbedVariables = variables;
+            perturbedVariables(i) += delta;
+            ASSERT_IS_TRUE(m_problem->setVariables(perturbedVariables));
+            ASSERT_IS_TRUE(m_problem->evaluateCostFunction(plusCost));
+            perturbedVariables(i) -= 2 * delta;
+            ASSERT_IS_TRUE(m_problem->setVariables(perturbedVariables));
+            ASSERT_IS_TRUE(m_problem->evaluateCostFunction(minusCost));
+            ASSERT_EQUAL_DOUBLE_TOL(gradient(i), (plusCost - minusCost) / (2 * delta), 1e-5);
+        }
+
+        // The constraints are linear, with the jacobian as matrix
+        VectorDynSize constraints;
+        MatrixDynSize jacobian;
+        ASSERT_IS_TRUE(m_problem->setVariables(variables));
+        ASSERT_IS_TRUE(m_problem->evaluateConstraints(constraints));
+        ASSERT_IS_TRUE(m_problem->evaluateConstraintsJacobian(jacobian));
+        ASSERT_EQUAL_VECTOR(constraints, (toEigen(jacobian) * toEigen(variables)).eval());
+
+        // The native nonzero evaluations match the dense ones
+        ASSERT_IS_TRUE(m_problem->evaluateConstraintsJacobianNonZeros(nonZeros));
+        ASSERT_IS_TRUE(m_problem->OptimizationProblem::evaluateConstraintsJacobianNonZeros(expectedNonZeros));
+        ASSERT_EQUAL_VECTOR(nonZeros, expectedNonZeros);
+        ASSERT_IS_TRUE(m_problem->evaluateCostHessianNonZeros(nonZeros));
+        ASSERT_IS_TRUE(m_problem->OptimizationProblem::evaluateCostHessianNonZeros(expectedNonZeros));
+        ASSERT_EQUAL_VECTOR(nonZeros, expectedNonZeros);
+    }
+
+    virtual bool solve() override {
+        if (!m_problem->prepare()) {
+            return false;
+        }
+        hessianIsUnchanged = m_problem->info().hessianIsUnchanged();
+        jacobianIsUnchanged = m_problem->info().constraintsJacobianIsUnchanged();
+        guessProvided = m_problem->getGuess(guess);
+        dualGuessProvided = m_problem->getDualGuess(dualGuess, lowerBoundsDualGuess, upperBoundsDualGuess);
+
+        checkProblem();
+
+        unsigned int nv = m_problem->numberOfVariables();
+        unsigned int nc = m_problem->numberOfConstraints();
+        VectorDynSize zero(nv), gradient, lowerBounds, upperBounds, constraints;
+        MatrixDynSize hessian, jacobian;
+        zero.zero();
+        ASSERT_IS_TRUE(m_problem->setVariables(zero));
+        ASSERT_IS_TRUE(m_problem->evaluateCostGradient(gradient));
+        ASSERT_IS_TRUE(m_problem->evaluateCostHessian(hessian));
+        ASSERT_IS_TRUE(m_problem->evaluateConstraintsJacobian(jacobian));
+        ASSERT_IS_TRUE(m_problem->getConstraintsBounds(lowerBounds, upperBounds));
+
+        std::vector<unsigned int> equalities;
+        for (unsigned int i = 0; i < nc; ++i) {
+            if (checkDoublesAreEqual(lowerBounds(i), upperBounds(i))) {
+                equalities.push_back(i);
+            }
+        }
+
+        Eigen::Index ne = static_cast<Eigen::Index>(equalities.size());
+        Eigen::MatrixXd kkt = Eigen::MatrixXd::Zero(nv + ne, nv + ne);
+        Eigen::VectorXd rhs(nv + ne);
+        kkt.topLeftCorner(nv, nv) = toEigen(hessian);
+        rhs.head(nv) = -toEigen(gradient);
+        for (Eigen::Index i = 0; i < ne; ++i) {
+            kkt.block(nv + i, 0, 1, nv) = toEigen(jacobian).row(equalities[i]);
+            kkt.block(0, nv + i, nv, 1) = toEigen(jacobian).row(equalities[i]).transpose();
+            rhs(nv + i) = lowerBounds(equalities[i]);
+        }
+
+        Eigen::VectorXd kktSolution = kkt.fullPivLu().solve(rhs);
+        m_solution.resize(nv);
+        toEigen(m_solution) = kktSolution.head(nv);
+        m_multipliers.resize(nc);
+        m_multipliers.zero();
+        for (Eigen::Index i = 0; i < ne; ++i) {
+            m_multipliers(equalities[i]) = kktSolution(nv + i);
+        }
+        return true;
+    }
+
+    virtual bool getPrimalVariables(VectorDynSize &primalVariables) override {
+        primalVariables = m_solution;
+        return true;
+    }
+
+    virtual bool getDualVariables(VectorDynSize &constraintsMultipliers, VectorDynSize &lowerBoundsMultipliers, VectorDynSize &upperBoundsMultipliers) override {
+        constraintsMultipliers = m_multipliers;
+        lowerBoundsMultipliers.resize(m_solution.size());
+        lowerBoundsMultipliers.zero();
+        upperBoundsMultipliers = lowerBoundsMultipliers;
+        return true;
+    }
+};
+
+std::shared_ptr<LinearSystem> createSystem() {
+    // Two double integrators coupled through the controls
+    std::shared_ptr<LinearSystem> system = std::make_shared<LinearSystem>(4, 2);
+    MatrixDynSize stateMatrix(4, 4), controlMatrix(4, 2);
+    stateMatrix.zero();
+    stateMatrix(0, 2) = 1.0;
+    stateMatrix(1, 3) = 1.0;
+    controlMatrix.zero();
+    controlMatrix(2, 0) = 1.0;
+    controlMatrix(2, 1) = 0.5;
+    controlMatrix(3, 1) = 1.0;
+    ASSERT_IS_TRUE(system->setStateMatrix(stateMatrix));
+    ASSERT_IS_TRUE(system->setControlMatrix(controlMatrix));
+    return system;
+}
+
+std::shared_ptr<QuadraticCost> createCost(const std::string& name, double stateWeight, double controlWeight, const VectorDynSize& stateReference) {
+    std::shared_ptr<QuadraticCost> cost = std::make_shared<QuadraticCost>(name);
+    MatrixDynSize stateHessian(4, 4), controlHessian(2, 2);
+    toEigen(stateHessian) = stateWeight * Eigen::Matrix4d::Identity();
+    toEigen(controlHessian) = controlWeight * Eigen::Matrix2d::Identity();
+    VectorDynSize stateGradient(4), controlGradient(2);
+    toEigen(stateGradient) = -toEigen(stateHessian) * toEigen(stateReference);
+    controlGradient.zero();
+    ASSERT_IS_TRUE(cost->setStateCost(stateHessian, stateGradient));
+    ASSERT_IS_TRUE(cost->setControlCost(controlHessian, controlGradient));
+    return cost;
+}
+
+// First control of the finite horizon LQR, computed with the Riccati recursion
+Eigen::VectorXd riccatiFirstControl(const Eigen::VectorXd& initialState, size_t steps, double dt,
+                                    double stateWeight, double controlWeight, double terminalWeight) {
+    Eigen::Matrix4d A = Eigen::Matrix4d::Identity();
+    A(0, 2) = dt;
+    A(1, 3) = dt;
+    Eigen::Matrix<double, 4, 2> B = Eigen::Matrix<double, 4, 2>::Zero();
+    B(2, 0) = dt;
+    B(2, 1) = 0.5 * dt;
+    B(3, 1) = dt;
+    Eigen::Matrix4d Q = stateWeight * Eigen::Matrix4d::Identity();
+    Eigen::Matrix2d R = controlWeight * Eigen::Matrix2d::Identity();
+    Eigen::Matrix4d P = terminalWeight * Eigen::Matrix4d::Identity();
+    Eigen::Matrix<double, 2, 4> K;
+    for (size_t k = steps; k > 0; --k) {
+        K = (R + B.transpose() * P * B).ldlt().solve(B.transpose() * P * A);
+        P = Q + A.transpose() * P * (A - B * K);
+    }
+    return -K * initialState;
+}
+
+void checkFormulation(LinearMPCFormulation formulation) {
+    const size_t steps = 20;
+    const double dt = 0.05;
+
+    VectorDynSize zeroReference(4), reference(4), initialState(4), controls(2);
+    zeroReference.zero();
+    getRandomVector(reference);
+    getRandomVector(initialState);
+
+    LinearMPC mpc(createSystem());
+    std::shared_ptr<EqualityConstrainedQPSolver> optimizer = std::make_shared<EqualityConstrainedQPSolver>();
+    ASSERT_IS_TRUE(mpc.setOptimizer(optimizer));
+    ASSERT_IS_TRUE(mpc.setHorizon(steps, dt));
+    ASSERT_IS_TRUE(mpc.setFormulation(formulation));
+    std::shared_ptr<QuadraticCost> stageCost = createCost("stage", 1.0, 0.1, zeroReference);
+    ASSERT_IS_TRUE(mpc.setStageCost(stageCost));
+    ASSERT_IS_TRUE(mpc.setTerminalCost(createCost("terminal", 5.0, 0.0, zeroReference)));
+
+    // Constraints without equalities, so that they do not affect the solution of the test optimizer
+    std::shared_ptr<LinearConstraint> constraint = std::make_shared<LinearConstraint>(3, "constraint");
+    MatrixDynSize stateConstraintMatrix(3, 4), controlConstraintMatrix(3, 2);
+    getRandomMatrix(stateConstraintMatrix);
+    getRandomMatrix(controlConstraintMatrix);
+    ASSERT_IS_TRUE(constraint->setStateConstraintMatrix(stateConstraintMatrix));
+    ASSERT_IS_TRUE(constraint->setControlConstraintMatrix(controlConstraintMatrix));
+    VectorDynSize bound(3);
+    toEigen(bound).setConstant(1e3);
+    ASSERT_IS_TRUE(constraint->setUpperBound(bound));
+    ASSERT_IS_TRUE(mpc.addConstraint(constraint));
+
+    ASSERT_IS_FALSE(mpc.solve()); //no state feedback
+    ASSERT_IS_TRUE(mpc.setStateFeedback(0.0, initialState));
+    ASSERT_IS_TRUE(mpc.doControl(controls));
+    ASSERT_IS_FALSE(optimizer->hessianIsUnchanged);
+    ASSERT_IS_FALSE(optimizer->jacobianIsUnchanged);
+    ASSERT_IS_FALSE(optimizer->guessProvided);
+    ASSERT_IS_FALSE(optimizer->dualGuessProvided);
+
+    ASSERT_EQUAL_VECTOR(controls, riccatiFirstControl(toEigen(initialState), steps, dt, 1.0, 0.1, 5.0));
+
+    std::vector<VectorDynSize> states, controlsSequence;
+    ASSERT_IS_TRUE(mpc.getSolution(states, controlsSequence));
+    ASSERT_IS_TRUE(states.size() == steps + 1);
+    ASSERT_IS_TRUE(controlsSequence.size() == steps);
+    ASSERT_EQUAL_VECTOR(states.front(), initialState);
+    ASSERT_EQUAL_VECTOR(controlsSequence.front(), controls);
+
+    VectorDynSize multipliers, lowerBoundsMultipliers, upperBoundsMultipliers;
+    ASSERT_IS_TRUE(optimizer->getDualVariables(multipliers, lowerBoundsMultipliers, upperBoundsMultipliers));
+
+    // Next tick: only the vectors change, and the previous primal and dual solutions are shifted to be used as guess
+    ASSERT_IS_TRUE(mpc.setStateFeedback(dt, states[1]));
+    ASSERT_IS_TRUE(mpc.doControl(controls));
+    ASSERT_IS_TRUE(optimizer->hessianIsUnchanged);
+    ASSERT_IS_TRUE(optimizer->jacobianIsUnchanged);
+    ASSERT_IS_TRUE(optimizer->guessProvided);
+    ASSERT_EQUAL_VECTOR(toEigen(optimizer->guess).head(2), toEigen(controlsSequence[1]));
+    ASSERT_IS_TRUE(optimizer->dualGuessProvided);
+    ASSERT_IS_TRUE(optimizer->dualGuess.size() == multipliers.size());
+    Eigen::Index constraintsPerStep = static_cast<Eigen::Index>(multipliers.size() / steps);
+    ASSERT_EQUAL_VECTOR(toEigen(optimizer->dualGuess).head(multipliers.size() - constraintsPerStep),
+                        toEigen(multipliers).tail(multipliers.size() - constraintsPerStep));
+    ASSERT_EQUAL_VECTOR(toEigen(optimizer->dualGuess).tail(constraintsPerStep), toEigen(multipliers).tail(constraintsPerStep));
+    if (formulation == LinearMPCFormulation::Sparse) {
+        // The multipliers of the dynamics constraints are not zero
+        ASSERT_IS_TRUE(toEigen(multipliers).norm() > 0.0);
+    }
+    ASSERT_EQUAL_VECTOR(controls, riccatiFirstControl(toEigen(states[1]), steps, dt, 1.0, 0.1, 5.0));
+
+    // Changing only the reference keeps the matrices
+    VectorDynSize stateGradient(4);
+    MatrixDynSize stateHessianMatrix(4, 4);
+    toEigen(stateHessianMatrix).setIdentity();
+    toEigen(stateGradient) = -toEigen(reference);
+    ASSERT_IS_TRUE(stageCost->setStateCost(stateHessianMatrix, stateGradient));
+    ASSERT_IS_TRUE(mpc.doControl(controls));
+    ASSERT_IS_TRUE(optimizer->hessianIsUnchanged);
+    ASSERT_IS_TRUE(optimizer->jacobianIsUnchanged);
+
+    // Changing the weights rebuilds the hessian
+    toEigen(stateHessianMatrix) *= 2.0;
+    ASSERT_IS_TRUE(stageCost->setStateCost(stateHessianMatrix, stateGradient));
+    ASSERT_IS_TRUE(mpc.doControl(controls));
+    ASSERT_IS_FALSE(optimizer->hessianIsUnchanged);
+    ASSERT_IS_TRUE(optimizer->jacobianIsUnchanged);
+}
+
+void checkFormulationsAgree() {
+    VectorDynSize reference(4), initialState(4);
+    getRandomVector(reference);
+    getRandomVector(initialState);
+
+    std::vector<VectorDynSize> sparseStates, sparseControls, condensedStates, condensedControls;
+    for (LinearMPCFormulation formulation : {LinearMPCFormulation::Sparse, LinearMPCFormulation::Condensed}) {
+        LinearMPC mpc(createSystem());
+        ASSERT_IS_TRUE(mpc.setOptimizer(std::make_shared<EqualityConstrainedQPSolver>()));
+        ASSERT_IS_TRUE(mpc.setHorizon(15, 0.1));
+        ASSERT_IS_TRUE(mpc.setFormulation(formulation));
+        ASSERT_IS_TRUE(mpc.setStageCost(createCost("stage", 2.0, 0.5, reference)));
+        ASSERT_IS_TRUE(mpc.setStateFeedback(1.0, initialState));
+        ASSERT_IS_TRUE(mpc.solve());
+        if (formulation == LinearMPCFormulation::Sparse) {
+            ASSERT_IS_TRUE(mpc.getSolution(sparseStates, sparseControls));
+        } else {
+            ASSERT_IS_TRUE(mpc.getSolution(condensedStates, condensedControls));
+        }
+    }
+
+    for (size_t k = 0; k < sparseControls.size(); ++k) {
+        ASSERT_EQUAL_VECTOR(sparseControls[k], condensedControls[k]);
+        ASSERT_EQUAL_VECTOR(sparseStates[k + 1], condensedStates[k + 1]);
+    }
+}
+
+void checkOsqp(LinearMPCFormulation formulation) {
+    std::shared_ptr<optimization::OsqpInterface> optimizer = std::make_shared<optimization::OsqpInterface>();
+    if (!optimizer->isAvailable()) {
+        return;
+    }
+    optimizer->settings().verbose = false;
+    optimizer->settings().eps_abs = 1e-6;
+    optimizer->settings().eps_rel = 1e-6;
+
+    VectorDynSize zeroReference(4), state(4), controls(2);
+    zeroReference.zero();
+    getRandomVector(state, -2.0, 2.0);
+
+    LinearMPC mpc(createSystem());
+    ASSERT_IS_TRUE(mpc.setOptimizer(optimizer));
+    ASSERT_IS_TRUE(mpc.setHorizon(30, 0.05));
+    ASSERT_IS_TRUE(mpc.setFormulation(formulation));
+    ASSERT_IS_TRUE(mpc.setStageCost(createCost("stage", 1.0, 0.01, zeroReference)));
+
+    std::shared_ptr<LinearConstraint> controlBounds = std::make_shared<LinearConstraint>(2, "controlBounds");
+    MatrixDynSize identity(2, 2);
+    toEigen(identity).setIdentity();
+    ASSERT_IS_TRUE(controlBounds->setControlConstraintMatrix(identity));
+    VectorDynSize bound(2);
+    toEigen(bound).setConstant(0.5);
+    ASSERT_IS_TRUE(controlBounds->setUpperBound(bound));
+    toEigen(bound).setConstant(-0.5);
+    ASSERT_IS_TRUE(controlBounds->setLowerBound(bound));
+    ASSERT_IS_TRUE(mpc.addConstraint(controlBounds));
+
+    double initialNorm = toEigen(state).norm();
+    for (size_t tick = 0; tick < 100; ++tick) {
+        ASSERT_IS_TRUE(mpc.setStateFeedback(tick * 0.05, state));
+        ASSERT_IS_TRUE(mpc.doControl(controls));
+        ASSERT_IS_TRUE(toEigen(controls).cwiseAbs().maxCoeff() < 0.5 + 1e-4);
+        std::vector<VectorDynSize> states, controlsSequence;
+        ASSERT_IS_TRUE(mpc.getSolution(states, controlsSequence));
+        state = states[1];
+    }
+    ASSERT_IS_TRUE(toEigen(state).norm() < initialNorm);
+}
+
+int main() {
+    checkFormulation(LinearMPCFormulation::Sparse);
+    checkFormulation(LinearMPCFormulation::Condensed);
+    checkFormulationsAgree();
+    checkOsqp(LinearMPCFormulation::Sparse);
+    checkOsqp(LinearMPCFormulation::Condensed);
+    return EXIT_SUCCESS;
+}
@@ -13,6 +13,7 @@
 #include <iDynTree/DynamicalSystem.h>
 #include <iDynTree/Constraint.h>
 #include <iDynTree/Cost.h>
+#include <iDynTree/L2NormCost.h>
 #include <iDynTree/Optimizer.h>
 #include <iDynTree/OCSolvers/MultipleShootingSolver.h>
 #include <iDynTree/DynamicalSystem.h>
@@ -25,6 +26,9 @@
 #include <Eigen/Dense>
 #include <iDynTree/EigenHelpers.h>
 #include <string>
+#include <cmath>
+#include <memory>
+#include <vector>
 
 class TestSystem : public iDynTree::optimalcontrol::DynamicalSystem {
 public:
@@ -386,6 +390,22 @@ public:
 //        std::cerr << "Cost Jacobian" << std::endl << dummyMatrix.toString() << std::endl << std::endl;
         iDynTree::MatrixDynSize dummyHessian;
         ASSERT_IS_TRUE(m_problem->evaluateConstraintsHessian(dummy1, dummyHessian));
+
+        // The nonzero elements evaluated directly have to match the ones extracted from the dense matrices
+        iDynTree::VectorDynSize nonZeros, expectedNonZeros, multipliers(m_problem->numberOfConstraints());
+        iDynTree::getRandomVector(multipliers);
+        ASSERT_IS_TRUE(m_problem->evaluateConstraintsJacobianNonZeros(nonZeros));
+        ASSERT_IS_TRUE(m_problem->OptimizationProblem::evaluateConstraintsJacobianNonZeros(expectedNonZeros));
+        ASSERT_IS_TRUE(nonZeros.size() == nnzeroRows.size());
+        ASSERT_EQUAL_VECTOR(nonZeros, expectedNonZeros);
+        ASSERT_IS_TRUE(m_problem->evaluateCostHessianNonZeros(nonZeros));
+        ASSERT_IS_TRUE(m_problem->OptimizationProblem::evaluateCostHessianNonZeros(expectedNonZeros));
+        ASSERT_IS_TRUE(nonZeros.size() == dummy3.size());
+        ASSERT_EQUAL_VECTOR(nonZeros, expectedNonZeros);
+        ASSERT_IS_TRUE(m_problem->evaluateConstraintsHessianNonZeros(multipliers, nonZeros));
+        ASSERT_IS_TRUE(m_problem->OptimizationProblem::evaluateConstraintsHessianNonZeros(multipliers, expectedNonZeros));
+        ASSERT_IS_TRUE(nonZeros.size() == dummy3.size());
+        ASSERT_EQUAL_VECTOR(nonZeros, expectedNonZeros);
         return true;
     }
 
@@ -420,6 +440,148 @@ public:
 };
 OptimizerTest::~OptimizerTest() {}
 
+class NonLinearTestSystem : public iDynTree::optimalcontrol::DynamicalSystem {
+public:
+    NonLinearTestSystem() : iDynTree::optimalcontrol::DynamicalSystem(2,1) {}
+    ~NonLinearTestSystem() override;
+
+    virtual bool dynamics(const iDynTree::VectorDynSize &state, double time, iDynTree::VectorDynSize &stateDynamics) override {
+        stateDynamics(0) = state(0) * state(1) + controlInput()(0) + time;
+        stateDynamics(1) = std::sin(state(0)) * controlInput()(0);
+        return true;
+    }
+
+    virtual bool dynamicsStateFirstDerivative(const iDynTree::VectorDynSize& state,
+                                              double /*time*/,
+                                              iDynTree::MatrixDynSize& dynamicsDerivative) override {
+        dynamicsDerivative(0, 0) = state(1);
+        dynamicsDerivative(0, 1) = state(0);
+        dynamicsDerivative(1, 0) = std::cos(state(0)) * controlInput()(0);
+        dynamicsDerivative(1, 1) = 0.0;
+        return true;
+    }
+
+    virtual bool dynamicsControlFirstDerivative(const iDynTree::VectorDynSize& state,
+                                                double /*time*/,
+                                                iDynTree::MatrixDynSize& dynamicsDerivative) override {
+        dynamicsDerivative(0, 0) = 1.0;
+        dynamicsDerivative(1, 0) = std::sin(state(0));
+        return true;
+    }
+
+    virtual bool dynamicsSecondPartialDerivativeWRTState(double /*time*/,
+                                                         const iDynTree::VectorDynSize& state,
+                                                         const iDynTree::VectorDynSize& lambda,
+                                                         iDynTree::MatrixDynSize& partialDerivative) override {
+        partialDerivative.resize(2, 2);
+        partialDerivative(0, 0) = -lambda(1) * std::sin(state(0)) * controlInput()(0);
+        partialDerivative(0, 1) = lambda(0);
+        partialDerivative(1, 0) = lambda(0);
+        partialDerivative(1, 1) = 0.0;
+        return true;
+    }
+
+    virtual bool dynamicsSecondPartialDerivativeWRTControl(double /*time*/,
+                                                           const iDynTree::VectorDynSize& /*state*/,
+                                                           const iDynTree::VectorDynSize& /*lambda*/,
+                                                           iDynTree::MatrixDynSize& partialDerivative) override {
+        partialDerivative.resize(1, 1);
+        partialDerivative.zero();
+        return true;
+    }
+
+    virtual bool dynamicsSecondPartialDerivativeWRTStateControl(double /*time*/,
+                                                                const iDynTree::VectorDynSize& state,
+                                                                const iDynTree::VectorDynSize& lambda,
+                                                                iDynTree::MatrixDynSize& partialDerivative) override {
+        partialDerivative.resize(2, 1);
+        partialDerivative(0, 0) = lambda(1) * std::cos(state(0));
+        partialDerivative(1, 0) = 0.0;
+        return true;
+    }
+};
+NonLinearTestSystem::~NonLinearTestSystem(){}
+
+class TranscriptionAccessor : public iDynTree::optimization::Optimizer {
+public:
+    virtual bool isAvailable() const override {
+        return true;
+    }
+
+    virtual bool solve() override {
+        return false;
+    }
+
+    std::shared_ptr<iDynTree::optimization::OptimizationProblem> transcription() {
+        return m_problem;
+    }
+};
+
+void checkConcurrentCollocations() {
+    using namespace iDynTree::optimalcontrol;
+
+    std::shared_ptr<OptimalControlProblem> problem = std::make_shared<OptimalControlProblem>();
+    std::shared_ptr<NonLinearTestSystem> system = std::make_shared<NonLinearTestSystem>();
+    ASSERT_IS_TRUE(problem->setTimeHorizon(0.0, 1.0));
+    ASSERT_IS_TRUE(problem->setDynamicalSystemConstraint(system));
+    ASSERT_IS_TRUE(problem->addLagrangeTerm(1.0, std::make_shared<L2NormCost>("normCost", 2, 1)));
+
+    MultipleShootingSolver solver(problem);
+    std::shared_ptr<TranscriptionAccessor> accessor = std::make_shared<TranscriptionAccessor>();
+    ASSERT_IS_TRUE(solver.setIntegrator(std::make_shared<integrators::ForwardEuler>()));
+    ASSERT_IS_TRUE(solver.setStepSizeBounds(0.004, 0.02));
+    ASSERT_IS_TRUE(solver.setControlPeriod(0.01));
+    ASSERT_IS_TRUE(solver.setOptimizer(accessor));
+
+    std::shared_ptr<iDynTree::optimization::OptimizationProblem> transcription = accessor->transcription();
+    ASSERT_IS_TRUE(transcription->prepare());
+
+    iDynTree::VectorDynSize variables(transcription->numberOfVariables()), multipliers(transcription->numberOfConstraints());
+    iDynTree::getRandomVector(variables);
+    iDynTree::getRandomVector(multipliers);
+
+    iDynTree::VectorDynSize expectedConstraints, expectedJacobian, expectedHessian;
+    ASSERT_IS_TRUE(transcription->setVariables(variables));
+    ASSERT_IS_TRUE(transcription->evaluateConstraints(expectedConstraints));
+    ASSERT_IS_TRUE(transcription->evaluateConstraintsJacobianNonZeros(expectedJacobian));
+    ASSERT_IS_TRUE(transcription->evaluateConstraintsHessianNonZeros(multipliers, expectedHessian));
+
+    // Each worker integrator needs its own dynamical system
+    std::shared_ptr<integrators::ForwardEuler> sharedSystemIntegrator = std::make_shared<integrators::ForwardEuler>(system);
+    ASSERT_IS_TRUE(solver.setWorkerIntegrators({sharedSystemIntegrator}));
+    ASSERT_IS_FALSE(transcription->prepare());
+
+    std::vector<std::shared_ptr<Integrator>> workerIntegrators;
+    for (size_t i = 0; i < 3; ++i) {
+        workerIntegrators.push_back(std::make_shared<integrators::ForwardEuler>(std::make_shared<NonLinearTestSystem>()));
+    }
+    ASSERT_IS_FALSE(solver.setWorkerIntegrators({workerIntegrators[0], workerIntegrators[0]}));
+    ASSERT_IS_TRUE(solver.setWorkerIntegrators(workerIntegrators));
+    ASSERT_IS_TRUE(transcription->prepare());
+
+    iDynTree::VectorDynSize constraints, jacobian, hessian;
+    iDynTree::MatrixDynSize denseJacobian, expectedDenseJacobian;
+    for (size_t i = 0; i < 2; ++i) {
+        ASSERT_IS_TRUE(transcription->setVariables(variables));
+        ASSERT_IS_TRUE(transcription->evaluateConstraints(constraints));
+        ASSERT_EQUAL_VECTOR(constraints, expectedConstraints);
+        ASSERT_IS_TRUE(transcription->evaluateConstraintsJacobianNonZeros(jacobian));
+        ASSERT_EQUAL_VECTOR(jacobian, expectedJacobian);
+        ASSERT_IS_TRUE(transcription->evaluateConstraintsHessianNonZeros(multipliers, hessian));
+        ASSERT_EQUAL_VECTOR(hessian, expectedHessian);
+    }
+
+    ASSERT_IS_TRUE(solver.setWorkerIntegrators({}));
+    ASSERT_IS_TRUE(transcription->prepare());
+    ASSERT_IS_TRUE(transcription->setVariables(variables));
+    ASSERT_IS_TRUE(transcription->evaluateConstraintsJacobian(expectedDenseJacobian));
+    ASSERT_IS_TRUE(solver.setWorkerIntegrators(workerIntegrators));
+    ASSERT_IS_TRUE(transcription->prepare());
+    ASSERT_IS_TRUE(transcription->setVariables(variables));
+    ASSERT_IS_TRUE(transcription->evaluateConstraintsJacobian(denseJacobian));
+    ASSERT_EQUAL_MATRIX(denseJacobian, expectedDenseJacobian);
+}
+
 
 
 int main(){
@@ -497,7 +659,11 @@ int main(){
 
     ASSERT_IS_TRUE(solver.solve());
 
+    solver.addCostsHessianRegularization(0.1);
+    solver.addConstraintsHessianRegularization(0.2);
+    ASSERT_IS_TRUE(solver.solve());
 
+    checkConcurrentCollocations();
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef IDYNTREE_LINK_DISTANCE_QUERIES_H
+#define IDYNTREE_LINK_DISTANCE_QUERIES_H
+
+#include <iDynTree/Indices.h>
+#include <iDynTree/Position.h>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace iDynTree
+{
+class Model;
+class LinkPositions;
+
+/**
+ * Options of LinkDistanceQueries.
+ */
+struct LinkDistanceQueriesOptions
+{
+    /**
+     * Pairs of links farther than this distance (in meters) are culled and
+     * not reported by LinkDistanceQueries::computeAllDistances (default: infinity, i.e. all the pairs are reported).
+     * A finite value permits to skip most of the pairs in the broad phase.
+     */
+    double maxDistance;
+
+    /**
+     * If true, the pairs of links connected by a joint are added to the allowed collisions (default: true).
+     */
+    bool allowCollisionsBetweenAdjacentLinks;
+
+    LinkDistanceQueriesOptions(): maxDistance(std::numeric_limits<double>::infinity()),
+                                  allowCollisionsBetweenAdjacentLinks(true)
+    {
+    }
+};
+
+/**
+ * Minimum distance between the collision shapes of two links.
+ */
+struct LinkPairDistance
+{
+    LinkIndex firstLink{LINK_INVALID_INDEX};
+    LinkIndex secondLink{LINK_INVALID_INDEX};
+
+    /**
+     * Minimum distance between the two links, 0 if they are in collision.
+     */
+    double distance{0.0};
+
+    /**
+     * Closest point of the first link, expressed in the world frame.
+     */
+    Position firstLinkClosestPoint{Position::Zero()};
+
+    /**
+     * Closest point of the second link, expressed in the world frame.
+     */
+    Position secondLinkClosestPoint{Position::Zero()};
+};
+
+/**
+ * Compute the minimum distance and the closest points between the collision shapes of the links of a model.
+ *
+ * The collision shapes of each link are organized once in a bounding volume hierarchy (BVH),
+ * whose bounding boxes are refitted each time the link positions are updated. computeAllDistances
+ * culls the pairs of links with a sweep-and-prune on the bounding boxes of the links, then for each
+ * remaining pair it traverses the two BVHs, computing the distance between the shapes
+ * with the GJK algorithm only when their bounding boxes are closer than the current minimum.
+ *
+ * The pairs in the allowed collision matrix are not checked. By default it contains the pairs
+ * of links connected by a joint, and it can be modified with setAllowedCollision.
+ *
+ * Spheres, boxes and cylinders are handled exactly, while the meshes are approximated with their bounding box
+ * (see computeBoundingBoxFromShape). The penetration depth of intersecting shapes is not computed.
+ *
+ * Once the model is loaded, updateLinkPositions and the distance computations do not allocate memory.
+ *
+ * Example:
+ * ~~~{.cpp}
+ * iDynTree::LinkDistanceQueries distanceQueries;
+ * distanceQueries.loadModel(model);
+ * // in the control loop
+ * iDynTree::ForwardPositionKinematics(model, traversal, world_H_base, jointPos, linkPositions);
+ * distanceQueries.updateLinkPositions(linkPositions);
+ * distanceQueries.computeAllDistances();
+ * iDynTree::LinkPairDistance closestPair;
+ * distanceQueries.getMinimumDistance(closestPair);
+ * ~~~
+ */
+class LinkDistanceQueries
+{
+    struct LinkDistanceQueriesPimpl;
+    LinkDistanceQueriesPimpl * pimpl;
+
+    // copy is disabled
+    LinkDistanceQueries(const LinkDistanceQueries& other) = delete;
+    LinkDistanceQueries& operator=(const LinkDistanceQueries& other) = delete;
+
+public:
+    LinkDistanceQueries();
+    ~LinkDistanceQueries();
+
+    /**
+     * Build the bounding volume hierarchies from the collision shapes of the model.
+     *
+     * The link positions are initialized to the identity.
+     * @return true if all went well, false otherwise (for example if the bounding box of a mesh could not be computed).
+     */
+    bool loadModel(const Model& model, const LinkDistanceQueriesOptions& options = LinkDistanceQueriesOptions());
+
+    /**
+     * Return true if a model has been successfully loaded.
+     */
+    bool isValid() const;
+
+    /**
+     * Add (or remove) a pair of links to the allowed collision matrix, i.e. the pairs of links
+     * that are not checked by computeAllDistances.
+     *
+     * @return true if all went well, false if the link indices are not valid.
+     */
+    bool setAllowedCollision(const LinkIndex firstLink, const LinkIndex secondLink, const bool allowed);
+
+    /**
+     * Return true if the pair of links is in the allowed collision matrix.
+     */
+    bool isCollisionAllowed(const LinkIndex firstLink, const LinkIndex secondLink) const;
+
+    /**
+     * Get the number of pairs of links checked by computeAllDistances, i.e. the pairs of links with at least
+     * one collision shape each that are not in the allowed collision matrix.
+     */
+    size_t getNrOfCheckedLinkPairs() const;
+
+    /**
+     * Update the world_H_link transforms, refitting the bounding volume hierarchies.
+     *
+     * @param[in] world_H_links the position of all the links of the model, as computed by ForwardPositionKinematics.
+     * @return true if all went well, false otherwise.
+     */
+    bool updateLinkPositions(const LinkPositions& world_H_links);
+
+    /**
+     * Compute the minimum distance between two links, regardless of the allowed collision matrix
+     * and of the maximum distance.
+     *
+     * @return true if all went well, false if the links are not valid or do not have collision shapes.
+     */
+    bool computeDistance(const LinkIndex firstLink, const LinkIndex secondLink, LinkPairDistance& linkPairDistance);
+
+    /**
+     * Compute the minimum distance of all the checked pairs of links that are closer than
+     * LinkDistanceQueriesOptions::maxDistance. The results are available with getDistances.
+     *
+     * @return true if all went well, false otherwise.
+     */
+    bool computeAllDistances();
+
+    /**
+     * Get the distances computed by the last call to computeAllDistances.
+     *
+     * The order of the pairs is not specified, but in each pair firstLink < secondLink.
+     */
+    const std::vector<LinkPairDistance>& getDistances() const;
+
+    /**
+     * Get the closest pair of links computed by the last call to computeAllDistances.
+     *
+     * @return true if at least a pair of links is closer than LinkDistanceQueriesOptions::maxDistance, false otherwise.
+     */
+    bool getMinimumDistance(LinkPairDistance& minimumDistance) const;
+};
+
+}
+
+#endif
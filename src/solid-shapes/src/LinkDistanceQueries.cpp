@@ -0,0 +1,950 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/LinkDistanceQueries.h>
+
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/InertialParametersSolidShapesHelpers.h>
+#include <iDynTree/LinkState.h>
+#include <iDynTree/Model.h>
+#include <iDynTree/SolidShapes.h>
+#include <iDynTree/Utils.h>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace iDynTree
+{
+
+namespace
+{
+
+enum class ConvexPrimitiveType
+{
+    Sphere,
+    Box,
+    Cylinder
+};
+
+/**
+ * Convex shape described by its support function.
+ *
+ * The spheres are handled as a point with a margin equal to the radius,
+ * that is added to the distance computed by the GJK algorithm.
+ */
+struct ConvexPrimitive
+{
+    ConvexPrimitiveType type;
+    // Box: half length of the sides, Cylinder: (radius, radius, half length)
+    Eigen::Vector3d halfSize;
+    double margin;
+    Eigen::Matrix3d link_R_geometry;
+    Eigen::Vector3d link_p_geometry;
+    Eigen::Matrix3d world_R_geometry;
+    Eigen::Vector3d world_p_geometry;
+};
+
+struct AxisAlignedBox
+{
+    Eigen::Vector3d center;
+    Eigen::Vector3d halfExtents;
+};
+
+struct BVHNode
+{
+    AxisAlignedBox worldBox;
+    // The children have always an index greater than the parent, so the refit can go backward
+    int firstChild{-1};
+    int secondChild{-1};
+    int primitive{-1};
+
+    bool isLeaf() const
+    {
+        return primitive >= 0;
+    }
+};
+
+/**
+ * Collision shapes of a link, the root of the BVH is the first node.
+ */
+struct LinkGeometry
+{
+    std::vector<ConvexPrimitive> primitives;
+    std::vector<BVHNode> nodes;
+};
+
+struct SimplexVertex
+{
+    // Vertex of the Minkowski difference, and the points of the two shapes that generated it
+    Eigen::Vector3d w{Eigen::Vector3d::Zero()};
+    Eigen::Vector3d a{Eigen::Vector3d::Zero()};
+    Eigen::Vector3d b{Eigen::Vector3d::Zero()};
+};
+
+struct Simplex
+{
+    SimplexVertex vertices[4];
+    double barycentricCoordinates[4]{};
+    int size{0};
+};
+
+struct PrimitivesDistance
+{
+    double distance;
+    Eigen::Vector3d firstPoint;
+    Eigen::Vector3d secondPoint;
+};
+
+const int gjkMaxIterations = 64;
+// Relative tolerance on the gap between the upper and lower bound of the distance
+const double gjkRelativeTolerance = 1e-8;
+// Squared distance below which the shapes are considered in contact
+const double gjkContactTolerance = 1e-18;
+
+Eigen::Vector3d supportPoint(const ConvexPrimitive& primitive,
+                             const Eigen::Matrix3d& R,
+                             const Eigen::Vector3d& p,
+                             const Eigen::Vector3d& direction)
+{
+    if (primitive.type == ConvexPrimitiveType::Sphere)
+    {
+        return p;
+    }
+
+    Eigen::Vector3d localDirection = R.transpose() * direction;
+    Eigen::Vector3d localSupport;
+    if (primitive.type == ConvexPrimitiveType::Box)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            localSupport(i) = localDirection(i) >= 0.0 ? primitive.halfSize(i) : -primitive.halfSize(i);
+        }
+    }
+    else
+    {
+        double radialNorm = std::sqrt(localDirection(0) * localDirection(0) + localDirection(1) * localDirection(1));
+        if (radialNorm > 0.0)
+        {
+            localSupport(0) = primitive.halfSize(0) * localDirection(0) / radialNorm;
+            localSupport(1) = primitive.halfSize(0) * localDirection(1) / radialNorm;
+        }
+        else
+        {
+            localSupport(0) = 0.0;
+            localSupport(1) = 0.0;
+        }
+        localSupport(2) = localDirection(2) >= 0.0 ? primitive.halfSize(2) : -primitive.halfSize(2);
+    }
+
+    return R * localSupport + p;
+}
+
+AxisAlignedBox computePrimitiveBox(const ConvexPrimitive& primitive,
+                                   const Eigen::Matrix3d& R,
+                                   const Eigen::Vector3d& p)
+{
+    Eigen::Vector3d minimum, maximum;
+    for (int i = 0; i < 3; i++)
+    {
+        Eigen::Vector3d axis = Eigen::Vector3d::Unit(i);
+        maximum(i) = supportPoint(primitive, R, p, axis)(i) + primitive.margin;
+        minimum(i) = supportPoint(primitive, R, p, -axis)(i) - primitive.margin;
+    }
+
+    AxisAlignedBox box;
+    box.center = 0.5 * (maximum + minimum);
+    box.halfExtents = 0.5 * (maximum - minimum);
+    return box;
+}
+
+AxisAlignedBox mergeBoxes(const AxisAlignedBox& first, const AxisAlignedBox& second)
+{
+    Eigen::Vector3d minimum = (first.center - first.halfExtents).cwiseMin(second.center - second.halfExtents);
+    Eigen::Vector3d maximum = (first.center + first.halfExtents).cwiseMax(second.center + second.halfExtents);
+
+    AxisAlignedBox box;
+    box.center = 0.5 * (maximum + minimum);
+    box.halfExtents = 0.5 * (maximum - minimum);
+    return box;
+}
+
+/**
+ * Lower bound of the distance between the content of two boxes.
+ */
+double boxesDistance(const AxisAlignedBox& first, const AxisAlignedBox& second)
+{
+    Eigen::Vector3d gap = ((first.center - second.center).cwiseAbs() - first.halfExtents - second.halfExtents).cwiseMax(0.0);
+    return gap.norm();
+}
+
+/**
+ * Build the subtree of the primitives in [begin, end), splitting them at the median
+ * along the axis in which the centers of their boxes are more spread.
+ */
+int buildBVHNode(std::vector<int>& primitives,
+                 const size_t begin,
+                 const size_t end,
+                 const std::vector<AxisAlignedBox>& localBoxes,
+                 std::vector<BVHNode>& nodes)
+{
+    int nodeIndex = static_cast<int>(nodes.size());
+    nodes.emplace_back();
+
+    if (end - begin == 1)
+    {
+        nodes[nodeIndex].primitive = primitives[begin];
+        return nodeIndex;
+    }
+
+    Eigen::Vector3d minimumCenter = localBoxes[primitives[begin]].center;
+    Eigen::Vector3d maximumCenter = minimumCenter;
+    for (size_t i = begin + 1; i < end; i++)
+    {
+        minimumCenter = minimumCenter.cwiseMin(localBoxes[primitives[i]].center);
+        maximumCenter = maximumCenter.cwiseMax(localBoxes[primitives[i]].center);
+    }
+    Eigen::Index splitAxis;
+    (maximumCenter - minimumCenter).maxCoeff(&splitAxis);
+
+    size_t middle = begin + (end - begin) / 2;
+    std::nth_element(primitives.begin() + begin, primitives.begin() + middle, primitives.begin() + end,
+                     [&localBoxes, splitAxis](int first, int second) {
+                         return localBoxes[first].center(splitAxis) < localBoxes[second].center(splitAxis);
+                     });
+
+    int firstChild = buildBVHNode(primitives, begin, middle, localBoxes, nodes);
+    int secondChild = buildBVHNode(primitives, middle, end, localBoxes, nodes);
+    nodes[nodeIndex].firstChild = firstChild;
+    nodes[nodeIndex].secondChild = secondChild;
+    return nodeIndex;
+}
+
+void setSimplexVertex(Simplex& simplex, const SimplexVertex& vertex)
+{
+    simplex.vertices[0] = vertex;
+    simplex.barycentricCoordinates[0] = 1.0;
+    simplex.size = 1;
+}
+
+void setSimplexEdge(Simplex& simplex, const SimplexVertex& first, const SimplexVertex& second, const double t)
+{
+    simplex.vertices[0] = first;
+    simplex.vertices[1] = second;
+    simplex.barycentricCoordinates[0] = 1.0 - t;
+    simplex.barycentricCoordinates[1] = t;
+    simplex.size = 2;
+}
+
+/**
+ * Closest point to the origin of the segment (a, b), stored in simplex as the vertices of the closest feature.
+ */
+void closestPointOnSegment(const SimplexVertex& a, const SimplexVertex& b, Simplex& simplex)
+{
+    Eigen::Vector3d ab = b.w - a.w;
+    double t = -a.w.dot(ab);
+    double squaredLength = ab.squaredNorm();
+    if (t <= 0.0 || squaredLength <= 0.0)
+    {
+        setSimplexVertex(simplex, a);
+    }
+    else if (t >= squaredLength)
+    {
+        setSimplexVertex(simplex, b);
+    }
+    else
+    {
+        setSimplexEdge(simplex, a, b, t / squaredLength);
+    }
+}
+
+/**
+ * Closest point to the origin of the triangle (a, b, c), see Ericson, Real-Time Collision Detection, Section 5.1.5.
+ */
+void closestPointOnTriangle(const SimplexVertex& a, const SimplexVertex& b, const SimplexVertex& c, Simplex& simplex)
+{
+    Eigen::Vector3d ab = b.w - a.w;
+    Eigen::Vector3d ac = c.w - a.w;
+
+    double d1 = -ab.dot(a.w);
+    double d2 = -ac.dot(a.w);
+    if (d1 <= 0.0 && d2 <= 0.0)
+    {
+        setSimplexVertex(simplex, a);
+        return;
+    }
+
+    double d3 = -ab.dot(b.w);
+    double d4 = -ac.dot(b.w);
+    if (d3 >= 0.0 && d4 <= d3)
+    {
+        setSimplexVertex(simplex, b);
+        return;
+    }
+
+    double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+    {
+        setSimplexEdge(simplex, a, b, d1 / (d1 - d3));
+        return;
+    }
+
+    double d5 = -ab.dot(c.w);
+    double d6 = -ac.dot(c.w);
+    if (d6 >= 0.0 && d5 <= d6)
+    {
+        setSimplexVertex(simplex, c);
+        return;
+    }
+
+    double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+    {
+        setSimplexEdge(simplex, a, c, d2 / (d2 - d6));
+        return;
+    }
+
+    double va = d3 * d6 - d5 * d4;
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+    {
+        setSimplexEdge(simplex, b, c, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        return;
+    }
+
+    double denominator = va + vb + vc;
+    if (denominator <= 0.0)
+    {
+        // Degenerate triangle, fall back to its longest edge
+        closestPointOnSegment(a, (ab.squaredNorm() >= ac.squaredNorm()) ? b : c, simplex);
+        return;
+    }
+    simplex.vertices[0] = a;
+    simplex.vertices[1] = b;
+    simplex.vertices[2] = c;
+    simplex.barycentricCoordinates[1] = vb / denominator;
+    simplex.barycentricCoordinates[2] = vc / denominator;
+    simplex.barycentricCoordinates[0] = 1.0 - simplex.barycentricCoordinates[1] - simplex.barycentricCoordinates[2];
+    simplex.size = 3;
+}
+
+/**
+ * Closest point to the origin of the tetrahedron in simplex, checking the faces that have the origin
+ * on their outer side. If the origin is inside the tetrahedron, the simplex is left unchanged.
+ */
+void closestPointOnTetrahedron(Simplex& simplex)
+{
+    const SimplexVertex* v = simplex.vertices;
+    const int faces[4][4] = {{0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 3, 1}, {1, 2, 3, 0}};
+
+    double volume = (v[1].w - v[0].w).cross(v[2].w - v[0].w).dot(v[3].w - v[0].w);
+    bool isDegenerate = std::abs(volume) <= 1e-14 * (v[1].w - v[0].w).squaredNorm() * (v[3].w - v[0].w).norm();
+
+    Simplex closestFace{};
+    bool isClosestFaceSelected = false;
+    double closestSquaredDistance = std::numeric_limits<double>::infinity();
+    bool isOriginInside = true;
+    for (const auto& face : faces)
+    {
+        const SimplexVertex& a = v[face[0]];
+        const SimplexVertex& b = v[face[1]];
+        const SimplexVertex& c = v[face[2]];
+        const SimplexVertex& opposite = v[face[3]];
+        Eigen::Vector3d normal = (b.w - a.w).cross(c.w - a.w);
+        double originSide = -normal.dot(a.w);
+        double oppositeSide = normal.dot(opposite.w - a.w);
+        if (!isDegenerate && originSide * oppositeSide >= 0.0)
+        {
+            continue;
+        }
+
+        isOriginInside = false;
+        Simplex faceSimplex{};
+        closestPointOnTriangle(a, b, c, faceSimplex);
+        Eigen::Vector3d point = Eigen::Vector3d::Zero();
+        for (int i = 0; i < faceSimplex.size; i++)
+        {
+            point += faceSimplex.barycentricCoordinates[i] * faceSimplex.vertices[i].w;
+        }
+        if (point.squaredNorm() < closestSquaredDistance)
+        {
+            closestSquaredDistance = point.squaredNorm();
+            closestFace = faceSimplex;
+            isClosestFaceSelected = true;
+        }
+    }
+
+    if (!isOriginInside)
+    {
+        if (isClosestFaceSelected)
+        {
+            simplex = closestFace;
+        }
+        else
+        {
+            // All the face distances are NaN: keep the current simplex, with well defined coordinates
+            for (int i = 0; i < 4; i++)
+            {
+                simplex.barycentricCoordinates[i] = 0.25;
+            }
+        }
+        return;
+    }
+
+    // The barycentric coordinates of the origin are the ratios of the volumes
+    for (int i = 0; i < 4; i++)
+    {
+        const int* face = faces[3 - i];
+        double subVolume = (v[face[1]].w - v[face[0]].w).cross(v[face[2]].w - v[face[0]].w).dot(-v[face[0]].w);
+        double oppositeVolume = (v[face[1]].w - v[face[0]].w).cross(v[face[2]].w - v[face[0]].w).dot(v[i].w - v[face[0]].w);
+        simplex.barycentricCoordinates[i] = subVolume / oppositeVolume;
+    }
+}
+
+/**
+ * Reduce the simplex to the vertices of its feature closest to the origin, and return the closest point.
+ */
+Eigen::Vector3d reduceSimplex(Simplex& simplex)
+{
+    switch (simplex.size)
+    {
+        case 1:
+            simplex.barycentricCoordinates[0] = 1.0;
+            break;
+        case 2:
+        {
+            SimplexVertex a = simplex.vertices[0], b = simplex.vertices[1];
+            closestPointOnSegment(a, b, simplex);
+            break;
+        }
+        case 3:
+        {
+            SimplexVertex a = simplex.vertices[0], b = simplex.vertices[1], c = simplex.vertices[2];
+            closestPointOnTriangle(a, b, c, simplex);
+            break;
+        }
+        default:
+            closestPointOnTetrahedron(simplex);
+            break;
+    }
+
+    Eigen::Vector3d point = Eigen::Vector3d::Zero();
+    for (int i = 0; i < simplex.size; i++)
+    {
+        point += simplex.barycentricCoordinates[i] * simplex.vertices[i].w;
+    }
+    return point;
+}
+
+/**
+ * Distance between two primitives with the GJK algorithm, see van den Bergen,
+ * "A Fast and Robust GJK Implementation for Collision Detection of Convex Objects".
+ */
+void computePrimitivesDistance(const ConvexPrimitive& first, const ConvexPrimitive& second, PrimitivesDistance& result)
+{
+    Simplex simplex{};
+    Eigen::Vector3d v = first.world_p_geometry - second.world_p_geometry;
+    if (v.squaredNorm() <= gjkContactTolerance)
+    {
+        v = Eigen::Vector3d::UnitX();
+    }
+
+    bool inContact = false;
+    double previousSquaredNorm = 0.0;
+    for (int iteration = 0; iteration < gjkMaxIterations; iteration++)
+    {
+        SimplexVertex vertex;
+        vertex.a = supportPoint(first, first.world_R_geometry, first.world_p_geometry, -v);
+        vertex.b = supportPoint(second, second.world_R_geometry, second.world_p_geometry, v);
+        vertex.w = vertex.a - vertex.b;
+
+        // v is the closest point of the current simplex: stop if the new vertex does not get closer to the origin
+        if (simplex.size > 0 && v.squaredNorm() - v.dot(vertex.w) <= gjkRelativeTolerance * v.squaredNorm())
+        {
+            break;
+        }
+
+        simplex.vertices[simplex.size] = vertex;
+        simplex.size++;
+        v = reduceSimplex(simplex);
+
+        double squaredNorm = v.squaredNorm();
+        if (simplex.size == 4 || squaredNorm <= gjkContactTolerance)
+        {
+            inContact = true;
+            break;
+        }
+        if (iteration > 0 && previousSquaredNorm - squaredNorm <= gjkRelativeTolerance * previousSquaredNorm)
+        {
+            break;
+        }
+        previousSquaredNorm = squaredNorm;
+    }
+
+    result.firstPoint.setZero();
+    result.secondPoint.setZero();
+    for (int i = 0; i < simplex.size; i++)
+    {
+        result.firstPoint += simplex.barycentricCoordinates[i] * simplex.vertices[i].a;
+        result.secondPoint += simplex.barycentricCoordinates[i] * simplex.vertices[i].b;
+    }
+
+    if (inContact)
+    {
+        result.distance = 0.0;
+        result.secondPoint = result.firstPoint;
+        return;
+    }
+
+    double coresDistance = std::sqrt(v.squaredNorm());
+    // v goes from the second to the first shape
+    Eigen::Vector3d direction = -v / coresDistance;
+    result.firstPoint += first.margin * direction;
+    result.secondPoint -= second.margin * direction;
+    result.distance = std::max(0.0, coresDistance - first.margin - second.margin);
+}
+
+bool convexPrimitiveFromShape(const SolidShape& shape, ConvexPrimitive& primitive)
+{
+    const SolidShape* approximatedShape = &shape;
+    Box boundingBox;
+    if (shape.isExternalMesh())
+    {
+        if (!computeBoundingBoxFromShape(shape, boundingBox))
+        {
+            return false;
+        }
+        approximatedShape = &boundingBox;
+    }
+
+    primitive.halfSize.setZero();
+    primitive.margin = 0.0;
+    if (approximatedShape->isSphere())
+    {
+        primitive.type = ConvexPrimitiveType::Sphere;
+        primitive.margin = approximatedShape->asSphere()->getRadius();
+    }
+    else if (approximatedShape->isBox())
+    {
+        const Box* box = approximatedShape->asBox();
+        primitive.type = ConvexPrimitiveType::Box;
+        primitive.halfSize << 0.5 * box->getX(), 0.5 * box->getY(), 0.5 * box->getZ();
+    }
+    else if (approximatedShape->isCylinder())
+    {
+        const Cylinder* cylinder = approximatedShape->asCylinder();
+        primitive.type = ConvexPrimitiveType::Cylinder;
+        primitive.halfSize << cylinder->getRadius(), cylinder->getRadius(), 0.5 * cylinder->getLength();
+    }
+    else
+    {
+        return false;
+    }
+
+    const Transform& link_H_geometry = approximatedShape->getLink_H_geometry();
+    primitive.link_R_geometry = toEigen(link_H_geometry.getRotation());
+    primitive.link_p_geometry = toEigen(link_H_geometry.getPosition());
+    primitive.world_R_geometry = primitive.link_R_geometry;
+    primitive.world_p_geometry = primitive.link_p_geometry;
+    return true;
+}
+
+}
+
+struct LinkDistanceQueries::LinkDistanceQueriesPimpl
+{
+    bool isValid{false};
+    LinkDistanceQueriesOptions options;
+    size_t nrOfLinks{0};
+
+    // One for each link of the model, without primitives if the link has no collision shapes
+    std::vector<LinkGeometry> linkGeometries;
+    std::vector<LinkIndex> linksWithShapes;
+    // nrOfLinks x nrOfLinks symmetric matrix
+    std::vector<bool> allowedCollisions;
+
+    // linksWithShapes sorted by the minimum x of their bounding box, used by the sweep and prune
+    std::vector<LinkIndex> sweepOrder;
+
+    std::vector<LinkPairDistance> distances;
+    LinkPairDistance minimumDistance;
+    bool hasMinimumDistance{false};
+
+    void updateLinkPosition(const LinkIndex link, const Eigen::Matrix3d& world_R_link, const Eigen::Vector3d& world_p_link)
+    {
+        LinkGeometry& geometry = linkGeometries[link];
+        for (auto& primitive : geometry.primitives)
+        {
+            primitive.world_R_geometry = world_R_link * primitive.link_R_geometry;
+            primitive.world_p_geometry = world_R_link * primitive.link_p_geometry + world_p_link;
+        }
+
+        // Refit the BVH from the leaves to the root
+        for (size_t i = geometry.nodes.size(); i-- > 0;)
+        {
+            BVHNode& node = geometry.nodes[i];
+            if (node.isLeaf())
+            {
+                const ConvexPrimitive& primitive = geometry.primitives[node.primitive];
+                node.worldBox = computePrimitiveBox(primitive, primitive.world_R_geometry, primitive.world_p_geometry);
+            }
+            else
+            {
+                node.worldBox = mergeBoxes(geometry.nodes[node.firstChild].worldBox,
+                                           geometry.nodes[node.secondChild].worldBox);
+            }
+        }
+    }
+
+    void computeNodesDistance(const LinkGeometry& first, const int firstNodeIndex,
+                              const LinkGeometry& second, const int secondNodeIndex,
+                              PrimitivesDistance& closest, bool& found)
+    {
+        const BVHNode& firstNode = first.nodes[firstNodeIndex];
+        const BVHNode& secondNode = second.nodes[secondNodeIndex];
+
+        if (firstNode.isLeaf() && secondNode.isLeaf())
+        {
+            PrimitivesDistance primitivesDistance;
+            computePrimitivesDistance(first.primitives[firstNode.primitive],
+                                      second.primitives[secondNode.primitive], primitivesDistance);
+            if (found ? primitivesDistance.distance < closest.distance : primitivesDistance.distance <= closest.distance)
+            {
+                closest = primitivesDistance;
+                found = true;
+            }
+            return;
+        }
+
+        // Descend in the larger node, visiting first the closest child
+        bool descendFirst = !firstNode.isLeaf() &&
+            (secondNode.isLeaf() || firstNode.worldBox.halfExtents.sum() >= secondNode.worldBox.halfExtents.sum());
+        const LinkGeometry& descended = descendFirst ? first : second;
+        const BVHNode& descendedNode = descendFirst ? firstNode : secondNode;
+        const AxisAlignedBox& otherBox = descendFirst ? secondNode.worldBox : firstNode.worldBox;
+
+        int children[2] = {descendedNode.firstChild, descendedNode.secondChild};
+        double childrenDistances[2] = {boxesDistance(descended.nodes[children[0]].worldBox, otherBox),
+                                       boxesDistance(descended.nodes[children[1]].worldBox, otherBox)};
+        if (childrenDistances[1] < childrenDistances[0])
+        {
+            std::swap(children[0], children[1]);
+            std::swap(childrenDistances[0], childrenDistances[1]);
+        }
+
+        for (int i = 0; i < 2; i++)
+        {
+            if (childrenDistances[i] > closest.distance)
+            {
+                continue;
+            }
+            if (descendFirst)
+            {
+                computeNodesDistance(first, children[i], second, secondNodeIndex, closest, found);
+            }
+            else
+            {
+                computeNodesDistance(first, firstNodeIndex, second, children[i], closest, found);
+            }
+        }
+    }
+
+    /**
+     * Return false if the links are farther than maxDistance.
+     */
+    bool computeLinkPairDistance(const LinkIndex firstLink, const LinkIndex secondLink,
+                                 const double maxDistance, LinkPairDistance& linkPairDistance)
+    {
+        const LinkGeometry& first = linkGeometries[firstLink];
+        const LinkGeometry& second = linkGeometries[secondLink];
+        if (boxesDistance(first.nodes[0].worldBox, second.nodes[0].worldBox) > maxDistance)
+        {
+            return false;
+        }
+
+        PrimitivesDistance closest;
+        closest.distance = maxDistance;
+        bool found = false;
+        computeNodesDistance(first, 0, second, 0, closest, found);
+        if (!found)
+        {
+            return false;
+        }
+
+        bool swapLinks = secondLink < firstLink;
+        linkPairDistance.firstLink = swapLinks ? secondLink : firstLink;
+        linkPairDistance.secondLink = swapLinks ? firstLink : secondLink;
+        linkPairDistance.distance = closest.distance;
+        toEigen(linkPairDistance.firstLinkClosestPoint) = swapLinks ? closest.secondPoint : closest.firstPoint;
+        toEigen(linkPairDistance.secondLinkClosestPoint) = swapLinks ? closest.firstPoint : closest.secondPoint;
+        return true;
+    }
+
+    double minimumX(const LinkIndex link) const
+    {
+        const AxisAlignedBox& box = linkGeometries[link].nodes[0].worldBox;
+        return box.center(0) - box.halfExtents(0);
+    }
+};
+
+LinkDistanceQueries::LinkDistanceQueries(): pimpl(new LinkDistanceQueriesPimpl)
+{
+}
+
+LinkDistanceQueries::~LinkDistanceQueries()
+{
+    delete pimpl;
+    pimpl = nullptr;
+}
+
+bool LinkDistanceQueries::loadModel(const Model& model, const LinkDistanceQueriesOptions& options)
+{
+    pimpl->isValid = false;
+
+    const ModelSolidShapes& collisionShapes = model.collisionSolidShapes();
+    if (!collisionShapes.isConsistent(model))
+    {
+        reportError("LinkDistanceQueries", "loadModel", "The collision shapes are not consistent with the model.");
+        return false;
+    }
+
+    if (std::isnan(options.maxDistance) || options.maxDistance < 0.0)
+    {
+        reportError("LinkDistanceQueries", "loadModel", "The maximum distance should be a non negative number.");
+        return false;
+    }
+
+    pimpl->options = options;
+    pimpl->nrOfLinks = model.getNrOfLinks();
+    pimpl->linkGeometries.clear();
+    pimpl->linkGeometries.resize(pimpl->nrOfLinks);
+    pimpl->linksWithShapes.clear();
+
+    const std::vector<std::vector<SolidShape*>>& linkShapes = collisionShapes.getLinkSolidShapes();
+    std::vector<AxisAlignedBox> localBoxes;
+    std::vector<int> primitivesIndices;
+    for (LinkIndex link = 0; link < static_cast<LinkIndex>(pimpl->nrOfLinks); link++)
+    {
+        if (linkShapes[link].empty())
+        {
+            continue;
+        }
+
+        LinkGeometry& geometry = pimpl->linkGeometries[link];
+        geometry.primitives.resize(linkShapes[link].size());
+        localBoxes.resize(linkShapes[link].size());
+        primitivesIndices.resize(linkShapes[link].size());
+        for (size_t i = 0; i < linkShapes[link].size(); i++)
+        {
+            if (!convexPrimitiveFromShape(*linkShapes[link][i], geometry.primitives[i]))
+            {
+                std::stringstream ss;
+                ss << "Impossible to convert the collision shape " << i << " of link " << model.getLinkName(link)
+                   << " to a convex primitive.";
+                reportError("LinkDistanceQueries", "loadModel", ss.str().c_str());
+                return false;
+            }
+            const ConvexPrimitive& primitive = geometry.primitives[i];
+            localBoxes[i] = computePrimitiveBox(primitive, primitive.link_R_geometry, primitive.link_p_geometry);
+            primitivesIndices[i] = static_cast<int>(i);
+        }
+
+        geometry.nodes.reserve(2 * geometry.primitives.size() - 1);
+        buildBVHNode(primitivesIndices, 0, primitivesIndices.size(), localBoxes, geometry.nodes);
+        pimpl->updateLinkPosition(link, Eigen::Matrix3d::Identity(), Eigen::Vector3d::Zero());
+        pimpl->linksWithShapes.push_back(link);
+    }
+
+    pimpl->allowedCollisions.assign(pimpl->nrOfLinks * pimpl->nrOfLinks, false);
+    if (options.allowCollisionsBetweenAdjacentLinks)
+    {
+        for (LinkIndex link = 0; link < static_cast<LinkIndex>(pimpl->nrOfLinks); link++)
+        {
+            for (unsigned int i = 0; i < model.getNrOfNeighbors(link); i++)
+            {
+                LinkIndex neighbor = model.getNeighbor(link, i).neighborLink;
+                pimpl->allowedCollisions[link * pimpl->nrOfLinks + neighbor] = true;
+                pimpl->allowedCollisions[neighbor * pimpl->nrOfLinks + link] = true;
+            }
+        }
+    }
+
+    pimpl->sweepOrder = pimpl->linksWithShapes;
+    size_t nrOfLinksWithShapes = pimpl->linksWithShapes.size();
+    pimpl->distances.clear();
+    pimpl->distances.reserve(nrOfLinksWithShapes * (nrOfLinksWithShapes - std::min<size_t>(nrOfLinksWithShapes, 1)) / 2);
+    pimpl->hasMinimumDistance = false;
+    pimpl->isValid = true;
+    return true;
+}
+
+bool LinkDistanceQueries::isValid() const
+{
+    return pimpl->isValid;
+}
+
+bool LinkDistanceQueries::setAllowedCollision(const LinkIndex firstLink, const LinkIndex secondLink, const bool allowed)
+{
+    if (!pimpl->isValid)
+    {
+        reportError("LinkDistanceQueries", "setAllowedCollision", "Model not loaded.");
+        return false;
+    }
+
+    if (firstLink < 0 || firstLink >= static_cast<LinkIndex>(pimpl->nrOfLinks) ||
+        secondLink < 0 || secondLink >= static_cast<LinkIndex>(pimpl->nrOfLinks))
+    {
+        reportError("LinkDistanceQueries", "setAllowedCollision", "Invalid link index.");
+        return false;
+    }
+
+    pimpl->allowedCollisions[firstLink * pimpl->nrOfLinks + secondLink] = allowed;
+    pimpl->allowedCollisions[secondLink * pimpl->nrOfLinks + firstLink] = allowed;
+    return true;
+}
+
+bool LinkDistanceQueries::isCollisionAllowed(const LinkIndex firstLink, const LinkIndex secondLink) const
+{
+    if (firstLink < 0 || firstLink >= static_cast<LinkIndex>(pimpl->nrOfLinks) ||
+        secondLink < 0 || secondLink >= static_cast<LinkIndex>(pimpl->nrOfLinks))
+    {
+        return false;
+    }
+    return pimpl->allowedCollisions[firstLink * pimpl->nrOfLinks + secondLink];
+}
+
+size_t LinkDistanceQueries::getNrOfCheckedLinkPairs() const
+{
+    size_t nrOfCheckedLinkPairs = 0;
+    for (size_t i = 0; i < pimpl->linksWithShapes.size(); i++)
+    {
+        for (size_t j = i + 1; j < pimpl->linksWithShapes.size(); j++)
+        {
+            if (!isCollisionAllowed(pimpl->linksWithShapes[i], pimpl->linksWithShapes[j]))
+            {
+                nrOfCheckedLinkPairs++;
+            }
+        }
+    }
+    return nrOfCheckedLinkPairs;
+}
+
+bool LinkDistanceQueries::updateLinkPositions(const LinkPositions& world_H_links)
+{
+    if (!pimpl->isValid)
+    {
+        reportError("LinkDistanceQueries", "updateLinkPositions", "Model not loaded.");
+        return false;
+    }
+
+    if (world_H_links.getNrOfLinks() != pimpl->nrOfLinks)
+    {
+        reportError("LinkDistanceQueries", "updateLinkPositions", "The size of the link positions does not match the model.");
+        return false;
+    }
+
+    for (LinkIndex link : pimpl->linksWithShapes)
+    {
+        const Transform& world_H_link = world_H_links(link);
+        pimpl->updateLinkPosition(link, toEigen(world_H_link.getRotation()), toEigen(world_H_link.getPosition()));
+    }
+    return true;
+}
+
+bool LinkDistanceQueries::computeDistance(const LinkIndex firstLink, const LinkIndex secondLink, LinkPairDistance& linkPairDistance)
+{
+    if (!pimpl->isValid)
+    {
+        reportError("LinkDistanceQueries", "computeDistance", "Model not loaded.");
+        return false;
+    }
+
+    if (firstLink < 0 || firstLink >= static_cast<LinkIndex>(pimpl->nrOfLinks) ||
+        secondLink < 0 || secondLink >= static_cast<LinkIndex>(pimpl->nrOfLinks) ||
+        firstLink == secondLink)
+    {
+        reportError("LinkDistanceQueries", "computeDistance", "Invalid link indices.");
+        return false;
+    }
+
+    if (pimpl->linkGeometries[firstLink].primitives.empty() || pimpl->linkGeometries[secondLink].primitives.empty())
+    {
+        reportError("LinkDistanceQueries", "computeDistance", "The links do not have collision shapes.");
+        return false;
+    }
+
+    return pimpl->computeLinkPairDistance(firstLink, secondLink, std::numeric_limits<double>::infinity(), linkPairDistance);
+}
+
+bool LinkDistanceQueries::computeAllDistances()
+{
+    if (!pimpl->isValid)
+    {
+        reportError("LinkDistanceQueries", "computeAllDistances", "Model not loaded.");
+        return false;
+    }
+
+    pimpl->distances.clear();
+    pimpl->hasMinimumDistance = false;
+
+    // Insertion sort, as the order changes little from one call to the next
+    std::vector<LinkIndex>& order = pimpl->sweepOrder;
+    for (size_t i = 1; i < order.size(); i++)
+    {
+        LinkIndex link = order[i];
+        double linkMinimumX = pimpl->minimumX(link);
+        size_t j = i;
+        while (j > 0 && pimpl->minimumX(order[j - 1]) > linkMinimumX)
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = link;
+    }
+
+    const double maxDistance = pimpl->options.maxDistance;
+    LinkPairDistance linkPairDistance;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const AxisAlignedBox& box = pimpl->linkGeometries[order[i]].nodes[0].worldBox;
+        double maximumX = box.center(0) + box.halfExtents(0);
+        for (size_t j = i + 1; j < order.size() && pimpl->minimumX(order[j]) - maximumX <= maxDistance; j++)
+        {
+            if (isCollisionAllowed(order[i], order[j]))
+            {
+                continue;
+            }
+
+            if (pimpl->computeLinkPairDistance(order[i], order[j], maxDistance, linkPairDistance))
+            {
+                pimpl->distances.push_back(linkPairDistance);
+                if (!pimpl->hasMinimumDistance || linkPairDistance.distance < pimpl->minimumDistance.distance)
+                {
+                    pimpl->minimumDistance = linkPairDistance;
+                    pimpl->hasMinimumDistance = true;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+const std::vector<LinkPairDistance>& LinkDistanceQueries::getDistances() const
+{
+    return pimpl->distances;
+}
+
+bool LinkDistanceQueries::getMinimumDistance(LinkPairDistance& minimumDistance) const
+{
+    if (!pimpl->hasMinimumDistance)
+    {
+        return false;
+    }
+    minimumDistance = pimpl->minimumDistance;
+    return true;
+}
+
+}
@@ -0,0 +1,313 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/TestUtils.h>
+
+#include <iDynTree/LinkDistanceQueries.h>
+
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/FixedJoint.h>
+#include <iDynTree/LinkState.h>
+#include <iDynTree/Model.h>
+#include <iDynTree/SolidShapes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace iDynTree;
+
+const double tolerance = 1e-6;
+
+void addSphere(Model& model, const LinkIndex link, const Position& center, const double radius)
+{
+    Sphere sphere;
+    sphere.setLink_H_geometry(Transform(Rotation::Identity(), center));
+    sphere.setRadius(radius);
+    model.collisionSolidShapes().addSingleLinkSolidShape(link, sphere);
+}
+
+void addBox(Model& model, const LinkIndex link, const Transform& link_H_box, const double x, const double y, const double z)
+{
+    Box box;
+    box.setLink_H_geometry(link_H_box);
+    box.setX(x);
+    box.setY(y);
+    box.setZ(z);
+    model.collisionSolidShapes().addSingleLinkSolidShape(link, box);
+}
+
+void addCylinder(Model& model, const LinkIndex link, const Transform& link_H_cylinder, const double radius, const double length)
+{
+    Cylinder cylinder;
+    cylinder.setLink_H_geometry(link_H_cylinder);
+    cylinder.setRadius(radius);
+    cylinder.setLength(length);
+    model.collisionSolidShapes().addSingleLinkSolidShape(link, cylinder);
+}
+
+/**
+ * Model with two links, the first fixed in the origin and the second that can be placed anywhere.
+ */
+struct TwoLinksModel
+{
+    Model model;
+    LinkPositions linkPositions;
+
+    TwoLinksModel()
+    {
+        model.addLink("first", Link());
+        model.addLink("second", Link());
+        linkPositions.resize(model);
+        linkPositions(0) = Transform::Identity();
+        linkPositions(1) = Transform::Identity();
+    }
+};
+
+void checkLinkPairDistance(TwoLinksModel& twoLinks, const Transform& world_H_second, const double expectedDistance)
+{
+    LinkDistanceQueries distanceQueries;
+    ASSERT_IS_TRUE(distanceQueries.loadModel(twoLinks.model));
+    twoLinks.linkPositions(1) = world_H_second;
+    ASSERT_IS_TRUE(distanceQueries.updateLinkPositions(twoLinks.linkPositions));
+
+    LinkPairDistance linkPairDistance;
+    ASSERT_IS_TRUE(distanceQueries.computeDistance(1, 0, linkPairDistance));
+    ASSERT_IS_TRUE(linkPairDistance.firstLink == 0);
+    ASSERT_IS_TRUE(linkPairDistance.secondLink == 1);
+    ASSERT_EQUAL_DOUBLE_TOL(linkPairDistance.distance, expectedDistance, tolerance);
+    if (expectedDistance > 0.0)
+    {
+        double pointsDistance = (toEigen(linkPairDistance.firstLinkClosestPoint) - toEigen(linkPairDistance.secondLinkClosestPoint)).norm();
+        ASSERT_EQUAL_DOUBLE_TOL(pointsDistance, expectedDistance, tolerance);
+    }
+}
+
+void checkPrimitivesDistances()
+{
+    // Sphere and sphere
+    {
+        TwoLinksModel twoLinks;
+        addSphere(twoLinks.model, 0, Position(0.1, 0.0, 0.0), 0.5);
+        addSphere(twoLinks.model, 1, Position::Zero(), 0.3);
+        checkLinkPairDistance(twoLinks, Transform(Rotation::Identity(), Position(0.1, 2.0, 0.0)), 1.2);
+        checkLinkPairDistance(twoLinks, Transform(Rotation::Identity(), Position(0.1, 0.5, 0.0)), 0.0);
+    }
+
+    // Box and box, face to face and overlapping
+    {
+        TwoLinksModel twoLinks;
+        addBox(twoLinks.model, 0, Transform::Identity(), 1.0, 1.0, 1.0);
+        addBox(twoLinks.model, 1, Transform::Identity(), 1.0, 2.0, 1.0);
+        checkLinkPairDistance(twoLinks, Transform(Rotation::Identity(), Position(3.0, 0.2, 0.0)), 2.0);
+        checkLinkPairDistance(twoLinks, Transform(Rotation::RotZ(0.3), Position(0.5, 0.5, 0.5)), 0.0);
+    }
+
+    // Rotated box and sphere: the closest point of the box is a vertex
+    {
+        TwoLinksModel twoLinks;
+        addBox(twoLinks.model, 0, Transform(Rotation::RotZ(M_PI / 4.0), Position::Zero()), 2.0, 2.0, 2.0);
+        addSphere(twoLinks.model, 1, Position::Zero(), 0.5);
+        checkLinkPairDistance(twoLinks, Transform(Rotation::Identity(), Position(3.0, 0.0, 0.0)), 3.0 - 0.5 - std::sqrt(2.0));
+    }
+
+    // Cylinder (with the axis along z) and box or sphere, on the side, on the cap and on the rim
+    {
+        TwoLinksModel twoLinks;
+        addCylinder(twoLinks.model, 0, Transform::Identity(), 0.5, 2.0);
+        addBox(twoLinks.model, 1, Transform::Identity(), 1.0, 1.0, 1.0);
+        checkLinkPairDistance(twoLinks, Transform(Rotation::Identity(), Position(2.0, 0.0, 0.0)), 1.0);
+    }
+    {
+        TwoLinksModel twoLinks;
+        addCylinder(twoLinks.model, 0, Transform::Identity(), 0.5, 2.0);
+        addSphere(twoLinks.model, 1, Position::Zero(), 0.5);
+        checkLinkPairDistance(twoLinks, Transform(Rotation::Identity(), Position(0.0, 0.0, 3.0)), 1.5);
+        checkLinkPairDistance(twoLinks, Transform(Rotation::Identity(), Position(2.0, 0.0, 3.0)), 2.0);
+    }
+
+    // Randomly placed boxes and cylinders: the closest points should be inside the shapes, and the distance should be
+    // a lower bound of the distance between the vertices of the boxes
+    for (int test = 0; test < 20; test++)
+    {
+        TwoLinksModel twoLinks;
+        Transform link_H_box = getRandomTransform();
+        double size[3] = {getRandomDouble(0.1, 1.0), getRandomDouble(0.1, 1.0), getRandomDouble(0.1, 1.0)};
+        addBox(twoLinks.model, 0, link_H_box, size[0], size[1], size[2]);
+        addBox(twoLinks.model, 1, Transform::Identity(), size[2], size[0], size[1]);
+
+        LinkDistanceQueries distanceQueries;
+        ASSERT_IS_TRUE(distanceQueries.loadModel(twoLinks.model));
+        Transform world_H_second = getRandomTransform();
+        Position world_p_second = world_H_second.getPosition();
+        toEigen(world_p_second) *= 5.0;
+        world_H_second.setPosition(world_p_second);
+        twoLinks.linkPositions(1) = world_H_second;
+        ASSERT_IS_TRUE(distanceQueries.updateLinkPositions(twoLinks.linkPositions));
+        LinkPairDistance linkPairDistance;
+        ASSERT_IS_TRUE(distanceQueries.computeDistance(0, 1, linkPairDistance));
+
+        Position firstPointInBox = link_H_box.inverse() * linkPairDistance.firstLinkClosestPoint;
+        Position secondPointInBox = world_H_second.inverse() * linkPairDistance.secondLinkClosestPoint;
+        ASSERT_IS_TRUE(std::abs(firstPointInBox(0)) <= 0.5 * size[0] + tolerance);
+        ASSERT_IS_TRUE(std::abs(firstPointInBox(1)) <= 0.5 * size[1] + tolerance);
+        ASSERT_IS_TRUE(std::abs(firstPointInBox(2)) <= 0.5 * size[2] + tolerance);
+        ASSERT_IS_TRUE(std::abs(secondPointInBox(0)) <= 0.5 * size[2] + tolerance);
+        ASSERT_IS_TRUE(std::abs(secondPointInBox(1)) <= 0.5 * size[0] + tolerance);
+        ASSERT_IS_TRUE(std::abs(secondPointInBox(2)) <= 0.5 * size[1] + tolerance);
+        double pointsDistance = (toEigen(linkPairDistance.firstLinkClosestPoint) - toEigen(linkPairDistance.secondLinkClosestPoint)).norm();
+        ASSERT_EQUAL_DOUBLE_TOL(pointsDistance, linkPairDistance.distance, tolerance);
+
+        for (int firstVertex = 0; firstVertex < 8; firstVertex++)
+        {
+            Position firstVertexPosition(((firstVertex & 1) ? 0.5 : -0.5) * size[0],
+                                         ((firstVertex & 2) ? 0.5 : -0.5) * size[1],
+                                         ((firstVertex & 4) ? 0.5 : -0.5) * size[2]);
+            for (int secondVertex = 0; secondVertex < 8; secondVertex++)
+            {
+                Position secondVertexPosition(((secondVertex & 1) ? 0.5 : -0.5) * size[2],
+                                              ((secondVertex & 2) ? 0.5 : -0.5) * size[0],
+                                              ((secondVertex & 4) ? 0.5 : -0.5) * size[1]);
+                double verticesDistance = (toEigen(link_H_box * firstVertexPosition) -
+                                           toEigen(world_H_second * secondVertexPosition)).norm();
+                ASSERT_IS_TRUE(linkPairDistance.distance <= verticesDistance + tolerance);
+            }
+        }
+    }
+}
+
+void checkBoundingVolumeHierarchy()
+{
+    // Links made of many spheres, whose distance is known in closed form
+    const int nrOfSpheres = 25;
+    TwoLinksModel twoLinks;
+    std::vector<Position> centers[2];
+    std::vector<double> radii[2];
+    for (LinkIndex link = 0; link < 2; link++)
+    {
+        for (int i = 0; i < nrOfSpheres; i++)
+        {
+            Position center(getRandomDouble(-1.0, 1.0), getRandomDouble(-1.0, 1.0), getRandomDouble(-1.0, 1.0));
+            double radius = getRandomDouble(0.01, 0.1);
+            addSphere(twoLinks.model, link, center, radius);
+            centers[link].push_back(center);
+            radii[link].push_back(radius);
+        }
+    }
+
+    LinkDistanceQueries distanceQueries;
+    ASSERT_IS_TRUE(distanceQueries.loadModel(twoLinks.model));
+    for (int test = 0; test < 20; test++)
+    {
+        Transform world_H_second = getRandomTransform();
+        Position world_p_second = world_H_second.getPosition();
+        toEigen(world_p_second) *= 3.0;
+        world_H_second.setPosition(world_p_second);
+        twoLinks.linkPositions(1) = world_H_second;
+        ASSERT_IS_TRUE(distanceQueries.updateLinkPositions(twoLinks.linkPositions));
+
+        double expectedDistance = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < nrOfSpheres; i++)
+        {
+            for (int j = 0; j < nrOfSpheres; j++)
+            {
+                double centersDistance = (toEigen(centers[0][i]) - toEigen(world_H_second * centers[1][j])).norm();
+                expectedDistance = std::min(expectedDistance, std::max(0.0, centersDistance - radii[0][i] - radii[1][j]));
+            }
+        }
+
+        LinkPairDistance linkPairDistance;
+        ASSERT_IS_TRUE(distanceQueries.computeDistance(0, 1, linkPairDistance));
+        ASSERT_EQUAL_DOUBLE_TOL(linkPairDistance.distance, expectedDistance, tolerance);
+    }
+}
+
+void checkAllowedCollisionsAndCulling()
+{
+    // Chain of four unit boxes along x, the first two connected by a fixed joint
+    Model model;
+    for (int i = 0; i < 4; i++)
+    {
+        LinkIndex link = model.addLink("link" + std::to_string(i), Link());
+        addBox(model, link, Transform::Identity(), 1.0, 1.0, 1.0);
+    }
+    model.addLink("linkWithoutShapes", Link());
+    FixedJoint joint(Transform::Identity());
+    model.addJoint("link0", "link1", "joint01", &joint);
+
+    LinkPositions linkPositions(model);
+    for (LinkIndex link = 0; link < static_cast<LinkIndex>(model.getNrOfLinks()); link++)
+    {
+        linkPositions(link) = Transform(Rotation::Identity(), Position(2.0 * link, 0.0, 0.0));
+    }
+
+    LinkDistanceQueries distanceQueries;
+    ASSERT_IS_FALSE(distanceQueries.isValid());
+    ASSERT_IS_FALSE(distanceQueries.computeAllDistances());
+    ASSERT_IS_TRUE(distanceQueries.loadModel(model));
+    ASSERT_IS_TRUE(distanceQueries.isValid());
+    ASSERT_IS_TRUE(distanceQueries.isCollisionAllowed(0, 1));
+    ASSERT_IS_FALSE(distanceQueries.isCollisionAllowed(0, 2));
+    ASSERT_IS_TRUE(distanceQueries.getNrOfCheckedLinkPairs() == 5);
+    ASSERT_IS_TRUE(distanceQueries.updateLinkPositions(linkPositions));
+    ASSERT_IS_FALSE(distanceQueries.updateLinkPositions(LinkPositions(2)));
+
+    ASSERT_IS_TRUE(distanceQueries.computeAllDistances());
+    ASSERT_IS_TRUE(distanceQueries.getDistances().size() == 5);
+    LinkPairDistance minimumDistance;
+    ASSERT_IS_TRUE(distanceQueries.getMinimumDistance(minimumDistance));
+    ASSERT_EQUAL_DOUBLE_TOL(minimumDistance.distance, 1.0, tolerance);
+    for (const LinkPairDistance& linkPairDistance : distanceQueries.getDistances())
+    {
+        ASSERT_IS_TRUE(linkPairDistance.firstLink < linkPairDistance.secondLink);
+        ASSERT_IS_FALSE(linkPairDistance.firstLink == 0 && linkPairDistance.secondLink == 1);
+        double expectedDistance = 2.0 * (linkPairDistance.secondLink - linkPairDistance.firstLink) - 1.0;
+        ASSERT_EQUAL_DOUBLE_TOL(linkPairDistance.distance, expectedDistance, tolerance);
+    }
+
+    // Allow the collision between link2 and link3
+    ASSERT_IS_TRUE(distanceQueries.setAllowedCollision(3, 2, true));
+    ASSERT_IS_FALSE(distanceQueries.setAllowedCollision(3, 10, true));
+    ASSERT_IS_TRUE(distanceQueries.getNrOfCheckedLinkPairs() == 4);
+    ASSERT_IS_TRUE(distanceQueries.computeAllDistances());
+    ASSERT_IS_TRUE(distanceQueries.getDistances().size() == 4);
+
+    // The links without collision shapes can not be queried
+    LinkPairDistance linkPairDistance;
+    ASSERT_IS_FALSE(distanceQueries.computeDistance(0, 4, linkPairDistance));
+
+    // Only the pairs closer than the maximum distance are reported
+    LinkDistanceQueriesOptions options;
+    options.maxDistance = 1.5;
+    ASSERT_IS_TRUE(distanceQueries.loadModel(model, options));
+    ASSERT_IS_TRUE(distanceQueries.updateLinkPositions(linkPositions));
+    ASSERT_IS_TRUE(distanceQueries.computeAllDistances());
+    ASSERT_IS_TRUE(distanceQueries.getDistances().size() == 2);
+    for (const LinkPairDistance& linkPairDistance : distanceQueries.getDistances())
+    {
+        ASSERT_IS_TRUE(linkPairDistance.secondLink - linkPairDistance.firstLink == 1);
+    }
+
+    // Move link3 far away: no pair in range for it, while the others are unchanged
+    linkPositions(3) = Transform(Rotation::Identity(), Position(0.0, 20.0, 0.0));
+    ASSERT_IS_TRUE(distanceQueries.updateLinkPositions(linkPositions));
+    ASSERT_IS_TRUE(distanceQueries.computeAllDistances());
+    ASSERT_IS_TRUE(distanceQueries.getDistances().size() == 1);
+    ASSERT_IS_TRUE(distanceQueries.getMinimumDistance(minimumDistance));
+    ASSERT_IS_TRUE(minimumDistance.firstLink == 1 && minimumDistance.secondLink == 2);
+
+    // Check also without the default allowed collisions
+    options.maxDistance = std::numeric_limits<double>::infinity();
+    options.allowCollisionsBetweenAdjacentLinks = false;
+    ASSERT_IS_TRUE(distanceQueries.loadModel(model, options));
+    ASSERT_IS_TRUE(distanceQueries.getNrOfCheckedLinkPairs() == 6);
+}
+
+int main()
+{
+    checkPrimitivesDistances();
+    checkBoundingVolumeHierarchy();
+    checkAllowedCollisionsAndCulling();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "BenchmarkUtils.h"
+
+#include "testModels.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<std::size_t> nrOfHeapAllocations{0};
+}
+
+// Replacement of the global allocation functions, used to count the allocations.
+// The array and nothrow versions are implemented by the standard library on
+// top of these ones, so there is no need to replace them as well.
+void* operator new(std::size_t size)
+{
+    nrOfHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0)
+    {
+        size = 1;
+    }
+    void* ptr = std::malloc(size);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+namespace iDynTree
+{
+
+std::size_t getNrOfHeapAllocations()
+{
+    return nrOfHeapAllocations.load(std::memory_order_relaxed);
+}
+
+HeapAllocationsCounter::HeapAllocationsCounter(): m_initialNrOfAllocations(getNrOfHeapAllocations())
+{
+}
+
+void HeapAllocationsCounter::report(benchmark::State& state) const
+{
+    double allocations = static_cast<double>(getNrOfHeapAllocations() - m_initialNrOfAllocations);
+    state.counters["allocs"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+}
+
+const std::vector<std::string>& getBenchmarkModels()
+{
+    static const std::vector<std::string> models(IDYNTREE_TESTS_URDFS, IDYNTREE_TESTS_URDFS + IDYNTREE_TESTS_URDFS_NR);
+    return models;
+}
+
+std::string getBenchmarkModelPath(const std::string& modelName)
+{
+    return getAbsModelPath(modelName);
+}
+
+bool registerBenchmarkOnModels(const std::string& benchmarkName,
+                               const std::vector<std::string>& modelNames,
+                               std::function<void(benchmark::State&, const std::string&)> benchmarkFunction)
+{
+    for (const std::string& modelName : modelNames)
+    {
+        std::string modelNameWithoutExtension = modelName.substr(0, modelName.find_last_of('.'));
+        benchmark::RegisterBenchmark((benchmarkName + "/" + modelNameWithoutExtension).c_str(),
+                                     [benchmarkFunction, modelName](benchmark::State& state)
+                                     {
+                                         benchmarkFunction(state, modelName);
+                                     });
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef IDYNTREE_BENCHMARK_UTILS_H
+#define IDYNTREE_BENCHMARK_UTILS_H
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace iDynTree
+{
+
+/**
+ * Number of calls to the global operator new since the start of the program.
+ *
+ * The counter is maintained by the replacement of the global allocation functions
+ * contained in BenchmarkUtils.cpp, that is linked in all the benchmark executables.
+ */
+std::size_t getNrOfHeapAllocations();
+
+/**
+ * Helper to measure the heap allocations performed during a benchmark.
+ *
+ * Construct it just before the benchmark loop and call report() after the
+ * loop: the average number of allocations per iteration is added to the
+ * counters of the benchmark, and so it is part of the console and JSON output.
+ */
+class HeapAllocationsCounter
+{
+    std::size_t m_initialNrOfAllocations;
+
+public:
+    HeapAllocationsCounter();
+
+    void report(benchmark::State& state) const;
+};
+
+/**
+ * Names of the URDF models (contained in the src/tests/data directory) used by the benchmarks.
+ */
+const std::vector<std::string>& getBenchmarkModels();
+
+/**
+ * Absolute path of a model contained in the src/tests/data directory.
+ */
+std::string getBenchmarkModelPath(const std::string& modelName);
+
+/**
+ * Register a benchmark for each of the specified models.
+ *
+ * The benchmarks are called <benchmarkName>/<modelName>, so that they can be filtered
+ * with the --benchmark_filter option.
+ */
+bool registerBenchmarkOnModels(const std::string& benchmarkName,
+                               const std::vector<std::string>& modelNames,
+                               std::function<void(benchmark::State&, const std::string&)> benchmarkFunction);
+
+}
+
+/**
+ * Register the benchmark function func (with signature void(benchmark::State&, const std::string& modelName))
+ * for all the models returned by iDynTree::getBenchmarkModels().
+ */
+#define IDYNTREE_BENCHMARK_ON_TEST_MODELS(func) \
+    static bool func##_isRegistered = iDynTree::registerBenchmarkOnModels(#func, iDynTree::getBenchmarkModels(), func)
+
+#endif
@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+// Benchmarks of the interpolation of joint trajectories with cubic splines: computation of the
+// coefficients as a function of the number of knots, and evaluation of the trajectories of all the
+// joints at the instants of a control loop, with a CubicSpline for each joint or a single MultiChannelCubicSpline.
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/CubicSpline.h>
+#include <iDynTree/VectorDynSize.h>
+#include <iDynTree/MatrixDynSize.h>
+#include <iDynTree/TestUtils.h>
+
+#include <vector>
+
+using namespace iDynTree;
+
+static const size_t numberOfJoints = 30;
+static const size_t numberOfQueries = 1000;
+
+static VectorDynSize getKnotsTime(size_t numberOfKnots)
+{
+    VectorDynSize time(numberOfKnots);
+    for (size_t i = 0; i < numberOfKnots; ++i)
+    {
+        time(i) = 0.01 * i;
+    }
+    return time;
+}
+
+static void BM_CubicSplineCoefficients(benchmark::State& state)
+{
+    size_t numberOfKnots = static_cast<size_t>(state.range(0));
+    VectorDynSize time = getKnotsTime(numberOfKnots), yData(numberOfKnots);
+    getRandomVector(yData);
+    CubicSpline spline(numberOfKnots);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        spline.setData(time, yData);
+        benchmark::DoNotOptimize(spline.evaluatePoint(0.0));
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_CubicSplineCoefficients)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// Evaluation at increasing instants spanning the whole trajectory
+static void BM_CubicSplineMonotoneEvaluation(benchmark::State& state)
+{
+    size_t numberOfKnots = static_cast<size_t>(state.range(0));
+    VectorDynSize time = getKnotsTime(numberOfKnots), yData(numberOfKnots);
+    getRandomVector(yData);
+    CubicSpline spline;
+    spline.setData(time, yData);
+    double duration = time(numberOfKnots - 1);
+    double velocity, acceleration;
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < numberOfQueries; ++i)
+        {
+            benchmark::DoNotOptimize(spline.evaluatePoint(duration * i / numberOfQueries, velocity, acceleration));
+        }
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations() * numberOfQueries);
+}
+BENCHMARK(BM_CubicSplineMonotoneEvaluation)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// Evaluation of all the joints with a spline for each joint
+static void BM_CubicSplineJointsEvaluation(benchmark::State& state)
+{
+    size_t numberOfKnots = static_cast<size_t>(state.range(0));
+    VectorDynSize time = getKnotsTime(numberOfKnots), yData(numberOfKnots);
+    std::vector<CubicSpline> splines(numberOfJoints);
+    for (CubicSpline& spline : splines)
+    {
+        getRandomVector(yData);
+        spline.setData(time, yData);
+    }
+    double duration = time(numberOfKnots - 1);
+    VectorDynSize positions(numberOfJoints), velocities(numberOfJoints), accelerations(numberOfJoints);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < numberOfQueries; ++i)
+        {
+            for (size_t joint = 0; joint < numberOfJoints; ++joint)
+            {
+                positions(joint) = splines[joint].evaluatePoint(duration * i / numberOfQueries, velocities(joint), accelerations(joint));
+            }
+            benchmark::DoNotOptimize(positions.data());
+        }
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations() * numberOfQueries);
+}
+BENCHMARK(BM_CubicSplineJointsEvaluation)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_MultiChannelCubicSplineJointsEvaluation(benchmark::State& state)
+{
+    size_t numberOfKnots = static_cast<size_t>(state.range(0));
+    VectorDynSize time = getKnotsTime(numberOfKnots);
+    MatrixDynSize yData(numberOfJoints, numberOfKnots);
+    getRandomMatrix(yData);
+    MultiChannelCubicSpline spline;
+    spline.setData(time, yData);
+    double duration = time(numberOfKnots - 1);
+    VectorDynSize positions(numberOfJoints), velocities(numberOfJoints), accelerations(numberOfJoints);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < numberOfQueries; ++i)
+        {
+            spline.evaluatePoint(duration * i / numberOfQueries, positions, velocities, accelerations);
+            benchmark::DoNotOptimize(positions.data());
+        }
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations() * numberOfQueries);
+}
+BENCHMARK(BM_MultiChannelCubicSplineJointsEvaluation)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// Computation of the coefficients of all the joints
+static void BM_MultiChannelCubicSplineCoefficients(benchmark::State& state)
+{
+    size_t numberOfKnots = static_cast<size_t>(state.range(0));
+    VectorDynSize time = getKnotsTime(numberOfKnots), positions(numberOfJoints);
+    MatrixDynSize yData(numberOfJoints, numberOfKnots);
+    getRandomMatrix(yData);
+    MultiChannelCubicSpline spline(numberOfJoints, numberOfKnots);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        spline.setData(time, yData);
+        spline.evaluatePoint(0.0, positions);
+        benchmark::DoNotOptimize(positions.data());
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_MultiChannelCubicSplineCoefficients)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
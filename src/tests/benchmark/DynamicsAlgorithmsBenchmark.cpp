@@ -0,0 +1,426 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/Model.h>
+#include <iDynTree/ModelLoader.h>
+#include <iDynTree/Traversal.h>
+
+#include <iDynTree/ForwardKinematics.h>
+#include <iDynTree/Dynamics.h>
+#include <iDynTree/DynamicsDerivatives.h>
+#include <iDynTree/Jacobians.h>
+#include <iDynTree/MassMatrixFactorization.h>
+
+#include <iDynTree/LinkState.h>
+#include <iDynTree/FreeFloatingState.h>
+#include <iDynTree/FreeFloatingMatrices.h>
+
+#include <iDynTree/MatrixDynSize.h>
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/TestUtils.h>
+
+using namespace iDynTree;
+
+namespace
+{
+
+/**
+ * Model, traversal and a random state, shared by the benchmarks of the algorithms
+ * that operate directly on the iDynTree::Model.
+ */
+struct DynamicsBenchmarkData
+{
+    Model model;
+    Traversal traversal;
+    FreeFloatingPos robotPos;
+    FreeFloatingVel robotVel;
+    FreeFloatingAcc robotAcc;
+    LinkNetExternalWrenches linkExtWrenches;
+    JointDOFsDoubleArray jointTorques;
+
+    bool init(const std::string& modelName)
+    {
+        ModelLoader loader;
+        if (!loader.loadModelFromFile(getBenchmarkModelPath(modelName)))
+        {
+            return false;
+        }
+        model = loader.model();
+        if (!model.computeFullTreeTraversal(traversal))
+        {
+            return false;
+        }
+
+        robotPos.resize(model);
+        robotVel.resize(model);
+        robotAcc.resize(model);
+        linkExtWrenches.resize(model);
+        jointTorques.resize(model);
+
+        robotPos.worldBasePos() = getRandomTransform();
+        robotVel.baseVel() = getRandomTwist();
+        robotAcc.baseAcc() = getRandomTwist();
+        getRandomVector(robotPos.jointPos());
+        getRandomVector(robotVel.jointVel());
+        getRandomVector(robotAcc.jointAcc());
+        getRandomVector(jointTorques);
+        for (LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+        {
+            linkExtWrenches(lnk) = getRandomWrench();
+        }
+
+        return true;
+    }
+};
+
+}
+
+static void BM_ForwardPositionKinematics(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    LinkPositions linkPos(data.model);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        ForwardPositionKinematics(data.model, data.traversal, data.robotPos, linkPos);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_ForwardPositionKinematics);
+
+static void BM_ForwardPositionKinematicsIncremental(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName) || data.model.getNrOfPosCoords() == 0)
+    {
+        state.SkipWithError("Impossible to load the model, or model without joints");
+        return;
+    }
+
+    LinkPositions linkPos(data.model);
+    ForwardPositionKinematicsIncrementalBuffers buffers(data.model);
+    ForwardPositionKinematicsIncremental(data.model, data.traversal, data.robotPos, buffers, linkPos);
+
+    // At each iteration only the last joint position coordinate is changed
+    const size_t changedCoord = data.model.getNrOfPosCoords()-1;
+    size_t nrOfUpdatedLinks = 0;
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.robotPos.jointPos()(changedCoord) += 1e-3;
+        ForwardPositionKinematicsIncremental(data.model, data.traversal, data.robotPos, buffers, linkPos);
+        nrOfUpdatedLinks += buffers.nrOfUpdatedLinks;
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    state.counters["updatedLinks"] = benchmark::Counter(static_cast<double>(nrOfUpdatedLinks), benchmark::Counter::kAvgIterations);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_ForwardPositionKinematicsIncremental);
+
+static void BM_ForwardPosVelAccKinematics(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    LinkPositions linkPos(data.model);
+    LinkVelArray linkVel(data.model);
+    LinkAccArray linkAcc(data.model);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        ForwardPosVelAccKinematics(data.model, data.traversal, data.robotPos, data.robotVel, data.robotAcc,
+                                   linkPos, linkVel, linkAcc);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_ForwardPosVelAccKinematics);
+
+static void BM_RNEA(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    LinkVelArray linkVel(data.model);
+    LinkAccArray linkAcc(data.model);
+    LinkInternalWrenches linkIntWrenches(data.model);
+    FreeFloatingGeneralizedTorques generalizedTorques(data.model);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        ForwardVelAccKinematics(data.model, data.traversal, data.robotPos, data.robotVel, data.robotAcc,
+                                linkVel, linkAcc);
+        RNEADynamicPhase(data.model, data.traversal, data.robotPos.jointPos(), linkVel, linkAcc,
+                         data.linkExtWrenches, linkIntWrenches, generalizedTorques);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_RNEA);
+
+static void BM_CRBA(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    LinkCompositeRigidBodyInertias linkCRBs(data.model);
+    FreeFloatingMassMatrix massMatrix(data.model);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        CompositeRigidBodyAlgorithm(data.model, data.traversal, data.robotPos.jointPos(), linkCRBs, massMatrix);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_CRBA);
+
+// The two following benchmarks compute M^{-1} J^T for a 6 x (6+n) matrix J, including
+// the factorization of the mass matrix M, with the sparse LTL and the dense LLT factorizations
+static void BM_MassMatrixLTLFactorizationSolve(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    LinkCompositeRigidBodyInertias linkCRBs(data.model);
+    FreeFloatingMassMatrix massMatrix(data.model);
+    CompositeRigidBodyAlgorithm(data.model, data.traversal, data.robotPos.jointPos(), linkCRBs, massMatrix);
+
+    MassMatrixLTLFactorization factorization(data.model, data.traversal);
+    MatrixDynSize jacobian(6, massMatrix.cols()), invMassJacobianT(massMatrix.rows(), 6);
+    getRandomMatrix(jacobian);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        factorization.factorize(massMatrix);
+        factorization.multiplyInverseByTransposed(jacobian, invMassJacobianT);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    state.counters["nnz"] = static_cast<double>(factorization.getNrOfNonZeros());
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_MassMatrixLTLFactorizationSolve);
+
+static void BM_MassMatrixDenseLLTSolve(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    LinkCompositeRigidBodyInertias linkCRBs(data.model);
+    FreeFloatingMassMatrix massMatrix(data.model);
+    CompositeRigidBodyAlgorithm(data.model, data.traversal, data.robotPos.jointPos(), linkCRBs, massMatrix);
+
+    Eigen::LLT<Eigen::MatrixXd> llt(massMatrix.rows());
+    MatrixDynSize jacobian(6, massMatrix.cols()), invMassJacobianT(massMatrix.rows(), 6);
+    getRandomMatrix(jacobian);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        llt.compute(toEigen(massMatrix));
+        toEigen(invMassJacobianT) = toEigen(jacobian).transpose();
+        llt.solveInPlace(toEigen(invMassJacobianT));
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_MassMatrixDenseLLTSolve);
+
+static void BM_ABA(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    ArticulatedBodyAlgorithmInternalBuffers bufs(data.model);
+    FreeFloatingAcc robotAcc(data.model);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        ArticulatedBodyAlgorithm(data.model, data.traversal, data.robotPos, data.robotVel,
+                                 data.linkExtWrenches, data.jointTorques, bufs, robotAcc);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_ABA);
+
+// The two following benchmarks compute the derivatives of the inverse dynamics with respect to the
+// joint positions and to the system velocity, analytically and with forward finite differences of the RNEA
+static void BM_InverseDynamicsDerivatives(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    InverseDynamicsDerivativesInternalBuffers bufs(data.model);
+    FreeFloatingGeneralizedTorques generalizedTorques(data.model);
+    MatrixDynSize dTau_dJointPos(6+data.model.getNrOfDOFs(), data.model.getNrOfDOFs());
+    MatrixDynSize dTau_dVel(6+data.model.getNrOfDOFs(), 6+data.model.getNrOfDOFs());
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        InverseDynamicsDerivatives(data.model, data.traversal, data.robotPos, data.robotVel, data.robotAcc,
+                                   data.linkExtWrenches, bufs, generalizedTorques, dTau_dJointPos, dTau_dVel);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_InverseDynamicsDerivatives);
+
+static void BM_InverseDynamicsFiniteDifferences(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    const size_t dofs = data.model.getNrOfDOFs();
+    const double h = 1e-6;
+    LinkVelArray linkVel(data.model);
+    LinkAccArray linkAcc(data.model);
+    LinkInternalWrenches linkIntWrenches(data.model);
+    FreeFloatingGeneralizedTorques generalizedTorques(data.model), perturbedGeneralizedTorques(data.model);
+    FreeFloatingPos perturbedPos = data.robotPos;
+    FreeFloatingVel perturbedVel = data.robotVel;
+    MatrixDynSize dTau_dJointPos(6+dofs, dofs);
+    MatrixDynSize dTau_dVel(6+dofs, 6+dofs);
+
+    auto rnea = [&](const FreeFloatingPos& pos, const FreeFloatingVel& vel, FreeFloatingGeneralizedTorques& tau)
+    {
+        ForwardVelAccKinematics(data.model, data.traversal, pos, vel, data.robotAcc, linkVel, linkAcc);
+        RNEADynamicPhase(data.model, data.traversal, pos.jointPos(), linkVel, linkAcc,
+                         data.linkExtWrenches, linkIntWrenches, tau);
+    };
+
+    auto storeColumn = [&](MatrixDynSize& derivative, size_t col)
+    {
+        auto column = toEigen(derivative).col(col);
+        column.head<6>() = (toEigen(perturbedGeneralizedTorques.baseWrench()) - toEigen(generalizedTorques.baseWrench()))/h;
+        column.tail(dofs) = (toEigen(perturbedGeneralizedTorques.jointTorques()) - toEigen(generalizedTorques.jointTorques()))/h;
+    };
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        rnea(data.robotPos, data.robotVel, generalizedTorques);
+        for (size_t i=0; i < dofs; i++)
+        {
+            perturbedPos.jointPos()(i) += h;
+            rnea(perturbedPos, data.robotVel, perturbedGeneralizedTorques);
+            perturbedPos.jointPos()(i) = data.robotPos.jointPos()(i);
+            storeColumn(dTau_dJointPos, i);
+        }
+        for (size_t i=0; i < 6+dofs; i++)
+        {
+            double& var = (i < 6) ? perturbedVel.baseVel()(i) : perturbedVel.jointVel()(i-6);
+            const double nominal = var;
+            var += h;
+            rnea(data.robotPos, perturbedVel, perturbedGeneralizedTorques);
+            var = nominal;
+            storeColumn(dTau_dVel, i);
+        }
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_InverseDynamicsFiniteDifferences);
+
+static void BM_ForwardDynamicsDerivatives(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    const size_t dofs = data.model.getNrOfDOFs();
+    ForwardDynamicsDerivativesInternalBuffers bufs(data.model, data.traversal);
+    FreeFloatingAcc robotAcc(data.model);
+    MatrixDynSize dAcc_dJointPos(6+dofs, dofs), dAcc_dVel(6+dofs, 6+dofs), dAcc_dJointTorques(6+dofs, dofs);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        ForwardDynamicsDerivatives(data.model, data.traversal, data.robotPos, data.robotVel,
+                                   data.linkExtWrenches, data.jointTorques, bufs, robotAcc,
+                                   dAcc_dJointPos, dAcc_dVel, dAcc_dJointTorques);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_ForwardDynamicsDerivatives);
+
+static void BM_FreeFloatingJacobian(benchmark::State& state, const std::string& modelName)
+{
+    DynamicsBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    LinkPositions linkPos(data.model);
+    ForwardPositionKinematics(data.model, data.traversal, data.robotPos, linkPos);
+
+    // Compute the jacobian of the last link, that is typically a leaf of the model
+    LinkIndex lastLink = static_cast<LinkIndex>(data.model.getNrOfLinks()-1);
+    Transform link_X_world = linkPos(lastLink).inverse();
+    MatrixDynSize jacobian(6, data.model.getNrOfDOFs()+6);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        FreeFloatingJacobianUsingLinkPos(data.model, data.traversal, data.robotPos.jointPos(), linkPos,
+                                         lastLink, link_X_world, Transform::Identity(), jacobian);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_FreeFloatingJacobian);
@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/ExtWrenchesAndJointTorquesEstimator.h>
+#include <iDynTree/BerdyHelper.h>
+#include <iDynTree/BerdySparseMAPSolver.h>
+#include <iDynTree/ExternalWrenchesEstimation.h>
+#include <iDynTree/AttitudeQuaternionEKF.h>
+#include <iDynTree/ModelLoader.h>
+
+#include <iDynTree/JointState.h>
+#include <iDynTree/SparseMatrix.h>
+#include <iDynTree/VectorDynSize.h>
+#include <iDynTree/TestUtils.h>
+
+using namespace iDynTree;
+
+/**
+ * Models of the test data directory that contain six axis force torque sensors.
+ */
+static const std::vector<std::string> modelsWithFTSensors = {"iCubGenova02.urdf", "iCubDarmstadt01.urdf"};
+
+static void BM_ExtWrenchesAndJointTorquesEstimation(benchmark::State& state, const std::string& modelName)
+{
+    ExtWrenchesAndJointTorquesEstimator estimator;
+    if (!estimator.loadModelAndSensorsFromFile(getBenchmarkModelPath(modelName)))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    const Model& model = estimator.model();
+    JointPosDoubleArray jointPos(model);
+    JointDOFsDoubleArray jointVel(model), jointAcc(model);
+    getRandomVector(jointPos);
+    getRandomVector(jointVel);
+    getRandomVector(jointAcc);
+    Vector3 gravity;
+    gravity.zero();
+    gravity(2) = -9.81;
+    FrameIndex baseFrame = model.getDefaultBaseLink();
+
+    LinkUnknownWrenchContacts unknowns(model);
+    unknowns.addNewUnknownFullWrenchInFrameOrigin(model, baseFrame);
+    SensorsMeasurements ftMeasurements(model.sensors());
+    LinkContactWrenches contactWrenches(model);
+    JointDOFsDoubleArray jointTorques(model);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        estimator.updateKinematicsFromFixedBase(jointPos, jointVel, jointAcc, baseFrame, gravity);
+        estimator.estimateExtWrenchesAndJointTorques(unknowns, ftMeasurements, contactWrenches, jointTorques);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+static bool BM_ExtWrenchesAndJointTorquesEstimation_isRegistered =
+    registerBenchmarkOnModels("BM_ExtWrenchesAndJointTorquesEstimation", modelsWithFTSensors,
+                              BM_ExtWrenchesAndJointTorquesEstimation);
+
+static void BM_BerdyHelperGetBerdyMatrices(benchmark::State& state, const std::string& modelName)
+{
+    ModelLoader loader;
+    if (!loader.loadModelFromFile(getBenchmarkModelPath(modelName)))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+    const Model& model = loader.model();
+
+    BerdyHelper berdyHelper;
+    BerdyOptions berdyOptions;
+    berdyOptions.berdyVariant = BERDY_FLOATING_BASE;
+    berdyOptions.includeAllNetExternalWrenchesAsSensors = true;
+    berdyOptions.includeAllJointAccelerationsAsSensors = true;
+    if (!berdyHelper.init(model, berdyOptions))
+    {
+        state.SkipWithError("Impossible to initialize the BerdyHelper");
+        return;
+    }
+
+    JointPosDoubleArray jointPos(model);
+    JointDOFsDoubleArray jointVel(model);
+    getRandomVector(jointPos);
+    getRandomVector(jointVel);
+    Vector3 baseAngularVel;
+    getRandomVector(baseAngularVel);
+    FrameIndex baseFrame = model.getDefaultBaseLink();
+
+    SparseMatrix<iDynTree::ColumnMajor> D, Y;
+    VectorDynSize bD, bY;
+    berdyHelper.resizeAndZeroBerdyMatrices(D, bD, Y, bY);
+    // The first call computes the sparsity pattern of the matrices
+    berdyHelper.updateKinematicsFromFloatingBase(jointPos, jointVel, baseFrame, baseAngularVel);
+    berdyHelper.getBerdyMatrices(D, bD, Y, bY);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        berdyHelper.updateKinematicsFromFloatingBase(jointPos, jointVel, baseFrame, baseAngularVel);
+        berdyHelper.getBerdyMatrices(D, bD, Y, bY);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    state.counters["nnzD"] = D.numberOfNonZeros();
+    state.counters["nnzY"] = Y.numberOfNonZeros();
+}
+static bool BM_BerdyHelperGetBerdyMatrices_isRegistered =
+    registerBenchmarkOnModels("BM_BerdyHelperGetBerdyMatrices", modelsWithFTSensors, BM_BerdyHelperGetBerdyMatrices);
+
+static void BM_BerdySparseMAPSolver(benchmark::State& state, const std::string& modelName)
+{
+    ModelLoader loader;
+    if (!loader.loadModelFromFile(getBenchmarkModelPath(modelName)))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+    const Model& model = loader.model();
+
+    BerdyHelper berdyHelper;
+    BerdyOptions berdyOptions;
+    berdyOptions.berdyVariant = BERDY_FLOATING_BASE;
+    berdyOptions.includeAllNetExternalWrenchesAsSensors = true;
+    berdyOptions.includeAllJointAccelerationsAsSensors = true;
+    BerdySparseMAPSolver solver(berdyHelper);
+    if (!berdyHelper.init(model, berdyOptions) || !solver.initialize())
+    {
+        state.SkipWithError("Impossible to initialize the BerdySparseMAPSolver");
+        return;
+    }
+
+    JointPosDoubleArray jointPos(model);
+    JointDOFsDoubleArray jointVel(model);
+    getRandomVector(jointPos);
+    getRandomVector(jointVel);
+    Vector3 baseAngularVel;
+    getRandomVector(baseAngularVel);
+    VectorDynSize measurements(berdyHelper.getNrOfSensorsMeasurements());
+    getRandomVector(measurements);
+    FrameIndex baseFrame = model.getDefaultBaseLink();
+
+    state.counters["dynVars"] = berdyHelper.getNrOfDynamicVariables();
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        solver.updateEstimateInformationFloatingBase(jointPos, jointVel, baseFrame, baseAngularVel, measurements);
+        solver.doEstimate();
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+static bool BM_BerdySparseMAPSolver_isRegistered =
+    registerBenchmarkOnModels("BM_BerdySparseMAPSolver", modelsWithFTSensors, BM_BerdySparseMAPSolver);
+
+/**
+ * Configure the attitude EKF as in a typical IMU loop, using the magnetometer if useMagnetometer is true.
+ */
+static bool setupAttitudeQuaternionEKF(AttitudeQuaternionEKF& qEKF, bool useMagnetometer)
+{
+    AttitudeQuaternionEKFParameters params;
+    params.use_magnetometer_measurements = useMagnetometer;
+    qEKF.setParameters(params);
+    if (!qEKF.initializeFilter())
+    {
+        return false;
+    }
+
+    Vector10 x0;
+    x0.zero();
+    x0(0) = 1.0;
+    return qEKF.setInternalState(make_span(x0.data(), x0.size()));
+}
+
+static void BM_AttitudeQuaternionEKFPropagateStates(benchmark::State& state)
+{
+    AttitudeQuaternionEKF qEKF;
+    if (!setupAttitudeQuaternionEKF(qEKF, state.range(0) != 0))
+    {
+        state.SkipWithError("Impossible to initialize the AttitudeQuaternionEKF");
+        return;
+    }
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        qEKF.propagateStates();
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_AttitudeQuaternionEKFPropagateStates)->ArgName("mag")->Arg(0)->Arg(1);
+
+static void BM_AttitudeQuaternionEKFUpdate(benchmark::State& state)
+{
+    AttitudeQuaternionEKF qEKF;
+    if (!setupAttitudeQuaternionEKF(qEKF, state.range(0) != 0))
+    {
+        state.SkipWithError("Impossible to initialize the AttitudeQuaternionEKF");
+        return;
+    }
+
+    LinearAccelerometerMeasurements acc;
+    acc.zero();
+    acc(0) = 0.1;
+    acc(2) = 9.81;
+    GyroscopeMeasurements gyro;
+    gyro.zero();
+    gyro(2) = 0.01;
+    MagnetometerMeasurements mag;
+    mag.zero();
+    mag(0) = 0.3;
+    mag(2) = 1.0;
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        qEKF.updateFilterWithMeasurements(acc, gyro, mag);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_AttitudeQuaternionEKFUpdate)->ArgName("mag")->Arg(0)->Arg(1);
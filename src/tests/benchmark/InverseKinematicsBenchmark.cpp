@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/InverseKinematics.h>
+#include <iDynTree/KinDynComputations.h>
+#include <iDynTree/ModelLoader.h>
+#include <iDynTree/ModelTestUtils.h>
+
+#include <iDynTree/VectorDynSize.h>
+#include <iDynTree/TestUtils.h>
+
+using namespace iDynTree;
+
+/**
+ * Solve the IK of a random chain with state.range(0) joints, with a full
+ * transform target on the last link and the first link fixed. If state.range(1)
+ * is not zero, the exact Hessian of the Lagrangian is used.
+ */
+static void BM_InverseKinematicsRandomChain(benchmark::State& state)
+{
+    int nrOfJoints = static_cast<int>(state.range(0));
+    Model chain = getRandomChain(nrOfJoints, 10, true);
+    std::string targetFrame = "link" + int2string(nrOfJoints-1);
+
+    InverseKinematics ik;
+    ik.setVerbosity(0);
+    if (!ik.setModel(chain))
+    {
+        state.SkipWithError("Impossible to set the model");
+        return;
+    }
+    ik.setDefaultTargetResolutionMode(InverseKinematicsTreatTargetAsConstraintNone);
+    ik.setHessianApproximation(state.range(1) ? InverseKinematicsHessianApproximationExact
+                                              : InverseKinematicsHessianApproximationLimitedMemory);
+
+    KinDynComputations kinDyn;
+    kinDyn.loadRobotModel(chain);
+    VectorDynSize s(chain.getNrOfPosCoords());
+    getRandomVector(s);
+    kinDyn.setJointPos(s);
+
+    ik.addFrameConstraint("link1", kinDyn.getWorldTransform("link1"));
+    ik.addTarget(targetFrame, kinDyn.getWorldTransform(targetFrame));
+
+    Transform baseInitial = kinDyn.getWorldBaseTransform();
+    VectorDynSize sInitial(chain.getNrOfPosCoords());
+    sInitial.zero();
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        ik.setFullJointsInitialCondition(&baseInitial, &sInitial);
+        bool ok = ik.solve();
+        benchmark::DoNotOptimize(ok);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_InverseKinematicsRandomChain)->ArgsProduct({{6, 12, 24}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+/**
+ * Solve a batch of 64 IK problems of a random chain with 12 joints, each with a different
+ * target on the last link and two initial conditions, using state.range(0) worker threads.
+ */
+static void BM_InverseKinematicsBatch(benchmark::State& state)
+{
+    const int nrOfJoints = 12;
+    const size_t nrOfProblems = 64;
+    Model chain = getRandomChain(nrOfJoints, 10, true);
+    std::string targetFrame = "link" + int2string(nrOfJoints-1);
+
+    InverseKinematics ik;
+    ik.setVerbosity(0);
+    if (!ik.setModel(chain) || !ik.setNrOfWorkerThreads(static_cast<size_t>(state.range(0))))
+    {
+        state.SkipWithError("Impossible to configure the IK");
+        return;
+    }
+    ik.setDefaultTargetResolutionMode(InverseKinematicsTreatTargetAsConstraintNone);
+
+    KinDynComputations kinDyn;
+    kinDyn.loadRobotModel(chain);
+    VectorDynSize s(chain.getNrOfPosCoords());
+    s.zero();
+    kinDyn.setJointPos(s);
+
+    ik.addFrameConstraint("link1", kinDyn.getWorldTransform("link1"));
+    ik.addTarget(targetFrame, kinDyn.getWorldTransform(targetFrame));
+
+    std::vector<InverseKinematicsBatchProblem> problems(nrOfProblems);
+    for (InverseKinematicsBatchProblem& problem : problems)
+    {
+        getRandomVector(s);
+        kinDyn.setJointPos(s);
+        problem.targetFrames.push_back(targetFrame);
+        problem.targetTransforms.push_back(kinDyn.getWorldTransform(targetFrame));
+        problem.initialBaseTransforms.assign(2, kinDyn.getWorldBaseTransform());
+        problem.initialJointsConfigurations.assign(2, VectorDynSize(chain.getNrOfPosCoords()));
+        problem.initialJointsConfigurations[0].zero();
+        getRandomVector(problem.initialJointsConfigurations[1]);
+    }
+
+    std::vector<InverseKinematicsBatchSolution> solutions;
+    for (auto _ : state)
+    {
+        bool ok = ik.solveBatch(problems, solutions);
+        benchmark::DoNotOptimize(ok);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nrOfProblems));
+}
+BENCHMARK(BM_InverseKinematicsBatch)->Arg(0)->Arg(1)->Arg(3)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * Solve a whole-body IK of the iCubGenova02 model, with the left foot fixed and
+ * targets on the right foot and on the upper arms.
+ */
+static void BM_InverseKinematicsWholeBody(benchmark::State& state, const std::string& modelName)
+{
+    ModelLoader loader;
+    if (!loader.loadModelFromFile(getBenchmarkModelPath(modelName)))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+    const Model& model = loader.model();
+
+    InverseKinematics ik;
+    ik.setVerbosity(0);
+    ik.setModel(model);
+    ik.setFloatingBaseOnFrameNamed("l_sole");
+    ik.setDefaultTargetResolutionMode(InverseKinematicsTreatTargetAsConstraintNone);
+
+    KinDynComputations kinDyn;
+    kinDyn.loadRobotModel(model);
+    kinDyn.setFloatingBase("l_sole");
+    VectorDynSize s(model.getNrOfPosCoords());
+    getRandomVector(s, -0.3, 0.3);
+    kinDyn.setJointPos(s);
+
+    bool ok = ik.addFrameConstraint("l_sole", kinDyn.getWorldTransform("l_sole"));
+    ok = ok && ik.addTarget("r_sole", kinDyn.getWorldTransform("r_sole"));
+    ok = ok && ik.addPositionTarget("l_upper_arm", kinDyn.getWorldTransform("l_upper_arm"));
+    ok = ok && ik.addPositionTarget("r_upper_arm", kinDyn.getWorldTransform("r_upper_arm"));
+    if (!ok)
+    {
+        state.SkipWithError("Impossible to configure the IK problem");
+        return;
+    }
+
+    Transform baseInitial = kinDyn.getWorldBaseTransform();
+    VectorDynSize sInitial(model.getNrOfPosCoords());
+    sInitial.zero();
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        ik.setFullJointsInitialCondition(&baseInitial, &sInitial);
+        ok = ik.solve();
+        benchmark::DoNotOptimize(ok);
+    }
+    allocations.report(state);
+}
+static bool BM_InverseKinematicsWholeBody_isRegistered =
+    registerBenchmarkOnModels("BM_InverseKinematicsWholeBody", {"iCubGenova02.urdf"}, BM_InverseKinematicsWholeBody);
@@ -0,0 +1,400 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/KinDynComputations.h>
+#include <iDynTree/KinDynComputationsBatch.h>
+#include <iDynTree/ModelLoader.h>
+
+#include <iDynTree/FreeFloatingState.h>
+#include <iDynTree/FreeFloatingMatrices.h>
+#include <iDynTree/LinkState.h>
+
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/MatrixDynSize.h>
+#include <iDynTree/VectorDynSize.h>
+#include <iDynTree/TestUtils.h>
+
+using namespace iDynTree;
+
+namespace
+{
+
+/**
+ * KinDynComputations object and a random robot state.
+ *
+ * All the benchmarks set the robot state at each iteration, so that the measured time
+ * includes the (lazy) computation of all the quantities needed by the measured getter,
+ * as it happens in a typical control loop. As KinDynComputations only invalidates the
+ * quantities that depend on the parts of the state that actually changed, setRobotState
+ * changes the base position, the joint positions and the joint velocities at each call.
+ */
+struct KinDynBenchmarkData
+{
+    KinDynComputations kinDyn;
+    Transform world_T_base;
+    VectorDynSize s;
+    Twist baseVel;
+    VectorDynSize s_dot;
+    Vector3 gravity;
+    FrameIndex lastFrame;
+
+    bool init(const std::string& modelName)
+    {
+        ModelLoader loader;
+        if (!loader.loadModelFromFile(getBenchmarkModelPath(modelName)) ||
+            !kinDyn.loadRobotModel(loader.model()))
+        {
+            return false;
+        }
+
+        size_t dofs = kinDyn.getNrOfDegreesOfFreedom();
+        s.resize(dofs);
+        s_dot.resize(dofs);
+        world_T_base = getRandomTransform();
+        baseVel = getRandomTwist();
+        getRandomVector(s);
+        getRandomVector(s_dot);
+        gravity.zero();
+        gravity(2) = -9.81;
+        lastFrame = static_cast<FrameIndex>(kinDyn.getNrOfFrames()-1);
+
+        return true;
+    }
+
+    void setRobotState()
+    {
+        Position world_p_base = world_T_base.getPosition();
+        world_p_base(0) = -world_p_base(0);
+        world_T_base.setPosition(world_p_base);
+        toEigen(s) = -toEigen(s);
+        toEigen(s_dot) = -toEigen(s_dot);
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+    }
+};
+
+}
+
+static void BM_KinDynSetRobotState(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.setRobotState();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynSetRobotState);
+
+static void BM_KinDynGetWorldTransform(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    MatrixDynSize world_T_frame(4, 4);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.setRobotState();
+        data.kinDyn.getWorldTransform(data.lastFrame, world_T_frame);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynGetWorldTransform);
+
+static void BM_KinDynGetFrameFreeFloatingJacobian(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    MatrixDynSize jacobian(6, data.kinDyn.getNrOfDegreesOfFreedom()+6);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.setRobotState();
+        data.kinDyn.getFrameFreeFloatingJacobian(data.lastFrame, jacobian);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynGetFrameFreeFloatingJacobian);
+
+// Number of frames used by the benchmarks of the jacobians of several frames,
+// evenly distributed among the frames of the model
+static const size_t nrOfJacobianFrames = 16;
+
+static std::vector<FrameIndex> getJacobianFrames(const KinDynComputations& kinDyn)
+{
+    std::vector<FrameIndex> frames(nrOfJacobianFrames);
+    for (size_t i=0; i < nrOfJacobianFrames; i++)
+    {
+        frames[i] = static_cast<FrameIndex>((i*kinDyn.getNrOfFrames())/nrOfJacobianFrames);
+    }
+    return frames;
+}
+
+static void BM_KinDynGetFrameFreeFloatingJacobianLoop(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    std::vector<FrameIndex> frames = getJacobianFrames(data.kinDyn);
+    MatrixDynSize jacobians(6*nrOfJacobianFrames, data.kinDyn.getNrOfDegreesOfFreedom()+6);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.setRobotState();
+        for (size_t i=0; i < nrOfJacobianFrames; i++)
+        {
+            data.kinDyn.getFrameFreeFloatingJacobian(frames[i], MatrixView<double>(jacobians).block(6*i, 0, 6, jacobians.cols()));
+        }
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynGetFrameFreeFloatingJacobianLoop);
+
+static void benchmarkGetFramesFreeFloatingJacobians(benchmark::State& state, const std::string& modelName,
+                                                    const size_t nrOfWorkerThreads)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName) || !data.kinDyn.setNrOfWorkerThreads(nrOfWorkerThreads))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    std::vector<FrameIndex> frames = getJacobianFrames(data.kinDyn);
+    MatrixDynSize jacobians(6*nrOfJacobianFrames, data.kinDyn.getNrOfDegreesOfFreedom()+6);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.setRobotState();
+        data.kinDyn.getFramesFreeFloatingJacobians(frames, jacobians);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+
+static void BM_KinDynGetFramesFreeFloatingJacobians(benchmark::State& state, const std::string& modelName)
+{
+    benchmarkGetFramesFreeFloatingJacobians(state, modelName, 0);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynGetFramesFreeFloatingJacobians);
+
+static void BM_KinDynGetFramesFreeFloatingJacobiansTwoWorkers(benchmark::State& state, const std::string& modelName)
+{
+    benchmarkGetFramesFreeFloatingJacobians(state, modelName, 2);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynGetFramesFreeFloatingJacobiansTwoWorkers);
+
+static void BM_KinDynGetFreeFloatingMassMatrix(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    MatrixDynSize massMatrix(data.kinDyn.getNrOfDegreesOfFreedom()+6, data.kinDyn.getNrOfDegreesOfFreedom()+6);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.setRobotState();
+        data.kinDyn.getFreeFloatingMassMatrix(massMatrix);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynGetFreeFloatingMassMatrix);
+
+static void BM_KinDynGeneralizedBiasForces(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    FreeFloatingGeneralizedTorques biasForces(data.kinDyn.model());
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.setRobotState();
+        data.kinDyn.generalizedBiasForces(biasForces);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynGeneralizedBiasForces);
+
+static void BM_KinDynInverseDynamics(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    Vector6 baseAcc;
+    getRandomVector(baseAcc);
+    VectorDynSize s_ddot(data.kinDyn.getNrOfDegreesOfFreedom());
+    getRandomVector(s_ddot);
+    LinkNetExternalWrenches linkExtWrenches(data.kinDyn.model());
+    linkExtWrenches.zero();
+    FreeFloatingGeneralizedTorques generalizedTorques(data.kinDyn.model());
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.setRobotState();
+        data.kinDyn.inverseDynamics(baseAcc, s_ddot, linkExtWrenches, generalizedTorques);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynInverseDynamics);
+
+static void BM_KinDynGetCenterOfMassJacobian(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    MatrixDynSize comJacobian(3, data.kinDyn.getNrOfDegreesOfFreedom()+6);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.setRobotState();
+        data.kinDyn.getCenterOfMassJacobian(comJacobian);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynGetCenterOfMassJacobian);
+
+static void BM_KinDynGetCentroidalTotalMomentumJacobian(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    MatrixDynSize momentumJacobian(6, data.kinDyn.getNrOfDegreesOfFreedom()+6);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        data.setRobotState();
+        data.kinDyn.getCentroidalTotalMomentumJacobian(momentumJacobian);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynGetCentroidalTotalMomentumJacobian);
+
+// Number of states used by the benchmarks comparing KinDynComputationsBatch with KinDynComputations
+static const size_t nrOfBatchStates = 64;
+
+static void BM_KinDynMassMatrixAndBiasForcesLoop(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    if (!data.init(modelName))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    size_t dofs = data.kinDyn.getNrOfDegreesOfFreedom();
+    MatrixDynSize massMatrix(dofs+6, dofs+6);
+    VectorDynSize biasForces(dofs+6);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        for (size_t k=0; k < nrOfBatchStates; k++)
+        {
+            data.setRobotState();
+            data.kinDyn.getFreeFloatingMassMatrix(massMatrix);
+            data.kinDyn.generalizedBiasForces(biasForces);
+        }
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations()*nrOfBatchStates);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynMassMatrixAndBiasForcesLoop);
+
+static void BM_KinDynBatchMassMatrixAndBiasForces(benchmark::State& state, const std::string& modelName)
+{
+    KinDynBenchmarkData data;
+    KinDynComputationsBatch batch;
+    if (!data.init(modelName) || !batch.loadRobotModel(data.kinDyn.model()))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    size_t dofs = data.kinDyn.getNrOfDegreesOfFreedom();
+    MatrixDynSize world_T_bases(4*nrOfBatchStates, 4), s(nrOfBatchStates, dofs);
+    MatrixDynSize baseVels(nrOfBatchStates, 6), s_dot(nrOfBatchStates, dofs);
+    for (size_t k=0; k < nrOfBatchStates; k++)
+    {
+        toEigen(world_T_bases).block<4,4>(4*k,0) = toEigen(data.world_T_base.asHomogeneousTransform());
+        for (int i=0; i < 6; i++)
+        {
+            baseVels(k,i) = data.baseVel(i);
+        }
+        toEigen(s).row(k) = toEigen(data.s).transpose();
+        toEigen(s_dot).row(k) = toEigen(data.s_dot).transpose();
+    }
+    MatrixDynSize massMatrices(nrOfBatchStates*(dofs+6), dofs+6), biasForces(nrOfBatchStates, dofs+6);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        batch.setRobotStates(world_T_bases, s, baseVels, s_dot, make_span(data.gravity));
+        batch.getFreeFloatingMassMatrices(massMatrices);
+        batch.generalizedBiasForces(biasForces);
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations()*nrOfBatchStates);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_KinDynBatchMassMatrixAndBiasForces);
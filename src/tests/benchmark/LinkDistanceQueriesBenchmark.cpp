@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/LinkDistanceQueries.h>
+
+#include <iDynTree/ForwardKinematics.h>
+#include <iDynTree/FreeFloatingState.h>
+#include <iDynTree/LinkState.h>
+#include <iDynTree/Model.h>
+#include <iDynTree/ModelLoader.h>
+#include <iDynTree/SolidShapes.h>
+#include <iDynTree/Traversal.h>
+
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/TestUtils.h>
+
+#include <Eigen/Geometry>
+
+#include <limits>
+
+using namespace iDynTree;
+
+/**
+ * Humanoid models of the test data directory.
+ */
+static const std::vector<std::string> humanoidModels = {"iCubGenova02.urdf", "bigman.urdf"};
+
+/**
+ * Replace the collision meshes of the model (whose bounding boxes need assimp) with a sphere in
+ * the origin of each link and a cylinder from the origin of each link to the origin of its neighbors.
+ */
+static void setSkeletonCollisionShapes(Model& model)
+{
+    const double sphereRadius = 0.04;
+    const double cylinderRadius = 0.025;
+
+    ModelSolidShapes& collisionShapes = model.collisionSolidShapes();
+    collisionShapes.resize(model);
+    for (LinkIndex link = 0; link < static_cast<LinkIndex>(model.getNrOfLinks()); link++)
+    {
+        collisionShapes.clearSingleLinkSolidShapes(link);
+
+        Sphere sphere;
+        sphere.setLink_H_geometry(Transform::Identity());
+        sphere.setRadius(sphereRadius);
+        collisionShapes.addSingleLinkSolidShape(link, sphere);
+
+        for (unsigned int i = 0; i < model.getNrOfNeighbors(link); i++)
+        {
+            Neighbor neighbor = model.getNeighbor(link, i);
+            if (neighbor.neighborLink < link)
+            {
+                continue;
+            }
+
+            Position link_p_neighbor = model.getJoint(neighbor.neighborJoint)->getRestTransform(link, neighbor.neighborLink).getPosition();
+            double length = toEigen(link_p_neighbor).norm();
+            if (length < 1e-3)
+            {
+                continue;
+            }
+
+            // The axis of the cylinder is the z axis of its frame
+            Rotation link_R_cylinder;
+            toEigen(link_R_cylinder) = Eigen::Quaterniond::FromTwoVectors(Eigen::Vector3d::UnitZ(), toEigen(link_p_neighbor)).toRotationMatrix();
+            Position link_p_cylinder;
+            toEigen(link_p_cylinder) = 0.5 * toEigen(link_p_neighbor);
+
+            Cylinder cylinder;
+            cylinder.setLink_H_geometry(Transform(link_R_cylinder, link_p_cylinder));
+            cylinder.setRadius(cylinderRadius);
+            cylinder.setLength(length);
+            collisionShapes.addSingleLinkSolidShape(link, cylinder);
+        }
+    }
+}
+
+/**
+ * Update the link positions and compute the distances of all the pairs of links, cycling on a set
+ * of random configurations.
+ */
+static void benchmarkComputeAllDistances(benchmark::State& state, const std::string& modelName, const double maxDistance)
+{
+    ModelLoader loader;
+    if (!loader.loadModelFromFile(getBenchmarkModelPath(modelName)))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+    Model model = loader.model();
+    setSkeletonCollisionShapes(model);
+
+    Traversal traversal;
+    model.computeFullTreeTraversal(traversal);
+
+    const size_t nrOfConfigurations = 100;
+    std::vector<LinkPositions> configurations(nrOfConfigurations, LinkPositions(model));
+    FreeFloatingPos robotPos(model);
+    robotPos.worldBasePos() = Transform::Identity();
+    for (auto& linkPositions : configurations)
+    {
+        getRandomVector(robotPos.jointPos(), -1.0, 1.0);
+        ForwardPositionKinematics(model, traversal, robotPos, linkPositions);
+    }
+
+    LinkDistanceQueriesOptions options;
+    options.maxDistance = maxDistance;
+    LinkDistanceQueries distanceQueries;
+    if (!distanceQueries.loadModel(model, options))
+    {
+        state.SkipWithError("Impossible to load the collision shapes");
+        return;
+    }
+
+    size_t configuration = 0;
+    size_t nrOfDistances = 0;
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        distanceQueries.updateLinkPositions(configurations[configuration]);
+        distanceQueries.computeAllDistances();
+        nrOfDistances += distanceQueries.getDistances().size();
+        configuration = (configuration + 1) % nrOfConfigurations;
+        benchmark::ClobberMemory();
+    }
+    allocations.report(state);
+    state.counters["checkedPairs"] = distanceQueries.getNrOfCheckedLinkPairs();
+    state.counters["distances"] = benchmark::Counter(nrOfDistances, benchmark::Counter::kAvgIterations);
+}
+
+static void BM_LinkDistanceQueriesComputeAllDistances(benchmark::State& state, const std::string& modelName)
+{
+    benchmarkComputeAllDistances(state, modelName, std::numeric_limits<double>::infinity());
+}
+static bool BM_LinkDistanceQueriesComputeAllDistances_isRegistered =
+    registerBenchmarkOnModels("BM_LinkDistanceQueriesComputeAllDistances", humanoidModels,
+                              BM_LinkDistanceQueriesComputeAllDistances);
+
+// Typical use in a controller, that needs only the pairs of links that are close to each other
+static void BM_LinkDistanceQueriesComputeDistancesWithin5cm(benchmark::State& state, const std::string& modelName)
+{
+    benchmarkComputeAllDistances(state, modelName, 0.05);
+}
+static bool BM_LinkDistanceQueriesComputeDistancesWithin5cm_isRegistered =
+    registerBenchmarkOnModels("BM_LinkDistanceQueriesComputeDistancesWithin5cm", humanoidModels,
+                              BM_LinkDistanceQueriesComputeDistancesWithin5cm);
@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/ModelLoader.h>
+
+using namespace iDynTree;
+
+static void BM_ModelLoaderLoadModelFromFile(benchmark::State& state, const std::string& modelName)
+{
+    std::string modelPath = getBenchmarkModelPath(modelName);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        ModelLoader loader;
+        bool ok = loader.loadModelFromFile(modelPath);
+        benchmark::DoNotOptimize(ok);
+    }
+    allocations.report(state);
+}
+IDYNTREE_BENCHMARK_ON_TEST_MODELS(BM_ModelLoaderLoadModelFromFile);
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/Model.h>
+#include <iDynTree/ModelTestUtils.h>
+
+#include <string>
+#include <vector>
+
+using namespace iDynTree;
+
+// The benchmarks look up all the names of a random model with state.range(0) joints
+// and state.range(0) additional frames, so that the result does not depend on the
+// position of the name in the model. The items_per_second counter reports the
+// number of lookups per second.
+
+static void BM_ModelGetLinkIndex(benchmark::State& state)
+{
+    Model model = getRandomModel(state.range(0), state.range(0));
+    std::vector<std::string> names;
+    for (LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+    {
+        names.push_back(model.getLinkName(lnk));
+    }
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        for (const std::string& name : names)
+        {
+            benchmark::DoNotOptimize(model.getLinkIndex(name));
+        }
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations()*names.size());
+}
+BENCHMARK(BM_ModelGetLinkIndex)->RangeMultiplier(10)->Range(10, 1000);
+
+static void BM_ModelGetJointIndex(benchmark::State& state)
+{
+    Model model = getRandomModel(state.range(0), state.range(0));
+    std::vector<std::string> names;
+    for (JointIndex jnt=0; jnt < static_cast<JointIndex>(model.getNrOfJoints()); jnt++)
+    {
+        names.push_back(model.getJointName(jnt));
+    }
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        for (const std::string& name : names)
+        {
+            benchmark::DoNotOptimize(model.getJointIndex(name));
+        }
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations()*names.size());
+}
+BENCHMARK(BM_ModelGetJointIndex)->RangeMultiplier(10)->Range(10, 1000);
+
+static void BM_ModelGetFrameIndex(benchmark::State& state)
+{
+    Model model = getRandomModel(state.range(0), state.range(0));
+    std::vector<std::string> names;
+    for (FrameIndex frame=0; frame < static_cast<FrameIndex>(model.getNrOfFrames()); frame++)
+    {
+        names.push_back(model.getFrameName(frame));
+    }
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        for (const std::string& name : names)
+        {
+            benchmark::DoNotOptimize(model.getFrameIndex(name));
+        }
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations()*names.size());
+}
+BENCHMARK(BM_ModelGetFrameIndex)->RangeMultiplier(10)->Range(10, 1000);
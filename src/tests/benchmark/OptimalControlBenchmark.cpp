@@ -0,0 +1,369 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+// Benchmarks of the evaluation of the constraints jacobian and of the hessians of the
+// multiple shooting transcription on long horizons, comparing the dense matrices with
+// the vectors of nonzero elements used by the sparse solvers.
+// The "outputBytes" counter reports the memory used by the evaluated jacobian or hessians.
+// The LinearMPC benchmarks measure the latency of a receding horizon tick as a function of the horizon length.
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/OptimalControlProblem.h>
+#include <iDynTree/OptimizationProblem.h>
+#include <iDynTree/Optimizer.h>
+#include <iDynTree/LinearSystem.h>
+#include <iDynTree/L2NormCost.h>
+#include <iDynTree/LinearConstraint.h>
+#include <iDynTree/LinearMPC.h>
+#include <iDynTree/QuadraticCost.h>
+#include <iDynTree/Optimizers/OsqpInterface.h>
+#include <iDynTree/Integrators/ForwardEuler.h>
+#include <iDynTree/OCSolvers/MultipleShootingSolver.h>
+
+#include <iDynTree/VectorDynSize.h>
+#include <iDynTree/MatrixDynSize.h>
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/TestUtils.h>
+
+#include <memory>
+#include <vector>
+
+using namespace iDynTree;
+using namespace iDynTree::optimalcontrol;
+
+// Optimizer that only gives access to the transcribed problem
+class TranscriptionAccessor : public optimization::Optimizer
+{
+public:
+    bool isAvailable() const override
+    {
+        return true;
+    }
+
+    bool solve() override
+    {
+        return false;
+    }
+
+    std::shared_ptr<optimization::OptimizationProblem> transcription()
+    {
+        return m_problem;
+    }
+};
+
+// Two double integrators controlled in acceleration
+static std::shared_ptr<LinearSystem> createDoubleIntegrators()
+{
+    std::shared_ptr<LinearSystem> system = std::make_shared<LinearSystem>(4, 2);
+    MatrixDynSize stateMatrix(4, 4), controlMatrix(4, 2);
+    stateMatrix.zero();
+    stateMatrix(0, 2) = 1.0;
+    stateMatrix(1, 3) = 1.0;
+    controlMatrix.zero();
+    controlMatrix(2, 0) = 1.0;
+    controlMatrix(3, 1) = 1.0;
+    system->setStateMatrix(stateMatrix);
+    system->setControlMatrix(controlMatrix);
+    return system;
+}
+
+// Double integrators with a bound on the controls, transcribed with a mesh point every control period.
+// The collocation constraints are evaluated by numberOfWorkerThreads threads in addition to the calling one.
+static std::shared_ptr<optimization::OptimizationProblem> createTranscription(size_t numberOfMeshPoints, size_t numberOfWorkerThreads = 0)
+{
+    const double controlPeriod = 0.01;
+
+    std::shared_ptr<LinearSystem> system = createDoubleIntegrators();
+
+    std::shared_ptr<OptimalControlProblem> problem = std::make_shared<OptimalControlProblem>();
+    problem->setDynamicalSystemConstraint(system);
+    problem->setTimeHorizon(0.0, controlPeriod * numberOfMeshPoints);
+    problem->addLagrangeTerm(1.0, std::make_shared<L2NormCost>("normCost", 4, 2));
+
+    std::shared_ptr<LinearConstraint> controlConstraint = std::make_shared<LinearConstraint>(2, "controlConstraint");
+    MatrixDynSize constraintMatrix(2, 2);
+    toEigen(constraintMatrix).setIdentity();
+    controlConstraint->setControlConstraintMatrix(constraintMatrix);
+    VectorDynSize bound(2);
+    toEigen(bound).setConstant(1.0);
+    controlConstraint->setUpperBound(bound);
+    problem->addConstraint(controlConstraint);
+
+    MultipleShootingSolver solver(problem);
+    solver.setIntegrator(std::make_shared<integrators::ForwardEuler>());
+    solver.setStepSizeBounds(controlPeriod / 3.0, controlPeriod);
+    solver.setControlPeriod(controlPeriod);
+    std::vector<std::shared_ptr<Integrator>> workerIntegrators;
+    for (size_t i = 0; i < numberOfWorkerThreads; ++i)
+    {
+        workerIntegrators.push_back(std::make_shared<integrators::ForwardEuler>(createDoubleIntegrators()));
+    }
+    solver.setWorkerIntegrators(workerIntegrators);
+    std::shared_ptr<TranscriptionAccessor> accessor = std::make_shared<TranscriptionAccessor>();
+    solver.setOptimizer(accessor);
+
+    std::shared_ptr<optimization::OptimizationProblem> transcription = accessor->transcription();
+    transcription->prepare();
+
+    VectorDynSize variables(transcription->numberOfVariables());
+    getRandomVector(variables);
+    transcription->setVariables(variables);
+    return transcription;
+}
+
+static void BM_ConstraintsJacobianDense(benchmark::State& state)
+{
+    std::shared_ptr<optimization::OptimizationProblem> transcription = createTranscription(state.range(0));
+    MatrixDynSize jacobian;
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        transcription->evaluateConstraintsJacobian(jacobian);
+        benchmark::DoNotOptimize(jacobian.data());
+    }
+    allocations.report(state);
+    state.counters["outputBytes"] = static_cast<double>(jacobian.rows() * jacobian.cols() * sizeof(double));
+}
+
+// Dense evaluation followed by the extraction of the nonzero elements, as done by the sparse solvers
+// before the problems could evaluate the nonzero elements directly
+static void BM_ConstraintsJacobianDenseToNonZeros(benchmark::State& state)
+{
+    std::shared_ptr<optimization::OptimizationProblem> transcription = createTranscription(state.range(0));
+    VectorDynSize nonZeros;
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        transcription->OptimizationProblem::evaluateConstraintsJacobianNonZeros(nonZeros);
+        benchmark::DoNotOptimize(nonZeros.data());
+    }
+    allocations.report(state);
+}
+
+static void BM_ConstraintsJacobianNonZeros(benchmark::State& state)
+{
+    std::shared_ptr<optimization::OptimizationProblem> transcription = createTranscription(state.range(0));
+    VectorDynSize nonZeros;
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        transcription->evaluateConstraintsJacobianNonZeros(nonZeros);
+        benchmark::DoNotOptimize(nonZeros.data());
+    }
+    allocations.report(state);
+    state.counters["outputBytes"] = static_cast<double>(nonZeros.size() * sizeof(double));
+}
+
+static void BM_HessiansDense(benchmark::State& state)
+{
+    std::shared_ptr<optimization::OptimizationProblem> transcription = createTranscription(state.range(0));
+    MatrixDynSize costHessian, constraintsHessian;
+    VectorDynSize multipliers(transcription->numberOfConstraints());
+    getRandomVector(multipliers);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        transcription->evaluateCostHessian(costHessian);
+        transcription->evaluateConstraintsHessian(multipliers, constraintsHessian);
+        benchmark::DoNotOptimize(costHessian.data());
+        benchmark::DoNotOptimize(constraintsHessian.data());
+    }
+    allocations.report(state);
+    state.counters["outputBytes"] = static_cast<double>(2 * costHessian.rows() * costHessian.cols() * sizeof(double));
+}
+
+static void BM_HessiansNonZeros(benchmark::State& state)
+{
+    std::shared_ptr<optimization::OptimizationProblem> transcription = createTranscription(state.range(0));
+    VectorDynSize costHessian, constraintsHessian;
+    VectorDynSize multipliers(transcription->numberOfConstraints());
+    getRandomVector(multipliers);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        transcription->evaluateCostHessianNonZeros(costHessian);
+        transcription->evaluateConstraintsHessianNonZeros(multipliers, constraintsHessian);
+        benchmark::DoNotOptimize(costHessian.data());
+        benchmark::DoNotOptimize(constraintsHessian.data());
+    }
+    allocations.report(state);
+    state.counters["outputBytes"] = static_cast<double>(2 * costHessian.size() * sizeof(double));
+}
+
+// Evaluation of all the constraints quantities needed by an NLP iteration, with the collocation
+// constraints of the mesh intervals split on multiple threads
+static void BM_ConstraintsEvaluationWorkerThreads(benchmark::State& state)
+{
+    std::shared_ptr<optimization::OptimizationProblem> transcription = createTranscription(state.range(0), state.range(1));
+    VectorDynSize constraints, jacobian, hessian;
+    VectorDynSize multipliers(transcription->numberOfConstraints());
+    getRandomVector(multipliers);
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        transcription->evaluateConstraints(constraints);
+        transcription->evaluateConstraintsJacobianNonZeros(jacobian);
+        transcription->evaluateConstraintsHessianNonZeros(multipliers, hessian);
+        benchmark::DoNotOptimize(constraints.data());
+        benchmark::DoNotOptimize(jacobian.data());
+        benchmark::DoNotOptimize(hessian.data());
+    }
+    allocations.report(state);
+}
+
+// Number of mesh points of the horizon
+BENCHMARK(BM_ConstraintsJacobianDense)->Arg(50)->Arg(200)->Arg(400)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ConstraintsJacobianDenseToNonZeros)->Arg(50)->Arg(200)->Arg(400)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ConstraintsJacobianNonZeros)->Arg(50)->Arg(200)->Arg(400)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_HessiansDense)->Arg(50)->Arg(200)->Arg(400)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_HessiansNonZeros)->Arg(50)->Arg(200)->Arg(400)->Unit(benchmark::kMicrosecond);
+// Number of mesh points of the horizon, number of worker threads
+BENCHMARK(BM_ConstraintsEvaluationWorkerThreads)->ArgsProduct({{400}, {0, 1, 3}})->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+// Performs the work that a QP solver does on the problem at each tick (evaluating the vectors, and the matrices
+// only when they changed), without solving the QP, so to measure the cost of updating the MPC problem
+class QPUpdateOnly : public optimization::Optimizer
+{
+    VectorDynSize m_variables, m_gradient, m_lowerBounds, m_upperBounds, m_hessian, m_jacobian, m_guess;
+
+public:
+    bool isAvailable() const override
+    {
+        return true;
+    }
+
+    bool solve() override
+    {
+        if (!m_problem->prepare())
+        {
+            return false;
+        }
+        m_variables.resize(m_problem->numberOfVariables());
+        m_variables.zero();
+        bool ok = m_problem->setVariables(m_variables);
+        ok = ok && m_problem->evaluateCostGradient(m_gradient);
+        ok = ok && m_problem->getConstraintsBounds(m_lowerBounds, m_upperBounds);
+        if (!m_problem->info().hessianIsUnchanged())
+        {
+            ok = ok && m_problem->evaluateCostHessianNonZeros(m_hessian);
+        }
+        if (!m_problem->info().constraintsJacobianIsUnchanged())
+        {
+            ok = ok && m_problem->evaluateConstraintsJacobianNonZeros(m_jacobian);
+        }
+        if (m_problem->getGuess(m_guess))
+        {
+            m_variables = m_guess;
+        }
+        return ok;
+    }
+
+    bool getPrimalVariables(VectorDynSize& primalVariables) override
+    {
+        primalVariables = m_variables;
+        return true;
+    }
+};
+
+// Two double integrators tracking a reference, with bounded controls
+static void configureMPC(LinearMPC& mpc, size_t numberOfSteps, LinearMPCFormulation formulation)
+{
+    mpc.setHorizon(numberOfSteps, 0.01);
+    mpc.setFormulation(formulation);
+
+    MatrixDynSize stateHessian(4, 4), controlHessian(2, 2);
+    toEigen(stateHessian).setIdentity();
+    toEigen(controlHessian).setIdentity();
+    toEigen(controlHessian) *= 0.01;
+    VectorDynSize stateGradient(4), controlGradient(2);
+    getRandomVector(stateGradient);
+    controlGradient.zero();
+    std::shared_ptr<QuadraticCost> cost = std::make_shared<QuadraticCost>("trackingCost");
+    cost->setStateCost(stateHessian, stateGradient);
+    cost->setControlCost(controlHessian, controlGradient);
+    mpc.setStageCost(cost);
+
+    std::shared_ptr<LinearConstraint> controlBounds = std::make_shared<LinearConstraint>(2, "controlBounds");
+    MatrixDynSize identity(2, 2);
+    toEigen(identity).setIdentity();
+    controlBounds->setControlConstraintMatrix(identity);
+    VectorDynSize bound(2);
+    toEigen(bound).setConstant(1.0);
+    controlBounds->setUpperBound(bound);
+    toEigen(bound).setConstant(-1.0);
+    controlBounds->setLowerBound(bound);
+    mpc.addConstraint(controlBounds);
+}
+
+static void runMPCTicks(benchmark::State& state, std::shared_ptr<optimization::Optimizer> optimizer, LinearMPCFormulation formulation)
+{
+    LinearMPC mpc(createDoubleIntegrators());
+    configureMPC(mpc, state.range(0), formulation);
+    mpc.setOptimizer(optimizer);
+
+    VectorDynSize stateFeedback(4), control(2);
+    getRandomVector(stateFeedback);
+    double time = 0.0;
+    // The first tick builds the QP
+    if (!mpc.setStateFeedback(time, stateFeedback) || !mpc.doControl(control))
+    {
+        state.SkipWithError("Impossible to solve the MPC problem");
+        return;
+    }
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        time += 0.01;
+        toEigen(stateFeedback)(0) += 1e-3;
+        mpc.setStateFeedback(time, stateFeedback);
+        mpc.doControl(control);
+        benchmark::DoNotOptimize(control.data());
+    }
+    allocations.report(state);
+}
+
+static void BM_LinearMPCUpdateSparse(benchmark::State& state)
+{
+    runMPCTicks(state, std::make_shared<QPUpdateOnly>(), LinearMPCFormulation::Sparse);
+}
+
+static void BM_LinearMPCUpdateCondensed(benchmark::State& state)
+{
+    runMPCTicks(state, std::make_shared<QPUpdateOnly>(), LinearMPCFormulation::Condensed);
+}
+
+static void runOsqpMPCTicks(benchmark::State& state, LinearMPCFormulation formulation)
+{
+    std::shared_ptr<optimization::OsqpInterface> osqp = std::make_shared<optimization::OsqpInterface>();
+    if (!osqp->isAvailable())
+    {
+        state.SkipWithError("iDynTree compiled without OSQP support");
+        return;
+    }
+    osqp->settings().verbose = false;
+    runMPCTicks(state, osqp, formulation);
+}
+
+static void BM_LinearMPCTickOsqpSparse(benchmark::State& state)
+{
+    runOsqpMPCTicks(state, LinearMPCFormulation::Sparse);
+}
+
+static void BM_LinearMPCTickOsqpCondensed(benchmark::State& state)
+{
+    runOsqpMPCTicks(state, LinearMPCFormulation::Condensed);
+}
+
+// Number of steps of the horizon
+BENCHMARK(BM_LinearMPCUpdateSparse)->Arg(20)->Arg(50)->Arg(100)->Arg(200)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LinearMPCUpdateCondensed)->Arg(20)->Arg(50)->Arg(100)->Arg(200)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LinearMPCTickOsqpSparse)->Arg(20)->Arg(50)->Arg(100)->Arg(200)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LinearMPCTickOsqpCondensed)->Arg(20)->Arg(50)->Arg(100)->Arg(200)->Unit(benchmark::kMicrosecond);
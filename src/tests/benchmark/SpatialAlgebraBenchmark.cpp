@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+// Micro-benchmarks of the single spatial algebra operations performed for each link by the model
+// algorithms, comparing the operators of the iDynTree classes with the inline kernels of EigenSpatialKernels.h
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/Transform.h>
+#include <iDynTree/Twist.h>
+#include <iDynTree/Wrench.h>
+#include <iDynTree/SpatialInertia.h>
+
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/EigenSpatialKernels.h>
+#include <iDynTree/TestUtils.h>
+
+using namespace iDynTree;
+
+static void BM_TransformCompose(benchmark::State& state)
+{
+    Transform a_H_b = getRandomTransform();
+    Transform b_H_c = getRandomTransform();
+    Transform a_H_c;
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        a_H_c = a_H_b*b_H_c;
+        benchmark::DoNotOptimize(a_H_c);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_TransformCompose);
+
+static void BM_TransformComposeKernel(benchmark::State& state)
+{
+    Transform a_H_b = getRandomTransform();
+    Transform b_H_c = getRandomTransform();
+    Transform a_H_c;
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        composeTransforms(a_H_b, b_H_c, a_H_c);
+        benchmark::DoNotOptimize(a_H_c);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_TransformComposeKernel);
+
+static void BM_TransformInverseTwist(benchmark::State& state)
+{
+    Transform a_H_b = getRandomTransform();
+    Twist v_a = getRandomTwist();
+    Twist v_b;
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        v_b = a_H_b.inverse()*v_a;
+        benchmark::DoNotOptimize(v_b);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_TransformInverseTwist);
+
+static void BM_TransformInverseTwistKernel(benchmark::State& state)
+{
+    Transform a_H_b = getRandomTransform();
+    Twist v_a = getRandomTwist();
+    Twist v_b;
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        fromEigen(v_b, inverseTransformMotionVector(a_H_b, toEigen(v_a)));
+        benchmark::DoNotOptimize(v_b);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_TransformInverseTwistKernel);
+
+static void BM_TransformWrenchAccumulate(benchmark::State& state)
+{
+    Transform a_H_b = getRandomTransform();
+    Wrench f_b = getRandomWrench();
+    Wrench f_a = getRandomWrench();
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        f_a = f_a + a_H_b*f_b;
+        benchmark::DoNotOptimize(f_a);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_TransformWrenchAccumulate);
+
+static void BM_TransformWrenchAccumulateKernel(benchmark::State& state)
+{
+    Transform a_H_b = getRandomTransform();
+    Wrench f_b = getRandomWrench();
+    SpatialVector6d f_a = toEigen(getRandomWrench());
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        f_a += transformForceVector(a_H_b, toEigen(f_b));
+        benchmark::DoNotOptimize(f_a);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_TransformWrenchAccumulateKernel);
+
+static void BM_SpatialInertiaAccumulate(benchmark::State& state)
+{
+    Transform a_H_b = getRandomTransform();
+    SpatialInertia I_b = getRandomInertia();
+    SpatialInertia I_a = getRandomInertia();
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        I_a = I_a + a_H_b*I_b;
+        benchmark::DoNotOptimize(I_a);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_SpatialInertiaAccumulate);
+
+static void BM_SpatialInertiaAccumulateKernel(benchmark::State& state)
+{
+    Transform a_H_b = getRandomTransform();
+    SpatialInertia I_b = getRandomInertia();
+    SpatialInertia I_a = getRandomInertia();
+
+    HeapAllocationsCounter allocations;
+    for (auto _ : state)
+    {
+        addTransformedSpatialInertia(a_H_b, I_b, I_a);
+        benchmark::DoNotOptimize(I_a);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_SpatialInertiaAccumulateKernel);
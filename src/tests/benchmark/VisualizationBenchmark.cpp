@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "BenchmarkUtils.h"
+
+#include <iDynTree/ModelLoader.h>
+#include <iDynTree/Visualizer.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace iDynTree;
+
+/**
+ * Offscreen rendering of a model on a 1280x720 ITexture, as when generating synthetic camera images.
+ * The argument selects how the frame is read back: 0 not read, 1 getPixels, 2 getRawPixels.
+ */
+static void BM_VisualizerTextureRendering(benchmark::State& state)
+{
+    ModelLoader loader;
+    if (!loader.loadModelFromFile(getBenchmarkModelPath("iCubGenova02.urdf")))
+    {
+        state.SkipWithError("Impossible to load the model");
+        return;
+    }
+
+    Visualizer viz;
+    VisualizerOptions textureOptions;
+    textureOptions.winWidth = 1280;
+    textureOptions.winHeight = 720;
+    if (!viz.init() || !viz.addModel(loader.model(), "model"))
+    {
+        state.SkipWithError("Impossible to initialize the visualizer");
+        return;
+    }
+
+    ITexture* texture = viz.textures().add("benchmarkTexture", textureOptions);
+    if (!texture)
+    {
+        state.SkipWithError("Impossible to add the texture");
+        return;
+    }
+
+    std::vector<PixelViz> pixels;
+    std::vector<std::uint8_t> rawPixels(4 * texture->width() * texture->height());
+
+    for (auto _ : state)
+    {
+        viz.draw();
+        if (state.range(0) == 1)
+        {
+            texture->getPixels(pixels);
+        }
+        else if (state.range(0) == 2)
+        {
+            texture->getRawPixels(make_span(rawPixels));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.counters["fps"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+
+    viz.close();
+}
+BENCHMARK(BM_VisualizerTextureRendering)->ArgName("readback")->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/TestUtils.h>
+
+#include <iDynTree/Model.h>
+#include <iDynTree/Traversal.h>
+
+#include <iDynTree/ModelLoader.h>
+
+#include <iDynTree/ForwardKinematics.h>
+#include <iDynTree/Dynamics.h>
+
+#include <iDynTree/LinkState.h>
+#include <iDynTree/FreeFloatingState.h>
+#include <iDynTree/FreeFloatingMatrices.h>
+
+#include "testModels.h"
+
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace iDynTree;
+
+/**
+ * Compute forward kinematics and inverse dynamics for a set of robot states,
+ * using only buffers owned by the caller.
+ */
+void computeKinematicsAndDynamics(const Model & model,
+                                  const Traversal & traversal,
+                                  const std::vector<FreeFloatingPos> & robotPos,
+                                  const std::vector<FreeFloatingVel> & robotVel,
+                                  std::vector<LinkPositions> & linkPos,
+                                  std::vector<FreeFloatingGeneralizedTorques> & generalizedTorques)
+{
+    LinkVelArray linkVel(model);
+    LinkAccArray linkAcc(model);
+    LinkNetExternalWrenches linkExtWrenches(model);
+    LinkInternalWrenches linkIntWrenches(model);
+    FreeFloatingAcc robotAcc(model);
+    linkExtWrenches.zero();
+    robotAcc.baseAcc().zero();
+    robotAcc.jointAcc().zero();
+
+    for (size_t i=0; i < robotPos.size(); i++)
+    {
+        bool ok = ForwardPosVelAccKinematics(model, traversal, robotPos[i], robotVel[i], robotAcc,
+                                             linkPos[i], linkVel, linkAcc);
+        ASSERT_IS_TRUE(ok);
+        ok = RNEADynamicPhase(model, traversal, robotPos[i].jointPos(), linkVel, linkAcc,
+                              linkExtWrenches, linkIntWrenches, generalizedTorques[i]);
+        ASSERT_IS_TRUE(ok);
+    }
+}
+
+/**
+ * Check that the same (const) Model can be used concurrently by several threads,
+ * obtaining the same results of a sequential evaluation.
+ */
+void checkConcurrentEvaluationOnSharedModel(const Model & model)
+{
+    Traversal traversal;
+    bool ok = model.computeFullTreeTraversal(traversal);
+    ASSERT_IS_TRUE(ok);
+
+    const size_t nrOfStates = 50;
+    const size_t nrOfThreads = 4;
+
+    std::vector<FreeFloatingPos> robotPos(nrOfStates, FreeFloatingPos(model));
+    std::vector<FreeFloatingVel> robotVel(nrOfStates, FreeFloatingVel(model));
+    for (size_t i=0; i < nrOfStates; i++)
+    {
+        robotPos[i].worldBasePos() = getRandomTransform();
+        robotVel[i].baseVel() = getRandomTwist();
+        getRandomVector(robotPos[i].jointPos());
+        getRandomVector(robotVel[i].jointVel());
+    }
+
+    std::vector<LinkPositions> expectedLinkPos(nrOfStates, LinkPositions(model));
+    std::vector<FreeFloatingGeneralizedTorques> expectedTorques(nrOfStates, FreeFloatingGeneralizedTorques(model));
+    computeKinematicsAndDynamics(model, traversal, robotPos, robotVel, expectedLinkPos, expectedTorques);
+
+    std::vector< std::vector<LinkPositions> > linkPos(nrOfThreads,
+        std::vector<LinkPositions>(nrOfStates, LinkPositions(model)));
+    std::vector< std::vector<FreeFloatingGeneralizedTorques> > torques(nrOfThreads,
+        std::vector<FreeFloatingGeneralizedTorques>(nrOfStates, FreeFloatingGeneralizedTorques(model)));
+
+    std::vector<std::thread> workers;
+    for (size_t t=0; t < nrOfThreads; t++)
+    {
+        workers.emplace_back(computeKinematicsAndDynamics, std::cref(model), std::cref(traversal),
+                             std::cref(robotPos), std::cref(robotVel),
+                             std::ref(linkPos[t]), std::ref(torques[t]));
+    }
+
+    for (auto & worker : workers)
+    {
+        worker.join();
+    }
+
+    for (size_t t=0; t < nrOfThreads; t++)
+    {
+        for (size_t i=0; i < nrOfStates; i++)
+        {
+            for (LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+            {
+                ASSERT_EQUAL_TRANSFORM(expectedLinkPos[i](lnk), linkPos[t][i](lnk));
+            }
+            ASSERT_EQUAL_VECTOR(expectedTorques[i].jointTorques(), torques[t][i].jointTorques());
+            ASSERT_EQUAL_VECTOR(expectedTorques[i].baseWrench().asVector(), torques[t][i].baseWrench().asVector());
+        }
+    }
+}
+
+int main()
+{
+    for (unsigned int mdl = 0; mdl < IDYNTREE_TESTS_URDFS_NR; mdl++)
+    {
+        std::string urdfFileName = getAbsModelPath(std::string(IDYNTREE_TESTS_URDFS[mdl]));
+        std::cout << "Checking concurrent kinematics on " << urdfFileName << std::endl;
+        ModelLoader loader;
+        bool ok = loader.loadModelFromFile(urdfFileName);
+        ASSERT_IS_TRUE(ok);
+        checkConcurrentEvaluationOnSharedModel(loader.model());
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -12,6 +12,10 @@
 
 #include <iDynTree/ForwardKinematics.h>
 #include <iDynTree/Dynamics.h>
+#include <iDynTree/DynamicsDerivatives.h>
+#include <iDynTree/MassMatrixFactorization.h>
+#include <iDynTree/SparseMatrix.h>
+#include <iDynTree/EigenSparseHelpers.h>
 
 #include <iDynTree/JointState.h>
 #include <iDynTree/LinkState.h>
@@ -20,9 +24,11 @@
 
 #include "testModels.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
+#include <limits>
 
 using namespace iDynTree;
 
@@ -161,6 +167,291 @@ void checkInverseAndForwardDynamicsAreIdempotent(const Model & model,
     ASSERT_EQUAL_VECTOR_TOL(REGR_jointTorques, RNEA_baseForceAndJointTorques.jointTorques(), tolRegr);
 }
 
+void checkIncrementalForwardPositionKinematics(const Model & model,
+                                               const Traversal & traversal)
+{
+    FreeFloatingPos robotPos(model);
+    LinkPositions linkPos(model), linkPosFull(model);
+    ForwardPositionKinematicsIncrementalBuffers buffers(model);
+
+    robotPos.worldBasePos() = getRandomTransform();
+    getRandomVector(robotPos.jointPos());
+
+    // The first call computes all the links
+    bool ok = ForwardPositionKinematicsIncremental(model, traversal, robotPos, buffers, linkPos);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(buffers.nrOfUpdatedLinks == model.getNrOfLinks());
+
+    // If the position does not change, no link is recomputed
+    ok = ForwardPositionKinematicsIncremental(model, traversal, robotPos, buffers, linkPos);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(buffers.nrOfUpdatedLinks == 0);
+
+    for(JointIndex jnt=0; jnt < static_cast<JointIndex>(model.getNrOfJoints()); jnt++)
+    {
+        IJointConstPtr joint = model.getJoint(jnt);
+        if( joint->getNrOfPosCoords() == 0 )
+        {
+            continue;
+        }
+
+        // Change a single joint: only the links in its subtree (with respect to the traversal) should move
+        robotPos.jointPos()(joint->getPosCoordsOffset()) += getRandomDouble(0.1, 1.0);
+        ok = ForwardPositionKinematicsIncremental(model, traversal, robotPos, buffers, linkPos);
+        ASSERT_IS_TRUE(ok);
+        ok = ForwardPositionKinematics(model, traversal, robotPos, linkPosFull);
+        ASSERT_IS_TRUE(ok);
+
+        size_t nrOfMovedLinks = 0;
+        for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+        {
+            ASSERT_EQUAL_TRANSFORM(linkPos(lnk), linkPosFull(lnk));
+
+            // A link is in the subtree of the joint if the joint is on its path to the base
+            LinkIndex visitedLink = lnk;
+            while( traversal.getParentLinkFromLinkIndex(visitedLink) != 0 )
+            {
+                if( traversal.getParentJointFromLinkIndex(visitedLink)->getIndex() == jnt )
+                {
+                    nrOfMovedLinks++;
+                    break;
+                }
+                visitedLink = traversal.getParentLinkFromLinkIndex(visitedLink)->getIndex();
+            }
+        }
+        ASSERT_IS_TRUE(buffers.nrOfUpdatedLinks == nrOfMovedLinks);
+    }
+
+    // A change of the base pose moves all the links
+    robotPos.worldBasePos() = getRandomTransform();
+    ok = ForwardPositionKinematicsIncremental(model, traversal, robotPos, buffers, linkPos);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(buffers.nrOfUpdatedLinks == model.getNrOfLinks());
+    ok = ForwardPositionKinematics(model, traversal, robotPos, linkPosFull);
+    ASSERT_IS_TRUE(ok);
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+    {
+        ASSERT_EQUAL_TRANSFORM(linkPos(lnk), linkPosFull(lnk));
+    }
+}
+
+void checkMassMatrixLTLFactorization(const Model & model,
+                                     const Traversal & traversal)
+{
+    FreeFloatingPos robotPos(model);
+    getRandomVector(robotPos.jointPos());
+
+    LinkCompositeRigidBodyInertias linkCRBs(model);
+    FreeFloatingMassMatrix massMatrix(model);
+    bool ok = CompositeRigidBodyAlgorithm(model, traversal, robotPos.jointPos(), linkCRBs, massMatrix);
+    ASSERT_IS_TRUE(ok);
+
+    MassMatrixLTLFactorization factorization(model, traversal);
+    ok = factorization.factorize(massMatrix);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(factorization.getNrOfNonZeros() <= (massMatrix.rows()*(massMatrix.rows()+1))/2);
+
+    // Check that L^T L = M
+    SparseMatrix<ColumnMajor> L;
+    ok = factorization.getFactor(L);
+    ASSERT_IS_TRUE(ok);
+    MatrixDynSize LTL(massMatrix.rows(), massMatrix.cols());
+    toEigen(LTL) = toEigen(L).transpose()*toEigen(L);
+    ASSERT_EQUAL_MATRIX_TOL(LTL, massMatrix, 1e-10);
+
+    // Check M^{-1} b, by checking the residual as the mass matrix of some models is badly conditioned
+    VectorDynSize b(massMatrix.rows()), x(massMatrix.rows()), residual(massMatrix.rows());
+    getRandomVector(b);
+    ok = factorization.solve(make_span(b), make_span(x));
+    ASSERT_IS_TRUE(ok);
+    toEigen(residual) = toEigen(massMatrix)*toEigen(x);
+    ASSERT_EQUAL_VECTOR_TOL(residual, b, 1e-8);
+
+    // Check M^{-1} J^T
+    MatrixDynSize jacobian(6, massMatrix.cols()), invMassJacobianT(massMatrix.rows(), 6), jacobianT(massMatrix.rows(), 6);
+    getRandomMatrix(jacobian);
+    ok = factorization.multiplyInverseByTransposed(jacobian, invMassJacobianT);
+    ASSERT_IS_TRUE(ok);
+    toEigen(jacobianT) = toEigen(massMatrix)*toEigen(invMassJacobianT);
+    ASSERT_EQUAL_MATRIX_TOL(jacobianT, toEigen(jacobian).transpose(), 1e-8);
+}
+
+void computeInverseDynamics(const Model & model,
+                            const Traversal & traversal,
+                            const FreeFloatingPos & robotPos,
+                            const FreeFloatingVel & robotVel,
+                            const FreeFloatingAcc & robotAcc,
+                            const LinkNetExternalWrenches & linkExtWrenches,
+                                  VectorDynSize & generalizedTorques)
+{
+    LinkVelArray linksVel(model);
+    LinkAccArray linksAcc(model);
+    LinkInternalWrenches linkIntWrenches(model);
+    FreeFloatingGeneralizedTorques baseForceAndJointTorques(model);
+    bool ok = ForwardVelAccKinematics(model, traversal, robotPos, robotVel, robotAcc, linksVel, linksAcc);
+    ok = ok && RNEADynamicPhase(model, traversal, robotPos.jointPos(), linksVel, linksAcc,
+                                linkExtWrenches, linkIntWrenches, baseForceAndJointTorques);
+    ASSERT_IS_TRUE(ok);
+    generalizedTorques.resize(6+model.getNrOfDOFs());
+    toEigen(generalizedTorques).head<6>() = toEigen(baseForceAndJointTorques.baseWrench());
+    toEigen(generalizedTorques).tail(model.getNrOfDOFs()) = toEigen(baseForceAndJointTorques.jointTorques());
+}
+
+void computeForwardDynamics(const Model & model,
+                            const Traversal & traversal,
+                            const FreeFloatingPos & robotPos,
+                            const FreeFloatingVel & robotVel,
+                            const LinkNetExternalWrenches & linkExtWrenches,
+                            const JointDOFsDoubleArray & jointTorques,
+                                  VectorDynSize & acc)
+{
+    ArticulatedBodyAlgorithmInternalBuffers bufs(model);
+    FreeFloatingAcc robotAcc(model);
+    bool ok = ArticulatedBodyAlgorithm(model, traversal, robotPos, robotVel, linkExtWrenches, jointTorques, bufs, robotAcc);
+    ASSERT_IS_TRUE(ok);
+    acc.resize(6+model.getNrOfDOFs());
+    toEigen(acc).head<6>() = toEigen(robotAcc.baseAcc());
+    toEigen(acc).tail(model.getNrOfDOFs()) = toEigen(robotAcc.jointAcc());
+}
+
+void assertColumnEqualToFiniteDifference(const MatrixDynSize & derivative, size_t col,
+                                         const VectorDynSize & plus, const VectorDynSize & minus, double h)
+{
+    Eigen::VectorXd finiteDifference = (toEigen(plus) - toEigen(minus))/(2*h);
+    // The second term accounts for the round-off error of the finite differences, that is not negligible
+    // for models with very light links (for which the accelerations computed by the ABA are large)
+    double maxAbsValue = std::max(toEigen(plus).cwiseAbs().maxCoeff(), toEigen(minus).cwiseAbs().maxCoeff());
+    double tol = 1e-4*(1.0 + finiteDifference.cwiseAbs().maxCoeff()) +
+                 10*std::numeric_limits<double>::epsilon()*maxAbsValue/h;
+    ASSERT_EQUAL_VECTOR_TOL(toEigen(derivative).col(col), finiteDifference, tol);
+}
+
+void checkDynamicsDerivatives(const Model & model,
+                              const Traversal & traversal)
+{
+    const size_t dofs = model.getNrOfDOFs();
+    const double h = 1e-4;
+
+    FreeFloatingPos robotPos(model);
+    FreeFloatingVel robotVel(model);
+    FreeFloatingAcc robotAcc(model);
+    LinkNetExternalWrenches linkExtWrenches(model);
+    JointDOFsDoubleArray jointTorques(model);
+
+    robotPos.worldBasePos() = getRandomTransform();
+    robotVel.baseVel() = getRandomTwist();
+    robotAcc.baseAcc() = getRandomTwist();
+    getRandomVector(robotPos.jointPos());
+    getRandomVector(robotVel.jointVel());
+    getRandomVector(robotAcc.jointAcc());
+    getRandomVector(jointTorques);
+    for(LinkIndex lnk=0; lnk < static_cast<LinkIndex>(model.getNrOfLinks()); lnk++)
+    {
+        linkExtWrenches(lnk) = getRandomWrench();
+    }
+
+    // Inverse dynamics
+    InverseDynamicsDerivativesInternalBuffers idBufs(model);
+    FreeFloatingGeneralizedTorques baseForceAndJointTorques(model);
+    MatrixDynSize dTau_dJointPos, dTau_dVel;
+    bool ok = InverseDynamicsDerivatives(model, traversal, robotPos, robotVel, robotAcc, linkExtWrenches,
+                                         idBufs, baseForceAndJointTorques, dTau_dJointPos, dTau_dVel);
+    ASSERT_IS_TRUE(ok);
+
+    VectorDynSize tau, tauPlus, tauMinus;
+    computeInverseDynamics(model, traversal, robotPos, robotVel, robotAcc, linkExtWrenches, tau);
+    ASSERT_EQUAL_VECTOR_TOL(baseForceAndJointTorques.baseWrench(), toEigen(tau).head<6>(), 1e-8);
+    ASSERT_EQUAL_VECTOR_TOL(baseForceAndJointTorques.jointTorques(), toEigen(tau).tail(dofs), 1e-8);
+
+    for(size_t dof=0; dof < dofs; dof++)
+    {
+        FreeFloatingPos robotPosPerturbed = robotPos;
+        robotPosPerturbed.jointPos()(dof) = robotPos.jointPos()(dof) + h;
+        computeInverseDynamics(model, traversal, robotPosPerturbed, robotVel, robotAcc, linkExtWrenches, tauPlus);
+        robotPosPerturbed.jointPos()(dof) = robotPos.jointPos()(dof) - h;
+        computeInverseDynamics(model, traversal, robotPosPerturbed, robotVel, robotAcc, linkExtWrenches, tauMinus);
+        assertColumnEqualToFiniteDifference(dTau_dJointPos, dof, tauPlus, tauMinus, h);
+    }
+
+    for(size_t i=0; i < 6+dofs; i++)
+    {
+        FreeFloatingVel robotVelPlus = robotVel, robotVelMinus = robotVel;
+        if (i < 6)
+        {
+            robotVelPlus.baseVel()(i) += h;
+            robotVelMinus.baseVel()(i) -= h;
+        }
+        else
+        {
+            robotVelPlus.jointVel()(i-6) += h;
+            robotVelMinus.jointVel()(i-6) -= h;
+        }
+        computeInverseDynamics(model, traversal, robotPos, robotVelPlus, robotAcc, linkExtWrenches, tauPlus);
+        computeInverseDynamics(model, traversal, robotPos, robotVelMinus, robotAcc, linkExtWrenches, tauMinus);
+        assertColumnEqualToFiniteDifference(dTau_dVel, i, tauPlus, tauMinus, h);
+    }
+
+    // Forward dynamics
+    FreeFloatingAcc robotAccABA(model);
+    MatrixDynSize dAcc_dJointPos, dAcc_dVel, dAcc_dJointTorques;
+
+    // Buffers that were not all resized for the model are rejected
+    ForwardDynamicsDerivativesInternalBuffers fdBufs(model, traversal);
+    fdBufs.massMatrixFactorization = MassMatrixLTLFactorization();
+    ok = ForwardDynamicsDerivatives(model, traversal, robotPos, robotVel, linkExtWrenches, jointTorques,
+                                    fdBufs, robotAccABA, dAcc_dJointPos, dAcc_dVel, dAcc_dJointTorques);
+    ASSERT_IS_FALSE(ok);
+    fdBufs.resize(model, traversal);
+    fdBufs.aba = ArticulatedBodyAlgorithmInternalBuffers();
+    ok = ForwardDynamicsDerivatives(model, traversal, robotPos, robotVel, linkExtWrenches, jointTorques,
+                                    fdBufs, robotAccABA, dAcc_dJointPos, dAcc_dVel, dAcc_dJointTorques);
+    ASSERT_IS_FALSE(ok);
+
+    fdBufs.resize(model, traversal);
+    ok = ForwardDynamicsDerivatives(model, traversal, robotPos, robotVel, linkExtWrenches, jointTorques,
+                                    fdBufs, robotAccABA, dAcc_dJointPos, dAcc_dVel, dAcc_dJointTorques);
+    ASSERT_IS_TRUE(ok);
+
+    VectorDynSize acc, accPlus, accMinus;
+    computeForwardDynamics(model, traversal, robotPos, robotVel, linkExtWrenches, jointTorques, acc);
+    ASSERT_EQUAL_VECTOR_TOL(toEigen(robotAccABA.baseAcc()), toEigen(acc).head<6>(), 1e-8);
+
+    for(size_t dof=0; dof < dofs; dof++)
+    {
+        FreeFloatingPos robotPosPerturbed = robotPos;
+        robotPosPerturbed.jointPos()(dof) = robotPos.jointPos()(dof) + h;
+        computeForwardDynamics(model, traversal, robotPosPerturbed, robotVel, linkExtWrenches, jointTorques, accPlus);
+        robotPosPerturbed.jointPos()(dof) = robotPos.jointPos()(dof) - h;
+        computeForwardDynamics(model, traversal, robotPosPerturbed, robotVel, linkExtWrenches, jointTorques, accMinus);
+        assertColumnEqualToFiniteDifference(dAcc_dJointPos, dof, accPlus, accMinus, h);
+
+        JointDOFsDoubleArray jointTorquesPlus = jointTorques, jointTorquesMinus = jointTorques;
+        jointTorquesPlus(dof) += h;
+        jointTorquesMinus(dof) -= h;
+        computeForwardDynamics(model, traversal, robotPos, robotVel, linkExtWrenches, jointTorquesPlus, accPlus);
+        computeForwardDynamics(model, traversal, robotPos, robotVel, linkExtWrenches, jointTorquesMinus, accMinus);
+        assertColumnEqualToFiniteDifference(dAcc_dJointTorques, dof, accPlus, accMinus, h);
+    }
+
+    for(size_t i=0; i < 6+dofs; i++)
+    {
+        FreeFloatingVel robotVelPlus = robotVel, robotVelMinus = robotVel;
+        if (i < 6)
+        {
+            robotVelPlus.baseVel()(i) += h;
+            robotVelMinus.baseVel()(i) -= h;
+        }
+        else
+        {
+            robotVelPlus.jointVel()(i-6) += h;
+            robotVelMinus.jointVel()(i-6) -= h;
+        }
+        computeForwardDynamics(model, traversal, robotPos, robotVelPlus, linkExtWrenches, jointTorques, accPlus);
+        computeForwardDynamics(model, traversal, robotPos, robotVelMinus, linkExtWrenches, jointTorques, accMinus);
+        assertColumnEqualToFiniteDifference(dAcc_dVel, i, accPlus, accMinus, h);
+    }
+}
+
 int main()
 {
     for(unsigned int mdl = 0; mdl < IDYNTREE_TESTS_URDFS_NR; mdl++ )
@@ -175,5 +466,21 @@ int main()
         ok = model.computeFullTreeTraversal(traversal);
         assert(ok);
         checkInverseAndForwardDynamicsAreIdempotent(model,traversal);
+        checkIncrementalForwardPositionKinematics(model,traversal);
+        checkMassMatrixLTLFactorization(model,traversal);
+    }
+
+    for(unsigned int mdl = 0; mdl < IDYNTREE_TESTS_URDFS_NR; mdl++ )
+    {
+        std::string urdfFileName = getAbsModelPath(std::string(IDYNTREE_TESTS_URDFS[mdl]));
+        std::cout << "Checking dynamics derivatives on " << urdfFileName << std::endl;
+        ModelLoader loader;
+        bool ok = loader.loadModelFromFile(urdfFileName);
+        assert(ok);
+        Model model = loader.model();
+        Traversal traversal;
+        ok = model.computeFullTreeTraversal(traversal);
+        assert(ok);
+        checkDynamicsDerivatives(model,traversal);
     }
 }
@@ -0,0 +1,318 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/EigenHelpers.h>
+#include <iDynTree/TestUtils.h>
+
+#include <iDynTree/KinDynComputations.h>
+#include <iDynTree/ExtWrenchesAndJointTorquesEstimator.h>
+#include <iDynTree/BerdyHelper.h>
+#include <iDynTree/BerdySparseMAPSolver.h>
+#include <iDynTree/ExternalWrenchesEstimation.h>
+
+#include <iDynTree/ModelLoader.h>
+#include <iDynTree/FreeFloatingState.h>
+#include <iDynTree/FreeFloatingMatrices.h>
+#include <iDynTree/LinkState.h>
+#include <iDynTree/JointState.h>
+#include <iDynTree/MatrixDynSize.h>
+#include <iDynTree/VectorDynSize.h>
+
+#include "testModels.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+
+// This test checks that the methods documented as real-time safe do not perform any
+// heap allocation once the objects have been initialized and the methods have been
+// called once (warm-up). The allocations are detected by replacing the global operator
+// new and, on glibc, also malloc, calloc and realloc (that are used for example by Eigen).
+
+namespace
+{
+    std::atomic<bool> isAllocationTrackingEnabled{false};
+    std::atomic<std::size_t> nrOfTrackedAllocations{0};
+
+    void trackAllocation()
+    {
+        if (isAllocationTrackingEnabled.load(std::memory_order_relaxed))
+        {
+            nrOfTrackedAllocations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+#if defined(__GLIBC__)
+extern "C"
+{
+    void* __libc_malloc(std::size_t size);
+    void* __libc_calloc(std::size_t nmemb, std::size_t size);
+    void* __libc_realloc(void* ptr, std::size_t size);
+
+    void* malloc(std::size_t size)
+    {
+        trackAllocation();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t nmemb, std::size_t size)
+    {
+        trackAllocation();
+        return __libc_calloc(nmemb, size);
+    }
+
+    void* realloc(void* ptr, std::size_t size)
+    {
+        trackAllocation();
+        return __libc_realloc(ptr, size);
+    }
+}
+#endif
+
+void* operator new(std::size_t size)
+{
+#if !defined(__GLIBC__)
+    // On glibc the allocation is already tracked by malloc
+    trackAllocation();
+#endif
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+/**
+ * Call the function twice: the first call is the warm-up, and during
+ * the second one the number of heap allocations is checked to be zero.
+ */
+void assertNoAllocations(const std::string& description, const std::function<void()>& realTimeCall)
+{
+    realTimeCall();
+
+    nrOfTrackedAllocations = 0;
+    isAllocationTrackingEnabled = true;
+    realTimeCall();
+    isAllocationTrackingEnabled = false;
+
+    std::size_t nrOfAllocations = nrOfTrackedAllocations;
+    if (nrOfAllocations != 0)
+    {
+        std::cerr << description << " performed " << nrOfAllocations << " heap allocations." << std::endl;
+    }
+    ASSERT_IS_TRUE(nrOfAllocations == 0);
+}
+
+using namespace iDynTree;
+
+void checkKinDynComputations(const std::string& modelName, FrameVelocityRepresentation representation)
+{
+    ModelLoader loader;
+    bool ok = loader.loadModelFromFile(getAbsModelPath(modelName));
+    ASSERT_IS_TRUE(ok);
+
+    KinDynComputations kinDyn;
+    ok = kinDyn.loadRobotModel(loader.model());
+    ASSERT_IS_TRUE(ok);
+    kinDyn.setFrameVelocityRepresentation(representation);
+
+    const size_t dofs = kinDyn.getNrOfDegreesOfFreedom();
+    const FrameIndex frame = static_cast<FrameIndex>(kinDyn.getNrOfFrames()-1);
+
+    Transform world_T_base = getRandomTransform();
+    Twist baseVel = getRandomTwist();
+    VectorDynSize s(dofs), s_dot(dofs), s_ddot(dofs);
+    getRandomVector(s);
+    getRandomVector(s_dot);
+    getRandomVector(s_ddot);
+    Vector3 gravity;
+    getRandomVector(gravity);
+    Vector6 baseAcc;
+    getRandomVector(baseAcc);
+
+    MatrixDynSize world_T_baseMatrix(4,4), world_T_frame(4,4);
+    toEigen(world_T_baseMatrix) = toEigen(world_T_base.asHomogeneousTransform());
+    VectorDynSize baseVelVector(6);
+    toEigen(baseVelVector) = toEigen(baseVel);
+
+    MatrixDynSize massMatrix(dofs+6, dofs+6), jacobian(6, dofs+6), comJacobian(3, dofs+6);
+    VectorDynSize generalizedForces(dofs+6), twist(6), comPosition(3);
+    FreeFloatingGeneralizedTorques generalizedTorques(kinDyn.model());
+    LinkNetExternalWrenches extWrenches(kinDyn.model());
+    extWrenches.zero();
+
+    std::string prefix = modelName + " (" + std::to_string(static_cast<int>(representation)) + ") ";
+
+    // Each call is preceded by setRobotState, so that it includes the lazy computation of the
+    // quantities on which it depends
+    assertNoAllocations(prefix + "setRobotState", [&]()
+    {
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        kinDyn.setRobotState(world_T_baseMatrix, s, baseVelVector, s_dot, make_span(gravity));
+        kinDyn.setRobotState(make_span(s), make_span(s_dot), make_span(gravity));
+    });
+
+    assertNoAllocations(prefix + "getWorldTransform", [&]()
+    {
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        Transform world_H_frame = kinDyn.getWorldTransform(frame);
+        kinDyn.getWorldTransform(frame, world_T_frame);
+        (void) world_H_frame;
+    });
+
+    assertNoAllocations(prefix + "getFrameVel", [&]()
+    {
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        kinDyn.getFrameVel(frame, twist);
+    });
+
+    assertNoAllocations(prefix + "getFrameFreeFloatingJacobian", [&]()
+    {
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        kinDyn.getFrameFreeFloatingJacobian(frame, jacobian);
+    });
+
+    assertNoAllocations(prefix + "getFreeFloatingMassMatrix", [&]()
+    {
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        kinDyn.getFreeFloatingMassMatrix(massMatrix);
+    });
+
+    assertNoAllocations(prefix + "generalizedBiasForces", [&]()
+    {
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        kinDyn.generalizedBiasForces(generalizedForces);
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        kinDyn.generalizedBiasForces(generalizedTorques);
+    });
+
+    assertNoAllocations(prefix + "generalizedGravityForces", [&]()
+    {
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        kinDyn.generalizedGravityForces(generalizedForces);
+    });
+
+    assertNoAllocations(prefix + "inverseDynamics", [&]()
+    {
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        kinDyn.inverseDynamics(baseAcc, s_ddot, extWrenches, generalizedTorques);
+    });
+
+    assertNoAllocations(prefix + "getCenterOfMassPosition", [&]()
+    {
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        kinDyn.getCenterOfMassPosition(comPosition);
+    });
+
+    assertNoAllocations(prefix + "getCenterOfMassJacobian", [&]()
+    {
+        kinDyn.setRobotState(world_T_base, s, baseVel, s_dot, gravity);
+        kinDyn.getCenterOfMassJacobian(comJacobian);
+    });
+}
+
+void checkExtWrenchesAndJointTorquesEstimator(const std::string& modelName)
+{
+    ExtWrenchesAndJointTorquesEstimator estimator;
+    bool ok = estimator.loadModelAndSensorsFromFile(getAbsModelPath(modelName));
+    ASSERT_IS_TRUE(ok);
+
+    const Model& model = estimator.model();
+    JointPosDoubleArray jointPos(model);
+    JointDOFsDoubleArray jointVel(model), jointAcc(model);
+    getRandomVector(jointPos);
+    getRandomVector(jointVel);
+    getRandomVector(jointAcc);
+    Vector3 gravity, angularVel, angularAcc;
+    getRandomVector(gravity);
+    getRandomVector(angularVel);
+    getRandomVector(angularAcc);
+    FrameIndex baseFrame = model.getDefaultBaseLink();
+
+    LinkUnknownWrenchContacts unknowns(model);
+    unknowns.addNewUnknownFullWrenchInFrameOrigin(model, baseFrame);
+    SensorsMeasurements ftMeasurements(model.sensors());
+    LinkContactWrenches contactWrenches(model);
+    JointDOFsDoubleArray jointTorques(model);
+
+    assertNoAllocations(modelName + " ExtWrenchesAndJointTorquesEstimator (fixed base)", [&]()
+    {
+        estimator.updateKinematicsFromFixedBase(jointPos, jointVel, jointAcc, baseFrame, gravity);
+        estimator.computeExpectedFTSensorsMeasurements(unknowns, ftMeasurements, contactWrenches, jointTorques);
+        estimator.estimateExtWrenchesAndJointTorques(unknowns, ftMeasurements, contactWrenches, jointTorques);
+    });
+
+    assertNoAllocations(modelName + " ExtWrenchesAndJointTorquesEstimator (floating base)", [&]()
+    {
+        estimator.updateKinematicsFromFloatingBase(jointPos, jointVel, jointAcc, baseFrame,
+                                                   gravity, angularVel, angularAcc);
+        estimator.estimateExtWrenchesAndJointTorques(unknowns, ftMeasurements, contactWrenches, jointTorques);
+    });
+}
+
+void checkBerdySparseMAPSolver(const std::string& modelName)
+{
+    ModelLoader loader;
+    bool ok = loader.loadModelFromFile(getAbsModelPath(modelName));
+    ASSERT_IS_TRUE(ok);
+    const Model& model = loader.model();
+
+    BerdyHelper berdyHelper;
+    BerdyOptions berdyOptions;
+    berdyOptions.berdyVariant = BERDY_FLOATING_BASE;
+    berdyOptions.includeAllNetExternalWrenchesAsSensors = true;
+    berdyOptions.includeAllJointAccelerationsAsSensors = true;
+    ok = berdyHelper.init(model, berdyOptions);
+    ASSERT_IS_TRUE(ok);
+    BerdySparseMAPSolver solver(berdyHelper);
+    ok = solver.initialize();
+    ASSERT_IS_TRUE(ok);
+
+    JointPosDoubleArray jointPos(model);
+    JointDOFsDoubleArray jointVel(model);
+    getRandomVector(jointPos);
+    getRandomVector(jointVel);
+    Vector3 baseAngularVel;
+    getRandomVector(baseAngularVel);
+    VectorDynSize measurements(berdyHelper.getNrOfSensorsMeasurements());
+    getRandomVector(measurements);
+    FrameIndex baseFrame = model.getDefaultBaseLink();
+
+    assertNoAllocations(modelName + " BerdySparseMAPSolver", [&]()
+    {
+        solver.updateEstimateInformationFloatingBase(jointPos, jointVel, baseFrame, baseAngularVel, measurements);
+        solver.doEstimate();
+    });
+}
+
+int main()
+{
+    for (const std::string modelName : {"iCubGenova02.urdf", "bigman.urdf", "icub_skin_frames.urdf"})
+    {
+        checkKinDynComputations(modelName, MIXED_REPRESENTATION);
+        checkKinDynComputations(modelName, BODY_FIXED_REPRESENTATION);
+        checkKinDynComputations(modelName, INERTIAL_FIXED_REPRESENTATION);
+    }
+
+    for (const std::string modelName : {"iCubGenova02.urdf", "iCubDarmstadt01.urdf"})
+    {
+        checkExtWrenchesAndJointTorquesEstimator(modelName);
+        checkBerdySparseMAPSolver(modelName);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef IDYNTREE_FRAME_RECORDER_H
+#define IDYNTREE_FRAME_RECORDER_H
+
+#include <iDynTree/Span.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace iDynTree
+{
+
+class ITexture;
+
+/**
+ * Output format of the FrameRecorder.
+ */
+enum FrameRecorderFormat
+{
+    /**
+     * One binary PPM (P6) image for each frame, named <outputPath>_<frameNumber>.ppm with
+     * the frame number padded to 6 digits. The alpha channel is discarded.
+     */
+    FRAME_RECORDER_IMAGE_SEQUENCE_PPM,
+
+    /**
+     * A single file at outputPath containing the RGBA8 frames one after the other, without any header.
+     * It can be converted for example with
+     * ffmpeg -f rawvideo -pixel_format rgba -video_size <width>x<height> -framerate <fps> -i <outputPath> video.mp4
+     */
+    FRAME_RECORDER_RAW_VIDEO
+};
+
+/**
+ * FrameRecorder options
+ */
+struct FrameRecorderOptions
+{
+    /**
+     * Output format (default: FRAME_RECORDER_IMAGE_SEQUENCE_PPM).
+     */
+    FrameRecorderFormat format;
+
+    /**
+     * Prefix of the images of the sequence, or path of the raw video file (default: "iDynTreeRecording").
+     */
+    std::string outputPath;
+
+    /**
+     * Number of frames that can be waiting to be written, i.e. the capacity of the queue (default: 16).
+     * The memory of all the frames is allocated by FrameRecorder::open.
+     */
+    std::size_t nrOfBufferedFrames;
+
+    /**
+     * Number of background threads writing the frames (default: 2).
+     * The raw video is always written by a single thread, to keep the frames in order.
+     */
+    std::size_t nrOfEncoderThreads;
+
+    /**
+     * If true, a frame recorded when the queue is full is dropped, otherwise recordFrame
+     * waits for a frame to be written (default: false).
+     */
+    bool dropFramesWhenFull;
+
+    FrameRecorderOptions(): format(FRAME_RECORDER_IMAGE_SEQUENCE_PPM),
+                            outputPath("iDynTreeRecording"),
+                            nrOfBufferedFrames(16),
+                            nrOfEncoderThreads(2),
+                            dropFramesWhenFull(false)
+    {
+    }
+};
+
+/**
+ * Statistics of a FrameRecorder, to check if the encoder threads keep up with the recorded frames.
+ */
+struct FrameRecorderStatistics
+{
+    /**
+     * Number of frames accepted by recordFrame.
+     */
+    std::size_t nrOfRecordedFrames{0};
+
+    /**
+     * Number of frames written to the output.
+     */
+    std::size_t nrOfWrittenFrames{0};
+
+    /**
+     * Number of frames dropped because the queue was full (only if dropFramesWhenFull is true).
+     */
+    std::size_t nrOfDroppedFrames{0};
+
+    /**
+     * Number of frames that could not be written because of an output error.
+     */
+    std::size_t nrOfFailedFrames{0};
+
+    /**
+     * Maximum number of frames waiting to be written.
+     */
+    std::size_t maxNrOfQueuedFrames{0};
+
+    /**
+     * Total time (in seconds) spent by recordFrame waiting for the queue to have space.
+     */
+    double waitingTimeInSeconds{0.0};
+};
+
+/**
+ * Record the frames rendered by the visualizer (through the ITexture interface) without slowing down the render loop.
+ *
+ * recordFrame only copies the pixels of the frame in one of the preallocated buffers and pushes it in a bounded
+ * lock-free queue, while the frames are written to disk by background threads.
+ * Once the recorder is open, recording a frame does not allocate memory.
+ *
+ * Example:
+ * ~~~{.cpp}
+ * iDynTree::ITexture* texture = visualizer.textures().add("camera", textureOptions);
+ * iDynTree::FrameRecorder recorder;
+ * recorder.open(texture->width(), texture->height(), recorderOptions);
+ * while (simulating)
+ * {
+ *     visualizer.draw();
+ *     recorder.recordFrame(*texture);
+ * }
+ * recorder.close();
+ * ~~~
+ *
+ * \note recordFrame can not be called concurrently from multiple threads.
+ */
+class FrameRecorder
+{
+    struct FrameRecorderPimpl;
+    FrameRecorderPimpl * pimpl;
+
+    // copy is disabled
+    FrameRecorder(const FrameRecorder& other) = delete;
+    FrameRecorder& operator=(const FrameRecorder& other) = delete;
+
+public:
+    FrameRecorder();
+
+    /**
+     * Destructor, close the recorder writing the frames still in the queue.
+     */
+    ~FrameRecorder();
+
+    /**
+     * Allocate the buffers and start the encoder threads.
+     *
+     * @param[in] width the width of the recorded frames.
+     * @param[in] height the height of the recorded frames.
+     * @param[in] options the recorder options.
+     * @return true if all went well, false otherwise (for example if the raw video file could not be created).
+     */
+    bool open(int width, int height, const FrameRecorderOptions& options = FrameRecorderOptions());
+
+    /**
+     * Return true if the recorder has been opened, and not closed yet.
+     */
+    bool isOpen() const;
+
+    /**
+     * Record the pixels of a texture, that should have the width and height passed to open.
+     *
+     * Remember to call draw() on the visualizer first.
+     * @return true if the frame was queued, false if it was dropped or in case of errors.
+     */
+    bool recordFrame(const ITexture& texture);
+
+    /**
+     * Record a frame given its RGBA8 pixels in row-major format, as returned by ITexture::getRawPixels.
+     *
+     * @return true if the frame was queued, false if it was dropped or in case of errors.
+     */
+    bool recordFrame(iDynTree::Span<const std::uint8_t> rgbaPixels);
+
+    /**
+     * Wait for the queued frames to be written and stop the encoder threads.
+     *
+     * @return true if all the recorded frames were written, false otherwise.
+     */
+    bool close();
+
+    /**
+     * Get the statistics of the recording (they are reset by open).
+     */
+    FrameRecorderStatistics getStatistics() const;
+};
+
+}
+
+#endif
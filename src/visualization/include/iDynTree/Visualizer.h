@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <utility>
+#include <cstdint>
 
 #include <iDynTree/Direction.h>
 #include <iDynTree/Position.h>
@@ -15,6 +16,7 @@
 #include <iDynTree/LinkState.h>
 
 #include <iDynTree/SolidShapes.h>
+#include <iDynTree/Span.h>
 
 namespace iDynTree
 {
@@ -878,6 +880,18 @@ public:
      */
     virtual bool getPixels(std::vector<PixelViz>& pixels) const = 0;
 
+    /**
+     * @brief Copy the raw pixels of the texture in a buffer provided by the caller.
+     *
+     * Remember to call draw() first.
+     * Differently from getPixels, the pixels are not converted to PixelViz, so this method is suitable
+     * to read the whole rendered image at every frame (for example to generate synthetic camera images).
+     * @param rgbaPixels The output buffer, of size 4 * width() * height(). The pixels are saved in row-major format,
+     * starting from the top-left corner, with 4 bytes (red, green, blue and alpha) for each pixel.
+     * @return True in case of success, false otherwise (for example if the size of the buffer is not correct).
+     */
+    virtual bool getRawPixels(iDynTree::Span<std::uint8_t> rgbaPixels) const = 0;
+
     /**
      * Draw the current texture to a image file.
      *
@@ -0,0 +1,496 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/FrameRecorder.h>
+#include <iDynTree/Visualizer.h>
+#include <iDynTree/Utils.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace iDynTree
+{
+
+namespace
+{
+
+/**
+ * Bounded multi-producer multi-consumer lock-free queue of indices
+ * (see Dmitry Vyukov's bounded MPMC queue), the capacity is a power of two.
+ */
+class BoundedIndexQueue
+{
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        std::size_t value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    std::size_t m_mask{0};
+    std::atomic<std::size_t> m_enqueuePosition{0};
+    std::atomic<std::size_t> m_dequeuePosition{0};
+
+public:
+    /**
+     * Resize the queue to contain at least minimumCapacity elements, removing all the elements.
+     * It can not be called concurrently with push and pop.
+     */
+    void resize(std::size_t minimumCapacity)
+    {
+        std::size_t capacity = 2;
+        while (capacity < minimumCapacity)
+        {
+            capacity *= 2;
+        }
+
+        m_cells.reset(new Cell[capacity]);
+        for (std::size_t i = 0; i < capacity; i++)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_mask = capacity - 1;
+        m_enqueuePosition.store(0, std::memory_order_relaxed);
+        m_dequeuePosition.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * Return false if the queue is full.
+     */
+    bool push(std::size_t value)
+    {
+        Cell* cell;
+        std::size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &m_cells[position & m_mask];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0)
+            {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Return false if the queue is empty.
+     */
+    bool pop(std::size_t& value)
+    {
+        Cell* cell;
+        std::size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &m_cells[position & m_mask];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (difference == 0)
+            {
+                if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = cell->value;
+        cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+}
+
+struct FrameRecorder::FrameRecorderPimpl
+{
+    FrameRecorderOptions options;
+    int width{0};
+    int height{0};
+    std::size_t frameSize{0};
+    bool isOpen{false};
+
+    // The frames circulate between the two queues: the recording thread pops a free frame, fills it and
+    // pushes it in queuedFrames, the encoder threads pop it, write it and push it back in freeFrames
+    std::vector<std::vector<std::uint8_t>> frames;
+    std::vector<std::size_t> frameNumbers;
+    BoundedIndexQueue freeFrames;
+    BoundedIndexQueue queuedFrames;
+    std::size_t nextFrameNumber{0};
+
+    std::vector<std::thread> encoders;
+    std::ofstream rawVideo;
+    std::atomic<bool> stop{false};
+    // Only used to let the idle encoders and the recording thread waiting for a free frame sleep,
+    // the queues do not need it
+    std::mutex mutex;
+    std::condition_variable newFrameCondition;
+    std::condition_variable freeFrameCondition;
+
+    // Statistics, the ones written only by the recording thread are atomic just to be read by getStatistics
+    std::atomic<std::size_t> nrOfQueuedFrames{0};
+    std::atomic<std::size_t> nrOfRecordedFrames{0};
+    std::atomic<std::size_t> nrOfWrittenFrames{0};
+    std::atomic<std::size_t> nrOfDroppedFrames{0};
+    std::atomic<std::size_t> nrOfFailedFrames{0};
+    std::atomic<std::size_t> maxNrOfQueuedFrames{0};
+    std::atomic<double> waitingTimeInSeconds{0.0};
+
+    bool writeImage(std::size_t frame, std::vector<std::uint8_t>& rgbBuffer)
+    {
+        char frameNumber[32];
+        std::snprintf(frameNumber, sizeof(frameNumber), "_%06zu.ppm", frameNumbers[frame]);
+        std::ofstream image(options.outputPath + frameNumber, std::ios::binary);
+        if (!image.is_open())
+        {
+            return false;
+        }
+
+        const std::uint8_t* rgba = frames[frame].data();
+        std::size_t nrOfPixels = frameSize / 4;
+        for (std::size_t pixel = 0; pixel < nrOfPixels; pixel++)
+        {
+            rgbBuffer[3 * pixel] = rgba[4 * pixel];
+            rgbBuffer[3 * pixel + 1] = rgba[4 * pixel + 1];
+            rgbBuffer[3 * pixel + 2] = rgba[4 * pixel + 2];
+        }
+
+        image << "P6\n" << width << " " << height << "\n255\n";
+        image.write(reinterpret_cast<const char*>(rgbBuffer.data()), rgbBuffer.size());
+        return image.good();
+    }
+
+    bool writeFrame(std::size_t frame, std::vector<std::uint8_t>& rgbBuffer)
+    {
+        if (options.format == FRAME_RECORDER_RAW_VIDEO)
+        {
+            rawVideo.write(reinterpret_cast<const char*>(frames[frame].data()), frameSize);
+            return rawVideo.good();
+        }
+        return writeImage(frame, rgbBuffer);
+    }
+
+    void encoderLoop()
+    {
+        std::vector<std::uint8_t> rgbBuffer;
+        if (options.format == FRAME_RECORDER_IMAGE_SEQUENCE_PPM)
+        {
+            rgbBuffer.resize(3 * (frameSize / 4));
+        }
+
+        while (true)
+        {
+            // stop is set after the last frame is queued, so if it is read before failing to pop
+            // a frame there are no frames left to write
+            bool stopping = stop.load(std::memory_order_acquire);
+
+            std::size_t frame;
+            if (queuedFrames.pop(frame))
+            {
+                nrOfQueuedFrames.fetch_sub(1);
+                if (writeFrame(frame, rgbBuffer))
+                {
+                    nrOfWrittenFrames.fetch_add(1);
+                }
+                else
+                {
+                    nrOfFailedFrames.fetch_add(1);
+                }
+                freeFrames.push(frame);
+                // Locking the mutex before notifying guarantees that a recording thread that failed
+                // to pop a free frame is already waiting, so the notification is not missed
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                }
+                freeFrameCondition.notify_one();
+                continue;
+            }
+
+            if (stopping)
+            {
+                break;
+            }
+
+            // The recording thread notifies without locking the mutex, so a notification can be missed:
+            // the timeout bounds the delay in that case
+            std::unique_lock<std::mutex> lock(mutex);
+            newFrameCondition.wait_for(lock, std::chrono::milliseconds(5), [this]() {
+                return nrOfQueuedFrames.load() > 0 || stop.load();
+            });
+        }
+    }
+
+    bool acquireFrame(std::size_t& frame)
+    {
+        if (freeFrames.pop(frame))
+        {
+            return true;
+        }
+
+        if (options.dropFramesWhenFull)
+        {
+            nrOfDroppedFrames.fetch_add(1);
+            return false;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            freeFrameCondition.wait(lock, [this, &frame]() {
+                return freeFrames.pop(frame);
+            });
+        }
+        std::chrono::duration<double> waitingTime = std::chrono::steady_clock::now() - start;
+        waitingTimeInSeconds.store(waitingTimeInSeconds.load() + waitingTime.count());
+        return true;
+    }
+
+    void queueFrame(std::size_t frame)
+    {
+        frameNumbers[frame] = nextFrameNumber++;
+        std::size_t queued = nrOfQueuedFrames.fetch_add(1) + 1;
+        if (queued > maxNrOfQueuedFrames.load())
+        {
+            maxNrOfQueuedFrames.store(queued);
+        }
+        // The queue can contain all the frames, so this never fails
+        queuedFrames.push(frame);
+        nrOfRecordedFrames.fetch_add(1);
+        newFrameCondition.notify_one();
+    }
+};
+
+FrameRecorder::FrameRecorder(): pimpl(new FrameRecorderPimpl)
+{
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    close();
+    delete pimpl;
+    pimpl = nullptr;
+}
+
+bool FrameRecorder::open(int width, int height, const FrameRecorderOptions& options)
+{
+    if (pimpl->isOpen)
+    {
+        reportError("FrameRecorder", "open", "The recorder is already open, call close first.");
+        return false;
+    }
+
+    if (width <= 0 || height <= 0)
+    {
+        reportError("FrameRecorder", "open", "The width and the height of the frames should be positive.");
+        return false;
+    }
+
+    if (options.nrOfBufferedFrames == 0 || options.nrOfEncoderThreads == 0)
+    {
+        reportError("FrameRecorder", "open", "The number of buffered frames and of encoder threads should be positive.");
+        return false;
+    }
+
+    pimpl->options = options;
+    pimpl->width = width;
+    pimpl->height = height;
+    pimpl->frameSize = 4 * static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+
+    if (options.format == FRAME_RECORDER_RAW_VIDEO)
+    {
+        pimpl->rawVideo.open(options.outputPath, std::ios::binary | std::ios::trunc);
+        if (!pimpl->rawVideo.is_open())
+        {
+            std::stringstream ss;
+            ss << "Impossible to create the raw video file " << options.outputPath;
+            reportError("FrameRecorder", "open", ss.str().c_str());
+            return false;
+        }
+        pimpl->options.nrOfEncoderThreads = 1;
+    }
+
+    pimpl->frames.resize(options.nrOfBufferedFrames);
+    for (auto& frame : pimpl->frames)
+    {
+        frame.resize(pimpl->frameSize);
+    }
+    pimpl->frameNumbers.assign(options.nrOfBufferedFrames, 0);
+    pimpl->freeFrames.resize(options.nrOfBufferedFrames);
+    pimpl->queuedFrames.resize(options.nrOfBufferedFrames);
+    for (std::size_t frame = 0; frame < options.nrOfBufferedFrames; frame++)
+    {
+        pimpl->freeFrames.push(frame);
+    }
+
+    pimpl->nextFrameNumber = 0;
+    pimpl->nrOfQueuedFrames = 0;
+    pimpl->nrOfRecordedFrames = 0;
+    pimpl->nrOfWrittenFrames = 0;
+    pimpl->nrOfDroppedFrames = 0;
+    pimpl->nrOfFailedFrames = 0;
+    pimpl->maxNrOfQueuedFrames = 0;
+    pimpl->waitingTimeInSeconds = 0.0;
+    pimpl->stop = false;
+    pimpl->isOpen = true;
+
+    try
+    {
+        for (std::size_t i = 0; i < pimpl->options.nrOfEncoderThreads; i++)
+        {
+            pimpl->encoders.emplace_back(&FrameRecorderPimpl::encoderLoop, pimpl);
+        }
+    }
+    catch (const std::system_error& e)
+    {
+        std::stringstream ss;
+        ss << "Impossible to create the encoder threads: " << e.what();
+        reportError("FrameRecorder", "open", ss.str().c_str());
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool FrameRecorder::isOpen() const
+{
+    return pimpl->isOpen;
+}
+
+bool FrameRecorder::recordFrame(const ITexture& texture)
+{
+    if (!pimpl->isOpen)
+    {
+        reportError("FrameRecorder", "recordFrame", "The recorder is not open.");
+        return false;
+    }
+
+    if (texture.width() != pimpl->width || texture.height() != pimpl->height)
+    {
+        std::stringstream ss;
+        ss << "The texture size (" << texture.width() << "x" << texture.height()
+           << ") does not match the size of the recorded frames (" << pimpl->width << "x" << pimpl->height << ").";
+        reportError("FrameRecorder", "recordFrame", ss.str().c_str());
+        return false;
+    }
+
+    std::size_t frame;
+    if (!pimpl->acquireFrame(frame))
+    {
+        return false;
+    }
+
+    if (!texture.getRawPixels(make_span(pimpl->frames[frame])))
+    {
+        reportError("FrameRecorder", "recordFrame", "Unable to get the pixels of the texture.");
+        pimpl->freeFrames.push(frame);
+        return false;
+    }
+
+    pimpl->queueFrame(frame);
+    return true;
+}
+
+bool FrameRecorder::recordFrame(Span<const std::uint8_t> rgbaPixels)
+{
+    if (!pimpl->isOpen)
+    {
+        reportError("FrameRecorder", "recordFrame", "The recorder is not open.");
+        return false;
+    }
+
+    if (static_cast<std::size_t>(rgbaPixels.size()) != pimpl->frameSize)
+    {
+        reportError("FrameRecorder", "recordFrame", "The size of the pixels buffer does not match 4 * width * height.");
+        return false;
+    }
+
+    std::size_t frame;
+    if (!pimpl->acquireFrame(frame))
+    {
+        return false;
+    }
+
+    std::memcpy(pimpl->frames[frame].data(), rgbaPixels.data(), pimpl->frameSize);
+    pimpl->queueFrame(frame);
+    return true;
+}
+
+bool FrameRecorder::close()
+{
+    if (!pimpl->isOpen)
+    {
+        return true;
+    }
+
+    pimpl->stop.store(true, std::memory_order_release);
+    pimpl->newFrameCondition.notify_all();
+    for (auto& encoder : pimpl->encoders)
+    {
+        encoder.join();
+    }
+    pimpl->encoders.clear();
+
+    if (pimpl->rawVideo.is_open())
+    {
+        pimpl->rawVideo.close();
+    }
+    pimpl->isOpen = false;
+
+    if (pimpl->nrOfFailedFrames > 0)
+    {
+        std::stringstream ss;
+        ss << pimpl->nrOfFailedFrames << " frames could not be written to " << pimpl->options.outputPath;
+        reportError("FrameRecorder", "close", ss.str().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+FrameRecorderStatistics FrameRecorder::getStatistics() const
+{
+    FrameRecorderStatistics statistics;
+    statistics.nrOfRecordedFrames = pimpl->nrOfRecordedFrames;
+    statistics.nrOfWrittenFrames = pimpl->nrOfWrittenFrames;
+    statistics.nrOfDroppedFrames = pimpl->nrOfDroppedFrames;
+    statistics.nrOfFailedFrames = pimpl->nrOfFailedFrames;
+    statistics.maxNrOfQueuedFrames = pimpl->maxNrOfQueuedFrames;
+    statistics.waitingTimeInSeconds = pimpl->waitingTimeInSeconds;
+    return statistics;
+}
+
+}
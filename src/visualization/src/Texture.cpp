@@ -118,6 +118,64 @@ bool iDynTree::Texture::getPixels(std::vector<iDynTree::PixelViz> &pixels) const
     return true;
 }
 
+bool iDynTree::Texture::getRawPixels(iDynTree::Span<std::uint8_t> rgbaPixels) const
+{
+    if (!irrTexture)
+    {
+        reportError("Texture","getRawPixels","Cannot get the pixels. The video texture has not been properly initialized.");
+        return false;
+    }
+
+    auto textureDim = irrTexture->getSize();
+    size_t expectedSize = 4 * static_cast<size_t>(textureDim.Width) * textureDim.Height;
+
+    if (static_cast<size_t>(rgbaPixels.size()) != expectedSize)
+    {
+        std::stringstream ss;
+        ss << "The size of the output buffer (" << rgbaPixels.size() << ") does not match the size of the texture ("
+           << expectedSize << " = 4 x " << textureDim.Width << " x " << textureDim.Height << ").";
+        reportError("Texture", "getRawPixels", ss.str().c_str());
+        return false;
+    }
+
+    auto pitch = irrTexture->getPitch();
+    auto format = irrTexture->getColorFormat();
+
+    // As in getPixels, the locked buffer is read as a sequence of 32 bits SColor
+    if (irr::video::IImage::getBitsPerPixelFromFormat(format) != 32)
+    {
+        reportError("Texture", "getRawPixels", "Unsupported color format of the texture. Expected 32 bits per pixel.");
+        return false;
+    }
+
+    const unsigned char* buffer = (const unsigned char*) irrTexture->lock(irr::video::E_TEXTURE_LOCK_MODE::ETLM_READ_ONLY);
+    if (!buffer)
+    {
+        reportError("Texture", "getRawPixels", "Failed to lock the texture.");
+        return false;
+    }
+
+    // Iterate following the layout of the locked buffer, one row at a time
+    std::uint8_t* output = rgbaPixels.data();
+    for (irr::u32 row = 0; row < textureDim.Height; ++row)
+    {
+        const irr::u32* inputRow = reinterpret_cast<const irr::u32*>(buffer + (row * pitch));
+        for (irr::u32 column = 0; column < textureDim.Width; ++column)
+        {
+            irr::video::SColor pixelIrrlicht(inputRow[column]);
+            output[0] = static_cast<std::uint8_t>(pixelIrrlicht.getRed());
+            output[1] = static_cast<std::uint8_t>(pixelIrrlicht.getGreen());
+            output[2] = static_cast<std::uint8_t>(pixelIrrlicht.getBlue());
+            output[3] = static_cast<std::uint8_t>(pixelIrrlicht.getAlpha());
+            output += 4;
+        }
+    }
+
+    irrTexture->unlock();
+
+    return true;
+}
+
 bool iDynTree::Texture::drawToFile(const std::string filename) const
 {
     if (!irrTexture)
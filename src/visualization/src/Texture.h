@@ -33,6 +33,8 @@ public:
 
     virtual bool getPixels(std::vector<PixelViz>& pixels) const override;
 
+    virtual bool getRawPixels(iDynTree::Span<std::uint8_t> rgbaPixels) const override;
+
     virtual bool drawToFile(const std::string filename="iDynTreeVisualizerTextureScreenshot.png") const override;
 
     virtual void enableDraw(bool enabled = true) override;
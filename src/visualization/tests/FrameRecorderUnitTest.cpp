@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <iDynTree/FrameRecorder.h>
+#include <iDynTree/TestUtils.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace iDynTree;
+
+const int width = 7;
+const int height = 5;
+
+std::vector<std::uint8_t> getFrame(size_t frameNumber)
+{
+    std::vector<std::uint8_t> frame(4 * width * height);
+    for (size_t i = 0; i < frame.size(); i++)
+    {
+        frame[i] = static_cast<std::uint8_t>((frameNumber * 31 + i) % 256);
+    }
+    return frame;
+}
+
+std::vector<char> readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void checkImageSequence()
+{
+    const size_t nrOfFrames = 20;
+    FrameRecorderOptions options;
+    options.outputPath = "FrameRecorderUnitTestSequence";
+    options.nrOfBufferedFrames = 4;
+    options.nrOfEncoderThreads = 2;
+
+    FrameRecorder recorder;
+    ASSERT_IS_TRUE(recorder.open(width, height, options));
+    ASSERT_IS_TRUE(recorder.isOpen());
+    ASSERT_IS_FALSE(recorder.open(width, height, options));
+
+    for (size_t frameNumber = 0; frameNumber < nrOfFrames; frameNumber++)
+    {
+        std::vector<std::uint8_t> frame = getFrame(frameNumber);
+        ASSERT_IS_TRUE(recorder.recordFrame(make_span(frame)));
+    }
+
+    // A buffer of the wrong size is rejected
+    std::vector<std::uint8_t> wrongFrame(4 * width * height + 1);
+    ASSERT_IS_FALSE(recorder.recordFrame(make_span(wrongFrame)));
+
+    ASSERT_IS_TRUE(recorder.close());
+    ASSERT_IS_FALSE(recorder.isOpen());
+
+    FrameRecorderStatistics statistics = recorder.getStatistics();
+    ASSERT_EQUAL_DOUBLE(statistics.nrOfRecordedFrames, nrOfFrames);
+    ASSERT_EQUAL_DOUBLE(statistics.nrOfWrittenFrames, nrOfFrames);
+    ASSERT_EQUAL_DOUBLE(statistics.nrOfDroppedFrames, 0);
+    ASSERT_EQUAL_DOUBLE(statistics.nrOfFailedFrames, 0);
+    ASSERT_IS_TRUE(statistics.maxNrOfQueuedFrames <= options.nrOfBufferedFrames);
+
+    std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    for (size_t frameNumber = 0; frameNumber < nrOfFrames; frameNumber++)
+    {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "_%06zu.ppm", frameNumber);
+        std::string path = options.outputPath + suffix;
+        std::vector<char> image = readFile(path);
+        ASSERT_EQUAL_DOUBLE(image.size(), header.size() + 3 * width * height);
+        ASSERT_IS_TRUE(std::string(image.begin(), image.begin() + header.size()) == header);
+
+        std::vector<std::uint8_t> frame = getFrame(frameNumber);
+        for (size_t pixel = 0; pixel < static_cast<size_t>(width * height); pixel++)
+        {
+            for (size_t channel = 0; channel < 3; channel++)
+            {
+                ASSERT_IS_TRUE(static_cast<std::uint8_t>(image[header.size() + 3 * pixel + channel]) == frame[4 * pixel + channel]);
+            }
+        }
+        std::remove(path.c_str());
+    }
+}
+
+void checkRawVideo()
+{
+    const size_t nrOfFrames = 30;
+    FrameRecorderOptions options;
+    options.format = FRAME_RECORDER_RAW_VIDEO;
+    options.outputPath = "FrameRecorderUnitTestVideo.rgba";
+    options.nrOfBufferedFrames = 3;
+
+    {
+        FrameRecorder recorder;
+        ASSERT_IS_TRUE(recorder.open(width, height, options));
+        for (size_t frameNumber = 0; frameNumber < nrOfFrames; frameNumber++)
+        {
+            std::vector<std::uint8_t> frame = getFrame(frameNumber);
+            ASSERT_IS_TRUE(recorder.recordFrame(make_span(frame)));
+        }
+        // The destructor closes the recorder
+    }
+
+    std::vector<char> video = readFile(options.outputPath);
+    const size_t frameSize = 4 * width * height;
+    ASSERT_EQUAL_DOUBLE(video.size(), nrOfFrames * frameSize);
+    for (size_t frameNumber = 0; frameNumber < nrOfFrames; frameNumber++)
+    {
+        std::vector<std::uint8_t> frame = getFrame(frameNumber);
+        for (size_t i = 0; i < frameSize; i++)
+        {
+            ASSERT_IS_TRUE(static_cast<std::uint8_t>(video[frameNumber * frameSize + i]) == frame[i]);
+        }
+    }
+    std::remove(options.outputPath.c_str());
+}
+
+void checkDroppedFrames()
+{
+    const size_t nrOfFrames = 200;
+    FrameRecorderOptions options;
+    options.format = FRAME_RECORDER_RAW_VIDEO;
+    options.outputPath = "FrameRecorderUnitTestDropped.rgba";
+    options.nrOfBufferedFrames = 2;
+    options.dropFramesWhenFull = true;
+
+    FrameRecorder recorder;
+    ASSERT_IS_TRUE(recorder.open(width, height, options));
+    std::vector<std::uint8_t> frame = getFrame(0);
+    size_t nrOfQueuedFrames = 0;
+    for (size_t frameNumber = 0; frameNumber < nrOfFrames; frameNumber++)
+    {
+        if (recorder.recordFrame(make_span(frame)))
+        {
+            nrOfQueuedFrames++;
+        }
+    }
+    ASSERT_IS_TRUE(recorder.close());
+
+    FrameRecorderStatistics statistics = recorder.getStatistics();
+    ASSERT_EQUAL_DOUBLE(statistics.nrOfRecordedFrames, nrOfQueuedFrames);
+    ASSERT_EQUAL_DOUBLE(statistics.nrOfWrittenFrames, nrOfQueuedFrames);
+    ASSERT_EQUAL_DOUBLE(statistics.nrOfRecordedFrames + statistics.nrOfDroppedFrames, nrOfFrames);
+    ASSERT_EQUAL_DOUBLE(readFile(options.outputPath).size(), nrOfQueuedFrames * frame.size());
+    std::remove(options.outputPath.c_str());
+}
+
+int main()
+{
+    checkImageSequence();
+    checkRawVideo();
+    checkDroppedFrames();
+
+    std::cout << "FrameRecorder tests passed." << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -125,6 +125,21 @@ void checkAdditionalTexture() {
     ASSERT_EQUAL_DOUBLE_TOL(pixels[0].g, backGroundColor.g, 1e-1);
     ASSERT_EQUAL_DOUBLE_TOL(pixels[0].b, backGroundColor.b, 1e-1);
 
+    std::vector<std::uint8_t> rawPixels(4 * texture->width() * texture->height());
+    ok = texture->getRawPixels(iDynTree::make_span(rawPixels));
+    ASSERT_IS_TRUE(ok);
+    ASSERT_EQUAL_DOUBLE_TOL(rawPixels[0] / 255.0, backGroundColor.r, 1e-1);
+    ASSERT_EQUAL_DOUBLE_TOL(rawPixels[1] / 255.0, backGroundColor.g, 1e-1);
+    ASSERT_EQUAL_DOUBLE_TOL(rawPixels[2] / 255.0, backGroundColor.b, 1e-1);
+    ASSERT_EQUAL_DOUBLE_TOL(rawPixels[3] / 255.0, backGroundColor.a, 1e-1);
+    size_t lastPixel = rawPixels.size() - 4;
+    ASSERT_EQUAL_DOUBLE_TOL(rawPixels[lastPixel] / 255.0, pixels.back().r, 1e-2);
+    ASSERT_EQUAL_DOUBLE_TOL(rawPixels[lastPixel + 3] / 255.0, pixels.back().a, 1e-2);
+
+    rawPixels.resize(4);
+    ok = texture->getRawPixels(iDynTree::make_span(rawPixels));
+    ASSERT_IS_FALSE(ok);
+
     iDynTree::ColorViz newBackground(0.0, 0.0, 0.0, 0.0);
     texture->environment().setBackgroundColor(newBackground);
     texture->enableDraw(false); //The texture should not be updated, hence the background color should not change